@@ -2,8 +2,20 @@
 
 #include "op_interface.h"
 #include "op_registry.h"
+#include "utils/cpu_features.h"
 #include "utils/safe_ops.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DILATE_SIMD_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define DILATE_SIMD_NEON 1
+#endif
+
+/** Input rows read above and below each output row */
+#define REF_HALO_ROWS 1
+
 /* Helper function to clamp coordinates to image bounds */
 static int ClampCoord(int coord, int max_coord) {
   int result;
@@ -20,8 +32,8 @@ static int ClampCoord(int coord, int max_coord) {
 }
 
 /* MISRA-C:2023 Rule 18.1: Add bounds checking for array access */
-static unsigned char GetPixelSafe(const unsigned char* input, int x, int y, int width,
-                                    int height) {
+static unsigned char GetPixelSafe(const unsigned char* input, int x, int y, int c, int width,
+                                    int height, int channels) {
   int clamped_x;
   int clamped_y;
   int index;
@@ -32,26 +44,162 @@ static unsigned char GetPixelSafe(const unsigned char* input, int x, int y, int
 
   clamped_x = ClampCoord(x, width);
   clamped_y = ClampCoord(y, height);
-  index = clamped_y * width + clamped_x;
+  index = ((clamped_y * width + clamped_x) * channels) + c;
 
   return input[index];
 }
 
-void Dilate3x3Ref(const OpParams* params) {
-  int y;
-  int x;
+/* Scalar 3x3 max of channel c with replicated borders (border pass and fallback) */
+static unsigned char DilatePixel(const unsigned char* input, int x, int y, int c, int width,
+                                 int height, int channels) {
   int dy;
   int dx;
-  int ny;
-  int nx;
-  unsigned char max_val;
+  unsigned char max_val = 0U;
   unsigned char val;
+
+  for (dy = -1; dy <= 1; dy++) {
+    for (dx = -1; dx <= 1; dx++) {
+      /* Get pixel value with bounds checking */
+      val = GetPixelSafe(input, x + dx, y + dy, c, width, height, channels);
+      if (val > max_val) {
+        max_val = val;
+      }
+    }
+  }
+
+  return max_val;
+}
+
+/*
+ * Interior fast paths: channels are interleaved, so in a row of row_bytes
+ * bytes the horizontal neighbours of byte b are b - step and b + step
+ * (step = channels), and every channel is dilated by the same byte-wise
+ * max. Row y has both neighbours (1 <= y < height - 1) and each vector of
+ * bytes starting at b needs bytes b - step .. b + N - 1 + step, all inside
+ * the row. Each returns the first byte it did not process; the scalar pass
+ * finishes the row. The max is exact, so every path matches DilatePixel
+ * bit for bit.
+ */
+#if defined(DILATE_SIMD_X86)
+__attribute__((target("sse2"))) static int DilateRowSse2(const unsigned char* input,
+                                                         unsigned char* output, int y, int b,
+                                                         int row_bytes, int step) {
+  const unsigned char* above = input + ((y - 1) * row_bytes);
+  const unsigned char* row = input + (y * row_bytes);
+  const unsigned char* below = input + ((y + 1) * row_bytes);
+  __m128i m;
+
+  while ((b + 15 + step) < row_bytes) {
+    m = _mm_max_epu8(_mm_loadu_si128((const __m128i*)(above + b - step)),
+                     _mm_loadu_si128((const __m128i*)(above + b)));
+    m = _mm_max_epu8(m, _mm_loadu_si128((const __m128i*)(above + b + step)));
+    m = _mm_max_epu8(m, _mm_loadu_si128((const __m128i*)(row + b - step)));
+    m = _mm_max_epu8(m, _mm_loadu_si128((const __m128i*)(row + b)));
+    m = _mm_max_epu8(m, _mm_loadu_si128((const __m128i*)(row + b + step)));
+    m = _mm_max_epu8(m, _mm_loadu_si128((const __m128i*)(below + b - step)));
+    m = _mm_max_epu8(m, _mm_loadu_si128((const __m128i*)(below + b)));
+    m = _mm_max_epu8(m, _mm_loadu_si128((const __m128i*)(below + b + step)));
+    _mm_storeu_si128((__m128i*)(output + (y * row_bytes) + b), m);
+    b += 16;
+  }
+
+  return b;
+}
+
+__attribute__((target("avx2"))) static int DilateRowAvx2(const unsigned char* input,
+                                                         unsigned char* output, int y, int b,
+                                                         int row_bytes, int step) {
+  const unsigned char* above = input + ((y - 1) * row_bytes);
+  const unsigned char* row = input + (y * row_bytes);
+  const unsigned char* below = input + ((y + 1) * row_bytes);
+  __m256i m;
+
+  while ((b + 31 + step) < row_bytes) {
+    m = _mm256_max_epu8(_mm256_loadu_si256((const __m256i*)(above + b - step)),
+                        _mm256_loadu_si256((const __m256i*)(above + b)));
+    m = _mm256_max_epu8(m, _mm256_loadu_si256((const __m256i*)(above + b + step)));
+    m = _mm256_max_epu8(m, _mm256_loadu_si256((const __m256i*)(row + b - step)));
+    m = _mm256_max_epu8(m, _mm256_loadu_si256((const __m256i*)(row + b)));
+    m = _mm256_max_epu8(m, _mm256_loadu_si256((const __m256i*)(row + b + step)));
+    m = _mm256_max_epu8(m, _mm256_loadu_si256((const __m256i*)(below + b - step)));
+    m = _mm256_max_epu8(m, _mm256_loadu_si256((const __m256i*)(below + b)));
+    m = _mm256_max_epu8(m, _mm256_loadu_si256((const __m256i*)(below + b + step)));
+    _mm256_storeu_si256((__m256i*)(output + (y * row_bytes) + b), m);
+    b += 32;
+  }
+
+  /* Finish with 16-byte steps before the scalar tail */
+  return DilateRowSse2(input, output, y, b, row_bytes, step);
+}
+#endif
+
+#if defined(DILATE_SIMD_NEON)
+static int DilateRowNeon(const unsigned char* input, unsigned char* output, int y, int b,
+                         int row_bytes, int step) {
+  const unsigned char* above = input + ((y - 1) * row_bytes);
+  const unsigned char* row = input + (y * row_bytes);
+  const unsigned char* below = input + ((y + 1) * row_bytes);
+  uint8x16_t m;
+
+  while ((b + 15 + step) < row_bytes) {
+    m = vmaxq_u8(vld1q_u8(above + b - step), vld1q_u8(above + b));
+    m = vmaxq_u8(m, vld1q_u8(above + b + step));
+    m = vmaxq_u8(m, vld1q_u8(row + b - step));
+    m = vmaxq_u8(m, vld1q_u8(row + b));
+    m = vmaxq_u8(m, vld1q_u8(row + b + step));
+    m = vmaxq_u8(m, vld1q_u8(below + b - step));
+    m = vmaxq_u8(m, vld1q_u8(below + b));
+    m = vmaxq_u8(m, vld1q_u8(below + b + step));
+    vst1q_u8(output + (y * row_bytes) + b, m);
+    b += 16;
+  }
+
+  return b;
+}
+#endif
+
+/* Run the widest available interior path over row y from byte b */
+static int DilateRowSimd(CpuSimd simd, const unsigned char* input, unsigned char* output, int y,
+                         int b, int row_bytes, int step) {
+#if defined(DILATE_SIMD_X86)
+  if (simd == CPU_SIMD_AVX2) {
+    return DilateRowAvx2(input, output, y, b, row_bytes, step);
+  }
+  if (simd == CPU_SIMD_SSE2) {
+    return DilateRowSse2(input, output, y, b, row_bytes, step);
+  }
+#elif defined(DILATE_SIMD_NEON)
+  if (simd == CPU_SIMD_NEON) {
+    return DilateRowNeon(input, output, y, b, row_bytes, step);
+  }
+#endif
+  (void)simd;
+  (void)input;
+  (void)output;
+  (void)y;
+  (void)row_bytes;
+  (void)step;
+  return b;
+}
+
+/*
+ * Row-range entry point: computes output rows [row_begin, row_end) and may
+ * run concurrently on disjoint ranges (borders still clamp to the full image).
+ * Channels are interleaved (src_channels per pixel, packed rows) and dilated
+ * independently.
+ */
+void Dilate3x3RefRows(const OpParams* params, int row_begin, int row_end) {
+  int y;
+  int b;
   int output_index;
-  int total_pixels;
+  int total_bytes;
+  int row_bytes;
   int width;
   int height;
+  int channels;
   unsigned char* input;
   unsigned char* output;
+  CpuSimd simd;
 
   if (params == NULL) {
     return;
@@ -62,42 +210,54 @@ void Dilate3x3Ref(const OpParams* params) {
   output = params->output;
   width = params->src_width;
   height = params->src_height;
+  channels = (params->src_channels > 0) ? params->src_channels : 1;
 
   if ((input == NULL) || (output == NULL) || (width <= 0) || (height <= 0)) {
     return;
   }
 
   /* MISRA-C:2023 Rule 1.3: Check for integer overflow */
-  if (!SafeMulInt(width, height, &total_pixels)) {
+  if (!SafeMulInt(width, channels, &row_bytes) || !SafeMulInt(row_bytes, height, &total_bytes)) {
     return; /* Overflow detected */
   }
 
+  if (row_begin < 0) {
+    row_begin = 0;
+  }
+  if (row_end > height) {
+    row_end = height;
+  }
+
+  simd = CpuSimdLevel();
+
   /* Handle borders by replication */
-  for (y = 0; y < height; y++) {
-    for (x = 0; x < width; x++) {
-      max_val = 0U;
-
-      /* 3x3 window */
-      for (dy = -1; dy <= 1; dy++) {
-        for (dx = -1; dx <= 1; dx++) {
-          ny = y + dy;
-          nx = x + dx;
-
-          /* Get pixel value with bounds checking */
-          val = GetPixelSafe(input, nx, ny, width, height);
-          if (val > max_val) {
-            max_val = val;
-          }
-        }
+  for (y = row_begin; y < row_end; y++) {
+    b = 0;
+
+    /* Interior rows: scalar left border pixel, SIMD body, scalar tail below */
+    if ((y >= 1) && (y < (height - 1)) && (width >= 3)) {
+      for (b = 0; b < channels; b++) {
+        output[(y * row_bytes) + b] = DilatePixel(input, 0, y, b, width, height, channels);
       }
+      b = DilateRowSimd(simd, input, output, y, channels, row_bytes, channels);
+    }
 
-      output_index = y * width + x;
+    for (; b < row_bytes; b++) {
+      output_index = y * row_bytes + b;
 
       /* MISRA-C:2023 Rule 18.1: Bounds check before write */
-      if (output_index < total_pixels) {
-        output[output_index] = max_val;
+      if (output_index < total_bytes) {
+        output[output_index] =
+            DilatePixel(input, b / channels, y, b % channels, width, height, channels);
       }
     }
   }
 }
 
+void Dilate3x3Ref(const OpParams* params) {
+  if (params == NULL) {
+    return;
+  }
+
+  Dilate3x3RefRows(params, 0, params->src_height);
+}
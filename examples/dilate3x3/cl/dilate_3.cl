@@ -0,0 +1,62 @@
+/**
+ * @file dilate_3.cl
+ * @brief 3x3 dilation of interleaved multi-channel images over pitched rows
+ *
+ * One work-item per pixel, with all channels of the pixel in one vector:
+ * uchar3 for RGB (-DCHANNELS=3, the default) or uchar4 for RGBA
+ * (-DCHANNELS=4). The 9 neighbours are 9 vector loads and 8 vector max
+ * operations instead of one pass per channel. Rows are addressed through
+ * the row strides, so the kernel runs on pitched device buffers
+ * ("pitched": true) and on packed ones alike.
+ *
+ * Kernel arguments (must match kernel_args in config/dilate3x3.json):
+ * @param input      Input image buffer
+ * @param output     Output image buffer
+ * @param width      Image width in pixels
+ * @param height     Image height in pixels
+ * @param src_stride Input row pitch in bytes
+ * @param dst_stride Output row pitch in bytes
+ */
+
+#ifndef CHANNELS
+#define CHANNELS 3
+#endif
+
+#if CHANNELS == 4
+/* Rows start 4-byte aligned (packed width * 4, or the device pitch alignment) */
+typedef uchar4 pixel_t;
+#define LOAD_PIXEL(x, row) (((__global const uchar4*)(row))[x])
+#define STORE_PIXEL(v, x, row) (((__global uchar4*)(row))[x] = (v))
+#elif CHANNELS == 3
+typedef uchar3 pixel_t;
+#define LOAD_PIXEL(x, row) vload3((x), (row))
+#define STORE_PIXEL(v, x, row) vstore3((v), (x), (row))
+#else
+#error "dilate_3.cl supports CHANNELS 3 or 4"
+#endif
+
+__kernel void dilate3x3_vec(__global const uchar* input,
+                            __global uchar* output,
+                            int width,
+                            int height,
+                            int src_stride,
+                            int dst_stride) {
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+
+    if (x >= width || y >= height) return;
+
+    int xl = max(x - 1, 0);
+    int xr = min(x + 1, width - 1);
+    pixel_t max_val = (pixel_t)(0);
+
+    for (int dy = -1; dy <= 1; dy++) {
+        __global const uchar* row = input + clamp(y + dy, 0, height - 1) * src_stride;
+
+        max_val = max(max_val, LOAD_PIXEL(xl, row));
+        max_val = max(max_val, LOAD_PIXEL(x, row));
+        max_val = max(max_val, LOAD_PIXEL(xr, row));
+    }
+
+    STORE_PIXEL(max_val, x, output + y * dst_stride);
+}
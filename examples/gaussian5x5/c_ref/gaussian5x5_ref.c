@@ -1,10 +1,26 @@
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "op_interface.h"
 #include "op_registry.h"
+#include "utils/cpu_features.h"
 #include "utils/safe_ops.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GAUSSIAN_SIMD_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define GAUSSIAN_SIMD_NEON 1
+#endif
+
+/** Number of taps in the 5x5 window */
+#define GAUSSIAN_TAPS 25
+
+/** Input rows read above and below each output row */
+#define REF_HALO_ROWS 2
+
 /* Helper function to clamp coordinates to image bounds */
 static int ClampCoord(int coord, int max_coord) {
   int result;
@@ -37,22 +53,210 @@ static int GetPixelSafe(const unsigned char* input, int x, int y, int width, int
   return (int)input[index];
 }
 
-void Gaussian5x5Ref(const OpParams* params) {
+/*
+ * Scalar 5x5 convolution with replicated borders (border pass and
+ * fallback). weights[] holds kernel_y[dy + 2] * kernel_x[dx + 2] in
+ * dy-major order and kernel_sum their running sum in the same order.
+ */
+static unsigned char GaussianPixel(const unsigned char* input, int x, int y, int width,
+                                   int height, const float* weights, float kernel_sum) {
+  int dy;
+  int dx;
+  int tap = 0;
+  int pixel_val;
+  float sum = 0.0f;
+
+  for (dy = -2; dy <= 2; dy++) {
+    for (dx = -2; dx <= 2; dx++) {
+      /* Get pixel value with bounds checking */
+      pixel_val = GetPixelSafe(input, x + dx, y + dy, width, height);
+      sum += (float)pixel_val * weights[tap];
+      tap++;
+    }
+  }
+
+  /* Convert to unsigned char with rounding */
+  return (unsigned char)((sum / kernel_sum) + 0.5f);
+}
+
+/*
+ * Interior fast paths: row y has two rows above and below
+ * (2 <= y < height - 2) and each vector of N pixels starting at column x
+ * reads columns x - 2 .. x + N + 1, all inside the row. Each lane performs
+ * the scalar operation sequence (25 multiply-adds in window order, divide,
+ * round, truncate) with separate multiplies and adds, so results match
+ * GaussianPixel bit for bit. Each returns the first unprocessed column.
+ */
+#if defined(GAUSSIAN_SIMD_X86)
+/* Load 4 pixels and widen them to floats */
+__attribute__((target("sse2"))) static inline __m128 LoadU8x4Sse2(const unsigned char* src) {
+  int packed;
+  __m128i zero = _mm_setzero_si128();
+  __m128i v;
+
+  (void)memcpy(&packed, src, sizeof(packed));
+  v = _mm_cvtsi32_si128(packed);
+  v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+  return _mm_cvtepi32_ps(v);
+}
+
+__attribute__((target("sse2"))) static int GaussianRowSse2(const unsigned char* input,
+                                                           unsigned char* output, int y, int x,
+                                                           int width, const float* weights,
+                                                           float kernel_sum) {
+  const __m128 ksum = _mm_set1_ps(kernel_sum);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const unsigned char* row;
+  __m128 sum;
+  __m128i packed;
+  int dy;
+  int dx;
+  int tap;
+  int result;
+
+  while ((x + 4 + 2) <= width) {
+    sum = _mm_setzero_ps();
+    tap = 0;
+    for (dy = -2; dy <= 2; dy++) {
+      row = input + ((y + dy) * width) + x;
+      for (dx = -2; dx <= 2; dx++) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(LoadU8x4Sse2(row + dx), _mm_set1_ps(weights[tap])));
+        tap++;
+      }
+    }
+    packed = _mm_cvttps_epi32(_mm_add_ps(_mm_div_ps(sum, ksum), half));
+    packed = _mm_packus_epi16(_mm_packs_epi32(packed, packed), packed);
+    result = _mm_cvtsi128_si32(packed);
+    (void)memcpy(output + (y * width) + x, &result, sizeof(result));
+    x += 4;
+  }
+
+  return x;
+}
+
+__attribute__((target("avx2"))) static int GaussianRowAvx2(const unsigned char* input,
+                                                           unsigned char* output, int y, int x,
+                                                           int width, const float* weights,
+                                                           float kernel_sum) {
+  const __m256 ksum = _mm256_set1_ps(kernel_sum);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const unsigned char* row;
+  __m256 sum;
+  __m256 pixels;
+  __m256i rounded;
+  __m128i packed;
+  int dy;
+  int dx;
+  int tap;
+
+  while ((x + 8 + 2) <= width) {
+    sum = _mm256_setzero_ps();
+    tap = 0;
+    for (dy = -2; dy <= 2; dy++) {
+      row = input + ((y + dy) * width) + x;
+      for (dx = -2; dx <= 2; dx++) {
+        pixels = _mm256_cvtepi32_ps(
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(row + dx))));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(pixels, _mm256_set1_ps(weights[tap])));
+        tap++;
+      }
+    }
+    rounded = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_div_ps(sum, ksum), half));
+    packed = _mm_packs_epi32(_mm256_castsi256_si128(rounded),
+                             _mm256_extracti128_si256(rounded, 1));
+    _mm_storel_epi64((__m128i*)(output + (y * width) + x), _mm_packus_epi16(packed, packed));
+    x += 8;
+  }
+
+  return GaussianRowSse2(input, output, y, x, width, weights, kernel_sum);
+}
+#endif
+
+#if defined(GAUSSIAN_SIMD_NEON)
+static int GaussianRowNeon(const unsigned char* input, unsigned char* output, int y, int x,
+                           int width, const float* weights, float kernel_sum) {
+  const float32x4_t ksum = vdupq_n_f32(kernel_sum);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const unsigned char* row;
+  float32x4_t sum_lo;
+  float32x4_t sum_hi;
+  float32x4_t weight;
+  uint16x8_t pixels;
+  uint16x8_t narrowed;
+  int dy;
+  int dx;
+  int tap;
+
+  while ((x + 8 + 2) <= width) {
+    sum_lo = vdupq_n_f32(0.0f);
+    sum_hi = vdupq_n_f32(0.0f);
+    tap = 0;
+    for (dy = -2; dy <= 2; dy++) {
+      row = input + ((y + dy) * width) + x;
+      for (dx = -2; dx <= 2; dx++) {
+        pixels = vmovl_u8(vld1_u8(row + dx));
+        weight = vdupq_n_f32(weights[tap]);
+        /* vmul + vadd, not vmla/vfma: keeps the scalar rounding */
+        sum_lo = vaddq_f32(sum_lo, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(pixels))),
+                                             weight));
+        sum_hi = vaddq_f32(sum_hi, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(pixels))),
+                                             weight));
+        tap++;
+      }
+    }
+    /* Quotients are non-negative, so unsigned truncation matches the cast */
+    narrowed = vcombine_u16(
+        vqmovn_u32(vcvtq_u32_f32(vaddq_f32(vdivq_f32(sum_lo, ksum), half))),
+        vqmovn_u32(vcvtq_u32_f32(vaddq_f32(vdivq_f32(sum_hi, ksum), half))));
+    vst1_u8(output + (y * width) + x, vqmovn_u16(narrowed));
+    x += 8;
+  }
+
+  return x;
+}
+#endif
+
+/* Run the widest available interior path over row y from column x */
+static int GaussianRowSimd(CpuSimd simd, const unsigned char* input, unsigned char* output,
+                           int y, int x, int width, const float* weights, float kernel_sum) {
+#if defined(GAUSSIAN_SIMD_X86)
+  if (simd == CPU_SIMD_AVX2) {
+    return GaussianRowAvx2(input, output, y, x, width, weights, kernel_sum);
+  }
+  if (simd == CPU_SIMD_SSE2) {
+    return GaussianRowSse2(input, output, y, x, width, weights, kernel_sum);
+  }
+#elif defined(GAUSSIAN_SIMD_NEON)
+  if (simd == CPU_SIMD_NEON) {
+    return GaussianRowNeon(input, output, y, x, width, weights, kernel_sum);
+  }
+#endif
+  (void)simd;
+  (void)input;
+  (void)output;
+  (void)y;
+  (void)width;
+  (void)weights;
+  (void)kernel_sum;
+  return x;
+}
+
+/*
+ * Row-range entry point: computes output rows [row_begin, row_end) and may
+ * run concurrently on disjoint ranges (borders still clamp to the full image).
+ */
+void Gaussian5x5RefRows(const OpParams* params, int row_begin, int row_end) {
   /* Separable Gaussian 5x5 using 1D kernels from custom buffers */
   /* This matches the OpenCL implementation which uses kernel_x and kernel_y */
   int y;
   int x;
   int dy;
   int dx;
-  int ny;
-  int nx;
-  float sum;
+  int tap;
   float kernel_sum;
-  float weight;
-  int pixel_val;
+  float weights[GAUSSIAN_TAPS];
   int output_index;
   int total_pixels;
-  unsigned char result;
   int width;
   int height;
   unsigned char* input;
@@ -60,6 +264,7 @@ void Gaussian5x5Ref(const OpParams* params) {
   CustomBuffers* custom_buffers;
   const float* kernel_x;
   const float* kernel_y;
+  CpuSimd simd;
 
   if (params == NULL) {
     return;
@@ -112,40 +317,57 @@ void Gaussian5x5Ref(const OpParams* params) {
     return; /* Overflow detected */
   }
 
-  for (y = 0; y < height; y++) {
-    for (x = 0; x < width; x++) {
-      sum = 0.0f;
-      kernel_sum = 0.0f;
+  /* 2D weight = kernel_y[i] * kernel_x[j], summed in window order */
+  kernel_sum = 0.0f;
+  tap = 0;
+  for (dy = -2; dy <= 2; dy++) {
+    for (dx = -2; dx <= 2; dx++) {
+      weights[tap] = kernel_y[dy + 2] * kernel_x[dx + 2];
+      kernel_sum += weights[tap];
+      tap++;
+    }
+  }
+
+  if (row_begin < 0) {
+    row_begin = 0;
+  }
+  if (row_end > height) {
+    row_end = height;
+  }
 
-      /* 5x5 window with separable convolution */
-      /* 2D weight = kernel_y[i] * kernel_x[j] */
-      for (dy = -2; dy <= 2; dy++) {
-        for (dx = -2; dx <= 2; dx++) {
-          ny = y + dy;
-          nx = x + dx;
+  simd = CpuSimdLevel();
 
-          /* Get pixel value with bounds checking */
-          pixel_val = GetPixelSafe(input, nx, ny, width, height);
+  for (y = row_begin; y < row_end; y++) {
+    x = 0;
 
-          /* Compute 2D weight as outer product of 1D kernels */
-          weight = kernel_y[dy + 2] * kernel_x[dx + 2];
-          kernel_sum += weight;
-          sum += (float)pixel_val * weight;
-        }
+    /* Interior rows: scalar left border, SIMD body, scalar tail below */
+    if ((y >= 2) && (y < (height - 2)) && (width >= 5)) {
+      for (; x < 2; x++) {
+        output[y * width + x] =
+            GaussianPixel(input, x, y, width, height, weights, kernel_sum);
       }
+      x = GaussianRowSimd(simd, input, output, y, x, width, weights, kernel_sum);
+    }
 
-      /* Convert to unsigned char with rounding */
-      result = (unsigned char)((sum / kernel_sum) + 0.5f);
+    for (; x < width; x++) {
       output_index = y * width + x;
 
       /* MISRA-C:2023 Rule 18.1: Bounds check before write */
       if (output_index < total_pixels) {
-        output[output_index] = result;
+        output[output_index] = GaussianPixel(input, x, y, width, height, weights, kernel_sum);
       }
     }
   }
 }
 
+void Gaussian5x5Ref(const OpParams* params) {
+  if (params == NULL) {
+    return;
+  }
+
+  Gaussian5x5RefRows(params, 0, params->src_height);
+}
+
 /*
  * NOTE: Registration of this algorithm happens in auto_registry.c
  * See src/utils/auto_registry.c for the registration code.
@@ -9,6 +9,14 @@
  * Kernel weights are computed on-the-fly from sigma rather than
  * being loaded from external buffer files.
  *
+ * Scalars marked "specialize" in the config arrive as -DSPEC_SIGMA,
+ * -DSPEC_KERNEL_RADIUS and -DSPEC_NORMALIZE build options. They replace the
+ * runtime arguments, so the loops have constant bounds (fully unrolled) and
+ * the weights and the normalize branch fold at compile time.
+ *
+ * Stores go through EPILOGUE() (epilogue.h), so a pipeline stage can fuse a
+ * following elementwise op into this kernel.
+ *
  * @param input Input image buffer
  * @param output Output image buffer
  * @param width Image width
@@ -17,6 +25,26 @@
  * @param kernel_radius Kernel radius (kernel size = 2*radius + 1)
  * @param normalize Whether to normalize output (1=yes, 0=no)
  */
+#include "epilogue.h"
+
+#ifdef SPEC_SIGMA
+#define SIGMA SPEC_SIGMA
+#else
+#define SIGMA sigma
+#endif
+
+#ifdef SPEC_KERNEL_RADIUS
+#define KERNEL_RADIUS SPEC_KERNEL_RADIUS
+#else
+#define KERNEL_RADIUS kernel_radius
+#endif
+
+#ifdef SPEC_NORMALIZE
+#define NORMALIZE SPEC_NORMALIZE
+#else
+#define NORMALIZE normalize
+#endif
+
 __kernel void gaussian_custom(__global const uchar* input,
                               __global uchar* output,
                               int width,
@@ -33,11 +61,11 @@ __kernel void gaussian_custom(__global const uchar* input,
     float weight_sum = 0.0f;
 
     /* Precompute Gaussian coefficient: -1 / (2 * sigma^2) */
-    float inv_2sigma2 = -1.0f / (2.0f * sigma * sigma);
+    float inv_2sigma2 = -1.0f / (2.0f * SIGMA * SIGMA);
 
     /* Apply NxN convolution with on-the-fly weight computation */
-    for (int dy = -kernel_radius; dy <= kernel_radius; dy++) {
-        for (int dx = -kernel_radius; dx <= kernel_radius; dx++) {
+    for (int dy = -KERNEL_RADIUS; dy <= KERNEL_RADIUS; dy++) {
+        for (int dx = -KERNEL_RADIUS; dx <= KERNEL_RADIUS; dx++) {
             /* Clamp coordinates to image bounds */
             int ny = clamp(y + dy, 0, height - 1);
             int nx = clamp(x + dx, 0, width - 1);
@@ -52,9 +80,9 @@ __kernel void gaussian_custom(__global const uchar* input,
     }
 
     /* Normalize if requested, otherwise just clamp */
-    if (normalize != 0) {
-        output[y * width + x] = convert_uchar_sat(sum / weight_sum);
+    if (NORMALIZE != 0) {
+        output[y * width + x] = EPILOGUE(convert_uchar_sat(sum / weight_sum));
     } else {
-        output[y * width + x] = convert_uchar_sat(sum);
+        output[y * width + x] = EPILOGUE(convert_uchar_sat(sum));
     }
 }
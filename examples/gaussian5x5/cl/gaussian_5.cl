@@ -0,0 +1,48 @@
+/**
+ * Gaussian 5x5 blur kernel reading and writing through image objects
+ *
+ * Same weights and arithmetic as gaussian_1.cl, but the input is an
+ * image2d_t view of the input buffer: reads go through the texture cache
+ * and the sampler resolves the border (clamp-to-edge for BORDER_CLAMP),
+ * so the loop has no per-tap clamping. The output is written through an
+ * image view of the output buffer.
+ *
+ * @param input Input image (view of the input buffer)
+ * @param smp Sampler (addressing mode from the border mode)
+ * @param output Output image (view of the output buffer)
+ * @param width Image width
+ * @param height Image height
+ * @param kernel_x Horizontal 1D Gaussian weights (5 floats)
+ * @param kernel_y Vertical 1D Gaussian weights (5 floats)
+ */
+#include "sampling.h"
+
+__kernel void gaussian5x5_image(read_only image2d_t input,
+                                sampler_t smp,
+                                write_only image2d_t output,
+                                int width,
+                                int height,
+                                __global const float* kernel_x,
+                                __global const float* kernel_y) {
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+
+    if (x >= width || y >= height) return;
+
+    float2 inv_size = image_inv_size(input);
+    float sum = 0.0f;
+    float kernel_sum = 0.0f;
+
+    // Apply 5x5 convolution using separable kernels
+    // 2D weight = kernel_y[i] * kernel_x[j]
+    for (int dy = -2; dy <= 2; dy++) {
+        for (int dx = -2; dx <= 2; dx++) {
+            float weight = kernel_y[dy + 2] * kernel_x[dx + 2];
+            kernel_sum += weight;
+
+            sum += (float)image_read_u8(input, smp, x + dx, y + dy, inv_size) * weight;
+        }
+    }
+
+    write_imageui(output, (int2)(x, y), (uint4)(convert_uchar_sat(sum / kernel_sum), 0, 0, 0));
+}
@@ -0,0 +1,124 @@
+/**
+ * Gaussian 5x5 blur kernels in reduced precision
+ *
+ * Same weights and border handling as gaussian_1.cl, with the arithmetic
+ * done in half or in fixed-point integers instead of float. Pixels are
+ * 8-bit, so both keep the rounding error within the verification
+ * tolerance while halving (fp16) or avoiding (int) float ALU work.
+ *
+ * gaussian5x5_fp16 computes in half when the host defines USE_FP16 (it
+ * does so only if the device reports cl_khr_fp16); otherwise real_t is
+ * float and the kernel is the fp32 fallback of the same variant.
+ *
+ * gaussian5x5_int converts the 2D weights to Q8 fixed point (sum 256 for
+ * normalized weights), accumulates in int and rounds once at the end.
+ */
+#ifdef USE_FP16
+#pragma OPENCL EXTENSION cl_khr_fp16 : enable
+typedef half real_t;
+#else
+typedef float real_t;
+#endif
+
+/** Fixed-point fraction bits of gaussian5x5_int weights */
+#define GAUSSIAN_Q_BITS 8
+
+/**
+ * @brief Gaussian 5x5 blur accumulating in half (float without USE_FP16)
+ *
+ * The weights are normalized in float before conversion, so every tap
+ * weight and the running sum stay within [0, 255] - well inside the half
+ * range (max 65504) with about three significant decimal digits.
+ *
+ * @param input Input image buffer
+ * @param output Output image buffer
+ * @param width Image width
+ * @param height Image height
+ * @param kernel_x Horizontal 1D Gaussian weights (5 floats)
+ * @param kernel_y Vertical 1D Gaussian weights (5 floats)
+ */
+__kernel void gaussian5x5_fp16(__global const uchar* input,
+                               __global uchar* output,
+                               int width,
+                               int height,
+                               __global const float* kernel_x,
+                               __global const float* kernel_y) {
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+
+    if (x >= width || y >= height) return;
+
+    float kernel_sum = 0.0f;
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 5; j++) {
+            kernel_sum += kernel_y[i] * kernel_x[j];
+        }
+    }
+    float inv_sum = 1.0f / kernel_sum;
+
+    real_t sum = (real_t)0.0f;
+    for (int dy = -2; dy <= 2; dy++) {
+        int ny = clamp(y + dy, 0, height - 1);
+        for (int dx = -2; dx <= 2; dx++) {
+            int nx = clamp(x + dx, 0, width - 1);
+            real_t weight = (real_t)(kernel_y[dy + 2] * kernel_x[dx + 2] * inv_sum);
+            sum += (real_t)input[ny * width + nx] * weight;
+        }
+    }
+
+    output[y * width + x] = convert_uchar_sat_rte((float)sum);
+}
+
+/**
+ * @brief Gaussian 5x5 blur in Q8 fixed-point integer arithmetic
+ *
+ * Each 2D weight is rounded to a multiple of 1/256; the accumulator peaks
+ * at 255 * (sum of weights) ~= 65280, far below the int range.
+ *
+ * @param input Input image buffer
+ * @param output Output image buffer
+ * @param width Image width
+ * @param height Image height
+ * @param kernel_x Horizontal 1D Gaussian weights (5 floats)
+ * @param kernel_y Vertical 1D Gaussian weights (5 floats)
+ */
+__kernel void gaussian5x5_int(__global const uchar* input,
+                              __global uchar* output,
+                              int width,
+                              int height,
+                              __global const float* kernel_x,
+                              __global const float* kernel_y) {
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+
+    if (x >= width || y >= height) return;
+
+    float kernel_sum = 0.0f;
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 5; j++) {
+            kernel_sum += kernel_y[i] * kernel_x[j];
+        }
+    }
+    float scale = (float)(1 << GAUSSIAN_Q_BITS) / kernel_sum;
+
+    int weights[25];
+    int weight_sum = 0;
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 5; j++) {
+            weights[i * 5 + j] = convert_int_rte(kernel_y[i] * kernel_x[j] * scale);
+            weight_sum += weights[i * 5 + j];
+        }
+    }
+
+    int sum = 0;
+    for (int dy = -2; dy <= 2; dy++) {
+        int ny = clamp(y + dy, 0, height - 1);
+        for (int dx = -2; dx <= 2; dx++) {
+            int nx = clamp(x + dx, 0, width - 1);
+            sum += (int)input[ny * width + nx] * weights[(dy + 2) * 5 + (dx + 2)];
+        }
+    }
+
+    /* Rounded division by the quantized weight sum (~256) */
+    output[y * width + x] = convert_uchar_sat((sum + weight_sum / 2) / weight_sum);
+}
@@ -1,12 +1,25 @@
 #include <math.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "op_interface.h"
 #include "op_registry.h"
+#include "utils/cpu_features.h"
 #include "utils/safe_ops.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HARRIS_SIMD_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define HARRIS_SIMD_NEON 1
+#endif
+
+/** Input rows read above and below each output row (Sobel 1 + window 2) */
+#define REF_HALO_ROWS 3
+
 /**
  * @file harris_corner_ref.c
  * @brief Harris Corner Detection Reference Implementation
@@ -50,6 +63,317 @@ static void compute_sobel_gradients(const unsigned char* input,
         + (float)input[(y+1) * width + (x+1)] - (float)input[(y-1) * width + (x+1)];
 }
 
+/* Gaussian weights for 5x5 window (sigma ~= 1.0)
+ * OpenCV uses boxFilter by default, but Gaussian gives better results
+ * These weights sum to 1.0 */
+static const float gauss[5][5] = {
+    {0.003765f, 0.015019f, 0.023792f, 0.015019f, 0.003765f},
+    {0.015019f, 0.059912f, 0.094907f, 0.059912f, 0.015019f},
+    {0.023792f, 0.094907f, 0.150342f, 0.094907f, 0.023792f},
+    {0.015019f, 0.059912f, 0.094907f, 0.059912f, 0.015019f},
+    {0.003765f, 0.015019f, 0.023792f, 0.015019f, 0.003765f}
+};
+
+/** Harris parameter (OpenCV default) */
+#define HARRIS_K 0.04f
+
+/**
+ * @brief Harris response at an interior pixel (scalar path)
+ *
+ * Requires 3 <= x < width - 3 and 3 <= y < height - 3 (3 pixels for the
+ * gradient plus the 5x5 window).
+ *
+ * @param input Input image
+ * @param x,y   Pixel coordinates
+ * @param width Image width
+ * @return Harris response R = det(M) - k * trace(M)^2
+ */
+static float harris_response(const unsigned char* input, int x, int y, int width) {
+    int wy;
+    int wx;
+    float Sxx = 0.0f;
+    float Syy = 0.0f;
+    float Sxy = 0.0f;
+    float det;
+    float trace;
+
+    /* Accumulate weighted gradient products (structure tensor)
+     * M = [Sxx Sxy; Sxy Syy] */
+    for (wy = -2; wy <= 2; wy++) {
+        for (wx = -2; wx <= 2; wx++) {
+            float Ix;
+            float Iy;
+            float w;
+
+            /* Compute gradients using Sobel operator (OpenCV default) */
+            compute_sobel_gradients(input, x + wx, y + wy, width, &Ix, &Iy);
+
+            /* Gaussian weight */
+            w = gauss[wy + 2][wx + 2];
+
+            /* Accumulate structure tensor */
+            Sxx += w * Ix * Ix;
+            Syy += w * Iy * Iy;
+            Sxy += w * Ix * Iy;
+        }
+    }
+
+    /* Compute Harris response (OpenCV formula)
+     * R = det(M) - k * trace(M)^2
+     * det(M) = Sxx * Syy - Sxy^2
+     * trace(M) = Sxx + Syy */
+    det = Sxx * Syy - Sxy * Sxy;
+    trace = Sxx + Syy;
+    return det - HARRIS_K * trace * trace;
+}
+
+/*
+ * Interior fast paths: each vector holds N adjacent pixels of row y, which
+ * must all be interior (x >= 3 and x + N + 3 <= width). Every lane follows
+ * the scalar expression order (Sobel terms left to right, (w * Ix) * Ix,
+ * separate multiplies and adds), so results match harris_response bit for
+ * bit. Each returns the first column it did not process.
+ */
+#if defined(HARRIS_SIMD_X86)
+/* Load 4 pixels and widen them to floats */
+__attribute__((target("sse2"))) static inline __m128 load_u8x4_sse2(const unsigned char* src) {
+    int packed;
+    __m128i zero = _mm_setzero_si128();
+    __m128i v;
+
+    (void)memcpy(&packed, src, sizeof(packed));
+    v = _mm_cvtsi32_si128(packed);
+    v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+    return _mm_cvtepi32_ps(v);
+}
+
+/* Sobel gradients for 4 pixels starting at (px, py) */
+__attribute__((target("sse2"))) static inline void sobel_sse2(const unsigned char* input,
+                                                              int px, int py, int width,
+                                                              __m128* Ix, __m128* Iy) {
+    const unsigned char* above = input + ((py - 1) * width) + px;
+    const unsigned char* row = input + (py * width) + px;
+    const unsigned char* below = input + ((py + 1) * width) + px;
+    const __m128 two = _mm_set1_ps(2.0f);
+    __m128 al = load_u8x4_sse2(above - 1);
+    __m128 ac = load_u8x4_sse2(above);
+    __m128 ar = load_u8x4_sse2(above + 1);
+    __m128 rl = load_u8x4_sse2(row - 1);
+    __m128 rr = load_u8x4_sse2(row + 1);
+    __m128 bl = load_u8x4_sse2(below - 1);
+    __m128 bc = load_u8x4_sse2(below);
+    __m128 br = load_u8x4_sse2(below + 1);
+
+    *Ix = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_sub_ps(ar, al),
+                                           _mm_mul_ps(two, _mm_sub_ps(rr, rl))), br), bl);
+    *Iy = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_sub_ps(bl, al),
+                                           _mm_mul_ps(two, _mm_sub_ps(bc, ac))), br), ar);
+}
+
+__attribute__((target("sse2"))) static int harris_row_sse2(const unsigned char* input,
+                                                           float* output, int y, int x,
+                                                           int width) {
+    const __m128 k = _mm_set1_ps(HARRIS_K);
+    __m128 Sxx;
+    __m128 Syy;
+    __m128 Sxy;
+    __m128 Ix;
+    __m128 Iy;
+    __m128 w;
+    __m128 wIx;
+    __m128 trace;
+    int wy;
+    int wx;
+
+    while ((x + 4 + 3) <= width) {
+        Sxx = _mm_setzero_ps();
+        Syy = _mm_setzero_ps();
+        Sxy = _mm_setzero_ps();
+        for (wy = -2; wy <= 2; wy++) {
+            for (wx = -2; wx <= 2; wx++) {
+                sobel_sse2(input, x + wx, y + wy, width, &Ix, &Iy);
+                w = _mm_set1_ps(gauss[wy + 2][wx + 2]);
+                wIx = _mm_mul_ps(w, Ix);
+                Sxx = _mm_add_ps(Sxx, _mm_mul_ps(wIx, Ix));
+                Syy = _mm_add_ps(Syy, _mm_mul_ps(_mm_mul_ps(w, Iy), Iy));
+                Sxy = _mm_add_ps(Sxy, _mm_mul_ps(wIx, Iy));
+            }
+        }
+        trace = _mm_add_ps(Sxx, Syy);
+        _mm_storeu_ps(output + (y * width) + x,
+                      _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(Sxx, Syy), _mm_mul_ps(Sxy, Sxy)),
+                                 _mm_mul_ps(_mm_mul_ps(k, trace), trace)));
+        x += 4;
+    }
+
+    return x;
+}
+
+/* Load 8 pixels and widen them to floats */
+__attribute__((target("avx2"))) static inline __m256 load_u8x8_avx2(const unsigned char* src) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src)));
+}
+
+/* Sobel gradients for 8 pixels starting at (px, py) */
+__attribute__((target("avx2"))) static inline void sobel_avx2(const unsigned char* input,
+                                                              int px, int py, int width,
+                                                              __m256* Ix, __m256* Iy) {
+    const unsigned char* above = input + ((py - 1) * width) + px;
+    const unsigned char* row = input + (py * width) + px;
+    const unsigned char* below = input + ((py + 1) * width) + px;
+    const __m256 two = _mm256_set1_ps(2.0f);
+    __m256 al = load_u8x8_avx2(above - 1);
+    __m256 ac = load_u8x8_avx2(above);
+    __m256 ar = load_u8x8_avx2(above + 1);
+    __m256 rl = load_u8x8_avx2(row - 1);
+    __m256 rr = load_u8x8_avx2(row + 1);
+    __m256 bl = load_u8x8_avx2(below - 1);
+    __m256 bc = load_u8x8_avx2(below);
+    __m256 br = load_u8x8_avx2(below + 1);
+
+    *Ix = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_sub_ps(ar, al),
+                                                    _mm256_mul_ps(two, _mm256_sub_ps(rr, rl))),
+                                      br), bl);
+    *Iy = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_sub_ps(bl, al),
+                                                    _mm256_mul_ps(two, _mm256_sub_ps(bc, ac))),
+                                      br), ar);
+}
+
+__attribute__((target("avx2"))) static int harris_row_avx2(const unsigned char* input,
+                                                           float* output, int y, int x,
+                                                           int width) {
+    const __m256 k = _mm256_set1_ps(HARRIS_K);
+    __m256 Sxx;
+    __m256 Syy;
+    __m256 Sxy;
+    __m256 Ix;
+    __m256 Iy;
+    __m256 w;
+    __m256 wIx;
+    __m256 trace;
+    int wy;
+    int wx;
+
+    while ((x + 8 + 3) <= width) {
+        Sxx = _mm256_setzero_ps();
+        Syy = _mm256_setzero_ps();
+        Sxy = _mm256_setzero_ps();
+        for (wy = -2; wy <= 2; wy++) {
+            for (wx = -2; wx <= 2; wx++) {
+                sobel_avx2(input, x + wx, y + wy, width, &Ix, &Iy);
+                w = _mm256_set1_ps(gauss[wy + 2][wx + 2]);
+                wIx = _mm256_mul_ps(w, Ix);
+                Sxx = _mm256_add_ps(Sxx, _mm256_mul_ps(wIx, Ix));
+                Syy = _mm256_add_ps(Syy, _mm256_mul_ps(_mm256_mul_ps(w, Iy), Iy));
+                Sxy = _mm256_add_ps(Sxy, _mm256_mul_ps(wIx, Iy));
+            }
+        }
+        trace = _mm256_add_ps(Sxx, Syy);
+        _mm256_storeu_ps(output + (y * width) + x,
+                         _mm256_sub_ps(_mm256_sub_ps(_mm256_mul_ps(Sxx, Syy),
+                                                     _mm256_mul_ps(Sxy, Sxy)),
+                                       _mm256_mul_ps(_mm256_mul_ps(k, trace), trace)));
+        x += 8;
+    }
+
+    return harris_row_sse2(input, output, y, x, width);
+}
+#endif
+
+#if defined(HARRIS_SIMD_NEON)
+/* Load 4 pixels and widen them to floats */
+static inline float32x4_t load_u8x4_neon(const unsigned char* src) {
+    uint32_t packed;
+
+    (void)memcpy(&packed, src, sizeof(packed));
+    return vcvtq_f32_u32(
+        vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(packed))))));
+}
+
+/* Sobel gradients for 4 pixels starting at (px, py) */
+static inline void sobel_neon(const unsigned char* input, int px, int py, int width,
+                              float32x4_t* Ix, float32x4_t* Iy) {
+    const unsigned char* above = input + ((py - 1) * width) + px;
+    const unsigned char* row = input + (py * width) + px;
+    const unsigned char* below = input + ((py + 1) * width) + px;
+    const float32x4_t two = vdupq_n_f32(2.0f);
+    float32x4_t al = load_u8x4_neon(above - 1);
+    float32x4_t ac = load_u8x4_neon(above);
+    float32x4_t ar = load_u8x4_neon(above + 1);
+    float32x4_t rl = load_u8x4_neon(row - 1);
+    float32x4_t rr = load_u8x4_neon(row + 1);
+    float32x4_t bl = load_u8x4_neon(below - 1);
+    float32x4_t bc = load_u8x4_neon(below);
+    float32x4_t br = load_u8x4_neon(below + 1);
+
+    *Ix = vsubq_f32(vaddq_f32(vaddq_f32(vsubq_f32(ar, al), vmulq_f32(two, vsubq_f32(rr, rl))),
+                              br), bl);
+    *Iy = vsubq_f32(vaddq_f32(vaddq_f32(vsubq_f32(bl, al), vmulq_f32(two, vsubq_f32(bc, ac))),
+                              br), ar);
+}
+
+static int harris_row_neon(const unsigned char* input, float* output, int y, int x, int width) {
+    const float32x4_t k = vdupq_n_f32(HARRIS_K);
+    float32x4_t Sxx;
+    float32x4_t Syy;
+    float32x4_t Sxy;
+    float32x4_t Ix;
+    float32x4_t Iy;
+    float32x4_t w;
+    float32x4_t wIx;
+    float32x4_t trace;
+    int wy;
+    int wx;
+
+    while ((x + 4 + 3) <= width) {
+        Sxx = vdupq_n_f32(0.0f);
+        Syy = vdupq_n_f32(0.0f);
+        Sxy = vdupq_n_f32(0.0f);
+        for (wy = -2; wy <= 2; wy++) {
+            for (wx = -2; wx <= 2; wx++) {
+                sobel_neon(input, x + wx, y + wy, width, &Ix, &Iy);
+                w = vdupq_n_f32(gauss[wy + 2][wx + 2]);
+                /* vmul + vadd, not vmla/vfma: keeps the scalar rounding */
+                wIx = vmulq_f32(w, Ix);
+                Sxx = vaddq_f32(Sxx, vmulq_f32(wIx, Ix));
+                Syy = vaddq_f32(Syy, vmulq_f32(vmulq_f32(w, Iy), Iy));
+                Sxy = vaddq_f32(Sxy, vmulq_f32(wIx, Iy));
+            }
+        }
+        trace = vaddq_f32(Sxx, Syy);
+        vst1q_f32(output + (y * width) + x,
+                  vsubq_f32(vsubq_f32(vmulq_f32(Sxx, Syy), vmulq_f32(Sxy, Sxy)),
+                            vmulq_f32(vmulq_f32(k, trace), trace)));
+        x += 4;
+    }
+
+    return x;
+}
+#endif
+
+/* Run the widest available interior path over row y from column x */
+static int harris_row_simd(CpuSimd simd, const unsigned char* input, float* output, int y,
+                           int x, int width) {
+#if defined(HARRIS_SIMD_X86)
+    if (simd == CPU_SIMD_AVX2) {
+        return harris_row_avx2(input, output, y, x, width);
+    }
+    if (simd == CPU_SIMD_SSE2) {
+        return harris_row_sse2(input, output, y, x, width);
+    }
+#elif defined(HARRIS_SIMD_NEON)
+    if (simd == CPU_SIMD_NEON) {
+        return harris_row_neon(input, output, y, x, width);
+    }
+#endif
+    (void)simd;
+    (void)input;
+    (void)output;
+    (void)y;
+    (void)width;
+    return x;
+}
+
 /**
  * @brief Harris Corner Detection reference implementation
  *
@@ -61,35 +385,28 @@ static void compute_sobel_gradients(const unsigned char* input,
  * 2. Build structure tensor M = [Sxx Sxy; Sxy Syy] with Gaussian weighting
  * 3. Compute Harris response: R = det(M) - k * trace(M)^2
  *
+ * Interior rows use the SIMD path selected by CpuSimdLevel(); borders and
+ * row tails use the scalar path. Only output rows [row_begin, row_end) are
+ * written, so disjoint ranges may run concurrently.
+ *
  * Reference: OpenCV modules/imgproc/src/corner.cpp - cornerEigenValsVecs()
  *
  * @param[in] params Operation parameters containing:
  *   - input: Input grayscale image
  *   - output: Harris response map (float)
  *   - src_width, src_height: Image dimensions
+ * @param[in] row_begin First output row to compute
+ * @param[in] row_end One past the last output row to compute
  */
-void HarrisCornerRef(const OpParams* params) {
+void HarrisCornerRefRows(const OpParams* params, int row_begin, int row_end) {
     int y;
     int x;
-    int wy;
-    int wx;
     int width;
     int height;
     unsigned char* input;
     float* output;
     int total_pixels;
-    float k;
-
-    /* Gaussian weights for 5x5 window (sigma ~= 1.0)
-     * OpenCV uses boxFilter by default, but Gaussian gives better results
-     * These weights sum to 1.0 */
-    static const float gauss[5][5] = {
-        {0.003765f, 0.015019f, 0.023792f, 0.015019f, 0.003765f},
-        {0.015019f, 0.059912f, 0.094907f, 0.059912f, 0.015019f},
-        {0.023792f, 0.094907f, 0.150342f, 0.094907f, 0.023792f},
-        {0.015019f, 0.059912f, 0.094907f, 0.059912f, 0.015019f},
-        {0.003765f, 0.015019f, 0.023792f, 0.015019f, 0.003765f}
-    };
+    CpuSimd simd;
 
     if (params == NULL) {
         return;
@@ -100,7 +417,6 @@ void HarrisCornerRef(const OpParams* params) {
     output = (float*)params->output;
     width = params->src_width;
     height = params->src_height;
-    k = 0.04f; /* Harris parameter (OpenCV default) */
 
     if ((input == NULL) || (output == NULL) ||
         (width <= 0) || (height <= 0)) {
@@ -112,15 +428,28 @@ void HarrisCornerRef(const OpParams* params) {
         return;
     }
 
-    for (y = 0; y < height; y++) {
-        for (x = 0; x < width; x++) {
+    if (row_begin < 0) {
+        row_begin = 0;
+    }
+    if (row_end > height) {
+        row_end = height;
+    }
+
+    simd = CpuSimdLevel();
+
+    for (y = row_begin; y < row_end; y++) {
+        x = 0;
+
+        /* Interior rows: zero left border, SIMD body, scalar tail below */
+        if ((y >= 3) && (y < height - 3)) {
+            for (; (x < 3) && (x < width); x++) {
+                output[y * width + x] = 0.0f;
+            }
+            x = harris_row_simd(simd, input, output, y, x, width);
+        }
+
+        for (; x < width; x++) {
             int idx = y * width + x;
-            float Sxx = 0.0f;
-            float Syy = 0.0f;
-            float Sxy = 0.0f;
-            float det;
-            float trace;
-            float response;
 
             /* Skip border pixels (need 3 pixels for gradient + 2 for window) */
             if ((x < 3) || (x >= width - 3) ||
@@ -129,42 +458,24 @@ void HarrisCornerRef(const OpParams* params) {
                 continue;
             }
 
-            /* Accumulate weighted gradient products (structure tensor)
-             * M = [Sxx Sxy; Sxy Syy] */
-            for (wy = -2; wy <= 2; wy++) {
-                for (wx = -2; wx <= 2; wx++) {
-                    int px = x + wx;
-                    int py = y + wy;
-                    float Ix;
-                    float Iy;
-                    float w;
-
-                    /* Compute gradients using Sobel operator (OpenCV default) */
-                    compute_sobel_gradients(input, px, py, width, &Ix, &Iy);
-
-                    /* Gaussian weight */
-                    w = gauss[wy + 2][wx + 2];
-
-                    /* Accumulate structure tensor */
-                    Sxx += w * Ix * Ix;
-                    Syy += w * Iy * Iy;
-                    Sxy += w * Ix * Iy;
-                }
-            }
-
-            /* Compute Harris response (OpenCV formula)
-             * R = det(M) - k * trace(M)^2
-             * det(M) = Sxx * Syy - Sxy^2
-             * trace(M) = Sxx + Syy */
-            det = Sxx * Syy - Sxy * Sxy;
-            trace = Sxx + Syy;
-            response = det - k * trace * trace;
-
-            output[idx] = response;
+            output[idx] = harris_response(input, x, y, width);
         }
     }
 }
 
+/**
+ * @brief Harris Corner Detection reference implementation (whole image)
+ *
+ * @param[in] params Operation parameters (see HarrisCornerRefRows)
+ */
+void HarrisCornerRef(const OpParams* params) {
+    if (params == NULL) {
+        return;
+    }
+
+    HarrisCornerRefRows(params, 0, params->src_height);
+}
+
 /**
  * @brief Non-maximum suppression reference implementation
  *
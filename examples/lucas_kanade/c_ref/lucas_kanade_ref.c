@@ -1,5 +1,7 @@
 #include <math.h>
 #include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "op_interface.h"
 #include "op_registry.h"
@@ -7,25 +9,61 @@
 
 /**
  * @file lucas_kanade_ref.c
- * @brief Lucas-Kanade Optical Flow Reference Implementation
+ * @brief Pyramidal Lucas-Kanade Optical Flow Reference Implementation
  *
  * Based on OpenCV's Lucas-Kanade implementation.
- * Computes dense optical flow between two consecutive frames.
+ * Computes dense optical flow between two consecutive frames, coarse to fine
+ * over a Gaussian image pyramid.
  *
  * Algorithm:
- * 1. Compute spatial gradients Ix, Iy using Scharr operator
- * 2. Compute temporal gradient It = I2 - I1
- * 3. Build structure tensor A and vector b over a window
- * 4. Solve 2x2 linear system: A * v = b
+ * 1. Build a pyramid of both frames (5x5 binomial filter, 2x decimation)
+ * 2. At the coarsest level start from zero flow; at every finer level start
+ *    from twice the flow of the coarser level at (x/2, y/2)
+ * 3. Compute spatial gradients Ix, Iy of the previous frame (Scharr)
+ * 4. Build structure tensor A over a window and refine the flow iteratively:
+ *    It = I2(p + v) - I1(p), solve A * dv = b, v += dv
+ *
+ * With "pyramid_levels" = 1 this is single-level iterative dense LK. The
+ * arithmetic mirrors pyr_down and lucas_kanade_pyr_level in
+ * lucas_kanade_2.cl, so the output is the golden for the pyramid pipeline
+ * (test_data/lucas_kanade/golden_pyr_flow_x.bin, 3 levels).
+ *
+ * Buffers: params->input holds the previous frame, the "curr_frame" custom
+ * buffer the current frame; flow_x is written to params->output and flow_y
+ * to the "flow_y" named output, or the custom buffer of that name when it
+ * has host memory.
  *
  * OpenCV Reference:
  *   - C++ implementation: https://github.com/opencv/opencv/blob/4.x/modules/video/src/lkpyramid.cpp
  *     (see calcOpticalFlowPyrLK, LKTrackerInvoker, calcScharrDeriv)
  *   - Scharr derivatives: https://github.com/opencv/opencv/blob/4.x/modules/imgproc/src/deriv.cpp
+ *   - Pyramid: https://github.com/opencv/opencv/blob/4.x/modules/imgproc/src/pyramids.cpp
  */
 
 /* Constants for tracking quality */
-#define MIN_EIGENVAL_THRESHOLD 1e-4f
+#define MIN_EIGENVAL_THRESHOLD 1.0f
+#define CONVERGENCE_THRESHOLD 0.01f
+
+/** Scharr weights sum to 32 across the two-pixel baseline */
+#define SCHARR_SCALE (1.0f / 32.0f)
+
+/** Pyramid levels supported by the reference */
+#define LK_MAX_LEVELS 6
+
+/** Largest window side cached by the reference */
+#define LK_MAX_WINDOW 15
+
+/** Largest frame (pixels) the reference has scratch memory for */
+#define LK_MAX_PIXELS (1920 * 1088)
+
+/* MISRA-C:2023 Rule 21.3: Static scratch instead of dynamic allocation.
+ * Levels >= 1 of both pyramids are packed back to back (< 1/3 of level 0);
+ * flow uses the output for level 0 and two ping-pong planes for coarser levels. */
+static unsigned char pyr_prev[LK_MAX_PIXELS / 2];
+static unsigned char pyr_curr[LK_MAX_PIXELS / 2];
+static float level_flow_x[2][LK_MAX_PIXELS / 4];
+static float level_flow_y[2][LK_MAX_PIXELS / 4];
+static float flow_y_scratch[LK_MAX_PIXELS];
 
 /**
  * @brief Compute Scharr gradients at a pixel
@@ -56,140 +94,339 @@ static void compute_scharr_gradients(const unsigned char* input,
         + 3.0f * ((float)input[(y+1) * width + (x+1)] - (float)input[(y-1) * width + (x+1)]);
 }
 
-/**
- * @brief Lucas-Kanade Optical Flow reference implementation
- *
- * CPU implementation of Lucas-Kanade optical flow algorithm following
- * OpenCV's approach. Computes motion vectors between two consecutive frames.
- *
- * Reference: OpenCV modules/video/src/lkpyramid.cpp
- *
- * @param[in] params Operation parameters containing:
- *   - input: Previous frame (grayscale)
- *   - output: Current frame (grayscale) - NOTE: uses output as second input
- *   - src_width, src_height: Frame dimensions
- */
-void LucasKanadeRef(const OpParams* params) {
-    int y;
-    int x;
-    int wy;
-    int wx;
-    int width;
-    int height;
-    unsigned char* prev_frame;
-    unsigned char* curr_frame;
-    float* flow_x;
-    float* flow_y;
-    int total_pixels;
-    int window_size;
-    int half_win;
+/* Bilinear sample with coordinates clamped to the image (matches bilinear_sample) */
+static float bilinear_sample(const unsigned char* input, float x, float y,
+                             int width, int height) {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+    float fx;
+    float fy;
+    float v0;
+    float v1;
 
-    if (params == NULL) {
-        return;
-    }
+    x = fmaxf(0.0f, fminf(x, (float)(width - 1)));
+    y = fmaxf(0.0f, fminf(y, (float)(height - 1)));
 
-    /* Extract parameters */
-    prev_frame = params->input;
-    curr_frame = params->output; /* Using output as second input for now */
-    width = params->src_width;
-    height = params->src_height;
-    window_size = 5; /* Default window size (OpenCV typically uses 21) */
-    half_win = window_size / 2;
+    x0 = (int)floorf(x);
+    y0 = (int)floorf(y);
+    x1 = (x0 + 1 < width) ? (x0 + 1) : (width - 1);
+    y1 = (y0 + 1 < height) ? (y0 + 1) : (height - 1);
+    fx = x - (float)x0;
+    fy = y - (float)y0;
 
-    if ((prev_frame == NULL) || (curr_frame == NULL) ||
-        (width <= 0) || (height <= 0)) {
-        return;
-    }
+    v0 = (float)input[y0 * width + x0] +
+         fx * ((float)input[y0 * width + x1] - (float)input[y0 * width + x0]);
+    v1 = (float)input[y1 * width + x0] +
+         fx * ((float)input[y1 * width + x1] - (float)input[y1 * width + x0]);
+    return v0 + fy * (v1 - v0);
+}
 
-    /* MISRA-C:2023 Rule 1.3: Check for integer overflow */
-    if (!SafeMulInt(width, height, &total_pixels)) {
-        return;
+/* Reflect-101 border (gfedcb|abcdefgh|gfedcba), as cv::pyrDown */
+static int Reflect101(int i, int n) {
+    if (n == 1) {
+        return 0;
     }
-
-    /* Get output buffers from custom buffers */
-    if ((params->custom_buffers == NULL) || (params->custom_buffers->count < 2)) {
-        return;
+    if (i < 0) {
+        i = -i;
+    }
+    if (i >= n) {
+        i = (2 * n) - 2 - i;
     }
+    return i;
+}
 
-    flow_x = (float*)params->custom_buffers->buffers[0].host_data;
-    flow_y = (float*)params->custom_buffers->buffers[1].host_data;
+/**
+ * @brief Downsample by 2 with the 5x5 binomial filter [1 4 6 4 1]^2 / 256
+ *
+ * dst(x, y) is centered on src(2x, 2y); results are rounded to nearest.
+ * Matches pyr_down_u8() in include/cl/pyramid.h.
+ */
+static void PyrDown(const unsigned char* src, int src_width, int src_height,
+                    unsigned char* dst, int dst_width, int dst_height) {
+    static const int kBinomial[5] = {1, 4, 6, 4, 1};
+    int x;
+    int y;
+    int i;
+    int j;
 
-    if ((flow_x == NULL) || (flow_y == NULL)) {
-        return;
+    for (y = 0; y < dst_height; y++) {
+        for (x = 0; x < dst_width; x++) {
+            int sum = 0;
+
+            for (j = 0; j < 5; j++) {
+                int sy = Reflect101((2 * y) + j - 2, src_height);
+                for (i = 0; i < 5; i++) {
+                    int sx = Reflect101((2 * x) + i - 2, src_width);
+                    sum += kBinomial[j] * kBinomial[i] * (int)src[(sy * src_width) + sx];
+                }
+            }
+            dst[(y * dst_width) + x] = (unsigned char)((sum + 128) >> 8);
+        }
     }
+}
+
+/**
+ * @brief Iterative LK at one pyramid level, seeded from the coarser level
+ *
+ * @param coarse_x,coarse_y Flow of the coarser level ((width+1)/2 wide), NULL at the top
+ */
+static void LucasKanadeLevel(const unsigned char* prev_frame, const unsigned char* curr_frame,
+                             int width, int height, const float* coarse_x,
+                             const float* coarse_y, float* flow_x, float* flow_y,
+                             int half_win, int max_iters) {
+    float grad_x[LK_MAX_WINDOW * LK_MAX_WINDOW];
+    float grad_y[LK_MAX_WINDOW * LK_MAX_WINDOW];
+    int coarse_width = (width + 1) / 2;
+    int coarse_height = (height + 1) / 2;
+    int window_pixels = ((2 * half_win) + 1) * ((2 * half_win) + 1);
+    int y;
+    int x;
 
     for (y = 0; y < height; y++) {
         for (x = 0; x < width; x++) {
             int idx = y * width + x;
+            float guess_x = 0.0f;
+            float guess_y = 0.0f;
             float A11 = 0.0f;  /* sum_Ix2 */
             float A22 = 0.0f;  /* sum_Iy2 */
             float A12 = 0.0f;  /* sum_IxIy */
-            float b1 = 0.0f;   /* -sum_IxIt */
-            float b2 = 0.0f;   /* -sum_IyIt */
             float det;
             float min_eigenval;
             float inv_det;
             float vx;
             float vy;
+            int iter;
+            int wy;
+            int wx;
+            int k;
 
-            /* Skip border pixels */
+            /* Initial guess: coarser flow, upsampled and scaled to this level */
+            if (coarse_x != NULL) {
+                int cx = ((x / 2) < coarse_width) ? (x / 2) : (coarse_width - 1);
+                int cy = ((y / 2) < coarse_height) ? (y / 2) : (coarse_height - 1);
+                guess_x = 2.0f * coarse_x[(cy * coarse_width) + cx];
+                guess_y = 2.0f * coarse_y[(cy * coarse_width) + cx];
+            }
+
+            /* Border pixels keep the propagated guess */
             if ((x < half_win + 1) || (x >= width - half_win - 1) ||
                 (y < half_win + 1) || (y >= height - half_win - 1)) {
-                flow_x[idx] = 0.0f;
-                flow_y[idx] = 0.0f;
+                flow_x[idx] = guess_x;
+                flow_y[idx] = guess_y;
                 continue;
             }
 
-            /* Accumulate structure tensor over window
-             * A = [A11 A12]    b = [b1]
-             *     [A12 A22]        [b2] */
+            /* Structure tensor from the previous frame (constant over iterations) */
+            k = 0;
             for (wy = -half_win; wy <= half_win; wy++) {
                 for (wx = -half_win; wx <= half_win; wx++) {
-                    int px = x + wx;
-                    int py = y + wy;
                     float Ix;
                     float Iy;
-                    float It;
-
-                    /* Spatial gradients using Scharr operator (OpenCV style) */
-                    compute_scharr_gradients(prev_frame, px, py, width, &Ix, &Iy);
-
-                    /* Temporal gradient */
-                    It = (float)curr_frame[py * width + px] -
-                         (float)prev_frame[py * width + px];
 
-                    /* Accumulate */
+                    compute_scharr_gradients(prev_frame, x + wx, y + wy, width, &Ix, &Iy);
+                    Ix *= SCHARR_SCALE;
+                    Iy *= SCHARR_SCALE;
+                    grad_x[k] = Ix;
+                    grad_y[k] = Iy;
                     A11 += Ix * Ix;
                     A22 += Iy * Iy;
                     A12 += Ix * Iy;
-                    b1 -= Ix * It;
-                    b2 -= Iy * It;
+                    k++;
                 }
             }
 
-            /* Solve 2x2 system using Cramer's rule
-             * det(A) = A11*A22 - A12*A12
-             * Check for trackability using minimum eigenvalue (OpenCV approach) */
+            /* Trackability: minimum eigenvalue per window pixel (OpenCV approach) */
             det = A11 * A22 - A12 * A12;
             min_eigenval = (A11 + A22 - sqrtf((A11 - A22) * (A11 - A22) + 4.0f * A12 * A12)) * 0.5f;
+            if ((det <= 0.0f) ||
+                (min_eigenval < MIN_EIGENVAL_THRESHOLD * (float)window_pixels)) {
+                flow_x[idx] = guess_x;
+                flow_y[idx] = guess_y;
+                continue;
+            }
+            inv_det = 1.0f / det;
+
+            /* Newton-Raphson refinement starting from the guess */
+            vx = guess_x;
+            vy = guess_y;
+            for (iter = 0; iter < max_iters; iter++) {
+                float b1 = 0.0f;  /* -sum_IxIt */
+                float b2 = 0.0f;  /* -sum_IyIt */
+                float dvx;
+                float dvy;
 
-            if ((fabsf(det) < MIN_EIGENVAL_THRESHOLD) ||
-                (min_eigenval < MIN_EIGENVAL_THRESHOLD)) {
-                /* Flat region or aperture problem */
-                flow_x[idx] = 0.0f;
-                flow_y[idx] = 0.0f;
-            } else {
-                /* Compute flow using Cramer's rule */
-                inv_det = 1.0f / det;
-                vx = (A22 * b1 - A12 * b2) * inv_det;
-                vy = (A11 * b2 - A12 * b1) * inv_det;
-                flow_x[idx] = vx;
-                flow_y[idx] = vy;
+                k = 0;
+                for (wy = -half_win; wy <= half_win; wy++) {
+                    for (wx = -half_win; wx <= half_win; wx++) {
+                        int px = x + wx;
+                        int py = y + wy;
+                        float I2 = bilinear_sample(curr_frame, (float)px + vx, (float)py + vy,
+                                                   width, height);
+                        float It = I2 - (float)prev_frame[py * width + px];
+
+                        b1 -= grad_x[k] * It;
+                        b2 -= grad_y[k] * It;
+                        k++;
+                    }
+                }
+
+                dvx = (A22 * b1 - A12 * b2) * inv_det;
+                dvy = (A11 * b2 - A12 * b1) * inv_det;
+                vx += dvx;
+                vy += dvy;
+                if ((fabsf(dvx) < CONVERGENCE_THRESHOLD) && (fabsf(dvy) < CONVERGENCE_THRESHOLD)) {
+                    break;
+                }
             }
+
+            /* A solution beyond the window is a lost track: keep the guess */
+            if ((fabsf(vx - guess_x) > (float)(half_win + 1)) ||
+                (fabsf(vy - guess_y) > (float)(half_win + 1))) {
+                vx = guess_x;
+                vy = guess_y;
+            }
+            flow_x[idx] = vx;
+            flow_y[idx] = vy;
         }
     }
 }
 
+/* Int scalar from custom_scalars, or @p fallback when not configured */
+static int GetIntScalar(const OpParams* params, const char* name, int fallback) {
+    int i;
+
+    if (params->custom_scalars != NULL) {
+        for (i = 0; i < params->custom_scalars->count; i++) {
+            if (strcmp(params->custom_scalars->scalars[i].name, name) == 0) {
+                return params->custom_scalars->scalars[i].value.int_value;
+            }
+        }
+    }
+    return fallback;
+}
+
+/* Host data of the custom buffer @p name, NULL if absent or not host-backed */
+static unsigned char* GetCustomHostData(const OpParams* params, const char* name) {
+    int i;
+
+    if (params->custom_buffers != NULL) {
+        for (i = 0; i < params->custom_buffers->count; i++) {
+            if (strcmp(params->custom_buffers->buffers[i].name, name) == 0) {
+                return params->custom_buffers->buffers[i].host_data;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Host data of the named output @p name, falling back to the custom buffer of that name */
+static unsigned char* GetOutputHostData(const OpParams* params, const char* name) {
+    int i;
+
+    if (params->outputs != NULL) {
+        for (i = 0; i < params->outputs->count; i++) {
+            if (strcmp(params->outputs->buffers[i].name, name) == 0) {
+                return params->outputs->buffers[i].host_data;
+            }
+        }
+    }
+    return GetCustomHostData(params, name);
+}
+
+/**
+ * @brief Pyramidal Lucas-Kanade Optical Flow reference implementation
+ *
+ * CPU implementation of coarse-to-fine dense Lucas-Kanade optical flow
+ * following OpenCV's approach.
+ *
+ * Reference: OpenCV modules/video/src/lkpyramid.cpp
+ *
+ * @param[in] params Operation parameters containing:
+ *   - input: Previous frame (grayscale)
+ *   - output: Horizontal flow (float, src_width * src_height)
+ *   - outputs / custom_buffers: "flow_y" (optional vertical flow, named output first)
+ *   - custom_buffers: "curr_frame" (current frame)
+ *   - custom_scalars: window_size (default 5), max_iters (default 10),
+ *     pyramid_levels (default 1)
+ *   - src_width, src_height: Frame dimensions
+ */
+void LucasKanadeRef(const OpParams* params) {
+    const unsigned char* prev_level[LK_MAX_LEVELS];
+    const unsigned char* curr_level[LK_MAX_LEVELS];
+    int level_width[LK_MAX_LEVELS];
+    int level_height[LK_MAX_LEVELS];
+    const unsigned char* curr_frame;
+    const float* coarse_x = NULL;
+    const float* coarse_y = NULL;
+    float* flow_x;
+    float* flow_y;
+    size_t offset = 0U;
+    int total_pixels;
+    int half_win;
+    int max_iters;
+    int levels;
+    int level;
+
+    if ((params == NULL) || (params->input == NULL) || (params->output == NULL)) {
+        return;
+    }
+
+    curr_frame = GetCustomHostData(params, "curr_frame");
+    half_win = GetIntScalar(params, "window_size", 5) / 2;
+    max_iters = GetIntScalar(params, "max_iters", 10);
+    levels = GetIntScalar(params, "pyramid_levels", 1);
+
+    /* MISRA-C:2023 Rule 1.3: Check for integer overflow */
+    if ((curr_frame == NULL) || (params->src_width <= 0) || (params->src_height <= 0) ||
+        !SafeMulInt(params->src_width, params->src_height, &total_pixels)) {
+        return;
+    }
+    if ((total_pixels > LK_MAX_PIXELS) || (levels < 1) || (levels > LK_MAX_LEVELS) ||
+        (half_win < 1) || (((2 * half_win) + 1) > LK_MAX_WINDOW)) {
+        (void)fprintf(stderr, "Error: Lucas-Kanade reference supports up to %d pixels, "
+                              "1-%d levels and windows of 3-%d\n",
+                      LK_MAX_PIXELS, LK_MAX_LEVELS, LK_MAX_WINDOW);
+        return;
+    }
+
+    flow_x = (float*)params->output;
+    flow_y = (float*)GetOutputHostData(params, "flow_y");
+    if (flow_y == NULL) {
+        flow_y = flow_y_scratch;
+    }
+
+    /* Step 1: Pyramids of both frames */
+    prev_level[0] = params->input;
+    curr_level[0] = curr_frame;
+    level_width[0] = params->src_width;
+    level_height[0] = params->src_height;
+    for (level = 1; level < levels; level++) {
+        level_width[level] = (level_width[level - 1] + 1) / 2;
+        level_height[level] = (level_height[level - 1] + 1) / 2;
+        prev_level[level] = &pyr_prev[offset];
+        curr_level[level] = &pyr_curr[offset];
+        PyrDown(prev_level[level - 1], level_width[level - 1], level_height[level - 1],
+                &pyr_prev[offset], level_width[level], level_height[level]);
+        PyrDown(curr_level[level - 1], level_width[level - 1], level_height[level - 1],
+                &pyr_curr[offset], level_width[level], level_height[level]);
+        offset += (size_t)level_width[level] * (size_t)level_height[level];
+    }
+
+    /* Step 2: Coarse to fine; level flow ping-pongs between the two planes */
+    for (level = levels - 1; level >= 0; level--) {
+        float* out_x = (level == 0) ? flow_x : level_flow_x[level % 2];
+        float* out_y = (level == 0) ? flow_y : level_flow_y[level % 2];
+
+        LucasKanadeLevel(prev_level[level], curr_level[level], level_width[level],
+                         level_height[level], coarse_x, coarse_y, out_x, out_y, half_win,
+                         max_iters);
+        coarse_x = out_x;
+        coarse_y = out_y;
+    }
+}
+
 /*
  * NOTE: Registration of this algorithm happens in auto_registry.c
  * Auto-generated by scripts/generate_registry.sh which scans for *_ref.c files.
@@ -0,0 +1,402 @@
+/**
+ * @file lucas_kanade_2.cl
+ * @brief Pyramidal (coarse-to-fine) and sparse Lucas-Kanade kernels
+ *
+ * Kernels for a pipeline with a "pyramid" section (see docs): pyr_down
+ * builds one pyramid level of a frame, lucas_kanade_pyr_level runs
+ * iterative LK at one level, seeded with the flow of the coarser level.
+ * The pipeline launches pyr_down once per image and level, then
+ * lucas_kanade_pyr_level from the coarsest level to level 0, all on the
+ * device; the host only reads back the level-0 flow.
+ *
+ * Sparse tracking: compact_keypoints turns a corner map (harris_nms) into
+ * a keypoint list with a count, and lucas_kanade_sparse runs the same
+ * coarse-to-fine levels for the listed points only. sparse_flow_clear
+ * resets the outputs beforehand.
+ *
+ * The arithmetic mirrors the C reference (lucas_kanade_ref.c): integer
+ * pyramid, Scharr gradients scaled by 1/32, bilinear warping of the current
+ * frame. Single-level LK with an unscaled gradient (lucas_kanade_1.cl)
+ * only resolves motion of about a pixel; each pyramid level doubles the
+ * motion range that the window can capture.
+ *
+ * OpenCV Reference:
+ *   - https://github.com/opencv/opencv/blob/4.x/modules/video/src/lkpyramid.cpp
+ *     (calcOpticalFlowPyrLK: level loop, prevPt * 2 between levels)
+ *   - https://github.com/opencv/opencv/blob/4.x/modules/imgproc/src/pyramids.cpp (pyrDown)
+ */
+
+#include "pyramid.h"
+
+/* Constants for iterative refinement (same as lucas_kanade_ref.c) */
+#define CONVERGENCE_THRESHOLD 0.01f
+#define MIN_EIGENVAL_THRESHOLD 1.0f
+#define SCHARR_SCALE (1.0f / 32.0f)
+
+/**
+ * @brief Compute Scharr gradients at a pixel, scaled to intensity per pixel
+ *
+ * @param input Input image
+ * @param x,y   Pixel coordinates
+ * @param width Image width
+ * @param Ix    Output: horizontal gradient
+ * @param Iy    Output: vertical gradient
+ */
+inline void scharr_gradients_scaled(__global const uchar* input,
+                                    int x, int y, int width,
+                                    float* Ix, float* Iy) {
+    *Ix = 3.0f * ((float)input[(y-1) * width + (x+1)] - (float)input[(y-1) * width + (x-1)])
+        + 10.0f * ((float)input[y * width + (x+1)] - (float)input[y * width + (x-1)])
+        + 3.0f * ((float)input[(y+1) * width + (x+1)] - (float)input[(y+1) * width + (x-1)]);
+    *Iy = 3.0f * ((float)input[(y+1) * width + (x-1)] - (float)input[(y-1) * width + (x-1)])
+        + 10.0f * ((float)input[(y+1) * width + x] - (float)input[(y-1) * width + x])
+        + 3.0f * ((float)input[(y+1) * width + (x+1)] - (float)input[(y-1) * width + (x+1)]);
+    *Ix *= SCHARR_SCALE;
+    *Iy *= SCHARR_SCALE;
+}
+
+/**
+ * @brief Bilinear sample with coordinates clamped to the image
+ *
+ * @param input Input image
+ * @param x,y   Floating-point coordinates
+ * @param width Image width
+ * @param height Image height
+ * @return Interpolated pixel value
+ */
+inline float bilinear_sample_clamped(__global const uchar* input,
+                                     float x, float y,
+                                     int width, int height) {
+    x = fmax(0.0f, fmin(x, (float)(width - 1)));
+    y = fmax(0.0f, fmin(y, (float)(height - 1)));
+
+    int x0 = (int)floor(x);
+    int y0 = (int)floor(y);
+    int x1 = min(x0 + 1, width - 1);
+    int y1 = min(y0 + 1, height - 1);
+    float fx = x - (float)x0;
+    float fy = y - (float)y0;
+
+    float v0 = (float)input[y0 * width + x0] +
+               fx * ((float)input[y0 * width + x1] - (float)input[y0 * width + x0]);
+    float v1 = (float)input[y1 * width + x0] +
+               fx * ((float)input[y1 * width + x1] - (float)input[y1 * width + x0]);
+    return v0 + fy * (v1 - v0);
+}
+
+/**
+ * @brief Build one pyramid level: 2x downsample with a 5x5 binomial filter
+ *
+ * @param[in]  src        Finer level (uchar, size: src_width * src_height)
+ * @param[out] dst        Coarser level (uchar, size: dst_width * dst_height)
+ * @param[in]  src_width  Finer level width
+ * @param[in]  src_height Finer level height
+ * @param[in]  dst_width  Coarser level width ((src_width + 1) / 2)
+ * @param[in]  dst_height Coarser level height ((src_height + 1) / 2)
+ */
+__kernel void pyr_down(__global const uchar* src,
+                       __global uchar* dst,
+                       int src_width,
+                       int src_height,
+                       int dst_width,
+                       int dst_height) {
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+
+    if (x >= dst_width || y >= dst_height) return;
+
+    dst[y * dst_width + x] = pyr_down_u8(src, src_width, src_height, x, y);
+}
+
+/**
+ * @brief Iterative Lucas-Kanade for the window around (x, y), starting from a guess
+ *
+ * Untrackable windows (minimum eigenvalue per pixel below the threshold)
+ * and solutions leaving the window return the guess. (x, y) must be at
+ * least half_win + 1 pixels inside the image.
+ *
+ * @return Flow (vx, vy) in pixels
+ */
+inline float2 lk_track_point(__global const uchar* prev_frame,
+                             __global const uchar* curr_frame,
+                             int width, int height, int x, int y,
+                             float guess_x, float guess_y,
+                             int half_win, int max_iters) {
+    /* Structure tensor from the previous frame (constant over iterations) */
+    float A11 = 0.0f;
+    float A22 = 0.0f;
+    float A12 = 0.0f;
+
+    for (int wy = -half_win; wy <= half_win; wy++) {
+        for (int wx = -half_win; wx <= half_win; wx++) {
+            float Ix, Iy;
+            scharr_gradients_scaled(prev_frame, x + wx, y + wy, width, &Ix, &Iy);
+            A11 += Ix * Ix;
+            A22 += Iy * Iy;
+            A12 += Ix * Iy;
+        }
+    }
+
+    /* Trackability: minimum eigenvalue per window pixel */
+    float det = A11 * A22 - A12 * A12;
+    float min_eigenval = (A11 + A22 - sqrt((A11 - A22) * (A11 - A22) + 4.0f * A12 * A12)) * 0.5f;
+    float window_pixels = (float)((2 * half_win + 1) * (2 * half_win + 1));
+
+    if (det <= 0.0f || min_eigenval < MIN_EIGENVAL_THRESHOLD * window_pixels) {
+        return (float2)(guess_x, guess_y);
+    }
+
+    float inv_det = 1.0f / det;
+    float vx = guess_x;
+    float vy = guess_y;
+
+    for (int iter = 0; iter < max_iters; iter++) {
+        float b1 = 0.0f;
+        float b2 = 0.0f;
+
+        for (int wy = -half_win; wy <= half_win; wy++) {
+            for (int wx = -half_win; wx <= half_win; wx++) {
+                int px = x + wx;
+                int py = y + wy;
+
+                float Ix, Iy;
+                scharr_gradients_scaled(prev_frame, px, py, width, &Ix, &Iy);
+
+                float I2 = bilinear_sample_clamped(curr_frame, (float)px + vx, (float)py + vy,
+                                                   width, height);
+                float It = I2 - (float)prev_frame[py * width + px];
+
+                b1 -= Ix * It;
+                b2 -= Iy * It;
+            }
+        }
+
+        float dvx = (A22 * b1 - A12 * b2) * inv_det;
+        float dvy = (A11 * b2 - A12 * b1) * inv_det;
+
+        vx += dvx;
+        vy += dvy;
+
+        if (fabs(dvx) < CONVERGENCE_THRESHOLD && fabs(dvy) < CONVERGENCE_THRESHOLD) {
+            break;
+        }
+    }
+
+    /* A solution beyond the window is a lost track: keep the guess */
+    if (fabs(vx - guess_x) > (float)(half_win + 1) || fabs(vy - guess_y) > (float)(half_win + 1)) {
+        return (float2)(guess_x, guess_y);
+    }
+    return (float2)(vx, vy);
+}
+
+/**
+ * @brief Iterative Lucas-Kanade at one pyramid level
+ *
+ * The initial guess is twice the coarser level's flow at (x/2, y/2); the
+ * coarser level is (width+1)/2 x (height+1)/2. At the coarsest level the
+ * pipeline binds a zero-filled plane, so the guess is zero. Untrackable
+ * pixels, borders and lost tracks keep the guess.
+ *
+ * @param[in]  prev_frame  Previous frame at this level (uchar, size: width * height)
+ * @param[in]  curr_frame  Current frame at this level (uchar, size: width * height)
+ * @param[in]  coarse_x    Horizontal flow of the coarser level (float)
+ * @param[in]  coarse_y    Vertical flow of the coarser level (float)
+ * @param[out] flow_x      Horizontal flow at this level in pixels (float, size: width * height)
+ * @param[out] flow_y      Vertical flow at this level in pixels (float, size: width * height)
+ * @param[in]  width       Level width in pixels
+ * @param[in]  height      Level height in pixels
+ * @param[in]  window_size Window size (odd number)
+ * @param[in]  max_iters   Maximum Newton-Raphson iterations
+ */
+__kernel void lucas_kanade_pyr_level(__global const uchar* prev_frame,
+                                     __global const uchar* curr_frame,
+                                     __global const float* coarse_x,
+                                     __global const float* coarse_y,
+                                     __global float* flow_x,
+                                     __global float* flow_y,
+                                     int width,
+                                     int height,
+                                     int window_size,
+                                     int max_iters) {
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+
+    if (x >= width || y >= height) return;
+
+    int half_win = window_size / 2;
+    int idx = y * width + x;
+    int coarse_width = (width + 1) / 2;
+    int coarse_height = (height + 1) / 2;
+    int cidx = min(y / 2, coarse_height - 1) * coarse_width + min(x / 2, coarse_width - 1);
+    float guess_x = 2.0f * coarse_x[cidx];
+    float guess_y = 2.0f * coarse_y[cidx];
+
+    if (x < half_win + 1 || x >= width - half_win - 1 ||
+        y < half_win + 1 || y >= height - half_win - 1) {
+        flow_x[idx] = guess_x;
+        flow_y[idx] = guess_y;
+        return;
+    }
+
+    float2 v = lk_track_point(prev_frame, curr_frame, width, height, x, y, guess_x, guess_y,
+                              half_win, max_iters);
+    flow_x[idx] = v.x;
+    flow_y[idx] = v.y;
+}
+
+/**
+ * @brief Reset the outputs of a sparse tracking pipeline
+ *
+ * Zeroes the dense level-0 flow maps (lucas_kanade_sparse only writes the
+ * keypoint pixels) and, from work-item (0, 0), the keypoint counter
+ * that compact_keypoints accumulates into.
+ *
+ * @param[out] flow_x         Horizontal flow (float, size: width * height)
+ * @param[out] flow_y         Vertical flow (float, size: width * height)
+ * @param[out] keypoint_count Keypoint counter (int, size: 1)
+ * @param[in]  width          Image width in pixels
+ * @param[in]  height         Image height in pixels
+ */
+__kernel void sparse_flow_clear(__global float* flow_x,
+                                __global float* flow_y,
+                                __global int* keypoint_count,
+                                int width,
+                                int height) {
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+
+    if (x >= width || y >= height) return;
+
+    int idx = y * width + x;
+    flow_x[idx] = 0.0f;
+    flow_y[idx] = 0.0f;
+    if (idx == 0) {
+        keypoint_count[0] = 0;
+    }
+}
+
+/**
+ * @brief Stream compaction of a corner map into a keypoint list
+ *
+ * Each work-group counts its corners with a local atomic, reserves a range
+ * of the list with a single global atomic_add and writes its (x, y) pairs
+ * into it, so global atomic traffic is one operation per work-group. The
+ * list order depends on work-group scheduling; the set of keypoints does
+ * not. keypoint_count receives the number of corners found, which may
+ * exceed max_keypoints; only the first max_keypoints are stored.
+ *
+ * @param[in]     corners        Corner map, non-zero at keypoints (uchar, size: width * height)
+ * @param[out]    keypoints      Keypoint (x, y) pairs (int, size: 2 * max_keypoints)
+ * @param[in,out] keypoint_count Keypoint counter, zero on entry (int, size: 1)
+ * @param[in]     width          Image width in pixels
+ * @param[in]     height         Image height in pixels
+ * @param[in]     max_keypoints  Capacity of the keypoint list
+ */
+__kernel void compact_keypoints(__global const uchar* corners,
+                                __global int* keypoints,
+                                __global int* keypoint_count,
+                                int width,
+                                int height,
+                                int max_keypoints) {
+    __local int group_count;
+    __local int group_base;
+
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+    /* No early return: every work-item must reach the barriers */
+    int is_corner = (x < width && y < height) ? (corners[y * width + x] != 0) : 0;
+    int first = (get_local_id(0) == 0 && get_local_id(1) == 0);
+
+    if (first) {
+        group_count = 0;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    int local_slot = is_corner ? atomic_inc(&group_count) : 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (first) {
+        group_base = (group_count > 0) ? atomic_add(keypoint_count, group_count) : 0;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    int slot = group_base + local_slot;
+    if (is_corner && slot < max_keypoints) {
+        keypoints[2 * slot] = x;
+        keypoints[2 * slot + 1] = y;
+    }
+}
+
+/**
+ * @brief Lucas-Kanade at one pyramid level for the keypoints of a compacted list
+ *
+ * One work-item per list entry (1D, global size >= max_keypoints); entries
+ * past min(keypoint_count, max_keypoints) do nothing. Keypoint (x, y) of
+ * level 0 is tracked at (x >> level, y >> level), the pixel that
+ * lucas_kanade_pyr_level would compute there, seeded by the coarser
+ * level's flow at the same place, so the flow at a keypoint equals the
+ * dense pyramidal flow at that pixel. Flows are scattered into the level
+ * planes (keypoints sharing a coarse pixel write the same value); at
+ * level 0 the track is also stored in the list order.
+ *
+ * @param[in]  prev_frame     Previous frame at this level (uchar, size: width * height)
+ * @param[in]  curr_frame     Current frame at this level (uchar, size: width * height)
+ * @param[in]  keypoints      Level-0 keypoint (x, y) pairs (int, size: 2 * max_keypoints)
+ * @param[in]  keypoint_count Keypoints found by compact_keypoints (int, size: 1)
+ * @param[in]  coarse_x       Horizontal flow of the coarser level (float)
+ * @param[in]  coarse_y       Vertical flow of the coarser level (float)
+ * @param[out] flow_x         Horizontal flow at this level, written at keypoints (float)
+ * @param[out] flow_y         Vertical flow at this level, written at keypoints (float)
+ * @param[out] tracks         Level-0 (x, y, vx, vy) per keypoint (float4, size: max_keypoints)
+ * @param[in]  width          Level width in pixels
+ * @param[in]  height         Level height in pixels
+ * @param[in]  frame_width    Level-0 width in pixels (selects the level)
+ * @param[in]  window_size    Window size (odd number)
+ * @param[in]  max_iters      Maximum Newton-Raphson iterations
+ * @param[in]  max_keypoints  Capacity of the keypoint list
+ */
+__kernel void lucas_kanade_sparse(__global const uchar* prev_frame,
+                                  __global const uchar* curr_frame,
+                                  __global const int* keypoints,
+                                  __global const int* keypoint_count,
+                                  __global const float* coarse_x,
+                                  __global const float* coarse_y,
+                                  __global float* flow_x,
+                                  __global float* flow_y,
+                                  __global float4* tracks,
+                                  int width,
+                                  int height,
+                                  int frame_width,
+                                  int window_size,
+                                  int max_iters,
+                                  int max_keypoints) {
+    int i = get_global_id(0);
+
+    if (i >= min(keypoint_count[0], max_keypoints)) return;
+
+    /* Level from the level width: level l + 1 is ceil(w / 2) of level l */
+    int level = 0;
+    for (int w = frame_width; w > width; w = (w + 1) / 2) {
+        level++;
+    }
+
+    int x = keypoints[2 * i] >> level;
+    int y = keypoints[2 * i + 1] >> level;
+    int half_win = window_size / 2;
+    int coarse_width = (width + 1) / 2;
+    int cidx = (y / 2) * coarse_width + (x / 2);
+    float2 v = (float2)(2.0f * coarse_x[cidx], 2.0f * coarse_y[cidx]);
+
+    if (x >= half_win + 1 && x < width - half_win - 1 &&
+        y >= half_win + 1 && y < height - half_win - 1) {
+        v = lk_track_point(prev_frame, curr_frame, width, height, x, y, v.x, v.y,
+                           half_win, max_iters);
+    }
+
+    int idx = y * width + x;
+    flow_x[idx] = v.x;
+    flow_y[idx] = v.y;
+    if (level == 0) {
+        tracks[i] = (float4)((float)x, (float)y, v.x, v.y);
+    }
+}
@@ -4,6 +4,9 @@
 #include "op_registry.h"
 #include "utils/safe_ops.h"
 
+/** Input rows read above and below each output row (pointwise) */
+#define REF_HALO_ROWS 0
+
 /**
  * @brief Relu reference implementation
  *
@@ -16,8 +19,10 @@
  *   - src_width, src_height: Source dimensions
  *   - dst_width, dst_height: Destination dimensions
  *   - custom_buffers: Optional custom buffers (NULL if none)
+ * @param[in] row_begin First output row to compute
+ * @param[in] row_end One past the last output row to compute
  */
-void ReluRef(const OpParams* params) {
+void ReluRefRows(const OpParams* params, int row_begin, int row_end) {
     int y;
     int x;
     int width;
@@ -46,9 +51,16 @@ void ReluRef(const OpParams* params) {
         return; /* Overflow detected */
     }
 
+    if (row_begin < 0) {
+        row_begin = 0;
+    }
+    if (row_end > height) {
+        row_end = height;
+    }
+
     /* TODO: Implement your algorithm here */
     /* Example: Simple copy operation */
-    for (y = 0; y < height; y++) {
+    for (y = row_begin; y < row_end; y++) {
         for (x = 0; x < width; x++) {
             output_index = y * width + x;
 
@@ -60,6 +72,19 @@ void ReluRef(const OpParams* params) {
     }
 }
 
+/**
+ * @brief Relu reference implementation (whole image)
+ *
+ * @param[in] params Operation parameters (see ReluRefRows)
+ */
+void ReluRef(const OpParams* params) {
+    if (params == NULL) {
+        return;
+    }
+
+    ReluRefRows(params, 0, params->src_height);
+}
+
 /*
  * NOTE: Registration of this algorithm happens in auto_registry.c
  * Auto-generated by scripts/generate_registry.sh which scans for *_ref.c files.
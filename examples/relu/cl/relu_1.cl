@@ -9,6 +9,10 @@
  * @param output Output image buffer
  * @param width  Image width in pixels
  * @param height Image height in pixels
+ *
+ * RELU_EPILOGUE is the per-pixel op for fusion into a preceding stencil
+ * stage ("epilogue" in the config); fused builds pass the threshold as
+ * -DEPI_RELU_V1.
  */
 
 struct relu_params {
@@ -19,6 +23,12 @@ struct relu_params {
     int relu_v4;
 };
 
+inline uchar relu_apply(uchar val, int threshold) {
+    return (val < (uchar)threshold) ? (uchar)0 : val;
+}
+
+#define RELU_EPILOGUE(v) relu_apply((v), EPI_RELU_V1)
+
 __kernel void relu(__global const uchar* input,
                              __global uchar* output,
                              int width,
@@ -34,11 +44,5 @@ __kernel void relu(__global const uchar* input,
     int index = y * width + x;
 
     /* ReLU with threshold from params */
-    uchar val = input[index];
-
-    if (val < (uchar)params.relu_v1) {
-        val = 0;
-    }
-
-    output[index] = val;
+    output[index] = relu_apply(input[index], params.relu_v1);
 }
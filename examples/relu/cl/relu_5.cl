@@ -0,0 +1,42 @@
+/**
+ * @file relu_5.cl
+ * @brief Relu over a batch of same-shape images in one dispatch
+ *
+ * Same operation as relu_1.cl. Images are packed back to back in the input
+ * and output buffers; the batch index is get_global_id(2) (config
+ * "batch": true), so one 3D dispatch covers every image. A plain 2D
+ * dispatch has no third dimension: get_global_id(2) is 0 and the kernel
+ * processes image 0 only.
+ *
+ * Kernel arguments (must match kernel_args in config/relu_tiles.json):
+ * @param input  Input images, width * height bytes each
+ * @param output Output images, width * height bytes each
+ * @param width  Image width in pixels
+ * @param height Image height in pixels
+ */
+
+struct relu_params {
+    int relu_v1;
+    int relu_v1b;
+    float relu_v2;
+    float relu_v3;
+    int relu_v4;
+};
+
+__kernel void relu_batch(__global const uchar* input,
+                         __global uchar* output,
+                         int width,
+                         int height,
+                         struct relu_params params) {
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+    size_t image = get_global_id(2);
+
+    /* Boundary check */
+    if (x >= width || y >= height) return;
+
+    size_t index = image * (size_t)width * (size_t)height + (size_t)(y * width + x);
+    uchar val = input[index];
+
+    output[index] = (val < (uchar)params.relu_v1) ? (uchar)0 : val;
+}
@@ -1,5 +1,6 @@
 #include <math.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "op_interface.h"
 #include "op_registry.h"
@@ -97,6 +98,18 @@ static void svd_2x2_symmetric(float a, float b, float c,
     }
 }
 
+/* Host data of the named output @p name, NULL if absent */
+static unsigned char* GetOutputHostData(const CustomBuffers* outputs, const char* name) {
+    int i;
+
+    for (i = 0; i < outputs->count; i++) {
+        if (strcmp(outputs->buffers[i].name, name) == 0) {
+            return outputs->buffers[i].host_data;
+        }
+    }
+    return NULL;
+}
+
 /**
  * @brief SVD reference implementation
  *
@@ -106,7 +119,9 @@ static void svd_2x2_symmetric(float a, float b, float c,
  *
  * @param[in] params Operation parameters containing:
  *   - input: Input grayscale image
- *   - output: Singular values and angles (stored in custom buffers)
+ *   - output: Larger singular value when the outputs are named
+ *   - outputs: "sigma2" and "angle" (outputs.json "buffers")
+ *   - custom_buffers: sigma1, sigma2 and angle in order, without named outputs
  *   - src_width, src_height: Image dimensions
  */
 void SvdRef(const OpParams* params) {
@@ -138,15 +153,20 @@ void SvdRef(const OpParams* params) {
         return;
     }
 
-    /* Get output buffers from custom buffers */
-    if ((params->custom_buffers == NULL) || (params->custom_buffers->count < 3)) {
-        return;
+    /* Named outputs (sigma1 is the primary output), else the first three custom buffers */
+    if (params->outputs != NULL) {
+        sigma1 = (float*)params->output;
+        sigma2 = (float*)GetOutputHostData(params->outputs, "sigma2");
+        angle = (float*)GetOutputHostData(params->outputs, "angle");
+    } else {
+        if ((params->custom_buffers == NULL) || (params->custom_buffers->count < 3)) {
+            return;
+        }
+        sigma1 = (float*)params->custom_buffers->buffers[0].host_data;
+        sigma2 = (float*)params->custom_buffers->buffers[1].host_data;
+        angle = (float*)params->custom_buffers->buffers[2].host_data;
     }
 
-    sigma1 = (float*)params->custom_buffers->buffers[0].host_data;
-    sigma2 = (float*)params->custom_buffers->buffers[1].host_data;
-    angle = (float*)params->custom_buffers->buffers[2].host_data;
-
     if ((sigma1 == NULL) || (sigma2 == NULL) || (angle == NULL)) {
         return;
     }
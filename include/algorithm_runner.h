@@ -23,14 +23,72 @@
 #pragma once
 
 #include "op_registry.h"
-
-/** Maximum image size (used for static buffer allocation) */
-#define MAX_IMAGE_SIZE (4096 * 4096)
+#include "platform/kernel_report.h"
+#include "utils/benchmark.h"
+#include "utils/verify.h"
 
 /* Forward declarations for internal types (avoid exposing internal headers) */
 typedef struct OpenCLEnv OpenCLEnv;
 typedef struct KernelConfig KernelConfig;
 typedef struct Config Config;
+typedef struct PipelineConfig PipelineConfig;
+
+/**
+ * @brief Verification of one secondary output of a multi-output kernel
+ */
+typedef struct {
+    char name[64];         /**< Output name (o_buffer argument) */
+    int verified;          /**< Non-zero if a golden was available */
+    int passed;            /**< Non-zero if verification passed (or no golden) */
+    size_t errors;         /**< Elements outside the tolerance */
+    size_t total_elements; /**< Elements compared */
+    float max_error;       /**< Largest |diff| */
+} OutputVerifyResult;
+
+/**
+ * @brief Outcome of one kernel variant run
+ *
+ * Filled by RunAlgorithmVariants for each selected variant.
+ */
+typedef struct {
+    char variant_id[32];           /**< Variant identifier (e.g., "v1") */
+    int status;                    /**< 0 if the variant ran, -1 on build/run failure */
+    double ref_time_ms;            /**< C reference wall time (0 when golden comes from file) */
+    int ref_threads;               /**< Threads the C reference ran on (0 for golden file) */
+    double gpu_time_ms;            /**< Kernel time of the verified run */
+    double upload_ms;              /**< Input host-to-device transfer time */
+    double readback_ms;            /**< Output device-to-host transfer time */
+    int passed;                    /**< Non-zero if verification passed (all outputs) */
+    float max_error;               /**< Maximum per-pixel error (primary output) */
+    VerifyReport verify;           /**< Mismatch count, worst element and error histogram */
+    int output_count;              /**< Secondary outputs in outputs[] */
+    OutputVerifyResult outputs[MAX_OUTPUT_BUFFERS - 1]; /**< Secondary outputs (named buffers) */
+    KernelReport hardware;         /**< Occupancy and bandwidth (hardware.valid if collected) */
+    int has_benchmark;             /**< Non-zero if benchmark statistics are valid */
+    BenchmarkResult benchmark;     /**< Benchmark statistics (benchmark mode only) */
+    int has_stream;                /**< Non-zero if streaming statistics are valid */
+    int stream_frames;             /**< Frames processed in streaming mode */
+    int stream_buffer_sets;        /**< In-flight buffer sets in streaming mode */
+    double stream_fps;             /**< Sustained streaming throughput */
+    BenchmarkStats stream_latency; /**< Per-frame streaming latency */
+    int has_multi_device;          /**< Non-zero if multi-device statistics are valid */
+    int multi_device_count;        /**< Devices used in the multi-device run */
+    int multi_device_split;        /**< MultiDeviceSplit of the multi-device run */
+    double multi_device_fps;       /**< Frames per second over all devices */
+    int multi_device_checks;       /**< Multi-device outputs compared with the reference */
+    int multi_device_passed;       /**< Non-zero if every compared output matched */
+    int has_batch;                 /**< Non-zero if batch statistics are valid */
+    int batch_images;              /**< Images per batch */
+    double batch_loop_ips;         /**< Images/sec with one dispatch per image */
+    double batch_ips;              /**< Images/sec with one batched dispatch (0: not batched) */
+    int batch_failures;            /**< Batch images that failed verification */
+    int precision;                 /**< KernelPrecision of the variant (fp32, fp16, int) */
+    int precision_fallback;        /**< Non-zero if fp16 ran in fp32 (no cl_khr_fp16) */
+    int has_baseline;              /**< Non-zero if compared with its fp32 baseline variant */
+    char baseline_id[32];          /**< fp32 baseline variant */
+    double baseline_speedup;       /**< Baseline time / variant time (median if benchmarked) */
+    VerifyReport baseline_verify;  /**< Output against the baseline's output */
+} VariantResult;
 
 /**
  * @brief Run complete algorithm execution pipeline
@@ -43,8 +101,9 @@ typedef struct Config Config;
  * 5. Verifies GPU results against reference
  * 6. Saves output image
  *
- * Uses static buffers for output storage (gpu_output_buffer, ref_output_buffer)
- * provided by the caller to avoid dynamic allocation (MISRA-C compliance).
+ * Output storage (gpu_output_buffer, ref_output_buffer) is provided by the
+ * caller; main.c maps page-backed buffers sized from the configured images
+ * (see utils/mapped_file.h), so there is no fixed image size limit.
  *
  * @param[in] algo Algorithm to execute
  * @param[in] kernel_cfg Kernel configuration (variant settings)
@@ -57,3 +116,47 @@ typedef struct Config Config;
 void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const Config* config,
                   OpenCLEnv* env, unsigned char* gpu_output_buffer,
                   unsigned char* ref_output_buffer);
+
+/**
+ * @brief Run several kernel variants of one algorithm in a single pass
+ *
+ * Input loading, custom buffer data, the C reference (or golden file) and the
+ * input/custom OpenCL buffers are prepared once and shared by all variants.
+ * Each variant then gets its own cache run directory, kernel build, output
+ * buffer and verification. A failing variant does not stop the sweep. When
+ * more than one variant is run, a consolidated comparison table is printed.
+ *
+ * @param[in] algo Algorithm to execute
+ * @param[in] variants Kernel configurations to run, in order
+ * @param[in] variant_count Number of variants (>= 1)
+ * @param[in] config Full configuration
+ * @param[in] env Initialized OpenCL environment
+ * @param[out] gpu_output_buffer Buffer for GPU output (must be >= image size)
+ * @param[out] ref_output_buffer Buffer for reference output (must be >= image size)
+ * @param[out] results Per-variant results (variant_count entries)
+ * @return 0 if all variants ran, -1 if setup or any variant failed
+ */
+int RunAlgorithmVariants(const Algorithm* algo, KernelConfig* const variants[], int variant_count,
+                         const Config* config, OpenCLEnv* env, unsigned char* gpu_output_buffer,
+                         unsigned char* ref_output_buffer, VariantResult* results);
+
+/**
+ * @brief Run a multi-kernel pipeline of one algorithm
+ *
+ * Shares the input/reference preparation of RunAlgorithmVariants, then
+ * enqueues every pipeline stage back-to-back with event dependencies and
+ * verifies the final output ("dst"). The pipeline's golden_file, when set,
+ * replaces the reference output for verification.
+ *
+ * @param[in] algo Algorithm to execute
+ * @param[in] pipeline Pipeline configuration (from the "pipeline" section)
+ * @param[in] config Full configuration
+ * @param[in] env Initialized OpenCL environment
+ * @param[out] gpu_output_buffer Buffer for GPU output (must be >= image size)
+ * @param[out] ref_output_buffer Buffer for reference output (must be >= image size)
+ * @param[out] result Pipeline result (variant_id holds the pipeline id)
+ * @return 0 if the pipeline ran, -1 on error
+ */
+int RunAlgorithmPipeline(const Algorithm* algo, const PipelineConfig* pipeline,
+                         const Config* config, OpenCLEnv* env, unsigned char* gpu_output_buffer,
+                         unsigned char* ref_output_buffer, VariantResult* result);
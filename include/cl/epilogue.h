@@ -0,0 +1,26 @@
+/**
+ * @file epilogue.h
+ * @brief Store hook for fusing an elementwise op into a kernel
+ *
+ * Kernels that can be fused with a following elementwise op wrap each
+ * stored output value in EPILOGUE(v). Standalone builds leave the value
+ * unchanged; fused pipeline stages are built with
+ * -DFUSED_EPILOGUE=<function or macro> of the elementwise kernel, which is
+ * compiled into the same program.
+ *
+ * Usage in kernel:
+ *   #include "epilogue.h"
+ *
+ *   output[index] = EPILOGUE(convert_uchar_sat(sum));
+ */
+
+#ifndef EPILOGUE_H
+#define EPILOGUE_H
+
+#ifdef FUSED_EPILOGUE
+#define EPILOGUE(v) FUSED_EPILOGUE(v)
+#else
+#define EPILOGUE(v) (v)
+#endif
+
+#endif /* EPILOGUE_H */
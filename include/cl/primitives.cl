@@ -0,0 +1,208 @@
+/**
+ * @file primitives.cl
+ * @brief Device-wide reduce, scan, min/max and histogram kernels
+ *
+ * Shared kernels behind the host API in src/platform/primitives.h, built
+ * from include/cl/ like any algorithm's .cl file. They are thin wrappers
+ * around the work-group building blocks of primitives.h:
+ *
+ *   - prim_reduce_* / prim_minmax_*: grid-stride pass, one partial per
+ *     work-group; the host then runs the same kernel with a single group
+ *     over the partials.
+ *   - prim_scan_blocks / prim_scan_add: exclusive scan of one block per
+ *     work-group plus the block totals; the host scans the totals the same
+ *     way (recursively) and adds them back to the blocks.
+ *   - prim_histogram_*: per-group local histogram, merged into the global
+ *     histogram with one atomic per bin and group.
+ *
+ * All kernels are 1D; the local scratch arguments hold one element per
+ * work-item (bin_count ints for the histograms).
+ */
+
+#include "primitives.h"
+
+/**
+ * @brief Reduce src[0 .. count) to one float per work-group
+ *
+ * @param[in]  src      Input values (float, size: count)
+ * @param[in]  count    Number of values
+ * @param[in]  op       PRIM_OP_SUM, PRIM_OP_MIN or PRIM_OP_MAX
+ * @param[out] partials Result per work-group (float, size: number of groups)
+ * @param      scratch  Local scratch (float, size: local size)
+ */
+__kernel void prim_reduce_float(__global const float* src, int count, int op,
+                                __global float* partials, __local float* scratch) {
+    float acc = prim_identity_float(op);
+
+    for (int i = get_global_id(0); i < count; i += get_global_size(0)) {
+        acc = prim_combine_float(acc, src[i], op);
+    }
+    acc = prim_wg_reduce_float(acc, op, scratch);
+    if (get_local_id(0) == 0) {
+        partials[get_group_id(0)] = acc;
+    }
+}
+
+/**
+ * @brief Reduce src[0 .. count) to one int per work-group
+ *
+ * @param[in]  src      Input values (int, size: count)
+ * @param[in]  count    Number of values
+ * @param[in]  op       PRIM_OP_SUM, PRIM_OP_MIN or PRIM_OP_MAX
+ * @param[out] partials Result per work-group (int, size: number of groups)
+ * @param      scratch  Local scratch (int, size: local size)
+ */
+__kernel void prim_reduce_int(__global const int* src, int count, int op,
+                              __global int* partials, __local int* scratch) {
+    int acc = prim_identity_int(op);
+
+    for (int i = get_global_id(0); i < count; i += get_global_size(0)) {
+        acc = prim_combine_int(acc, src[i], op);
+    }
+    acc = prim_wg_reduce_int(acc, op, scratch);
+    if (get_local_id(0) == 0) {
+        partials[get_group_id(0)] = acc;
+    }
+}
+
+/**
+ * @brief Minimum and maximum of src[0 .. count) per work-group
+ *
+ * @param[in]  src      Input values (float, size: count)
+ * @param[in]  count    Number of values
+ * @param[out] partials (min, max) per work-group (float2, size: number of groups)
+ * @param      scratch  Local scratch (float2, size: local size)
+ */
+__kernel void prim_minmax_float(__global const float* src, int count,
+                                __global float2* partials, __local float2* scratch) {
+    float lo = INFINITY;
+    float hi = -INFINITY;
+
+    for (int i = get_global_id(0); i < count; i += get_global_size(0)) {
+        float v = src[i];
+        lo = fmin(lo, v);
+        hi = fmax(hi, v);
+    }
+    float2 r = prim_wg_minmax_float(lo, hi, scratch);
+    if (get_local_id(0) == 0) {
+        partials[get_group_id(0)] = r;
+    }
+}
+
+/**
+ * @brief Combine (min, max) partials; the second pass of prim_minmax_float
+ *
+ * @param[in]  src      (min, max) pairs (float2, size: count)
+ * @param[in]  count    Number of pairs
+ * @param[out] partials (min, max) per work-group (float2, size: number of groups)
+ * @param      scratch  Local scratch (float2, size: local size)
+ */
+__kernel void prim_minmax_float2(__global const float2* src, int count,
+                                 __global float2* partials, __local float2* scratch) {
+    float lo = INFINITY;
+    float hi = -INFINITY;
+
+    for (int i = get_global_id(0); i < count; i += get_global_size(0)) {
+        float2 v = src[i];
+        lo = fmin(lo, v.x);
+        hi = fmax(hi, v.y);
+    }
+    float2 r = prim_wg_minmax_float(lo, hi, scratch);
+    if (get_local_id(0) == 0) {
+        partials[get_group_id(0)] = r;
+    }
+}
+
+/**
+ * @brief Exclusive prefix sum within each block of local-size elements
+ *
+ * Each work-item reads and writes only its own element, so @p src and
+ * @p dst may be the same buffer.
+ *
+ * @param[in]  src        Input values (int, size: count)
+ * @param[in]  count      Number of values
+ * @param[out] dst        Block-local exclusive sums (int, size: count)
+ * @param[out] block_sums Total per block (int, size: number of groups)
+ * @param      scratch    Local scratch (int, size: local size)
+ */
+__kernel void prim_scan_blocks(__global const int* src, int count, __global int* dst,
+                               __global int* block_sums, __local int* scratch) {
+    int i = get_global_id(0);
+    int v = (i < count) ? src[i] : 0;
+    int total;
+
+    int ex = prim_wg_scan_exclusive_int(v, scratch, &total);
+    if (i < count) {
+        dst[i] = ex;
+    }
+    if (get_local_id(0) == 0) {
+        block_sums[get_group_id(0)] = total;
+    }
+}
+
+/**
+ * @brief Add the scanned block totals to the elements of each block
+ *
+ * @param[in,out] dst          Block-local exclusive sums (int, size: count)
+ * @param[in]     count        Number of values
+ * @param[in]     block_offsets Exclusive scan of the block totals (int, size: number of groups)
+ */
+__kernel void prim_scan_add(__global int* dst, int count, __global const int* block_offsets) {
+    int i = get_global_id(0);
+
+    if (i < count) {
+        dst[i] += block_offsets[get_group_id(0)];
+    }
+}
+
+/**
+ * @brief Histogram of 8-bit values into bin_count equal-width bins
+ *
+ * Value v lands in bin v * bin_count / 256. The global histogram is
+ * accumulated into and must be zeroed beforehand.
+ *
+ * @param[in]     src       Input values (uchar, size: count)
+ * @param[in]     count     Number of values
+ * @param[in,out] bins      Global histogram (int, size: bin_count)
+ * @param[in]     bin_count Number of bins (1..256)
+ * @param         local_bins Local histogram (int, size: bin_count)
+ */
+__kernel void prim_histogram_u8(__global const uchar* src, int count, __global int* bins,
+                                int bin_count, __local int* local_bins) {
+    prim_local_histogram_clear(local_bins, bin_count);
+    for (int i = get_global_id(0); i < count; i += get_global_size(0)) {
+        atomic_inc(&local_bins[((int)src[i] * bin_count) >> 8]);
+    }
+    prim_local_histogram_flush(local_bins, bin_count, bins);
+}
+
+/**
+ * @brief Histogram of floats over [lo, hi) into bin_count equal-width bins
+ *
+ * Values outside the range are clamped into the first or last bin; NaNs
+ * are skipped. The global histogram is accumulated into and must be zeroed
+ * beforehand.
+ *
+ * @param[in]     src       Input values (float, size: count)
+ * @param[in]     count     Number of values
+ * @param[in]     lo        Lower edge of the first bin
+ * @param[in]     hi        Upper edge of the last bin (> lo)
+ * @param[in,out] bins      Global histogram (int, size: bin_count)
+ * @param[in]     bin_count Number of bins
+ * @param         local_bins Local histogram (int, size: bin_count)
+ */
+__kernel void prim_histogram_float(__global const float* src, int count, float lo, float hi,
+                                   __global int* bins, int bin_count,
+                                   __local int* local_bins) {
+    float scale = (float)bin_count / (hi - lo);
+
+    prim_local_histogram_clear(local_bins, bin_count);
+    for (int i = get_global_id(0); i < count; i += get_global_size(0)) {
+        float v = src[i];
+        if (!isnan(v)) {
+            int b = clamp((int)floor((v - lo) * scale), 0, bin_count - 1);
+            atomic_inc(&local_bins[b]);
+        }
+    }
+    prim_local_histogram_flush(local_bins, bin_count, bins);
+}
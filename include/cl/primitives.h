@@ -0,0 +1,212 @@
+/**
+ * @file primitives.h
+ * @brief Work-group reduce, scan, min/max and histogram building blocks
+ *
+ * Functions any kernel can use to combine values across its work-group
+ * through caller-provided __local scratch of one element per work-item.
+ * Every work-item of the group must call them (they contain barriers), with
+ * the same op; the group may be 1D or 2D (items are ranked row-major) and
+ * of any size. OpenCL 1.2 has no work_group_reduce/scan built-ins, so these
+ * are tree reductions and a Hillis-Steele scan in local memory.
+ *
+ * Device-wide versions (a grid-stride pass per group, then one group over
+ * the partial results) are the kernels in primitives.cl, launched by the
+ * host API in src/platform/primitives.h.
+ *
+ * Usage in kernel:
+ *   #include "primitives.h"
+ *
+ *   __local int scratch[256];
+ *   int total;
+ *   int offset = prim_wg_scan_exclusive_int(is_corner, scratch, &total);
+ */
+
+#ifndef PRIMITIVES_H
+#define PRIMITIVES_H
+
+/*============================================================
+ * Reduction operators
+ * Must match PrimOp in src/platform/primitives.h
+ *============================================================*/
+#define PRIM_OP_SUM 0
+#define PRIM_OP_MIN 1
+#define PRIM_OP_MAX 2
+
+/** Row-major rank of the work-item in its work-group */
+inline int prim_local_rank(void) {
+    return (int)(get_local_id(1) * get_local_size(0) + get_local_id(0));
+}
+
+/** Number of work-items in the work-group */
+inline int prim_local_count(void) {
+    return (int)(get_local_size(0) * get_local_size(1));
+}
+
+/** Smallest power of two >= n (n >= 1) */
+inline int prim_pow2_ceil(int n) {
+    int p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+/** Identity element of op for float */
+inline float prim_identity_float(int op) {
+    return (op == PRIM_OP_MIN) ? INFINITY : ((op == PRIM_OP_MAX) ? -INFINITY : 0.0f);
+}
+
+/** Identity element of op for int */
+inline int prim_identity_int(int op) {
+    return (op == PRIM_OP_MIN) ? INT_MAX : ((op == PRIM_OP_MAX) ? INT_MIN : 0);
+}
+
+/** a op b for float */
+inline float prim_combine_float(float a, float b, int op) {
+    return (op == PRIM_OP_MIN) ? fmin(a, b) : ((op == PRIM_OP_MAX) ? fmax(a, b) : (a + b));
+}
+
+/** a op b for int */
+inline int prim_combine_int(int a, int b, int op) {
+    return (op == PRIM_OP_MIN) ? min(a, b) : ((op == PRIM_OP_MAX) ? max(a, b) : (a + b));
+}
+
+/**
+ * @brief Reduce one float per work-item over the work-group
+ *
+ * @param v       This work-item's value
+ * @param op      PRIM_OP_SUM, PRIM_OP_MIN or PRIM_OP_MAX
+ * @param scratch Local scratch, one float per work-item
+ * @return The reduction, in every work-item
+ */
+inline float prim_wg_reduce_float(float v, int op, __local float* scratch) {
+    int rank = prim_local_rank();
+    int count = prim_local_count();
+
+    scratch[rank] = v;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = prim_pow2_ceil(count) / 2; s > 0; s >>= 1) {
+        if (rank < s && rank + s < count) {
+            scratch[rank] = prim_combine_float(scratch[rank], scratch[rank + s], op);
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    float result = scratch[0];
+    barrier(CLK_LOCAL_MEM_FENCE); /* scratch may be reused after return */
+    return result;
+}
+
+/**
+ * @brief Reduce one int per work-item over the work-group
+ *
+ * @param v       This work-item's value
+ * @param op      PRIM_OP_SUM, PRIM_OP_MIN or PRIM_OP_MAX
+ * @param scratch Local scratch, one int per work-item
+ * @return The reduction, in every work-item
+ */
+inline int prim_wg_reduce_int(int v, int op, __local int* scratch) {
+    int rank = prim_local_rank();
+    int count = prim_local_count();
+
+    scratch[rank] = v;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = prim_pow2_ceil(count) / 2; s > 0; s >>= 1) {
+        if (rank < s && rank + s < count) {
+            scratch[rank] = prim_combine_int(scratch[rank], scratch[rank + s], op);
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    int result = scratch[0];
+    barrier(CLK_LOCAL_MEM_FENCE);
+    return result;
+}
+
+/**
+ * @brief Minimum and maximum of one float per work-item in a single pass
+ *
+ * @param v_min   Value entering the minimum
+ * @param v_max   Value entering the maximum
+ * @param scratch Local scratch, one float2 per work-item
+ * @return (min, max), in every work-item
+ */
+inline float2 prim_wg_minmax_float(float v_min, float v_max, __local float2* scratch) {
+    int rank = prim_local_rank();
+    int count = prim_local_count();
+
+    scratch[rank] = (float2)(v_min, v_max);
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = prim_pow2_ceil(count) / 2; s > 0; s >>= 1) {
+        if (rank < s && rank + s < count) {
+            float2 a = scratch[rank];
+            float2 b = scratch[rank + s];
+            scratch[rank] = (float2)(fmin(a.x, b.x), fmax(a.y, b.y));
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    float2 result = scratch[0];
+    barrier(CLK_LOCAL_MEM_FENCE);
+    return result;
+}
+
+/**
+ * @brief Exclusive prefix sum of one int per work-item in rank order
+ *
+ * @param v       This work-item's value
+ * @param scratch Local scratch, one int per work-item
+ * @param total   Receives the sum over the work-group (may be NULL)
+ * @return Sum of the values of the lower-ranked work-items
+ */
+inline int prim_wg_scan_exclusive_int(int v, __local int* scratch, int* total) {
+    int rank = prim_local_rank();
+    int count = prim_local_count();
+
+    scratch[rank] = v;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int offset = 1; offset < count; offset <<= 1) {
+        int addend = (rank >= offset) ? scratch[rank - offset] : 0;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        scratch[rank] += addend;
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    int inclusive = scratch[rank];
+    if (total != NULL) {
+        *total = scratch[count - 1];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+    return inclusive - v;
+}
+
+/**
+ * @brief Zero a work-group's local histogram
+ *
+ * @param bins     Local histogram
+ * @param bin_count Number of bins
+ */
+inline void prim_local_histogram_clear(__local int* bins, int bin_count) {
+    for (int i = prim_local_rank(); i < bin_count; i += prim_local_count()) {
+        bins[i] = 0;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+}
+
+/**
+ * @brief Add the local histogram of the work-group to a global histogram
+ *
+ * One global atomic per non-empty bin and work-group instead of one per
+ * sample; samples are counted into @p bins with atomic_inc() in between.
+ *
+ * @param bins        Local histogram
+ * @param bin_count   Number of bins
+ * @param global_bins Global histogram (int, size: bin_count)
+ */
+inline void prim_local_histogram_flush(__local int* bins, int bin_count,
+                                       __global int* global_bins) {
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int i = prim_local_rank(); i < bin_count; i += prim_local_count()) {
+        if (bins[i] != 0) {
+            atomic_add(&global_bins[i], bins[i]);
+        }
+    }
+}
+
+#endif /* PRIMITIVES_H */
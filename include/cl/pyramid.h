@@ -0,0 +1,44 @@
+/**
+ * @file pyramid.h
+ * @brief Gaussian pyramid downsampling for pipeline "pyramid" levels
+ *
+ * Level l + 1 is ceil(w / 2) x ceil(h / 2) of level l; pixel (x, y) is the
+ * 5x5 binomial filter [1 4 6 4 1]^2 / 256 centred on (2x, 2y), with
+ * reflect-101 borders and round-to-nearest, as cv::pyrDown. The integer
+ * arithmetic makes every level bit-exact with a C reference.
+ *
+ * Usage in kernel:
+ *   #include "pyramid.h"
+ *
+ *   dst[y * dst_width + x] = pyr_down_u8(src, src_width, src_height, x, y);
+ */
+
+#ifndef PYRAMID_H
+#define PYRAMID_H
+
+/** Reflect-101 border index (gfedcb|abcdefgh|gfedcba) */
+inline int pyr_reflect101(int i, int n) {
+    if (n == 1) {
+        return 0;
+    }
+    i = (i < 0) ? -i : i;
+    return (i >= n) ? ((2 * n) - 2 - i) : i;
+}
+
+/** Level l + 1 pixel (x, y) from the 8-bit level l image src */
+inline uchar pyr_down_u8(__global const uchar* src, int src_width, int src_height, int x, int y) {
+    const int binomial[5] = {1, 4, 6, 4, 1};
+    int sum = 0;
+
+    for (int j = 0; j < 5; j++) {
+        int row = pyr_reflect101((2 * y) + j - 2, src_height) * src_width;
+        int acc = 0;
+        for (int i = 0; i < 5; i++) {
+            acc += binomial[i] * (int)src[row + pyr_reflect101((2 * x) + i - 2, src_width)];
+        }
+        sum += binomial[j] * acc;
+    }
+    return (uchar)((sum + 128) >> 8);
+}
+
+#endif /* PYRAMID_H */
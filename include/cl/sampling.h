@@ -0,0 +1,32 @@
+/**
+ * @file sampling.h
+ * @brief Image reads for kernels taking "i_image" and "sampler" arguments
+ *
+ * Images are sampled with normalized coordinates (the host creates every
+ * sampler with CL_TRUE), since the REPEAT and MIRRORED_REPEAT addressing
+ * modes used for wrap and reflect borders require them. Pixel (x, y) is
+ * read at its centre; coordinates outside the image are resolved by the
+ * sampler's addressing mode, so kernels need no clamping.
+ *
+ * Usage in kernel:
+ *   #include "sampling.h"
+ *
+ *   float2 inv_size = image_inv_size(input);
+ *   uint v = image_read_u8(input, smp, x - 1, y, inv_size);
+ */
+
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+/** Reciprocal of the image size, for image_read_u8() */
+inline float2 image_inv_size(read_only image2d_t img) {
+    return (float2)(1.0f / (float)get_image_width(img), 1.0f / (float)get_image_height(img));
+}
+
+/** Channel 0 of pixel (x, y) of an 8-bit unsigned integer image */
+inline uint image_read_u8(read_only image2d_t img, sampler_t smp, int x, int y, float2 inv_size) {
+    float2 coord = (float2)(((float)x + 0.5f) * inv_size.x, ((float)y + 0.5f) * inv_size.y);
+    return read_imageui(img, smp, coord).x;
+}
+
+#endif /* SAMPLING_H */
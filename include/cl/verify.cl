@@ -0,0 +1,98 @@
+/**
+ * @file verify.cl
+ * @brief On-device comparison of an output against its golden
+ *
+ * Kernels behind src/platform/device_verify.h. Each work-item compares a
+ * grid-stride slice of elements, the work-group reduces its mismatch count
+ * and largest |diff| (primitives.h), and one work-item per group folds them
+ * into result[0] (count, atomic_add) and result[1] (max |diff| as float
+ * bits, atomic_max - the bit patterns of non-negative floats order like
+ * ints). The host reads back those two ints instead of the whole output.
+ *
+ * Same rules as VerifyCompare(): an element is a mismatch when
+ * |gpu - ref| > tolerance, non-finite differences count as INFINITY, and
+ * bit-identical floats (matching inf / NaN included) count as equal.
+ * The output may have padded rows (gpu_pitch elements per row); the golden
+ * is packed.
+ */
+
+#include "primitives.h"
+
+/* Reduce the group's counts and fold them into the result */
+inline void verify_flush(int errors, float max_diff, __local int* count_scratch,
+                         __local float* max_scratch, __global int* result) {
+    errors = prim_wg_reduce_int(errors, PRIM_OP_SUM, count_scratch);
+    max_diff = prim_wg_reduce_float(max_diff, PRIM_OP_MAX, max_scratch);
+    if (prim_local_rank() == 0) {
+        if (errors != 0) {
+            atomic_add(&result[0], errors);
+        }
+        atomic_max(&result[1], as_int(max_diff));
+    }
+}
+
+/**
+ * @brief Compare a uchar output with its golden
+ *
+ * @param[in]     gpu           Output (uchar, rows * gpu_pitch)
+ * @param[in]     ref           Golden (uchar, rows * row_elems, packed)
+ * @param[in]     row_elems     Elements per row (width * channels)
+ * @param[in]     rows          Number of rows
+ * @param[in]     gpu_pitch     Output row pitch in elements
+ * @param[in]     tolerance     Max |diff| not counted as a mismatch
+ * @param[in,out] result        (mismatches, max |diff| bits), zeroed beforehand (int, size: 2)
+ * @param         count_scratch Local scratch (int, size: local size)
+ * @param         max_scratch   Local scratch (float, size: local size)
+ */
+__kernel void verify_compare_u8(__global const uchar* gpu, __global const uchar* ref,
+                                int row_elems, int rows, int gpu_pitch, float tolerance,
+                                __global int* result, __local int* count_scratch,
+                                __local float* max_scratch) {
+    int total = row_elems * rows;
+    int errors = 0;
+    float max_diff = 0.0f;
+
+    for (int i = get_global_id(0); i < total; i += get_global_size(0)) {
+        int y = i / row_elems;
+        int x = i - y * row_elems;
+        float diff = (float)abs((int)gpu[y * gpu_pitch + x] - (int)ref[i]);
+        errors += (diff > tolerance) ? 1 : 0;
+        max_diff = fmax(max_diff, diff);
+    }
+    verify_flush(errors, max_diff, count_scratch, max_scratch, result);
+}
+
+/**
+ * @brief Compare a float output with its golden
+ *
+ * @param[in]     gpu           Output (float, rows * gpu_pitch)
+ * @param[in]     ref           Golden (float, rows * row_elems, packed)
+ * @param[in]     row_elems     Elements per row (width * channels)
+ * @param[in]     rows          Number of rows
+ * @param[in]     gpu_pitch     Output row pitch in elements
+ * @param[in]     tolerance     Max |diff| not counted as a mismatch
+ * @param[in,out] result        (mismatches, max |diff| bits), zeroed beforehand (int, size: 2)
+ * @param         count_scratch Local scratch (int, size: local size)
+ * @param         max_scratch   Local scratch (float, size: local size)
+ */
+__kernel void verify_compare_f32(__global const float* gpu, __global const float* ref,
+                                 int row_elems, int rows, int gpu_pitch, float tolerance,
+                                 __global int* result, __local int* count_scratch,
+                                 __local float* max_scratch) {
+    int total = row_elems * rows;
+    int errors = 0;
+    float max_diff = 0.0f;
+
+    for (int i = get_global_id(0); i < total; i += get_global_size(0)) {
+        int y = i / row_elems;
+        int x = i - y * row_elems;
+        float g = gpu[y * gpu_pitch + x];
+        float r = ref[i];
+        /* Identical bits, including matching inf / NaN, are no difference (as ElementDiff()) */
+        float diff = (as_uint(g) == as_uint(r)) ? 0.0f : fabs(g - r);
+        diff = isfinite(diff) ? diff : INFINITY;
+        errors += (diff > tolerance) ? 1 : 0;
+        max_diff = fmax(max_diff, diff);
+    }
+    verify_flush(errors, max_diff, count_scratch, max_scratch, result);
+}
@@ -24,7 +24,10 @@
 #endif
 
 /** Maximum number of custom buffers per algorithm */
-#define MAX_CUSTOM_BUFFERS 8
+#define MAX_CUSTOM_BUFFERS 16
+
+/** Maximum named outputs of one kernel (primary output included) */
+#define MAX_OUTPUT_BUFFERS 4
 
 /** Maximum number of custom scalars per algorithm */
 #define MAX_CUSTOM_SCALARS 32
@@ -136,15 +139,16 @@ typedef struct {
     int src_width;        /**< Source width in pixels */
     int src_height;       /**< Source height in pixels */
     int src_channels;     /**< Source number of channels (default 1) */
-    int src_stride;       /**< Source stride in bytes (0 = packed, width * channels) */
+    int src_stride;       /**< Source row stride in elements (packed: width * channels; the
+                             device row pitch for "pitched" kernels) */
 
     /* Output image */
     unsigned char* output; /**< Output image buffer (for reference_impl) */
     int dst_width;         /**< Destination width in pixels */
     int dst_height;        /**< Destination height in pixels */
     int dst_channels;      /**< Destination number of channels (default 1) */
-    int dst_stride;        /**< Destination stride in bytes (0 = packed, width *
-                              channels) */
+    int dst_stride;        /**< Destination row stride in elements (packed: width *
+                              channels; the device row pitch for "pitched" kernels) */
 
     /* Verification buffers (for verify_result only) */
     unsigned char* ref_output; /**< Reference implementation output buffer */
@@ -157,6 +161,10 @@ typedef struct {
     /* Custom buffers (for algorithms needing additional data) */
     CustomBuffers* custom_buffers; /**< Pointer to custom buffer collection (NULL if none) */
 
+    /* Secondary outputs of multi-output kernels ("buffers" in outputs.json) */
+    CustomBuffers* outputs; /**< Named outputs after the primary one, which stays in output;
+                               host_data receives the reference (NULL if single output) */
+
     /* Custom scalars (for algorithm-specific parameters) */
     CustomScalars* custom_scalars; /**< Pointer to custom scalar collection (NULL if none) */
 
@@ -201,4 +209,30 @@ typedef struct {
      * @param[in] params Operation parameters (input, output, dimensions, etc.)
      */
     void (*reference_impl)(const OpParams* params);
+
+    /**
+     * @brief Optional row-range reference implementation (NULL if absent)
+     *
+     * Computes output rows [row_begin, row_end) only and must produce
+     * exactly what reference_impl writes to those rows. The full input
+     * image stays visible, so the halo rows of a band are read in place.
+     * Calls for disjoint row ranges run concurrently: the C reference
+     * thread pool splits the image into horizontal bands and runs them in
+     * parallel. Registered automatically when the *_ref.c file defines
+     * <AlgoName>RefRows().
+     *
+     * @param[in] params Operation parameters (as for reference_impl)
+     * @param[in] row_begin First output row to compute
+     * @param[in] row_end One past the last output row to compute
+     */
+    void (*reference_rows_impl)(const OpParams* params, int row_begin, int row_end);
+
+    /**
+     * @brief Input rows read above and below a band (stencil radius)
+     *
+     * Taken from REF_HALO_ROWS in the *_ref.c file. The thread pool keeps
+     * bands several times taller than their halo so overlapping reads stay
+     * cheap.
+     */
+    int halo_rows;
 } Algorithm;
@@ -0,0 +1,47 @@
+/**
+ * @file cpu_features.h
+ * @brief Runtime CPU SIMD detection for the C reference implementations
+ *
+ * The c_ref implementations keep their scalar code as the border pass and
+ * the portable fallback, and add an interior fast path per instruction set.
+ * CpuSimdLevel() picks the widest path the running CPU supports, so one
+ * binary runs everywhere.
+ *
+ * Every SIMD path evaluates the same arithmetic, in the same order, as the
+ * scalar code (one pixel per vector lane), so the output is bit-identical.
+ * Setting the environment variable OPENCL_REF_SIMD to "scalar", "sse2",
+ * "avx2" or "neon" caps the selected level, e.g. to compare paths.
+ */
+
+#pragma once
+
+/**
+ * @brief SIMD instruction set used by the reference interior fast paths
+ *
+ * Ordered by width within an architecture: a level implies that the lower
+ * levels of the same architecture are available too.
+ */
+typedef enum {
+    CPU_SIMD_SCALAR = 0, /**< Portable scalar code only */
+    CPU_SIMD_SSE2,       /**< x86 SSE2 (16-byte vectors) */
+    CPU_SIMD_AVX2,       /**< x86 AVX2 (32-byte vectors) */
+    CPU_SIMD_NEON        /**< AArch64 AdvSIMD (16-byte vectors) */
+} CpuSimd;
+
+/**
+ * @brief Get the SIMD level to use on this CPU
+ *
+ * Detected once (thread-safe) and cached. The OPENCL_REF_SIMD environment variable can
+ * lower (never raise) the detected level.
+ *
+ * @return Widest supported level, after the optional override
+ */
+CpuSimd CpuSimdLevel(void);
+
+/**
+ * @brief Get a printable name for a SIMD level
+ *
+ * @param[in] level SIMD level
+ * @return "scalar", "sse2", "avx2" or "neon"
+ */
+const char* CpuSimdName(CpuSimd level);
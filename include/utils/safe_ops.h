@@ -156,3 +156,33 @@ static inline bool SafeStrToSize(const char* str, size_t* result) {
     *result = (size_t)val;
     return true;
 }
+
+/**
+ * @brief Safely convert string to float
+ *
+ * Like SafeStrtol(), but for a decimal or exponent float literal.
+ * MISRA C 2023 Rule 21.8 compliant (avoids atof).
+ *
+ * @param[in] str Input string to convert (must be null-terminated)
+ * @param[out] result Pointer to store the converted float value
+ * @return true if conversion succeeded, false on error (invalid format,
+ * overflow, trailing characters)
+ */
+static inline bool SafeStrtof(const char* str, float* result) {
+    char* endptr = NULL;
+    float val;
+
+    if ((str == NULL) || (*str == '\0')) {
+        return false;
+    }
+
+    errno = 0;
+    val = strtof(str, &endptr);
+
+    if ((errno == ERANGE) || (endptr == str) || (*endptr != '\0')) {
+        return false;
+    }
+
+    *result = val;
+    return true;
+}
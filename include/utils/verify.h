@@ -4,10 +4,116 @@
  *
  * Provides standard verification functions that can be used by different
  * algorithms to compare GPU output against reference implementations.
+ *
+ * VerifyCompare() is the full comparator: uchar or float elements, runs of
+ * identical bytes skipped with SSE2/AVX2/NEON compares (utils/cpu_features),
+ * an optional split across threads and optional early exit. It reports an
+ * error histogram, the count above tolerance and the worst element.
+ * VerifyWriteDiffImage() dumps the per-element |gpu - ref| for debugging.
+ *
+ * Float elements may also be accepted by a relative bound
+ * (|diff| <= rel_tolerance * |ref|) or by their distance in ULPs (units in
+ * the last place), so outputs spanning several orders of magnitude get a
+ * fitting tolerance. uchar elements use the absolute tolerance only.
  */
 
 #pragma once
 
+#include <stddef.h>
+
+/** Maximum number of verification threads */
+#define VERIFY_MAX_THREADS 64
+
+/**
+ * @brief Number of error histogram bins
+ *
+ * With unit u = tolerance (or 1 when tolerance is 0): bin 0 counts exact
+ * matches, bin 1 counts 0 < |diff| <= u, bin k counts
+ * 2^(k-2) u < |diff| <= 2^(k-1) u, and the last bin also collects larger
+ * and non-finite differences.
+ */
+#define VERIFY_HISTOGRAM_BINS 12
+
+/**
+ * @brief Element type of the compared outputs
+ */
+typedef enum {
+    VERIFY_ELEMENT_UCHAR = 0, /**< 8-bit unsigned (images) */
+    VERIFY_ELEMENT_FLOAT      /**< 32-bit float (responses, flow fields) */
+} VerifyElementType;
+
+/**
+ * @brief Comparison settings
+ */
+typedef struct {
+    VerifyElementType element_type; /**< Element type of both buffers */
+    int width;                      /**< Image width in pixels */
+    int height;                     /**< Image height in pixels */
+    int channels;                   /**< Elements per pixel (<= 0 means 1) */
+    float tolerance;                /**< Max |diff| not counted as an error */
+    float rel_tolerance;            /**< Float: also accept |diff| <= rel_tolerance * |ref| */
+    int ulp_tolerance;              /**< Float: also accept elements this many ULPs apart */
+    float error_rate_threshold;     /**< Max fraction of elements above tolerance */
+    int threads;                    /**< Threads to split elements across (<= 1: calling thread) */
+    int early_exit;                 /**< Stop once the error budget is exceeded */
+} VerifyOptions;
+
+/**
+ * @brief Comparison outcome
+ *
+ * With early exit the counts cover only the elements examined before the
+ * budget was exceeded (early_exited is then non-zero); the verdict is final.
+ */
+typedef struct {
+    int passed;                                /**< 1 if error rate <= threshold */
+    int early_exited;                          /**< Non-zero if stopped early */
+    size_t total_elements;                     /**< Elements in the image */
+    size_t errors;                             /**< Elements outside every tolerance bound */
+    float error_rate;                          /**< errors / total_elements */
+    float max_error;                           /**< Largest |diff| (INFINITY if non-finite) */
+    int worst_x;                               /**< Worst element column (-1 if none differ) */
+    int worst_y;                               /**< Worst element row */
+    int worst_channel;                         /**< Worst element channel */
+    float worst_gpu;                           /**< GPU value at the worst element */
+    float worst_ref;                           /**< Reference value at the worst element */
+    size_t histogram[VERIFY_HISTOGRAM_BINS];   /**< |diff| distribution (see above) */
+} VerifyReport;
+
+/**
+ * @brief Compare two outputs element by element
+ *
+ * @param[in] gpu_output GPU-generated output
+ * @param[in] ref_output Reference output
+ * @param[in] opts Comparison settings
+ * @param[out] report Comparison outcome
+ * @return 0 on success, -1 on invalid arguments
+ */
+int VerifyCompare(const void* gpu_output, const void* ref_output, const VerifyOptions* opts,
+                  VerifyReport* report);
+
+/**
+ * @brief Print a report (mismatch count, worst element, histogram)
+ *
+ * @param[in] opts Settings used for the comparison
+ * @param[in] report Report from VerifyCompare()
+ */
+void VerifyPrintReport(const VerifyOptions* opts, const VerifyReport* report);
+
+/**
+ * @brief Write the per-element |gpu - ref| image
+ *
+ * Same layout as the outputs: uchar outputs give a uchar image, float
+ * outputs a float image.
+ *
+ * @param[in] gpu_output GPU-generated output
+ * @param[in] ref_output Reference output
+ * @param[in] opts Settings used for the comparison (type and dimensions)
+ * @param[in] path Destination raw file
+ * @return 0 on success, -1 on error
+ */
+int VerifyWriteDiffImage(const void* gpu_output, const void* ref_output,
+                         const VerifyOptions* opts, const char* path);
+
 /**
  * @brief Verify exact pixel match between two images
  *
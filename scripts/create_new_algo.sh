@@ -102,6 +102,9 @@ cat > "$C_REF_FILE" << EOF
 #include "op_registry.h"
 #include "utils/safe_ops.h"
 
+/** Input rows read above and below each output row (stencil radius) */
+#define REF_HALO_ROWS 0
+
 /**
  * @brief ${ALGO_NAME_PASCAL} reference implementation
  *
@@ -114,8 +117,10 @@ cat > "$C_REF_FILE" << EOF
  *   - src_width, src_height: Source dimensions
  *   - dst_width, dst_height: Destination dimensions
  *   - custom_buffers: Optional custom buffers (NULL if none)
+ * @param[in] row_begin First output row to compute
+ * @param[in] row_end One past the last output row to compute
  */
-void ${ALGO_NAME_PASCAL}Ref(const OpParams* params) {
+void ${ALGO_NAME_PASCAL}RefRows(const OpParams* params, int row_begin, int row_end) {
     int y;
     int x;
     int width;
@@ -144,9 +149,16 @@ void ${ALGO_NAME_PASCAL}Ref(const OpParams* params) {
         return; /* Overflow detected */
     }
 
+    if (row_begin < 0) {
+        row_begin = 0;
+    }
+    if (row_end > height) {
+        row_end = height;
+    }
+
     /* TODO: Implement your algorithm here */
     /* Example: Simple copy operation */
-    for (y = 0; y < height; y++) {
+    for (y = row_begin; y < row_end; y++) {
         for (x = 0; x < width; x++) {
             output_index = y * width + x;
 
@@ -158,6 +170,19 @@ void ${ALGO_NAME_PASCAL}Ref(const OpParams* params) {
     }
 }
 
+/**
+ * @brief ${ALGO_NAME_PASCAL} reference implementation (whole image)
+ *
+ * @param[in] params Operation parameters (see ${ALGO_NAME_PASCAL}RefRows)
+ */
+void ${ALGO_NAME_PASCAL}Ref(const OpParams* params) {
+    if (params == NULL) {
+        return;
+    }
+
+    ${ALGO_NAME_PASCAL}RefRows(params, 0, params->src_height);
+}
+
 /*
  * NOTE: Registration of this algorithm happens in auto_registry.c
  * Auto-generated by scripts/generate_registry.sh which scans for *_ref.c files.
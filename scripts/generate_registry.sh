@@ -53,6 +53,13 @@ for file in $ALGO_FILES; do
     cat >> "$OUTPUT_FILE" <<EOF
 extern void ${pascal_name}Ref(const OpParams* params);
 EOF
+
+    # Optional row-range entry point (multithreaded C reference)
+    if grep -q "^void ${pascal_name}RefRows(" "$file"; then
+        cat >> "$OUTPUT_FILE" <<EOF
+extern void ${pascal_name}RefRows(const OpParams* params, int row_begin, int row_end);
+EOF
+    fi
 done
 
 # Add algorithm structures
@@ -68,12 +75,23 @@ for file in $ALGO_FILES; do
     # Use PascalCase for display name (e.g., dilate3x3 -> Dilate3x3)
     display_name="$pascal_name"
 
+    # Row-range entry point and its halo (#define REF_HALO_ROWS n), if any
+    rows_impl="NULL"
+    halo_rows=0
+    if grep -q "^void ${pascal_name}RefRows(" "$file"; then
+        rows_impl="${pascal_name}RefRows"
+        halo_rows=$(sed -n 's/^#define REF_HALO_ROWS \([0-9][0-9]*\).*/\1/p' "$file" | head -n 1)
+        halo_rows=${halo_rows:-0}
+    fi
+
     # Generate algorithm structure (verify_result removed - now config-driven)
     cat >> "$OUTPUT_FILE" <<EOF
 static Algorithm ${algo_name}_algorithm = {
     .name = "$display_name",
     .id = "$algo_name",
-    .reference_impl = ${pascal_name}Ref
+    .reference_impl = ${pascal_name}Ref,
+    .reference_rows_impl = $rows_impl,
+    .halo_rows = $halo_rows
 };
 
 EOF
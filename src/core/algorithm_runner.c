@@ -7,77 +7,640 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 
+#include "algorithm_runner.h"
+#include "core/ref_thread_pool.h"
+#include "core/results_writer.h"
 #include "op_registry.h"
+#include "platform/autotune.h"
+#include "platform/buffer_pool.h"
 #include "platform/cache_manager.h"
+#include "platform/device_verify.h"
 #include "platform/opencl_utils.h"
+#include "platform/pipeline.h"
+#include "platform/batch.h"
+#include "platform/multi_device.h"
+#include "platform/stream.h"
+#include "platform/trace.h"
+#include "utils/benchmark.h"
 #include "utils/config.h"
+#include "utils/cpu_features.h"
 #include "utils/image_io.h"
+#include "utils/mapped_file.h"
 #include "utils/safe_ops.h"
 #include "utils/verify.h"
 
-/** Maximum image size (used for static buffer allocation) */
-#define MAX_IMAGE_SIZE (4096 * 4096)
+/** Byte written over recycled output buffers before a run (never a plausible full result) */
+#define OUTPUT_POISON_BYTE 0xCDU
 
-/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
-/* Using static buffer pool for custom buffer host data */
-#define MAX_CUSTOM_BUFFER_SIZE (2 * 1024 * 1024) /* 2MB max per custom buffer */
-static unsigned char custom_buffer_pool[MAX_CUSTOM_BUFFERS][MAX_CUSTOM_BUFFER_SIZE];
+/* Per-iteration timing samples for benchmark mode */
+static double kernel_samples[MAX_BENCHMARK_ITERATIONS];
+static double upload_samples[MAX_BENCHMARK_ITERATIONS];
+static double readback_samples[MAX_BENCHMARK_ITERATIONS];
 
-void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const Config* config,
-                  OpenCLEnv* env, unsigned char* gpu_output_buffer,
-                  unsigned char* ref_output_buffer) {
-    cl_int err;
-    unsigned char* input;
-    int img_size;
-    cl_kernel kernel;
-    cl_mem input_buf = NULL;
-    cl_mem output_buf = NULL;
-    CustomBuffers custom_buffers = {0};
-    CustomScalars custom_scalars = {0};
-    clock_t ref_start;
-    clock_t ref_end;
-    double ref_time;
-    double gpu_time;
-    float max_error;
-    int passed;
-    int write_result;
-    size_t img_size_t;
-    int run_result;
+/* Extra devices of multi-device runs, opened on first use (see RunMultiDevice) */
+static MultiDeviceSet multi_devices;
+
+/* Upload the input image; a pitched kernel's rows go through a rectangular write */
+static int UploadInput(const OpenCLEnv* env, cl_mem input_buf, MemoryStrategy strategy,
+                       const unsigned char* input, size_t input_size, const ImagePitch* pitches,
+                       double* upload_ms) {
+    if (pitches != NULL) {
+        return OpenclUploadRect(env, input_buf, input, &pitches[0], upload_ms);
+    }
+    return OpenclUploadBuffer(env, input_buf, strategy, input, input_size, upload_ms);
+}
+
+/* Read the output image back into packed host rows */
+static int ReadbackOutput(const OpenCLEnv* env, cl_mem output_buf, MemoryStrategy strategy,
+                          unsigned char* output, size_t output_size, const ImagePitch* pitches,
+                          double* readback_ms) {
+    if (pitches != NULL) {
+        return OpenclReadbackRect(env, output_buf, output, &pitches[1], readback_ms);
+    }
+    return OpenclReadbackBuffer(env, output_buf, strategy, output, output_size, readback_ms);
+}
+
+/**
+ * @brief Secondary outputs of a multi-output kernel ("buffers" in outputs.json)
+ *
+ * The first named buffer is the primary output; the others are bound by
+ * name through OpParams.outputs, read back after it with the same row
+ * layout and verified against their own golden.
+ */
+typedef struct {
+    CustomBuffers bound; /**< Name, size and device buffer of the current variant;
+                              host_data holds the reference */
+    const OutputBufferConfig* cfgs[MAX_OUTPUT_BUFFERS - 1]; /**< outputs.json settings */
+    VerifyElementType types[MAX_OUTPUT_BUFFERS - 1];        /**< Element types */
+    int has_golden[MAX_OUTPUT_BUFFERS - 1];                 /**< Non-zero if a golden exists */
+    MappedBuffer refs[MAX_OUTPUT_BUFFERS - 1];              /**< Reference storage */
+    MappedBuffer gpu[MAX_OUTPUT_BUFFERS - 1];               /**< GPU readback storage */
+} SecondaryOutputs;
+
+/* Read the secondary outputs back into their packed host copies */
+static int ReadbackSecondary(const OpenCLEnv* env, const SecondaryOutputs* secondary,
+                             const ImagePitch* pitches, double* readback_ms) {
+    double ms;
     int i;
-    OpParams op_params = {0}; /* Common params reused throughout */
-    char configured_output_path[512] = {0}; /* Output path from outputs.json */
 
-    if ((algo == NULL) || (kernel_cfg == NULL) || (config == NULL) || (env == NULL)) {
-        (void)fprintf(stderr, "Error: NULL parameter in RunAlgorithm\n");
+    *readback_ms = 0.0;
+    for (i = 0; i < secondary->bound.count; i++) {
+        if (ReadbackOutput(env, secondary->bound.buffers[i].buffer, MEM_STRATEGY_COPY,
+                           secondary->gpu[i].data, secondary->bound.buffers[i].size_bytes,
+                           pitches, &ms) != 0) {
+            return -1;
+        }
+        *readback_ms += ms;
+    }
+    return 0;
+}
+
+/**
+ * @brief Run benchmark iterations for an already verified kernel
+ *
+ * Each iteration uploads the input (host-to-device), dispatches the kernel
+ * and reads back the output (device-to-host). Transfers go through the
+ * variant's memory strategy (write/read or map/unmap) and are timed on the
+ * host clock; the kernel is timed from its profiling event. Kernel
+ * arguments must already be set (by OpenclRunKernel); the same kernel and
+ * buffers are reused. When a pipeline is given, the whole stage chain is
+ * dispatched instead and its end-to-end device time is recorded as the
+ * kernel time.
+ *
+ * With a device verifier, the full readback is replaced by an on-device
+ * compare against the golden that returns two ints; its host time is
+ * recorded as the readback time. The output is only read back (once, for
+ * inspection) when an iteration fails verification.
+ *
+ * Secondary outputs of a multi-output kernel are read back after the
+ * primary output and counted in the readback time.
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] kernel Kernel with arguments set (unused for pipelines)
+ * @param[in] kernel_cfg Kernel configuration (unused for pipelines)
+ * @param[in] pipeline Built pipeline, or NULL for a single kernel
+ * @param[in] bench_cfg Benchmark iteration counts
+ * @param[in] strategy Memory strategy of input_buf and output_buf
+ * @param[in] input_buf Device input buffer
+ * @param[in] input Host input data
+ * @param[in] input_size Input size in bytes
+ * @param[in] output_buf Device output buffer
+ * @param[out] output Host readback destination
+ * @param[in] output_size Output size in bytes
+ * @param[in] pitches Input and output row layouts of a pitched kernel, or NULL
+ * @param[in] verifier On-device verifier of the output, or NULL for a full readback
+ * @param[in] secondary Secondary outputs, or NULL
+ * @param[out] result Benchmark statistics
+ * @return 0 on success, -1 on error
+ */
+static int RunBenchmark(OpenCLEnv* env, cl_kernel kernel, const KernelConfig* kernel_cfg,
+                        const PipelineInstance* pipeline, const BenchmarkConfig* bench_cfg,
+                        MemoryStrategy strategy, cl_mem input_buf, const unsigned char* input,
+                        size_t input_size, cl_mem output_buf, unsigned char* output,
+                        size_t output_size, const ImagePitch* pitches,
+                        const DeviceVerifier* verifier, const SecondaryOutputs* secondary,
+                        BenchmarkResult* result) {
+    PipelineTiming pipeline_timing;
+    DeviceVerifyResult check;
+    double kernel_ms;
+    double upload_ms;
+    double readback_ms;
+    double secondary_ms;
+    double start_ms;
+    int total;
+    int iter;
+    int sample;
+
+    result->device_verified = (verifier != NULL) ? 1 : 0;
+    result->verify_failures = 0;
+    total = bench_cfg->warmup_iterations + bench_cfg->iterations;
+    for (iter = 0; iter < total; iter++) {
+        if (UploadInput(env, input_buf, strategy, input, input_size, pitches, &upload_ms) != 0) {
+            return -1;
+        }
+
+        if (pipeline != NULL) {
+            if (PipelineExecute(env, pipeline, &pipeline_timing) != 0) {
+                return -1;
+            }
+            kernel_ms = pipeline_timing.total_ms;
+        } else if (OpenclDispatchKernel(env, kernel, kernel_cfg, &kernel_ms) != 0) {
+            return -1;
+        }
+
+        if (verifier != NULL) {
+            start_ms = BenchmarkNowMs();
+            if (DeviceVerifyRun(env, verifier, output_buf, &check) != 0) {
+                return -1;
+            }
+            readback_ms = BenchmarkNowMs() - start_ms;
+            if (check.passed == 0) {
+                /* Keep the first failing output on the host for inspection */
+                if ((result->verify_failures == 0) &&
+                    (ReadbackOutput(env, output_buf, strategy, output, output_size, pitches,
+                                    NULL) == 0)) {
+                    (void)fprintf(stderr,
+                                  "Iteration %d: on-device verification FAILED (%zu of %zu "
+                                  "elements, max error %.2f); output read back\n",
+                                  iter, check.errors, check.total_elements,
+                                  (double)check.max_error);
+                }
+                result->verify_failures++;
+            }
+        } else {
+            if (ReadbackOutput(env, output_buf, strategy, output, output_size, pitches,
+                               &readback_ms) != 0) {
+                return -1;
+            }
+            if ((secondary != NULL) && (secondary->bound.count > 0)) {
+                if (ReadbackSecondary(env, secondary, pitches, &secondary_ms) != 0) {
+                    return -1;
+                }
+                readback_ms += secondary_ms;
+            }
+        }
+
+        /* Warmup iterations are executed but not recorded */
+        if (iter >= bench_cfg->warmup_iterations) {
+            sample = iter - bench_cfg->warmup_iterations;
+            kernel_samples[sample] = kernel_ms;
+            upload_samples[sample] = upload_ms;
+            readback_samples[sample] = readback_ms;
+        }
+    }
+
+    result->warmup_iterations = bench_cfg->warmup_iterations;
+    if ((BenchmarkComputeStats(kernel_samples, bench_cfg->iterations, &result->kernel) != 0) ||
+        (BenchmarkComputeStats(upload_samples, bench_cfg->iterations, &result->upload) != 0) ||
+        (BenchmarkComputeStats(readback_samples, bench_cfg->iterations, &result->readback) !=
+         0)) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Run the streaming mode for a verified kernel and print its statistics
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] kernel Built kernel
+ * @param[in] kernel_cfg Kernel configuration
+ * @param[in] op_params Operation parameters of the verified run
+ * @param[in] stream_cfg Streaming settings
+ * @param[in] input_size Bytes per input frame
+ * @param[in] output_size Bytes per output frame
+ * @param[in,out] result Variant result (receives the stream statistics)
+ */
+static void RunStream(OpenCLEnv* env, cl_kernel kernel, const KernelConfig* kernel_cfg,
+                      const OpParams* op_params, const StreamConfig* stream_cfg,
+                      size_t input_size, size_t output_size, VariantResult* result) {
+    StreamResult stream;
+    double serial_ms;
+    double bound_ms;
+
+    (void)printf("\n=== Streaming (%s, %d buffer sets) ===\n", stream_cfg->input_path,
+                 stream_cfg->buffer_sets);
+    if (stream_cfg->input_path[0] == '\0') {
+        (void)fprintf(stderr, "Error: Streaming needs a frame source (stream.input or --stream)\n");
+        return;
+    }
+    if (StreamRun(env, kernel, kernel_cfg, op_params, stream_cfg, input_size, output_size,
+                  &stream) != 0) {
+        (void)fprintf(stderr, "Streaming failed\n");
         return;
     }
 
-    if ((gpu_output_buffer == NULL) || (ref_output_buffer == NULL)) {
-        (void)fprintf(stderr, "Error: NULL output buffers in RunAlgorithm\n");
+    /* Serial: one frame at a time; bound: perfect overlap limited by the slowest stage */
+    serial_ms = stream.upload_mean_ms + stream.kernel_mean_ms + stream.readback_mean_ms;
+    bound_ms = stream.upload_mean_ms;
+    if (stream.kernel_mean_ms > bound_ms) {
+        bound_ms = stream.kernel_mean_ms;
+    }
+    if (stream.readback_mean_ms > bound_ms) {
+        bound_ms = stream.readback_mean_ms;
+    }
+
+    (void)printf("Frames:     %d in %.3f ms\n", stream.frames, stream.total_ms);
+    (void)printf("Throughput: %.2f fps (serial %.2f fps, overlap bound %.2f fps)\n", stream.fps,
+                 (serial_ms > 0.0) ? (1000.0 / serial_ms) : 0.0,
+                 (bound_ms > 0.0) ? (1000.0 / bound_ms) : 0.0);
+    (void)printf("Stages:     upload %.3f | kernel %.3f | readback %.3f ms (mean per frame)\n",
+                 stream.upload_mean_ms, stream.kernel_mean_ms, stream.readback_mean_ms);
+    BenchmarkPrintStats("Latency:", &stream.latency);
+
+    result->has_stream = 1;
+    result->stream_frames = stream.frames;
+    result->stream_buffer_sets = stream.buffer_sets;
+    result->stream_fps = stream.fps;
+    result->stream_latency = stream.latency;
+}
+
+/**
+ * @brief Run a verified kernel on all devices and print the per-device split
+ *
+ * @param[in] env Primary OpenCL environment
+ * @param[in] algo Algorithm (its REF_HALO_ROWS is the default row-band halo)
+ * @param[in] kernel_cfg Kernel configuration
+ * @param[in] op_params Operation parameters of the verified run (packed strides)
+ * @param[in] config Full configuration (multi_device and stream sections)
+ * @param[in] input Input frame
+ * @param[in] input_size Bytes per input frame
+ * @param[out] output Output frame (row bands write the assembled frame)
+ * @param[in] output_size Bytes per output frame
+ * @param[in] reference Reference output
+ * @param[in] verify_opts Comparison settings
+ * @param[in,out] result Variant result (receives the multi-device statistics)
+ */
+static void RunMultiDevice(OpenCLEnv* env, const Algorithm* algo, const KernelConfig* kernel_cfg,
+                           const OpParams* op_params, const Config* config,
+                           const unsigned char* input, size_t input_size, unsigned char* output,
+                           size_t output_size, const unsigned char* reference,
+                           const VerifyOptions* verify_opts, VariantResult* result) {
+    static MultiDeviceResult md;
+    MultiDeviceConfig md_cfg = config->multi_device;
+    const char* split = (md_cfg.split == MULTI_SPLIT_ROWS) ? "rows" : "frames";
+    const char* unit = (md_cfg.split == MULTI_SPLIT_ROWS) ? "rows" : "frames";
+    double single_ms;
+    int i;
+
+    /* A band short of its stencil rows would read unset rows at its edges */
+    if ((md_cfg.split == MULTI_SPLIT_ROWS) && (md_cfg.halo == MULTI_DEVICE_HALO_AUTO)) {
+        if (algo->reference_rows_impl == NULL) {
+            (void)fprintf(stderr,
+                          "Error: Row bands of %s need multi_device.halo (the op has no "
+                          "REF_HALO_ROWS)\n",
+                          algo->id);
+            return;
+        }
+        md_cfg.halo = algo->halo_rows;
+    }
+
+    if ((multi_devices.count == 0) &&
+        (MultiDeviceOpen(env, config->multi_device.max_devices, &multi_devices) != 0)) {
+        (void)fprintf(stderr, "Error: Failed to open the device set\n");
+        return;
+    }
+    (void)printf("\n=== Multi-Device (%s, %d devices) ===\n", split, multi_devices.count);
+    if (md_cfg.split == MULTI_SPLIT_ROWS) {
+        (void)printf("Halo:       %d rows\n", md_cfg.halo);
+    }
+    if (MultiDeviceRun(&multi_devices, algo->id, kernel_cfg, op_params, &md_cfg, &config->stream,
+                       input, input_size, output, output_size, reference, verify_opts,
+                       &md) != 0) {
+        (void)fprintf(stderr, "Multi-device run failed\n");
+        return;
+    }
+
+    (void)printf("%-3s %-32s %8s %8s %12s %12s\n", "#", "Device", "Share", unit, "Busy (ms)",
+                 "Rate (/ms)");
+    for (i = 0; i < md.device_count; i++) {
+        (void)printf("%-3d %-32.32s %7.1f%% %8d %12.3f %12.2f\n", i, md.devices[i].device_name,
+                     md.devices[i].share * 100.0, md.devices[i].units, md.devices[i].busy_ms,
+                     md.devices[i].rate);
+    }
+
+    /* Single device: one frame's upload, kernel and readback back-to-back */
+    single_ms = result->upload_ms + result->gpu_time_ms + result->readback_ms;
+    (void)printf("Frames:     %d in %.3f ms\n", md.frames, md.total_ms);
+    (void)printf("Throughput: %.2f fps (single device %.2f fps)\n", md.fps,
+                 (single_ms > 0.0) ? (1000.0 / single_ms) : 0.0);
+    if (md.checks > 0) {
+        (void)printf("Verification: %d/%d outputs match the reference\n",
+                     md.checks - md.failures, md.checks);
+    }
+
+    result->has_multi_device = 1;
+    result->multi_device_count = md.device_count;
+    result->multi_device_split = (int)md.split;
+    result->multi_device_fps = md.fps;
+    result->multi_device_checks = md.checks;
+    result->multi_device_passed = (md.failures == 0) ? 1 : 0;
+}
+
+/**
+ * @brief State shared by all variants of one algorithm run
+ *
+ * Built once by PrepareRunContext and reused for every selected variant:
+ * the input image, custom buffer data, scalars, reference output and the
+ * uploaded input/custom cl_mem objects.
+ */
+typedef struct {
+    unsigned char* input;                         /**< Input image (mapping from ReadImage) */
+    int img_size;                                 /**< Image size in bytes */
+    int output_size;                              /**< Output size in bytes (dst w*h*c*element) */
+    VerifyElementType output_type;                /**< Output element type */
+    OpParams op_params;                           /**< Common params reused for every variant */
+    CustomBuffers custom_buffers;                 /**< Custom buffer host data and cl_mem */
+    CustomScalars custom_scalars;                 /**< Custom scalar values */
+    double ref_time;                              /**< C reference time in ms (0 for golden file) */
+    int ref_threads;                              /**< Threads used by the C reference */
+    double upload_ms;                             /**< Initial input upload time in ms */
+    cl_mem input_buf;                             /**< Uploaded input buffer */
+    char configured_output_path[512];             /**< Output path from outputs.json */
+    MappedBuffer custom_maps[MAX_CUSTOM_BUFFERS]; /**< File-backed custom buffer mappings */
+    const OutputImageConfig* out_cfg;             /**< Selected outputs.json entry */
+    SecondaryOutputs secondary;                   /**< Named outputs after the primary one */
+    int batch_count;                              /**< Images in the input ("batch", 1 = one) */
+    MappedBuffer batch_refs;                      /**< Reference outputs of all batch images */
+    MappedBuffer batch_outputs;                   /**< Per-image, then batched pass outputs */
+} RunContext;
+
+/**
+ * @brief Run the C reference on batch images 1..N-1 (image 0 is already in ref_output)
+ *
+ * @param[in] algo Algorithm with the reference implementation
+ * @param[in] config Full configuration (reference threads)
+ * @param[in] ref_output_buffer Reference output of image 0
+ * @param[in,out] ctx Run context (batch_refs receives all references)
+ * @return 0 on success, -1 on error
+ */
+static int RunBatchReferences(const Algorithm* algo, const Config* config,
+                              unsigned char* ref_output_buffer, RunContext* ctx) {
+    size_t img_size = (size_t)ctx->img_size;
+    size_t output_size = (size_t)ctx->output_size;
+    int bands;
+    int i;
+
+    if (MappedBufferAlloc(output_size * (size_t)ctx->batch_count, &ctx->batch_refs) != 0) {
+        return -1;
+    }
+    (void)memcpy(ctx->batch_refs.data, ref_output_buffer, output_size);
+    for (i = 1; i < ctx->batch_count; i++) {
+        ctx->op_params.input = ctx->input + ((size_t)i * img_size);
+        ctx->op_params.output = ctx->batch_refs.data + ((size_t)i * output_size);
+        if (RefPoolRun(algo, &ctx->op_params,
+                       RefPoolResolveThreads(config->verification.reference_threads),
+                       &bands) < 1) {
+            (void)fprintf(stderr, "Error: C reference failed on batch image %d\n", i);
+            return -1;
+        }
+    }
+    ctx->op_params.input = ctx->input;
+    ctx->op_params.output = ref_output_buffer;
+    (void)printf("Batch references: %d images\n", ctx->batch_count);
+    return 0;
+}
+
+/**
+ * @brief Check every image of one batch pass against its own reference
+ *
+ * @param[in] outputs Outputs of the pass, back to back
+ * @param[in] ctx Run context (batch references)
+ * @param[in] verify_opts Comparison settings
+ * @param[in,out] worst Image with the largest error so far (-1: none)
+ * @param[in,out] worst_error Largest error so far
+ * @return Images that do not match
+ */
+static int VerifyBatchPass(const unsigned char* outputs, const RunContext* ctx,
+                           const VerifyOptions* verify_opts, int* worst, float* worst_error) {
+    VerifyReport report;
+    size_t output_size = (size_t)ctx->output_size;
+    int failures = 0;
+    int i;
+
+    for (i = 0; i < ctx->batch_count; i++) {
+        if ((VerifyCompare(outputs + ((size_t)i * output_size),
+                           ctx->batch_refs.data + ((size_t)i * output_size), verify_opts,
+                           &report) != 0) ||
+            (report.passed == 0)) {
+            failures++;
+        }
+        if ((*worst < 0) || (report.max_error > *worst_error)) {
+            *worst = i;
+            *worst_error = report.max_error;
+        }
+    }
+    return failures;
+}
+
+/**
+ * @brief Run the batch passes of a verified kernel and check every image of both
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] kernel Built kernel
+ * @param[in] kernel_cfg Kernel configuration
+ * @param[in] op_params Operation parameters of one image (packed strides)
+ * @param[in] config Full configuration (benchmark iterations set the rounds)
+ * @param[in,out] ctx Run context (batch input, references and output storage)
+ * @param[in] verify_opts Comparison settings
+ * @param[in,out] result Variant result (receives the batch statistics)
+ */
+static void RunBatch(OpenCLEnv* env, cl_kernel kernel, const KernelConfig* kernel_cfg,
+                     const OpParams* op_params, const Config* config, RunContext* ctx,
+                     const VerifyOptions* verify_opts, VariantResult* result) {
+    BatchResult batch;
+    size_t pass_size = (size_t)ctx->output_size * (size_t)ctx->batch_count;
+    unsigned char* loop_outputs;
+    unsigned char* batch_outputs;
+    int rounds = (config->benchmark.enabled != 0) ? config->benchmark.iterations : 1;
+    int loop_failures;
+    int failures = 0;
+    int worst = -1;
+    float worst_error = 0.0f;
+
+    (void)printf("\n=== Batch (%d images, %d timed round(s)) ===\n", ctx->batch_count, rounds);
+    /* One region per pass, so the batched pass cannot hide a wrong per-image pass */
+    if ((ctx->batch_outputs.data == NULL) &&
+        (MappedBufferAlloc(pass_size * 2U, &ctx->batch_outputs) != 0)) {
+        return;
+    }
+    loop_outputs = ctx->batch_outputs.data;
+    batch_outputs = ctx->batch_outputs.data + pass_size;
+    if (BatchRun(env, kernel, kernel_cfg, op_params, ctx->input, ctx->batch_count,
+                 (size_t)ctx->img_size, loop_outputs, batch_outputs, (size_t)ctx->output_size,
+                 rounds, &batch) != 0) {
+        (void)fprintf(stderr, "Batch run failed\n");
         return;
     }
 
+    /* Unpack: each image of each pass against its own reference */
+    loop_failures = VerifyBatchPass(loop_outputs, ctx, verify_opts, &worst, &worst_error);
+    failures = loop_failures;
+    if (batch.batched != 0) {
+        failures += VerifyBatchPass(batch_outputs, ctx, verify_opts, &worst, &worst_error);
+    }
+
+    (void)printf("Per image:  %d dispatches  %10.3f ms/batch (kernels %.3f ms)  %10.1f images/s\n",
+                 batch.images, batch.loop_ms, batch.loop_kernel_ms, batch.loop_ips);
+    if (batch.batched != 0) {
+        (void)printf("Batched:    1 dispatch    %10.3f ms/batch (kernel  %.3f ms)  %10.1f images/s "
+                     "(%.2fx)\n",
+                     batch.batch_ms, batch.batch_kernel_ms, batch.batch_ips,
+                     (batch.loop_ips > 0.0) ? (batch.batch_ips / batch.loop_ips) : 0.0);
+    } else {
+        (void)printf("Batched:    - (kernel has no \"batch\": true)\n");
+    }
+    (void)printf("Verification: per image %d/%d", batch.images - loop_failures, batch.images);
+    if (batch.batched != 0) {
+        (void)printf(", batched %d/%d", batch.images - (failures - loop_failures), batch.images);
+    }
+    (void)printf(" images match the reference (worst: image %d, max error %.2f)\n", worst,
+                 (double)worst_error);
+
+    result->has_batch = 1;
+    result->batch_images = batch.images;
+    result->batch_loop_ips = batch.loop_ips;
+    result->batch_ips = batch.batch_ips;
+    result->batch_failures = failures;
+}
+
+/**
+ * @brief Allocate the host copies of the secondary outputs
+ *
+ * All outputs of an entry share its dimensions. The reference copies are
+ * handed to the C reference through OpParams.outputs.
+ *
+ * @param[in,out] ctx Run context (output entry and dimensions resolved)
+ * @return 0 on success, -1 on error
+ */
+static int PrepareSecondaryOutputs(RunContext* ctx) {
+    SecondaryOutputs* secondary = &ctx->secondary;
+    const OutputBufferConfig* buf_cfg;
+    RuntimeBuffer* out;
+    size_t elements;
+    int i;
+
+    if (ctx->out_cfg->buffer_count <= 1) {
+        return 0;
+    }
+
+    (void)printf("\n=== Secondary Outputs ===\n");
+    elements = (size_t)ctx->op_params.dst_width * (size_t)ctx->op_params.dst_height *
+               (size_t)ctx->op_params.dst_channels;
+    for (i = 1; i < ctx->out_cfg->buffer_count; i++) {
+        buf_cfg = &ctx->out_cfg->buffers[i];
+        out = &secondary->bound.buffers[i - 1];
+        (void)snprintf(out->name, sizeof(out->name), "%s", buf_cfg->name);
+        out->type = BUFFER_TYPE_WRITE_ONLY;
+        secondary->cfgs[i - 1] = buf_cfg;
+        secondary->types[i - 1] = (buf_cfg->data_type == DATA_TYPE_FLOAT) ? VERIFY_ELEMENT_FLOAT
+                                                                          : VERIFY_ELEMENT_UCHAR;
+        out->size_bytes =
+            elements * ((secondary->types[i - 1] == VERIFY_ELEMENT_FLOAT) ? sizeof(float) : 1U);
+        if ((MappedBufferAlloc(out->size_bytes, &secondary->refs[i - 1]) != 0) ||
+            (MappedBufferAlloc(out->size_bytes, &secondary->gpu[i - 1]) != 0)) {
+            (void)fprintf(stderr, "Error: Failed to allocate output '%s'\n", out->name);
+            return -1;
+        }
+        out->host_data = secondary->refs[i - 1].data;
+        secondary->bound.count++;
+        (void)printf("Output '%s': %s, %zu bytes\n", out->name,
+                     (secondary->types[i - 1] == VERIFY_ELEMENT_FLOAT) ? "float" : "uchar",
+                     out->size_bytes);
+    }
+
+    ctx->op_params.outputs = &secondary->bound;
+    return 0;
+}
+
+/**
+ * @brief Resolve the golden of every secondary output
+ *
+ * An output's own "golden_file" is loaded over the reference copy; without
+ * one, the C reference output is the golden (none with golden_source=file,
+ * the output is then only saved).
+ *
+ * @param[in] config Full configuration
+ * @param[in,out] ctx Run context
+ * @return 0 on success, -1 on error
+ */
+static int LoadSecondaryGoldens(const Config* config, RunContext* ctx) {
+    SecondaryOutputs* secondary = &ctx->secondary;
+    RuntimeBuffer* out;
+    int i;
+
+    for (i = 0; i < secondary->bound.count; i++) {
+        out = &secondary->bound.buffers[i];
+        if (secondary->cfgs[i]->golden_file[0] != '\0') {
+            if (CacheLoadGoldenFromFile(secondary->cfgs[i]->golden_file, out->host_data,
+                                        out->size_bytes) != 0) {
+                (void)fprintf(stderr, "Failed to load golden file of '%s': %s\n", out->name,
+                              secondary->cfgs[i]->golden_file);
+                return -1;
+            }
+            secondary->has_golden[i] = 1;
+        } else {
+            secondary->has_golden[i] =
+                (config->verification.golden_source != GOLDEN_SOURCE_FILE) ? 1 : 0;
+        }
+        if (secondary->has_golden[i] == 0) {
+            (void)printf("Output '%s': no golden, saved without verification\n", out->name);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Load inputs and compute the reference output shared by all variants
+ *
+ * @param[in] algo Algorithm to execute
+ * @param[in] config Full configuration
+ * @param[out] ref_output_buffer Reference output destination
+ * @param[out] ctx Run context to populate
+ * @return 0 on success, -1 on error
+ */
+static int PrepareRunContext(const Algorithm* algo, const Config* config,
+                             unsigned char* ref_output_buffer, RunContext* ctx) {
+    double ref_start;
+    int ref_bands = 1;
+    int i;
+
     /* Load input image from config/inputs.ini */
     if (config->input_image_count == 0) {
         (void)fprintf(stderr, "Error: No input images configured in config/inputs.ini\n");
-        return;
+        return -1;
     }
 
     /* Find the specified input image by input_image_id */
     {
         const InputImageConfig* img_cfg = NULL;
         int selected_index = 0;
-        int i;
 
-        /* If input_image_id is specified, find matching image */
+        /* If input_image_id is specified, find the entry of that name (image_N or named) */
         if (config->input_image_id[0] != '\0') {
             for (i = 0; i < config->input_image_count; i++) {
-                /* Extract image_N from section name for comparison */
-                char image_name[64];
-                (void)snprintf(image_name, sizeof(image_name), "image_%d", i + 1);
-                if (strcmp(config->input_image_id, image_name) == 0) {
+                if (strcmp(config->input_image_id, config->input_images[i].name) == 0) {
                     img_cfg = &config->input_images[i];
                     selected_index = i + 1;
                     break;
@@ -86,9 +649,12 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
             if (img_cfg == NULL) {
                 (void)fprintf(stderr, "Error: Specified input_image_id '%s' not found\n",
                               config->input_image_id);
-                (void)fprintf(stderr, "Available images: image_1 to image_%d\n",
-                              config->input_image_count);
-                return;
+                (void)fprintf(stderr, "Available images:");
+                for (i = 0; i < config->input_image_count; i++) {
+                    (void)fprintf(stderr, " %s", config->input_images[i].name);
+                }
+                (void)fprintf(stderr, "\n");
+                return -1;
             }
         } else {
             /* Default to first image if not specified */
@@ -109,46 +675,58 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
             int temp_size;
             if (!SafeMulInt(img_cfg->src_width, img_cfg->src_height, &temp_size)) {
                 (void)fprintf(stderr, "Image size overflow (width * height)\n");
-                return;
+                return -1;
             }
-            if (!SafeMulInt(temp_size, channels, &img_size)) {
+            if (!SafeMulInt(temp_size, channels, &ctx->img_size)) {
                 (void)fprintf(stderr, "Image size overflow (with channels)\n");
-                return;
+                return -1;
             }
         }
 
-        input = ReadImage(img_cfg->input_path, (size_t)img_size);
-        if (input == NULL) {
+        /* A batch input holds batch_count images back to back; image 0 is the verified one */
+        ctx->batch_count = (img_cfg->batch_count > 0) ? img_cfg->batch_count : 1;
+        if (ctx->batch_count > MAX_BATCH_IMAGES) {
+            (void)fprintf(stderr, "Error: Input batch of %d images exceeds %d\n",
+                          ctx->batch_count, MAX_BATCH_IMAGES);
+            return -1;
+        }
+        if (ctx->batch_count > 1) {
+            (void)printf("Batch: %d images of %d bytes\n", ctx->batch_count, ctx->img_size);
+        }
+
+        ctx->input = ReadImage(img_cfg->input_path,
+                               (size_t)ctx->img_size * (size_t)ctx->batch_count);
+        if (ctx->input == NULL) {
             (void)fprintf(stderr, "Failed to load input image: %s\n", img_cfg->input_path);
-            return;
+            return -1;
         }
 
         /* Initialize common OpParams fields */
-        op_params.src_width = img_cfg->src_width;
-        op_params.src_height = img_cfg->src_height;
-        op_params.src_channels = (img_cfg->src_channels > 0) ? img_cfg->src_channels : 1;
-        op_params.src_stride = img_cfg->src_stride;
+        ctx->op_params.src_width = img_cfg->src_width;
+        ctx->op_params.src_height = img_cfg->src_height;
+        ctx->op_params.src_channels = (img_cfg->src_channels > 0) ? img_cfg->src_channels : 1;
+        ctx->op_params.src_stride = img_cfg->src_stride;
+        /* Host images are packed: an unset stride is width * channels */
+        if (ctx->op_params.src_stride <= 0) {
+            ctx->op_params.src_stride = img_cfg->src_width * ctx->op_params.src_channels;
+        }
     }
 
     /* Resolve output image configuration from config/outputs.ini */
     if (config->output_image_count == 0) {
         (void)fprintf(stderr, "Error: No output images configured in config/outputs.ini\n");
-        return;
+        return -1;
     }
 
     /* Find the specified output image by output_image_id */
     {
         const OutputImageConfig* out_cfg = NULL;
         int selected_index = 0;
-        int i;
 
-        /* If output_image_id is specified, find matching output */
+        /* If output_image_id is specified, find the entry of that name (output_N or named) */
         if (config->output_image_id[0] != '\0') {
             for (i = 0; i < config->output_image_count; i++) {
-                /* Extract output_N from section name for comparison */
-                char output_name[64];
-                (void)snprintf(output_name, sizeof(output_name), "output_%d", i + 1);
-                if (strcmp(config->output_image_id, output_name) == 0) {
+                if (strcmp(config->output_image_id, config->output_images[i].name) == 0) {
                     out_cfg = &config->output_images[i];
                     selected_index = i + 1;
                     break;
@@ -157,9 +735,12 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
             if (out_cfg == NULL) {
                 (void)fprintf(stderr, "Error: Specified output_image_id '%s' not found\n",
                               config->output_image_id);
-                (void)fprintf(stderr, "Available outputs: output_1 to output_%d\n",
-                              config->output_image_count);
-                return;
+                (void)fprintf(stderr, "Available outputs:");
+                for (i = 0; i < config->output_image_count; i++) {
+                    (void)fprintf(stderr, " %s", config->output_images[i].name);
+                }
+                (void)fprintf(stderr, "\n");
+                return -1;
             }
         } else {
             /* Default to first output if not specified */
@@ -174,25 +755,46 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
                      (out_cfg->dst_channels > 0) ? out_cfg->dst_channels : 1);
 
         /* Set output parameters from output image config */
-        op_params.dst_width = out_cfg->dst_width;
-        op_params.dst_height = out_cfg->dst_height;
-        op_params.dst_channels = (out_cfg->dst_channels > 0) ? out_cfg->dst_channels : 1;
-        op_params.dst_stride = out_cfg->dst_stride;
+        ctx->op_params.dst_width = out_cfg->dst_width;
+        ctx->op_params.dst_height = out_cfg->dst_height;
+        ctx->op_params.dst_channels = (out_cfg->dst_channels > 0) ? out_cfg->dst_channels : 1;
+        ctx->op_params.dst_stride = out_cfg->dst_stride;
+        if (ctx->op_params.dst_stride <= 0) {
+            ctx->op_params.dst_stride = out_cfg->dst_width * ctx->op_params.dst_channels;
+        }
+
+        /* MISRA-C:2023 Rule 1.3: Check for integer overflow */
+        ctx->output_type = (out_cfg->data_type == DATA_TYPE_FLOAT) ? VERIFY_ELEMENT_FLOAT
+                                                                    : VERIFY_ELEMENT_UCHAR;
+        {
+            int temp_size;
+            int element_size = (ctx->output_type == VERIFY_ELEMENT_FLOAT) ? (int)sizeof(float) : 1;
+            if (!SafeMulInt(out_cfg->dst_width, out_cfg->dst_height, &temp_size) ||
+                !SafeMulInt(temp_size, ctx->op_params.dst_channels, &temp_size) ||
+                !SafeMulInt(temp_size, element_size, &ctx->output_size)) {
+                (void)fprintf(stderr, "Output size overflow\n");
+                return -1;
+            }
+            if (ctx->output_size <= 0) {
+                (void)fprintf(stderr, "Error: Output image needs dst_width and dst_height\n");
+                return -1;
+            }
+        }
 
         /* Store configured output path for later use */
         if (out_cfg->output_path[0] != '\0') {
-            (void)strncpy(configured_output_path, out_cfg->output_path,
-                          sizeof(configured_output_path) - 1);
+            (void)strncpy(ctx->configured_output_path, out_cfg->output_path,
+                          sizeof(ctx->configured_output_path) - 1);
         }
+        ctx->out_cfg = out_cfg;
     }
 
-    /* Check if image fits in static buffers */
-    if (img_size > MAX_IMAGE_SIZE) {
-        (void)fprintf(stderr, "Image too large for static buffers\n");
-        return;
+    /* Named outputs after the primary one: host storage, bound through OpParams.outputs */
+    if (PrepareSecondaryOutputs(ctx) != 0) {
+        return -1;
     }
 
-    op_params.border_mode = BORDER_CLAMP;
+    ctx->op_params.border_mode = BORDER_CLAMP;
 
     /* Step 0: Load custom buffer data from files (needed by both C ref and GPU)
      */
@@ -201,7 +803,7 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
 
         for (i = 0; i < config->custom_buffer_count; i++) {
             const CustomBufferConfig* buf_cfg = &config->custom_buffers[i];
-            RuntimeBuffer* runtime_buf = &custom_buffers.buffers[i];
+            RuntimeBuffer* runtime_buf = &ctx->custom_buffers.buffers[i];
 
             /* Set buffer configuration metadata */
             (void)strncpy(runtime_buf->name, buf_cfg->name, sizeof(runtime_buf->name) - 1);
@@ -209,36 +811,26 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
             runtime_buf->type = buf_cfg->type;
             runtime_buf->size_bytes = buf_cfg->size_bytes;
 
-            /* File-backed buffer: load data from file directly into buffer pool */
+            /* File-backed buffer: map the file, pages load on first access */
             if (buf_cfg->source_file[0] != '\0') {
-                /* Check if buffer fits in static pool slot */
-                if (buf_cfg->size_bytes > MAX_CUSTOM_BUFFER_SIZE) {
-                    (void)fprintf(stderr, "Error: Custom buffer '%s' too large (%zu bytes, max %d)\n",
-                                  buf_cfg->name, buf_cfg->size_bytes, MAX_CUSTOM_BUFFER_SIZE);
-                    custom_buffers.count = i;
-                    goto cleanup_early;
-                }
-
-                /* Read directly into static buffer pool slot */
-                runtime_buf->host_data = custom_buffer_pool[i];
-                if (ReadImageToBuffer(buf_cfg->source_file, buf_cfg->size_bytes,
-                                      runtime_buf->host_data) != 0) {
+                if (MappedFileOpen(buf_cfg->source_file, buf_cfg->size_bytes,
+                                   &ctx->custom_maps[i]) != 0) {
                     (void)fprintf(stderr, "Failed to load %s\n", buf_cfg->source_file);
-                    custom_buffers.count = i;
-                    goto cleanup_early;
+                    return -1;
                 }
+                runtime_buf->host_data = ctx->custom_maps[i].data;
 
-                (void)printf("Loaded '%s' from %s (%zu bytes)\n", buf_cfg->name,
+                (void)printf("Mapped '%s' from %s (%zu bytes)\n", buf_cfg->name,
                              buf_cfg->source_file, buf_cfg->size_bytes);
             } else {
                 runtime_buf->host_data = NULL;
             }
 
-            custom_buffers.count++;
+            ctx->custom_buffers.count++;
         }
 
         /* Make custom buffer data available to reference implementation */
-        op_params.custom_buffers = &custom_buffers;
+        ctx->op_params.custom_buffers = &ctx->custom_buffers;
     }
 
     /* Step 0b: Populate custom scalars from config */
@@ -247,7 +839,7 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
 
         for (i = 0; i < config->scalar_arg_count; i++) {
             const ScalarArgConfig* scalar_cfg = &config->scalar_args[i];
-            ScalarValue* scalar_val = &custom_scalars.scalars[i];
+            ScalarValue* scalar_val = &ctx->custom_scalars.scalars[i];
 
             /* Copy scalar configuration to runtime structure */
             (void)strncpy(scalar_val->name, scalar_cfg->name, sizeof(scalar_val->name) - 1);
@@ -277,11 +869,11 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
                     break;
             }
 
-            custom_scalars.count++;
+            ctx->custom_scalars.count++;
         }
 
         /* Make custom scalars available via OpParams */
-        op_params.custom_scalars = &custom_scalars;
+        ctx->op_params.custom_scalars = &ctx->custom_scalars;
     }
 
     /* Step 1: Get golden/reference output (either from C ref or from file) */
@@ -289,83 +881,139 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
         /* Load golden directly from file (skip c_ref execution) */
         int load_result;
 
+        /* The primary output's "golden_file" in outputs.json stands in for an unset one */
+        const char* golden_file = config->verification.golden_file;
+        if ((golden_file[0] == '\0') && (ctx->out_cfg->buffer_count > 0)) {
+            golden_file = ctx->out_cfg->buffers[0].golden_file;
+        }
+
         (void)printf("\n=== Loading Golden Sample from File ===\n");
-        if (config->verification.golden_file[0] == '\0') {
+        if (golden_file[0] == '\0') {
             (void)fprintf(stderr, "Error: golden_source=file but golden_file not specified\n");
-            goto cleanup_early;
+            return -1;
         }
 
-        load_result = CacheLoadGoldenFromFile(config->verification.golden_file, ref_output_buffer,
-                                              (size_t)img_size);
+        if (ctx->batch_count > 1) {
+            /* A batch golden holds every image's output back to back */
+            load_result = MappedBufferAlloc((size_t)ctx->output_size * (size_t)ctx->batch_count,
+                                            &ctx->batch_refs);
+            if (load_result == 0) {
+                load_result = CacheLoadGoldenFromFile(golden_file, ctx->batch_refs.data,
+                                                      ctx->batch_refs.size);
+            }
+            if (load_result == 0) {
+                (void)memcpy(ref_output_buffer, ctx->batch_refs.data, (size_t)ctx->output_size);
+            }
+        } else {
+            load_result = CacheLoadGoldenFromFile(golden_file, ref_output_buffer,
+                                                  (size_t)ctx->output_size);
+        }
         if (load_result != 0) {
-            (void)fprintf(stderr, "Failed to load golden file: %s\n",
-                          config->verification.golden_file);
-            goto cleanup_early;
+            (void)fprintf(stderr, "Failed to load golden file: %s\n", golden_file);
+            return -1;
         }
 
-        ref_time = 0.0; /* No c_ref execution time */
+        ctx->ref_time = 0.0; /* No c_ref execution time */
+        ctx->ref_threads = 0;
     } else {
         /* Default: Run C reference implementation to generate golden */
         (void)printf("\n=== C Reference Implementation ===\n");
-        ref_start = clock();
-        op_params.input = input;
-        op_params.output = ref_output_buffer;
-        algo->reference_impl(&op_params);
-        ref_end = clock();
-        ref_time = (double)(ref_end - ref_start) / (double)CLOCKS_PER_SEC * 1000.0;
-        (void)printf("Reference time: %.3f ms\n", ref_time);
-
-        /* Step 2: Golden sample verification (c_ref output only) */
-        (void)printf("\n=== Golden Sample Verification ===\n");
-        if (CacheGoldenExists(algo->id, NULL) != 0) {
-            /* Golden sample exists - verify c_ref against it */
-            size_t golden_differences;
-            int golden_result;
-
-            (void)printf("Golden sample found, verifying c_ref output...\n");
-            golden_result = CacheVerifyGolden(algo->id, NULL, ref_output_buffer, (size_t)img_size,
-                                              &golden_differences);
-            if (golden_result < 0) {
-                (void)fprintf(stderr, "Golden verification failed\n");
-            } else if (golden_result == 0) {
-                (void)fprintf(stderr, "Warning: C reference output differs from golden sample\n");
-            }
-        } else {
-            /* No golden sample - create it from C reference output */
-            int save_result;
+        (void)printf("Reference SIMD: %s\n", CpuSimdName(CpuSimdLevel()));
+        ctx->op_params.input = ctx->input;
+        ctx->op_params.output = ref_output_buffer;
+        /* Wall clock: clock() would add up CPU time across reference threads */
+        ref_start = BenchmarkNowMs();
+        ctx->ref_threads =
+            RefPoolRun(algo, &ctx->op_params,
+                       RefPoolResolveThreads(config->verification.reference_threads), &ref_bands);
+        ctx->ref_time = BenchmarkNowMs() - ref_start;
+        TraceRecordHost("C reference", "reference", ref_start, ref_start + ctx->ref_time);
+        if (ctx->ref_threads < 1) {
+            (void)fprintf(stderr, "Error: C reference implementation failed to run\n");
+            return -1;
+        }
+        (void)printf("Reference threads: %d (%d band(s))\n", ctx->ref_threads, ref_bands);
+        (void)printf("Reference time: %.3f ms\n", ctx->ref_time);
 
-            (void)printf("No golden sample found, creating from C reference output...\n");
-            save_result = CacheSaveGolden(algo->id, NULL, ref_output_buffer, (size_t)img_size);
-            if (save_result == 0) {
-                (void)printf("Golden sample created successfully\n");
-            } else {
-                (void)fprintf(stderr, "Failed to create golden sample\n");
-            }
+        /* Remaining batch images: untimed, the reference time is for one image */
+        if ((ctx->batch_count > 1) && (RunBatchReferences(algo, config, ref_output_buffer,
+                                                          ctx) != 0)) {
+            return -1;
         }
     }
 
-    /* Step 3: Build OpenCL kernel */
-    (void)printf("\n=== Building OpenCL Kernel ===\n");
-    kernel = OpenclBuildKernel(env, algo->id, kernel_cfg);
-    if (kernel == NULL) {
-        (void)fprintf(stderr, "Failed to build kernel\n");
-        return;
+    /* Secondary goldens from file replace what the C reference wrote */
+    return LoadSecondaryGoldens(config, ctx);
+}
+
+/**
+ * @brief Verify c_ref output against the golden sample of the current run dir
+ *
+ * Creates the golden sample from the C reference output if none exists.
+ * Called per variant since each variant has its own cache run directory.
+ *
+ * @param[in] algo Algorithm being executed
+ * @param[in] output_name Named secondary output, or NULL for the primary output
+ * @param[in] ref_output_buffer C reference output
+ * @param[in] size Output size in bytes
+ */
+static void CheckReferenceGolden(const Algorithm* algo, const char* output_name,
+                                 const unsigned char* ref_output_buffer, size_t size) {
+    /* Step 2: Golden sample verification (c_ref output only) */
+    if (output_name == NULL) {
+        (void)printf("\n=== Golden Sample Verification ===\n");
+    } else {
+        (void)printf("\n=== Golden Sample Verification (%s) ===\n", output_name);
+    }
+    if (CacheGoldenExists(algo->id, output_name) != 0) {
+        /* Golden sample exists - verify c_ref against it */
+        size_t golden_differences;
+        int golden_result;
+
+        (void)printf("Golden sample found, verifying c_ref output...\n");
+        golden_result =
+            CacheVerifyGolden(algo->id, output_name, ref_output_buffer, size, &golden_differences);
+        if (golden_result < 0) {
+            (void)fprintf(stderr, "Golden verification failed\n");
+        } else if (golden_result == 0) {
+            (void)fprintf(stderr, "Warning: C reference output differs from golden sample\n");
+        }
+    } else {
+        /* No golden sample - create it from C reference output */
+        int save_result;
+
+        (void)printf("No golden sample found, creating from C reference output...\n");
+        save_result = CacheSaveGolden(algo->id, output_name, ref_output_buffer, size);
+        if (save_result == 0) {
+            (void)printf("Golden sample created successfully\n");
+        } else {
+            (void)fprintf(stderr, "Failed to create golden sample\n");
+        }
     }
+}
 
-    /* Step 4: Create STANDARD OpenCL buffers (input, output) */
-    img_size_t = (size_t)img_size;
-    input_buf = OpenclCreateBuffer(env->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                                   img_size_t, input, "input");
-    if (input_buf == NULL) {
-        OpenclReleaseKernel(kernel);
-        return;
+/**
+ * @brief Create the input and custom OpenCL buffers shared by all variants
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] config Full configuration
+ * @param[in,out] ctx Run context (receives cl_mem handles)
+ * @return 0 on success, -1 on error (partially created buffers are left in ctx)
+ */
+static int CreateSharedBuffers(OpenCLEnv* env, const Config* config, RunContext* ctx) {
+    int i;
+
+    /* Step 4: Create STANDARD OpenCL input buffer */
+    ctx->input_buf = OpenclCreateBuffer(env->context, CL_MEM_READ_ONLY, (size_t)ctx->img_size,
+                                        NULL, "input");
+    if (ctx->input_buf == NULL) {
+        return -1;
     }
 
-    output_buf = OpenclCreateBuffer(env->context, CL_MEM_WRITE_ONLY, img_size_t, NULL, "output");
-    if (output_buf == NULL) {
-        OpenclReleaseMemObject(input_buf, "input buffer");
-        OpenclReleaseKernel(kernel);
-        return;
+    /* Upload with an explicit write (instead of COPY_HOST_PTR) so it can be timed */
+    if (OpenclUploadBuffer(env, ctx->input_buf, MEM_STRATEGY_COPY, ctx->input,
+                           (size_t)ctx->img_size, &ctx->upload_ms) != 0) {
+        return -1;
     }
 
     /* Step 4b: Create OpenCL buffers from already-loaded custom buffer data */
@@ -376,7 +1024,7 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
 
         for (i = 0; i < config->custom_buffer_count; i++) {
             const CustomBufferConfig* buf_cfg = &config->custom_buffers[i];
-            RuntimeBuffer* runtime_buf = &custom_buffers.buffers[i];
+            RuntimeBuffer* runtime_buf = &ctx->custom_buffers.buffers[i];
 
             /* Convert buffer type to OpenCL flags */
             if (buf_cfg->type == BUFFER_TYPE_READ_ONLY) {
@@ -406,105 +1054,1366 @@ void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const C
 
             if (runtime_buf->buffer == NULL) {
                 (void)fprintf(stderr, "Failed to create GPU buffer '%s'\n", buf_cfg->name);
-                goto cleanup;
+                return -1;
             }
         }
     }
 
-    /* Step 5: Run OpenCL kernel (algorithm handles argument setting) */
-    (void)printf("\n=== Running OpenCL Kernel ===\n");
+    return 0;
+}
 
-    /* Note: op_params.custom_buffers already set earlier if custom buffers exist
-     */
-    /* Set host type and kernel variant for this kernel */
-    op_params.host_type = kernel_cfg->host_type;
-    op_params.kernel_variant = kernel_cfg->kernel_variant;
+/**
+ * @brief Release the shared OpenCL buffers of a run context
+ *
+ * @param[in] config Full configuration (buffer names)
+ * @param[in,out] ctx Run context
+ */
+static void ReleaseSharedBuffers(const Config* config, RunContext* ctx) {
+    int i;
 
-    run_result = OpenclRunKernel(env, kernel, algo, input_buf, output_buf, &op_params, kernel_cfg,
-                                 &gpu_time);
-    if (run_result != 0) {
-        (void)fprintf(stderr, "Failed to run kernel\n");
-        goto cleanup;
+    /* Cleanup custom buffers */
+    for (i = 0; i < ctx->custom_buffers.count; i++) {
+        /* Release OpenCL buffer */
+        if (ctx->custom_buffers.buffers[i].buffer != NULL) {
+            OpenclReleaseMemObject(ctx->custom_buffers.buffers[i].buffer,
+                                   config->custom_buffers[i].name);
+            ctx->custom_buffers.buffers[i].buffer = NULL;
+        }
     }
 
-    (void)printf("GPU kernel time: %.3f ms\n", gpu_time);
+    /* MISRA-C:2023 Rule 22.1: Proper resource management */
+    if (ctx->input_buf != NULL) {
+        OpenclReleaseMemObject(ctx->input_buf, "input buffer");
+        ctx->input_buf = NULL;
+    }
 
-    /* Step 6: Read back results */
-    err = clEnqueueReadBuffer(env->queue, output_buf, CL_TRUE, 0U, img_size_t, gpu_output_buffer,
-                              0U, NULL, NULL);
-    if (err != CL_SUCCESS) {
-        (void)fprintf(stderr, "Failed to read output buffer (error code: %d)\n", err);
-        goto cleanup;
+    /* Host mappings last: zero-copy cl_mem objects above may have wrapped them */
+    for (i = 0; i < MAX_CUSTOM_BUFFERS; i++) {
+        ctx->custom_buffers.buffers[i].host_data = NULL;
+        MappedBufferRelease(&ctx->custom_maps[i]);
     }
+    for (i = 0; i < (MAX_OUTPUT_BUFFERS - 1); i++) {
+        ctx->secondary.bound.buffers[i].host_data = NULL;
+        MappedBufferRelease(&ctx->secondary.refs[i]);
+        MappedBufferRelease(&ctx->secondary.gpu[i]);
+    }
+    MappedBufferRelease(&ctx->batch_refs);
+    MappedBufferRelease(&ctx->batch_outputs);
+    ReleaseImage();
+    ctx->input = NULL;
+}
 
-    /* Step 7: Verify GPU results against C reference using config-driven tolerance */
-    op_params.gpu_output = gpu_output_buffer;
-    op_params.ref_output = ref_output_buffer;
-    passed = VerifyWithTolerance(gpu_output_buffer, ref_output_buffer, op_params.dst_width,
-                                 op_params.dst_height, op_params.dst_channels,
-                                 config->verification.tolerance,
-                                 config->verification.error_rate_threshold, &max_error);
+/* A "tolerance" of a named output or a variant replaces the verification section's bounds */
+static void ApplyTolerance(const ToleranceOverride* tolerance, VerifyOptions* opts) {
+    if (tolerance->enabled != 0) {
+        opts->tolerance = tolerance->tolerance;
+        opts->rel_tolerance = tolerance->rel_tolerance;
+        opts->ulp_tolerance = tolerance->ulp_tolerance;
+    }
+}
 
-    /* Display results */
-    (void)printf("\n=== Results ===\n");
-    if (config->verification.golden_source == GOLDEN_SOURCE_FILE) {
-        (void)printf("Golden source:    file (%s)\n", config->verification.golden_file);
-    } else {
-        (void)printf("C Reference time: %.3f ms\n", ref_time);
-        (void)printf("Speedup:          %.2fx\n", ref_time / gpu_time);
+/**
+ * @brief Fill comparison settings from the output image and verification config
+ *
+ * @param[in] ctx Shared run context (output element type, reference threads)
+ * @param[in] config Full configuration
+ * @param[in] params Parameters of the verified run (output dimensions)
+ * @param[out] opts Comparison settings
+ */
+static void BuildVerifyOptions(const RunContext* ctx, const Config* config,
+                               const OpParams* params, VerifyOptions* opts) {
+    opts->element_type = ctx->output_type;
+    opts->width = params->dst_width;
+    opts->height = params->dst_height;
+    opts->channels = params->dst_channels;
+    opts->tolerance = config->verification.tolerance;
+    opts->rel_tolerance = config->verification.rel_tolerance;
+    opts->ulp_tolerance = config->verification.ulp_tolerance;
+    opts->error_rate_threshold = config->verification.error_rate_threshold;
+    /* Same CPU budget as the C reference */
+    opts->threads = RefPoolResolveThreads(config->verification.reference_threads);
+    opts->early_exit = config->verification.early_exit;
+    if ((ctx->out_cfg != NULL) && (ctx->out_cfg->buffer_count > 0)) {
+        ApplyTolerance(&ctx->out_cfg->buffers[0].tolerance, opts);
     }
-    (void)printf("OpenCL GPU time:  %.3f ms\n", gpu_time);
-    (void)printf("Verification:     %s\n", (passed != 0) ? "PASSED" : "FAILED");
-    (void)printf("Max error:        %.2f\n", (double)max_error);
+}
 
-    /* Save output to timestamped run directory */
-    {
-        char output_path[512];
-        const char* run_dir = CacheGetRunDir();
-        if (run_dir != NULL) {
-            (void)snprintf(output_path, sizeof(output_path), "%s/out.bin", run_dir);
-            write_result = WriteImage(output_path, gpu_output_buffer, img_size_t);
-            if (write_result == 0) {
-                (void)printf("Output saved to: %s\n", output_path);
-            } else {
-                (void)fprintf(stderr, "Failed to save output image\n");
-            }
-        }
+/**
+ * @brief Write diff.bin (per-element |gpu - ref|) to the run directory
+ *
+ * Only written when some element differs.
+ *
+ * @param[in] gpu_output_buffer GPU output
+ * @param[in] ref_output_buffer Reference output
+ * @param[in] opts Settings used for the comparison
+ * @param[in] report Comparison outcome
+ */
+static void SaveDiffImage(const unsigned char* gpu_output_buffer,
+                          const unsigned char* ref_output_buffer, const VerifyOptions* opts,
+                          const VerifyReport* report) {
+    char diff_path[512];
+    const char* run_dir = CacheGetRunDir();
 
-        /* Also save to configured output path from outputs.json if specified */
-        if (configured_output_path[0] != '\0') {
-            write_result = WriteImage(configured_output_path, gpu_output_buffer, img_size_t);
-            if (write_result == 0) {
-                (void)printf("Output also saved to: %s\n", configured_output_path);
-            } else {
-                (void)fprintf(stderr, "Failed to save to configured output path: %s\n",
-                              configured_output_path);
-            }
-        }
+    if ((run_dir == NULL) || (report->worst_x < 0)) {
+        return;
+    }
+    (void)snprintf(diff_path, sizeof(diff_path), "%s/diff.bin", run_dir);
+    if (VerifyWriteDiffImage(gpu_output_buffer, ref_output_buffer, opts, diff_path) == 0) {
+        (void)printf("Diff image saved to: %s (%dx%dx%d %s)\n", diff_path, opts->width,
+                     opts->height, (opts->channels > 0) ? opts->channels : 1,
+                     (opts->element_type == VERIFY_ELEMENT_FLOAT) ? "float" : "uchar");
     }
+}
 
-cleanup:
-    /* Cleanup custom buffers */
-    for (i = 0; i < custom_buffers.count; i++) {
-        /* Release OpenCL buffer */
-        if (custom_buffers.buffers[i].buffer != NULL) {
-            OpenclReleaseMemObject(custom_buffers.buffers[i].buffer,
-                                   config->custom_buffers[i].name);
+/**
+ * @brief Compare GPU output with the reference, recorded as a trace span
+ *
+ * @return Result of VerifyCompare()
+ */
+static int TracedVerify(const unsigned char* gpu_output_buffer,
+                        const unsigned char* ref_output_buffer, const VerifyOptions* opts,
+                        VerifyReport* report) {
+    double start_ms = BenchmarkNowMs();
+    int result = VerifyCompare(gpu_output_buffer, ref_output_buffer, opts, report);
+
+    TraceRecordHost("verify", "verify", start_ms, BenchmarkNowMs());
+    return result;
+}
+
+/* Non-zero if the variant binds o_buffer @p name (kernels without kernel_args set their own) */
+static int VariantWritesOutput(const KernelConfig* kernel_cfg, const char* name) {
+    int i;
+
+    if (kernel_cfg->kernel_arg_count == 0) {
+        return 1;
+    }
+    for (i = 0; i < kernel_cfg->kernel_arg_count; i++) {
+        if ((kernel_cfg->kernel_args[i].arg_type == KERNEL_ARG_TYPE_BUFFER_OUTPUT) &&
+            (strcmp(kernel_cfg->kernel_args[i].source_name, name) == 0)) {
+            return 1;
         }
-        /* Note: host_data points to static buffer pool, no free needed */
     }
+    return 0;
+}
 
-    /* Cleanup standard buffers - MISRA-C:2023 Rule 22.1: Proper resource
-     * management */
-    OpenclReleaseMemObject(output_buf, "output buffer");
-    OpenclReleaseMemObject(input_buf, "input buffer");
-    OpenclReleaseKernel(kernel);
-
-    /* NOTE: input points to static buffer from ReadImage(), don't free it */
-    return;
+/**
+ * @brief Verify secondary output @p i (already read back) against its golden
+ *
+ * @param[in] config Full configuration (verification section)
+ * @param[in] secondary Secondary outputs
+ * @param[in] i Output index
+ * @param[in] primary_opts Comparison settings of the primary output
+ * @param[out] out Verdict of the output
+ * @param[in,out] result Per-variant result (passed ANDed)
+ * @return 0 on success, -1 if the comparison failed to run
+ */
+static int VerifySecondaryOutput(const Config* config, const SecondaryOutputs* secondary, int i,
+                                 const VerifyOptions* primary_opts, OutputVerifyResult* out,
+                                 VariantResult* result) {
+    VerifyOptions opts = *primary_opts;
+    VerifyReport report;
+
+    opts.element_type = secondary->types[i];
+    opts.tolerance = config->verification.tolerance;
+    opts.rel_tolerance = config->verification.rel_tolerance;
+    opts.ulp_tolerance = config->verification.ulp_tolerance;
+    ApplyTolerance(&secondary->cfgs[i]->tolerance, &opts);
+    if (TracedVerify(secondary->gpu[i].data, secondary->bound.buffers[i].host_data, &opts,
+                     &report) != 0) {
+        (void)fprintf(stderr, "Error: Verification of '%s' failed to run\n", out->name);
+        return -1;
+    }
+    out->verified = 1;
+    out->passed = report.passed;
+    out->errors = report.errors;
+    out->total_elements = report.total_elements;
+    out->max_error = report.max_error;
+    (void)printf("Output %-10s %s (max error %.4g)\n", out->name,
+                 (report.passed != 0) ? "PASSED" : "FAILED", (double)report.max_error);
+    if (report.passed == 0) {
+        VerifyPrintReport(&opts, &report);
+        result->passed = 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read back and verify the secondary outputs of a variant
+ *
+ * Outputs without a golden, or not written by the variant, are read back
+ * only. Each verdict is ANDed into result->passed.
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] kernel_cfg Kernel configuration (o_buffer names)
+ * @param[in] config Full configuration (verification section)
+ * @param[in] ctx Shared run context (secondary outputs bound to the variant's buffers)
+ * @param[in] primary_opts Comparison settings of the primary output
+ * @param[in] pitches Row layouts of a pitched kernel, or NULL
+ * @param[in,out] result Per-variant result (outputs, passed, readback time)
+ * @return 0 on success, -1 on error
+ */
+static int VerifySecondaryOutputs(const OpenCLEnv* env, const KernelConfig* kernel_cfg,
+                                  const Config* config, const RunContext* ctx,
+                                  const VerifyOptions* primary_opts, const ImagePitch* pitches,
+                                  VariantResult* result) {
+    const SecondaryOutputs* secondary = &ctx->secondary;
+    OutputVerifyResult* out;
+    double readback_ms;
+    int i;
+
+    if (ReadbackSecondary(env, secondary, pitches, &readback_ms) != 0) {
+        return -1;
+    }
+    result->readback_ms += readback_ms;
+
+    for (i = 0; i < secondary->bound.count; i++) {
+        out = &result->outputs[i];
+        (void)memset(out, 0, sizeof(*out));
+        (void)snprintf(out->name, sizeof(out->name), "%s", secondary->bound.buffers[i].name);
+        result->output_count = i + 1;
+        if (secondary->has_golden[i] == 0) {
+            (void)printf("Output %-10s saved (no golden)\n", out->name);
+            continue;
+        }
+        if (VariantWritesOutput(kernel_cfg, out->name) == 0) {
+            (void)printf("Output %-10s not written by this variant\n", out->name);
+            continue;
+        }
+        if (VerifySecondaryOutput(config, secondary, i, primary_opts, out, result) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Verify the pipeline buffers that have an "output_goldens" entry
+ *
+ * Each entry names a secondary output of outputs.json; the pipeline buffer
+ * of that name is read back and compared with the pipeline's own golden,
+ * which replaces the single-variant one.
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] pipeline Pipeline configuration
+ * @param[in] config Full configuration (verification section)
+ * @param[in,out] ctx Shared run context (secondary reference and readback storage)
+ * @param[in] primary_opts Comparison settings of the final output
+ * @param[in,out] result Pipeline result (outputs, passed, readback time)
+ * @return 0 on success, -1 on error
+ */
+static int VerifyPipelineOutputs(const OpenCLEnv* env, const PipelineConfig* pipeline,
+                                 const Config* config, RunContext* ctx,
+                                 const VerifyOptions* primary_opts, VariantResult* result) {
+    SecondaryOutputs* secondary = &ctx->secondary;
+    RuntimeBuffer* bound;
+    cl_mem buffer;
+    OutputVerifyResult* out;
+    double readback_ms;
+    const char* name;
+    int g;
+    int i;
+    int b;
+
+    for (g = 0; g < pipeline->golden_count; g++) {
+        name = pipeline->goldens[g].output;
+        i = 0;
+        while ((i < secondary->bound.count) &&
+               (strcmp(secondary->bound.buffers[i].name, name) != 0)) {
+            i++;
+        }
+        buffer = NULL;
+        for (b = 0; b < ctx->custom_buffers.count; b++) {
+            if (strcmp(config->custom_buffers[b].name, name) == 0) {
+                buffer = ctx->custom_buffers.buffers[b].buffer;
+            }
+        }
+        if ((i >= secondary->bound.count) || (buffer == NULL)) {
+            (void)fprintf(stderr, "Error: Pipeline '%s' golden for '%s', which is not both a "
+                                  "named output and a buffer\n",
+                          pipeline->pipeline_id, name);
+            return -1;
+        }
+
+        bound = &secondary->bound.buffers[i];
+        if (CacheLoadGoldenFromFile(pipeline->goldens[g].golden_file, bound->host_data,
+                                    bound->size_bytes) != 0) {
+            (void)fprintf(stderr, "Failed to load golden file of '%s': %s\n", bound->name,
+                          pipeline->goldens[g].golden_file);
+            return -1;
+        }
+        if (OpenclReadbackBuffer(env, buffer, MEM_STRATEGY_COPY, secondary->gpu[i].data,
+                                 bound->size_bytes, &readback_ms) != 0) {
+            return -1;
+        }
+        result->readback_ms += readback_ms;
+
+        out = &result->outputs[result->output_count];
+        (void)memset(out, 0, sizeof(*out));
+        (void)snprintf(out->name, sizeof(out->name), "%s", bound->name);
+        result->output_count++;
+        if (VerifySecondaryOutput(config, secondary, i, primary_opts, out, result) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+/**
+ * @brief Write trace.json to the run directory (when tracing) and start a new trace
+ */
+static void SaveTrace(void) {
+    char trace_path[512];
+    const char* run_dir = CacheGetRunDir();
+
+    if ((TraceEnabled() != 0) && (run_dir != NULL)) {
+        (void)snprintf(trace_path, sizeof(trace_path), "%s/trace.json", run_dir);
+        (void)TraceWrite(trace_path);
+    }
+    TraceReset();
+}
+
+/**
+ * @brief Save GPU output to the run directory and the configured output path
+ *
+ * @param[in] ctx Shared run context
+ * @param[in] gpu_output_buffer GPU output
+ * @param[in] size Output size in bytes
+ */
+static void SaveOutputs(const RunContext* ctx, const unsigned char* gpu_output_buffer,
+                        size_t size) {
+    char output_path[512];
+    const char* run_dir = CacheGetRunDir();
+    int write_result;
+
+    /* Save output to timestamped run directory */
+    if (run_dir != NULL) {
+        (void)snprintf(output_path, sizeof(output_path), "%s/out.bin", run_dir);
+        write_result = WriteImage(output_path, gpu_output_buffer, size);
+        if (write_result == 0) {
+            (void)printf("Output saved to: %s\n", output_path);
+        } else {
+            (void)fprintf(stderr, "Failed to save output image\n");
+        }
+    }
+
+    /* Also save to configured output path from outputs.json if specified */
+    if (ctx->configured_output_path[0] != '\0') {
+        write_result = WriteImage(ctx->configured_output_path, gpu_output_buffer, size);
+        if (write_result == 0) {
+            (void)printf("Output also saved to: %s\n", ctx->configured_output_path);
+        } else {
+            (void)fprintf(stderr, "Failed to save to configured output path: %s\n",
+                          ctx->configured_output_path);
+        }
+    }
+}
+
+/**
+ * @brief Save the secondary outputs to the run directory and their configured paths
+ *
+ * Written as out_<name>.bin next to out.bin.
+ *
+ * @param[in] ctx Shared run context (GPU copies read back)
+ */
+static void SaveSecondaryOutputs(const RunContext* ctx) {
+    char output_path[512];
+    const char* run_dir = CacheGetRunDir();
+    const RuntimeBuffer* out;
+    int i;
+
+    for (i = 0; i < ctx->secondary.bound.count; i++) {
+        out = &ctx->secondary.bound.buffers[i];
+        if (run_dir != NULL) {
+            (void)snprintf(output_path, sizeof(output_path), "%s/out_%s.bin", run_dir, out->name);
+            if (WriteImage(output_path, ctx->secondary.gpu[i].data, out->size_bytes) == 0) {
+                (void)printf("Output '%s' saved to: %s\n", out->name, output_path);
+            } else {
+                (void)fprintf(stderr, "Failed to save output '%s'\n", out->name);
+            }
+        }
+        if (ctx->secondary.cfgs[i]->output_path[0] != '\0') {
+            if (WriteImage(ctx->secondary.cfgs[i]->output_path, ctx->secondary.gpu[i].data,
+                           out->size_bytes) != 0) {
+                (void)fprintf(stderr, "Failed to save output '%s' to: %s\n", out->name,
+                              ctx->secondary.cfgs[i]->output_path);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Set up on-device verification of benchmark iterations, if configured
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] config Full configuration (verification.on_device)
+ * @param[in] opts Comparison settings of the first run
+ * @param[in] golden Reference output
+ * @param[in] output_pitch Row layout of the device output, or NULL if packed
+ * @param[out] verifier Verifier storage
+ * @return @p verifier when ready, NULL for a full readback per iteration
+ */
+static const DeviceVerifier* StartDeviceVerify(OpenCLEnv* env, const Config* config,
+                                               const VerifyOptions* opts,
+                                               const unsigned char* golden,
+                                               const ImagePitch* output_pitch,
+                                               DeviceVerifier* verifier) {
+    (void)memset(verifier, 0, sizeof(*verifier));
+    if (config->verification.on_device == 0) {
+        return NULL;
+    }
+    if (DeviceVerifyCreate(env, opts, golden, output_pitch, verifier) != 0) {
+        (void)fprintf(stderr, "Warning: On-device verification unavailable, reading back\n");
+        return NULL;
+    }
+    return verifier;
+}
+
+/**
+ * @brief Print benchmark statistics of one variant or pipeline
+ *
+ * @param[in] kernel_label Label of the kernel (or pipeline) row
+ * @param[in] bench Benchmark statistics
+ */
+static void PrintBenchmark(const char* kernel_label, const BenchmarkResult* bench) {
+    BenchmarkPrintStats(kernel_label, &bench->kernel);
+    BenchmarkPrintStats("Upload:", &bench->upload);
+    if (bench->device_verified != 0) {
+        BenchmarkPrintStats("Verify:", &bench->readback);
+        (void)printf("On-device verify: %d of %d iterations FAILED\n", bench->verify_failures,
+                     bench->kernel.count);
+    } else {
+        BenchmarkPrintStats("Readback:", &bench->readback);
+    }
+}
+
+/* Precision label of a variant ("fp16" that fell back is reported as such) */
+static const char* PrecisionName(int precision, int fallback) {
+    if (precision == (int)KERNEL_PRECISION_FP16) {
+        return (fallback != 0) ? "fp16->fp32" : "fp16";
+    }
+    return (precision == (int)KERNEL_PRECISION_INT) ? "int" : "fp32";
+}
+
+/* Time used to compare variants: benchmark median when measured, else the verified run */
+static double VariantTimeMs(const VariantResult* result) {
+    return (result->has_benchmark != 0) ? result->benchmark.kernel.median_ms
+                                        : result->gpu_time_ms;
+}
+
+/**
+ * @brief Build, run and verify one kernel variant using the shared context
+ *
+ * @param[in] algo Algorithm to execute
+ * @param[in] variant_cfg Kernel configuration (variant settings)
+ * @param[in] config Full configuration
+ * @param[in] env OpenCL environment
+ * @param[in,out] ctx Shared run context
+ * @param[out] gpu_output_buffer GPU output destination
+ * @param[in] ref_output_buffer Reference output
+ * @param[in] baseline_output Output of the variant's fp32 baseline, or NULL
+ * @param[in] baseline_result Result of the fp32 baseline, or NULL
+ * @param[out] result Per-variant result
+ * @return 0 on success, -1 on error
+ */
+static int RunVariant(const Algorithm* algo, const KernelConfig* variant_cfg,
+                      const Config* config, OpenCLEnv* env, RunContext* ctx,
+                      unsigned char* gpu_output_buffer, unsigned char* ref_output_buffer,
+                      const unsigned char* baseline_output, const VariantResult* baseline_result,
+                      VariantResult* result) {
+    /* Working copy: run-time resolved settings (e.g., autotuned local size) */
+    static KernelConfig run_cfg;
+    const KernelConfig* kernel_cfg = &run_cfg;
+    cl_kernel kernel;
+    cl_mem input_buf;
+    cl_mem variant_input_buf = NULL;
+    cl_mem output_buf;
+    OpParams op_params;
+    MemoryStrategy strategy;
+    double gpu_time;
+    double upload_ms;
+    double readback_ms;
+    VerifyOptions verify_opts;
+    DeviceVerifier device_verifier;
+    const DeviceVerifier* verifier;
+    ImagePitch pitch_storage[2];
+    const ImagePitch* pitches = NULL;
+    size_t img_size_t = (size_t)ctx->img_size;
+    size_t output_size_t = (size_t)ctx->output_size;
+    size_t input_buf_size;
+    size_t output_buf_size;
+    size_t secondary_size;
+    int status = -1;
+    int i;
+
+    run_cfg = *variant_cfg;
+    strategy = kernel_cfg->memory_strategy;
+
+    /* Each variant gets its own cache run directory (kernel binaries, golden, output) */
+    if (CacheInit(algo->id, kernel_cfg->variant_id) != 0) {
+        (void)fprintf(stderr, "Warning: Failed to initialize cache directories for %s\n", algo->id);
+    }
+
+    (void)printf("\n=== Running %s (variant: %s) ===\n", algo->name, kernel_cfg->variant_id);
+
+    if (config->verification.golden_source != GOLDEN_SOURCE_FILE) {
+        CheckReferenceGolden(algo, NULL, ref_output_buffer, output_size_t);
+    }
+    for (i = 0; i < ctx->secondary.bound.count; i++) {
+        /* Only goldens produced by the C reference are cached */
+        if ((ctx->secondary.has_golden[i] != 0) &&
+            (ctx->secondary.cfgs[i]->golden_file[0] == '\0')) {
+            CheckReferenceGolden(algo, ctx->secondary.bound.buffers[i].name,
+                                 ctx->secondary.bound.buffers[i].host_data,
+                                 ctx->secondary.bound.buffers[i].size_bytes);
+        }
+    }
+
+    /* Step 3: Build OpenCL kernel */
+    (void)printf("\n=== Building OpenCL Kernel ===\n");
+    kernel = OpenclBuildKernel(env, algo->id, kernel_cfg);
+    if (kernel == NULL) {
+        (void)fprintf(stderr, "Failed to build kernel\n");
+        return -1;
+    }
+
+    /* Pitched kernels: device rows padded to the device alignment */
+    input_buf_size = img_size_t;
+    output_buf_size = output_size_t;
+    if (kernel_cfg->pitched != 0) {
+        OpenclInitImagePitch(env, img_size_t / (size_t)ctx->op_params.src_height,
+                             (size_t)ctx->op_params.src_height, 1, &pitch_storage[0]);
+        OpenclInitImagePitch(env, output_size_t / (size_t)ctx->op_params.dst_height,
+                             (size_t)ctx->op_params.dst_height, 1, &pitch_storage[1]);
+        pitches = pitch_storage;
+        input_buf_size = pitches[0].device_pitch * pitches[0].rows;
+        output_buf_size = pitches[1].device_pitch * pitches[1].rows;
+        (void)printf("Row pitch: input %zu -> %zu B, output %zu -> %zu B (alignment %zu B)\n",
+                     pitches[0].row_bytes, pitches[0].device_pitch, pitches[1].row_bytes,
+                     pitches[1].device_pitch, env->row_pitch_alignment);
+    }
+
+    /* Zero-copy strategies and pitched rows need their own input buffer; copy reuses the
+     * shared upload */
+    input_buf = ctx->input_buf;
+    upload_ms = ctx->upload_ms;
+    if ((strategy != MEM_STRATEGY_COPY) || (pitches != NULL)) {
+        variant_input_buf = OpenclCreateStrategyBuffer(env, CL_MEM_READ_ONLY, input_buf_size,
+                                                       ctx->input, strategy, "input");
+        if ((variant_input_buf == NULL) ||
+            (UploadInput(env, variant_input_buf, strategy, ctx->input, img_size_t, pitches,
+                         &upload_ms) != 0)) {
+            OpenclReleaseMemObject(variant_input_buf, "input buffer");
+            OpenclReleaseKernel(kernel);
+            return -1;
+        }
+        input_buf = variant_input_buf;
+    }
+
+    /* Output buffer is per variant; a recycled one is poisoned so a stale result can never
+     * pass verification */
+    output_buf = OpenclCreateStrategyBuffer(env, CL_MEM_WRITE_ONLY, output_buf_size,
+                                            gpu_output_buffer, strategy, "output");
+    if ((output_buf != NULL) && (BufferPoolRequestedSize(output_buf) > 0U) &&
+        (OpenclFillBuffer(env, output_buf, OUTPUT_POISON_BYTE, output_buf_size) != 0)) {
+        OpenclReleaseMemObject(output_buf, "output buffer");
+        output_buf = NULL;
+    }
+    if (output_buf == NULL) {
+        OpenclReleaseMemObject(variant_input_buf, "input buffer");
+        OpenclReleaseKernel(kernel);
+        return -1;
+    }
+
+    /* Secondary outputs (poisoned like the primary) share its row layout when pitched */
+    for (i = 0; i < ctx->secondary.bound.count; i++) {
+        RuntimeBuffer* out = &ctx->secondary.bound.buffers[i];
+
+        secondary_size = out->size_bytes;
+        if (pitches != NULL) {
+            if (out->size_bytes != output_size_t) {
+                (void)fprintf(stderr,
+                              "Error: Pitched variants need outputs of one element type ('%s')\n",
+                              out->name);
+                goto cleanup;
+            }
+            secondary_size = output_buf_size;
+        }
+        out->buffer =
+            OpenclCreateBuffer(env->context, CL_MEM_WRITE_ONLY, secondary_size, NULL, out->name);
+        if ((out->buffer == NULL) ||
+            (OpenclFillBuffer(env, out->buffer, OUTPUT_POISON_BYTE, secondary_size) != 0)) {
+            goto cleanup;
+        }
+    }
+
+    /* Step 5: Run OpenCL kernel (algorithm handles argument setting) */
+    (void)printf("\n=== Running OpenCL Kernel ===\n");
+
+    /* Set host type and kernel variant for this kernel */
+    op_params = ctx->op_params;
+    op_params.host_type = kernel_cfg->host_type;
+    op_params.kernel_variant = kernel_cfg->kernel_variant;
+    if (pitches != NULL) {
+        /* Strides in elements: the input is uchar, the output uchar or float */
+        op_params.src_stride = (int)pitches[0].device_pitch;
+        op_params.dst_stride = (int)(pitches[1].device_pitch /
+                                     ((ctx->output_type == VERIFY_ELEMENT_FLOAT) ? sizeof(float)
+                                                                                 : 1U));
+    }
+
+    /* Step 5a: Resolve "local_work_size": "auto" (persisted per device/kernel/image size) */
+    if (kernel_cfg->local_work_size_auto != 0) {
+        if (AutotuneLocalWorkSize(env, kernel, algo->id, input_buf, output_buf, &op_params,
+                                  &run_cfg) != 0) {
+            (void)fprintf(stderr, "Warning: Autotuning failed, using driver-selected local size\n");
+        }
+    }
+
+    if (OpenclRunKernel(env, kernel, algo, input_buf, output_buf, &op_params, kernel_cfg,
+                        &gpu_time, &result->hardware) != 0) {
+        (void)fprintf(stderr, "Failed to run kernel\n");
+        goto cleanup;
+    }
+
+    (void)printf("GPU kernel time: %.3f ms\n", gpu_time);
+
+    /* Step 6: Read back results (read, or map/unmap for zero-copy strategies) */
+    if (ReadbackOutput(env, output_buf, strategy, gpu_output_buffer, output_size_t, pitches,
+                       &readback_ms) != 0) {
+        goto cleanup;
+    }
+
+    /* Step 7: Verify GPU results against C reference using config-driven tolerance */
+    BuildVerifyOptions(ctx, config, &op_params, &verify_opts);
+    ApplyTolerance(&kernel_cfg->tolerance, &verify_opts);
+    if (TracedVerify(gpu_output_buffer, ref_output_buffer, &verify_opts, &result->verify) != 0) {
+        (void)fprintf(stderr, "Error: Verification failed to run\n");
+        goto cleanup;
+    }
+
+    /* Step 7a: Reduced-precision variant against its fp32 baseline's output (same bounds) */
+    result->precision = (int)kernel_cfg->precision;
+    result->precision_fallback = kernel_cfg->precision_fallback;
+    if (baseline_output != NULL) {
+        if (VerifyCompare(gpu_output_buffer, baseline_output, &verify_opts,
+                          &result->baseline_verify) == 0) {
+            result->has_baseline = 1;
+            (void)snprintf(result->baseline_id, sizeof(result->baseline_id), "%s",
+                           kernel_cfg->baseline);
+        }
+    }
+
+    /* Display results */
+    (void)printf("\n=== Results ===\n");
+    if (config->verification.golden_source == GOLDEN_SOURCE_FILE) {
+        (void)printf("Golden source:    file (%s)\n", config->verification.golden_file);
+    } else {
+        (void)printf("C Reference time: %.3f ms (%d thread(s))\n", ctx->ref_time,
+                     ctx->ref_threads);
+        (void)printf("Speedup:          %.2fx\n", ctx->ref_time / gpu_time);
+    }
+    (void)printf("OpenCL GPU time:  %.3f ms\n", gpu_time);
+    (void)printf("Memory strategy:  %s (upload %.3f ms, readback %.3f ms)\n",
+                 OpenclMemoryStrategyName(strategy), upload_ms, readback_ms);
+    if (kernel_cfg->precision != KERNEL_PRECISION_FP32) {
+        (void)printf("Precision:        %s\n",
+                     PrecisionName(result->precision, result->precision_fallback));
+    }
+
+    result->gpu_time_ms = gpu_time;
+    result->upload_ms = upload_ms;
+    result->readback_ms = readback_ms;
+    result->passed = result->verify.passed;
+    result->max_error = result->verify.max_error;
+
+    /* Step 7b: Secondary outputs, each against its own golden (before the verdict line) */
+    if ((ctx->secondary.bound.count > 0) &&
+        (VerifySecondaryOutputs(env, kernel_cfg, config, ctx, &verify_opts, pitches, result) !=
+         0)) {
+        goto cleanup;
+    }
+
+    /* One verdict over every verified output */
+    (void)printf("Verification:     %s\n", (result->passed != 0) ? "PASSED" : "FAILED");
+    (void)printf("Max error:        %.2f\n", (double)result->verify.max_error);
+    VerifyPrintReport(&verify_opts, &result->verify);
+    if (result->has_baseline != 0) {
+        (void)printf("Max error vs %s: %.4g (%zu of %zu elements above tolerance)\n",
+                     result->baseline_id, (double)result->baseline_verify.max_error,
+                     result->baseline_verify.errors, result->baseline_verify.total_elements);
+    }
+    status = 0;
+
+    SaveOutputs(ctx, gpu_output_buffer, output_size_t);
+    SaveSecondaryOutputs(ctx);
+    if (config->verification.dump_diff != 0) {
+        SaveDiffImage(gpu_output_buffer, ref_output_buffer, &verify_opts, &result->verify);
+    }
+
+    /* Step 8: Benchmark iterations (optional, after outputs are saved) */
+    if (config->benchmark.enabled != 0) {
+        (void)printf("\n=== Benchmark (%d warmup + %d timed iterations) ===\n",
+                     config->benchmark.warmup_iterations, config->benchmark.iterations);
+        verifier = NULL;
+        (void)memset(&device_verifier, 0, sizeof(device_verifier));
+        if ((ctx->secondary.bound.count > 0) && (config->verification.on_device != 0)) {
+            (void)fprintf(stderr,
+                          "Warning: On-device verification covers one output, reading back\n");
+        } else {
+            verifier = StartDeviceVerify(env, config, &verify_opts, ref_output_buffer,
+                                         (pitches != NULL) ? &pitches[1] : NULL,
+                                         &device_verifier);
+        }
+        if (RunBenchmark(env, kernel, kernel_cfg, NULL, &config->benchmark, strategy, input_buf,
+                         ctx->input, img_size_t, output_buf, gpu_output_buffer, output_size_t,
+                         pitches, verifier, &ctx->secondary, &result->benchmark) == 0) {
+            result->has_benchmark = 1;
+            PrintBenchmark("Kernel:", &result->benchmark);
+        } else {
+            (void)fprintf(stderr, "Benchmark failed\n");
+        }
+        DeviceVerifyRelease(&device_verifier);
+    }
+
+    /* Step 8b: Streaming mode over a frame sequence (optional, re-binds kernel args) */
+    if (config->stream.enabled != 0) {
+        /* Stream frames use packed device buffers; stride-aware kernels take packed strides */
+        op_params.src_stride = ctx->op_params.src_stride;
+        op_params.dst_stride = ctx->op_params.dst_stride;
+        RunStream(env, kernel, kernel_cfg, &op_params, &config->stream, img_size_t,
+                  output_size_t, result);
+    }
+
+    /* Step 8c: Multi-device split (optional, one kernel per device) */
+    if (config->multi_device.enabled != 0) {
+        if (ctx->secondary.bound.count > 0) {
+            (void)fprintf(stderr, "Warning: Multi-device runs cover one output, skipped\n");
+        } else {
+            op_params.src_stride = ctx->op_params.src_stride;
+            op_params.dst_stride = ctx->op_params.dst_stride;
+            RunMultiDevice(env, algo, kernel_cfg, &op_params, config, ctx->input, img_size_t,
+                           gpu_output_buffer, output_size_t, ref_output_buffer, &verify_opts,
+                           result);
+        }
+    }
+
+    /* Step 8d: Batch of same-shape images (per-image dispatches vs one batched dispatch) */
+    if (ctx->batch_count > 1) {
+        if ((ctx->secondary.bound.count > 0) || (kernel_cfg->host_type != HOST_TYPE_STANDARD)) {
+            (void)fprintf(stderr,
+                          "Warning: Batch runs need the standard host type and one output, "
+                          "skipped\n");
+        } else {
+            op_params.src_stride = ctx->op_params.src_stride;
+            op_params.dst_stride = ctx->op_params.dst_stride;
+            RunBatch(env, kernel, kernel_cfg, &op_params, config, ctx, &verify_opts, result);
+        }
+    }
+
+    if ((result->has_baseline != 0) && (baseline_result != NULL) &&
+        (VariantTimeMs(result) > 0.0)) {
+        result->baseline_speedup = VariantTimeMs(baseline_result) / VariantTimeMs(result);
+    }
+
+    /* Step 9: Machine-readable results in the run directory */
+    {
+        const char* run_dir = CacheGetRunDir();
+        if (run_dir != NULL) {
+            (void)ResultsWriteRunDir(run_dir, algo, kernel_cfg, config, env->device_name, &op_params,
+                                     result);
+        }
+    }
+
+cleanup:
+    /* All commands are complete here (blocking readback or failure after a finish) */
+    SaveTrace();
+
+    /* MISRA-C:2023 Rule 22.1: Proper resource management */
+    OpenclReleaseMemObject(output_buf, "output buffer");
+    OpenclReleaseMemObject(variant_input_buf, "input buffer");
+    for (i = 0; i < ctx->secondary.bound.count; i++) {
+        OpenclReleaseMemObject(ctx->secondary.bound.buffers[i].buffer,
+                               ctx->secondary.bound.buffers[i].name);
+        ctx->secondary.bound.buffers[i].buffer = NULL;
+    }
+    OpenclReleaseKernel(kernel);
+    return status;
+}
+
+/**
+ * @brief Chain the stage C references into the pipeline reference
+ *
+ * Each stage kernel, then the kernel fused into it, runs the C reference
+ * of its "reference" op (default: @p algo) on the previous output, starting
+ * from the input image. Stages are taken as one chain of equally sized
+ * images; pyramid pipelines need a golden_file.
+ *
+ * @param[in] algo Pipeline's algorithm
+ * @param[in] pipeline Pipeline configuration
+ * @param[in] config Full configuration
+ * @param[in,out] ctx Shared run context (ref_time/ref_threads updated)
+ * @param[out] ref_output_buffer Pipeline reference output
+ * @return 0 on success, -1 on error
+ */
+static int BuildPipelineReference(const Algorithm* algo, const PipelineConfig* pipeline,
+                                  const Config* config, RunContext* ctx,
+                                  unsigned char* ref_output_buffer) {
+    const KernelConfig* chain[MAX_PIPELINE_STAGES * 2];
+    const Algorithm* stage_algo;
+    MappedBuffer scratch = {NULL, 0U, 0U};
+    OpParams params = ctx->op_params;
+    unsigned char* in = ctx->input;
+    unsigned char* out;
+    double start_ms;
+    int count = 0;
+    int bands;
+    int s;
+    int status = 0;
+
+    if (pipeline->pyramid_levels > 0) {
+        (void)fprintf(stderr, "Error: Pipeline '%s' has a pyramid; it needs a golden_file\n",
+                      pipeline->pipeline_id);
+        return -1;
+    }
+    for (s = 0; s < pipeline->stage_count; s++) {
+        chain[count] = FindKernelConfig(config, pipeline->stages[s].kernel_id);
+        count++;
+        if (pipeline->stages[s].fuse_kernel_id[0] != '\0') {
+            chain[count] = FindKernelConfig(config, pipeline->stages[s].fuse_kernel_id);
+            count++;
+        }
+    }
+    if ((count > 1) && (ctx->img_size != ctx->output_size)) {
+        (void)fprintf(stderr, "Error: Pipeline '%s' changes the image size; it needs a "
+                              "golden_file\n", pipeline->pipeline_id);
+        return -1;
+    }
+    if ((count > 1) && (MappedBufferAlloc((size_t)ctx->output_size, &scratch) != 0)) {
+        return -1;
+    }
+
+    (void)printf("\n=== Pipeline C Reference (%d step(s)) ===\n", count);
+    ctx->ref_time = 0.0;
+    for (s = 0; (s < count) && (status == 0); s++) {
+        stage_algo = algo;
+        if ((chain[s] != NULL) && (chain[s]->reference[0] != '\0')) {
+            stage_algo = FindAlgorithm(chain[s]->reference);
+        }
+        if ((chain[s] == NULL) || (stage_algo == NULL)) {
+            (void)fprintf(stderr, "Error: No C reference for pipeline '%s' step %d\n",
+                          pipeline->pipeline_id, s);
+            status = -1;
+            break;
+        }
+
+        /* Alternate so that the last step writes the reference buffer */
+        out = (((count - 1 - s) % 2) == 0) ? ref_output_buffer : scratch.data;
+        params.input = in;
+        params.output = out;
+        start_ms = BenchmarkNowMs();
+        ctx->ref_threads = RefPoolRun(
+            stage_algo, &params, RefPoolResolveThreads(config->verification.reference_threads),
+            &bands);
+        ctx->ref_time += BenchmarkNowMs() - start_ms;
+        if (ctx->ref_threads < 1) {
+            (void)fprintf(stderr, "Error: C reference of %s failed to run\n", stage_algo->id);
+            status = -1;
+            break;
+        }
+        (void)printf("Step %d %-12s %s\n", s, chain[s]->variant_id, stage_algo->id);
+        in = out;
+    }
+    if (status == 0) {
+        (void)printf("Reference time: %.3f ms\n", ctx->ref_time);
+    }
+
+    MappedBufferRelease(&scratch);
+    return status;
+}
+
+/**
+ * @brief Build, run and verify one multi-kernel pipeline
+ *
+ * All stages are enqueued back-to-back with event dependencies (see
+ * platform/pipeline.h); only the final "dst" output is read back and
+ * verified. results.json describes the final stage's kernel under the
+ * pipeline id.
+ *
+ * @param[in] algo Algorithm to execute
+ * @param[in] pipeline Pipeline configuration
+ * @param[in] config Full configuration
+ * @param[in] env OpenCL environment
+ * @param[in,out] ctx Shared run context
+ * @param[out] gpu_output_buffer GPU output destination
+ * @param[out] ref_output_buffer Reference output (the pipeline golden_file, or the stage C
+ *                               references chained)
+ * @param[out] result Pipeline result
+ * @return 0 on success, -1 on error
+ */
+static int RunPipeline(const Algorithm* algo, const PipelineConfig* pipeline,
+                       const Config* config, OpenCLEnv* env, RunContext* ctx,
+                       unsigned char* gpu_output_buffer, unsigned char* ref_output_buffer,
+                       VariantResult* result) {
+    static PipelineInstance inst;
+    static KernelConfig summary_cfg;
+    PipelineTiming timing;
+    cl_mem output_buf;
+    double readback_ms;
+    VerifyOptions verify_opts;
+    DeviceVerifier device_verifier;
+    const DeviceVerifier* verifier;
+    int s;
+    size_t img_size_t = (size_t)ctx->img_size;
+    size_t output_size_t = (size_t)ctx->output_size;
+    int status = -1;
+
+    if (CacheInit(algo->id, pipeline->pipeline_id) != 0) {
+        (void)fprintf(stderr, "Warning: Failed to initialize cache directories for %s\n", algo->id);
+    }
+
+    (void)printf("\n=== Running %s (pipeline: %s, %d stages) ===\n", algo->name,
+                 pipeline->pipeline_id, pipeline->stage_count);
+
+    /* A pipeline usually produces a different output than any single stage */
+    if (pipeline->golden_file[0] != '\0') {
+        if (CacheLoadGoldenFromFile(pipeline->golden_file, ref_output_buffer, output_size_t) !=
+            0) {
+            (void)fprintf(stderr, "Failed to load pipeline golden file: %s\n",
+                          pipeline->golden_file);
+            return -1;
+        }
+    } else {
+        if (BuildPipelineReference(algo, pipeline, config, ctx, ref_output_buffer) != 0) {
+            return -1;
+        }
+        result->ref_time_ms = ctx->ref_time;
+        result->ref_threads = ctx->ref_threads;
+    }
+
+    output_buf =
+        OpenclCreateBuffer(env->context, CL_MEM_READ_WRITE, output_size_t, NULL, "output");
+    if ((output_buf != NULL) &&
+        (OpenclFillBuffer(env, output_buf, OUTPUT_POISON_BYTE, output_size_t) != 0)) {
+        OpenclReleaseMemObject(output_buf, "output buffer");
+        output_buf = NULL;
+    }
+    if (output_buf == NULL) {
+        return -1;
+    }
+
+    if (PipelineCreate(env, algo->id, pipeline, config, ctx->input_buf, output_buf,
+                       &ctx->op_params, &inst) != 0) {
+        (void)fprintf(stderr, "Failed to build pipeline %s\n", pipeline->pipeline_id);
+        OpenclReleaseMemObject(output_buf, "output buffer");
+        return -1;
+    }
+
+    (void)printf("\n=== Running Pipeline ===\n");
+    if (PipelineExecute(env, &inst, &timing) != 0) {
+        (void)fprintf(stderr, "Failed to run pipeline\n");
+        goto cleanup;
+    }
+    for (s = 0; s < timing.launch_count; s++) {
+        if (inst.launch_level[s] >= 0) {
+            (void)printf("Launch %2d %-12s L%d %.3f ms\n", s, inst.launch_cfgs[s]->variant_id,
+                         inst.launch_level[s], timing.launch_ms[s]);
+        } else {
+            (void)printf("Launch %2d %-12s    %.3f ms\n", s, inst.launch_cfgs[s]->variant_id,
+                         timing.launch_ms[s]);
+        }
+    }
+    (void)printf("GPU pipeline time: %.3f ms (end-to-end)\n", timing.total_ms);
+
+    if (OpenclReadbackBuffer(env, output_buf, MEM_STRATEGY_COPY, gpu_output_buffer,
+                             output_size_t, &readback_ms) != 0) {
+        goto cleanup;
+    }
+
+    BuildVerifyOptions(ctx, config, &ctx->op_params, &verify_opts);
+    ApplyTolerance(&pipeline->tolerance, &verify_opts);
+    if (TracedVerify(gpu_output_buffer, ref_output_buffer, &verify_opts, &result->verify) != 0) {
+        (void)fprintf(stderr, "Error: Verification failed to run\n");
+        goto cleanup;
+    }
+
+    (void)printf("\n=== Results ===\n");
+    if (pipeline->golden_file[0] != '\0') {
+        (void)printf("Golden source:    file (%s)\n", pipeline->golden_file);
+    } else {
+        (void)printf("C Reference time: %.3f ms (%d thread(s))\n", ctx->ref_time,
+                     ctx->ref_threads);
+        (void)printf("Speedup:          %.2fx\n", ctx->ref_time / timing.total_ms);
+    }
+    (void)printf("OpenCL GPU time:  %.3f ms\n", timing.total_ms);
+
+    result->gpu_time_ms = timing.total_ms;
+    result->upload_ms = ctx->upload_ms;
+    result->readback_ms = readback_ms;
+    result->passed = result->verify.passed;
+    result->max_error = result->verify.max_error;
+    if (VerifyPipelineOutputs(env, pipeline, config, ctx, &verify_opts, result) != 0) {
+        goto cleanup;
+    }
+
+    /* One verdict over the final output and every output_goldens buffer */
+    (void)printf("Verification:     %s\n", (result->passed != 0) ? "PASSED" : "FAILED");
+    (void)printf("Max error:        %.2f\n", (double)result->verify.max_error);
+    VerifyPrintReport(&verify_opts, &result->verify);
+    status = 0;
+
+    SaveOutputs(ctx, gpu_output_buffer, output_size_t);
+    if (config->verification.dump_diff != 0) {
+        SaveDiffImage(gpu_output_buffer, ref_output_buffer, &verify_opts, &result->verify);
+    }
+
+    if (config->benchmark.enabled != 0) {
+        (void)printf("\n=== Benchmark (%d warmup + %d timed iterations) ===\n",
+                     config->benchmark.warmup_iterations, config->benchmark.iterations);
+        verifier = StartDeviceVerify(env, config, &verify_opts, ref_output_buffer, NULL,
+                                     &device_verifier);
+        if (RunBenchmark(env, NULL, NULL, &inst, &config->benchmark, MEM_STRATEGY_COPY,
+                         ctx->input_buf, ctx->input, img_size_t, output_buf, gpu_output_buffer,
+                         output_size_t, NULL, verifier, NULL, &result->benchmark) == 0) {
+            result->has_benchmark = 1;
+            PrintBenchmark("Pipeline:", &result->benchmark);
+        } else {
+            (void)fprintf(stderr, "Benchmark failed\n");
+        }
+        DeviceVerifyRelease(&device_verifier);
+    }
+
+    {
+        const char* run_dir = CacheGetRunDir();
+        if (run_dir != NULL) {
+            summary_cfg = *inst.launch_cfgs[inst.launch_count - 1];
+            (void)snprintf(summary_cfg.variant_id, sizeof(summary_cfg.variant_id), "%s",
+                           pipeline->pipeline_id);
+            (void)snprintf(summary_cfg.description, sizeof(summary_cfg.description), "%s",
+                           pipeline->description);
+            (void)ResultsWriteRunDir(run_dir, algo, &summary_cfg, config, env->device_name,
+                                     &ctx->op_params, result);
+        }
+    }
+
+cleanup:
+    SaveTrace();
+
+    /* MISRA-C:2023 Rule 22.1: Proper resource management */
+    PipelineRelease(&inst);
+    OpenclReleaseMemObject(output_buf, "output buffer");
+    return status;
+}
+
+/**
+ * @brief Print consolidated comparison table for a multi-variant sweep
+ *
+ * @param[in] config Full configuration
+ * @param[in] ref_time C reference time in ms
+ * @param[in] results Per-variant results
+ * @param[in] count Number of results
+ */
+static void PrintComparisonTable(const Config* config, double ref_time,
+                                 const VariantResult* results, int count) {
+    int i;
+    int golden_file = (config->verification.golden_source == GOLDEN_SOURCE_FILE) ? 1 : 0;
+    int has_batch = 0;
+
+    for (i = 0; i < count; i++) {
+        has_batch |= results[i].has_batch;
+    }
+
+    (void)printf("\n=== Variant Comparison ===\n");
+    if (golden_file != 0) {
+        (void)printf("Golden source: file (%s)\n", config->verification.golden_file);
+    } else {
+        (void)printf("C Reference time: %.3f ms (%d thread(s))\n", ref_time,
+                     (count > 0) ? results[0].ref_threads : 1);
+    }
+    (void)printf("%-10s %12s %10s %10s %8s", "Variant", "GPU (ms)", "Speedup", "Max err",
+                 "Result");
+    if (config->benchmark.enabled != 0) {
+        (void)printf(" %12s %12s", "Median (ms)", "p95 (ms)");
+    }
+    if (config->stream.enabled != 0) {
+        (void)printf(" %10s", "Stream fps");
+    }
+    if (config->multi_device.enabled != 0) {
+        (void)printf(" %10s", "Multi fps");
+    }
+    if (has_batch != 0) {
+        (void)printf(" %12s", "Batch img/s");
+    }
+    (void)printf("\n");
+
+    for (i = 0; i < count; i++) {
+        const VariantResult* r = &results[i];
+
+        if (r->status != 0) {
+            (void)printf("%-10s %12s %10s %10s %8s\n", r->variant_id, "-", "-", "-", "ERROR");
+            continue;
+        }
+
+        (void)printf("%-10s %12.3f", r->variant_id, r->gpu_time_ms);
+        if ((golden_file == 0) && (r->gpu_time_ms > 0.0)) {
+            (void)printf(" %9.2fx", ref_time / r->gpu_time_ms);
+        } else {
+            (void)printf(" %10s", "-");
+        }
+        (void)printf(" %10.2f %8s", (double)r->max_error, (r->passed != 0) ? "PASSED" : "FAILED");
+        if (config->benchmark.enabled != 0) {
+            if (r->has_benchmark != 0) {
+                (void)printf(" %12.3f %12.3f", r->benchmark.kernel.median_ms,
+                             r->benchmark.kernel.p95_ms);
+            } else {
+                (void)printf(" %12s %12s", "-", "-");
+            }
+        }
+        if (config->stream.enabled != 0) {
+            if (r->has_stream != 0) {
+                (void)printf(" %10.2f", r->stream_fps);
+            } else {
+                (void)printf(" %10s", "-");
+            }
+        }
+        if (config->multi_device.enabled != 0) {
+            if (r->has_multi_device != 0) {
+                (void)printf(" %10.2f", r->multi_device_fps);
+            } else {
+                (void)printf(" %10s", "-");
+            }
+        }
+        if (has_batch != 0) {
+            /* Batched rate when the kernel supports it, else the per-image rate */
+            if (r->has_batch != 0) {
+                (void)printf(" %12.1f",
+                             (r->batch_ips > 0.0) ? r->batch_ips : r->batch_loop_ips);
+            } else {
+                (void)printf(" %12s", "-");
+            }
+        }
+        (void)printf("\n");
+    }
+}
+
+/**
+ * @brief Print the speed/accuracy tradeoff of reduced-precision variants
+ *
+ * Each fp16 or int variant is listed with its speedup and max error against
+ * its fp32 baseline (when that ran earlier in the sweep) and against the C
+ * reference or golden.
+ *
+ * @param[in] config Full configuration
+ * @param[in] ref_time C reference time in ms
+ * @param[in] results Per-variant results
+ * @param[in] count Number of results
+ */
+static void PrintPrecisionReport(const Config* config, double ref_time,
+                                 const VariantResult* results, int count) {
+    int i;
+    int golden_file = (config->verification.golden_source == GOLDEN_SOURCE_FILE) ? 1 : 0;
+
+    (void)printf("\n=== Precision Tradeoff ===\n");
+    (void)printf("%-10s %-10s %-10s %10s %9s %9s %10s %10s %8s\n", "Variant", "Precision",
+                 "Baseline", "Time (ms)", "vs base", "vs C ref", "Max err", "Err vs base",
+                 "Result");
+    for (i = 0; i < count; i++) {
+        const VariantResult* r = &results[i];
+        double time_ms = VariantTimeMs(r);
+
+        if ((r->status != 0) || (r->precision == (int)KERNEL_PRECISION_FP32)) {
+            continue;
+        }
+        (void)printf("%-10s %-10s %-10s %10.3f", r->variant_id,
+                     PrecisionName(r->precision, r->precision_fallback),
+                     (r->has_baseline != 0) ? r->baseline_id : "-", time_ms);
+        if (r->baseline_speedup > 0.0) {
+            (void)printf(" %8.2fx", r->baseline_speedup);
+        } else {
+            (void)printf(" %9s", "-");
+        }
+        if ((golden_file == 0) && (time_ms > 0.0)) {
+            (void)printf(" %8.2fx", ref_time / time_ms);
+        } else {
+            (void)printf(" %9s", "-");
+        }
+        (void)printf(" %10.4g", (double)r->max_error);
+        if (r->has_baseline != 0) {
+            (void)printf(" %10.4g", (double)r->baseline_verify.max_error);
+        } else {
+            (void)printf(" %10s", "-");
+        }
+        (void)printf(" %8s\n", (r->passed != 0) ? "PASSED" : "FAILED");
+    }
+}
+
+/* Index of the variant @p variant_id among the first @p count selected ones, -1 if absent */
+static int FindSelectedVariant(KernelConfig* const variants[], int count, const char* variant_id) {
+    int i;
+
+    for (i = 0; i < count; i++) {
+        if (strcmp(variants[i]->variant_id, variant_id) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int RunAlgorithmVariants(const Algorithm* algo, KernelConfig* const variants[], int variant_count,
+                         const Config* config, OpenCLEnv* env, unsigned char* gpu_output_buffer,
+                         unsigned char* ref_output_buffer, VariantResult* results) {
+    /* Large context (custom buffer descriptors) kept off the stack */
+    static RunContext ctx;
+    /* Outputs of fp32 variants other selected variants name as "baseline" */
+    static MappedBuffer baseline_outputs[MAX_KERNEL_CONFIGS];
+    const unsigned char* baseline_output;
+    const VariantResult* baseline_result;
+    int has_reduced = 0;
+    int base;
+    int i;
+    int j;
+    int failures = 0;
+
+    if ((algo == NULL) || (variants == NULL) || (variant_count <= 0) || (config == NULL) ||
+        (env == NULL) || (results == NULL)) {
+        (void)fprintf(stderr, "Error: NULL parameter in RunAlgorithmVariants\n");
+        return -1;
+    }
+
+    if ((gpu_output_buffer == NULL) || (ref_output_buffer == NULL)) {
+        (void)fprintf(stderr, "Error: NULL output buffers in RunAlgorithmVariants\n");
+        return -1;
+    }
+
+    (void)memset(&ctx, 0, sizeof(ctx));
+    for (i = 0; i < variant_count; i++) {
+        (void)memset(&results[i], 0, sizeof(results[i]));
+        (void)strncpy(results[i].variant_id, variants[i]->variant_id,
+                      sizeof(results[i].variant_id) - 1U);
+        results[i].status = -1;
+    }
+
+    /* The first variant's trace also holds the shared stage */
+    TraceReset();
+    TraceEnable(config->results.write_trace);
+
+    /* Shared stage: input, custom data, scalars and reference run once */
+    if (PrepareRunContext(algo, config, ref_output_buffer, &ctx) != 0) {
+        ReleaseSharedBuffers(config, &ctx);
+        return -1;
+    }
+    for (i = 0; i < variant_count; i++) {
+        results[i].ref_time_ms = ctx.ref_time;
+        results[i].ref_threads = ctx.ref_threads;
+    }
+
+    if (CreateSharedBuffers(env, config, &ctx) != 0) {
+        ReleaseSharedBuffers(config, &ctx);
+        return -1;
+    }
+
+    /* Per-variant stage: build, run, verify (failures do not stop the sweep) */
+    for (i = 0; i < variant_count; i++) {
+        baseline_output = NULL;
+        baseline_result = NULL;
+        if (variants[i]->precision != KERNEL_PRECISION_FP32) {
+            has_reduced = 1;
+            base = (variants[i]->baseline[0] != '\0')
+                       ? FindSelectedVariant(variants, i, variants[i]->baseline)
+                       : -1;
+            if ((base >= 0) && (baseline_outputs[base].data != NULL)) {
+                baseline_output = baseline_outputs[base].data;
+                baseline_result = &results[base];
+            } else if (variants[i]->baseline[0] != '\0') {
+                (void)printf("Note: baseline %s of %s did not run before it, not compared\n",
+                             variants[i]->baseline, variants[i]->variant_id);
+            }
+        }
+
+        results[i].status = RunVariant(algo, variants[i], config, env, &ctx, gpu_output_buffer,
+                                       ref_output_buffer, baseline_output, baseline_result,
+                                       &results[i]);
+        if (results[i].status != 0) {
+            failures++;
+            continue;
+        }
+
+        /* Keep the output if a later variant is compared with it */
+        for (j = i + 1; j < variant_count; j++) {
+            if (strcmp(variants[j]->baseline, variants[i]->variant_id) == 0) {
+                if (MappedBufferAlloc((size_t)ctx.output_size, &baseline_outputs[i]) == 0) {
+                    (void)memcpy(baseline_outputs[i].data, gpu_output_buffer,
+                                 (size_t)ctx.output_size);
+                }
+                break;
+            }
+        }
+    }
+
+    if (variant_count > 1) {
+        PrintComparisonTable(config, ctx.ref_time, results, variant_count);
+    }
+    if (has_reduced != 0) {
+        PrintPrecisionReport(config, ctx.ref_time, results, variant_count);
+    }
+
+    for (i = 0; i < MAX_KERNEL_CONFIGS; i++) {
+        MappedBufferRelease(&baseline_outputs[i]);
+    }
+    MultiDeviceClose(&multi_devices);
+    ReleaseSharedBuffers(config, &ctx);
+    return (failures == 0) ? 0 : -1;
+}
+
+int RunAlgorithmPipeline(const Algorithm* algo, const PipelineConfig* pipeline,
+                         const Config* config, OpenCLEnv* env, unsigned char* gpu_output_buffer,
+                         unsigned char* ref_output_buffer, VariantResult* result) {
+    /* Large context (custom buffer descriptors) kept off the stack */
+    static RunContext ctx;
+
+    if ((algo == NULL) || (pipeline == NULL) || (config == NULL) || (env == NULL) ||
+        (gpu_output_buffer == NULL) || (ref_output_buffer == NULL) || (result == NULL)) {
+        (void)fprintf(stderr, "Error: NULL parameter in RunAlgorithmPipeline\n");
+        return -1;
+    }
+
+    (void)memset(&ctx, 0, sizeof(ctx));
+    (void)memset(result, 0, sizeof(*result));
+    (void)strncpy(result->variant_id, pipeline->pipeline_id, sizeof(result->variant_id) - 1U);
+    result->status = -1;
+
+    TraceReset();
+    TraceEnable(config->results.write_trace);
+
+    if (PrepareRunContext(algo, config, ref_output_buffer, &ctx) != 0) {
+        ReleaseSharedBuffers(config, &ctx);
+        return -1;
+    }
+    result->ref_time_ms = ctx.ref_time;
+    result->ref_threads = ctx.ref_threads;
+
+    if (CreateSharedBuffers(env, config, &ctx) != 0) {
+        ReleaseSharedBuffers(config, &ctx);
+        return -1;
+    }
+
+    result->status = RunPipeline(algo, pipeline, config, env, &ctx, gpu_output_buffer,
+                                 ref_output_buffer, result);
+
+    ReleaseSharedBuffers(config, &ctx);
+    return result->status;
+}
+
+void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const Config* config,
+                  OpenCLEnv* env, unsigned char* gpu_output_buffer,
+                  unsigned char* ref_output_buffer) {
+    KernelConfig* variants[1];
+    VariantResult result;
+
+    if (kernel_cfg == NULL) {
+        (void)fprintf(stderr, "Error: NULL parameter in RunAlgorithm\n");
+        return;
+    }
 
-cleanup_early:
-    /* Early cleanup before OpenCL resources were created */
-    /* Note: host_data points to static buffer pool, no free needed */
-    /* NOTE: input points to static buffer from ReadImage(), don't free it */
+    variants[0] = (KernelConfig*)kernel_cfg;
+    (void)RunAlgorithmVariants(algo, variants, 1, config, env, gpu_output_buffer,
+                               ref_output_buffer, &result);
 }
@@ -1,91 +1,177 @@
 /**
  * @file android_runner.c
- * @brief Android execution pipeline implementation (stub)
+ * @brief Android execution pipeline implementation
  *
- * This is a placeholder implementation for the Android runner.
- * The full implementation will:
- * - Load pre-compiled program binary from opencl-study
- * - Use cl_extension APIs for buffer management
- * - Execute kernels on Android GPU
+ * Lean runtime: parses the variant configuration, initializes OpenCL,
+ * creates the kernel from a prebuilt program binary (working_set.h) and
+ * dispatches it once through the cl_extension host path. Every startup
+ * phase is timed, and the total from runner entry to the first output can
+ * be held to a cold-start budget (--budget-ms).
  */
 
+#include "android_runner.h"
+
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 
-#include "android_runner.h"
-#include "utils/config.h"
+#include "core/working_set.h"
+#include "utils/benchmark.h"
+#include "utils/image_io.h"
+#include "utils/safe_ops.h"
 
-/* Configuration file paths */
-#define CONFIG_INPUTS_PATH "config/inputs.json"
-#define CONFIG_OUTPUTS_PATH "config/outputs.json"
-#define MAX_PATH_LENGTH 512
+/**
+ * @brief Wall-clock of the startup phases (milliseconds)
+ */
+typedef struct {
+    double init_ms;           /**< OpenclInit() */
+    double config_ms;         /**< Config parsing and buffer allocation */
+    double binary_load_ms;    /**< Program binary load and kernel creation */
+    double input_ms;          /**< Input image read */
+    double first_dispatch_ms; /**< First run: upload, dispatch and readback */
+    double total_ms;          /**< Runner entry to first output */
+} StartupTiming;
 
-int AndroidRunner(int argc, char** argv) {
-    Config config;
-    int parse_result;
-    char config_path[MAX_PATH_LENGTH];
-    const char* config_input;
-    const char* variant_selector;
-
-    (void)printf("=== Android Runner (Stub) ===\n");
-    (void)printf("This is a placeholder implementation.\n\n");
-
-    /* Check command line arguments */
-    if (argc != 3) {
-        (void)fprintf(stderr, "Usage: %s <algorithm> <variant>\n", argv[0]);
-        return 1;
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static OpenCLEnv android_env;
+static WorkingSet android_ws;
+
+static void PrintUsage(const char* prog) {
+    (void)fprintf(stderr,
+                  "Usage: %s <algorithm> <variant> [--binary PATH] [--output PATH] "
+                  "[--budget-ms MS]\n",
+                  prog);
+    (void)fprintf(stderr, "  --binary PATH   Program binary\n");
+    (void)fprintf(stderr, "                  (default: %s/<op_id>/cache/<variant_id>.bin)\n",
+                  WORKING_SET_BINARY_DIR);
+    (void)fprintf(stderr, "  --output PATH   Write the output image\n");
+    (void)fprintf(stderr, "  --budget-ms MS  Fail if startup to first output exceeds MS\n");
+}
+
+static void PrintStartupReport(const WorkingSet* ws, const StartupTiming* startup,
+                               const WorkingSetTiming* first, double budget_ms) {
+    (void)printf("\n=== Startup (%s %s) ===\n", ws->algorithm_id, ws->kernel_cfg.variant_id);
+    (void)printf("  Binary:          %s\n", ws->binary_path);
+    (void)printf("  OpenCL init:     %8.3f ms\n", startup->init_ms);
+    (void)printf("  Config/buffers:  %8.3f ms\n", startup->config_ms);
+    (void)printf("  Binary load:     %8.3f ms\n", startup->binary_load_ms);
+    (void)printf("  Input read:      %8.3f ms\n", startup->input_ms);
+    (void)printf("  First dispatch:  %8.3f ms (upload %.3f, kernel %.3f, readback %.3f)\n",
+                 startup->first_dispatch_ms, first->upload_ms, first->kernel_ms,
+                 first->readback_ms);
+    (void)printf("  Total:           %8.3f ms", startup->total_ms);
+    if (budget_ms > 0.0) {
+        (void)printf(" (budget %.3f ms: %s)", budget_ms,
+                     (startup->total_ms <= budget_ms) ? "OK" : "EXCEEDED");
     }
+    (void)printf("\n");
+}
 
-    config_input = argv[1];
-    variant_selector = argv[2];
+/* First dispatch of an open working set; returns 0 on success */
+static int RunFirstDispatch(WorkingSet* ws, const char* output_path, StartupTiming* startup,
+                            WorkingSetTiming* first) {
+    const unsigned char* input;
+    double start_ms = BenchmarkNowMs();
+    int result = 0;
 
-    /* Resolve algorithm name to config path */
-    if (ResolveConfigPath(config_input, config_path, sizeof(config_path)) != 0) {
-        (void)fprintf(stderr, "Failed to resolve config path: %s\n", config_input);
-        return 1;
+    input = ReadImage(ws->input_path, ws->input_size);
+    startup->input_ms = BenchmarkNowMs() - start_ms;
+    if (input == NULL) {
+        (void)fprintf(stderr, "Failed to read input %s\n", ws->input_path);
+        return -1;
     }
 
-    /* Parse configuration files */
-    parse_result = ParseInputsConfig(CONFIG_INPUTS_PATH, &config);
-    if (parse_result != 0) {
-        (void)fprintf(stderr, "Failed to parse %s\n", CONFIG_INPUTS_PATH);
+    if (WorkingSetRun(&android_env, ws, input, NULL, first) != 0) {
+        (void)fprintf(stderr, "First dispatch failed\n");
+        result = -1;
+    }
+    startup->first_dispatch_ms = first->total_ms;
+    ReleaseImage();
+
+    if ((result == 0) && (output_path != NULL) &&
+        (WriteImage(output_path, ws->host_output.data, ws->output_size) != 0)) {
+        (void)fprintf(stderr, "Failed to write output %s\n", output_path);
+        result = -1;
+    }
+    return result;
+}
+
+int AndroidRunner(int argc, char** argv) {
+    double start_ms = BenchmarkNowMs();
+    double phase_ms;
+    const char* binary_path = NULL;
+    const char* output_path = NULL;
+    double budget_ms = 0.0;
+    long temp_long;
+    StartupTiming startup;
+    WorkingSetTiming first;
+    int result;
+    int i;
+
+    if (argc < 3) {
+        PrintUsage(argv[0]);
         return 1;
     }
+    for (i = 3; i < argc; i++) {
+        if ((strcmp(argv[i], "--binary") == 0) && ((i + 1) < argc)) {
+            i++;
+            binary_path = argv[i];
+        } else if ((strcmp(argv[i], "--output") == 0) && ((i + 1) < argc)) {
+            i++;
+            output_path = argv[i];
+        } else if ((strcmp(argv[i], "--budget-ms") == 0) && ((i + 1) < argc)) {
+            i++;
+            if (!SafeStrtol(argv[i], &temp_long) || (temp_long <= 0)) {
+                (void)fprintf(stderr, "Error: --budget-ms requires a positive integer\n");
+                return 1;
+            }
+            budget_ms = (double)temp_long;
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    (void)memset(&startup, 0, sizeof(startup));
+    (void)memset(&first, 0, sizeof(first));
 
-    parse_result = ParseOutputsConfig(CONFIG_OUTPUTS_PATH, &config);
-    if (parse_result != 0) {
-        (void)fprintf(stderr, "Failed to parse %s\n", CONFIG_OUTPUTS_PATH);
+    /* 1. OpenCL platform, device, context, queue and extension context */
+    phase_ms = BenchmarkNowMs();
+    if (OpenclInit(&android_env) != 0) {
+        (void)fprintf(stderr, "Failed to initialize OpenCL\n");
         return 1;
     }
+    startup.init_ms = BenchmarkNowMs() - phase_ms;
 
-    parse_result = ParseConfig(config_path, &config);
-    if (parse_result != 0) {
-        (void)fprintf(stderr, "Failed to parse %s\n", config_path);
+    /* 2. Variant, buffers and kernel from the prebuilt binary (no source, no C reference) */
+    result = WorkingSetOpenBinary(&android_env, argv[1], argv[2], binary_path, &android_ws);
+    if ((result == 0) && (android_ws.kernel_cfg.host_type == HOST_TYPE_STANDARD)) {
+        (void)fprintf(stderr,
+                      "Variant %s uses the standard host type; the Android runtime "
+                      "dispatches through cl_extension\n",
+                      android_ws.kernel_cfg.variant_id);
+        result = -1;
+    }
+    if (result != 0) {
+        (void)fprintf(stderr, "Failed to open %s variant %s from its program binary\n", argv[1],
+                      argv[2]);
+        WorkingSetClose(&android_ws);
+        OpenclCleanup(&android_env);
         return 1;
     }
+    startup.binary_load_ms = android_ws.program_ms;
+    startup.config_ms = android_ws.setup_ms - android_ws.program_ms;
+
+    /* 3. First dispatch */
+    result = RunFirstDispatch(&android_ws, output_path, &startup, &first);
+    startup.total_ms = BenchmarkNowMs() - start_ms;
+    if (result == 0) {
+        PrintStartupReport(&android_ws, &startup, &first, budget_ms);
+        if ((budget_ms > 0.0) && (startup.total_ms > budget_ms)) {
+            result = -1;
+        }
+    }
 
-    /* Display parsed configuration */
-    (void)printf("Configuration loaded successfully:\n");
-    (void)printf("  Algorithm: %s\n", config.op_id);
-    (void)printf("  Variant:   %s\n", variant_selector);
-    (void)printf("  Config:    %s\n", config_path);
-
-    /* TODO: Full Android implementation will:
-     * 1. Load pre-compiled program binary from cache
-     * 2. Initialize OpenCL using cl_extension APIs
-     * 3. Create buffers for input/output
-     * 4. Execute kernel
-     * 5. Read back results
-     */
-
-    (void)printf("\n[Android runner not yet implemented]\n");
-    (void)printf("Expected workflow:\n");
-    (void)printf("  1. Load program binary from: test_data/%s/cache/program.bin\n",
-                 config.op_id);
-    (void)printf("  2. Create OpenCL context via cl_extension\n");
-    (void)printf("  3. Execute kernel with variant %s\n", variant_selector);
-    (void)printf("  4. Output results\n");
-
-    return 0;
+    /* MISRA-C:2023 Rule 22.1: Proper resource management */
+    WorkingSetClose(&android_ws);
+    OpenclCleanup(&android_env);
+    return (result == 0) ? 0 : 1;
 }
@@ -3,29 +3,30 @@
  * @brief Android execution pipeline interface
  *
  * This runner is designed for Android deployment where:
- * - Program binaries are pre-compiled (by desktop opencl-study)
- * - No C reference implementation needed
- * - Uses cl_extension APIs for buffer management
+ * - Program binaries are pre-compiled (opencl_precompile --export on the device)
+ * - No C reference implementation needed (not linked in BUILD_ANDROID builds)
+ * - Uses cl_extension APIs for buffer management and dispatch
  */
 
 #ifndef ANDROID_RUNNER_H
 #define ANDROID_RUNNER_H
 
-#include "utils/config.h"
-
 /**
  * @brief Run algorithm on Android using pre-compiled program binary
  *
  * Unlike the desktop algorithm_runner which compiles kernels from source,
  * this runner:
- * 1. Loads pre-compiled program binary
- * 2. Sets up buffers using cl_extension API
- * 3. Executes kernel
- * 4. Returns results
+ * 1. Initializes OpenCL
+ * 2. Loads the pre-compiled program binary (no source, no build key)
+ * 3. Sets up buffers using cl_extension API
+ * 4. Executes the kernel once and reads back the result
+ * 5. Reports the time of each startup phase, optionally against a budget
+ *
+ * Usage: <algorithm> <variant> [--binary PATH] [--output PATH] [--budget-ms MS]
  *
  * @param[in] argc Argument count from main()
  * @param[in] argv Argument vector from main()
- * @return 0 on success, non-zero on error
+ * @return 0 on success, non-zero on error or when the budget is exceeded
  */
 int AndroidRunner(int argc, char** argv);
 
@@ -0,0 +1,185 @@
+/**
+ * @file ref_thread_pool.c
+ * @brief Thread pool running C reference implementations in horizontal bands
+ */
+
+#include "ref_thread_pool.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+/** Current banded job (guarded by pool_mutex) */
+typedef struct {
+    const Algorithm* algo;  /**< Algorithm being run */
+    const OpParams* params; /**< Shared parameters */
+    int rows;               /**< Output rows in the image */
+    int band_rows;          /**< Rows per band (last band may be shorter) */
+    int band_count;         /**< Number of bands */
+    int next_band;          /**< Next band to hand out */
+    int bands_done;         /**< Bands finished */
+    int workers;            /**< Worker threads allowed to take bands */
+} RefJob;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static pthread_t workers[MAX_REF_THREADS];
+static unsigned int worker_start_generation[MAX_REF_THREADS];
+static int worker_count = 0;
+static RefJob job;
+static unsigned int job_generation = 0U;
+static int shutting_down = 0;
+
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+
+/* Run bands of the current job until none is left (pool_mutex held on entry and exit) */
+static void RunBands(void) {
+    int band;
+    int row_begin;
+    int row_end;
+
+    while (job.next_band < job.band_count) {
+        band = job.next_band;
+        job.next_band++;
+        (void)pthread_mutex_unlock(&pool_mutex);
+
+        row_begin = band * job.band_rows;
+        row_end = row_begin + job.band_rows;
+        if (row_end > job.rows) {
+            row_end = job.rows;
+        }
+        job.algo->reference_rows_impl(job.params, row_begin, row_end);
+
+        (void)pthread_mutex_lock(&pool_mutex);
+        job.bands_done++;
+        if (job.bands_done == job.band_count) {
+            (void)pthread_cond_broadcast(&done_cond);
+        }
+    }
+}
+
+static void* RefWorker(void* arg) {
+    int index = (int)(intptr_t)arg;
+    unsigned int seen;
+
+    (void)pthread_mutex_lock(&pool_mutex);
+    /* Generation before the job that started this worker, so it joins that job */
+    seen = worker_start_generation[index];
+    for (;;) {
+        while ((shutting_down == 0) && (job_generation == seen)) {
+            (void)pthread_cond_wait(&job_cond, &pool_mutex);
+        }
+        if (shutting_down != 0) {
+            break;
+        }
+        seen = job_generation;
+        /* Workers above the job's thread count sit this one out */
+        if (index < job.workers) {
+            RunBands();
+        }
+    }
+    (void)pthread_mutex_unlock(&pool_mutex);
+    return NULL;
+}
+
+int RefPoolResolveThreads(int requested) {
+    long online;
+
+    if (requested <= 0) {
+        online = sysconf(_SC_NPROCESSORS_ONLN);
+        requested = (online > 0) ? (int)((online > MAX_REF_THREADS) ? MAX_REF_THREADS : online)
+                                 : 1;
+    }
+    return (requested > MAX_REF_THREADS) ? MAX_REF_THREADS : requested;
+}
+
+int RefPoolRun(const Algorithm* algo, const OpParams* params, int threads, int* bands) {
+    int rows;
+    int min_band_rows;
+    int band_count;
+
+    if ((algo == NULL) || (params == NULL) || (algo->reference_impl == NULL)) {
+        return -1;
+    }
+
+    rows = params->src_height;
+    min_band_rows = algo->halo_rows * 4;
+    if (min_band_rows < REF_MIN_BAND_ROWS) {
+        min_band_rows = REF_MIN_BAND_ROWS;
+    }
+    band_count = (rows > 0) ? (rows / min_band_rows) : 0;
+    if ((threads > 1) && (band_count > (threads * REF_BANDS_PER_THREAD))) {
+        band_count = threads * REF_BANDS_PER_THREAD;
+    }
+
+    if ((algo->reference_rows_impl == NULL) || (threads <= 1) || (band_count <= 1)) {
+        algo->reference_impl(params);
+        if (bands != NULL) {
+            *bands = 1;
+        }
+        return 1;
+    }
+    if (threads > band_count) {
+        threads = band_count;
+    }
+
+    /* Grow the pool to threads - 1 workers (the caller is the last thread) */
+    (void)pthread_mutex_lock(&pool_mutex);
+    while (worker_count < (threads - 1)) {
+        worker_start_generation[worker_count] = job_generation;
+        if (pthread_create(&workers[worker_count], NULL, RefWorker,
+                           (void*)(intptr_t)worker_count) != 0) {
+            (void)fprintf(stderr, "Warning: Failed to start reference thread %d\n",
+                          worker_count + 1);
+            break;
+        }
+        worker_count++;
+    }
+    if (threads > (worker_count + 1)) {
+        threads = worker_count + 1;
+    }
+
+    job.algo = algo;
+    job.params = params;
+    job.rows = rows;
+    job.band_rows = (rows + band_count - 1) / band_count;
+    job.band_count = (rows + job.band_rows - 1) / job.band_rows;
+    job.next_band = 0;
+    job.bands_done = 0;
+    job.workers = threads - 1;
+    job_generation++;
+    (void)pthread_cond_broadcast(&job_cond);
+
+    RunBands();
+    while (job.bands_done < job.band_count) {
+        (void)pthread_cond_wait(&done_cond, &pool_mutex);
+    }
+    if (bands != NULL) {
+        *bands = job.band_count;
+    }
+    (void)pthread_mutex_unlock(&pool_mutex);
+
+    return threads;
+}
+
+void RefPoolShutdown(void) {
+    int i;
+    int count;
+
+    (void)pthread_mutex_lock(&pool_mutex);
+    shutting_down = 1;
+    count = worker_count;
+    (void)pthread_cond_broadcast(&job_cond);
+    (void)pthread_mutex_unlock(&pool_mutex);
+
+    for (i = 0; i < count; i++) {
+        (void)pthread_join(workers[i], NULL);
+    }
+
+    (void)pthread_mutex_lock(&pool_mutex);
+    worker_count = 0;
+    shutting_down = 0;
+    (void)pthread_mutex_unlock(&pool_mutex);
+}
@@ -0,0 +1,59 @@
+/**
+ * @file ref_thread_pool.h
+ * @brief Thread pool running C reference implementations in horizontal bands
+ *
+ * Splits the output image into horizontal bands and runs the algorithm's
+ * row-range entry point (Algorithm::reference_rows_impl) on them from a
+ * small pool of persistent worker threads; the calling thread works too.
+ * Bands read their halo rows straight from the shared input image, so no
+ * data is copied. Algorithms without a row-range entry point run
+ * single-threaded through reference_impl.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Static worker table, no dynamic memory allocation
+ * - Rule 17.7: All functions return status for error checking
+ */
+
+#pragma once
+
+#include "op_interface.h"
+
+/** Maximum number of C reference threads (including the calling thread) */
+#define MAX_REF_THREADS 64
+
+/** Minimum output rows per band */
+#define REF_MIN_BAND_ROWS 16
+
+/** Bands queued per thread, so uneven rows still balance across threads */
+#define REF_BANDS_PER_THREAD 4
+
+/**
+ * @brief Resolve a configured thread count
+ *
+ * @param[in] requested Configured count (0 = one per online CPU)
+ * @return Thread count in [1, MAX_REF_THREADS]
+ */
+int RefPoolResolveThreads(int requested);
+
+/**
+ * @brief Run a C reference implementation, banded across threads
+ *
+ * Band height is at least REF_MIN_BAND_ROWS and four times the algorithm's
+ * halo_rows, so small images (or threads <= 1) run as a single call.
+ * Returns when every band has finished.
+ *
+ * @param[in] algo Algorithm to execute
+ * @param[in] params Operation parameters (shared read-only by all bands)
+ * @param[in] threads Thread count from RefPoolResolveThreads()
+ * @param[out] bands Number of bands executed (may be NULL)
+ * @return Threads actually used (>= 1), or -1 on error
+ */
+int RefPoolRun(const Algorithm* algo, const OpParams* params, int threads, int* bands);
+
+/**
+ * @brief Stop and join all worker threads
+ *
+ * Safe to call when the pool was never started. A later RefPoolRun()
+ * starts new workers.
+ */
+void RefPoolShutdown(void);
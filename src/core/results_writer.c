@@ -0,0 +1,391 @@
+/**
+ * @file results_writer.c
+ * @brief Machine-readable run results (JSON/CSV) in the cache run directory
+ */
+
+#include "results_writer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "platform/cache_manager.h"
+#include "platform/opencl_utils.h"
+#include "utils/config.h"
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation for output text */
+#define MAX_RESULTS_JSON_SIZE (16 * 1024)
+static char results_json_buffer[MAX_RESULTS_JSON_SIZE];
+
+/* Add a work size array (work_dim entries) to a JSON object */
+static void AddWorkSizeArray(cJSON* object, const char* name, const size_t* sizes, int work_dim) {
+    cJSON* array = cJSON_AddArrayToObject(object, name);
+    int i;
+
+    if (array == NULL) {
+        return;
+    }
+    for (i = 0; i < work_dim; i++) {
+        (void)cJSON_AddItemToArray(array, cJSON_CreateNumber((double)sizes[i]));
+    }
+}
+
+/* Add a BenchmarkStats object to a JSON object */
+static void AddStatsObject(cJSON* object, const char* name, const BenchmarkStats* stats) {
+    cJSON* item = cJSON_AddObjectToObject(object, name);
+
+    if (item == NULL) {
+        return;
+    }
+    (void)cJSON_AddNumberToObject(item, "min_ms", stats->min_ms);
+    (void)cJSON_AddNumberToObject(item, "max_ms", stats->max_ms);
+    (void)cJSON_AddNumberToObject(item, "mean_ms", stats->mean_ms);
+    (void)cJSON_AddNumberToObject(item, "median_ms", stats->median_ms);
+    (void)cJSON_AddNumberToObject(item, "p95_ms", stats->p95_ms);
+    (void)cJSON_AddNumberToObject(item, "p99_ms", stats->p99_ms);
+    (void)cJSON_AddNumberToObject(item, "stddev_ms", stats->stddev_ms);
+}
+
+/* Format work sizes as "1920x1088" (CSV-safe, no commas) */
+static void FormatWorkSize(char* out, size_t out_size, const size_t* sizes, int work_dim) {
+    size_t used = 0U;
+    int i;
+    int written;
+
+    out[0] = '\0';
+    for (i = 0; i < work_dim; i++) {
+        written = snprintf(out + used, out_size - used, (i == 0) ? "%zu" : "x%zu", sizes[i]);
+        if ((written < 0) || ((size_t)written >= (out_size - used))) {
+            return;
+        }
+        used += (size_t)written;
+    }
+}
+
+static int WriteResultsJson(const char* path, const Algorithm* algo, const KernelConfig* kernel_cfg,
+                            const Config* config, const char* device_name, const OpParams* params,
+                            const VariantResult* result) {
+    cJSON* root;
+    cJSON* item;
+    FILE* fp;
+    int status = -1;
+
+    root = cJSON_CreateObject();
+    if (root == NULL) {
+        return -1;
+    }
+
+    (void)cJSON_AddStringToObject(root, "algorithm", algo->id);
+    (void)cJSON_AddStringToObject(root, "variant", kernel_cfg->variant_id);
+    (void)cJSON_AddStringToObject(root, "device", device_name);
+    (void)cJSON_AddStringToObject(root, "kernel_file", kernel_cfg->kernel_file);
+    (void)cJSON_AddStringToObject(root, "kernel_function", kernel_cfg->kernel_function);
+    (void)cJSON_AddStringToObject(
+        root, "host_type",
+        (kernel_cfg->host_type == HOST_TYPE_STANDARD) ? "standard" : "cl_extension");
+    (void)cJSON_AddStringToObject(root, "memory_strategy",
+                                  OpenclMemoryStrategyName(kernel_cfg->memory_strategy));
+    (void)cJSON_AddNumberToObject(root, "work_dim", (double)kernel_cfg->work_dim);
+    AddWorkSizeArray(root, "global_work_size", kernel_cfg->global_work_size, kernel_cfg->work_dim);
+    AddWorkSizeArray(root, "local_work_size", kernel_cfg->local_work_size, kernel_cfg->work_dim);
+    (void)cJSON_AddBoolToObject(root, "local_work_size_auto",
+                                (kernel_cfg->local_work_size_auto != 0) ? 1 : 0);
+
+    /* Reduced-precision variants: mode and tradeoff against the fp32 baseline */
+    if (kernel_cfg->precision != KERNEL_PRECISION_FP32) {
+        item = cJSON_AddObjectToObject(root, "precision");
+        if (item != NULL) {
+            (void)cJSON_AddStringToObject(
+                item, "mode", (kernel_cfg->precision == KERNEL_PRECISION_FP16) ? "fp16" : "int");
+            (void)cJSON_AddBoolToObject(item, "fp32_fallback",
+                                        (kernel_cfg->precision_fallback != 0) ? 1 : 0);
+            if (result->has_baseline != 0) {
+                (void)cJSON_AddStringToObject(item, "baseline", result->baseline_id);
+                (void)cJSON_AddNumberToObject(item, "speedup_vs_baseline",
+                                              result->baseline_speedup);
+                (void)cJSON_AddNumberToObject(item, "max_error_vs_baseline",
+                                              (double)result->baseline_verify.max_error);
+                (void)cJSON_AddNumberToObject(item, "mismatches_vs_baseline",
+                                              (double)result->baseline_verify.errors);
+            }
+        }
+    }
+
+    item = cJSON_AddObjectToObject(root, "image");
+    if (item != NULL) {
+        (void)cJSON_AddNumberToObject(item, "width", (double)params->dst_width);
+        (void)cJSON_AddNumberToObject(item, "height", (double)params->dst_height);
+        (void)cJSON_AddNumberToObject(item, "channels", (double)params->dst_channels);
+    }
+
+    item = cJSON_AddObjectToObject(root, "timings_ms");
+    if (item != NULL) {
+        (void)cJSON_AddNumberToObject(item, "reference", result->ref_time_ms);
+        (void)cJSON_AddNumberToObject(item, "reference_threads", (double)result->ref_threads);
+        (void)cJSON_AddNumberToObject(item, "kernel", result->gpu_time_ms);
+        (void)cJSON_AddNumberToObject(item, "upload", result->upload_ms);
+        (void)cJSON_AddNumberToObject(item, "readback", result->readback_ms);
+    }
+
+    item = cJSON_AddObjectToObject(root, "verification");
+    if (item != NULL) {
+        (void)cJSON_AddBoolToObject(item, "passed", (result->passed != 0) ? 1 : 0);
+        (void)cJSON_AddNumberToObject(item, "max_error", (double)result->max_error);
+        (void)cJSON_AddNumberToObject(item, "tolerance", (double)config->verification.tolerance);
+        (void)cJSON_AddNumberToObject(item, "error_rate_threshold",
+                                      (double)config->verification.error_rate_threshold);
+        (void)cJSON_AddStringToObject(
+            item, "golden_source",
+            (config->verification.golden_source == GOLDEN_SOURCE_FILE) ? "file" : "c_ref");
+        (void)cJSON_AddNumberToObject(item, "mismatches", (double)result->verify.errors);
+        (void)cJSON_AddNumberToObject(item, "elements", (double)result->verify.total_elements);
+        (void)cJSON_AddBoolToObject(item, "early_exit", (result->verify.early_exited != 0) ? 1 : 0);
+        if (result->verify.worst_x >= 0) {
+            cJSON* worst = cJSON_AddObjectToObject(item, "worst_pixel");
+            if (worst != NULL) {
+                (void)cJSON_AddNumberToObject(worst, "x", (double)result->verify.worst_x);
+                (void)cJSON_AddNumberToObject(worst, "y", (double)result->verify.worst_y);
+                (void)cJSON_AddNumberToObject(worst, "channel",
+                                              (double)result->verify.worst_channel);
+                (void)cJSON_AddNumberToObject(worst, "gpu", (double)result->verify.worst_gpu);
+                (void)cJSON_AddNumberToObject(worst, "ref", (double)result->verify.worst_ref);
+            }
+        }
+        {
+            cJSON* histogram = cJSON_AddArrayToObject(item, "histogram");
+            int bin;
+            for (bin = 0; (histogram != NULL) && (bin < VERIFY_HISTOGRAM_BINS); bin++) {
+                (void)cJSON_AddItemToArray(
+                    histogram, cJSON_CreateNumber((double)result->verify.histogram[bin]));
+            }
+        }
+        if ((config->verification.rel_tolerance > 0.0f) ||
+            (config->verification.ulp_tolerance > 0)) {
+            (void)cJSON_AddNumberToObject(item, "rel_tolerance",
+                                          (double)config->verification.rel_tolerance);
+            (void)cJSON_AddNumberToObject(item, "ulp_tolerance",
+                                          (double)config->verification.ulp_tolerance);
+        }
+        /* Secondary outputs of a multi-output kernel */
+        if (result->output_count > 0) {
+            cJSON* outputs = cJSON_AddArrayToObject(item, "outputs");
+            int out;
+            for (out = 0; (outputs != NULL) && (out < result->output_count); out++) {
+                const OutputVerifyResult* r = &result->outputs[out];
+                cJSON* entry = cJSON_CreateObject();
+                if (entry == NULL) {
+                    break;
+                }
+                (void)cJSON_AddStringToObject(entry, "name", r->name);
+                (void)cJSON_AddBoolToObject(entry, "verified", (r->verified != 0) ? 1 : 0);
+                if (r->verified != 0) {
+                    (void)cJSON_AddBoolToObject(entry, "passed", (r->passed != 0) ? 1 : 0);
+                    (void)cJSON_AddNumberToObject(entry, "mismatches", (double)r->errors);
+                    (void)cJSON_AddNumberToObject(entry, "elements", (double)r->total_elements);
+                    (void)cJSON_AddNumberToObject(entry, "max_error", (double)r->max_error);
+                }
+                (void)cJSON_AddItemToArray(outputs, entry);
+            }
+        }
+    }
+
+    if (result->hardware.valid != 0) {
+        item = cJSON_AddObjectToObject(root, "hardware");
+        if (item != NULL) {
+            (void)cJSON_AddNumberToObject(item, "compute_units",
+                                          (double)result->hardware.compute_units);
+            (void)cJSON_AddNumberToObject(item, "device_local_mem_bytes",
+                                          (double)result->hardware.device_local_mem);
+            (void)cJSON_AddNumberToObject(item, "kernel_work_group_size",
+                                          (double)result->hardware.max_work_group_size);
+            (void)cJSON_AddNumberToObject(item, "preferred_work_group_multiple",
+                                          (double)result->hardware.preferred_multiple);
+            (void)cJSON_AddNumberToObject(item, "local_mem_bytes",
+                                          (double)result->hardware.local_mem_bytes);
+            (void)cJSON_AddNumberToObject(item, "private_mem_bytes",
+                                          (double)result->hardware.private_mem_bytes);
+            (void)cJSON_AddNumberToObject(item, "work_group_items",
+                                          (double)result->hardware.work_group_items);
+            (void)cJSON_AddNumberToObject(item, "work_groups",
+                                          (double)result->hardware.work_groups);
+            if (result->hardware.occupancy >= 0.0) {
+                (void)cJSON_AddNumberToObject(item, "occupancy", result->hardware.occupancy);
+                (void)cJSON_AddStringToObject(item, "occupancy_limit",
+                                              result->hardware.occupancy_limit);
+                (void)cJSON_AddNumberToObject(item, "lane_utilization",
+                                              result->hardware.lane_utilization);
+            }
+            (void)cJSON_AddNumberToObject(item, "bytes_moved",
+                                          (double)result->hardware.bytes_moved);
+            (void)cJSON_AddNumberToObject(item, "bandwidth_gbps",
+                                          result->hardware.bandwidth_gbps);
+            (void)cJSON_AddNumberToObject(item, "copy_bandwidth_gbps",
+                                          result->hardware.copy_bandwidth_gbps);
+            (void)cJSON_AddNumberToObject(item, "mpixels_per_s", result->hardware.mpixels_per_s);
+        }
+    }
+
+    if (result->has_benchmark != 0) {
+        item = cJSON_AddObjectToObject(root, "benchmark");
+        if (item != NULL) {
+            (void)cJSON_AddNumberToObject(item, "warmup_iterations",
+                                          (double)result->benchmark.warmup_iterations);
+            (void)cJSON_AddNumberToObject(item, "iterations",
+                                          (double)result->benchmark.kernel.count);
+            AddStatsObject(item, "kernel", &result->benchmark.kernel);
+            AddStatsObject(item, "upload", &result->benchmark.upload);
+            AddStatsObject(item, "readback", &result->benchmark.readback);
+            (void)cJSON_AddBoolToObject(item, "device_verify",
+                                        (result->benchmark.device_verified != 0) ? 1 : 0);
+            (void)cJSON_AddNumberToObject(item, "verify_failures",
+                                          (double)result->benchmark.verify_failures);
+        }
+    }
+
+    if (result->has_stream != 0) {
+        item = cJSON_AddObjectToObject(root, "stream");
+        if (item != NULL) {
+            (void)cJSON_AddNumberToObject(item, "frames", (double)result->stream_frames);
+            (void)cJSON_AddNumberToObject(item, "buffer_sets",
+                                          (double)result->stream_buffer_sets);
+            (void)cJSON_AddNumberToObject(item, "fps", result->stream_fps);
+            AddStatsObject(item, "latency", &result->stream_latency);
+        }
+    }
+
+    if (result->has_multi_device != 0) {
+        item = cJSON_AddObjectToObject(root, "multi_device");
+        if (item != NULL) {
+            (void)cJSON_AddStringToObject(
+                item, "split",
+                (result->multi_device_split == (int)MULTI_SPLIT_ROWS) ? "rows" : "frames");
+            (void)cJSON_AddNumberToObject(item, "devices", (double)result->multi_device_count);
+            (void)cJSON_AddNumberToObject(item, "fps", result->multi_device_fps);
+            (void)cJSON_AddNumberToObject(item, "checks", (double)result->multi_device_checks);
+            (void)cJSON_AddBoolToObject(item, "passed", result->multi_device_passed != 0);
+        }
+    }
+
+    if (result->has_batch != 0) {
+        item = cJSON_AddObjectToObject(root, "batch");
+        if (item != NULL) {
+            (void)cJSON_AddNumberToObject(item, "images", (double)result->batch_images);
+            (void)cJSON_AddNumberToObject(item, "per_image_ips", result->batch_loop_ips);
+            (void)cJSON_AddNumberToObject(item, "batched_ips", result->batch_ips);
+            (void)cJSON_AddNumberToObject(item, "failures", (double)result->batch_failures);
+        }
+    }
+
+    if (cJSON_PrintPreallocated(root, results_json_buffer, (int)sizeof(results_json_buffer), 1) ==
+        0) {
+        (void)fprintf(stderr, "Error: results.json exceeds %d bytes\n", MAX_RESULTS_JSON_SIZE);
+        cJSON_Delete(root);
+        return -1;
+    }
+    cJSON_Delete(root);
+
+    fp = fopen(path, "w");
+    if (fp == NULL) {
+        (void)fprintf(stderr, "Error: Failed to create %s\n", path);
+        return -1;
+    }
+    if (fprintf(fp, "%s\n", results_json_buffer) > 0) {
+        status = 0;
+    }
+    if (fclose(fp) != 0) {
+        status = -1;
+    }
+    return status;
+}
+
+static int WriteResultsCsv(const char* path, const Algorithm* algo, const KernelConfig* kernel_cfg,
+                           const char* device_name, const VariantResult* result) {
+    FILE* fp;
+    char global_str[64];
+    char local_str[64];
+    char device_str[MAX_DEVICE_NAME_SIZE];
+    size_t i;
+    int written;
+
+    /* Device names may contain commas; keep the CSV unquoted and simple */
+    (void)strncpy(device_str, device_name, sizeof(device_str) - 1U);
+    device_str[sizeof(device_str) - 1U] = '\0';
+    for (i = 0U; device_str[i] != '\0'; i++) {
+        if ((device_str[i] == ',') || (device_str[i] == '"')) {
+            device_str[i] = ' ';
+        }
+    }
+
+    FormatWorkSize(global_str, sizeof(global_str), kernel_cfg->global_work_size,
+                   kernel_cfg->work_dim);
+    FormatWorkSize(local_str, sizeof(local_str), kernel_cfg->local_work_size,
+                   kernel_cfg->work_dim);
+
+    fp = fopen(path, "w");
+    if (fp == NULL) {
+        (void)fprintf(stderr, "Error: Failed to create %s\n", path);
+        return -1;
+    }
+
+    (void)fprintf(fp,
+                  "algorithm,variant,device,global_work_size,local_work_size,memory_strategy,"
+                  "reference_ms,kernel_ms,upload_ms,readback_ms,max_error,passed,bench_iterations,"
+                  "bench_kernel_median_ms,bench_kernel_p95_ms,bench_kernel_p99_ms,"
+                  "bench_upload_median_ms,bench_readback_median_ms\n");
+    written = fprintf(fp,
+                      "%s,%s,%s,%s,%s,%s,%.6f,%.6f,%.6f,%.6f,%.6f,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+                      algo->id, kernel_cfg->variant_id, device_str, global_str, local_str,
+                      OpenclMemoryStrategyName(kernel_cfg->memory_strategy), result->ref_time_ms, result->gpu_time_ms, result->upload_ms,
+                      result->readback_ms, (double)result->max_error,
+                      (result->passed != 0) ? 1 : 0,
+                      (result->has_benchmark != 0) ? result->benchmark.kernel.count : 0,
+                      (result->has_benchmark != 0) ? result->benchmark.kernel.median_ms : 0.0,
+                      (result->has_benchmark != 0) ? result->benchmark.kernel.p95_ms : 0.0,
+                      (result->has_benchmark != 0) ? result->benchmark.kernel.p99_ms : 0.0,
+                      (result->has_benchmark != 0) ? result->benchmark.upload.median_ms : 0.0,
+                      (result->has_benchmark != 0) ? result->benchmark.readback.median_ms : 0.0);
+
+    if ((fclose(fp) != 0) || (written < 0)) {
+        return -1;
+    }
+    return 0;
+}
+
+int ResultsWriteRunDir(const char* run_dir, const Algorithm* algo, const KernelConfig* kernel_cfg,
+                       const Config* config, const char* device_name, const OpParams* params,
+                       const VariantResult* result) {
+    char path[MAX_CACHE_PATH];
+    int written;
+    int status = 0;
+
+    if ((run_dir == NULL) || (algo == NULL) || (kernel_cfg == NULL) || (config == NULL) ||
+        (device_name == NULL) || (params == NULL) || (result == NULL)) {
+        return -1;
+    }
+
+    written = snprintf(path, sizeof(path), "%s/results.json", run_dir);
+    if ((written < 0) || ((size_t)written >= sizeof(path))) {
+        return -1;
+    }
+    if (WriteResultsJson(path, algo, kernel_cfg, config, device_name, params, result) == 0) {
+        (void)printf("Results saved to: %s\n", path);
+    } else {
+        (void)fprintf(stderr, "Failed to save results.json\n");
+        status = -1;
+    }
+
+    if (config->results.write_csv != 0) {
+        written = snprintf(path, sizeof(path), "%s/results.csv", run_dir);
+        if ((written < 0) || ((size_t)written >= sizeof(path))) {
+            return -1;
+        }
+        if (WriteResultsCsv(path, algo, kernel_cfg, device_name, result) == 0) {
+            (void)printf("Results saved to: %s\n", path);
+        } else {
+            (void)fprintf(stderr, "Failed to save results.csv\n");
+            status = -1;
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file results_writer.h
+ * @brief Machine-readable run results (JSON/CSV) in the cache run directory
+ *
+ * Writes one record per executed variant so regression tracking can ingest
+ * results without scraping stdout:
+ * - <run_dir>/results.json: always written
+ * - <run_dir>/results.csv:  written when "results": {"csv": true} or --csv
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: JSON text is printed into a static buffer
+ * - Rule 17.7: All functions return status for error checking
+ */
+
+#pragma once
+
+#include "algorithm_runner.h"
+
+/**
+ * @brief Write results.json (and optionally results.csv) for one variant
+ *
+ * @param[in] run_dir Output directory (typically CacheGetRunDir())
+ * @param[in] algo Executed algorithm
+ * @param[in] kernel_cfg Executed variant configuration (work sizes, kernel)
+ * @param[in] config Full configuration (verification and results settings)
+ * @param[in] device_name OpenCL device name (may be empty)
+ * @param[in] params Operation parameters (image dimensions)
+ * @param[in] result Variant result (timings, verification, benchmark)
+ * @return 0 on success, -1 on error
+ */
+int ResultsWriteRunDir(const char* run_dir, const Algorithm* algo, const KernelConfig* kernel_cfg,
+                       const Config* config, const char* device_name, const OpParams* params,
+                       const VariantResult* result);
@@ -0,0 +1,558 @@
+/**
+ * @file server.c
+ * @brief Persistent server mode implementation
+ */
+
+#include "server.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "cJSON.h"
+#include "core/working_set.h"
+#include "utils/benchmark.h"
+#include "utils/image_io.h"
+#include "utils/safe_ops.h"
+
+/** Pending connections queued by listen() */
+#define SERVER_BACKLOG 8
+
+/** Tokens per request line */
+#define SERVER_MAX_TOKENS 8
+
+/** Run option prefix of a scalar override (scalar.NAME=VALUE) */
+#define SERVER_SCALAR_PREFIX "scalar."
+
+/**
+ * @brief A working set table entry
+ */
+typedef struct {
+    WorkingSet ws;            /**< Working set (valid if in_use) */
+    int in_use;               /**< Non-zero if ws is open */
+    unsigned long last_used;  /**< Use clock of the last request */
+} ServerEntry;
+
+/**
+ * @brief Shared-memory frame of a run request
+ */
+typedef struct {
+    unsigned char* data; /**< Mapping (input, then output) */
+    size_t length;       /**< Mapped bytes */
+} SharedFrame;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static ServerEntry entries[SERVER_MAX_WORKING_SETS];
+static unsigned long use_clock = 0UL;
+static OpenCLEnv server_env;
+static char request_buffer[SERVER_MAX_REQUEST];
+static char reply_buffer[SERVER_MAX_REPLY];
+static volatile sig_atomic_t stop_requested = 0;
+
+static void OnStopSignal(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+/* Write all bytes (replies are small, but a socket may still take them in parts) */
+static int WriteAll(int fd, const char* data, size_t size) {
+    ssize_t written;
+
+    while (size > 0U) {
+        written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return 0;
+}
+
+/* Send a reply object as one line and delete it */
+static int SendReply(int fd, cJSON* root) {
+    size_t length;
+    int status = -1;
+
+    if (root == NULL) {
+        return -1;
+    }
+    /* One line: unformatted, newline terminated */
+    if (cJSON_PrintPreallocated(root, reply_buffer, (int)sizeof(reply_buffer) - 1, 0) != 0) {
+        length = strlen(reply_buffer);
+        reply_buffer[length] = '\n';
+        status = WriteAll(fd, reply_buffer, length + 1U);
+    }
+    cJSON_Delete(root);
+    return status;
+}
+
+static cJSON* NewReply(const char* status) {
+    cJSON* root = cJSON_CreateObject();
+
+    if (root != NULL) {
+        (void)cJSON_AddStringToObject(root, "status", status);
+    }
+    return root;
+}
+
+static int SendError(int fd, const char* message) {
+    cJSON* root = NewReply("error");
+
+    if (root != NULL) {
+        (void)cJSON_AddStringToObject(root, "message", message);
+    }
+    return SendReply(fd, root);
+}
+
+/* Split a request line into space-separated tokens (in place) */
+static int Tokenize(char* line, char* tokens[], int max_tokens) {
+    int count = 0;
+    char* p = line;
+
+    while (*p != '\0') {
+        while ((*p == ' ') || (*p == '\t') || (*p == '\r')) {
+            *p = '\0';
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (count >= max_tokens) {
+            return -1;
+        }
+        tokens[count] = p;
+        count++;
+        while ((*p != '\0') && (*p != ' ') && (*p != '\t') && (*p != '\r')) {
+            p++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Warm working set of a variant, opened on first use
+ *
+ * @param[in] algorithm Algorithm name
+ * @param[in] variant Variant selector
+ * @param[out] cold Non-zero if the set was opened by this call
+ * @return Working set, or NULL if it cannot be opened
+ */
+static WorkingSet* AcquireWorkingSet(const char* algorithm, const char* variant, int* cold) {
+    ServerEntry* victim = NULL;
+    int i;
+
+    use_clock++;
+    for (i = 0; i < SERVER_MAX_WORKING_SETS; i++) {
+        ServerEntry* entry = &entries[i];
+
+        if ((entry->in_use != 0) && (strcmp(entry->ws.algorithm, algorithm) == 0) &&
+            (VariantMatchesSelector(&entry->ws.kernel_cfg, variant, strlen(variant)) != 0)) {
+            entry->last_used = use_clock;
+            *cold = 0;
+            return &entry->ws;
+        }
+        /* Free entries first, else the least recently used one */
+        if ((victim == NULL) || (entry->in_use == 0) ||
+            ((victim->in_use != 0) && (entry->last_used < victim->last_used))) {
+            victim = entry;
+        }
+    }
+
+    if (victim->in_use != 0) {
+        (void)printf("Server: closing %s v%s\n", victim->ws.algorithm,
+                     victim->ws.kernel_cfg.variant_id + 1);
+        WorkingSetClose(&victim->ws);
+        victim->in_use = 0;
+    }
+    if (WorkingSetOpen(&server_env, algorithm, variant, &victim->ws) != 0) {
+        WorkingSetClose(&victim->ws);
+        return NULL;
+    }
+    (void)printf("Server: opened %s %s in %.3f ms\n", algorithm, victim->ws.kernel_cfg.variant_id,
+                 victim->ws.setup_ms);
+    victim->in_use = 1;
+    victim->last_used = use_clock;
+    *cold = 1;
+    return &victim->ws;
+}
+
+/* Map a shared frame file (input followed by output) */
+static int MapSharedFrame(const char* path, size_t size, SharedFrame* frame) {
+    struct stat st;
+    void* data;
+    int fd;
+
+    frame->data = NULL;
+    frame->length = 0U;
+    fd = open(path, O_RDWR);
+    if (fd < 0) {
+        return -1;
+    }
+    if ((fstat(fd, &st) != 0) || (st.st_size < 0) || ((size_t)st.st_size < size)) {
+        (void)close(fd);
+        return -1;
+    }
+    data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (data == MAP_FAILED) {
+        return -1;
+    }
+    frame->data = (unsigned char*)data;
+    frame->length = size;
+    return 0;
+}
+
+static void UnmapSharedFrame(SharedFrame* frame) {
+    if (frame->data != NULL) {
+        (void)munmap(frame->data, frame->length);
+        frame->data = NULL;
+    }
+}
+
+/* Working set description shared by info and run replies */
+static void AddWorkingSetInfo(cJSON* root, const WorkingSet* ws, int cold) {
+    (void)cJSON_AddStringToObject(root, "algorithm", ws->algorithm_id);
+    (void)cJSON_AddStringToObject(root, "variant", ws->kernel_cfg.variant_id);
+    (void)cJSON_AddBoolToObject(root, "cold", cold != 0);
+    (void)cJSON_AddNumberToObject(root, "setup_ms", (cold != 0) ? ws->setup_ms : 0.0);
+    (void)cJSON_AddNumberToObject(root, "input_bytes", (double)ws->input_size);
+    (void)cJSON_AddNumberToObject(root, "output_bytes", (double)ws->output_size);
+}
+
+/* info <algorithm> <variant> */
+static int HandleInfo(int fd, char* tokens[], int count) {
+    WorkingSet* ws;
+    cJSON* root;
+    int cold = 0;
+
+    if (count != 3) {
+        return SendError(fd, "usage: info <algorithm> <variant>");
+    }
+    ws = AcquireWorkingSet(tokens[1], tokens[2], &cold);
+    if (ws == NULL) {
+        return SendError(fd, "cannot open working set (variant is e.g. 1 or v1)");
+    }
+    root = NewReply("ok");
+    if (root != NULL) {
+        AddWorkingSetInfo(root, ws, cold);
+        (void)cJSON_AddNumberToObject(root, "width", (double)ws->params.src_width);
+        (void)cJSON_AddNumberToObject(root, "height", (double)ws->params.src_height);
+        (void)cJSON_AddNumberToObject(root, "runs", (double)ws->runs);
+    }
+    return SendReply(fd, root);
+}
+
+/*
+ * run <algorithm> <variant> [input=PATH | shm=PATH] [output=PATH] [iterations=N]
+ *     [scalar.NAME=VALUE ...]
+ */
+static int HandleRun(int fd, char* tokens[], int count) {
+    const char* scalar_names[SERVER_MAX_TOKENS];
+    const char* scalar_values[SERVER_MAX_TOKENS];
+    int scalar_count = 0;
+    int arg_updates = 0;
+    int marked;
+    const char* input_path = NULL;
+    const char* shm_path = NULL;
+    const char* output_path = NULL;
+    char* value;
+    SharedFrame frame = {NULL, 0U};
+    WorkingSetTiming timing;
+    WorkingSetTiming sum;
+    const unsigned char* input;
+    unsigned char* output = NULL;
+    WorkingSet* ws;
+    cJSON* root;
+    long iterations = 1;
+    int cold = 0;
+    int i;
+
+    if (count < 3) {
+        return SendError(fd, "usage: run <algorithm> <variant> [input=PATH | shm=PATH] "
+                             "[output=PATH] [iterations=N] [scalar.NAME=VALUE ...]");
+    }
+    /* Options are key=value tokens */
+    for (i = 3; i < count; i++) {
+        value = strchr(tokens[i], '=');
+        if (value == NULL) {
+            return SendError(fd, "run options are key=value");
+        }
+        *value = '\0';
+        value++;
+        if (strcmp(tokens[i], "input") == 0) {
+            input_path = value;
+        } else if (strcmp(tokens[i], "shm") == 0) {
+            shm_path = value;
+        } else if (strcmp(tokens[i], "output") == 0) {
+            output_path = value;
+        } else if (strcmp(tokens[i], "iterations") == 0) {
+            if (!SafeStrtol(value, &iterations) || (iterations < 1) ||
+                (iterations > MAX_BENCHMARK_ITERATIONS)) {
+                return SendError(fd, "iterations out of range");
+            }
+        } else if (strncmp(tokens[i], SERVER_SCALAR_PREFIX, strlen(SERVER_SCALAR_PREFIX)) == 0) {
+            scalar_names[scalar_count] = tokens[i] + strlen(SERVER_SCALAR_PREFIX);
+            scalar_values[scalar_count] = value;
+            scalar_count++;
+        } else {
+            return SendError(fd, "unknown run option");
+        }
+    }
+    if ((input_path != NULL) && (shm_path != NULL)) {
+        return SendError(fd, "input and shm are exclusive");
+    }
+
+    ws = AcquireWorkingSet(tokens[1], tokens[2], &cold);
+    if (ws == NULL) {
+        return SendError(fd, "cannot open working set (variant is e.g. 1 or v1)");
+    }
+
+    /* Scalars stay set on the warm set; only their kernel arguments are re-set */
+    for (i = 0; i < scalar_count; i++) {
+        marked = WorkingSetSetScalar(ws, scalar_names[i], scalar_values[i]);
+        if (marked < 0) {
+            return SendError(fd, "unknown scalar or bad value");
+        }
+        arg_updates += marked;
+    }
+
+    /* Input: the shared frame, a file, or the configured input image */
+    if (shm_path != NULL) {
+        if (MapSharedFrame(shm_path, ws->input_size + ws->output_size, &frame) != 0) {
+            return SendError(fd, "cannot map shared frame (too small or missing)");
+        }
+        input = frame.data;
+        output = frame.data + ws->input_size;
+    } else {
+        input = ReadImage((input_path != NULL) ? input_path : ws->input_path, ws->input_size);
+        if (input == NULL) {
+            return SendError(fd, "cannot read input");
+        }
+    }
+
+    (void)memset(&sum, 0, sizeof(sum));
+    for (i = 0; i < (int)iterations; i++) {
+        if (WorkingSetRun(&server_env, ws, input, output, &timing) != 0) {
+            break;
+        }
+        sum.upload_ms += timing.upload_ms;
+        sum.kernel_ms += timing.kernel_ms;
+        sum.readback_ms += timing.readback_ms;
+        sum.total_ms += timing.total_ms;
+    }
+    if ((i == (int)iterations) && (output_path != NULL) &&
+        (WriteImage(output_path, (output != NULL) ? output : ws->host_output.data,
+                    ws->output_size) != 0)) {
+        i = -1;
+    }
+    UnmapSharedFrame(&frame);
+    ReleaseImage();
+    if (i != (int)iterations) {
+        return SendError(fd, (i < 0) ? "cannot write output" : "run failed");
+    }
+
+    root = NewReply("ok");
+    if (root != NULL) {
+        AddWorkingSetInfo(root, ws, cold);
+        (void)cJSON_AddNumberToObject(root, "iterations", (double)iterations);
+        (void)cJSON_AddNumberToObject(root, "upload_ms", sum.upload_ms / (double)iterations);
+        (void)cJSON_AddNumberToObject(root, "kernel_ms", sum.kernel_ms / (double)iterations);
+        (void)cJSON_AddNumberToObject(root, "readback_ms", sum.readback_ms / (double)iterations);
+        (void)cJSON_AddNumberToObject(root, "total_ms", sum.total_ms / (double)iterations);
+        (void)cJSON_AddNumberToObject(root, "arg_updates", (double)timing.arg_updates);
+        (void)cJSON_AddNumberToObject(root, "scalar_updates", (double)arg_updates);
+        if (output_path != NULL) {
+            (void)cJSON_AddStringToObject(root, "output", output_path);
+        }
+    }
+    return SendReply(fd, root);
+}
+
+/* stats: the warm working sets */
+static int HandleStats(int fd) {
+    cJSON* root = NewReply("ok");
+    cJSON* list;
+    cJSON* item;
+    int i;
+
+    if (root == NULL) {
+        return -1;
+    }
+    list = cJSON_AddArrayToObject(root, "working_sets");
+    for (i = 0; (list != NULL) && (i < SERVER_MAX_WORKING_SETS); i++) {
+        if (entries[i].in_use == 0) {
+            continue;
+        }
+        item = cJSON_CreateObject();
+        if (item == NULL) {
+            break;
+        }
+        (void)cJSON_AddStringToObject(item, "algorithm", entries[i].ws.algorithm_id);
+        (void)cJSON_AddStringToObject(item, "variant", entries[i].ws.kernel_cfg.variant_id);
+        (void)cJSON_AddNumberToObject(item, "runs", (double)entries[i].ws.runs);
+        (void)cJSON_AddNumberToObject(item, "setup_ms", entries[i].ws.setup_ms);
+        (void)cJSON_AddItemToArray(list, item);
+    }
+    return SendReply(fd, root);
+}
+
+/**
+ * @brief Handle one request line
+ *
+ * @return 0 to keep serving, 1 after shutdown, -1 if the connection failed
+ */
+static int HandleRequest(int fd, char* line) {
+    char* tokens[SERVER_MAX_TOKENS];
+    int count = Tokenize(line, tokens, SERVER_MAX_TOKENS);
+
+    if (count == 0) {
+        return 0;
+    }
+    if (count < 0) {
+        return SendError(fd, "too many arguments");
+    }
+    if (strcmp(tokens[0], "ping") == 0) {
+        return SendReply(fd, NewReply("ok"));
+    }
+    if (strcmp(tokens[0], "info") == 0) {
+        return HandleInfo(fd, tokens, count);
+    }
+    if (strcmp(tokens[0], "run") == 0) {
+        return HandleRun(fd, tokens, count);
+    }
+    if (strcmp(tokens[0], "stats") == 0) {
+        return HandleStats(fd);
+    }
+    if (strcmp(tokens[0], "shutdown") == 0) {
+        (void)SendReply(fd, NewReply("ok"));
+        return 1;
+    }
+    return SendError(fd, "unknown request");
+}
+
+/**
+ * @brief Serve the requests of one connection until it closes
+ *
+ * @return 1 after shutdown, 0 otherwise
+ */
+static int ServeConnection(int fd) {
+    size_t used = 0U;
+    ssize_t got;
+    char* newline;
+    int result;
+
+    while (stop_requested == 0) {
+        got = read(fd, request_buffer + used, sizeof(request_buffer) - 1U - used);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        if (got == 0) {
+            return 0;
+        }
+        used += (size_t)got;
+        request_buffer[used] = '\0';
+
+        /* Every complete line is one request */
+        while ((newline = strchr(request_buffer, '\n')) != NULL) {
+            *newline = '\0';
+            result = HandleRequest(fd, request_buffer);
+            used -= (size_t)(newline + 1 - request_buffer);
+            (void)memmove(request_buffer, newline + 1, used + 1U);
+            if (result != 0) {
+                return (result > 0) ? 1 : 0;
+            }
+        }
+        if (used >= sizeof(request_buffer) - 1U) {
+            (void)SendError(fd, "request too long");
+            return 0;
+        }
+    }
+    return 0;
+}
+
+int ServerRun(const char* socket_path) {
+    struct sockaddr_un addr;
+    struct sigaction action;
+    int listen_fd;
+    int fd;
+    int stop = 0;
+    int i;
+
+    if ((socket_path == NULL) || (strlen(socket_path) >= sizeof(addr.sun_path))) {
+        (void)fprintf(stderr, "Error: Invalid socket path\n");
+        return 1;
+    }
+
+    (void)printf("=== OpenCL Initialization ===\n");
+    if (OpenclInit(&server_env) != 0) {
+        (void)fprintf(stderr, "Failed to initialize OpenCL\n");
+        return 1;
+    }
+
+    /* No SA_RESTART: a stop signal interrupts accept() and read() */
+    (void)memset(&action, 0, sizeof(action));
+    action.sa_handler = OnStopSignal;
+    (void)sigemptyset(&action.sa_mask);
+    (void)sigaction(SIGINT, &action, NULL);
+    (void)sigaction(SIGTERM, &action, NULL);
+    /* A client that disconnects early must not kill the server */
+    (void)signal(SIGPIPE, SIG_IGN);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        (void)fprintf(stderr, "Error: Failed to create socket\n");
+        OpenclCleanup(&server_env);
+        return 1;
+    }
+    (void)memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    (void)snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path);
+    (void)unlink(socket_path);
+    if ((bind(listen_fd, (const struct sockaddr*)&addr, sizeof(addr)) != 0) ||
+        (listen(listen_fd, SERVER_BACKLOG) != 0)) {
+        (void)fprintf(stderr, "Error: Failed to listen on %s\n", socket_path);
+        (void)close(listen_fd);
+        OpenclCleanup(&server_env);
+        return 1;
+    }
+    (void)printf("Server: listening on %s\n", socket_path);
+
+    while ((stop == 0) && (stop_requested == 0)) {
+        fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            (void)fprintf(stderr, "Error: accept failed (%s)\n", strerror(errno));
+            break;
+        }
+        stop = ServeConnection(fd);
+        (void)close(fd);
+    }
+
+    (void)printf("Server: shutting down\n");
+    (void)close(listen_fd);
+    (void)unlink(socket_path);
+    for (i = 0; i < SERVER_MAX_WORKING_SETS; i++) {
+        if (entries[i].in_use != 0) {
+            WorkingSetClose(&entries[i].ws);
+            entries[i].in_use = 0;
+        }
+    }
+    OpenclCleanup(&server_env);
+    return 0;
+}
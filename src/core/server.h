@@ -0,0 +1,60 @@
+/**
+ * @file server.h
+ * @brief Persistent server mode for low-latency repeated runs
+ *
+ * A one-shot opencl_host run pays process start, OpenCL initialization,
+ * config parsing and program load before milliseconds of GPU work. The
+ * server pays them once: it keeps the OpenCL context and up to
+ * SERVER_MAX_WORKING_SETS warm working sets (working_set.h) and answers
+ * requests on a local (Unix domain) stream socket, one request per line,
+ * one JSON reply per line:
+ *
+ *   ping
+ *   info <algorithm> <variant>
+ *   run <algorithm> <variant> [input=PATH | shm=PATH] [output=PATH] [iterations=N]
+ *       [scalar.NAME=VALUE ...]
+ *   stats
+ *   shutdown
+ *
+ * `<variant>` is a variant id with or without its 'v' prefix ("1f" or
+ * "v1f").
+ *
+ * `run` reads the input from PATH (default: the configured input image),
+ * or from a shared-memory frame: a file mapped shared (e.g. /dev/shm/frame)
+ * that holds the input at offset 0 and receives the output right after it,
+ * at offset input_bytes (`info` reports both sizes). `output=PATH` also
+ * writes the output to a file. The reply carries the timings of the run
+ * (means over N iterations) and whether the working set was cold.
+ * `scalar.NAME=VALUE` changes a configured scalar of the warm set for this
+ * and later runs; only the kernel arguments it feeds are set again
+ * (`scalar_updates` of the reply).
+ *
+ * Requests are served one at a time, in order; the least recently used
+ * working set is closed when a new one needs its place.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Static working set table, no dynamic memory allocation
+ * - Rule 17.7: All system call return values checked
+ */
+
+#pragma once
+
+/** Working sets kept warm at once */
+#define SERVER_MAX_WORKING_SETS 8
+
+/** Longest request line in bytes (including the newline) */
+#define SERVER_MAX_REQUEST 1024
+
+/** Longest reply in bytes */
+#define SERVER_MAX_REPLY 2048
+
+/**
+ * @brief Serve requests on a Unix domain socket until `shutdown` or SIGINT / SIGTERM
+ *
+ * Initializes OpenCL, binds @p socket_path (replacing a stale socket file)
+ * and removes it again on exit.
+ *
+ * @param[in] socket_path Socket file path
+ * @return Process exit code (0 after an orderly shutdown)
+ */
+int ServerRun(const char* socket_path);
@@ -0,0 +1,424 @@
+/**
+ * @file working_set.c
+ * @brief Resident algorithm variant implementation
+ */
+
+#include "working_set.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "platform/autotune.h"
+#include "platform/cache_manager.h"
+#include "platform/cl_extension_api.h"
+#include "utils/benchmark.h"
+#include "utils/safe_ops.h"
+
+/* Configuration file paths */
+#define CONFIG_INPUTS_PATH "config/inputs.json"
+#define CONFIG_OUTPUTS_PATH "config/outputs.json"
+#define MAX_PATH_LENGTH 512
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static Config scratch_config;
+
+/* Select the variant the selector names ("1f" or "v1f") */
+static const KernelConfig* FindVariant(const Config* config, const char* selector) {
+    KernelConfig* variants[MAX_KERNEL_CONFIGS];
+    int count = 0;
+    int i;
+
+    if (GetOpVariants(config, config->op_id, variants, &count) != 0) {
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        if (VariantMatchesSelector(variants[i], selector, strlen(selector)) != 0) {
+            return variants[i];
+        }
+    }
+    (void)fprintf(stderr, "Error: Variant '%s' not found in %s; available:", selector,
+                  config->op_id);
+    for (i = 0; i < count; i++) {
+        (void)fprintf(stderr, " %s", variants[i]->variant_id);
+    }
+    (void)fprintf(stderr, " (with or without the 'v')\n");
+    return NULL;
+}
+
+/* Image geometry from the selected input and output entries (packed rows) */
+static int ResolveImages(const Config* config, WorkingSet* ws) {
+    const InputImageConfig* img_cfg = &config->input_images[0];
+    const OutputImageConfig* out_cfg = &config->output_images[0];
+    OpParams* params = &ws->params;
+    int size;
+    int i;
+
+    if ((config->input_image_count == 0) || (config->output_image_count == 0)) {
+        (void)fprintf(stderr, "Error: No input or output images configured\n");
+        return -1;
+    }
+    for (i = 0; (config->input_image_id[0] != '\0') && (i < config->input_image_count); i++) {
+        if (strcmp(config->input_image_id, config->input_images[i].name) == 0) {
+            img_cfg = &config->input_images[i];
+        }
+    }
+    for (i = 0; (config->output_image_id[0] != '\0') && (i < config->output_image_count); i++) {
+        if (strcmp(config->output_image_id, config->output_images[i].name) == 0) {
+            out_cfg = &config->output_images[i];
+        }
+    }
+    if (out_cfg->buffer_count > 1) {
+        (void)fprintf(stderr, "Error: Variants with secondary outputs are not supported\n");
+        return -1;
+    }
+
+    params->src_width = img_cfg->src_width;
+    params->src_height = img_cfg->src_height;
+    params->src_channels = (img_cfg->src_channels > 0) ? img_cfg->src_channels : 1;
+    params->src_stride = img_cfg->src_width * params->src_channels;
+    params->dst_width = out_cfg->dst_width;
+    params->dst_height = out_cfg->dst_height;
+    params->dst_channels = (out_cfg->dst_channels > 0) ? out_cfg->dst_channels : 1;
+    params->dst_stride = out_cfg->dst_width * params->dst_channels;
+    params->border_mode = BORDER_CLAMP;
+
+    /* MISRA-C:2023 Rule 1.3: Check for integer overflow */
+    if (!SafeMulInt(params->src_width, params->src_height, &size) ||
+        !SafeMulInt(size, params->src_channels, &size) || (size <= 0)) {
+        (void)fprintf(stderr, "Error: Invalid input image size\n");
+        return -1;
+    }
+    ws->input_size = (size_t)size;
+    if (!SafeMulInt(params->dst_width, params->dst_height, &size) ||
+        !SafeMulInt(size, params->dst_channels, &size) ||
+        !SafeMulInt(size, (out_cfg->data_type == DATA_TYPE_FLOAT) ? (int)sizeof(float) : 1,
+                    &size) ||
+        (size <= 0)) {
+        (void)fprintf(stderr, "Error: Invalid output image size\n");
+        return -1;
+    }
+    ws->output_size = (size_t)size;
+    (void)snprintf(ws->input_path, sizeof(ws->input_path), "%s", img_cfg->input_path);
+    return 0;
+}
+
+/* Extension variants allocate through the extension API, like they dispatch */
+static cl_mem CreateBuffer(OpenCLEnv* env, const WorkingSet* ws, cl_mem_flags flags, size_t size,
+                           void* host_ptr, const char* name) {
+    cl_mem buffer;
+    cl_int err;
+
+    if (ws->kernel_cfg.host_type == HOST_TYPE_STANDARD) {
+        return OpenclCreateBuffer(env->context, flags, size, host_ptr, name);
+    }
+    buffer = ClExtensionCreateBuffer(&env->ext_ctx, env->context, flags, size, host_ptr, &err);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to create %s buffer (error code: %d)\n", name, err);
+        return NULL;
+    }
+    return buffer;
+}
+
+/* Device copies of the custom buffers (file-backed ones from their mapped file) */
+static int CreateCustomBuffers(OpenCLEnv* env, const Config* config, WorkingSet* ws) {
+    MappedBuffer file_data;
+    cl_mem_flags mem_flags;
+    int i;
+
+    for (i = 0; i < config->custom_buffer_count; i++) {
+        const CustomBufferConfig* buf_cfg = &config->custom_buffers[i];
+        RuntimeBuffer* runtime_buf = &ws->custom_buffers.buffers[i];
+
+        (void)snprintf(runtime_buf->name, sizeof(runtime_buf->name), "%s", buf_cfg->name);
+        runtime_buf->type = buf_cfg->type;
+        runtime_buf->size_bytes = buf_cfg->size_bytes;
+        ws->custom_buffers.count++;
+
+        /* Convert buffer type to OpenCL flags */
+        if (buf_cfg->type == BUFFER_TYPE_READ_ONLY) {
+            mem_flags = CL_MEM_READ_ONLY;
+        } else if (buf_cfg->type == BUFFER_TYPE_WRITE_ONLY) {
+            mem_flags = CL_MEM_WRITE_ONLY;
+        } else {
+            mem_flags = CL_MEM_READ_WRITE;
+        }
+
+        if (buf_cfg->source_file[0] != '\0') {
+            /* The device copy is made at creation, the mapping is not kept */
+            (void)memset(&file_data, 0, sizeof(file_data));
+            if (MappedFileOpen(buf_cfg->source_file, buf_cfg->size_bytes, &file_data) != 0) {
+                (void)fprintf(stderr, "Failed to load %s\n", buf_cfg->source_file);
+                return -1;
+            }
+            runtime_buf->buffer = CreateBuffer(env, ws, mem_flags | CL_MEM_COPY_HOST_PTR,
+                                               buf_cfg->size_bytes, file_data.data, buf_cfg->name);
+            MappedBufferRelease(&file_data);
+        } else {
+            runtime_buf->buffer =
+                CreateBuffer(env, ws, mem_flags, buf_cfg->size_bytes, NULL, buf_cfg->name);
+        }
+        if (runtime_buf->buffer == NULL) {
+            (void)fprintf(stderr, "Failed to create GPU buffer '%s'\n", buf_cfg->name);
+            return -1;
+        }
+    }
+    if (ws->custom_buffers.count > 0) {
+        ws->params.custom_buffers = &ws->custom_buffers;
+    }
+    return 0;
+}
+
+/* Scalars from the config */
+static void LoadScalars(const Config* config, WorkingSet* ws) {
+    int i;
+
+    for (i = 0; i < config->scalar_arg_count; i++) {
+        const ScalarArgConfig* scalar_cfg = &config->scalar_args[i];
+        ScalarValue* scalar_val = &ws->custom_scalars.scalars[i];
+
+        (void)snprintf(scalar_val->name, sizeof(scalar_val->name), "%s", scalar_cfg->name);
+        scalar_val->type = scalar_cfg->type;
+        switch (scalar_cfg->type) {
+            case SCALAR_TYPE_INT:
+                scalar_val->value.int_value = scalar_cfg->value.int_value;
+                break;
+            case SCALAR_TYPE_FLOAT:
+                scalar_val->value.float_value = scalar_cfg->value.float_value;
+                break;
+            case SCALAR_TYPE_SIZE:
+                scalar_val->value.size_value = scalar_cfg->value.size_value;
+                break;
+            default:
+                break;
+        }
+        ws->custom_scalars.count++;
+    }
+    if (ws->custom_scalars.count > 0) {
+        ws->params.custom_scalars = &ws->custom_scalars;
+    }
+}
+
+/* Kernel from a prebuilt program binary: no source, no build key, no registry */
+static cl_kernel LoadBinaryKernel(const OpenCLEnv* env, const char* binary_path,
+                                  const KernelConfig* kernel_cfg) {
+    cl_program program;
+    cl_kernel kernel;
+    cl_int err;
+
+    program = CacheLoadProgramBinary(env->context, env->device, binary_path);
+    if (program == NULL) {
+        return NULL;
+    }
+    kernel = clCreateKernel(program, kernel_cfg->kernel_function, &err);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to create kernel %s from %s (error code: %d)\n",
+                      kernel_cfg->kernel_function, binary_path, err);
+        kernel = NULL;
+    }
+
+    /* The kernel holds its own reference to the program */
+    err = clReleaseProgram(program);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Warning: Failed to release program (error: %d)\n", err);
+    }
+    return kernel;
+}
+
+static int OpenSet(OpenCLEnv* env, const char* algorithm, const char* variant_selector,
+                   int from_binary, const char* binary_path, WorkingSet* ws) {
+    Config* config = &scratch_config;
+    const KernelConfig* variant;
+    char config_path[MAX_PATH_LENGTH];
+    double start_ms = BenchmarkNowMs();
+    double program_start_ms;
+
+    if ((env == NULL) || (algorithm == NULL) || (variant_selector == NULL) || (ws == NULL)) {
+        return -1;
+    }
+    (void)memset(ws, 0, sizeof(*ws));
+    (void)snprintf(ws->algorithm, sizeof(ws->algorithm), "%s", algorithm);
+
+    /* Resolve algorithm name to config path (config/<name>.json) */
+    if (ResolveConfigPath(algorithm, config_path, sizeof(config_path)) != 0) {
+        (void)fprintf(stderr, "Failed to resolve config path: %s\n", algorithm);
+        return -1;
+    }
+    (void)memset(config, 0, sizeof(*config));
+    if ((ParseInputsConfig(CONFIG_INPUTS_PATH, config) != 0) ||
+        (ParseOutputsConfig(CONFIG_OUTPUTS_PATH, config) != 0) ||
+        (ParseConfig(config_path, config) != 0)) {
+        (void)fprintf(stderr, "Failed to parse the configuration of %s\n", algorithm);
+        return -1;
+    }
+    /* Auto-derive op_id from filename if not specified in config */
+    if ((config->op_id[0] == '\0') || (strcmp(config->op_id, "config") == 0)) {
+        if (ExtractOpIdFromPath(config_path, config->op_id, sizeof(config->op_id)) != 0) {
+            return -1;
+        }
+    }
+    (void)snprintf(ws->algorithm_id, sizeof(ws->algorithm_id), "%s", config->op_id);
+
+    variant = FindVariant(config, variant_selector);
+    if (variant == NULL) {
+        return -1;
+    }
+    ws->kernel_cfg = *variant;
+    OpenclResolvePrecision(env, &ws->kernel_cfg);
+    if (OpenclCheckImageArgs(env, &ws->kernel_cfg) != 0) {
+        return -1;
+    }
+
+    if ((ResolveImages(config, ws) != 0) || (CreateCustomBuffers(env, config, ws) != 0)) {
+        return -1;
+    }
+    LoadScalars(config, ws);
+    ws->params.host_type = ws->kernel_cfg.host_type;
+    ws->params.kernel_variant = ws->kernel_cfg.kernel_variant;
+
+    ws->input_buf =
+        CreateBuffer(env, ws, CL_MEM_READ_ONLY, ws->input_size, NULL, "working set input");
+    ws->output_buf =
+        CreateBuffer(env, ws, CL_MEM_WRITE_ONLY, ws->output_size, NULL, "working set output");
+    if ((ws->input_buf == NULL) || (ws->output_buf == NULL) ||
+        (MappedBufferAlloc(ws->output_size, &ws->host_output) != 0)) {
+        return -1;
+    }
+
+    /* Programs come from the registry / binary cache, so a rebuilt set is cheap */
+    program_start_ms = BenchmarkNowMs();
+    if (from_binary != 0) {
+        if (binary_path != NULL) {
+            (void)snprintf(ws->binary_path, sizeof(ws->binary_path), "%s", binary_path);
+        } else {
+            (void)snprintf(ws->binary_path, sizeof(ws->binary_path), "%s/%s/cache/%s.bin",
+                           WORKING_SET_BINARY_DIR, ws->algorithm_id, ws->kernel_cfg.variant_id);
+        }
+        ws->kernel = LoadBinaryKernel(env, ws->binary_path, &ws->kernel_cfg);
+    } else {
+        ws->kernel = OpenclBuildKernel(env, ws->algorithm_id, &ws->kernel_cfg);
+    }
+    ws->program_ms = BenchmarkNowMs() - program_start_ms;
+    if (ws->kernel == NULL) {
+        return -1;
+    }
+    if ((ws->kernel_cfg.local_work_size_auto != 0) &&
+        (AutotuneLocalWorkSize(env, ws->kernel, ws->algorithm_id, ws->input_buf, ws->output_buf,
+                               &ws->params, &ws->kernel_cfg) != 0)) {
+        (void)fprintf(stderr, "Warning: Autotuning failed, using driver-selected local size\n");
+    }
+    if (KernelArgPlanCompile(ws->kernel, &ws->params, &ws->kernel_cfg, NULL, &ws->args) != 0) {
+        return -1;
+    }
+
+    ws->setup_ms = BenchmarkNowMs() - start_ms;
+    return 0;
+}
+
+int WorkingSetOpen(OpenCLEnv* env, const char* algorithm, const char* variant_selector,
+                   WorkingSet* ws) {
+    return OpenSet(env, algorithm, variant_selector, 0, NULL, ws);
+}
+
+int WorkingSetOpenBinary(OpenCLEnv* env, const char* algorithm, const char* variant_selector,
+                         const char* binary_path, WorkingSet* ws) {
+    return OpenSet(env, algorithm, variant_selector, 1, binary_path, ws);
+}
+
+int WorkingSetSetScalar(WorkingSet* ws, const char* name, const char* value) {
+    ScalarValue* scalar = NULL;
+    long int_value;
+    int i;
+
+    if ((ws == NULL) || (ws->kernel == NULL) || (name == NULL) || (value == NULL)) {
+        return -1;
+    }
+    for (i = 0; (scalar == NULL) && (i < ws->custom_scalars.count); i++) {
+        if (strcmp(ws->custom_scalars.scalars[i].name, name) == 0) {
+            scalar = &ws->custom_scalars.scalars[i];
+        }
+    }
+    if (scalar == NULL) {
+        (void)fprintf(stderr, "Error: Scalar '%s' not configured for %s\n", name,
+                      ws->kernel_cfg.variant_id);
+        return -1;
+    }
+
+    switch (scalar->type) {
+        case SCALAR_TYPE_INT:
+            if (!SafeStrtol(value, &int_value) || (int_value < INT_MIN) ||
+                (int_value > INT_MAX)) {
+                return -1;
+            }
+            scalar->value.int_value = (int)int_value;
+            break;
+        case SCALAR_TYPE_FLOAT:
+            if (!SafeStrtof(value, &scalar->value.float_value)) {
+                return -1;
+            }
+            break;
+        case SCALAR_TYPE_SIZE:
+            if (!SafeStrToSize(value, &scalar->value.size_value)) {
+                return -1;
+            }
+            break;
+        default:
+            return -1;
+    }
+    return KernelArgPlanRefresh(&ws->args, &ws->params);
+}
+
+int WorkingSetRun(OpenCLEnv* env, WorkingSet* ws, const unsigned char* input,
+                  unsigned char* output, WorkingSetTiming* timing) {
+    unsigned char* dst;
+    double start_ms = BenchmarkNowMs();
+
+    if ((env == NULL) || (ws == NULL) || (ws->kernel == NULL) || (input == NULL) ||
+        (timing == NULL)) {
+        return -1;
+    }
+    (void)memset(timing, 0, sizeof(*timing));
+    dst = (output != NULL) ? output : ws->host_output.data;
+
+    if ((OpenclUploadBuffer(env, ws->input_buf, MEM_STRATEGY_COPY, input, ws->input_size,
+                            &timing->upload_ms) != 0) ||
+        (KernelArgPlanBind(&ws->args, ws->input_buf, ws->output_buf) != 0) ||
+        (OpenclDispatchKernel(env, ws->kernel, &ws->kernel_cfg, &timing->kernel_ms) != 0) ||
+        (OpenclReadbackBuffer(env, ws->output_buf, MEM_STRATEGY_COPY, dst, ws->output_size,
+                              &timing->readback_ms) != 0)) {
+        return -1;
+    }
+    timing->arg_updates = ws->args.last_updates;
+
+    /* Extension kernels: keep the custom binary of the first dispatch */
+    if ((ws->runs == 0) && (ws->kernel_cfg.host_type != HOST_TYPE_STANDARD)) {
+        CacheSaveCustomBinary(&env->ext_ctx);
+    }
+    ws->runs++;
+    timing->total_ms = BenchmarkNowMs() - start_ms;
+    return 0;
+}
+
+void WorkingSetClose(WorkingSet* ws) {
+    int i;
+
+    if (ws == NULL) {
+        return;
+    }
+    /* MISRA-C:2023 Rule 22.1: Proper resource management */
+    if (ws->kernel != NULL) {
+        OpenclReleaseKernel(ws->kernel);
+        ws->kernel = NULL;
+    }
+    for (i = 0; i < ws->custom_buffers.count; i++) {
+        OpenclReleaseMemObject(ws->custom_buffers.buffers[i].buffer,
+                               ws->custom_buffers.buffers[i].name);
+        ws->custom_buffers.buffers[i].buffer = NULL;
+    }
+    ws->custom_buffers.count = 0;
+    OpenclReleaseMemObject(ws->input_buf, "working set input");
+    OpenclReleaseMemObject(ws->output_buf, "working set output");
+    ws->input_buf = NULL;
+    ws->output_buf = NULL;
+    MappedBufferRelease(&ws->host_output);
+    ws->algorithm[0] = '\0';
+}
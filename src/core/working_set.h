@@ -0,0 +1,131 @@
+/**
+ * @file working_set.h
+ * @brief One kernel variant kept resident for repeated runs
+ *
+ * A working set holds everything a run of one algorithm variant needs
+ * after the cold start: the parsed variant configuration, the built
+ * kernel with its compiled argument plan (kernel_args.h), the custom
+ * buffers and scalars, and device input / output buffers sized for the
+ * configured images. A run is then upload, one dispatch and readback.
+ * Changing a scalar between runs (WorkingSetSetScalar()) re-sets only the
+ * kernel arguments that pack it.
+ *
+ * There is no C reference and no verification: the working set is the
+ * execution path of callers that already trust the variant (server mode).
+ * Variants with secondary outputs are not supported. Variants with the
+ * cl_extension host type allocate their buffers through the extension API.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: No dynamic allocation (host output is a page-backed mapping)
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#include "platform/kernel_args.h"
+#include "platform/opencl_utils.h"
+#include "utils/config.h"
+#include "utils/mapped_file.h"
+
+/** Root of the prebuilt binaries: <dir>/<op_id>/cache/<variant_id>.bin */
+#define WORKING_SET_BINARY_DIR "test_data"
+
+/**
+ * @brief Resident state of one algorithm variant
+ */
+typedef struct {
+    char algorithm[64];            /**< Algorithm name as requested (config/<name>.json) */
+    char algorithm_id[32];         /**< Config op_id (program cache directory) */
+    KernelConfig kernel_cfg;       /**< Selected variant, run-time resolved */
+    cl_kernel kernel;              /**< Built kernel */
+    KernelArgPlan args;            /**< Arguments of kernel, resolved once */
+    OpParams params;               /**< Image geometry, custom buffers and scalars */
+    CustomBuffers custom_buffers;  /**< Device copies of the custom buffers */
+    CustomScalars custom_scalars;  /**< Scalars from the config */
+    cl_mem input_buf;              /**< Device input image */
+    cl_mem output_buf;             /**< Device output image */
+    size_t input_size;             /**< Bytes per input image */
+    size_t output_size;            /**< Bytes per output image */
+    char input_path[256];          /**< Configured input image */
+    char binary_path[256];         /**< Program binary, empty if built from source */
+    MappedBuffer host_output;      /**< Host output of the last run */
+    double setup_ms;               /**< Wall-clock of WorkingSetOpen() */
+    double program_ms;             /**< Program load and kernel creation, within setup_ms */
+    int runs;                      /**< Runs since the set was opened */
+} WorkingSet;
+
+/**
+ * @brief Timing of one working set run (milliseconds)
+ */
+typedef struct {
+    double upload_ms;   /**< Host to device input transfer */
+    double kernel_ms;   /**< Device time of the dispatch */
+    double readback_ms; /**< Device to host output transfer */
+    double total_ms;    /**< Host wall-clock of the whole run */
+    int arg_updates;    /**< Kernel arguments set for this run */
+} WorkingSetTiming;
+
+/**
+ * @brief Parse, build and allocate everything a variant needs
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] algorithm Algorithm name (config/<name>.json)
+ * @param[in] variant_selector Variant id, with or without the 'v' prefix (e.g., "1f" or "v1f")
+ * @param[out] ws Working set (safe to close after a failed open)
+ * @return 0 on success, -1 on error
+ */
+int WorkingSetOpen(OpenCLEnv* env, const char* algorithm, const char* variant_selector,
+                   WorkingSet* ws);
+
+/**
+ * @brief Open a working set whose kernel comes from a prebuilt program binary
+ *
+ * Like WorkingSetOpen(), but the program is created from @p binary_path
+ * (by default WORKING_SET_BINARY_DIR/<op_id>/cache/<variant_id>.bin, as
+ * written by opencl_precompile --export): the kernel source is never read
+ * and clCreateProgramWithSource is never called. The binary must have been
+ * built for this device with the variant's build options.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] algorithm Algorithm name (config/<name>.json)
+ * @param[in] variant_selector Variant id, with or without the 'v' prefix (e.g., "1f" or "v1f")
+ * @param[in] binary_path Program binary file, or NULL for the default layout
+ * @param[out] ws Working set (safe to close after a failed open)
+ * @return 0 on success, -1 on error
+ */
+int WorkingSetOpenBinary(OpenCLEnv* env, const char* algorithm, const char* variant_selector,
+                         const char* binary_path, WorkingSet* ws);
+
+/**
+ * @brief Change a configured scalar for the following runs
+ *
+ * Parses @p value as the scalar's configured type and stores it in the
+ * working set. KernelArgPlanRefresh() then marks only the kernel arguments
+ * packing that scalar dirty, so the next run sets just those.
+ *
+ * @param[in,out] ws Open working set
+ * @param[in] name Scalar name (scalars section of the config)
+ * @param[in] value New value as text
+ * @return Kernel arguments marked dirty (0 if the value is unchanged), or -1 on error
+ */
+int WorkingSetSetScalar(WorkingSet* ws, const char* name, const char* value);
+
+/**
+ * @brief Run the variant once
+ *
+ * @param[in] env OpenCL environment the set was opened with
+ * @param[in,out] ws Open working set
+ * @param[in] input Input image (ws->input_size bytes)
+ * @param[out] output Output image (ws->output_size bytes), or NULL for ws->host_output
+ * @param[out] timing Transfer and kernel times
+ * @return 0 on success, -1 on error
+ */
+int WorkingSetRun(OpenCLEnv* env, WorkingSet* ws, const unsigned char* input,
+                  unsigned char* output, WorkingSetTiming* timing);
+
+/**
+ * @brief Release the kernel and buffers of a working set
+ *
+ * @param[in,out] ws Working set (safe on a zeroed or closed one)
+ */
+void WorkingSetClose(WorkingSet* ws);
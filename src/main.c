@@ -1,12 +1,20 @@
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 /* Include internal headers with full type definitions */
+#include "algorithm_runner.h"
+#include "core/ref_thread_pool.h"
+#include "core/server.h"
 #include "op_registry.h"
 #include "platform/cache_manager.h"
 #include "platform/opencl_utils.h"
+#include "platform/primitives.h"
+#include "utils/benchmark.h"
 #include "utils/config.h"
+#include "utils/mapped_file.h"
 #include "utils/safe_ops.h"
 
 #ifdef BUILD_ANDROID
@@ -15,25 +23,64 @@
 
 /* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
 #define MAX_PATH_LENGTH 512
-#define MAX_IMAGE_SIZE (4096 * 4096)
+
+/* Elements per input of --bench-primitives (one 1080p frame) */
+#define PRIMITIVES_BENCH_DEFAULT_COUNT (1920 * 1080)
 
 /* Configuration file paths */
 #define CONFIG_INPUTS_PATH "config/inputs.json"
 #define CONFIG_OUTPUTS_PATH "config/outputs.json"
 
-static unsigned char gpu_output_buffer[MAX_IMAGE_SIZE];
-static unsigned char ref_output_buffer[MAX_IMAGE_SIZE];
+/* Output buffers are page-backed mappings sized from the configured images */
+static MappedBuffer gpu_output;
+static MappedBuffer ref_output;
 
-/* Forward declarations */
-void RunAlgorithm(const Algorithm* algo, const KernelConfig* kernel_cfg, const Config* config,
-                  OpenCLEnv* env, unsigned char* gpu_output_buffer,
-                  unsigned char* ref_output_buffer);
+/**
+ * @brief Command line options
+ *
+ * Positional arguments plus optional flags. Benchmark overrides are -1 when
+ * not given on the command line (config file value is kept).
+ */
+typedef struct {
+    const char* algorithm;        /**< Algorithm name (positional 1) */
+    const char* variant_selector; /**< Variant selector (positional 2) */
+    int benchmark;                /**< Non-zero if --benchmark given */
+    int warmup_iterations;        /**< --warmup N, or -1 */
+    int iterations;               /**< --iterations N, or -1 */
+    int csv;                      /**< Non-zero if --csv given */
+    int trace;                    /**< Non-zero if --trace given */
+    int device_verify;            /**< Non-zero if --device-verify given */
+    const char* stream_path;      /**< --stream PATH, or NULL */
+    int frames;                   /**< --frames N, or -1 */
+    int buffer_sets;              /**< --buffer-sets N, or -1 */
+    int ref_threads;              /**< --ref-threads N, or -1 */
+    int multi_device;             /**< Non-zero if --multi-device given */
+    MultiDeviceSplit split;       /**< --multi-device rows|frames */
+    int devices;                  /**< --devices N, or -1 */
+} CliOptions;
+
+/* Per-variant results of the current run (one entry per selected variant) */
+static VariantResult variant_results[MAX_KERNEL_CONFIGS];
 
+/* Forward declarations */
 void AutoRegisterAlgorithms(void);
 
 static int SelectAlgorithmAndVariant(const Config* config, const char* provided_selector,
-                                     Algorithm** selected_algo, KernelConfig** variants,
-                                     int* variant_count, int* selected_variant_index);
+                                     Algorithm** selected_algo, KernelConfig** selected,
+                                     int* selected_count,
+                                     const PipelineConfig** selected_pipeline);
+
+static int ParseCliOptions(int argc, char** argv, CliOptions* opts);
+
+static void ApplyCliOverrides(const CliOptions* opts, Config* config);
+
+static void PrintUsage(FILE* stream, const char* prog);
+
+static size_t MaxConfiguredImageSize(const Config* config);
+
+#ifndef BUILD_ANDROID
+static int RunPrimitivesBenchmark(int argc, char** argv);
+#endif
 
 int main(int argc, char** argv) {
 #ifdef BUILD_ANDROID
@@ -48,26 +95,44 @@ int main(int argc, char** argv) {
 
     OpenCLEnv env;
     Algorithm* algo;
-    KernelConfig* variants[MAX_KERNEL_CONFIGS];
-    int variant_count;
+    KernelConfig* selected[MAX_KERNEL_CONFIGS];
+    int selected_count = 0;
+    const PipelineConfig* selected_pipeline = NULL;
     int parse_result;
     int opencl_result;
     char config_path[MAX_PATH_LENGTH];
     const char* config_input;
+    CliOptions cli;
+    size_t image_bytes;
+    int k;
 
     /* Check for help flags */
     if ((argc == 2) && ((strcmp(argv[1], "--help") == 0) || (strcmp(argv[1], "-h") == 0) ||
                         (strcmp(argv[1], "help") == 0))) {
-        (void)printf("Usage: %s <algorithm> [variant_index]\n", argv[0]);
+        PrintUsage(stdout, argv[0]);
         (void)printf("\n");
         (void)printf("Available Algorithms:\n");
         ListAlgorithms();
         return 0;
     }
 
+    /* Standalone benchmark of the shared kernel primitives (no algorithm config) */
+    if ((argc >= 2) && (strcmp(argv[1], "--bench-primitives") == 0)) {
+        return RunPrimitivesBenchmark(argc, argv);
+    }
+
+    /* Persistent server: context, kernels and buffers stay warm across requests */
+    if ((argc >= 2) && (strcmp(argv[1], "--serve") == 0)) {
+        if (argc != 3) {
+            (void)fprintf(stderr, "Usage: %s --serve SOCKET_PATH\n", argv[0]);
+            return 1;
+        }
+        return ServerRun(argv[2]);
+    }
+
     /* Check command line arguments - both algorithm and variant are required */
-    if (argc != 3) {
-        (void)fprintf(stderr, "Usage: %s <algorithm> <variant>\n", argv[0]);
+    if (ParseCliOptions(argc, argv, &cli) != 0) {
+        PrintUsage(stderr, argv[0]);
         (void)fprintf(stderr, "\nRun '%s --help' for more information\n", argv[0]);
         if (argc < 2) {
             (void)fprintf(stderr, "\nAvailable algorithms:\n");
@@ -77,11 +142,12 @@ int main(int argc, char** argv) {
     }
 
     /* Argument 1: Algorithm name (required) */
-    config_input = argv[1];
+    config_input = cli.algorithm;
 
     /* Argument 2: Variant selector (required) */
-    /* User enters selector string (e.g., "0", "1", "1f") without 'v' prefix */
-    const char* variant_selector = argv[2];
+    /* User enters selector string (e.g., "0", "1", "1f" or "v1f"), */
+    /* a comma-separated list (e.g., "0,1,1f") or "all" */
+    const char* variant_selector = cli.variant_selector;
 
     /* Resolve algorithm name to config path (config/<name>.json) */
     if (ResolveConfigPath(config_input, config_path, sizeof(config_path)) != 0) {
@@ -110,6 +176,9 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    /* 1d. Command line flags override config file benchmark settings */
+    ApplyCliOverrides(&cli, &config);
+
     /* Auto-derive op_id from filename if not specified in config */
     if ((config.op_id[0] == '\0') || (strcmp(config.op_id, "config") == 0)) {
         if (ExtractOpIdFromPath(config_path, config.op_id, sizeof(config.op_id)) != 0) {
@@ -117,10 +186,9 @@ int main(int argc, char** argv) {
         }
     }
 
-    /* 3. Select algorithm and kernel variant (with user interaction if needed) */
-    int variant_index = -1;
-    if (SelectAlgorithmAndVariant(&config, variant_selector, &algo, variants, &variant_count,
-                                  &variant_index) != 0) {
+    /* 3. Select algorithm and kernel variant(s) */
+    if (SelectAlgorithmAndVariant(&config, variant_selector, &algo, selected, &selected_count,
+                                  &selected_pipeline) != 0) {
         return 1;
     }
 
@@ -132,52 +200,103 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    /* 5. Initialize cache directories for this algorithm */
-    if (CacheInit(algo->id, variants[variant_index]->variant_id) != 0) {
-        (void)fprintf(stderr, "Warning: Failed to initialize cache directories for %s\n", algo->id);
+    /* fp16 variants fall back to fp32 on devices without cl_khr_fp16 */
+    for (k = 0; k < config.num_kernels; k++) {
+        OpenclResolvePrecision(&env, &config.kernels[k]);
+        if (config.kernels[k].precision_fallback != 0) {
+            (void)printf("Note: %s requests fp16, running it in fp32\n",
+                         config.kernels[k].variant_id);
+        }
+    }
+
+    /* 6. Output buffers: no fixed cap, pages are committed only when written */
+    image_bytes = MaxConfiguredImageSize(&config);
+    if ((image_bytes == 0U) || (MappedBufferAlloc(image_bytes, &gpu_output) != 0) ||
+        (MappedBufferAlloc(image_bytes, &ref_output) != 0)) {
+        (void)fprintf(stderr, "Failed to allocate output buffers\n");
+        MappedBufferRelease(&gpu_output);
+        OpenclCleanup(&env);
+        return 1;
     }
 
-    /* 7. Run algorithm */
-    (void)printf("\n=== Running %s (variant: %s) ===\n", algo->name,
-                 variants[variant_index]->variant_id);
-    RunAlgorithm(algo, variants[variant_index], &config, &env, gpu_output_buffer,
-                 ref_output_buffer);
+    /* 7. Run algorithm - environment, input and reference are shared across variants */
+    /* (cache directories are initialized per variant by the runner) */
+    if (selected_pipeline != NULL) {
+        (void)RunAlgorithmPipeline(algo, selected_pipeline, &config, &env, gpu_output.data,
+                                   ref_output.data, &variant_results[0]);
+    } else {
+        (void)RunAlgorithmVariants(algo, selected, selected_count, &config, &env, gpu_output.data,
+                                   ref_output.data, variant_results);
+    }
 
     /* Cleanup */
+    RefPoolShutdown();
     OpenclCleanup(&env);
+    MappedBufferRelease(&gpu_output);
+    MappedBufferRelease(&ref_output);
     return 0;
 #endif /* !BUILD_ANDROID */
 }
 
 /**
- * @brief Select algorithm and kernel variant
+ * @brief Find a variant by selector (variant_id with or without its 'v' prefix)
+ *
+ * @param[in] variants Available variants
+ * @param[in] variant_count Number of available variants
+ * @param[in] selector Selector string (e.g., "1f" or "v1f")
+ * @param[in] selector_len Number of selector characters to compare
+ * @return Variant index, or -1 if not found
+ */
+static int FindVariantIndex(KernelConfig* const variants[], int variant_count, const char* selector,
+                            size_t selector_len) {
+    int i;
+
+    for (i = 0; i < variant_count; i++) {
+        if (VariantMatchesSelector(variants[i], selector, selector_len) != 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Select algorithm and kernel variant(s)
  *
  * This function:
  * 1. Finds the algorithm based on config.op_id
  * 2. Gets kernel variants for the selected algorithm
  * 3. Displays available variants
- * 4. Selects variant based on provided selector string
+ * 4. Selects variants based on provided selector string
+ *
+ * Selector forms: a single variant ("1f" or "v1f"), a comma-separated list ("0,1,1f"),
+ * "all" for every configured variant in config order, or the id of an entry
+ * in the "pipeline" section (matched verbatim, e.g. "corners").
  *
  * @param[in] config Configuration containing op_id
- * @param[in] selector Variant selector string (e.g., "0", "1f") - required
+ * @param[in] selector Variant selector string - required
  * @param[out] selected_algo Pointer to receive the selected algorithm
- * @param[out] variants Array to receive variant configurations
- * @param[out] variant_count Number of variants found
- * @param[out] selected_variant_index The selected variant index
+ * @param[out] selected Array to receive selected variant configurations
+ * @param[out] selected_count Number of selected variants
+ * @param[out] selected_pipeline Selected pipeline, or NULL when variants are selected
  * @return 0 on success, -1 on error
  */
 static int SelectAlgorithmAndVariant(const Config* config, const char* selector,
-                                     Algorithm** selected_algo, KernelConfig** variants,
-                                     int* variant_count, int* selected_variant_index) {
+                                     Algorithm** selected_algo, KernelConfig** selected,
+                                     int* selected_count,
+                                     const PipelineConfig** selected_pipeline) {
     Algorithm* algo;
+    KernelConfig* variants[MAX_KERNEL_CONFIGS];
+    int variant_count;
     int get_variants_result;
     int i;
-    int found_index = -1;
+    const char* token;
+    size_t token_len;
 
     if ((config == NULL) || (selector == NULL) || (selected_algo == NULL) ||
-        (variants == NULL) || (variant_count == NULL) || (selected_variant_index == NULL)) {
+        (selected == NULL) || (selected_count == NULL) || (selected_pipeline == NULL)) {
         return -1;
     }
+    *selected_pipeline = NULL;
 
     /* Step 1: Find selected algorithm based on config.op_id */
     algo = FindAlgorithm(config->op_id);
@@ -189,8 +308,8 @@ static int SelectAlgorithmAndVariant(const Config* config, const char* selector,
     }
 
     /* Step 2: Get kernel variants for selected algorithm */
-    get_variants_result = GetOpVariants(config, algo->id, variants, variant_count);
-    if ((get_variants_result != 0) || (*variant_count == 0)) {
+    get_variants_result = GetOpVariants(config, algo->id, variants, &variant_count);
+    if ((get_variants_result != 0) || (variant_count == 0)) {
         (void)fprintf(stderr, "No kernel variants configured for %s\n", algo->name);
         return -1;
     }
@@ -199,7 +318,7 @@ static int SelectAlgorithmAndVariant(const Config* config, const char* selector,
     /* Format: [selector] kernel_variant--description */
     (void)printf("\n=== Algorithm: %s ===\n", algo->name);
     (void)printf("Available variants:\n");
-    for (i = 0; i < *variant_count; i++) {
+    for (i = 0; i < variant_count; i++) {
         /* Skip 'v' prefix in variant_id for display */
         const char* vid = variants[i]->variant_id + 1;
         if (variants[i]->description[0] != '\0') {
@@ -209,26 +328,413 @@ static int SelectAlgorithmAndVariant(const Config* config, const char* selector,
             (void)printf("  [%s] %d\n", vid, variants[i]->kernel_variant);
         }
     }
+    if (config->pipeline_count > 0) {
+        int s;
+
+        (void)printf("Available pipelines:\n");
+        for (i = 0; i < config->pipeline_count; i++) {
+            const PipelineConfig* pc = &config->pipelines[i];
+
+            (void)printf("  [%s] ", pc->pipeline_id);
+            for (s = 0; s < pc->stage_count; s++) {
+                (void)printf("%s%s", (s > 0) ? " -> " : "", pc->stages[s].kernel_id);
+            }
+            if (pc->description[0] != '\0') {
+                (void)printf("--%s", pc->description);
+            }
+            (void)printf("\n");
+        }
+    }
     (void)printf("\n");
 
-    /* Step 4: Find variant by matching selector against variant_id suffix (skip 'v') */
-    for (i = 0; i < *variant_count; i++) {
-        if (strcmp(variants[i]->variant_id + 1, selector) == 0) {
-            found_index = i;
-            break;
+    /* Step 4a: A pipeline id selects that pipeline */
+    *selected_count = 0;
+    *selected_pipeline = FindPipelineConfig(config, selector);
+    if (*selected_pipeline != NULL) {
+        *selected_algo = algo;
+        return 0;
+    }
+
+    /* Step 4b: "all" selects every variant in config order */
+    if (strcmp(selector, "all") == 0) {
+        for (i = 0; i < variant_count; i++) {
+            selected[i] = variants[i];
         }
+        *selected_count = variant_count;
+        *selected_algo = algo;
+        return 0;
     }
 
-    if (found_index < 0) {
-        (void)fprintf(stderr, "Error: Variant '%s' not found. Available: ", selector);
-        for (i = 0; i < *variant_count; i++) {
-            (void)fprintf(stderr, "%s%s", variants[i]->variant_id + 1,
-                          (i < *variant_count - 1) ? ", " : "\n");
+    /* Step 4c: Match each comma-separated selector against variant_id suffix (skip 'v') */
+    token = selector;
+    while (*token != '\0') {
+        int found_index;
+
+        token_len = strcspn(token, ",");
+        found_index = FindVariantIndex(variants, variant_count, token, token_len);
+        if (found_index < 0) {
+            (void)fprintf(stderr, "Error: Variant '%.*s' not found. Available: ", (int)token_len,
+                          token);
+            for (i = 0; i < variant_count; i++) {
+                (void)fprintf(stderr, "%s%s", variants[i]->variant_id + 1,
+                              (i < variant_count - 1) ? ", " : "\n");
+            }
+            return -1;
+        }
+        if (*selected_count >= MAX_KERNEL_CONFIGS) {
+            (void)fprintf(stderr, "Error: Too many variants selected (max %d)\n",
+                          MAX_KERNEL_CONFIGS);
+            return -1;
+        }
+        selected[*selected_count] = variants[found_index];
+        (*selected_count)++;
+
+        token += token_len;
+        if (*token == ',') {
+            token++;
         }
+    }
+
+    if (*selected_count == 0) {
+        (void)fprintf(stderr, "Error: Empty variant selector\n");
         return -1;
     }
 
-    *selected_variant_index = found_index;
     *selected_algo = algo;
     return 0;
 }
+
+/**
+ * @brief Print command line usage
+ *
+ * @param[in] stream Output stream (stdout for --help, stderr on error)
+ * @param[in] prog Program name (argv[0])
+ */
+static void PrintUsage(FILE* stream, const char* prog) {
+    (void)fprintf(stream, "Usage: %s <algorithm> <variant> [options]\n", prog);
+    (void)fprintf(stream, "       %s --bench-primitives [N] [--warmup N] [--iterations N]\n",
+                  prog);
+    (void)fprintf(stream, "       %s --serve SOCKET_PATH\n", prog);
+    (void)fprintf(stream,
+                  "\nVariant: a selector (e.g., 1f or v1f), a list (e.g., 0,1,1f) or 'all'\n");
+    (void)fprintf(stream, "\nOptions:\n");
+    (void)fprintf(stream, "  --benchmark       Run warmup + timed iterations after verification\n");
+    (void)fprintf(stream, "  --warmup N        Warmup iterations (default: %d)\n",
+                  BENCHMARK_DEFAULT_WARMUP);
+    (void)fprintf(stream, "  --iterations N    Timed iterations, 1-%d (default: %d)\n",
+                  MAX_BENCHMARK_ITERATIONS, BENCHMARK_DEFAULT_ITERATIONS);
+    (void)fprintf(stream, "  --csv             Also write results.csv next to results.json\n");
+    (void)fprintf(stream, "  --trace           Also write trace.json (Chrome trace timeline)\n");
+    (void)fprintf(stream, "  --device-verify   Verify benchmark iterations on the device\n");
+    (void)fprintf(stream, "  --stream PATH     Stream a multi-frame raw file or frame directory\n");
+    (void)fprintf(stream, "  --frames N        Frames to stream (default: all)\n");
+    (void)fprintf(stream, "  --buffer-sets N   In-flight buffer sets, 2-%d (default: %d)\n",
+                  MAX_STREAM_BUFFER_SETS, STREAM_DEFAULT_BUFFER_SETS);
+    (void)fprintf(stream, "  --ref-threads N   C reference threads, 0 = all CPUs (default: 0)\n");
+    (void)fprintf(stream, "  --multi-device S  Split over all devices: rows or frames\n");
+    (void)fprintf(stream, "  --devices N       Devices to use, 1-%d (default: all)\n",
+                  MAX_MULTI_DEVICES);
+}
+
+/**
+ * @brief Parse a non-negative integer option value
+ *
+ * @param[in] name Option name (for error messages)
+ * @param[in] str Value string (may be NULL if missing)
+ * @param[in] max_value Largest accepted value
+ * @param[out] value Parsed value
+ * @return 0 on success, -1 on error
+ */
+static int ParseCliInt(const char* name, const char* str, int max_value, int* value) {
+    long temp_long;
+
+    if ((str == NULL) || !SafeStrtol(str, &temp_long) || (temp_long < 0) ||
+        (temp_long > (long)max_value)) {
+        (void)fprintf(stderr, "Error: %s requires an integer in [0, %d]\n", name, max_value);
+        return -1;
+    }
+    *value = (int)temp_long;
+    return 0;
+}
+
+/**
+ * @brief Parse command line into positional arguments and option flags
+ *
+ * Options may appear anywhere after the program name. Exactly two positional
+ * arguments (algorithm and variant) are required.
+ *
+ * @param[in] argc Argument count
+ * @param[in] argv Argument vector
+ * @param[out] opts Parsed options
+ * @return 0 on success, -1 on error
+ */
+static int ParseCliOptions(int argc, char** argv, CliOptions* opts) {
+    int i;
+    int positional = 0;
+
+    opts->algorithm = NULL;
+    opts->variant_selector = NULL;
+    opts->benchmark = 0;
+    opts->warmup_iterations = -1;
+    opts->iterations = -1;
+    opts->csv = 0;
+    opts->trace = 0;
+    opts->device_verify = 0;
+    opts->stream_path = NULL;
+    opts->frames = -1;
+    opts->buffer_sets = -1;
+    opts->ref_threads = -1;
+    opts->multi_device = 0;
+    opts->split = MULTI_SPLIT_ROWS;
+    opts->devices = -1;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--benchmark") == 0) {
+            opts->benchmark = 1;
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            opts->csv = 1;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            opts->trace = 1;
+        } else if (strcmp(argv[i], "--device-verify") == 0) {
+            opts->device_verify = 1;
+        } else if (strcmp(argv[i], "--warmup") == 0) {
+            if (ParseCliInt("--warmup", (i + 1 < argc) ? argv[i + 1] : NULL,
+                            MAX_BENCHMARK_ITERATIONS, &opts->warmup_iterations) != 0) {
+                return -1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--iterations") == 0) {
+            if (ParseCliInt("--iterations", (i + 1 < argc) ? argv[i + 1] : NULL,
+                            MAX_BENCHMARK_ITERATIONS, &opts->iterations) != 0) {
+                return -1;
+            }
+            if (opts->iterations < 1) {
+                (void)fprintf(stderr, "Error: --iterations must be at least 1\n");
+                return -1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            if (i + 1 >= argc) {
+                (void)fprintf(stderr, "Error: --stream requires a path\n");
+                return -1;
+            }
+            opts->stream_path = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "--frames") == 0) {
+            if (ParseCliInt("--frames", (i + 1 < argc) ? argv[i + 1] : NULL, INT_MAX,
+                            &opts->frames) != 0) {
+                return -1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--buffer-sets") == 0) {
+            if (ParseCliInt("--buffer-sets", (i + 1 < argc) ? argv[i + 1] : NULL,
+                            MAX_STREAM_BUFFER_SETS, &opts->buffer_sets) != 0) {
+                return -1;
+            }
+            if (opts->buffer_sets < 2) {
+                (void)fprintf(stderr, "Error: --buffer-sets must be at least 2\n");
+                return -1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--ref-threads") == 0) {
+            if (ParseCliInt("--ref-threads", (i + 1 < argc) ? argv[i + 1] : NULL,
+                            MAX_REF_THREADS, &opts->ref_threads) != 0) {
+                return -1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--multi-device") == 0) {
+            if ((i + 1 >= argc) || (ParseMultiDeviceSplit(argv[i + 1], &opts->split) != 0)) {
+                (void)fprintf(stderr, "Error: --multi-device requires rows or frames\n");
+                return -1;
+            }
+            opts->multi_device = 1;
+            i++;
+        } else if (strcmp(argv[i], "--devices") == 0) {
+            if (ParseCliInt("--devices", (i + 1 < argc) ? argv[i + 1] : NULL, MAX_MULTI_DEVICES,
+                            &opts->devices) != 0) {
+                return -1;
+            }
+            if (opts->devices < 1) {
+                (void)fprintf(stderr, "Error: --devices must be at least 1\n");
+                return -1;
+            }
+            i++;
+        } else if (strncmp(argv[i], "--", 2U) == 0) {
+            (void)fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+            return -1;
+        } else if (positional == 0) {
+            opts->algorithm = argv[i];
+            positional++;
+        } else if (positional == 1) {
+            opts->variant_selector = argv[i];
+            positional++;
+        } else {
+            (void)fprintf(stderr, "Error: Unexpected argument '%s'\n", argv[i]);
+            return -1;
+        }
+    }
+
+    return (positional == 2) ? 0 : -1;
+}
+
+#ifndef BUILD_ANDROID
+/**
+ * @brief Check and benchmark the shared primitives (reduce, scan, min/max, histogram)
+ *
+ * Usage: --bench-primitives [N] [--warmup N] [--iterations N], with N
+ * elements per input (default: one 1080p frame).
+ *
+ * @param[in] argc Argument count
+ * @param[in] argv Argument vector (argv[1] is --bench-primitives)
+ * @return Process exit code
+ */
+static int RunPrimitivesBenchmark(int argc, char** argv) {
+    OpenCLEnv env;
+    int count = PRIMITIVES_BENCH_DEFAULT_COUNT;
+    int warmup = BENCHMARK_DEFAULT_WARMUP;
+    int iterations = BENCHMARK_DEFAULT_ITERATIONS;
+    int result;
+    int i;
+
+    for (i = 2; i < argc; i++) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "--warmup") == 0) {
+            if (ParseCliInt("--warmup", value, MAX_BENCHMARK_ITERATIONS, &warmup) != 0) {
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--iterations") == 0) {
+            if ((ParseCliInt("--iterations", value, MAX_BENCHMARK_ITERATIONS, &iterations) !=
+                 0) ||
+                (iterations < 1)) {
+                return 1;
+            }
+            i++;
+        } else if ((i == 2) && (strncmp(argv[i], "--", 2U) != 0)) {
+            if ((ParseCliInt("elements", argv[i], INT_MAX, &count) != 0) || (count < 1)) {
+                return 1;
+            }
+        } else {
+            (void)fprintf(stderr, "Error: Unexpected argument '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    (void)printf("=== OpenCL Initialization ===\n");
+    if (OpenclInit(&env) != 0) {
+        (void)fprintf(stderr, "Failed to initialize OpenCL\n");
+        return 1;
+    }
+    result = PrimitivesBenchmark(&env, count, warmup, iterations);
+    OpenclCleanup(&env);
+    return (result == 0) ? 0 : 1;
+}
+#endif /* !BUILD_ANDROID */
+
+/**
+ * @brief Apply command line overrides on top of parsed config
+ *
+ * --warmup / --iterations imply --benchmark. --csv enables results.csv,
+ * --trace the timeline trace. --device-verify checks benchmark iterations
+ * on the device instead of reading the output back.
+ * --stream sets the frame source and enables streaming; --frames and
+ * --buffer-sets only adjust it. --ref-threads sets the C reference threads.
+ * --multi-device enables the multi-device split; --devices caps the devices.
+ *
+ * @param[in] opts Parsed command line options
+ * @param[in,out] config Configuration to update
+ */
+static void ApplyCliOverrides(const CliOptions* opts, Config* config) {
+    if (opts->benchmark != 0) {
+        config->benchmark.enabled = 1;
+    }
+    if (opts->warmup_iterations >= 0) {
+        config->benchmark.warmup_iterations = opts->warmup_iterations;
+        config->benchmark.enabled = 1;
+    }
+    if (opts->iterations > 0) {
+        config->benchmark.iterations = opts->iterations;
+        config->benchmark.enabled = 1;
+    }
+    if (opts->csv != 0) {
+        config->results.write_csv = 1;
+    }
+    if (opts->trace != 0) {
+        config->results.write_trace = 1;
+    }
+    if (opts->device_verify != 0) {
+        config->verification.on_device = 1;
+    }
+    if (opts->stream_path != NULL) {
+        (void)strncpy(config->stream.input_path, opts->stream_path,
+                      sizeof(config->stream.input_path) - 1U);
+        config->stream.input_path[sizeof(config->stream.input_path) - 1U] = '\0';
+        config->stream.enabled = 1;
+    }
+    if (opts->frames >= 0) {
+        config->stream.max_frames = opts->frames;
+    }
+    if (opts->buffer_sets > 0) {
+        config->stream.buffer_sets = opts->buffer_sets;
+    }
+    if (opts->ref_threads >= 0) {
+        config->verification.reference_threads = opts->ref_threads;
+    }
+    if (opts->multi_device != 0) {
+        config->multi_device.split = opts->split;
+        config->multi_device.enabled = 1;
+    }
+    if (opts->devices > 0) {
+        config->multi_device.max_devices = opts->devices;
+    }
+}
+
+/* Bytes of one image (channels default to 1); 0 on overflow or bad size */
+static size_t ImageBytes(int width, int height, int channels) {
+    size_t bytes;
+
+    if ((width <= 0) || (height <= 0)) {
+        return 0U;
+    }
+    bytes = (size_t)width * (size_t)height;
+    if ((channels > 1) && (bytes > (SIZE_MAX / (size_t)channels))) {
+        return 0U;
+    }
+    return (channels > 1) ? (bytes * (size_t)channels) : bytes;
+}
+
+/**
+ * @brief Largest image over all configured inputs and outputs
+ *
+ * The output buffers must fit every configured image; float outputs take
+ * four bytes per element.
+ *
+ * @param[in] config Parsed configuration (inputs.json and outputs.json)
+ * @return Size in bytes, or 0 if no valid image is configured
+ */
+static size_t MaxConfiguredImageSize(const Config* config) {
+    size_t max_bytes = 0U;
+    size_t bytes;
+    int i;
+
+    for (i = 0; i < config->input_image_count; i++) {
+        bytes = ImageBytes(config->input_images[i].src_width, config->input_images[i].src_height,
+                           config->input_images[i].src_channels);
+        if (bytes > max_bytes) {
+            max_bytes = bytes;
+        }
+    }
+    for (i = 0; i < config->output_image_count; i++) {
+        bytes = ImageBytes(config->output_images[i].dst_width,
+                           config->output_images[i].dst_height,
+                           config->output_images[i].dst_channels);
+        if (config->output_images[i].data_type == DATA_TYPE_FLOAT) {
+            bytes *= sizeof(float);
+        }
+        if (bytes > max_bytes) {
+            max_bytes = bytes;
+        }
+    }
+    return max_bytes;
+}
@@ -0,0 +1,238 @@
+/**
+ * @file autotune.c
+ * @brief Local work size autotuner implementation
+ */
+
+#include "autotune.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cache_manager.h"
+#include "kernel_args.h"
+#include "utils/config.h"
+
+/** Maximum number of candidate shapes evaluated per kernel */
+#define MAX_AUTOTUNE_CANDIDATES 128
+
+/** Maximum tuning key length */
+#define MAX_TUNE_KEY 256
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static size_t candidate_sizes[MAX_AUTOTUNE_CANDIDATES][3];
+static KernelArgPlan tune_args;
+
+/* Append src to key, mapping characters outside [A-Za-z0-9.-] to '_' */
+static void AppendKeyPart(char* key, size_t key_size, const char* src) {
+    size_t len = strlen(key);
+
+    while ((*src != '\0') && ((len + 1U) < key_size)) {
+        char c = *src;
+        if (!(((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+              ((c >= '0') && (c <= '9')) || (c == '.') || (c == '-'))) {
+            c = '_';
+        }
+        key[len] = c;
+        len++;
+        src++;
+    }
+    key[len] = '\0';
+}
+
+/* Build file-safe tuning key: <device>_<kernel file>_<function>_<WxH>_g<global> */
+static void BuildTuneKey(const OpenCLEnv* env, const KernelConfig* kernel_cfg,
+                         const OpParams* params, char* key, size_t key_size) {
+    const char* file_name;
+    char dims[96];
+    int i;
+    size_t used;
+    int written;
+
+    key[0] = '\0';
+    AppendKeyPart(key, key_size, (env->device_name[0] != '\0') ? env->device_name : "device");
+    AppendKeyPart(key, key_size, "_");
+
+    file_name = strrchr(kernel_cfg->kernel_file, '/');
+    file_name = (file_name != NULL) ? (file_name + 1) : kernel_cfg->kernel_file;
+    AppendKeyPart(key, key_size, file_name);
+    AppendKeyPart(key, key_size, "_");
+    AppendKeyPart(key, key_size, kernel_cfg->kernel_function);
+
+    written = snprintf(dims, sizeof(dims), "_%dx%d_g", params->src_width, params->src_height);
+    if ((written < 0) || ((size_t)written >= sizeof(dims))) {
+        return;
+    }
+    used = (size_t)written;
+    for (i = 0; i < kernel_cfg->work_dim; i++) {
+        written = snprintf(dims + used, sizeof(dims) - used, (i == 0) ? "%zu" : "x%zu",
+                           kernel_cfg->global_work_size[i]);
+        if ((written < 0) || ((size_t)written >= (sizeof(dims) - used))) {
+            break;
+        }
+        used += (size_t)written;
+    }
+    AppendKeyPart(key, key_size, dims);
+}
+
+/* Enumerate candidate shapes; returns number of candidates */
+static int EnumerateCandidates(const KernelConfig* kernel_cfg, size_t max_wg, size_t multiple,
+                               const size_t* max_item_sizes) {
+    size_t x;
+    size_t y;
+    size_t z;
+    size_t total;
+    int count = 0;
+    int dim = kernel_cfg->work_dim;
+    const size_t* global = kernel_cfg->global_work_size;
+
+    for (x = 1U; x <= max_item_sizes[0]; x *= 2U) {
+        for (y = 1U; y <= ((dim > 1) ? max_item_sizes[1] : 1U); y *= 2U) {
+            for (z = 1U; z <= ((dim > 2) ? max_item_sizes[2] : 1U); z *= 2U) {
+                total = x * y * z;
+                if (total > max_wg) {
+                    break;
+                }
+                if (((total % multiple) != 0U) && (total != max_wg)) {
+                    continue;
+                }
+                if (((global[0] % x) != 0U) || ((dim > 1) && ((global[1] % y) != 0U)) ||
+                    ((dim > 2) && ((global[2] % z) != 0U))) {
+                    continue;
+                }
+                if (count >= MAX_AUTOTUNE_CANDIDATES) {
+                    return count;
+                }
+                candidate_sizes[count][0] = x;
+                candidate_sizes[count][1] = y;
+                candidate_sizes[count][2] = z;
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/* Time one candidate: warmup, then minimum over timed runs */
+static int TimeCandidate(OpenCLEnv* env, cl_kernel kernel, const KernelConfig* kernel_cfg,
+                         const size_t* local, double* best_ms) {
+    double ms;
+    int run;
+
+    *best_ms = -1.0;
+    for (run = 0; run < (AUTOTUNE_WARMUP_RUNS + AUTOTUNE_TIMED_RUNS); run++) {
+        if (OpenclDispatchKernelWithLocalSize(env, kernel, kernel_cfg, local, &ms) != 0) {
+            return -1;
+        }
+        if ((run >= AUTOTUNE_WARMUP_RUNS) && ((*best_ms < 0.0) || (ms < *best_ms))) {
+            *best_ms = ms;
+        }
+    }
+    return 0;
+}
+
+int AutotuneLocalWorkSize(OpenCLEnv* env, cl_kernel kernel, const char* algorithm_id,
+                          cl_mem input_buf, cl_mem output_buf, const OpParams* params,
+                          struct KernelConfig* kernel_cfg) {
+    char tune_key[MAX_TUNE_KEY];
+    cl_int err;
+    size_t max_wg = 0U;
+    size_t multiple = 1U;
+    size_t compile_wg[3] = {0U, 0U, 0U};
+    size_t max_item_sizes[3] = {1U, 1U, 1U};
+    double best_ms = -1.0;
+    double ms;
+    int best_index = -1;
+    int count;
+    int i;
+    int d;
+
+    if ((env == NULL) || (kernel == NULL) || (algorithm_id == NULL) || (params == NULL) ||
+        (kernel_cfg == NULL) || (kernel_cfg->work_dim < 1) || (kernel_cfg->work_dim > 3)) {
+        return -1;
+    }
+
+    (void)printf("\n=== Autotuning local_work_size ===\n");
+    for (d = 0; d < 3; d++) {
+        kernel_cfg->local_work_size[d] = 0U;
+    }
+
+    /* Reuse persisted result for this (device, kernel, image size) */
+    BuildTuneKey(env, kernel_cfg, params, tune_key, sizeof(tune_key));
+    if (CacheLoadTunedLocalSize(algorithm_id, tune_key, kernel_cfg->local_work_size,
+                                kernel_cfg->work_dim) == 0) {
+        return 0;
+    }
+
+    /* Kernel compiled with reqd_work_group_size: no choice to make */
+    err = clGetKernelWorkGroupInfo(kernel, env->device, CL_KERNEL_COMPILE_WORK_GROUP_SIZE,
+                                   sizeof(compile_wg), compile_wg, NULL);
+    if ((err == CL_SUCCESS) && (compile_wg[0] != 0U)) {
+        for (d = 0; d < kernel_cfg->work_dim; d++) {
+            kernel_cfg->local_work_size[d] = compile_wg[d];
+        }
+        (void)printf("Kernel requires work-group size %zu x %zu x %zu\n", compile_wg[0],
+                     compile_wg[1], compile_wg[2]);
+        return 0;
+    }
+
+    err = clGetKernelWorkGroupInfo(kernel, env->device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(max_wg),
+                                   &max_wg, NULL);
+    if ((err != CL_SUCCESS) || (max_wg == 0U)) {
+        (void)fprintf(stderr, "Error: Failed to query CL_KERNEL_WORK_GROUP_SIZE (%d)\n", err);
+        return -1;
+    }
+    err = clGetKernelWorkGroupInfo(kernel, env->device,
+                                   CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof(multiple),
+                                   &multiple, NULL);
+    if ((err != CL_SUCCESS) || (multiple == 0U)) {
+        multiple = 1U;
+    }
+    err = clGetDeviceInfo(env->device, CL_DEVICE_MAX_WORK_ITEM_SIZES, sizeof(max_item_sizes),
+                          max_item_sizes, NULL);
+    if (err != CL_SUCCESS) {
+        max_item_sizes[0] = max_wg;
+        max_item_sizes[1] = max_wg;
+        max_item_sizes[2] = max_wg;
+    }
+
+    count = EnumerateCandidates(kernel_cfg, max_wg, multiple, max_item_sizes);
+    (void)printf("Kernel work-group limit %zu, preferred multiple %zu, %d candidates\n", max_wg,
+                 multiple, count);
+    if (count == 0) {
+        (void)printf("No legal candidates, using driver-selected local size\n");
+        return 0;
+    }
+
+    /* Candidates are timed with the real arguments, bound once for the whole sweep */
+    if ((KernelArgPlanCompile(kernel, params, kernel_cfg, NULL, &tune_args) != 0) ||
+        (KernelArgPlanBind(&tune_args, input_buf, output_buf) != 0)) {
+        (void)fprintf(stderr, "Failed to set kernel arguments for autotuning\n");
+        return -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (TimeCandidate(env, kernel, kernel_cfg, candidate_sizes[i], &ms) != 0) {
+            continue; /* Rejected by the driver (e.g., resource limits) */
+        }
+        if ((best_index < 0) || (ms < best_ms)) {
+            best_ms = ms;
+            best_index = i;
+        }
+    }
+
+    if (best_index < 0) {
+        (void)fprintf(stderr, "Warning: No candidate could be timed, using driver choice\n");
+        return 0;
+    }
+
+    for (d = 0; d < kernel_cfg->work_dim; d++) {
+        kernel_cfg->local_work_size[d] = candidate_sizes[best_index][d];
+    }
+    (void)printf("Best local_work_size: %zu x %zu x %zu (%.3f ms)\n",
+                 candidate_sizes[best_index][0], candidate_sizes[best_index][1],
+                 candidate_sizes[best_index][2], best_ms);
+
+    (void)CacheSaveTunedLocalSize(algorithm_id, tune_key, kernel_cfg->local_work_size,
+                                  kernel_cfg->work_dim);
+    return 0;
+}
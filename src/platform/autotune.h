@@ -0,0 +1,56 @@
+/**
+ * @file autotune.h
+ * @brief Local work size autotuner for "local_work_size": "auto" variants
+ *
+ * Sweeps legal work-group shapes for a kernel, times each with OpenCL
+ * profiling and keeps the fastest. The winner is persisted per
+ * (device, kernel, image size) via cache_manager so later runs reuse it
+ * without re-tuning.
+ *
+ * Candidate shapes:
+ * - Power-of-two extents per dimension, bounded by CL_DEVICE_MAX_WORK_ITEM_SIZES
+ * - Total size <= CL_KERNEL_WORK_GROUP_SIZE
+ * - Total size a multiple of CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE
+ *   (or equal to the maximum, for small kernels)
+ * - Each extent divides the global work size (OpenCL 1.x uniform work-groups)
+ * Kernels compiled with reqd_work_group_size use that size directly.
+ *
+ * NOTE: Only use "auto" for kernels that do not hardcode their work-group
+ * shape (e.g., fixed __local tile arrays). The verified run that follows
+ * tuning catches kernels that are not shape-agnostic.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: No dynamic memory allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#include "opencl_utils.h"
+
+/** Untimed dispatches per candidate before measurement */
+#define AUTOTUNE_WARMUP_RUNS 1
+
+/** Timed dispatches per candidate (minimum is kept) */
+#define AUTOTUNE_TIMED_RUNS 3
+
+/**
+ * @brief Resolve the local work size for an "auto" kernel variant
+ *
+ * Loads a persisted result if one exists for this (device, kernel, image
+ * size); otherwise sets the kernel arguments, sweeps candidates and saves
+ * the winner. On return kernel_cfg->local_work_size holds the chosen size
+ * (left at 0 = driver choice if no candidate could be timed).
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] kernel Compiled kernel
+ * @param[in] algorithm_id Algorithm identifier (cache directory)
+ * @param[in] input_buf Input buffer (for argument binding)
+ * @param[in] output_buf Output buffer (for argument binding)
+ * @param[in] params Operation parameters (image size, custom buffers)
+ * @param[in,out] kernel_cfg Variant configuration; local_work_size is written
+ * @return 0 on success (tuned or loaded), -1 on error
+ */
+int AutotuneLocalWorkSize(OpenCLEnv* env, cl_kernel kernel, const char* algorithm_id,
+                          cl_mem input_buf, cl_mem output_buf, const OpParams* params,
+                          struct KernelConfig* kernel_cfg);
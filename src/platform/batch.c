@@ -0,0 +1,216 @@
+/**
+ * @file batch.c
+ * @brief Batched NDRange execution implementation
+ */
+
+#include "batch.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "kernel_args.h"
+#include "utils/benchmark.h"
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static cl_event loop_events[MAX_BATCH_IMAGES];
+static KernelArgPlan batch_args;
+
+/* Device time of a finished kernel event (0 if unavailable), then release it */
+static double TakeKernelMs(cl_event event) {
+    double ms = 0.0;
+
+    if (event != NULL) {
+        if (OpenclGetEventDurationMs(event, &ms) != 0) {
+            ms = 0.0;
+        }
+        /* MISRA-C:2023 Rule 17.7: Check return value */
+        (void)clReleaseEvent(event);
+    }
+    return ms;
+}
+
+/**
+ * @brief One batch as N independent upload / dispatch / readback sequences
+ *
+ * Commands are non-blocking on the in-order queue; the single-image device
+ * buffers are reused, the queue order keeps the images apart.
+ */
+static int RunLoopRound(OpenCLEnv* env, cl_kernel kernel, const KernelConfig* kernel_cfg,
+                        cl_mem input_buf, cl_mem output_buf, const unsigned char* images,
+                        int count, size_t input_size, unsigned char* outputs,
+                        size_t output_size, double* kernel_ms) {
+    const size_t* local = (kernel_cfg->local_work_size[0] == 0U) ? NULL
+                                                                   : kernel_cfg->local_work_size;
+    cl_event* events = loop_events;
+    cl_int err = CL_SUCCESS;
+    int issued;
+    int i;
+
+    for (issued = 0; issued < count; issued++) {
+        events[issued] = NULL;
+        err = clEnqueueWriteBuffer(env->queue, input_buf, CL_FALSE, 0U, input_size,
+                                   images + ((size_t)issued * input_size), 0U, NULL, NULL);
+        if (err == CL_SUCCESS) {
+            err = clEnqueueNDRangeKernel(env->queue, kernel, (cl_uint)kernel_cfg->work_dim, NULL,
+                                         kernel_cfg->global_work_size, local, 0U, NULL,
+                                         &events[issued]);
+        }
+        if (err == CL_SUCCESS) {
+            err = clEnqueueReadBuffer(env->queue, output_buf, CL_FALSE, 0U, output_size,
+                                      outputs + ((size_t)issued * output_size), 0U, NULL, NULL);
+        }
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to enqueue image %d (error code: %d)\n", issued, err);
+            break;
+        }
+    }
+    /* Host memory of pending commands must outlive them, also on failure */
+    if (clFinish(env->queue) != CL_SUCCESS) {
+        err = CL_INVALID_COMMAND_QUEUE;
+    }
+
+    *kernel_ms = 0.0;
+    for (i = 0; i < issued; i++) {
+        *kernel_ms += TakeKernelMs(events[i]);
+    }
+    if ((issued < count) && (events[issued] != NULL)) {
+        (void)clReleaseEvent(events[issued]);
+    }
+    return (err == CL_SUCCESS) ? 0 : -1;
+}
+
+/**
+ * @brief One batch as a single upload, one work_dim + 1 dispatch and a single readback
+ */
+static int RunBatchedRound(OpenCLEnv* env, cl_kernel kernel, const KernelConfig* kernel_cfg,
+                           cl_mem input_buf, cl_mem output_buf, const unsigned char* images,
+                           int count, size_t input_size, unsigned char* outputs,
+                           size_t output_size, double* kernel_ms) {
+    size_t global[3];
+    size_t local[3];
+    cl_uint dims = (cl_uint)kernel_cfg->work_dim + 1U;
+    cl_event event = NULL;
+    cl_int err;
+    int d;
+
+    for (d = 0; d < kernel_cfg->work_dim; d++) {
+        global[d] = kernel_cfg->global_work_size[d];
+        local[d] = kernel_cfg->local_work_size[d];
+    }
+    /* The batch dimension: one image per index, one image per work-group */
+    global[kernel_cfg->work_dim] = (size_t)count;
+    local[kernel_cfg->work_dim] = 1U;
+
+    err = clEnqueueWriteBuffer(env->queue, input_buf, CL_FALSE, 0U, (size_t)count * input_size,
+                               images, 0U, NULL, NULL);
+    if (err == CL_SUCCESS) {
+        err = clEnqueueNDRangeKernel(env->queue, kernel, dims, NULL, global,
+                                     (kernel_cfg->local_work_size[0] == 0U) ? NULL : local, 0U,
+                                     NULL, &event);
+    }
+    if (err == CL_SUCCESS) {
+        err = clEnqueueReadBuffer(env->queue, output_buf, CL_FALSE, 0U,
+                                  (size_t)count * output_size, outputs, 0U, NULL, NULL);
+    }
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to enqueue the batch (error code: %d)\n", err);
+    }
+    if (clFinish(env->queue) != CL_SUCCESS) {
+        err = CL_INVALID_COMMAND_QUEUE;
+    }
+    *kernel_ms = TakeKernelMs(event);
+    return (err == CL_SUCCESS) ? 0 : -1;
+}
+
+int BatchRun(OpenCLEnv* env, cl_kernel kernel, const KernelConfig* kernel_cfg,
+             const OpParams* params, const unsigned char* images, int count, size_t input_size,
+             unsigned char* loop_outputs, unsigned char* batch_outputs, size_t output_size,
+             int rounds, BatchResult* result) {
+    cl_mem input_buf = NULL;
+    cl_mem output_buf = NULL;
+    double kernel_ms;
+    double start_ms;
+    int round;
+    int status = -1;
+
+    if ((env == NULL) || (kernel == NULL) || (kernel_cfg == NULL) || (params == NULL) ||
+        (images == NULL) || (loop_outputs == NULL) || (result == NULL) || (count < 1) ||
+        (count > MAX_BATCH_IMAGES) || (rounds < 1) ||
+        ((kernel_cfg->batch != 0) && (batch_outputs == NULL))) {
+        return -1;
+    }
+    (void)memset(result, 0, sizeof(*result));
+    result->images = count;
+    result->rounds = rounds;
+
+    /* Both passes share the scalars; only the buffers change between them */
+    if (KernelArgPlanCompile(kernel, params, kernel_cfg, NULL, &batch_args) != 0) {
+        return -1;
+    }
+
+    /* Pass 1: per-image dispatches through single-image buffers */
+    input_buf = OpenclCreateBuffer(env->context, CL_MEM_READ_ONLY, input_size, NULL,
+                                   "batch image input");
+    output_buf = OpenclCreateBuffer(env->context, CL_MEM_WRITE_ONLY, output_size, NULL,
+                                    "batch image output");
+    if ((input_buf == NULL) || (output_buf == NULL) ||
+        (KernelArgPlanBind(&batch_args, input_buf, output_buf) != 0)) {
+        goto cleanup;
+    }
+    for (round = 0; round <= rounds; round++) {
+        start_ms = BenchmarkNowMs();
+        if (RunLoopRound(env, kernel, kernel_cfg, input_buf, output_buf, images, count,
+                         input_size, loop_outputs, output_size, &kernel_ms) != 0) {
+            goto cleanup;
+        }
+        /* Round 0 is the warmup */
+        if (round > 0) {
+            result->loop_ms += BenchmarkNowMs() - start_ms;
+            result->loop_kernel_ms += kernel_ms;
+        }
+    }
+    OpenclReleaseMemObject(input_buf, "batch image input");
+    OpenclReleaseMemObject(output_buf, "batch image output");
+    input_buf = NULL;
+    output_buf = NULL;
+    result->loop_ms /= (double)rounds;
+    result->loop_kernel_ms /= (double)rounds;
+    result->loop_ips = (result->loop_ms > 0.0) ? ((double)count * 1000.0 / result->loop_ms) : 0.0;
+
+    /* Pass 2: one dispatch over the packed batch */
+    if (kernel_cfg->batch == 0) {
+        status = 0;
+        goto cleanup;
+    }
+    input_buf = OpenclCreateBuffer(env->context, CL_MEM_READ_ONLY, (size_t)count * input_size,
+                                   NULL, "batch input");
+    output_buf = OpenclCreateBuffer(env->context, CL_MEM_WRITE_ONLY,
+                                    (size_t)count * output_size, NULL, "batch output");
+    if ((input_buf == NULL) || (output_buf == NULL) ||
+        (KernelArgPlanBind(&batch_args, input_buf, output_buf) != 0)) {
+        goto cleanup;
+    }
+    for (round = 0; round <= rounds; round++) {
+        start_ms = BenchmarkNowMs();
+        if (RunBatchedRound(env, kernel, kernel_cfg, input_buf, output_buf, images, count,
+                            input_size, batch_outputs, output_size, &kernel_ms) != 0) {
+            goto cleanup;
+        }
+        if (round > 0) {
+            result->batch_ms += BenchmarkNowMs() - start_ms;
+            result->batch_kernel_ms += kernel_ms;
+        }
+    }
+    result->batched = 1;
+    result->batch_ms /= (double)rounds;
+    result->batch_kernel_ms /= (double)rounds;
+    result->batch_ips =
+        (result->batch_ms > 0.0) ? ((double)count * 1000.0 / result->batch_ms) : 0.0;
+    status = 0;
+
+cleanup:
+    /* MISRA-C:2023 Rule 22.1: Proper resource management */
+    OpenclReleaseMemObject(input_buf, "batch input");
+    OpenclReleaseMemObject(output_buf, "batch output");
+    return status;
+}
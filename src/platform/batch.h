@@ -0,0 +1,69 @@
+/**
+ * @file batch.h
+ * @brief Batched NDRange execution over many small images of one shape
+ *
+ * An input declared with "batch": N in inputs.json holds N images of the
+ * same shape back to back. Launch overhead dominates when each small image
+ * gets its own upload, dispatch and readback, so batch mode compares two
+ * passes over the whole batch:
+ *
+ *   per image: write image i, run the kernel, read output i (N dispatches)
+ *   batched:   write all images into one contiguous buffer, run one
+ *              dispatch with an extra dimension of size N, read all outputs
+ *
+ * Only kernels marked "batch": true run the batched pass. They take the
+ * image index from get_global_id(work_dim) and offset their input and
+ * output by it; in the ordinary single-image run that dimension does not
+ * exist, get_global_id() returns 0 and the kernel processes image 0.
+ * Outputs land packed in the host buffer, one image after the other.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: No dynamic allocation (host storage comes from the caller)
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#include "opencl_utils.h"
+#include "utils/config.h"
+
+/**
+ * @brief Outcome of a batch run (times are means over the timed rounds)
+ */
+typedef struct {
+    int images;            /**< Images per batch */
+    int rounds;            /**< Timed rounds of each pass (after one warmup round) */
+    double loop_ms;        /**< Per-image pass: host wall-clock per batch */
+    double loop_kernel_ms; /**< Per-image pass: device time of the N kernels per batch */
+    double loop_ips;       /**< Per-image pass: images per second */
+    int batched;           /**< Non-zero if the single-dispatch pass ran */
+    double batch_ms;       /**< Batched pass: host wall-clock per batch */
+    double batch_kernel_ms; /**< Batched pass: device time of the one kernel */
+    double batch_ips;      /**< Batched pass: images per second */
+} BatchResult;
+
+/**
+ * @brief Run a batch of images through an already verified kernel
+ *
+ * Custom buffers and scalars come from params and are shared by every
+ * image. Device buffers are packed (params must carry packed strides).
+ * Each pass reads back into its own host storage, so both can be checked.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] kernel Built kernel
+ * @param[in] kernel_cfg Kernel configuration (arguments and per-image work sizes)
+ * @param[in] params Operation parameters of one image
+ * @param[in] images Input images back to back
+ * @param[in] count Images in the batch
+ * @param[in] input_size Bytes per input image
+ * @param[out] loop_outputs Per-image pass outputs back to back (count * output_size bytes)
+ * @param[out] batch_outputs Batched pass outputs (same size; unused without "batch": true)
+ * @param[in] output_size Bytes per output image
+ * @param[in] rounds Timed rounds of each pass (>= 1)
+ * @param[out] result Throughput of both passes
+ * @return 0 on success, -1 on error
+ */
+int BatchRun(OpenCLEnv* env, cl_kernel kernel, const KernelConfig* kernel_cfg,
+             const OpParams* params, const unsigned char* images, int count, size_t input_size,
+             unsigned char* loop_outputs, unsigned char* batch_outputs, size_t output_size,
+             int rounds, BatchResult* result);
@@ -0,0 +1,215 @@
+/**
+ * @file buffer_pool.c
+ * @brief Per-process pool of device buffers implementation
+ */
+
+#include "buffer_pool.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/** One buffer owned by the pool */
+typedef struct {
+    cl_mem buffer;         /**< Buffer object (NULL = free slot) */
+    cl_context context;    /**< Context it belongs to */
+    cl_mem_flags flags;    /**< Creation flags */
+    size_t class_bytes;    /**< Allocated size (size class) */
+    size_t requested;      /**< Size requested by the current user */
+    int in_use;            /**< Non-zero while handed out */
+    unsigned long release; /**< Release tick, for oldest-idle eviction */
+} PooledBuffer;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static PooledBuffer pool[MAX_POOL_BUFFERS];
+static BufferPoolStats stats;
+static unsigned long release_tick = 0UL;
+
+/* Size class: 4 KB minimum, then steps of a quarter of the enclosing power of two */
+static size_t SizeClass(size_t size) {
+    size_t power = POOL_MIN_CLASS_BYTES;
+    size_t step;
+
+    if (size <= POOL_MIN_CLASS_BYTES) {
+        return POOL_MIN_CLASS_BYTES;
+    }
+    while ((power <= (size / 2U)) && (power < ((size_t)1 << ((sizeof(size_t) * 8U) - 2U)))) {
+        power *= 2U;
+    }
+    step = power / 4U;
+    return ((size + step - 1U) / step) * step;
+}
+
+/* Release one pool entry's buffer and update the counters */
+static void FreeEntry(PooledBuffer* entry) {
+    cl_int err;
+
+    err = clReleaseMemObject(entry->buffer);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Warning: Failed to release pooled buffer (error: %d)\n", err);
+    }
+    stats.device_bytes -= entry->class_bytes;
+    if (entry->in_use != 0) {
+        stats.in_use_bytes -= entry->requested;
+    }
+    stats.buffers--;
+    (void)memset(entry, 0, sizeof(*entry));
+}
+
+/* Find the entry holding @p buffer */
+static PooledBuffer* FindEntry(cl_mem buffer) {
+    int i;
+
+    if (buffer == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < MAX_POOL_BUFFERS; i++) {
+        if (pool[i].buffer == buffer) {
+            return &pool[i];
+        }
+    }
+    return NULL;
+}
+
+/* Free slot for a new buffer; evicts the longest-idle buffer when full */
+static PooledBuffer* FreeSlot(void) {
+    PooledBuffer* oldest = NULL;
+    int i;
+
+    for (i = 0; i < MAX_POOL_BUFFERS; i++) {
+        if (pool[i].buffer == NULL) {
+            return &pool[i];
+        }
+        if ((pool[i].in_use == 0) && ((oldest == NULL) || (pool[i].release < oldest->release))) {
+            oldest = &pool[i];
+        }
+    }
+    if (oldest != NULL) {
+        FreeEntry(oldest);
+    }
+    return oldest;
+}
+
+int BufferPoolAccepts(cl_mem_flags flags, const void* host_ptr) {
+    return ((host_ptr == NULL) &&
+            ((flags & (CL_MEM_USE_HOST_PTR | CL_MEM_COPY_HOST_PTR)) == 0U))
+               ? 1
+               : 0;
+}
+
+cl_mem BufferPoolAcquire(cl_context context, cl_mem_flags flags, size_t size,
+                         cl_int* errcode_ret) {
+    PooledBuffer* entry = NULL;
+    size_t class_bytes;
+    cl_int err;
+    cl_mem buffer;
+    int i;
+
+    if ((context == NULL) || (size == 0U) || (BufferPoolAccepts(flags, NULL) == 0)) {
+        if (errcode_ret != NULL) {
+            *errcode_ret = CL_INVALID_VALUE;
+        }
+        return NULL;
+    }
+
+    class_bytes = SizeClass(size);
+    stats.acquires++;
+
+    for (i = 0; i < MAX_POOL_BUFFERS; i++) {
+        if ((pool[i].buffer != NULL) && (pool[i].in_use == 0) && (pool[i].context == context) &&
+            (pool[i].flags == flags) && (pool[i].class_bytes == class_bytes)) {
+            entry = &pool[i];
+            stats.hits++;
+            break;
+        }
+    }
+
+    if (entry == NULL) {
+        buffer = clCreateBuffer(context, flags, class_bytes, NULL, &err);
+        if (err != CL_SUCCESS) {
+            if (errcode_ret != NULL) {
+                *errcode_ret = err;
+            }
+            return NULL;
+        }
+        entry = FreeSlot();
+        if (entry == NULL) {
+            /* Every slot in use: hand out an unpooled buffer of the exact class size */
+            if (errcode_ret != NULL) {
+                *errcode_ret = CL_SUCCESS;
+            }
+            return buffer;
+        }
+        entry->buffer = buffer;
+        entry->context = context;
+        entry->flags = flags;
+        entry->class_bytes = class_bytes;
+        stats.device_bytes += class_bytes;
+        stats.buffers++;
+        if (stats.device_bytes > stats.peak_bytes) {
+            stats.peak_bytes = stats.device_bytes;
+        }
+    }
+
+    entry->in_use = 1;
+    entry->requested = size;
+    stats.in_use_bytes += size;
+    if (stats.in_use_bytes > stats.peak_in_use) {
+        stats.peak_in_use = stats.in_use_bytes;
+    }
+    if (errcode_ret != NULL) {
+        *errcode_ret = CL_SUCCESS;
+    }
+    return entry->buffer;
+}
+
+int BufferPoolRelease(cl_mem buffer) {
+    PooledBuffer* entry = FindEntry(buffer);
+
+    if (entry == NULL) {
+        return 0;
+    }
+    if (entry->in_use != 0) {
+        stats.in_use_bytes -= entry->requested;
+        entry->in_use = 0;
+        entry->requested = 0U;
+        release_tick++;
+        entry->release = release_tick;
+    }
+    return 1;
+}
+
+size_t BufferPoolRequestedSize(cl_mem buffer) {
+    const PooledBuffer* entry = FindEntry(buffer);
+
+    return ((entry != NULL) && (entry->in_use != 0)) ? entry->requested : 0U;
+}
+
+void BufferPoolGetStats(BufferPoolStats* out) {
+    if (out != NULL) {
+        *out = stats;
+    }
+}
+
+void BufferPoolPrintStats(void) {
+    if (stats.acquires == 0UL) {
+        return;
+    }
+    (void)printf("Buffer pool: %lu request(s), %lu reused (%.0f%% hit rate), peak %.2f MB "
+                 "allocated / %.2f MB in use\n",
+                 stats.acquires, stats.hits,
+                 100.0 * (double)stats.hits / (double)stats.acquires,
+                 (double)stats.peak_bytes / (1024.0 * 1024.0),
+                 (double)stats.peak_in_use / (1024.0 * 1024.0));
+}
+
+void BufferPoolReleaseAll(void) {
+    int i;
+
+    for (i = 0; i < MAX_POOL_BUFFERS; i++) {
+        if (pool[i].buffer != NULL) {
+            FreeEntry(&pool[i]);
+        }
+    }
+    (void)memset(&stats, 0, sizeof(stats));
+    release_tick = 0UL;
+}
@@ -13,12 +13,12 @@
 #include <sys/types.h>
 #include <time.h>
 
+#include "utils/mapped_file.h"
+
 /* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
 #define MAX_KERNEL_BINARY_SIZE (10 * 1024 * 1024) /* 10MB max */
-#define MAX_GOLDEN_SAMPLE_SIZE (4096 * 4096)      /* 16MB max */
 
 static unsigned char kernel_binary_buffer[MAX_KERNEL_BINARY_SIZE];
-static unsigned char golden_sample_buffer[MAX_GOLDEN_SAMPLE_SIZE];
 
 /* Global storage for current run directory (set by CacheInit) */
 static char current_run_dir[MAX_CACHE_PATH] = {0};
@@ -63,6 +63,7 @@ static int BuildAlgorithmDir(const char* algorithm_id, const char* variant_id, c
 }
 
 /* Helper function to construct kernel cache file path */
+/* Kernel binaries persist across runs in out/{algorithm}/ (not the timestamped run dir) */
 static int BuildKernelCachePath(const char* algorithm_id, const char* kernel_name, char* path,
                                 size_t path_size) {
     int result;
@@ -71,13 +72,7 @@ static int BuildKernelCachePath(const char* algorithm_id, const char* kernel_nam
         return -1;
     }
 
-    /* Use current run directory if available, otherwise fall back to algorithm_id */
-    if (current_run_dir[0] != '\0') {
-        result = snprintf(path, path_size, "%s/%s.bin", current_run_dir, kernel_name);
-    } else {
-        result =
-            snprintf(path, path_size, "%s/%s/%s.bin", CACHE_BASE_DIR, algorithm_id, kernel_name);
-    }
+    result = snprintf(path, path_size, "%s/%s/%s.bin", CACHE_BASE_DIR, algorithm_id, kernel_name);
 
     if ((result < 0) || ((size_t)result >= path_size)) {
         return -1;
@@ -86,8 +81,25 @@ static int BuildKernelCachePath(const char* algorithm_id, const char* kernel_nam
     return 0;
 }
 
-/* Helper function to construct golden sample cache file path */
-static int BuildGoldenCachePath(const char* algorithm_id, char* path, size_t path_size) {
+/* Helper function to create out/{algorithm}/ for persistent cache entries */
+static int EnsureAlgorithmCacheDir(const char* algorithm_id) {
+    char algo_dir[MAX_CACHE_PATH];
+    int result;
+
+    result = snprintf(algo_dir, sizeof(algo_dir), "%s/%s", CACHE_BASE_DIR, algorithm_id);
+    if ((result < 0) || ((size_t)result >= sizeof(algo_dir))) {
+        return -1;
+    }
+
+    /* MISRA-C:2023 Rule 17.7: mkdir fails if the directory exists, which is okay */
+    (void)mkdir(CACHE_BASE_DIR, 0755);
+    (void)mkdir(algo_dir, 0755);
+    return 0;
+}
+
+/* Helper function to construct golden sample cache file path (one file per named output) */
+static int BuildGoldenCachePath(const char* algorithm_id, const char* output_name, char* path,
+                                size_t path_size) {
     int result;
 
     if ((algorithm_id == NULL) || (path == NULL) || (path_size == 0U)) {
@@ -95,8 +107,13 @@ static int BuildGoldenCachePath(const char* algorithm_id, char* path, size_t pat
     }
 
     /* Use current run directory if available, otherwise fall back to algorithm_id */
-    if (current_run_dir[0] != '\0') {
+    if ((current_run_dir[0] != '\0') && (output_name != NULL)) {
+        result = snprintf(path, path_size, "%s/golden_%s.bin", current_run_dir, output_name);
+    } else if (current_run_dir[0] != '\0') {
         result = snprintf(path, path_size, "%s/golden.bin", current_run_dir);
+    } else if (output_name != NULL) {
+        result = snprintf(path, path_size, "%s/%s/%s_%s.bin", CACHE_BASE_DIR, algorithm_id,
+                          algorithm_id, output_name);
     } else {
         result =
             snprintf(path, path_size, "%s/%s/%s.bin", CACHE_BASE_DIR, algorithm_id, algorithm_id);
@@ -199,7 +216,8 @@ int CacheSaveKernelBinary(cl_program program, cl_device_id device, const char* a
     }
 
     /* Build cache file path */
-    if (BuildKernelCachePath(algorithm_id, kernel_name, cache_path, sizeof(cache_path)) != 0) {
+    if ((BuildKernelCachePath(algorithm_id, kernel_name, cache_path, sizeof(cache_path)) != 0) ||
+        (EnsureAlgorithmCacheDir(algorithm_id) != 0)) {
         (void)fprintf(stderr, "Error: Failed to build cache path\n");
         return -1;
     }
@@ -227,76 +245,76 @@ int CacheSaveKernelBinary(cl_program program, cl_device_id device, const char* a
     return 0;
 }
 
-cl_program CacheLoadKernelBinary(cl_context context, cl_device_id device, const char* algorithm_id,
-                                 const char* kernel_name) {
-    char cache_path[MAX_CACHE_PATH];
+/* Read a whole binary file into kernel_binary_buffer */
+static int ReadBinaryFile(const char* path, size_t* binary_size) {
     FILE* fp;
     long file_size;
     size_t read_size;
-    size_t binary_size;
-    const unsigned char* binary_ptr;
-    cl_int binary_status;
-    cl_int err;
-    cl_program program;
 
-    if ((context == NULL) || (algorithm_id == NULL) || (kernel_name == NULL)) {
-        return NULL;
-    }
-
-    /* Build cache file path */
-    if (BuildKernelCachePath(algorithm_id, kernel_name, cache_path, sizeof(cache_path)) != 0) {
-        (void)fprintf(stderr, "Error: Failed to build cache path\n");
-        return NULL;
-    }
-
-    /* Open file */
-    fp = fopen(cache_path, "rb");
+    fp = fopen(path, "rb");
     if (fp == NULL) {
-        (void)fprintf(stderr, "Error: Failed to open kernel cache file: %s\n", cache_path);
-        return NULL;
+        (void)fprintf(stderr, "Error: Failed to open kernel binary file: %s\n", path);
+        return -1;
     }
 
     /* Get file size */
     if (fseek(fp, 0, SEEK_END) != 0) {
-        (void)fprintf(stderr, "Error: Failed to seek in cache file\n");
+        (void)fprintf(stderr, "Error: Failed to seek in kernel binary file\n");
         (void)fclose(fp);
-        return NULL;
+        return -1;
     }
 
     file_size = ftell(fp);
-    if (file_size < 0) {
-        (void)fprintf(stderr, "Error: Failed to get cache file size\n");
+    if (file_size <= 0) {
+        (void)fprintf(stderr, "Error: Failed to get kernel binary file size\n");
         (void)fclose(fp);
-        return NULL;
+        return -1;
     }
 
-    binary_size = (size_t)file_size;
-    if (binary_size > MAX_KERNEL_BINARY_SIZE) {
-        (void)fprintf(stderr, "Error: Cached binary too large (%zu bytes)\n", binary_size);
+    *binary_size = (size_t)file_size;
+    if (*binary_size > MAX_KERNEL_BINARY_SIZE) {
+        (void)fprintf(stderr, "Error: Kernel binary too large (%zu bytes)\n", *binary_size);
         (void)fclose(fp);
-        return NULL;
+        return -1;
     }
 
     if (fseek(fp, 0, SEEK_SET) != 0) {
-        (void)fprintf(stderr, "Error: Failed to rewind cache file\n");
+        (void)fprintf(stderr, "Error: Failed to rewind kernel binary file\n");
         (void)fclose(fp);
-        return NULL;
+        return -1;
     }
 
     /* Read binary data */
-    read_size = fread(kernel_binary_buffer, 1U, binary_size, fp);
-    if (read_size != binary_size) {
+    read_size = fread(kernel_binary_buffer, 1U, *binary_size, fp);
+    if (read_size != *binary_size) {
         (void)fprintf(stderr, "Error: Failed to read kernel binary (%zu of %zu bytes)\n", read_size,
-                      binary_size);
+                      *binary_size);
         (void)fclose(fp);
-        return NULL;
+        return -1;
     }
 
     if (fclose(fp) != 0) {
-        (void)fprintf(stderr, "Warning: Failed to close cache file\n");
+        (void)fprintf(stderr, "Warning: Failed to close kernel binary file\n");
+    }
+    return 0;
+}
+
+cl_program CacheLoadProgramBinary(cl_context context, cl_device_id device, const char* path) {
+    size_t binary_size;
+    const unsigned char* binary_ptr;
+    cl_int binary_status;
+    cl_int err;
+    cl_program program;
+
+    if ((context == NULL) || (path == NULL)) {
+        return NULL;
+    }
+
+    if (ReadBinaryFile(path, &binary_size) != 0) {
+        return NULL;
     }
 
-    (void)printf("Loaded cached kernel binary (%zu bytes): %s\n", binary_size, cache_path);
+    (void)printf("Loaded kernel binary (%zu bytes): %s\n", binary_size, path);
 
     /* Create program from binary */
     binary_ptr = kernel_binary_buffer;
@@ -305,266 +323,159 @@ cl_program CacheLoadKernelBinary(cl_context context, cl_device_id device, const
     if ((err != CL_SUCCESS) || (binary_status != CL_SUCCESS)) {
         (void)fprintf(stderr, "Error: Failed to create program from binary (err=%d, status=%d)\n",
                       err, binary_status);
+        if (program != NULL) {
+            (void)clReleaseProgram(program);
+        }
         return NULL;
     }
 
     /* Build the program (required even for binaries) */
     err = clBuildProgram(program, 1U, &device, NULL, NULL, NULL);
     if (err != CL_SUCCESS) {
-        (void)fprintf(stderr, "Error: Failed to build cached binary (error: %d)\n", err);
+        (void)fprintf(stderr, "Error: Failed to build kernel binary (error: %d)\n", err);
         (void)clReleaseProgram(program);
         return NULL;
     }
-
-    (void)printf("Kernel binary loaded from cache successfully\n");
     return program;
 }
 
+cl_program CacheLoadKernelBinary(cl_context context, cl_device_id device, const char* algorithm_id,
+                                 const char* kernel_name) {
+    char cache_path[MAX_CACHE_PATH];
+    cl_program program;
 
-int CacheSaveCustomBinary(CLExtensionContext* ctx) {
-    return 0;
-}
-
-/* ============================================================================
- * SOURCE HASH FOR CACHE INVALIDATION
- * ============================================================================
- */
-
-/* Helper function to construct hash cache file path */
-static int BuildHashCachePath(const char* algorithm_id, const char* kernel_name, char* path,
-                              size_t path_size) {
-    int result;
-
-    if ((algorithm_id == NULL) || (kernel_name == NULL) || (path == NULL) || (path_size == 0U)) {
-        return -1;
-    }
-
-    /* Use current run directory if available, otherwise fall back to algorithm_id */
-    if (current_run_dir[0] != '\0') {
-        result = snprintf(path, path_size, "%s/%s.hash", current_run_dir, kernel_name);
-    } else {
-        result =
-            snprintf(path, path_size, "%s/%s/%s.hash", CACHE_BASE_DIR, algorithm_id, kernel_name);
-    }
-
-    if ((result < 0) || ((size_t)result >= path_size)) {
-        return -1;
+    if ((context == NULL) || (algorithm_id == NULL) || (kernel_name == NULL)) {
+        return NULL;
     }
 
-    return 0;
-}
-
-/*
- * FNV-1a hash implementation (MISRA-C compliant, no external dependencies)
- * We use multiple rounds of 32-bit FNV-1a to fill CACHE_HASH_SIZE bytes
- */
-#define FNV_OFFSET_BASIS 2166136261U
-#define FNV_PRIME 16777619U
-
-static void ComputeFnv1aHash(const unsigned char* data, size_t length, unsigned char* hash_out) {
-    size_t i;
-    size_t round;
-    uint32_t hash;
-    size_t hash_index;
-
-    /* Initialize hash output to zero */
-    for (i = 0U; i < CACHE_HASH_SIZE; i++) {
-        hash_out[i] = 0U;
+    /* Build cache file path */
+    if (BuildKernelCachePath(algorithm_id, kernel_name, cache_path, sizeof(cache_path)) != 0) {
+        (void)fprintf(stderr, "Error: Failed to build cache path\n");
+        return NULL;
     }
 
-    /* Compute multiple rounds of FNV-1a to fill the hash buffer */
-    /* Each round uses a different offset to produce different hash values */
-    for (round = 0U; round < (CACHE_HASH_SIZE / 4U); round++) {
-        hash = FNV_OFFSET_BASIS + (uint32_t)(round * 0x9E3779B9U); /* Golden ratio offset */
-
-        for (i = 0U; i < length; i++) {
-            hash ^= (uint32_t)data[i];
-            hash *= FNV_PRIME;
-        }
-
-        /* Store this round's hash (4 bytes, little-endian) */
-        hash_index = round * 4U;
-        hash_out[hash_index] = (unsigned char)(hash & 0xFFU);
-        hash_out[hash_index + 1U] = (unsigned char)((hash >> 8U) & 0xFFU);
-        hash_out[hash_index + 2U] = (unsigned char)((hash >> 16U) & 0xFFU);
-        hash_out[hash_index + 3U] = (unsigned char)((hash >> 24U) & 0xFFU);
+    program = CacheLoadProgramBinary(context, device, cache_path);
+    if (program != NULL) {
+        (void)printf("Kernel binary loaded from cache successfully\n");
     }
+    return program;
 }
 
-int CacheComputeSourceHash(const char* source_file, unsigned char* hash_out) {
+int CacheExportKernelBinary(const char* algorithm_id, const char* kernel_name,
+                            const char* dest_path) {
+    char cache_path[MAX_CACHE_PATH];
+    size_t binary_size;
+    size_t written;
     FILE* fp;
-    long file_size;
-    size_t read_size;
-
-    if ((source_file == NULL) || (hash_out == NULL)) {
-        return -1;
-    }
-
-    /* Open source file */
-    fp = fopen(source_file, "rb");
-    if (fp == NULL) {
-        (void)fprintf(stderr, "Error: Failed to open source file for hashing: %s\n", source_file);
-        return -1;
-    }
-
-    /* Get file size */
-    if (fseek(fp, 0, SEEK_END) != 0) {
-        (void)fprintf(stderr, "Error: Failed to seek in source file\n");
-        (void)fclose(fp);
-        return -1;
-    }
 
-    file_size = ftell(fp);
-    if (file_size < 0) {
-        (void)fprintf(stderr, "Error: Failed to get source file size\n");
-        (void)fclose(fp);
+    if ((algorithm_id == NULL) || (kernel_name == NULL) || (dest_path == NULL)) {
         return -1;
     }
 
-    if ((size_t)file_size > MAX_KERNEL_BINARY_SIZE) {
-        (void)fprintf(stderr, "Error: Source file too large for hashing (%ld bytes)\n", file_size);
-        (void)fclose(fp);
+    if ((BuildKernelCachePath(algorithm_id, kernel_name, cache_path, sizeof(cache_path)) != 0) ||
+        (ReadBinaryFile(cache_path, &binary_size) != 0)) {
         return -1;
     }
 
-    if (fseek(fp, 0, SEEK_SET) != 0) {
-        (void)fprintf(stderr, "Error: Failed to rewind source file\n");
-        (void)fclose(fp);
+    fp = fopen(dest_path, "wb");
+    if (fp == NULL) {
+        (void)fprintf(stderr, "Error: Failed to create %s\n", dest_path);
         return -1;
     }
 
-    /* Read file into buffer (reuse kernel_binary_buffer) */
-    read_size = fread(kernel_binary_buffer, 1U, (size_t)file_size, fp);
-    if (read_size != (size_t)file_size) {
-        (void)fprintf(stderr, "Error: Failed to read source file (%zu of %ld bytes)\n", read_size,
-                      file_size);
+    written = fwrite(kernel_binary_buffer, 1U, binary_size, fp);
+    if (written != binary_size) {
+        (void)fprintf(stderr, "Error: Failed to write kernel binary (%zu of %zu bytes)\n", written,
+                      binary_size);
         (void)fclose(fp);
         return -1;
     }
 
     if (fclose(fp) != 0) {
-        (void)fprintf(stderr, "Warning: Failed to close source file\n");
+        (void)fprintf(stderr, "Warning: Failed to close %s\n", dest_path);
     }
-
-    /* Compute hash */
-    ComputeFnv1aHash(kernel_binary_buffer, read_size, hash_out);
-
     return 0;
 }
 
-int CacheSaveSourceHash(const char* algorithm_id, const char* kernel_name,
-                        const unsigned char* hash) {
-    char hash_path[MAX_CACHE_PATH];
-    FILE* fp;
-    size_t written;
-
-    if ((algorithm_id == NULL) || (kernel_name == NULL) || (hash == NULL)) {
-        return -1;
-    }
-
-    /* Build hash file path */
-    if (BuildHashCachePath(algorithm_id, kernel_name, hash_path, sizeof(hash_path)) != 0) {
-        (void)fprintf(stderr, "Error: Failed to build hash cache path\n");
-        return -1;
-    }
-
-    /* Save to file */
-    fp = fopen(hash_path, "wb");
-    if (fp == NULL) {
-        (void)fprintf(stderr, "Error: Failed to create hash cache file: %s\n", hash_path);
-        return -1;
-    }
-
-    written = fwrite(hash, 1U, CACHE_HASH_SIZE, fp);
-    if (written != CACHE_HASH_SIZE) {
-        (void)fprintf(stderr, "Error: Failed to write hash (%zu of %d bytes)\n", written,
-                      CACHE_HASH_SIZE);
-        (void)fclose(fp);
-        return -1;
-    }
-
-    if (fclose(fp) != 0) {
-        (void)fprintf(stderr, "Warning: Failed to close hash cache file\n");
-    }
-
-    (void)printf("Source hash saved: %s\n", hash_path);
+int CacheSaveCustomBinary(CLExtensionContext* ctx) {
     return 0;
 }
 
-int CacheLoadSourceHash(const char* algorithm_id, const char* kernel_name,
-                        unsigned char* hash_out) {
-    char hash_path[MAX_CACHE_PATH];
-    FILE* fp;
-    size_t read_size;
+/* ============================================================================
+ * BUILD KEY HASH
+ * ============================================================================
+ */
 
-    if ((algorithm_id == NULL) || (kernel_name == NULL) || (hash_out == NULL)) {
-        return -1;
-    }
+/*
+ * FNV-1a hash implementation (MISRA-C compliant, no external dependencies)
+ * We use multiple rounds of 32-bit FNV-1a to fill CACHE_HASH_SIZE bytes
+ */
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
 
-    /* Build hash file path */
-    if (BuildHashCachePath(algorithm_id, kernel_name, hash_path, sizeof(hash_path)) != 0) {
-        return -1;
-    }
+void CacheHashInit(CacheHashState* state) {
+    size_t round;
 
-    /* Open file */
-    fp = fopen(hash_path, "rb");
-    if (fp == NULL) {
-        /* Hash file doesn't exist - this is expected for first run */
-        return -1;
+    /* Each round uses a different offset to produce different hash values */
+    for (round = 0U; round < (CACHE_HASH_SIZE / 4U); round++) {
+        state->rounds[round] = FNV_OFFSET_BASIS + (uint32_t)(round * 0x9E3779B9U); /* Golden ratio */
     }
+}
 
-    /* Read hash data */
-    read_size = fread(hash_out, 1U, CACHE_HASH_SIZE, fp);
-    if (read_size != CACHE_HASH_SIZE) {
-        (void)fprintf(stderr, "Error: Failed to read hash file (%zu of %d bytes)\n", read_size,
-                      CACHE_HASH_SIZE);
-        (void)fclose(fp);
-        return -1;
-    }
+void CacheHashUpdate(CacheHashState* state, const void* data, size_t length) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    size_t i;
+    size_t round;
+    uint32_t hash;
 
-    if (fclose(fp) != 0) {
-        (void)fprintf(stderr, "Warning: Failed to close hash file\n");
+    for (round = 0U; round < (CACHE_HASH_SIZE / 4U); round++) {
+        hash = state->rounds[round];
+        for (i = 0U; i < length; i++) {
+            hash ^= (uint32_t)bytes[i];
+            hash *= FNV_PRIME;
+        }
+        state->rounds[round] = hash;
     }
-
-    return 0;
 }
 
-int CacheKernelIsValid(const char* algorithm_id, const char* kernel_name, const char* source_file) {
-    unsigned char stored_hash[CACHE_HASH_SIZE];
-    unsigned char current_hash[CACHE_HASH_SIZE];
-    size_t i;
+void CacheHashFinal(const CacheHashState* state, unsigned char* hash_out) {
+    size_t round;
+    size_t hash_index;
+    uint32_t hash;
 
-    if ((algorithm_id == NULL) || (kernel_name == NULL) || (source_file == NULL)) {
-        return 0;
+    /* Store each round's hash (4 bytes, little-endian) */
+    for (round = 0U; round < (CACHE_HASH_SIZE / 4U); round++) {
+        hash = state->rounds[round];
+        hash_index = round * 4U;
+        hash_out[hash_index] = (unsigned char)(hash & 0xFFU);
+        hash_out[hash_index + 1U] = (unsigned char)((hash >> 8U) & 0xFFU);
+        hash_out[hash_index + 2U] = (unsigned char)((hash >> 16U) & 0xFFU);
+        hash_out[hash_index + 3U] = (unsigned char)((hash >> 24U) & 0xFFU);
     }
+}
 
-    /* Step 1: Check if cached binary exists */
-    if (CacheKernelExists(algorithm_id, kernel_name) == 0) {
-        return 0; /* No cached binary */
-    }
+int CacheFormatKeyedName(const char* base_name, const unsigned char* hash, char* out,
+                         size_t out_size) {
+    static const char hex_digits[] = "0123456789abcdef";
+    char hex[(CACHE_KEY_HEX_BYTES * 2U) + 1U];
+    size_t i;
+    int result;
 
-    /* Step 2: Load stored source hash */
-    if (CacheLoadSourceHash(algorithm_id, kernel_name, stored_hash) != 0) {
-        (void)printf("No stored hash found for %s, cache invalid\n", kernel_name);
-        return 0; /* No hash file - treat as invalid */
+    if ((base_name == NULL) || (hash == NULL) || (out == NULL) || (out_size == 0U)) {
+        return -1;
     }
 
-    /* Step 3: Compute current source hash */
-    if (CacheComputeSourceHash(source_file, current_hash) != 0) {
-        (void)fprintf(stderr, "Error: Failed to compute source hash for %s\n", source_file);
-        return 0; /* Can't verify - treat as invalid */
+    for (i = 0U; i < CACHE_KEY_HEX_BYTES; i++) {
+        hex[i * 2U] = hex_digits[(hash[i] >> 4U) & 0x0FU];
+        hex[(i * 2U) + 1U] = hex_digits[hash[i] & 0x0FU];
     }
+    hex[CACHE_KEY_HEX_BYTES * 2U] = '\0';
 
-    /* Step 4: Compare hashes */
-    for (i = 0U; i < CACHE_HASH_SIZE; i++) {
-        if (stored_hash[i] != current_hash[i]) {
-            (void)printf("Source file changed for %s, cache invalid\n", kernel_name);
-            return 0; /* Hash mismatch - source changed */
-        }
+    result = snprintf(out, out_size, "%s_%s", base_name, hex);
+    if ((result < 0) || ((size_t)result >= out_size)) {
+        return -1;
     }
-
-    /* Cache is valid - binary exists and source hasn't changed */
-    return 1;
+    return 0;
 }
 
 /* ============================================================================
@@ -572,7 +483,7 @@ int CacheKernelIsValid(const char* algorithm_id, const char* kernel_name, const
  * ============================================================================
  */
 
-int CacheGoldenExists(const char* algorithm_id, const char* variant_id) {
+int CacheGoldenExists(const char* algorithm_id, const char* output_name) {
     char cache_path[MAX_CACHE_PATH];
     FILE* fp;
 
@@ -580,11 +491,7 @@ int CacheGoldenExists(const char* algorithm_id, const char* variant_id) {
         return 0;
     }
 
-    /* variant_id is ignored - golden samples are per algorithm, not per variant
-     */
-    (void)variant_id;
-
-    if (BuildGoldenCachePath(algorithm_id, cache_path, sizeof(cache_path)) != 0) {
+    if (BuildGoldenCachePath(algorithm_id, output_name, cache_path, sizeof(cache_path)) != 0) {
         return 0;
     }
 
@@ -597,7 +504,7 @@ int CacheGoldenExists(const char* algorithm_id, const char* variant_id) {
     return 1;
 }
 
-int CacheSaveGolden(const char* algorithm_id, const char* variant_id, const unsigned char* data,
+int CacheSaveGolden(const char* algorithm_id, const char* output_name, const unsigned char* data,
                     size_t size) {
     char cache_path[MAX_CACHE_PATH];
     FILE* fp;
@@ -607,18 +514,8 @@ int CacheSaveGolden(const char* algorithm_id, const char* variant_id, const unsi
         return -1;
     }
 
-    /* variant_id is ignored - golden samples are per algorithm, not per variant
-     */
-    (void)variant_id;
-
-    if (size > MAX_GOLDEN_SAMPLE_SIZE) {
-        (void)fprintf(stderr, "Error: Golden sample too large (%zu bytes, max %u)\n", size,
-                      MAX_GOLDEN_SAMPLE_SIZE);
-        return -1;
-    }
-
     /* Build cache file path */
-    if (BuildGoldenCachePath(algorithm_id, cache_path, sizeof(cache_path)) != 0) {
+    if (BuildGoldenCachePath(algorithm_id, output_name, cache_path, sizeof(cache_path)) != 0) {
         (void)fprintf(stderr, "Error: Failed to build cache path\n");
         return -1;
     }
@@ -646,7 +543,7 @@ int CacheSaveGolden(const char* algorithm_id, const char* variant_id, const unsi
     return 0;
 }
 
-int CacheLoadGolden(const char* algorithm_id, const char* variant_id, unsigned char* buffer,
+int CacheLoadGolden(const char* algorithm_id, const char* output_name, unsigned char* buffer,
                     size_t buffer_size, size_t* actual_size) {
     char cache_path[MAX_CACHE_PATH];
     FILE* fp;
@@ -657,12 +554,8 @@ int CacheLoadGolden(const char* algorithm_id, const char* variant_id, unsigned c
         return -1;
     }
 
-    /* variant_id is ignored - golden samples are per algorithm, not per variant
-     */
-    (void)variant_id;
-
     /* Build cache file path */
-    if (BuildGoldenCachePath(algorithm_id, cache_path, sizeof(cache_path)) != 0) {
+    if (BuildGoldenCachePath(algorithm_id, output_name, cache_path, sizeof(cache_path)) != 0) {
         (void)fprintf(stderr, "Error: Failed to build cache path\n");
         return -1;
     }
@@ -720,9 +613,10 @@ int CacheLoadGolden(const char* algorithm_id, const char* variant_id, unsigned c
     return 0;
 }
 
-int CacheVerifyGolden(const char* algorithm_id, const char* variant_id, const unsigned char* data,
+int CacheVerifyGolden(const char* algorithm_id, const char* output_name, const unsigned char* data,
                       size_t size, size_t* differences) {
-    size_t golden_size;
+    char cache_path[MAX_CACHE_PATH];
+    MappedBuffer golden;
     size_t i;
     size_t diff_count;
 
@@ -730,26 +624,32 @@ int CacheVerifyGolden(const char* algorithm_id, const char* variant_id, const un
         return -1;
     }
 
-    /* Load golden sample - variant_id can be NULL */
-    if (CacheLoadGolden(algorithm_id, variant_id, golden_sample_buffer, MAX_GOLDEN_SAMPLE_SIZE,
-                        &golden_size) != 0) {
+    if (BuildGoldenCachePath(algorithm_id, output_name, cache_path, sizeof(cache_path)) != 0) {
+        (void)fprintf(stderr, "Error: Failed to build cache path\n");
+        return -1;
+    }
+
+    /* Map the golden sample instead of reading it into a capped static copy */
+    if (MappedFileOpen(cache_path, 0U, &golden) != 0) {
         return -1;
     }
 
     /* Check size match */
-    if (golden_size != size) {
+    if (golden.size != size) {
         (void)fprintf(stderr, "Error: Golden sample size mismatch (expected %zu, got %zu)\n",
-                      golden_size, size);
+                      golden.size, size);
+        MappedBufferRelease(&golden);
         return -1;
     }
 
     /* Compare byte by byte */
     diff_count = 0U;
     for (i = 0U; i < size; i++) {
-        if (data[i] != golden_sample_buffer[i]) {
+        if (data[i] != golden.data[i]) {
             diff_count++;
         }
     }
+    MappedBufferRelease(&golden);
 
     *differences = diff_count;
 
@@ -829,3 +729,224 @@ int CacheLoadGoldenFromFile(const char* golden_file_path, unsigned char* buffer,
                  golden_file_path);
     return 0;
 }
+
+/* ============================================================================
+ * AUTOTUNED LOCAL WORK SIZE
+ * ============================================================================
+ */
+
+/* Helper function to construct tuning file path (persistent per-algorithm dir) */
+static int BuildTuneCachePath(const char* algorithm_id, const char* tune_key,
+                              const char* extension, char* path, size_t path_size) {
+    int result;
+
+    if ((algorithm_id == NULL) || (tune_key == NULL) || (path == NULL) || (path_size == 0U)) {
+        return -1;
+    }
+
+    result = snprintf(path, path_size, "%s/%s/%s.%s", CACHE_BASE_DIR, algorithm_id, tune_key,
+                      extension);
+    if ((result < 0) || ((size_t)result >= path_size)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int CacheSaveTunedLocalSize(const char* algorithm_id, const char* tune_key,
+                            const size_t* local_work_size, int work_dim) {
+    char cache_path[MAX_CACHE_PATH];
+    FILE* fp;
+    int i;
+
+    if ((local_work_size == NULL) || (work_dim < 1) || (work_dim > 3)) {
+        return -1;
+    }
+
+    if ((BuildTuneCachePath(algorithm_id, tune_key, "lws", cache_path, sizeof(cache_path)) !=
+         0) ||
+        (EnsureAlgorithmCacheDir(algorithm_id) != 0)) {
+        return -1;
+    }
+
+    fp = fopen(cache_path, "w");
+    if (fp == NULL) {
+        (void)fprintf(stderr, "Error: Failed to create tuning file: %s\n", cache_path);
+        return -1;
+    }
+
+    /* Format: "<work_dim> <l0> [<l1> [<l2>]]\n" */
+    (void)fprintf(fp, "%d", work_dim);
+    for (i = 0; i < work_dim; i++) {
+        (void)fprintf(fp, " %zu", local_work_size[i]);
+    }
+    (void)fprintf(fp, "\n");
+
+    if (fclose(fp) != 0) {
+        (void)fprintf(stderr, "Warning: Failed to close tuning file\n");
+        return -1;
+    }
+
+    (void)printf("Saved tuned local work size: %s\n", cache_path);
+    return 0;
+}
+
+int CacheLoadTunedLocalSize(const char* algorithm_id, const char* tune_key,
+                            size_t* local_work_size, int work_dim) {
+    char cache_path[MAX_CACHE_PATH];
+    FILE* fp;
+    int saved_dim;
+    size_t values[3] = {0U, 0U, 0U};
+    int i;
+    int status = 0;
+
+    if ((local_work_size == NULL) || (work_dim < 1) || (work_dim > 3)) {
+        return -1;
+    }
+
+    if (BuildTuneCachePath(algorithm_id, tune_key, "lws", cache_path, sizeof(cache_path)) != 0) {
+        return -1;
+    }
+
+    fp = fopen(cache_path, "r");
+    if (fp == NULL) {
+        return -1; /* Not tuned yet */
+    }
+
+    if ((fscanf(fp, "%d", &saved_dim) != 1) || (saved_dim != work_dim)) {
+        status = -1;
+    }
+    for (i = 0; (status == 0) && (i < work_dim); i++) {
+        if ((fscanf(fp, "%zu", &values[i]) != 1) || (values[i] == 0U)) {
+            status = -1;
+        }
+    }
+    (void)fclose(fp);
+
+    if (status != 0) {
+        (void)fprintf(stderr, "Warning: Ignoring invalid tuning file: %s\n", cache_path);
+        return -1;
+    }
+
+    for (i = 0; i < work_dim; i++) {
+        local_work_size[i] = values[i];
+    }
+    (void)printf("Loaded tuned local work size: %s\n", cache_path);
+    return 0;
+}
+
+int CacheSaveBalance(const char* algorithm_id, const char* balance_key, const double* shares,
+                     int count) {
+    char cache_path[MAX_CACHE_PATH];
+    FILE* fp;
+    int i;
+
+    if ((shares == NULL) || (count < 1)) {
+        return -1;
+    }
+
+    if ((BuildTuneCachePath(algorithm_id, balance_key, "balance", cache_path,
+                            sizeof(cache_path)) != 0) ||
+        (EnsureAlgorithmCacheDir(algorithm_id) != 0)) {
+        return -1;
+    }
+
+    fp = fopen(cache_path, "w");
+    if (fp == NULL) {
+        (void)fprintf(stderr, "Error: Failed to create balance file: %s\n", cache_path);
+        return -1;
+    }
+
+    /* Format: "<count> <share0> <share1> ...\n" */
+    (void)fprintf(fp, "%d", count);
+    for (i = 0; i < count; i++) {
+        (void)fprintf(fp, " %.6f", shares[i]);
+    }
+    (void)fprintf(fp, "\n");
+
+    if (fclose(fp) != 0) {
+        (void)fprintf(stderr, "Warning: Failed to close balance file\n");
+        return -1;
+    }
+
+    (void)printf("Saved load balance: %s\n", cache_path);
+    return 0;
+}
+
+int CacheLoadBalance(const char* algorithm_id, const char* balance_key, double* shares,
+                     int count) {
+    char cache_path[MAX_CACHE_PATH];
+    FILE* fp;
+    int saved_count;
+    double values[MAX_CACHE_BALANCE_DEVICES];
+    int i;
+    int status = 0;
+
+    if ((shares == NULL) || (count < 1) || (count > MAX_CACHE_BALANCE_DEVICES)) {
+        return -1;
+    }
+
+    if (BuildTuneCachePath(algorithm_id, balance_key, "balance", cache_path,
+                           sizeof(cache_path)) != 0) {
+        return -1;
+    }
+
+    fp = fopen(cache_path, "r");
+    if (fp == NULL) {
+        return -1; /* Not measured yet */
+    }
+
+    if ((fscanf(fp, "%d", &saved_count) != 1) || (saved_count != count)) {
+        status = -1;
+    }
+    for (i = 0; (status == 0) && (i < count); i++) {
+        if ((fscanf(fp, "%lf", &values[i]) != 1) || !(values[i] > 0.0)) {
+            status = -1;
+        }
+    }
+    (void)fclose(fp);
+
+    if (status != 0) {
+        (void)fprintf(stderr, "Warning: Ignoring invalid balance file: %s\n", cache_path);
+        return -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        shares[i] = values[i];
+    }
+    (void)printf("Loaded load balance: %s\n", cache_path);
+    return 0;
+}
+
+int CacheSaveGeneratedSource(const char* algorithm_id, const char* name, const char* source,
+                             size_t length, char* path, size_t path_size) {
+    FILE* fp;
+    int result;
+
+    if ((algorithm_id == NULL) || (name == NULL) || (source == NULL) || (path == NULL) ||
+        (path_size == 0U)) {
+        return -1;
+    }
+
+    result = snprintf(path, path_size, "%s/%s/%s.cl", CACHE_BASE_DIR, algorithm_id, name);
+    if ((result < 0) || ((size_t)result >= path_size) ||
+        (EnsureAlgorithmCacheDir(algorithm_id) != 0)) {
+        return -1;
+    }
+
+    fp = fopen(path, "w");
+    if (fp == NULL) {
+        (void)fprintf(stderr, "Error: Failed to create generated source: %s\n", path);
+        return -1;
+    }
+    if (fwrite(source, 1U, length, fp) != length) {
+        (void)fprintf(stderr, "Error: Failed to write generated source: %s\n", path);
+        (void)fclose(fp);
+        return -1;
+    }
+    if (fclose(fp) != 0) {
+        (void)fprintf(stderr, "Warning: Failed to close generated source\n");
+        return -1;
+    }
+    return 0;
+}
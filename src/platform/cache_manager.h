@@ -5,11 +5,19 @@
  * This module provides functionality to cache:
  * 1. Compiled OpenCL kernel binaries (to avoid recompilation)
  * 2. Golden sample outputs (for result verification)
+ * 3. Autotuned local work sizes (persisted across runs)
  *
  * Cache directory structure:
- * cache/
- *   ├── kernels/     - Compiled kernel binaries (.bin)
- *   └── golden/      - Golden sample outputs (.golden)
+ * out/
+ *   ├── {algorithm}/                        - Persistent per-algorithm cache
+ *   │     ├── {kernel}_{buildkey}.bin       - Compiled kernel binaries
+ *   │     └── *.lws                         - Autotuned local work sizes
+ *   └── {algorithm}_{variant}_{timestamp}/  - Per-run outputs (golden.bin, out.bin,
+ *                                                golden_<name>.bin per named output)
+ *
+ * Kernel binaries are keyed by a build key (device, driver, platform, build
+ * options and header-embedded source), so binaries for different devices or
+ * options coexist and a changed input never loads a stale binary.
  *
  * MISRA-C:2023 Compliance:
  * - Rule 21.3: Avoids dynamic memory allocation
@@ -26,6 +34,8 @@
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
+
 #include "cl_extension_api.h"
 
 /* Cache base directory (organized per algorithm) */
@@ -38,6 +48,57 @@
 /* Hash size for source change detection (using FNV-1a 256-bit equivalent via multiple 32-bit) */
 #define CACHE_HASH_SIZE 32
 
+/* Number of hash bytes encoded (as hex) into keyed cache file names */
+#define CACHE_KEY_HEX_BYTES 8U
+
+/**
+ * @brief Incremental hash state (CACHE_HASH_SIZE / 4 rounds of 32-bit FNV-1a)
+ *
+ * Hashing several buffers in sequence gives the same result as hashing
+ * their concatenation.
+ */
+typedef struct {
+    uint32_t rounds[CACHE_HASH_SIZE / 4]; /**< Per-round FNV-1a state */
+} CacheHashState;
+
+/**
+ * @brief Initialize an incremental hash
+ *
+ * @param[out] state Hash state
+ */
+void CacheHashInit(CacheHashState* state);
+
+/**
+ * @brief Add data to an incremental hash
+ *
+ * @param[in,out] state Hash state
+ * @param[in] data Data to hash
+ * @param[in] length Data length in bytes
+ */
+void CacheHashUpdate(CacheHashState* state, const void* data, size_t length);
+
+/**
+ * @brief Produce the final hash
+ *
+ * @param[in] state Hash state
+ * @param[out] hash_out Hash output (CACHE_HASH_SIZE bytes)
+ */
+void CacheHashFinal(const CacheHashState* state, unsigned char* hash_out);
+
+/**
+ * @brief Format a keyed cache name "<base_name>_<hex>"
+ *
+ * Encodes the first CACHE_KEY_HEX_BYTES bytes of hash as lowercase hex.
+ *
+ * @param base_name Base name (e.g., "dilate_1")
+ * @param hash Build key hash (CACHE_HASH_SIZE bytes)
+ * @param[out] out Output name
+ * @param out_size Output buffer size
+ * @return 0 on success, -1 on error
+ */
+int CacheFormatKeyedName(const char* base_name, const unsigned char* hash, char* out,
+                         size_t out_size);
+
 /**
  * @brief Initialize cache directory structure for an algorithm
  *
@@ -104,62 +165,32 @@ int CacheSaveKernelBinary(cl_program program, cl_device_id device, const char* a
 cl_program CacheLoadKernelBinary(cl_context context, cl_device_id device, const char* algorithm_id,
                                  const char* kernel_name);
 
-/* ============================================================================
- * SOURCE HASH FOR CACHE INVALIDATION
- * ============================================================================
- */
-
 /**
- * @brief Compute hash of kernel source file for change detection
+ * @brief Create and build a program from a binary file
  *
- * Uses FNV-1a hash algorithm to compute a hash of the source file contents.
- * This hash is used to detect if the source has changed since the binary was cached.
+ * The binary-only path of the Android runtime: no source is read, embedded
+ * or hashed, and clCreateProgramWithSource is never called.
  *
- * @param source_file Path to the .cl source file
- * @param hash_out Buffer to receive hash (must be CACHE_HASH_SIZE bytes)
- * @return 0 on success, -1 on error
+ * @param context OpenCL context
+ * @param device Device the binary was compiled for
+ * @param path Program binary file
+ * @return OpenCL program object, or NULL on error
  */
-int CacheComputeSourceHash(const char* source_file, unsigned char* hash_out);
+cl_program CacheLoadProgramBinary(cl_context context, cl_device_id device, const char* path);
 
 /**
- * @brief Save source hash alongside kernel binary
+ * @brief Copy a cached kernel binary to a standalone file
  *
- * Saves the source file hash to a .hash file next to the .bin file.
- * This allows detection of source changes on subsequent runs.
+ * Used by opencl_precompile --export to lay out per-variant binaries that
+ * CacheLoadProgramBinary() loads without knowing the build key.
  *
- * @param algorithm_id Algorithm identifier
- * @param kernel_name Kernel name (for filename)
- * @param hash Hash data to save (CACHE_HASH_SIZE bytes)
+ * @param algorithm_id Algorithm identifier (e.g., "dilate3x3")
+ * @param kernel_name Name of the kernel (cache filename)
+ * @param dest_path Destination file (its directory must exist)
  * @return 0 on success, -1 on error
  */
-int CacheSaveSourceHash(const char* algorithm_id, const char* kernel_name,
-                        const unsigned char* hash);
-
-/**
- * @brief Load stored source hash from cache
- *
- * @param algorithm_id Algorithm identifier
- * @param kernel_name Kernel name (for filename)
- * @param hash_out Buffer to receive hash (must be CACHE_HASH_SIZE bytes)
- * @return 0 on success, -1 on error (file not found or read error)
- */
-int CacheLoadSourceHash(const char* algorithm_id, const char* kernel_name, unsigned char* hash_out);
-
-/**
- * @brief Check if cached kernel is valid (exists AND source unchanged)
- *
- * This function performs a complete validation:
- * 1. Checks if the cached binary file exists
- * 2. Checks if the hash file exists
- * 3. Computes current source hash and compares with stored hash
- *
- * @param algorithm_id Algorithm identifier
- * @param kernel_name Kernel name for cache lookup
- * @param source_file Path to current .cl source file
- * @return 1 if cache is valid and can be used, 0 if invalid/missing/changed
- */
-int CacheKernelIsValid(const char* algorithm_id, const char* kernel_name, const char* source_file);
-
+int CacheExportKernelBinary(const char* algorithm_id, const char* kernel_name,
+                            const char* dest_path);
 
 int CacheSaveCustomBinary(CLExtensionContext* ctx);
 /* ============================================================================
@@ -171,10 +202,10 @@ int CacheSaveCustomBinary(CLExtensionContext* ctx);
  * @brief Check if a golden sample exists
  *
  * @param algorithm_id Unique identifier for the algorithm
- * @param variant_id Variant identifier (can be NULL for c_ref golden samples)
+ * @param output_name Named output of a multi-output kernel (NULL for the primary output)
  * @return 1 if golden sample exists, 0 otherwise
  */
-int CacheGoldenExists(const char* algorithm_id, const char* variant_id);
+int CacheGoldenExists(const char* algorithm_id, const char* output_name);
 
 /**
  * @brief Save golden sample output to cache
@@ -183,12 +214,12 @@ int CacheGoldenExists(const char* algorithm_id, const char* variant_id);
  * Golden samples are created from c_ref implementations only.
  *
  * @param algorithm_id Unique identifier for the algorithm
- * @param variant_id Variant identifier (pass NULL for c_ref golden samples)
+ * @param output_name Named output of a multi-output kernel (NULL for the primary output)
  * @param data Output data to save
  * @param size Size of data in bytes
  * @return 0 on success, -1 on error
  */
-int CacheSaveGolden(const char* algorithm_id, const char* variant_id, const unsigned char* data,
+int CacheSaveGolden(const char* algorithm_id, const char* output_name, const unsigned char* data,
                     size_t size);
 
 /**
@@ -197,13 +228,13 @@ int CacheSaveGolden(const char* algorithm_id, const char* variant_id, const unsi
  * Loads previously saved golden sample data for verification.
  *
  * @param algorithm_id Unique identifier for the algorithm
- * @param variant_id Variant identifier (pass NULL for c_ref golden samples)
+ * @param output_name Named output of a multi-output kernel (NULL for the primary output)
  * @param buffer Buffer to receive the golden sample data
  * @param buffer_size Size of the buffer
  * @param[out] actual_size Actual size of data loaded
  * @return 0 on success, -1 on error
  */
-int CacheLoadGolden(const char* algorithm_id, const char* variant_id, unsigned char* buffer,
+int CacheLoadGolden(const char* algorithm_id, const char* output_name, unsigned char* buffer,
                     size_t buffer_size, size_t* actual_size);
 
 /**
@@ -212,13 +243,13 @@ int CacheLoadGolden(const char* algorithm_id, const char* variant_id, unsigned c
  * Compares the current output against the saved golden sample.
  *
  * @param algorithm_id Unique identifier for the algorithm
- * @param variant_id Variant identifier (pass NULL for c_ref golden samples)
+ * @param output_name Named output of a multi-output kernel (NULL for the primary output)
  * @param data Current output data
  * @param size Size of data in bytes
  * @param[out] differences Number of byte differences found
  * @return 1 if verification passes (exact match), 0 otherwise, -1 on error
  */
-int CacheVerifyGolden(const char* algorithm_id, const char* variant_id, const unsigned char* data,
+int CacheVerifyGolden(const char* algorithm_id, const char* output_name, const unsigned char* data,
                       size_t size, size_t* differences);
 
 /**
@@ -238,3 +269,78 @@ int CacheVerifyGolden(const char* algorithm_id, const char* variant_id, const un
  */
 int CacheLoadGoldenFromFile(const char* golden_file_path, unsigned char* buffer,
                             size_t expected_size);
+
+/**
+ * @brief Save an autotuned local work size
+ *
+ * Tuning results persist across runs in the per-algorithm cache directory
+ * (out/{algorithm}/{tune_key}.lws), independent of the timestamped run dir.
+ *
+ * @param algorithm_id Unique identifier for the algorithm
+ * @param tune_key File-safe key identifying (device, kernel, image size)
+ * @param local_work_size Local work size to save (work_dim entries)
+ * @param work_dim Number of work dimensions (1 to 3)
+ * @return 0 on success, -1 on error
+ */
+int CacheSaveTunedLocalSize(const char* algorithm_id, const char* tune_key,
+                            const size_t* local_work_size, int work_dim);
+
+/**
+ * @brief Load a previously autotuned local work size
+ *
+ * @param algorithm_id Unique identifier for the algorithm
+ * @param tune_key File-safe key identifying (device, kernel, image size)
+ * @param[out] local_work_size Loaded local work size (work_dim entries)
+ * @param work_dim Number of work dimensions (must match saved entry)
+ * @return 0 on success, -1 if not found or invalid
+ */
+int CacheLoadTunedLocalSize(const char* algorithm_id, const char* tune_key,
+                            size_t* local_work_size, int work_dim);
+
+/** Maximum devices in a persisted load balance */
+#define MAX_CACHE_BALANCE_DEVICES 8
+
+/**
+ * @brief Save the learned work shares of a multi-device run
+ *
+ * Persisted like tuned local sizes, in the per-algorithm cache directory
+ * (out/{algorithm}/{balance_key}.balance).
+ *
+ * @param algorithm_id Unique identifier for the algorithm
+ * @param balance_key File-safe key identifying (kernel, split, device set)
+ * @param shares Relative work share per device (count entries, > 0)
+ * @param count Number of devices
+ * @return 0 on success, -1 on error
+ */
+int CacheSaveBalance(const char* algorithm_id, const char* balance_key, const double* shares,
+                     int count);
+
+/**
+ * @brief Load the learned work shares of a multi-device run
+ *
+ * @param algorithm_id Unique identifier for the algorithm
+ * @param balance_key File-safe key identifying (kernel, split, device set)
+ * @param[out] shares Loaded shares (count entries)
+ * @param count Number of devices (must match saved entry, <= MAX_CACHE_BALANCE_DEVICES)
+ * @return 0 on success, -1 if not found or invalid
+ */
+int CacheLoadBalance(const char* algorithm_id, const char* balance_key, double* shares,
+                     int count);
+
+/**
+ * @brief Save a generated kernel source
+ *
+ * Generated sources (e.g., fused pipeline stages) are written to the
+ * per-algorithm cache directory (out/{algorithm}/{name}.cl), so they can be
+ * built like any kernel file and inspected after the run.
+ *
+ * @param algorithm_id Unique identifier for the algorithm
+ * @param name File-safe source name (without extension)
+ * @param source Source text
+ * @param length Source length in bytes
+ * @param[out] path Path of the written file
+ * @param path_size Size of path
+ * @return 0 on success, -1 on error
+ */
+int CacheSaveGeneratedSource(const char* algorithm_id, const char* name, const char* source,
+                             size_t length, char* path, size_t path_size);
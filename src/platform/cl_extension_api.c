@@ -13,6 +13,326 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "buffer_pool.h"
+#include "trace.h"
+#include "utils/benchmark.h"
+
+/**
+ * @brief Caller event of a tiled dispatch and the tiles bounding it
+ *
+ * Queues are in-order, so the first tile on a queue starts first and the
+ * last one ends last.
+ */
+typedef struct {
+    cl_event marker;                 /**< Event returned to the caller (retained) */
+    cl_event first[MAX_TILE_QUEUES]; /**< First tile per queue (retained, may be NULL) */
+    cl_event last[MAX_TILE_QUEUES];  /**< Last tile per queue (retained, may be NULL) */
+} TiledEvent;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static TiledEvent tiled_events[CL_EXT_MAX_TILED_EVENTS];
+static int tiled_next = 0;
+static cl_ulong tile_keys[CL_EXT_MAX_TILES]; /* Sort key (Morton code) << 32 | tile index */
+
+/* Release the events held by a tracked tiled dispatch */
+static void ReleaseTiledEvent(TiledEvent* entry) {
+    int q;
+
+    if (entry->marker != NULL) {
+        (void)clReleaseEvent(entry->marker);
+        entry->marker = NULL;
+    }
+    for (q = 0; q < MAX_TILE_QUEUES; q++) {
+        if (entry->first[q] != NULL) {
+            (void)clReleaseEvent(entry->first[q]);
+            entry->first[q] = NULL;
+        }
+        if (entry->last[q] != NULL) {
+            (void)clReleaseEvent(entry->last[q]);
+            entry->last[q] = NULL;
+        }
+    }
+}
+
+/* Spread the low 16 bits of v to the even bit positions */
+static cl_uint SpreadBits(cl_uint v) {
+    v &= 0x0000FFFFU;
+    v = (v | (v << 8)) & 0x00FF00FFU;
+    v = (v | (v << 4)) & 0x0F0F0F0FU;
+    v = (v | (v << 2)) & 0x33333333U;
+    v = (v | (v << 1)) & 0x55555555U;
+    return v;
+}
+
+/* qsort comparator for tile_keys */
+static int CompareTileKeys(const void* a, const void* b) {
+    cl_ulong ka = *(const cl_ulong*)a;
+    cl_ulong kb = *(const cl_ulong*)b;
+
+    return (ka < kb) ? -1 : ((ka > kb) ? 1 : 0);
+}
+
+/**
+ * @brief Tile sizes, tile grid and launch order for one dispatch
+ *
+ * Tiles are rounded up to a multiple of the local size and enlarged
+ * (doubling the dimension with more tiles) until at most CL_EXT_MAX_TILES.
+ * The launch order is written to tile_keys (low 32 bits = row-major index).
+ *
+ * @return Number of tiles, 0 for an empty range
+ */
+static size_t PlanTiles(const TilingConfig* tiling, cl_uint work_dim, const size_t* global,
+                        const size_t* local, size_t tile[2], size_t count[2]) {
+    size_t tiles;
+    size_t t;
+    cl_uint d;
+    cl_uint x;
+    cl_uint y;
+
+    for (d = 0U; d < 2U; d++) {
+        tile[d] = 1U;
+        count[d] = 1U;
+        if (d >= work_dim) {
+            continue;
+        }
+        if (global[d] == 0U) {
+            return 0U;
+        }
+        tile[d] = ((tiling->tile_size[d] == 0U) || (tiling->tile_size[d] > global[d]))
+                      ? global[d]
+                      : tiling->tile_size[d];
+        if ((local != NULL) && (local[d] > 0U)) {
+            tile[d] = ((tile[d] + local[d] - 1U) / local[d]) * local[d];
+        }
+        count[d] = (global[d] + tile[d] - 1U) / tile[d];
+    }
+
+    while ((count[0] * count[1]) > (size_t)CL_EXT_MAX_TILES) {
+        d = (count[0] >= count[1]) ? 0U : 1U;
+        tile[d] *= 2U;
+        count[d] = (global[d] + tile[d] - 1U) / tile[d];
+    }
+
+    tiles = count[0] * count[1];
+    for (t = 0U; t < tiles; t++) {
+        x = (cl_uint)(t % count[0]);
+        y = (cl_uint)(t / count[0]);
+        tile_keys[t] = (tiling->order == TILE_ORDER_Z_ORDER)
+                           ? (((cl_ulong)(SpreadBits(x) | (SpreadBits(y) << 1)) << 32) | t)
+                           : (cl_ulong)t;
+    }
+    if (tiling->order == TILE_ORDER_Z_ORDER) {
+        qsort(tile_keys, tiles, sizeof(tile_keys[0]), CompareTileKeys);
+    }
+    return tiles;
+}
+
+/**
+ * @brief Queues for a tiled dispatch: the caller's plus extra in-order queues
+ *
+ * Extra queues are created on first use with profiling enabled and kept in
+ * the context. If one cannot be created, fewer queues are used.
+ *
+ * @return Number of usable queues (>= 1)
+ */
+static int PrepareTileQueues(CLExtensionContext* ctx, cl_command_queue command_queue,
+                             cl_command_queue queues[MAX_TILE_QUEUES]) {
+    cl_context context;
+    cl_device_id device;
+    cl_int err;
+    int wanted = ctx->tiling.queues;
+    int q;
+
+    queues[0] = command_queue;
+    if (wanted <= 1) {
+        return 1;
+    }
+    if (wanted > MAX_TILE_QUEUES) {
+        wanted = MAX_TILE_QUEUES;
+    }
+
+    err = clGetCommandQueueInfo(command_queue, CL_QUEUE_CONTEXT, sizeof(context), &context, NULL);
+    if (err == CL_SUCCESS) {
+        err = clGetCommandQueueInfo(command_queue, CL_QUEUE_DEVICE, sizeof(device), &device, NULL);
+    }
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "[CL_EXT] Warning: Queue info query failed (%d), one tile queue\n",
+                      err);
+        return 1;
+    }
+
+    /* Queues are per context: drop those of an earlier context */
+    if (ctx->tile_context != context) {
+        for (q = 1; q < MAX_TILE_QUEUES; q++) {
+            if (ctx->tile_queues[q] != NULL) {
+                (void)clReleaseCommandQueue(ctx->tile_queues[q]);
+                ctx->tile_queues[q] = NULL;
+            }
+        }
+        ctx->tile_context = context;
+    }
+
+    for (q = 1; q < wanted; q++) {
+        if (ctx->tile_queues[q] == NULL) {
+            ctx->tile_queues[q] =
+                clCreateCommandQueue(context, device, CL_QUEUE_PROFILING_ENABLE, &err);
+            if (err != CL_SUCCESS) {
+                ctx->tile_queues[q] = NULL;
+                (void)fprintf(stderr, "[CL_EXT] Warning: Tile queue %d not created (%d)\n", q,
+                              err);
+                break;
+            }
+        }
+        queues[q] = ctx->tile_queues[q];
+    }
+    return q;
+}
+
+/**
+ * @brief Launch an NDRange as tiles (see ClExtensionEnqueueNdrangeKernel())
+ */
+static cl_int EnqueueTiled(CLExtensionContext* ctx, cl_command_queue command_queue,
+                           cl_kernel kernel, cl_uint work_dim, const size_t* global_work_offset,
+                           const size_t* global_work_size, const size_t* local_work_size,
+                           cl_uint num_events_in_wait_list, const cl_event* event_wait_list,
+                           cl_event* event) {
+    cl_command_queue queues[MAX_TILE_QUEUES];
+    cl_event first[MAX_TILE_QUEUES] = {NULL};
+    cl_event last[MAX_TILE_QUEUES] = {NULL};
+    cl_event tile_event;
+    cl_event own_marker = NULL;
+    cl_event start_marker = NULL;
+    cl_uint tile_wait_count = num_events_in_wait_list;
+    const cl_event* tile_wait_list = event_wait_list;
+    TiledEvent* entry;
+    size_t tile[2];
+    size_t count[2];
+    size_t index[2];
+    size_t offset[3];
+    size_t size[3];
+    size_t tiles;
+    size_t t;
+    cl_uint d;
+    cl_uint used = 0U;
+    cl_int err = CL_SUCCESS;
+    int queue_count;
+    int q;
+
+    if (global_work_size == NULL) {
+        return CL_INVALID_GLOBAL_WORK_SIZE;
+    }
+    tiles = PlanTiles(&ctx->tiling, work_dim, global_work_size, local_work_size, tile, count);
+    if (tiles == 0U) {
+        return CL_INVALID_GLOBAL_WORK_SIZE;
+    }
+    queue_count = PrepareTileQueues(ctx, command_queue, queues);
+
+    /* Extra queues: tiles must not start before the caller's queued commands (e.g. uploads) */
+    if (queue_count > 1) {
+        err = clEnqueueMarkerWithWaitList(command_queue, num_events_in_wait_list, event_wait_list,
+                                          &start_marker);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "[CL_EXT] Tile start marker failed: %d\n", err);
+            return err;
+        }
+        (void)clFlush(command_queue);
+        tile_wait_count = 1U;
+        tile_wait_list = &start_marker;
+    }
+
+    for (t = 0U; t < tiles; t++) {
+        index[0] = (size_t)(tile_keys[t] & 0xFFFFFFFFU) % count[0];
+        index[1] = (size_t)(tile_keys[t] & 0xFFFFFFFFU) / count[0];
+        for (d = 0U; d < work_dim; d++) {
+            offset[d] = (global_work_offset != NULL) ? global_work_offset[d] : 0U;
+            size[d] = global_work_size[d];
+            if (d < 2U) {
+                offset[d] += index[d] * tile[d];
+                size[d] -= index[d] * tile[d];
+                if (size[d] > tile[d]) {
+                    size[d] = tile[d];
+                }
+            }
+        }
+
+        q = (int)(t % (size_t)queue_count);
+        err = clEnqueueNDRangeKernel(queues[q], kernel, work_dim, offset, size, local_work_size,
+                                     tile_wait_count, tile_wait_list, &tile_event);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "[CL_EXT] Tile %zu enqueue failed: %d\n", t, err);
+            break;
+        }
+        TraceRecordKernel(tile_event, queues[q], kernel, "kernel (cl_ext tile)");
+        if (first[q] == NULL) {
+            first[q] = tile_event;
+            (void)clRetainEvent(tile_event);
+        } else {
+            (void)clReleaseEvent(last[q]);
+        }
+        last[q] = tile_event;
+    }
+
+    /* Extra queues: submit now, the caller only flushes its own */
+    for (q = 1; q < queue_count; q++) {
+        (void)clFlush(queues[q]);
+    }
+
+    /* Tiles on extra queues still join the caller's queue, so its clFinish covers them */
+    if ((event == NULL) && (queue_count > 1) && (tiles > 1U)) {
+        event = &own_marker;
+    }
+
+    if ((err == CL_SUCCESS) && (event != NULL)) {
+        if (tiles == 1U) {
+            *event = last[0];
+            (void)clRetainEvent(*event);
+        } else {
+            for (q = 0; q < queue_count; q++) {
+                if (last[q] != NULL) {
+                    last[used] = last[q];
+                    first[used] = first[q];
+                    if (used != (cl_uint)q) {
+                        last[q] = NULL;
+                        first[q] = NULL;
+                    }
+                    used++;
+                }
+            }
+            err = clEnqueueMarkerWithWaitList(command_queue, used, last, event);
+            if (err == CL_SUCCESS) {
+                /* Track the marker so its timing covers the tiles */
+                entry = &tiled_events[tiled_next];
+                tiled_next = (tiled_next + 1) % CL_EXT_MAX_TILED_EVENTS;
+                ReleaseTiledEvent(entry);
+                entry->marker = *event;
+                (void)clRetainEvent(*event);
+                (void)memcpy(entry->first, first, sizeof(first));
+                (void)memcpy(entry->last, last, sizeof(last));
+                (void)memset(first, 0, sizeof(first));
+                (void)memset(last, 0, sizeof(last));
+            } else {
+                (void)fprintf(stderr, "[CL_EXT] Tile completion marker failed: %d\n", err);
+            }
+        }
+    }
+
+    for (q = 0; q < MAX_TILE_QUEUES; q++) {
+        if (first[q] != NULL) {
+            (void)clReleaseEvent(first[q]);
+        }
+        if (last[q] != NULL) {
+            (void)clReleaseEvent(last[q]);
+        }
+    }
+    if (own_marker != NULL) {
+        (void)clReleaseEvent(own_marker);
+    }
+    if (start_marker != NULL) {
+        (void)clReleaseEvent(start_marker);
+    }
+    return err;
+}
+
 int ClExtensionInit(CLExtensionContext* ctx) {
     if (ctx == NULL) {
         (void)fprintf(stderr, "Error: NULL context in ClExtensionInit\n");
@@ -20,7 +340,9 @@ int ClExtensionInit(CLExtensionContext* ctx) {
     }
 
     /* Initialize extension context */
+    (void)memset(ctx, 0, sizeof(*ctx));
     ctx->extension_data = NULL;
+    ctx->tiling.queues = 1;
     ctx->initialized = 1;
 
     (void)printf("[CL_EXT] Custom CL extension API initialized\n");
@@ -28,6 +350,8 @@ int ClExtensionInit(CLExtensionContext* ctx) {
 }
 
 void ClExtensionCleanup(CLExtensionContext* ctx) {
+    int i;
+
     if (ctx == NULL) {
         return;
     }
@@ -38,6 +362,17 @@ void ClExtensionCleanup(CLExtensionContext* ctx) {
         ctx->extension_data = NULL;
     }
 
+    for (i = 0; i < CL_EXT_MAX_TILED_EVENTS; i++) {
+        ReleaseTiledEvent(&tiled_events[i]);
+    }
+    for (i = 1; i < MAX_TILE_QUEUES; i++) {
+        if (ctx->tile_queues[i] != NULL) {
+            (void)clReleaseCommandQueue(ctx->tile_queues[i]);
+            ctx->tile_queues[i] = NULL;
+        }
+    }
+    ctx->tile_context = NULL;
+
     ctx->initialized = 0;
     (void)printf("[CL_EXT] Custom CL extension API cleaned up\n");
 }
@@ -47,6 +382,7 @@ cl_int ClExtensionEnqueueNdrangeKernel(
     const size_t* global_work_offset, const size_t* global_work_size, const size_t* local_work_size,
     cl_uint num_events_in_wait_list, const cl_event* event_wait_list, cl_event* event) {
     cl_int err;
+    cl_event trace_event = NULL;
 
     if (ctx == NULL) {
         (void)fprintf(stderr, "[CL_EXT] Error: NULL context\n");
@@ -82,25 +418,103 @@ cl_int ClExtensionEnqueueNdrangeKernel(
         }
     }
 
-    /* TODO: Add custom scheduling/optimization logic here */
-    /* For now, just call the standard OpenCL API */
-    err = clEnqueueNDRangeKernel(command_queue, kernel, work_dim, global_work_offset,
-                                 global_work_size, local_work_size, num_events_in_wait_list,
-                                 event_wait_list, event);
+    if ((ctx->tiling.tile_size[0] != 0U) || (ctx->tiling.tile_size[1] != 0U)) {
+        err = EnqueueTiled(ctx, command_queue, kernel, work_dim, global_work_offset,
+                           global_work_size, local_work_size, num_events_in_wait_list,
+                           event_wait_list, event);
+        if (err == CL_SUCCESS) {
+            (void)printf("[CL_EXT] Kernel enqueued successfully (tiled)\n");
+        }
+        return err;
+    }
+
+    /* Untiled: one launch. Tracing needs an event even when the caller does not ask for one */
+    err = clEnqueueNDRangeKernel(
+        command_queue, kernel, work_dim, global_work_offset, global_work_size, local_work_size,
+        num_events_in_wait_list, event_wait_list,
+        ((event == NULL) && (TraceEnabled() != 0)) ? &trace_event : event);
 
     if (err != CL_SUCCESS) {
         (void)fprintf(stderr, "[CL_EXT] Kernel enqueue failed: %d\n", err);
     } else {
         (void)printf("[CL_EXT] Kernel enqueued successfully\n");
+        TraceRecordKernel((event != NULL) ? *event : trace_event, command_queue, kernel,
+                          "kernel (cl_ext)");
+        if (trace_event != NULL) {
+            (void)clReleaseEvent(trace_event);
+        }
     }
 
     return err;
 }
 
+void ClExtensionSetTiling(CLExtensionContext* ctx, const TilingConfig* tiling) {
+    if (ctx == NULL) {
+        return;
+    }
+    if (tiling == NULL) {
+        (void)memset(&ctx->tiling, 0, sizeof(ctx->tiling));
+        ctx->tiling.queues = 1;
+    } else {
+        ctx->tiling = *tiling;
+    }
+}
+
+cl_int ClExtensionGetEventTimes(cl_event event, cl_ulong* start_ns, cl_ulong* end_ns) {
+    const TiledEvent* entry = NULL;
+    cl_ulong stamp;
+    cl_int err;
+    int i;
+    int q;
+
+    if ((event == NULL) || (start_ns == NULL) || (end_ns == NULL)) {
+        return CL_INVALID_VALUE;
+    }
+
+    for (i = 0; i < CL_EXT_MAX_TILED_EVENTS; i++) {
+        if (tiled_events[i].marker == event) {
+            entry = &tiled_events[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        err = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(*start_ns),
+                                      start_ns, NULL);
+        if (err == CL_SUCCESS) {
+            err = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(*end_ns), end_ns,
+                                          NULL);
+        }
+        return err;
+    }
+
+    *start_ns = 0U;
+    *end_ns = 0U;
+    for (q = 0; (q < MAX_TILE_QUEUES) && (entry->first[q] != NULL); q++) {
+        err = clGetEventProfilingInfo(entry->first[q], CL_PROFILING_COMMAND_START, sizeof(stamp),
+                                      &stamp, NULL);
+        if (err != CL_SUCCESS) {
+            return err;
+        }
+        if ((q == 0) || (stamp < *start_ns)) {
+            *start_ns = stamp;
+        }
+        err = clGetEventProfilingInfo(entry->last[q], CL_PROFILING_COMMAND_END, sizeof(stamp),
+                                      &stamp, NULL);
+        if (err != CL_SUCCESS) {
+            return err;
+        }
+        if (stamp > *end_ns) {
+            *end_ns = stamp;
+        }
+    }
+    return CL_SUCCESS;
+}
+
 cl_mem ClExtensionCreateBuffer(CLExtensionContext* ctx, cl_context context, cl_mem_flags flags,
                                size_t size, void* host_ptr, cl_int* errcode_ret) {
     cl_mem buffer;
     const char* flag_desc = "UNKNOWN";
+    double start_ms;
 
     if (ctx == NULL) {
         if (errcode_ret != NULL) {
@@ -132,9 +546,14 @@ cl_mem ClExtensionCreateBuffer(CLExtensionContext* ctx, cl_context context, cl_m
     }
     (void)printf("[CL_EXT]   Buffer flags: %s\n", flag_desc);
 
-    /* TODO: Add custom memory allocation/pooling logic here */
-    /* For now, just call the standard OpenCL API */
-    buffer = clCreateBuffer(context, flags, size, host_ptr, errcode_ret);
+    /* Recycle device-only buffers; host-backed ones are tied to their host memory */
+    start_ms = BenchmarkNowMs();
+    if (BufferPoolAccepts(flags, host_ptr) != 0) {
+        buffer = BufferPoolAcquire(context, flags, size, errcode_ret);
+    } else {
+        buffer = clCreateBuffer(context, flags, size, host_ptr, errcode_ret);
+    }
+    TraceRecordHost("cl_ext create buffer", "buffer", start_ms, BenchmarkNowMs());
 
     if ((errcode_ret != NULL) && (*errcode_ret != CL_SUCCESS)) {
         (void)fprintf(stderr, "[CL_EXT] Buffer creation failed: %d\n", *errcode_ret);
@@ -147,6 +566,7 @@ cl_mem ClExtensionCreateBuffer(CLExtensionContext* ctx, cl_context context, cl_m
 
 cl_int ClExtensionFinish(CLExtensionContext* ctx, cl_command_queue command_queue) {
     cl_int err;
+    double start_ms;
 
     if (ctx == NULL) {
         (void)fprintf(stderr, "[CL_EXT] Error: NULL context\n");
@@ -161,9 +581,10 @@ cl_int ClExtensionFinish(CLExtensionContext* ctx, cl_command_queue command_queue
     /* Dummy implementation: Print information and call standard API */
     (void)printf("[CL_EXT] Custom finish called\n");
 
-    /* TODO: Add custom synchronization/profiling logic here */
-    /* For now, just call the standard OpenCL API */
+    /* Standard finish; its host wait shows on the trace timeline */
+    start_ms = BenchmarkNowMs();
     err = clFinish(command_queue);
+    TraceRecordHost("cl_ext finish", "sync", start_ms, BenchmarkNowMs());
 
     if (err != CL_SUCCESS) {
         (void)fprintf(stderr, "[CL_EXT] Finish failed: %d\n", err);
@@ -9,6 +9,15 @@
  * Configuration:
  * - Set host_type = "standard" in .ini for standard OpenCL API (default)
  * - Set host_type = "cl_extension" in .ini for custom extension API
+ *
+ * Tiled sub-dispatch: with a kernel "tiling" config, the extension NDRange
+ * enqueue splits the range into tiles launched with global work offsets,
+ * in row-major or Z (Morton) order, round-robin over up to MAX_TILE_QUEUES
+ * in-order queues. Smaller launches shorten each dispatch (less to wait for
+ * when a preemptive GPU switches context) and let other queued work
+ * interleave. The caller still gets one event: a marker that completes
+ * with the last tile; ClExtensionGetEventTimes() reports the span from the
+ * first tile's start to the last tile's end for it.
  */
 
 #pragma once
@@ -30,8 +39,17 @@
 typedef struct {
     void* extension_data; /**< Custom extension-specific data */
     int initialized;      /**< Initialization flag */
+    TilingConfig tiling;  /**< Tiling for the next NDRange enqueues (tile_size 0 = untiled) */
+    cl_command_queue tile_queues[MAX_TILE_QUEUES]; /**< Extra tile queues (0 = caller's, unused) */
+    cl_context tile_context;                       /**< Context the extra queues belong to */
 } CLExtensionContext;
 
+/** Maximum tiles per dispatch; tiles are enlarged to stay within it */
+#define CL_EXT_MAX_TILES 4096
+
+/** Tiled dispatches whose caller events are tracked for ClExtensionGetEventTimes() */
+#define CL_EXT_MAX_TILED_EVENTS 64
+
 /**
  * @brief Initialize custom CL extension context
  *
@@ -56,7 +74,9 @@ void ClExtensionCleanup(CLExtensionContext* ctx);
  * @brief Custom implementation of clEnqueueNDRangeKernel
  *
  * This is a custom wrapper/replacement for the standard clEnqueueNDRangeKernel.
- * Implement custom scheduling, profiling, or optimization logic here.
+ * Untiled (default), it forwards to clEnqueueNDRangeKernel. With tiling set
+ * (ClExtensionSetTiling()), it launches the range as tiles; every tile
+ * waits for @p event_wait_list and @p event completes after all tiles.
  *
  * @param[in] ctx Custom extension context
  * @param[in] command_queue Command queue to enqueue the kernel
@@ -75,11 +95,33 @@ cl_int ClExtensionEnqueueNdrangeKernel(
     const size_t* global_work_offset, const size_t* global_work_size, const size_t* local_work_size,
     cl_uint num_events_in_wait_list, const cl_event* event_wait_list, cl_event* event);
 
+/**
+ * @brief Select tiling for subsequent ClExtensionEnqueueNdrangeKernel() calls
+ *
+ * @param[in,out] ctx Custom extension context
+ * @param[in] tiling Tiling settings (NULL = untiled)
+ */
+void ClExtensionSetTiling(CLExtensionContext* ctx, const TilingConfig* tiling);
+
+/**
+ * @brief Device start/end timestamps of a command
+ *
+ * For the event of a tiled dispatch this is the span of its tiles (first
+ * START to last END); for any other event its own START and END.
+ *
+ * @param[in] event Completed event
+ * @param[out] start_ns CL_PROFILING_COMMAND_START
+ * @param[out] end_ns CL_PROFILING_COMMAND_END
+ * @return CL_SUCCESS, or the profiling query error
+ */
+cl_int ClExtensionGetEventTimes(cl_event event, cl_ulong* start_ns, cl_ulong* end_ns);
+
 /**
  * @brief Custom implementation of clCreateBuffer
  *
  * This is a custom wrapper/replacement for the standard clCreateBuffer.
- * Implement custom memory allocation, pooling, or optimization logic here.
+ * Buffers without host memory come from the buffer pool (buffer_pool.h);
+ * release them with OpenclReleaseMemObject() so they are recycled.
  *
  * @param[in] ctx Custom extension context
  * @param[in] context OpenCL context
@@ -0,0 +1,164 @@
+/**
+ * @file device_verify.c
+ * @brief On-device output verification implementation
+ */
+
+#include "device_verify.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "primitives.h"
+#include "program_registry.h"
+
+/** Algorithm id of the verification program (kernel cache directory) */
+#define DEVICE_VERIFY_ALGORITHM_ID "verify"
+
+/** Work-groups per compute unit of the grid-stride compare */
+#define VERIFY_GROUPS_PER_CU 4U
+
+int DeviceVerifyCreate(OpenCLEnv* env, const VerifyOptions* opts, const void* golden,
+                       const ImagePitch* output_pitch, DeviceVerifier* verifier) {
+    static KernelConfig verify_cfg;
+    size_t elem_size;
+    size_t golden_size;
+    size_t total;
+    size_t groups;
+    int channels;
+
+    if ((env == NULL) || (opts == NULL) || (golden == NULL) || (verifier == NULL) ||
+        (opts->width <= 0) || (opts->height <= 0)) {
+        return -1;
+    }
+    if ((opts->element_type == VERIFY_ELEMENT_FLOAT) &&
+        ((opts->rel_tolerance > 0.0f) || (opts->ulp_tolerance > 0))) {
+        (void)fprintf(stderr, "Error: On-device verification supports absolute tolerance only\n");
+        return -1;
+    }
+
+    (void)memset(verifier, 0, sizeof(*verifier));
+    channels = (opts->channels > 0) ? opts->channels : 1;
+    elem_size = (opts->element_type == VERIFY_ELEMENT_FLOAT) ? sizeof(float) : 1U;
+    verifier->row_elems = opts->width * channels;
+    verifier->rows = opts->height;
+    verifier->gpu_pitch = verifier->row_elems;
+    if (output_pitch != NULL) {
+        verifier->gpu_pitch = (int)(output_pitch->device_pitch / elem_size);
+    }
+    verifier->tolerance = opts->tolerance;
+    verifier->error_rate_threshold = opts->error_rate_threshold;
+    total = (size_t)verifier->row_elems * (size_t)verifier->rows;
+    golden_size = total * elem_size;
+
+    (void)memset(&verify_cfg, 0, sizeof(verify_cfg));
+    (void)snprintf(verify_cfg.variant_id, sizeof(verify_cfg.variant_id), "v0");
+    (void)snprintf(verify_cfg.kernel_file, sizeof(verify_cfg.kernel_file), "%s/verify.cl",
+                   CL_INCLUDE_DIR);
+    verify_cfg.work_dim = 1;
+    verify_cfg.host_type = HOST_TYPE_STANDARD;
+    verifier->kernel = ProgramRegistryCreateKernel(
+        env, DEVICE_VERIFY_ALGORITHM_ID, &verify_cfg,
+        (opts->element_type == VERIFY_ELEMENT_FLOAT) ? "verify_compare_f32" : "verify_compare_u8");
+    if (verifier->kernel == NULL) {
+        (void)fprintf(stderr, "Error: Failed to build the device verification kernel\n");
+        return -1;
+    }
+    verifier->local_size = PrimWorkGroupSize(env, verifier->kernel);
+    groups = (total + verifier->local_size - 1U) / verifier->local_size;
+    verifier->groups = (size_t)((env->compute_units > 0U) ? env->compute_units : 1U) *
+                       VERIFY_GROUPS_PER_CU;
+    if (groups < verifier->groups) {
+        verifier->groups = groups;
+    }
+
+    verifier->golden = OpenclCreateBuffer(env->context, CL_MEM_READ_ONLY, golden_size, NULL,
+                                          "verify_golden");
+    verifier->result = OpenclCreateBuffer(env->context, CL_MEM_READ_WRITE, 2U * sizeof(cl_int),
+                                          NULL, "verify_result");
+    if ((verifier->golden == NULL) || (verifier->result == NULL) ||
+        (OpenclUploadBuffer(env, verifier->golden, MEM_STRATEGY_COPY, golden, golden_size,
+                            NULL) != 0)) {
+        DeviceVerifyRelease(verifier);
+        return -1;
+    }
+    return 0;
+}
+
+int DeviceVerifyRun(OpenCLEnv* env, const DeviceVerifier* verifier, cl_mem output,
+                    DeviceVerifyResult* result) {
+    KernelConfig cfg;
+    cl_int zero = 0;
+    cl_int counts[2];
+    cl_event event;
+    cl_int err;
+    float max_error;
+    cl_uint arg = 0U;
+
+    if ((env == NULL) || (verifier == NULL) || (verifier->kernel == NULL) || (output == NULL) ||
+        (result == NULL)) {
+        return -1;
+    }
+
+    err = clEnqueueFillBuffer(env->queue, verifier->result, &zero, sizeof(zero), 0U,
+                              2U * sizeof(cl_int), 0U, NULL, NULL);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Error: Failed to clear verification result (error: %d)\n", err);
+        return -1;
+    }
+
+    err = clSetKernelArg(verifier->kernel, arg++, sizeof(cl_mem), &output);
+    err |= clSetKernelArg(verifier->kernel, arg++, sizeof(cl_mem), &verifier->golden);
+    err |= clSetKernelArg(verifier->kernel, arg++, sizeof(int), &verifier->row_elems);
+    err |= clSetKernelArg(verifier->kernel, arg++, sizeof(int), &verifier->rows);
+    err |= clSetKernelArg(verifier->kernel, arg++, sizeof(int), &verifier->gpu_pitch);
+    err |= clSetKernelArg(verifier->kernel, arg++, sizeof(float), &verifier->tolerance);
+    err |= clSetKernelArg(verifier->kernel, arg++, sizeof(cl_mem), &verifier->result);
+    err |= clSetKernelArg(verifier->kernel, arg++, verifier->local_size * sizeof(cl_int), NULL);
+    err |= clSetKernelArg(verifier->kernel, arg, verifier->local_size * sizeof(float), NULL);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Error: Failed to set verification kernel arguments\n");
+        return -1;
+    }
+
+    (void)memset(&cfg, 0, sizeof(cfg));
+    cfg.work_dim = 1;
+    cfg.host_type = HOST_TYPE_STANDARD;
+    cfg.global_work_size[0] = verifier->groups * verifier->local_size;
+    cfg.local_work_size[0] = verifier->local_size;
+    if (OpenclEnqueueKernel(env, verifier->kernel, &cfg, cfg.local_work_size, 0U, NULL, &event) !=
+        0) {
+        return -1;
+    }
+    /* MISRA-C:2023 Rule 17.7: Check return value */
+    if (clReleaseEvent(event) != CL_SUCCESS) {
+        (void)fprintf(stderr, "Warning: Failed to release verification event\n");
+    }
+
+    /* Blocking 8-byte read; the in-order queue runs it after the compare */
+    if (OpenclReadbackBuffer(env, verifier->result, MEM_STRATEGY_COPY, counts, sizeof(counts),
+                             NULL) != 0) {
+        return -1;
+    }
+
+    (void)memcpy(&max_error, &counts[1], sizeof(max_error));
+    result->errors = (size_t)(unsigned int)counts[0];
+    result->total_elements = (size_t)verifier->row_elems * (size_t)verifier->rows;
+    result->max_error = max_error;
+    result->passed = (((float)result->errors / (float)result->total_elements) <=
+                      verifier->error_rate_threshold)
+                         ? 1
+                         : 0;
+    return 0;
+}
+
+void DeviceVerifyRelease(DeviceVerifier* verifier) {
+    if (verifier == NULL) {
+        return;
+    }
+    OpenclReleaseMemObject(verifier->golden, "verify_golden");
+    OpenclReleaseMemObject(verifier->result, "verify_result");
+    OpenclReleaseKernel(verifier->kernel);
+    verifier->golden = NULL;
+    verifier->result = NULL;
+    verifier->kernel = NULL;
+}
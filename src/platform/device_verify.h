@@ -0,0 +1,84 @@
+/**
+ * @file device_verify.h
+ * @brief Compare a device output with its golden without reading it back
+ *
+ * The golden is uploaded once; every check then runs one compare + reduce
+ * launch (include/cl/verify.cl) and reads back two ints: the number of
+ * elements above the tolerance and the largest |diff|. Benchmark
+ * iterations use it instead of a full-frame readback, so the per-iteration
+ * transfer is a few bytes; the output is only read back when a check fails.
+ *
+ * The verdict follows VerifyCompare(): passed when
+ * mismatches / elements <= error_rate_threshold. The histogram and worst
+ * element need the host comparison and are not produced here, and only
+ * the absolute tolerance is supported (no relative or ULP bound).
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: No dynamic memory allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#include "opencl_utils.h"
+#include "utils/verify.h"
+
+/**
+ * @brief Device-side state of one output's verification
+ */
+typedef struct {
+    cl_kernel kernel;           /**< verify_compare_u8 or verify_compare_f32 */
+    cl_mem golden;              /**< Golden output (packed) */
+    cl_mem result;              /**< (mismatches, max |diff| bits) */
+    int row_elems;              /**< Elements per row */
+    int rows;                   /**< Rows */
+    int gpu_pitch;              /**< Output row pitch in elements */
+    float tolerance;            /**< Max |diff| not counted as a mismatch */
+    float error_rate_threshold; /**< Max fraction of mismatches */
+    size_t local_size;          /**< Work-group size */
+    size_t groups;              /**< Work-groups per check */
+} DeviceVerifier;
+
+/**
+ * @brief Outcome of one device check
+ */
+typedef struct {
+    int passed;             /**< 1 if error rate <= threshold */
+    size_t errors;          /**< Elements with |diff| > tolerance */
+    size_t total_elements;  /**< Elements compared */
+    float max_error;        /**< Largest |diff| (INFINITY if non-finite) */
+} DeviceVerifyResult;
+
+/**
+ * @brief Build the compare kernel and upload the golden
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] opts Comparison settings (element type, size, tolerance, threshold)
+ * @param[in] golden Golden output, packed rows
+ * @param[in] output_pitch Row layout of the device output, or NULL if packed
+ * @param[out] verifier Verifier
+ * @return 0 on success, -1 on error (verifier is released)
+ */
+int DeviceVerifyCreate(OpenCLEnv* env, const VerifyOptions* opts, const void* golden,
+                       const ImagePitch* output_pitch, DeviceVerifier* verifier);
+
+/**
+ * @brief Compare a device output with the golden (blocking on the result only)
+ *
+ * Enqueued on env->queue after the commands that produce @p output.
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] verifier Verifier from DeviceVerifyCreate()
+ * @param[in] output Device output
+ * @param[out] result Outcome
+ * @return 0 on success, -1 on error
+ */
+int DeviceVerifyRun(OpenCLEnv* env, const DeviceVerifier* verifier, cl_mem output,
+                    DeviceVerifyResult* result);
+
+/**
+ * @brief Release the golden, the result buffer and the kernel
+ *
+ * @param[in,out] verifier Verifier (safe on a zeroed or released one)
+ */
+void DeviceVerifyRelease(DeviceVerifier* verifier);
@@ -0,0 +1,121 @@
+/**
+ * @file fusion.c
+ * @brief Fusion of elementwise kernels into stencil pipeline stages implementation
+ */
+
+#include "fusion.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cache_manager.h"
+#include "utils/mapped_file.h"
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static char fused_source[MAX_FUSED_SOURCE_SIZE];
+
+/* Append a kernel file to fused_source at *used, framed by a marker comment */
+static int AppendSource(const char* role, const char* path, size_t* used,
+                        int* has_epilogue_hook) {
+    MappedBuffer file = {0};
+    int written;
+
+    if (MappedFileOpen(path, 0U, &file) != 0) {
+        (void)fprintf(stderr, "Error: Failed to read kernel file for fusion: %s\n", path);
+        return -1;
+    }
+
+    written = snprintf(&fused_source[*used], sizeof(fused_source) - *used,
+                       "\n/* ---- %s: %s ---- */\n", role, path);
+    if ((written < 0) || ((size_t)written >= (sizeof(fused_source) - *used)) ||
+        (file.size >= (sizeof(fused_source) - *used - (size_t)written))) {
+        (void)fprintf(stderr, "Error: Fused source exceeds %u bytes\n",
+                      (unsigned int)MAX_FUSED_SOURCE_SIZE);
+        MappedBufferRelease(&file);
+        return -1;
+    }
+    *used += (size_t)written;
+    (void)memcpy(&fused_source[*used], file.data, file.size);
+    fused_source[*used + file.size] = '\0';
+
+    if (has_epilogue_hook != NULL) {
+        *has_epilogue_hook = (strstr(&fused_source[*used], "EPILOGUE(") != NULL) ? 1 : 0;
+    }
+    *used += file.size;
+    MappedBufferRelease(&file);
+    return 0;
+}
+
+int FusionCreateKernelConfig(const char* algorithm_id, const Config* config,
+                             const KernelConfig* stencil, const KernelConfig* elementwise,
+                             KernelConfig* fused) {
+    char name[MAX_CACHE_PATH];
+    char defines[256];
+    size_t used = 0U;
+    size_t option_len;
+    int has_hook = 0;
+    int written;
+
+    if ((algorithm_id == NULL) || (config == NULL) || (stencil == NULL) ||
+        (elementwise == NULL) || (fused == NULL) || (elementwise->epilogue[0] == '\0')) {
+        return -1;
+    }
+
+    written = snprintf(fused_source, sizeof(fused_source),
+                       "/* Generated: %s (%s) with epilogue %s of %s (%s) */\n",
+                       stencil->variant_id, stencil->kernel_function, elementwise->epilogue,
+                       elementwise->variant_id, elementwise->kernel_function);
+    if ((written < 0) || ((size_t)written >= sizeof(fused_source))) {
+        return -1;
+    }
+    used = (size_t)written;
+
+    if ((AppendSource("elementwise", elementwise->kernel_file, &used, NULL) != 0) ||
+        (AppendSource("stencil", stencil->kernel_file, &used, &has_hook) != 0)) {
+        return -1;
+    }
+    if (has_hook == 0) {
+        (void)fprintf(stderr, "Error: Kernel '%s' does not apply EPILOGUE() and cannot be fused\n",
+                      stencil->variant_id);
+        return -1;
+    }
+
+    written = snprintf(name, sizeof(name), "fused_%s_%s", stencil->variant_id,
+                       elementwise->variant_id);
+    if ((written < 0) || ((size_t)written >= sizeof(name))) {
+        return -1;
+    }
+
+    *fused = *stencil;
+    if (CacheSaveGeneratedSource(algorithm_id, name, fused_source, used, fused->kernel_file,
+                                 sizeof(fused->kernel_file)) != 0) {
+        return -1;
+    }
+
+    written = snprintf(fused->variant_id, sizeof(fused->variant_id), "%s+%s",
+                       stencil->variant_id, elementwise->variant_id);
+    if ((written < 0) || ((size_t)written >= sizeof(fused->variant_id))) {
+        (void)fprintf(stderr, "Error: Fused variant id '%s+%s' too long\n", stencil->variant_id,
+                      elementwise->variant_id);
+        return -1;
+    }
+
+    /* Stencil options, the epilogue binding, then the elementwise op's scalars as constants */
+    if (ComposeScalarDefines(config, elementwise, "EPI_", 0, defines, sizeof(defines)) != 0) {
+        (void)fprintf(stderr, "Error: Too many scalars for fused epilogue of '%s'\n",
+                      elementwise->variant_id);
+        return -1;
+    }
+    option_len = strlen(fused->kernel_option);
+    written = snprintf(&fused->kernel_option[option_len], sizeof(fused->kernel_option) - option_len,
+                       " -DFUSED_EPILOGUE=%s%s", elementwise->epilogue, defines);
+    if ((written < 0) || ((size_t)written >= (sizeof(fused->kernel_option) - option_len))) {
+        (void)fprintf(stderr, "Error: Build options of fused kernel '%s' too long\n",
+                      fused->variant_id);
+        return -1;
+    }
+
+    (void)printf("Fused %s into %s: %s\n", elementwise->variant_id, stencil->variant_id,
+                 fused->kernel_file);
+    return 0;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file fusion.h
+ * @brief Fusion of elementwise kernels into stencil pipeline stages
+ *
+ * A pipeline stage {"kernel": "<stencil>", "fuse": "<elementwise>"} runs
+ * both kernels as one: the stencil stores EPILOGUE(value) instead of value,
+ * and the fused build binds EPILOGUE to the elementwise kernel's epilogue
+ * (its "epilogue" entry, a uchar -> uchar function or macro in its .cl
+ * file). The intermediate image is never written to or re-read from global
+ * memory, and one launch replaces two.
+ *
+ * The generated source is the elementwise kernel file followed by the
+ * stencil kernel file; it is saved as out/{algorithm}/fused_<a>_<b>.cl and
+ * built through OpenclBuildKernel() with the stencil's options plus
+ * -DFUSED_EPILOGUE=<epilogue>, so the binary cache and program registry
+ * key on it like on any other kernel. Config scalars read by the
+ * elementwise kernel's arguments become -DEPI_<NAME> constants, since the
+ * fused kernel only takes the stencil's arguments.
+ *
+ * The elementwise op must map each output pixel of the stencil 1:1
+ * (same size and element type).
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: No dynamic memory allocation (static source buffer)
+ * - Rule 17.7: All functions return status for error checking
+ */
+
+#pragma once
+
+#include "utils/config.h"
+
+/** Maximum size of a generated fused source in bytes */
+#define MAX_FUSED_SOURCE_SIZE (256U * 1024U)
+
+/**
+ * @brief Generate the fused source and the kernel configuration building it
+ *
+ * @param[in] algorithm_id Algorithm identifier (generated source directory)
+ * @param[in] config Configuration (scalars)
+ * @param[in] stencil Stencil kernel (must apply EPILOGUE() to its stores)
+ * @param[in] elementwise Elementwise kernel with an "epilogue"
+ * @param[out] fused Copy of the stencil configuration with the generated
+ *                   kernel file and fused build options
+ * @return 0 on success, -1 on error
+ */
+int FusionCreateKernelConfig(const char* algorithm_id, const Config* config,
+                             const KernelConfig* stencil, const KernelConfig* elementwise,
+                             KernelConfig* fused);
@@ -0,0 +1,286 @@
+/**
+ * @file image_view.c
+ * @brief 2D image views of device buffers and border-mode samplers implementation
+ */
+
+#include "image_view.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/** One cached image view */
+typedef struct {
+    cl_mem image;           /**< Image object (NULL = free slot) */
+    cl_mem buffer;          /**< Buffer it views */
+    cl_mem_flags flags;     /**< Access flags */
+    cl_image_format format; /**< Pixel format */
+    size_t width;           /**< Width in pixels */
+    size_t height;          /**< Height in pixels */
+    size_t row_pitch;       /**< Row pitch in bytes */
+    unsigned long created;  /**< Creation tick, for oldest-first eviction */
+} ImageView;
+
+/** One cached sampler */
+typedef struct {
+    cl_sampler sampler;            /**< Sampler object (NULL = free slot) */
+    cl_context context;            /**< Context it belongs to */
+    cl_addressing_mode addressing; /**< Addressing mode */
+    cl_filter_mode filter;         /**< Filter mode */
+} CachedSampler;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static ImageView views[MAX_IMAGE_VIEWS];
+static CachedSampler samplers[MAX_IMAGE_SAMPLERS];
+static unsigned long create_tick = 0UL;
+
+/* Image format for a channel count and data type; -1 if not representable */
+static int ImageFormat(DataType data_type, int channels, cl_image_format* format,
+                       size_t* elem_bytes_out) {
+    size_t elem_bytes;
+
+    switch (channels) {
+        case 1:
+            format->image_channel_order = CL_R;
+            break;
+        case 2:
+            format->image_channel_order = CL_RG;
+            break;
+        case 4:
+            format->image_channel_order = CL_RGBA;
+            break;
+        default:
+            return -1;
+    }
+    switch (data_type) {
+        case DATA_TYPE_UCHAR:
+            format->image_channel_data_type = CL_UNSIGNED_INT8;
+            elem_bytes = 1U;
+            break;
+        case DATA_TYPE_SHORT:
+            format->image_channel_data_type = CL_SIGNED_INT16;
+            elem_bytes = 2U;
+            break;
+        case DATA_TYPE_INT:
+            format->image_channel_data_type = CL_SIGNED_INT32;
+            elem_bytes = 4U;
+            break;
+        case DATA_TYPE_FLOAT:
+            format->image_channel_data_type = CL_FLOAT;
+            elem_bytes = 4U;
+            break;
+        case DATA_TYPE_HALF:
+            format->image_channel_data_type = CL_HALF_FLOAT;
+            elem_bytes = 2U;
+            break;
+        default:
+            return -1;
+    }
+    *elem_bytes_out = elem_bytes;
+    return 0;
+}
+
+/* Release one view */
+static void FreeView(ImageView* view) {
+    cl_int err;
+
+    err = clReleaseMemObject(view->image);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Warning: Failed to release image view (error: %d)\n", err);
+    }
+    (void)memset(view, 0, sizeof(*view));
+}
+
+cl_mem ImageViewGet(cl_mem buffer, cl_mem_flags flags, DataType data_type, int width, int height,
+                    int channels, int row_stride, cl_int* errcode_ret) {
+    cl_image_format format;
+    cl_image_desc desc;
+    cl_context context;
+    ImageView* slot = NULL;
+    size_t elem_bytes = 0U;
+    size_t row_pitch;
+    cl_int err = CL_INVALID_VALUE;
+    cl_mem image;
+    int i;
+
+    if (errcode_ret != NULL) {
+        *errcode_ret = CL_INVALID_VALUE;
+    }
+    if ((buffer == NULL) || (width <= 0) || (height <= 0)) {
+        return NULL;
+    }
+    if (ImageFormat(data_type, channels, &format, &elem_bytes) != 0) {
+        (void)fprintf(stderr, "Error: No image format for %d channel(s) of this data type\n",
+                      channels);
+        return NULL;
+    }
+    if (row_stride < (width * channels)) {
+        (void)fprintf(stderr, "Error: Image row stride %d below row size %d\n", row_stride,
+                      width * channels);
+        return NULL;
+    }
+    row_pitch = (size_t)row_stride * elem_bytes;
+
+    for (i = 0; i < MAX_IMAGE_VIEWS; i++) {
+        const ImageView* view = &views[i];
+        if ((view->image != NULL) && (view->buffer == buffer) && (view->flags == flags) &&
+            (view->format.image_channel_order == format.image_channel_order) &&
+            (view->format.image_channel_data_type == format.image_channel_data_type) &&
+            (view->width == (size_t)width) && (view->height == (size_t)height) &&
+            (view->row_pitch == row_pitch)) {
+            if (errcode_ret != NULL) {
+                *errcode_ret = CL_SUCCESS;
+            }
+            return view->image;
+        }
+    }
+
+    err = clGetMemObjectInfo(buffer, CL_MEM_CONTEXT, sizeof(context), &context, NULL);
+    if (err != CL_SUCCESS) {
+        if (errcode_ret != NULL) {
+            *errcode_ret = err;
+        }
+        return NULL;
+    }
+
+    (void)memset(&desc, 0, sizeof(desc));
+    desc.image_type = CL_MEM_OBJECT_IMAGE2D;
+    desc.image_width = (size_t)width;
+    desc.image_height = (size_t)height;
+    desc.image_row_pitch = row_pitch;
+    desc.buffer = buffer;
+    image = clCreateImage(context, flags, &format, &desc, NULL, &err);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr,
+                      "Error: Failed to create %dx%d image view of buffer (error: %d); needs "
+                      "image-from-buffer support and a row pitch (%zu B) aligned to "
+                      "CL_DEVICE_IMAGE_PITCH_ALIGNMENT (try \"pitched\": true)\n",
+                      width, height, err, row_pitch);
+        if (errcode_ret != NULL) {
+            *errcode_ret = err;
+        }
+        return NULL;
+    }
+
+    /* Free slot, else the oldest view */
+    for (i = 0; i < MAX_IMAGE_VIEWS; i++) {
+        if (views[i].image == NULL) {
+            slot = &views[i];
+            break;
+        }
+        if ((slot == NULL) || (views[i].created < slot->created)) {
+            slot = &views[i];
+        }
+    }
+    if (slot->image != NULL) {
+        FreeView(slot);
+    }
+    create_tick++;
+    slot->image = image;
+    slot->buffer = buffer;
+    slot->flags = flags;
+    slot->format = format;
+    slot->width = (size_t)width;
+    slot->height = (size_t)height;
+    slot->row_pitch = row_pitch;
+    slot->created = create_tick;
+
+    if (errcode_ret != NULL) {
+        *errcode_ret = CL_SUCCESS;
+    }
+    return image;
+}
+
+cl_sampler ImageViewGetSampler(cl_context context, BorderMode border_mode, int linear,
+                               cl_int* errcode_ret) {
+    cl_addressing_mode addressing;
+    cl_filter_mode filter = (linear != 0) ? CL_FILTER_LINEAR : CL_FILTER_NEAREST;
+    cl_sampler sampler;
+    cl_int err;
+    int i;
+
+    switch (border_mode) {
+        case BORDER_CONSTANT:
+            addressing = CL_ADDRESS_CLAMP;
+            break;
+        case BORDER_REFLECT:
+            addressing = CL_ADDRESS_MIRRORED_REPEAT;
+            break;
+        case BORDER_WRAP:
+            addressing = CL_ADDRESS_REPEAT;
+            break;
+        default:
+            addressing = CL_ADDRESS_CLAMP_TO_EDGE;
+            break;
+    }
+
+    for (i = 0; i < MAX_IMAGE_SAMPLERS; i++) {
+        if ((samplers[i].sampler != NULL) && (samplers[i].context == context) &&
+            (samplers[i].addressing == addressing) && (samplers[i].filter == filter)) {
+            if (errcode_ret != NULL) {
+                *errcode_ret = CL_SUCCESS;
+            }
+            return samplers[i].sampler;
+        }
+    }
+
+    for (i = 0; i < MAX_IMAGE_SAMPLERS; i++) {
+        if (samplers[i].sampler == NULL) {
+            break;
+        }
+    }
+    if (i == MAX_IMAGE_SAMPLERS) {
+        (void)fprintf(stderr, "Error: Sampler table full (max %d)\n", MAX_IMAGE_SAMPLERS);
+        if (errcode_ret != NULL) {
+            *errcode_ret = CL_OUT_OF_RESOURCES;
+        }
+        return NULL;
+    }
+
+    sampler = clCreateSampler(context, CL_TRUE, addressing, filter, &err);
+    if (errcode_ret != NULL) {
+        *errcode_ret = err;
+    }
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Error: Failed to create sampler (error: %d)\n", err);
+        return NULL;
+    }
+    samplers[i].sampler = sampler;
+    samplers[i].context = context;
+    samplers[i].addressing = addressing;
+    samplers[i].filter = filter;
+    return sampler;
+}
+
+void ImageViewReleaseBuffer(cl_mem buffer) {
+    int i;
+
+    if (buffer == NULL) {
+        return;
+    }
+    for (i = 0; i < MAX_IMAGE_VIEWS; i++) {
+        if ((views[i].image != NULL) && (views[i].buffer == buffer)) {
+            FreeView(&views[i]);
+        }
+    }
+}
+
+void ImageViewReleaseAll(void) {
+    cl_int err;
+    int i;
+
+    for (i = 0; i < MAX_IMAGE_VIEWS; i++) {
+        if (views[i].image != NULL) {
+            FreeView(&views[i]);
+        }
+    }
+    for (i = 0; i < MAX_IMAGE_SAMPLERS; i++) {
+        if (samplers[i].sampler != NULL) {
+            err = clReleaseSampler(samplers[i].sampler);
+            if (err != CL_SUCCESS) {
+                (void)fprintf(stderr, "Warning: Failed to release sampler (error: %d)\n", err);
+            }
+        }
+    }
+    (void)memset(samplers, 0, sizeof(samplers));
+    create_tick = 0UL;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file image_view.h
+ * @brief 2D image views of device buffers and border-mode samplers
+ *
+ * Kernel arguments declared "i_image" / "o_image" read and write the same
+ * input and output buffers as "i_buffer" / "o_buffer", through an image2d_t
+ * created over the buffer (OpenCL 2.0 image-from-buffer, or the
+ * cl_khr_image2d_from_buffer extension). Reads go through the texture path,
+ * and out-of-range coordinates are resolved by the sampler instead of
+ * per-pixel clamping in the kernel. Buffer uploads and readbacks, streams
+ * and pipelines are unchanged, since the view shares the buffer's memory.
+ *
+ * Views are cached by (buffer, access, format, size, row pitch) and
+ * released with their buffer in OpenclReleaseMemObject(); samplers are
+ * cached per (context, addressing, filter). The row pitch must be a
+ * multiple of CL_DEVICE_IMAGE_PITCH_ALIGNMENT pixels ("pitched": true
+ * pads rows to it).
+ *
+ * Sampler addressing mode per BorderMode (normalized coordinates, which
+ * REPEAT and MIRRORED_REPEAT require):
+ * - BORDER_CLAMP, BORDER_REPLICATE: CL_ADDRESS_CLAMP_TO_EDGE
+ * - BORDER_CONSTANT: CL_ADDRESS_CLAMP (border color 0 only)
+ * - BORDER_REFLECT: CL_ADDRESS_MIRRORED_REPEAT
+ * - BORDER_WRAP: CL_ADDRESS_REPEAT
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Static view and sampler tables, no dynamic memory allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include "op_interface.h"
+#include "utils/config.h"
+
+/** Maximum image views held at once (oldest released first when full) */
+#define MAX_IMAGE_VIEWS 32
+
+/** Maximum cached samplers */
+#define MAX_IMAGE_SAMPLERS 16
+
+/**
+ * @brief Get a 2D image view of a buffer
+ *
+ * @param[in] buffer Buffer holding the image rows
+ * @param[in] flags CL_MEM_READ_ONLY or CL_MEM_WRITE_ONLY
+ * @param[in] data_type Channel data type (uchar, short, int or float)
+ * @param[in] width Image width in pixels
+ * @param[in] height Image height in pixels
+ * @param[in] channels Channels per pixel (1, 2 or 4)
+ * @param[in] row_stride Row stride in elements, as OpParams src_stride / dst_stride
+ * @param[out] errcode_ret Error code (may be NULL)
+ * @return Image (owned by the cache), or NULL on error
+ */
+cl_mem ImageViewGet(cl_mem buffer, cl_mem_flags flags, DataType data_type, int width, int height,
+                    int channels, int row_stride, cl_int* errcode_ret);
+
+/**
+ * @brief Get a sampler for a border mode
+ *
+ * @param[in] context OpenCL context
+ * @param[in] border_mode Border handling (see the table above)
+ * @param[in] linear Non-zero for CL_FILTER_LINEAR, 0 for CL_FILTER_NEAREST
+ * @param[out] errcode_ret Error code (may be NULL)
+ * @return Sampler (owned by the cache), or NULL on error
+ */
+cl_sampler ImageViewGetSampler(cl_context context, BorderMode border_mode, int linear,
+                               cl_int* errcode_ret);
+
+/**
+ * @brief Release the views of a buffer (called before the buffer is released)
+ *
+ * @param[in] buffer Buffer
+ */
+void ImageViewReleaseBuffer(cl_mem buffer);
+
+/**
+ * @brief Release all views and samplers
+ */
+void ImageViewReleaseAll(void);
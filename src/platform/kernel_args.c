@@ -3,9 +3,10 @@
  * @brief Kernel argument handling for OpenCL kernels
  *
  * Provides functions to set kernel arguments based on configuration:
- * - Lookup OpParams fields by name (int, float, size_t)
- * - Set kernel arguments from KernelConfig descriptors
+ * - Resolve OpParams fields by name (int, float, size_t) to indices and offsets
+ * - Compile KernelConfig descriptors into a binding plan, bind dirty slots only
  * - Support for buffers, scalars, and packed structs
+ * - Image views of buffers and samplers (see image_view.h)
  *
  * MISRA C 2023 Compliance:
  * - Rule 17.7: All OpenCL API return values checked
@@ -24,6 +25,7 @@
 #include <CL/cl.h>
 #endif
 
+#include "image_view.h"
 #include "op_interface.h"
 #include "utils/config.h"
 
@@ -36,190 +38,275 @@ typedef struct {
 static const OpParamsIntField kOpParamsIntFields[] = {
     {"src_width", offsetof(OpParams, src_width)},
     {"src_height", offsetof(OpParams, src_height)},
+    {"src_channels", offsetof(OpParams, src_channels)},
     {"src_stride", offsetof(OpParams, src_stride)},
     {"dst_width", offsetof(OpParams, dst_width)},
     {"dst_height", offsetof(OpParams, dst_height)},
+    {"dst_channels", offsetof(OpParams, dst_channels)},
     {"dst_stride", offsetof(OpParams, dst_stride)},
     {"kernel_variant", offsetof(OpParams, kernel_variant)},
     {NULL, 0} /* sentinel */
 };
 
 /**
- * @brief Lookup an int field in OpParams by name
+ * @brief Bytes of a scalar of the given type (0 for an unknown type)
+ */
+static size_t ScalarSize(ScalarType type) {
+    switch (type) {
+        case SCALAR_TYPE_INT:
+            return sizeof(int);
+        case SCALAR_TYPE_FLOAT:
+            return sizeof(float);
+        case SCALAR_TYPE_SIZE:
+            return sizeof(size_t);
+        default:
+            return 0U;
+    }
+}
+
+/**
+ * @brief Resolve a scalar source by name
  *
- * First checks built-in OpParams fields (src_width, dst_height, etc.),
- * then falls back to custom_scalars for algorithm-specific parameters.
+ * Int sources check the built-in OpParams fields first (src_width,
+ * dst_height, etc.), then custom_scalars; float and size_t sources only
+ * exist in custom_scalars. SCALAR_TYPE_NONE matches a custom scalar of any
+ * type (struct fields).
  *
- * @param params The OpParams struct to lookup from
- * @param field_name The name of the field to find
- * @return Pointer to the int field, or NULL if not found
+ * @param[in] params The OpParams struct to resolve against
+ * @param[in] field_name The name of the field to find
+ * @param[in] type Required scalar type, or SCALAR_TYPE_NONE
+ * @param[in] value_offset Offset of the scalar in the packed slot value
+ * @param[out] source Resolved source
+ * @return 0 on success, -1 if not found
  */
-static const int* OpParamsLookupInt(const OpParams* params, const char* field_name) {
+static int ResolveScalarSource(const OpParams* params, const char* field_name, ScalarType type,
+                               size_t value_offset, KernelArgSource* source) {
     const OpParamsIntField* field;
     int i;
 
-    if ((params == NULL) || (field_name == NULL)) {
-        return NULL;
-    }
+    source->value_offset = value_offset;
 
     /* Check built-in fields first (fast path for common parameters) */
-    for (field = kOpParamsIntFields; field->name != NULL; field++) {
-        if (strcmp(field->name, field_name) == 0) {
-            /* Calculate pointer to field using offset */
-            return (const int*)((const char*)params + field->offset);
+    if (type == SCALAR_TYPE_INT) {
+        for (field = kOpParamsIntFields; field->name != NULL; field++) {
+            if (strcmp(field->name, field_name) == 0) {
+                source->scalar_index = -1;
+                source->type = SCALAR_TYPE_INT;
+                source->param_offset = field->offset;
+                source->size = sizeof(int);
+                return 0;
+            }
         }
     }
 
     /* Fallback to custom_scalars for algorithm-specific parameters */
     if (params->custom_scalars != NULL) {
         for (i = 0; i < params->custom_scalars->count; i++) {
-            if ((params->custom_scalars->scalars[i].type == SCALAR_TYPE_INT) &&
-                (strcmp(params->custom_scalars->scalars[i].name, field_name) == 0)) {
-                return &params->custom_scalars->scalars[i].value.int_value;
+            const ScalarValue* sv = &params->custom_scalars->scalars[i];
+
+            if (((type == SCALAR_TYPE_NONE) || (sv->type == type)) &&
+                (strcmp(sv->name, field_name) == 0)) {
+                source->scalar_index = i;
+                source->type = sv->type;
+                source->param_offset = 0U;
+                source->size = ScalarSize(sv->type);
+                return 0;
             }
         }
     }
 
-    return NULL;
+    return -1;
 }
 
 /**
- * @brief Lookup a float field in custom_scalars by name
- *
- * Float fields are only supported via custom_scalars (no built-in float fields).
+ * @brief Current value of a resolved scalar source
  *
- * @param params The OpParams struct to lookup from
- * @param field_name The name of the field to find
- * @return Pointer to the float field, or NULL if not found
+ * @return Pointer to the scalar, or NULL if params no longer has it
  */
-static const float* OpParamsLookupFloat(const OpParams* params, const char* field_name) {
-    int i;
+static const void* SourceValue(const OpParams* params, const KernelArgSource* source) {
+    const ScalarValue* sv;
 
-    if ((params == NULL) || (field_name == NULL)) {
+    if (source->scalar_index < 0) {
+        /* Calculate pointer to field using offset */
+        return (const char*)params + source->param_offset;
+    }
+    if ((params->custom_scalars == NULL) ||
+        (source->scalar_index >= params->custom_scalars->count)) {
         return NULL;
     }
+    sv = &params->custom_scalars->scalars[source->scalar_index];
+    if (sv->type != source->type) {
+        return NULL;
+    }
+    switch (sv->type) {
+        case SCALAR_TYPE_INT:
+            return &sv->value.int_value;
+        case SCALAR_TYPE_FLOAT:
+            return &sv->value.float_value;
+        case SCALAR_TYPE_SIZE:
+            return &sv->value.size_value;
+        default:
+            return NULL;
+    }
+}
 
-    /* Float fields are only in custom_scalars */
-    if (params->custom_scalars != NULL) {
-        for (i = 0; i < params->custom_scalars->count; i++) {
-            if ((params->custom_scalars->scalars[i].type == SCALAR_TYPE_FLOAT) &&
-                (strcmp(params->custom_scalars->scalars[i].name, field_name) == 0)) {
-                return &params->custom_scalars->scalars[i].value.float_value;
-            }
+/**
+ * @brief Copy the current scalar values into a slot's packed value
+ *
+ * @return 1 if the value changed, 0 if not, -1 if a source is gone
+ */
+static int LoadSources(KernelArgSlot* slot, const OpParams* params) {
+    int changed = 0;
+    int i;
+
+    for (i = 0; i < slot->source_count; i++) {
+        const KernelArgSource* source = &slot->sources[i];
+        const void* value = SourceValue(params, source);
+
+        if (value == NULL) {
+            return -1;
+        }
+        if (memcmp(slot->value + source->value_offset, value, source->size) != 0) {
+            (void)memcpy(slot->value + source->value_offset, value, source->size);
+            changed = 1;
         }
     }
+    return changed;
+}
 
-    return NULL;
+/**
+ * @brief Store a fixed value (buffer handle, sampler, size) in a slot
+ */
+static void SetSlotValue(KernelArgSlot* slot, const void* value, size_t size) {
+    slot->kind = KERNEL_ARG_SLOT_VALUE;
+    slot->size = size;
+    (void)memcpy(slot->value, value, size);
 }
 
 /**
- * @brief Lookup a size_t field in custom_scalars by name
+ * @brief Resolve a single scalar argument
  *
- * Size_t fields are only supported via custom_scalars (no built-in size_t fields).
- *
- * @param params The OpParams struct to lookup from
- * @param field_name The name of the field to find
- * @return Pointer to the size_t field, or NULL if not found
+ * @param[out] slot Slot to fill
+ * @param[in] params Operation parameters
+ * @param[in] source_name Scalar name
+ * @param[in] type Scalar type
+ * @return 0 on success, -1 if not found
  */
-static const size_t* OpParamsLookupSize(const OpParams* params, const char* field_name) {
-    int i;
-
-    if ((params == NULL) || (field_name == NULL)) {
-        return NULL;
+static int ResolveScalarArg(KernelArgSlot* slot, const OpParams* params, const char* source_name,
+                            ScalarType type) {
+    if (ResolveScalarSource(params, source_name, type, 0U, &slot->sources[0]) != 0) {
+        return -1;
     }
+    slot->kind = KERNEL_ARG_SLOT_VALUE;
+    slot->size = slot->sources[0].size;
+    slot->source_count = 1;
+    return (LoadSources(slot, params) < 0) ? -1 : 0;
+}
 
-    /* Size_t fields are only in custom_scalars */
-    if (params->custom_scalars != NULL) {
-        for (i = 0; i < params->custom_scalars->count; i++) {
-            if ((params->custom_scalars->scalars[i].type == SCALAR_TYPE_SIZE) &&
-                (strcmp(params->custom_scalars->scalars[i].name, field_name) == 0)) {
-                return &params->custom_scalars->scalars[i].value.size_value;
+/**
+ * @brief Buffer of an o_buffer argument
+ *
+ * Secondary outputs of a multi-output kernel (OpParams.outputs) are bound
+ * by name; every other output argument gets the primary output buffer.
+ *
+ * @param[in] params Operation parameters
+ * @param[in] source_name Argument name
+ * @return Secondary output buffer, or NULL for the primary output
+ */
+static cl_mem NamedOutputBuffer(const OpParams* params, const char* source_name) {
+    int j;
+
+    if (params->outputs != NULL) {
+        for (j = 0; j < params->outputs->count; j++) {
+            if ((params->outputs->buffers[j].buffer != NULL) &&
+                (strcmp(params->outputs->buffers[j].name, source_name) == 0)) {
+                return params->outputs->buffers[j].buffer;
             }
         }
     }
-
     return NULL;
 }
 
 /**
- * @brief Set a custom buffer kernel argument
- *
- * Finds and sets a custom buffer by name or numeric index.
+ * @brief Find a custom buffer by name or numeric index
  *
- * @param kernel OpenCL kernel
- * @param arg_idx Current argument index (will be incremented)
  * @param custom_buffers Available custom buffers
- * @param source_name Buffer name or numeric index string
- * @return 0 on success, -1 on error
+ * @param buffer_name Buffer name or numeric index string
+ * @return Buffer index, or -1 if not found
  */
-static int SetCustomBufferArg(cl_kernel kernel, cl_uint* arg_idx,
-                              const CustomBuffers* custom_buffers, const char* source_name) {
+static int FindCustomBuffer(const CustomBuffers* custom_buffers, const char* buffer_name) {
     int buffer_idx = -1;
     int j;
 
-    if (custom_buffers == NULL) {
-        (void)fprintf(stderr,
-                      "Error: Custom buffer '%s' requested but no custom buffers available\n",
-                      source_name);
-        return -1;
-    }
-
-    /* Check if source_name is a numeric index */
-    if (source_name[0] >= '0' && source_name[0] <= '9') {
+    /* Check if buffer_name is a numeric index */
+    if (buffer_name[0] >= '0' && buffer_name[0] <= '9') {
         /* Parse as integer index */
-        buffer_idx = atoi(source_name);
+        buffer_idx = atoi(buffer_name);
         if (buffer_idx < 0 || buffer_idx >= custom_buffers->count) {
-            (void)fprintf(stderr, "Error: Buffer index %d out of range (0-%d)\n",
-                          buffer_idx, custom_buffers->count - 1);
+            (void)fprintf(stderr, "Error: Buffer index %d out of range (0-%d)\n", buffer_idx,
+                          custom_buffers->count - 1);
             return -1;
         }
-    } else {
-        /* Look up by name */
-        for (j = 0; j < custom_buffers->count; j++) {
-            if (strcmp(custom_buffers->buffers[j].name, source_name) == 0) {
-                buffer_idx = j;
-                break;
-            }
-        }
+        return buffer_idx;
+    }
 
-        if (buffer_idx < 0) {
-            (void)fprintf(stderr, "Error: Custom buffer '%s' not found\n", source_name);
-            return -1;
+    /* Look up by name */
+    for (j = 0; j < custom_buffers->count; j++) {
+        if (strcmp(custom_buffers->buffers[j].name, buffer_name) == 0) {
+            return j;
         }
     }
+    (void)fprintf(stderr, "Error: Custom buffer '%s' not found\n", buffer_name);
+    return -1;
+}
+
+/**
+ * @brief Resolve a custom buffer kernel argument
+ *
+ * @param[out] slot Slot to fill
+ * @param custom_buffers Available custom buffers
+ * @param source_name Buffer name or numeric index string
+ * @return 0 on success, -1 on error
+ */
+static int ResolveCustomBufferArg(KernelArgSlot* slot, const CustomBuffers* custom_buffers,
+                                  const char* source_name) {
+    int buffer_idx;
 
-    if (clSetKernelArg(kernel, (*arg_idx)++, sizeof(cl_mem),
-                       &custom_buffers->buffers[buffer_idx].buffer) != CL_SUCCESS) {
-        (void)fprintf(stderr, "Error: Failed to set custom buffer '%s' at arg %d\n",
-                      source_name, *arg_idx - 1);
+    if (custom_buffers == NULL) {
+        (void)fprintf(stderr,
+                      "Error: Custom buffer '%s' requested but no custom buffers available\n",
+                      source_name);
         return -1;
     }
-
+    buffer_idx = FindCustomBuffer(custom_buffers, source_name);
+    if (buffer_idx < 0) {
+        return -1;
+    }
+    SetSlotValue(slot, &custom_buffers->buffers[buffer_idx].buffer, sizeof(cl_mem));
     return 0;
 }
 
 /**
- * @brief Set a size_t scalar kernel argument
+ * @brief Resolve a size_t scalar kernel argument
  *
  * Handles both buffer.size format and custom scalar size_t values.
  *
- * @param kernel OpenCL kernel
- * @param arg_idx Current argument index (will be incremented)
+ * @param[out] slot Slot to fill
  * @param params Operation parameters
  * @param custom_buffers Available custom buffers
  * @param source_name Source name (e.g., "buffer.size" or scalar name)
  * @return 0 on success, -1 on error
  */
-static int SetSizeTArg(cl_kernel kernel, cl_uint* arg_idx, const OpParams* params,
-                       const CustomBuffers* custom_buffers, const char* source_name) {
+static int ResolveSizeTArg(KernelArgSlot* slot, const OpParams* params,
+                           const CustomBuffers* custom_buffers, const char* source_name) {
     const char* dot = strchr(source_name, '.');
 
     if (dot != NULL && strcmp(dot, ".size") == 0) {
         /* Buffer size format: "buffer_name.size" or "index.size" */
         char buffer_name[64];
         size_t name_len = (size_t)(dot - source_name);
-        int buffer_idx = -1;
-        int j;
+        unsigned long buffer_size;
+        int buffer_idx;
 
         if (name_len >= sizeof(buffer_name)) {
             (void)fprintf(stderr, "Error: Buffer name/index too long in '%s'\n", source_name);
@@ -234,70 +321,39 @@ static int SetSizeTArg(cl_kernel kernel, cl_uint* arg_idx, const OpParams* param
                           source_name);
             return -1;
         }
-
-        /* Check if buffer_name is a numeric index */
-        if (buffer_name[0] >= '0' && buffer_name[0] <= '9') {
-            buffer_idx = atoi(buffer_name);
-            if (buffer_idx < 0 || buffer_idx >= custom_buffers->count) {
-                (void)fprintf(stderr, "Error: Buffer index %d out of range (0-%d) in '%s'\n",
-                              buffer_idx, custom_buffers->count - 1, source_name);
-                return -1;
-            }
-        } else {
-            /* Look up by name */
-            for (j = 0; j < custom_buffers->count; j++) {
-                if (strcmp(custom_buffers->buffers[j].name, buffer_name) == 0) {
-                    buffer_idx = j;
-                    break;
-                }
-            }
-
-            if (buffer_idx < 0) {
-                (void)fprintf(stderr, "Error: Buffer '%s' not found for size_t arg\n", buffer_name);
-                return -1;
-            }
-        }
-
-        /* Set the buffer size as unsigned long (OpenCL kernel convention) */
-        unsigned long buffer_size = (unsigned long)custom_buffers->buffers[buffer_idx].size_bytes;
-        if (clSetKernelArg(kernel, (*arg_idx)++, sizeof(unsigned long), &buffer_size) !=
-            CL_SUCCESS) {
-            (void)fprintf(stderr, "Error: Failed to set size_t arg for '%s' at arg %d\n",
-                          buffer_name, *arg_idx - 1);
-            return -1;
-        }
-    } else {
-        /* Custom scalar size_t: lookup in custom_scalars */
-        const size_t* value_ptr = OpParamsLookupSize(params, source_name);
-        if (value_ptr == NULL) {
-            (void)fprintf(stderr, "Error: Unknown size_t scalar source '%s'\n", source_name);
-            return -1;
-        }
-        if (clSetKernelArg(kernel, (*arg_idx)++, sizeof(size_t), value_ptr) != CL_SUCCESS) {
-            (void)fprintf(stderr, "Error: Failed to set scalar size_t '%s' at arg %d\n",
-                          source_name, *arg_idx - 1);
+        buffer_idx = FindCustomBuffer(custom_buffers, buffer_name);
+        if (buffer_idx < 0) {
             return -1;
         }
+
+        /* The buffer size as unsigned long (OpenCL kernel convention) */
+        buffer_size = (unsigned long)custom_buffers->buffers[buffer_idx].size_bytes;
+        SetSlotValue(slot, &buffer_size, sizeof(unsigned long));
+        return 0;
     }
 
+    /* Custom scalar size_t: lookup in custom_scalars */
+    if (ResolveScalarArg(slot, params, source_name, SCALAR_TYPE_SIZE) != 0) {
+        (void)fprintf(stderr, "Error: Unknown size_t scalar source '%s'\n", source_name);
+        return -1;
+    }
     return 0;
 }
 
 /**
- * @brief Set a struct kernel argument
+ * @brief Resolve a struct kernel argument
  *
- * Packs scalar fields into a struct buffer and sets as kernel argument.
+ * Lays the scalar fields out back to back in the slot value and records
+ * where each one comes from, so a refresh can repack single fields.
  *
- * @param kernel OpenCL kernel
- * @param arg_idx Current argument index (will be incremented)
+ * @param[out] slot Slot to fill
  * @param params Operation parameters (contains custom_scalars)
  * @param arg_desc Kernel argument descriptor with struct field info
  * @return 0 on success, -1 on error
  */
-static int SetStructArg(cl_kernel kernel, cl_uint* arg_idx, const OpParams* params,
-                        const KernelArgDescriptor* arg_desc) {
-    unsigned char struct_buffer[256]; /* Max struct size */
-    size_t struct_size = 0;
+static int ResolveStructArg(KernelArgSlot* slot, const OpParams* params,
+                            const KernelArgDescriptor* arg_desc) {
+    size_t struct_size = 0U;
     int field_idx;
 
     if (params->custom_scalars == NULL) {
@@ -305,190 +361,379 @@ static int SetStructArg(cl_kernel kernel, cl_uint* arg_idx, const OpParams* para
         return -1;
     }
 
-    /* Pack each field into the struct buffer */
     for (field_idx = 0; field_idx < arg_desc->struct_field_count; field_idx++) {
         const char* field_name = arg_desc->struct_fields[field_idx];
-        int scalar_idx;
-        int found = 0;
-
-        /* Find the scalar by name */
-        for (scalar_idx = 0; scalar_idx < params->custom_scalars->count; scalar_idx++) {
-            if (strcmp(params->custom_scalars->scalars[scalar_idx].name, field_name) == 0) {
-                const ScalarValue* sv = &params->custom_scalars->scalars[scalar_idx];
-
-                /* Pack based on type */
-                switch (sv->type) {
-                    case SCALAR_TYPE_INT:
-                        if (struct_size + sizeof(int) > sizeof(struct_buffer)) {
-                            (void)fprintf(stderr, "Error: Struct too large\n");
-                            return -1;
-                        }
-                        (void)memcpy(struct_buffer + struct_size, &sv->value.int_value,
-                                     sizeof(int));
-                        struct_size += sizeof(int);
-                        break;
-                    case SCALAR_TYPE_FLOAT:
-                        if (struct_size + sizeof(float) > sizeof(struct_buffer)) {
-                            (void)fprintf(stderr, "Error: Struct too large\n");
-                            return -1;
-                        }
-                        (void)memcpy(struct_buffer + struct_size, &sv->value.float_value,
-                                     sizeof(float));
-                        struct_size += sizeof(float);
-                        break;
-                    case SCALAR_TYPE_SIZE:
-                        if (struct_size + sizeof(size_t) > sizeof(struct_buffer)) {
-                            (void)fprintf(stderr, "Error: Struct too large\n");
-                            return -1;
-                        }
-                        (void)memcpy(struct_buffer + struct_size, &sv->value.size_value,
-                                     sizeof(size_t));
-                        struct_size += sizeof(size_t);
-                        break;
-                    default:
-                        (void)fprintf(stderr, "Error: Unknown scalar type for field '%s'\n",
-                                      field_name);
-                        return -1;
-                }
-                found = 1;
-                break;
-            }
-        }
+        KernelArgSource* source = &slot->sources[field_idx];
 
-        if (!found) {
+        if (ResolveScalarSource(params, field_name, SCALAR_TYPE_NONE, struct_size, source) !=
+            0) {
             (void)fprintf(stderr, "Error: Struct field '%s' not found in scalars\n", field_name);
             return -1;
         }
+        if (source->size == 0U) {
+            (void)fprintf(stderr, "Error: Unknown scalar type for field '%s'\n", field_name);
+            return -1;
+        }
+        if (struct_size + source->size > sizeof(slot->value)) {
+            (void)fprintf(stderr, "Error: Struct too large\n");
+            return -1;
+        }
+        struct_size += source->size;
     }
 
-    /* Set the packed struct as kernel argument */
-    if (clSetKernelArg(kernel, (*arg_idx)++, struct_size, struct_buffer) != CL_SUCCESS) {
-        (void)fprintf(stderr, "Error: Failed to set struct arg at %d (size %zu)\n",
-                      *arg_idx - 1, struct_size);
+    slot->kind = KERNEL_ARG_SLOT_VALUE;
+    slot->size = struct_size;
+    slot->source_count = arg_desc->struct_field_count;
+    return (LoadSources(slot, params) < 0) ? -1 : 0;
+}
+
+/**
+ * @brief Resolve an image view argument
+ *
+ * Input views take the source size, channels and stride from OpParams,
+ * output views the destination ones. The view itself is looked up at bind
+ * time, when the buffer it views is known.
+ *
+ * @param[out] slot Slot to fill
+ * @param params Operation parameters
+ * @param arg_desc Kernel argument descriptor (data type, input or output)
+ * @param fixed_buffer Bound buffer the image views, or NULL for the input / output
+ */
+static void ResolveImageArg(KernelArgSlot* slot, const OpParams* params,
+                            const KernelArgDescriptor* arg_desc, cl_mem fixed_buffer) {
+    slot->size = sizeof(cl_mem);
+    slot->fixed_buffer = fixed_buffer;
+    slot->data_type = arg_desc->data_type;
+    if (arg_desc->arg_type == KERNEL_ARG_TYPE_IMAGE_INPUT) {
+        slot->kind = KERNEL_ARG_SLOT_IMAGE_INPUT;
+        slot->width = params->src_width;
+        slot->height = params->src_height;
+        slot->channels = params->src_channels;
+        slot->row_stride = params->src_stride;
+    } else {
+        slot->kind = KERNEL_ARG_SLOT_IMAGE_OUTPUT;
+        slot->width = params->dst_width;
+        slot->height = params->dst_height;
+        slot->channels = params->dst_channels;
+        slot->row_stride = params->dst_stride;
+    }
+}
+
+/**
+ * @brief Resolve a sampler kernel argument
+ *
+ * @param[out] slot Slot to fill
+ * @param kernel OpenCL kernel (its context owns the sampler)
+ * @param params Operation parameters (border_mode for "border")
+ * @param arg_desc Kernel argument descriptor (addressing name and filter)
+ * @return 0 on success, -1 on error
+ */
+static int ResolveSamplerArg(KernelArgSlot* slot, cl_kernel kernel, const OpParams* params,
+                             const KernelArgDescriptor* arg_desc) {
+    const char* name = arg_desc->source_name;
+    BorderMode mode;
+    cl_context context;
+    cl_sampler sampler;
+    cl_int err;
+
+    if (strcmp(name, "border") == 0) {
+        mode = params->border_mode;
+    } else if (strcmp(name, "clamp") == 0) {
+        mode = BORDER_CLAMP;
+    } else if (strcmp(name, "constant") == 0) {
+        mode = BORDER_CONSTANT;
+    } else if (strcmp(name, "reflect") == 0) {
+        mode = BORDER_REFLECT;
+    } else if (strcmp(name, "wrap") == 0) {
+        mode = BORDER_WRAP;
+    } else {
+        (void)fprintf(stderr, "Error: Unknown sampler addressing '%s'\n", name);
         return -1;
     }
+    if ((mode == BORDER_CONSTANT) && (params->border_value != 0U)) {
+        (void)printf("Warning: Sampler border color is 0, not border_value %u\n",
+                     (unsigned int)params->border_value);
+    }
 
+    if (clGetKernelInfo(kernel, CL_KERNEL_CONTEXT, sizeof(context), &context, NULL) !=
+        CL_SUCCESS) {
+        return -1;
+    }
+    sampler = ImageViewGetSampler(context, mode, arg_desc->sampler_linear, &err);
+    if (sampler == NULL) {
+        return -1;
+    }
+    SetSlotValue(slot, &sampler, sizeof(cl_sampler));
     return 0;
 }
 
-int OpenclSetKernelArgs(cl_kernel kernel, cl_mem input_buf, cl_mem output_buf,
-                        const OpParams* params, const KernelConfig* kernel_config) {
-    cl_uint arg_idx = 0U;
+/**
+ * @brief Resolve one kernel_args descriptor into its slot
+ *
+ * @param[out] slot Slot to fill
+ * @param kernel OpenCL kernel
+ * @param params Operation parameters
+ * @param arg_desc Kernel argument descriptor
+ * @param bound_buffer Explicitly bound buffer, or NULL
+ * @return 0 on success, -1 on error
+ */
+static int ResolveArg(KernelArgSlot* slot, cl_kernel kernel, const OpParams* params,
+                      const KernelArgDescriptor* arg_desc, cl_mem bound_buffer) {
+    slot->name = arg_desc->source_name;
+
+    /* Image views: of the bound buffer, else of the input / output buffer */
+    if ((arg_desc->arg_type == KERNEL_ARG_TYPE_IMAGE_INPUT) ||
+        (arg_desc->arg_type == KERNEL_ARG_TYPE_IMAGE_OUTPUT)) {
+        ResolveImageArg(slot, params, arg_desc, bound_buffer);
+        return 0;
+    }
+
+    /* Explicit binding overrides the default buffer for this argument */
+    if ((bound_buffer != NULL) && ((arg_desc->arg_type == KERNEL_ARG_TYPE_BUFFER_INPUT) ||
+                                   (arg_desc->arg_type == KERNEL_ARG_TYPE_BUFFER_OUTPUT) ||
+                                   (arg_desc->arg_type == KERNEL_ARG_TYPE_BUFFER_CUSTOM))) {
+        SetSlotValue(slot, &bound_buffer, sizeof(cl_mem));
+        return 0;
+    }
+
+    switch (arg_desc->arg_type) {
+        case KERNEL_ARG_TYPE_BUFFER_INPUT:
+            slot->kind = KERNEL_ARG_SLOT_INPUT;
+            slot->size = sizeof(cl_mem);
+            return 0;
+
+        case KERNEL_ARG_TYPE_BUFFER_OUTPUT: {
+            /* Named secondary output, else the primary output buffer */
+            cl_mem secondary = NamedOutputBuffer(params, arg_desc->source_name);
+
+            if (secondary != NULL) {
+                SetSlotValue(slot, &secondary, sizeof(cl_mem));
+            } else {
+                slot->kind = KERNEL_ARG_SLOT_OUTPUT;
+                slot->size = sizeof(cl_mem);
+            }
+            return 0;
+        }
+
+        case KERNEL_ARG_TYPE_BUFFER_CUSTOM:
+            return ResolveCustomBufferArg(slot, params->custom_buffers, arg_desc->source_name);
+
+        case KERNEL_ARG_TYPE_SCALAR_INT:
+            if (ResolveScalarArg(slot, params, arg_desc->source_name, SCALAR_TYPE_INT) != 0) {
+                (void)fprintf(stderr, "Error: Unknown scalar source '%s'\n",
+                              arg_desc->source_name);
+                return -1;
+            }
+            return 0;
+
+        case KERNEL_ARG_TYPE_SCALAR_SIZE:
+            return ResolveSizeTArg(slot, params, params->custom_buffers, arg_desc->source_name);
+
+        case KERNEL_ARG_TYPE_SCALAR_FLOAT:
+            if (ResolveScalarArg(slot, params, arg_desc->source_name, SCALAR_TYPE_FLOAT) != 0) {
+                (void)fprintf(stderr, "Error: Unknown float scalar source '%s'\n",
+                              arg_desc->source_name);
+                return -1;
+            }
+            return 0;
+
+        case KERNEL_ARG_TYPE_STRUCT:
+            return ResolveStructArg(slot, params, arg_desc);
+
+        case KERNEL_ARG_TYPE_SAMPLER:
+            return ResolveSamplerArg(slot, kernel, params, arg_desc);
+
+        default:
+            (void)fprintf(stderr, "Error: Unknown kernel arg type %d\n", arg_desc->arg_type);
+            return -1;
+    }
+}
+
+/**
+ * @brief Point an image slot at the view of this bind's buffer
+ *
+ * Views are cached per buffer (image_view.h), so the lookup only runs when
+ * the viewed buffer changes.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int UpdateImageSlot(KernelArgSlot* slot, cl_mem buffer, int arg_idx) {
+    cl_mem viewed = (slot->fixed_buffer != NULL) ? slot->fixed_buffer : buffer;
+    cl_mem_flags flags =
+        (slot->kind == KERNEL_ARG_SLOT_IMAGE_INPUT) ? CL_MEM_READ_ONLY : CL_MEM_WRITE_ONLY;
+    cl_mem image;
+    cl_int err;
+
+    if ((slot->dirty == 0) && (viewed == slot->viewed)) {
+        return 0;
+    }
+    image = ImageViewGet(viewed, flags, slot->data_type, slot->width, slot->height,
+                         slot->channels, slot->row_stride, &err);
+    if (image == NULL) {
+        (void)fprintf(stderr, "Error: No image view for '%s' at arg %d (error: %d)\n",
+                      slot->name, arg_idx, err);
+        return -1;
+    }
+    slot->viewed = viewed;
+    if (memcmp(slot->value, &image, sizeof(cl_mem)) != 0) {
+        (void)memcpy(slot->value, &image, sizeof(cl_mem));
+        slot->dirty = 1;
+    }
+    return 0;
+}
+
+int KernelArgPlanCompile(cl_kernel kernel, const OpParams* params,
+                         const KernelConfig* kernel_config, const cl_mem* bound_buffers,
+                         KernelArgPlan* plan) {
     int i;
-    const KernelArgDescriptor* arg_desc;
-    CustomBuffers* custom_buffers;
 
-    if ((kernel == NULL) || (params == NULL) || (kernel_config == NULL)) {
+    if ((kernel == NULL) || (params == NULL) || (kernel_config == NULL) || (plan == NULL)) {
         return -1;
     }
+    (void)memset(plan, 0, sizeof(*plan));
+    plan->kernel = kernel;
 
-    /* If no kernel_args configured, use default: input, output, width, height */
     if (kernel_config->kernel_arg_count == 0) {
-        /* Set input and output as arg0 and arg1 */
-        if (clSetKernelArg(kernel, arg_idx++, sizeof(cl_mem), &input_buf) != CL_SUCCESS) {
-            (void)fprintf(stderr, "Error: Failed to set input buffer (arg 0)\n");
-            return -1;
-        }
-        if (clSetKernelArg(kernel, arg_idx++, sizeof(cl_mem), &output_buf) != CL_SUCCESS) {
-            (void)fprintf(stderr, "Error: Failed to set output buffer (arg 1)\n");
-            return -1;
-        }
-        if (clSetKernelArg(kernel, arg_idx++, sizeof(int), &params->src_width) != CL_SUCCESS) {
+        /* No kernel_args configured: input, output, width, height */
+        plan->slots[0].kind = KERNEL_ARG_SLOT_INPUT;
+        plan->slots[0].size = sizeof(cl_mem);
+        plan->slots[0].name = "input";
+        plan->slots[1].kind = KERNEL_ARG_SLOT_OUTPUT;
+        plan->slots[1].size = sizeof(cl_mem);
+        plan->slots[1].name = "output";
+        plan->slots[2].name = "src_width";
+        plan->slots[3].name = "src_height";
+        if ((ResolveScalarArg(&plan->slots[2], params, "src_width", SCALAR_TYPE_INT) != 0) ||
+            (ResolveScalarArg(&plan->slots[3], params, "src_height", SCALAR_TYPE_INT) != 0)) {
             return -1;
         }
-        if (clSetKernelArg(kernel, arg_idx++, sizeof(int), &params->src_height) != CL_SUCCESS) {
-            return -1;
+        plan->count = 4;
+    } else {
+        for (i = 0; i < kernel_config->kernel_arg_count; i++) {
+            cl_mem bound = (bound_buffers != NULL) ? bound_buffers[i] : NULL;
+
+            if (ResolveArg(&plan->slots[i], kernel, params, &kernel_config->kernel_args[i],
+                           bound) != 0) {
+                return -1;
+            }
         }
-        return 0;
+        plan->count = kernel_config->kernel_arg_count;
     }
 
-    /* Use kernel_args configuration */
-    custom_buffers = params->custom_buffers;
-
-    (void)printf("\n=== Setting Kernel Arguments (variant: %d) ===\n", params->kernel_variant);
-    (void)printf("Total kernel_args to set: %d\n", kernel_config->kernel_arg_count);
+    /* Nothing is on the kernel yet */
+    for (i = 0; i < plan->count; i++) {
+        plan->slots[i].dirty = 1;
+    }
+    return 0;
+}
 
-    for (i = 0; i < kernel_config->kernel_arg_count; i++) {
-        arg_desc = &kernel_config->kernel_args[i];
-        (void)printf("kernel_args[%d]: type=%d, source='%s'\n", i, arg_desc->arg_type,
-                     arg_desc->source_name);
+int KernelArgPlanBind(KernelArgPlan* plan, cl_mem input_buf, cl_mem output_buf) {
+    int i;
 
-        switch (arg_desc->arg_type) {
-            case KERNEL_ARG_TYPE_BUFFER_INPUT:
-                /* Set input buffer */
-                if (clSetKernelArg(kernel, arg_idx++, sizeof(cl_mem), &input_buf) != CL_SUCCESS) {
-                    (void)fprintf(stderr, "Error: Failed to set input buffer at arg %d\n",
-                                  arg_idx - 1);
-                    return -1;
-                }
-                break;
+    if ((plan == NULL) || (plan->kernel == NULL)) {
+        return -1;
+    }
+    plan->last_updates = 0;
 
-            case KERNEL_ARG_TYPE_BUFFER_OUTPUT:
-                /* Set output buffer */
-                if (clSetKernelArg(kernel, arg_idx++, sizeof(cl_mem), &output_buf) != CL_SUCCESS) {
-                    (void)fprintf(stderr, "Error: Failed to set output buffer at arg %d\n",
-                                  arg_idx - 1);
-                    return -1;
-                }
-                break;
+    for (i = 0; i < plan->count; i++) {
+        KernelArgSlot* slot = &plan->slots[i];
 
-            case KERNEL_ARG_TYPE_BUFFER_CUSTOM:
-                if (SetCustomBufferArg(kernel, &arg_idx, custom_buffers, arg_desc->source_name) !=
-                    0) {
-                    return -1;
-                }
-                break;
+        switch (slot->kind) {
+            case KERNEL_ARG_SLOT_INPUT:
+            case KERNEL_ARG_SLOT_OUTPUT: {
+                cl_mem buffer = (slot->kind == KERNEL_ARG_SLOT_INPUT) ? input_buf : output_buf;
 
-            case KERNEL_ARG_TYPE_SCALAR_INT: {
-                /* Lookup OpParams field by name using data-driven table */
-                const int* value_ptr = OpParamsLookupInt(params, arg_desc->source_name);
-                if (value_ptr == NULL) {
-                    (void)fprintf(stderr, "Error: Unknown scalar source '%s'\n",
-                                  arg_desc->source_name);
-                    return -1;
-                }
-                if (clSetKernelArg(kernel, arg_idx++, sizeof(int), value_ptr) != CL_SUCCESS) {
-                    (void)fprintf(stderr, "Error: Failed to set scalar int '%s' at arg %d\n",
-                                  arg_desc->source_name, arg_idx - 1);
-                    return -1;
+                if (memcmp(slot->value, &buffer, sizeof(cl_mem)) != 0) {
+                    (void)memcpy(slot->value, &buffer, sizeof(cl_mem));
+                    slot->dirty = 1;
                 }
                 break;
             }
-
-            case KERNEL_ARG_TYPE_SCALAR_SIZE:
-                if (SetSizeTArg(kernel, &arg_idx, params, custom_buffers, arg_desc->source_name) !=
-                    0) {
+            case KERNEL_ARG_SLOT_IMAGE_INPUT:
+            case KERNEL_ARG_SLOT_IMAGE_OUTPUT:
+                if (UpdateImageSlot(slot,
+                                    (slot->kind == KERNEL_ARG_SLOT_IMAGE_INPUT) ? input_buf
+                                                                               : output_buf,
+                                    i) != 0) {
                     return -1;
                 }
                 break;
-
-            case KERNEL_ARG_TYPE_SCALAR_FLOAT: {
-                /* Lookup float field in custom_scalars */
-                const float* value_ptr = OpParamsLookupFloat(params, arg_desc->source_name);
-                if (value_ptr == NULL) {
-                    (void)fprintf(stderr, "Error: Unknown float scalar source '%s'\n",
-                                  arg_desc->source_name);
-                    return -1;
-                }
-                if (clSetKernelArg(kernel, arg_idx++, sizeof(float), value_ptr) != CL_SUCCESS) {
-                    (void)fprintf(stderr, "Error: Failed to set scalar float '%s' at arg %d\n",
-                                  arg_desc->source_name, arg_idx - 1);
-                    return -1;
-                }
+            default:
                 break;
+        }
+
+        if (slot->dirty != 0) {
+            if (clSetKernelArg(plan->kernel, (cl_uint)i, slot->size, slot->value) != CL_SUCCESS) {
+                (void)fprintf(stderr, "Error: Failed to set '%s' at arg %d (size %zu)\n",
+                              slot->name, i, slot->size);
+                return -1;
             }
+            slot->dirty = 0;
+            plan->last_updates++;
+        }
+    }
+    return 0;
+}
 
-            case KERNEL_ARG_TYPE_STRUCT:
-                if (SetStructArg(kernel, &arg_idx, params, arg_desc) != 0) {
-                    return -1;
-                }
-                break;
+int KernelArgPlanRefresh(KernelArgPlan* plan, const OpParams* params) {
+    int marked = 0;
+    int changed;
+    int i;
 
-            default:
-                (void)fprintf(stderr, "Error: Unknown kernel arg type %d\n", arg_desc->arg_type);
-                return -1;
+    if ((plan == NULL) || (params == NULL)) {
+        return -1;
+    }
+    for (i = 0; i < plan->count; i++) {
+        KernelArgSlot* slot = &plan->slots[i];
+
+        if (slot->source_count == 0) {
+            continue;
+        }
+        changed = LoadSources(slot, params);
+        if (changed < 0) {
+            (void)fprintf(stderr, "Error: Scalar source of '%s' (arg %d) no longer exists\n",
+                          slot->name, i);
+            return -1;
+        }
+        if ((changed != 0) && (slot->dirty == 0)) {
+            slot->dirty = 1;
+            marked++;
         }
     }
+    return marked;
+}
 
-    return 0;
+int OpenclSetKernelArgs(cl_kernel kernel, cl_mem input_buf, cl_mem output_buf,
+                        const OpParams* params, const KernelConfig* kernel_config) {
+    return OpenclSetKernelArgsWithBuffers(kernel, input_buf, output_buf, params, kernel_config,
+                                          NULL);
+}
+
+int OpenclSetKernelArgsWithBuffers(cl_kernel kernel, cl_mem input_buf, cl_mem output_buf,
+                                   const OpParams* params, const KernelConfig* kernel_config,
+                                   const cl_mem* bound_buffers) {
+    /* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+    static KernelArgPlan plan;
+    int i;
+
+    if ((kernel == NULL) || (params == NULL) || (kernel_config == NULL)) {
+        return -1;
+    }
+
+    if (kernel_config->kernel_arg_count > 0) {
+        (void)printf("\n=== Setting Kernel Arguments (variant: %d) ===\n",
+                     params->kernel_variant);
+        (void)printf("Total kernel_args to set: %d\n", kernel_config->kernel_arg_count);
+        for (i = 0; i < kernel_config->kernel_arg_count; i++) {
+            (void)printf("kernel_args[%d]: type=%d, source='%s'\n", i,
+                         kernel_config->kernel_args[i].arg_type,
+                         kernel_config->kernel_args[i].source_name);
+        }
+    }
+
+    /* One-off launch: resolve and set everything */
+    if (KernelArgPlanCompile(kernel, params, kernel_config, bound_buffers, &plan) != 0) {
+        return -1;
+    }
+    return KernelArgPlanBind(&plan, input_buf, output_buf);
 }
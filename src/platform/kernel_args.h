@@ -5,6 +5,10 @@
  * Provides functions to set kernel arguments based on configuration.
  * Separates argument mapping logic from core OpenCL operations.
  *
+ * Per-iteration callers compile a KernelArgPlan once and bind it for each
+ * set of buffers; the OpenclSetKernelArgs() functions compile and bind in
+ * one go for one-off launches.
+ *
  * MISRA C 2023 Compliance:
  * - Rule 17.7: All OpenCL API return values checked
  */
@@ -20,6 +24,117 @@
 #include "op_interface.h"
 #include "utils/config.h"
 
+/** Largest packed argument value (struct arguments included) */
+#define KERNEL_ARG_MAX_VALUE_SIZE 256
+
+/**
+ * @brief How a compiled argument slot gets its value
+ */
+typedef enum {
+    KERNEL_ARG_SLOT_VALUE = 0,   /**< Fixed or scalar value packed at compile time */
+    KERNEL_ARG_SLOT_INPUT,       /**< The input buffer passed to KernelArgPlanBind() */
+    KERNEL_ARG_SLOT_OUTPUT,      /**< The output buffer passed to KernelArgPlanBind() */
+    KERNEL_ARG_SLOT_IMAGE_INPUT, /**< Image view of the input (or a fixed) buffer */
+    KERNEL_ARG_SLOT_IMAGE_OUTPUT /**< Image view of the output (or a fixed) buffer */
+} KernelArgSlotKind;
+
+/**
+ * @brief Where a scalar inside a packed value comes from
+ *
+ * Either a built-in OpParams int field (scalar_index -1, param_offset) or
+ * an entry of OpParams.custom_scalars (scalar_index, type).
+ */
+typedef struct {
+    int scalar_index;    /**< Index in custom_scalars, or -1 for a built-in field */
+    ScalarType type;     /**< Scalar type of a custom_scalars entry */
+    size_t param_offset; /**< Offset of the built-in field in OpParams */
+    size_t value_offset; /**< Offset of the scalar in the packed value */
+    size_t size;         /**< Bytes of the scalar */
+} KernelArgSource;
+
+/**
+ * @brief One kernel argument, resolved once
+ */
+typedef struct {
+    KernelArgSlotKind kind;                         /**< Value source */
+    size_t size;                                    /**< Bytes passed to clSetKernelArg() */
+    unsigned char value[KERNEL_ARG_MAX_VALUE_SIZE]; /**< Value last set (or to set) */
+    int dirty;                                      /**< Non-zero: value not yet on the kernel */
+    KernelArgSource sources[MAX_STRUCT_FIELDS];     /**< Scalars packed into value */
+    int source_count;                               /**< Number of sources */
+    cl_mem fixed_buffer;                            /**< Image slots: bound buffer, or NULL */
+    cl_mem viewed;                                  /**< Image slots: buffer the view is of */
+    DataType data_type;                             /**< Image slots: element type */
+    int width;                                      /**< Image slots: view width */
+    int height;                                     /**< Image slots: view height */
+    int channels;                                   /**< Image slots: view channels */
+    int row_stride;                                 /**< Image slots: view row stride */
+    const char* name;                               /**< Source name (diagnostics) */
+} KernelArgSlot;
+
+/**
+ * @brief Kernel arguments resolved once, updated by dirty slot
+ *
+ * Setting arguments through kernel_args descriptors means name lookups,
+ * struct packing and image view lookups. A plan does all of that once per
+ * kernel: slot i holds argument i with its lookups resolved to indices and
+ * offsets and its value prepacked. Per iteration, KernelArgPlanBind() only
+ * calls clSetKernelArg() for slots whose value changed: the input / output
+ * buffers (and their image views) when the caller swaps buffers, scalars
+ * after KernelArgPlanRefresh() found a new value. OpenCL keeps argument
+ * values on the kernel, so unchanged slots need no call.
+ *
+ * A plan is tied to one kernel. It keeps pointers into the KernelConfig it
+ * was compiled from, which must outlive it, and must be recompiled when
+ * anything else changes the kernel's arguments.
+ */
+typedef struct {
+    cl_kernel kernel;                    /**< Kernel the plan sets arguments of */
+    int count;                           /**< Arguments (slots) */
+    KernelArgSlot slots[MAX_KERNEL_ARGS]; /**< Slot i is kernel argument i */
+    int last_updates;                    /**< clSetKernelArg() calls of the last bind */
+} KernelArgPlan;
+
+/**
+ * @brief Resolve the arguments of a kernel into a binding plan
+ *
+ * Resolves every kernel_args descriptor like OpenclSetKernelArgsWithBuffers()
+ * but sets nothing; all slots start dirty, so the first KernelArgPlanBind()
+ * sets every argument.
+ *
+ * @param[in] kernel OpenCL kernel
+ * @param[in] params Operation parameters (dimensions, algo-specific data)
+ * @param[in] kernel_config Kernel configuration with argument descriptors
+ * @param[in] bound_buffers Per-argument buffer overrides (MAX_KERNEL_ARGS entries), or NULL
+ * @param[out] plan Compiled plan
+ * @return 0 on success, -1 on error
+ */
+int KernelArgPlanCompile(cl_kernel kernel, const OpParams* params,
+                         const KernelConfig* kernel_config, const cl_mem* bound_buffers,
+                         KernelArgPlan* plan);
+
+/**
+ * @brief Set the arguments that changed since the last bind
+ *
+ * @param[in,out] plan Compiled plan
+ * @param[in] input_buf Input buffer of this iteration
+ * @param[in] output_buf Output buffer of this iteration
+ * @return 0 on success, -1 on error
+ */
+int KernelArgPlanBind(KernelArgPlan* plan, cl_mem input_buf, cl_mem output_buf);
+
+/**
+ * @brief Re-read the scalar arguments and mark the changed ones dirty
+ *
+ * Reads each scalar through its resolved index or offset (no name lookup)
+ * from params, which must have the layout the plan was compiled against.
+ *
+ * @param[in,out] plan Compiled plan
+ * @param[in] params Operation parameters with possibly new scalar values
+ * @return Number of slots marked dirty, or -1 on error
+ */
+int KernelArgPlanRefresh(KernelArgPlan* plan, const OpParams* params);
+
 /**
  * @brief Set kernel arguments for OpenCL kernel
  *
@@ -29,12 +144,15 @@
  *
  * Supports multiple argument types:
  * - BUFFER_INPUT: Primary input buffer
- * - BUFFER_OUTPUT: Primary output buffer
+ * - BUFFER_OUTPUT: Primary output buffer, or the secondary output of the same
+ *   name in OpParams.outputs (multi-output kernels)
  * - BUFFER_CUSTOM: Named custom buffers from OpParams
  * - SCALAR_INT: Integer scalars from OpParams fields or custom_scalars
  * - SCALAR_FLOAT: Float scalars from custom_scalars
  * - SCALAR_SIZE: Size_t scalars (buffer sizes or custom values)
  * - STRUCT: Packed struct from multiple scalar fields
+ * - IMAGE_INPUT / IMAGE_OUTPUT: 2D image views of the input / output buffer
+ * - SAMPLER: Sampler with addressing from OpParams.border_mode (or fixed)
  *
  * @param[in] kernel OpenCL kernel to set arguments for
  * @param[in] input_buf Input buffer containing image data
@@ -45,3 +163,24 @@
  */
 int OpenclSetKernelArgs(cl_kernel kernel, cl_mem input_buf, cl_mem output_buf,
                         const OpParams* params, const KernelConfig* kernel_config);
+
+/**
+ * @brief Set kernel arguments with explicit buffer bindings
+ *
+ * Same as OpenclSetKernelArgs(), but bound_buffers[i] (when non-NULL)
+ * replaces the buffer that kernel_args[i] would otherwise use (for image
+ * arguments, the buffer the image views). Entries for scalar, struct and
+ * sampler arguments are ignored. Used by the pipeline engine to
+ * route intermediate buffers between stages.
+ *
+ * @param[in] kernel OpenCL kernel to set arguments for
+ * @param[in] input_buf Default input buffer
+ * @param[in] output_buf Default output buffer
+ * @param[in] params Operation parameters (dimensions, algo-specific data)
+ * @param[in] kernel_config Kernel configuration with argument descriptors
+ * @param[in] bound_buffers Per-argument buffer overrides (MAX_KERNEL_ARGS entries), or NULL
+ * @return 0 on success, -1 on error
+ */
+int OpenclSetKernelArgsWithBuffers(cl_kernel kernel, cl_mem input_buf, cl_mem output_buf,
+                                   const OpParams* params, const KernelConfig* kernel_config,
+                                   const cl_mem* bound_buffers);
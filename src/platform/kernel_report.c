@@ -0,0 +1,269 @@
+/**
+ * @file kernel_report.c
+ * @brief Per-kernel hardware, occupancy and bandwidth report implementation
+ */
+
+#include "kernel_report.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "buffer_pool.h"
+#include "opencl_utils.h"
+#include "utils/config.h"
+
+/**
+ * @brief Measure device-to-device copy bandwidth with a buffer of @p size bytes
+ *
+ * One untimed copy, then one profiled copy (read + write = 2 * size bytes).
+ *
+ * @return GB/s, or 0 on failure
+ */
+static double MeasureCopyBandwidth(const OpenCLEnv* env, size_t size) {
+    cl_int err;
+    cl_mem src;
+    cl_mem dst;
+    cl_event event = NULL;
+    double ms = 0.0;
+    double gbps = 0.0;
+    int pass;
+
+    src = clCreateBuffer(env->context, CL_MEM_READ_WRITE, size, NULL, &err);
+    if (err != CL_SUCCESS) {
+        return 0.0;
+    }
+    dst = clCreateBuffer(env->context, CL_MEM_READ_WRITE, size, NULL, &err);
+    if (err != CL_SUCCESS) {
+        (void)clReleaseMemObject(src);
+        return 0.0;
+    }
+
+    for (pass = 0; pass < 2; pass++) {
+        err = clEnqueueCopyBuffer(env->queue, src, dst, 0U, 0U, size, 0U, NULL, &event);
+        if (err != CL_SUCCESS) {
+            break;
+        }
+        err = clWaitForEvents(1U, &event);
+        if ((err == CL_SUCCESS) && (pass == 1) && (OpenclGetEventDurationMs(event, &ms) == 0) &&
+            (ms > 0.0)) {
+            gbps = (2.0 * (double)size) / (ms * 1.0e6);
+        }
+        (void)clReleaseEvent(event);
+        if (err != CL_SUCCESS) {
+            break;
+        }
+    }
+
+    (void)clReleaseMemObject(dst);
+    (void)clReleaseMemObject(src);
+    return gbps;
+}
+
+/* Size of a bound buffer (as requested, for pooled ones), 0 for NULL or on query failure */
+static size_t MemSize(cl_mem mem) {
+    size_t size = BufferPoolRequestedSize(mem);
+
+    if (size > 0U) {
+        return size;
+    }
+    if ((mem == NULL) ||
+        (clGetMemObjectInfo(mem, CL_MEM_SIZE, sizeof(size), &size, NULL) != CL_SUCCESS)) {
+        return 0U;
+    }
+    return size;
+}
+
+int KernelReportQuery(const OpenCLEnv* env, cl_kernel kernel, KernelReport* report) {
+    cl_int err;
+
+    if (report == NULL) {
+        return -1;
+    }
+    (void)memset(report, 0, sizeof(*report));
+    report->occupancy = -1.0;
+    if ((env == NULL) || (kernel == NULL)) {
+        return -1;
+    }
+
+    err = clGetKernelWorkGroupInfo(kernel, env->device, CL_KERNEL_WORK_GROUP_SIZE,
+                                   sizeof(report->max_work_group_size),
+                                   &report->max_work_group_size, NULL);
+    if (err == CL_SUCCESS) {
+        err = clGetKernelWorkGroupInfo(kernel, env->device,
+                                       CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+                                       sizeof(report->preferred_multiple),
+                                       &report->preferred_multiple, NULL);
+    }
+    if (err == CL_SUCCESS) {
+        err = clGetKernelWorkGroupInfo(kernel, env->device, CL_KERNEL_LOCAL_MEM_SIZE,
+                                       sizeof(report->local_mem_bytes), &report->local_mem_bytes,
+                                       NULL);
+    }
+    if (err == CL_SUCCESS) {
+        err = clGetKernelWorkGroupInfo(kernel, env->device, CL_KERNEL_PRIVATE_MEM_SIZE,
+                                       sizeof(report->private_mem_bytes),
+                                       &report->private_mem_bytes, NULL);
+    }
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Warning: Kernel resource query failed (error code: %d)\n", err);
+        return -1;
+    }
+
+    report->compute_units = env->compute_units;
+    report->device_local_mem = env->local_mem_size;
+    report->valid = 1;
+    return 0;
+}
+
+void KernelReportFinish(OpenCLEnv* env, const KernelConfig* kernel_cfg, cl_mem input_buf,
+                        cl_mem output_buf, const OpParams* params, double kernel_ms,
+                        KernelReport* report) {
+    size_t items = 1U;
+    size_t groups = 1U;
+    size_t rounded;
+    size_t by_items;
+    size_t by_regs;
+    size_t by_local;
+    size_t slots;
+    int dim;
+    int i;
+
+    if ((env == NULL) || (kernel_cfg == NULL) || (params == NULL) || (report == NULL) ||
+        (report->valid == 0)) {
+        return;
+    }
+
+    /* Work-group shape: a zero local size leaves the choice to the driver */
+    if (kernel_cfg->local_work_size[0] != 0U) {
+        for (dim = 0; dim < kernel_cfg->work_dim; dim++) {
+            items *= kernel_cfg->local_work_size[dim];
+            groups *= (kernel_cfg->global_work_size[dim] + kernel_cfg->local_work_size[dim] - 1U) /
+                      kernel_cfg->local_work_size[dim];
+        }
+        report->work_group_items = items;
+        report->work_groups = groups;
+    }
+
+    if ((report->work_group_items > 0U) && (env->max_work_group_size > 0U) &&
+        (env->compute_units > 0U)) {
+        rounded = report->preferred_multiple;
+        if (rounded > 0U) {
+            rounded = ((items + rounded - 1U) / rounded) * rounded;
+            report->lane_utilization = (double)items / (double)rounded;
+        } else {
+            report->lane_utilization = 1.0;
+        }
+
+        by_items = env->max_work_group_size / items;
+        if (by_items == 0U) {
+            by_items = 1U;
+        }
+        report->groups_per_cu = (int)by_items;
+        report->occupancy_limit = "work-group size";
+
+        /* Register and private memory use lower CL_KERNEL_WORK_GROUP_SIZE below the device limit */
+        by_regs = by_items;
+        if ((report->max_work_group_size > 0U) &&
+            (report->max_work_group_size < env->max_work_group_size)) {
+            by_regs = report->max_work_group_size / items;
+            if (by_regs == 0U) {
+                by_regs = 1U;
+            }
+        }
+        if (by_regs < (size_t)report->groups_per_cu) {
+            report->groups_per_cu = (int)by_regs;
+            report->occupancy_limit = (report->private_mem_bytes > 0U)
+                                          ? "registers/private memory"
+                                          : "registers";
+        }
+
+        by_local = by_items;
+        if (report->local_mem_bytes > 0U) {
+            by_local = (size_t)(env->local_mem_size / report->local_mem_bytes);
+        }
+        if (by_local < (size_t)report->groups_per_cu) {
+            report->groups_per_cu = (int)by_local;
+            report->occupancy_limit = "local memory";
+        }
+
+        report->occupancy = ((double)report->groups_per_cu * (double)items) /
+                            (double)env->max_work_group_size;
+        if (report->occupancy > 1.0) {
+            report->occupancy = 1.0;
+        }
+        slots = (size_t)report->groups_per_cu * (size_t)env->compute_units;
+        report->device_fill =
+            ((slots > 0U) && (groups < slots)) ? ((double)groups / (double)slots) : 1.0;
+    }
+
+    /* Bytes moved: every bound buffer read or written once */
+    report->bytes_moved = MemSize(input_buf) + MemSize(output_buf);
+    if (params->custom_buffers != NULL) {
+        for (i = 0; i < params->custom_buffers->count; i++) {
+            report->bytes_moved += MemSize(params->custom_buffers->buffers[i].buffer);
+        }
+    }
+
+    report->kernel_ms = kernel_ms;
+    if (kernel_ms > 0.0) {
+        report->bandwidth_gbps = (double)report->bytes_moved / (kernel_ms * 1.0e6);
+        report->mpixels_per_s =
+            ((double)params->dst_width * (double)params->dst_height) / (kernel_ms * 1.0e3);
+    }
+
+    /* Reference rate for memory-bound classification, measured once per process */
+    if ((env->copy_bandwidth_gbps <= 0.0) && (MemSize(output_buf) > 0U)) {
+        env->copy_bandwidth_gbps = MeasureCopyBandwidth(env, MemSize(output_buf));
+    }
+    report->copy_bandwidth_gbps = env->copy_bandwidth_gbps;
+}
+
+void KernelReportPrintResources(const KernelReport* report) {
+    if ((report == NULL) || (report->valid == 0)) {
+        return;
+    }
+    (void)printf("Kernel resources: max work-group %zu, preferred multiple %zu, "
+                 "local %lu B, private %lu B/item\n",
+                 report->max_work_group_size, report->preferred_multiple,
+                 (unsigned long)report->local_mem_bytes, (unsigned long)report->private_mem_bytes);
+}
+
+void KernelReportPrint(const KernelReport* report) {
+    double ratio;
+
+    if ((report == NULL) || (report->valid == 0)) {
+        return;
+    }
+
+    (void)printf("\n=== Kernel Hardware Report ===\n");
+    KernelReportPrintResources(report);
+    (void)printf("Device:           %u compute units, %lu KB local memory\n",
+                 (unsigned int)report->compute_units,
+                 (unsigned long)(report->device_local_mem / 1024U));
+    if (report->occupancy >= 0.0) {
+        (void)printf("Work-groups:      %zu x %zu items (%.0f%% SIMD lanes used)\n",
+                     report->work_groups, report->work_group_items,
+                     report->lane_utilization * 100.0);
+        (void)printf("Occupancy:        %.0f%% theoretical (%d group(s)/CU, limited by %s)\n",
+                     report->occupancy * 100.0, report->groups_per_cu, report->occupancy_limit);
+        if (report->device_fill < 1.0) {
+            (void)printf("Device fill:      %.0f%% (fewer work-groups than resident slots)\n",
+                         report->device_fill * 100.0);
+        }
+    } else {
+        (void)printf("Occupancy:        n/a (driver-chosen local size)\n");
+    }
+
+    if (report->kernel_ms <= 0.0) {
+        return;
+    }
+    (void)printf("Bytes moved:      %zu (%.2f GB/s, %.1f Mpixel/s)\n", report->bytes_moved,
+                 report->bandwidth_gbps, report->mpixels_per_s);
+    if (report->copy_bandwidth_gbps > 0.0) {
+        ratio = report->bandwidth_gbps / report->copy_bandwidth_gbps;
+        (void)printf("Device copy:      %.2f GB/s -> %.0f%% of copy rate, %s\n",
+                     report->copy_bandwidth_gbps, ratio * 100.0,
+                     (ratio >= KERNEL_REPORT_MEMORY_BOUND_RATIO) ? "memory-bound"
+                                                                 : "compute/latency-bound");
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ * @file kernel_report.h
+ * @brief Per-kernel hardware, occupancy and bandwidth report
+ *
+ * Collected from OpenCL device and kernel queries when a kernel is built
+ * (CL_KERNEL_WORK_GROUP_SIZE, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+ * local/private memory) and completed after the verified run with the
+ * chosen work-group shape and the kernel time.
+ *
+ * Theoretical occupancy: OpenCL exposes no per-compute-unit limit on
+ * resident work-items, so one CL_DEVICE_MAX_WORK_GROUP_SIZE worth of
+ * work-items per compute unit counts as full. Resident work-groups per
+ * compute unit are bounded by that, by the kernel's CL_KERNEL_WORK_GROUP_SIZE
+ * (which drivers lower for kernels with high register or private memory
+ * use) and by CL_DEVICE_LOCAL_MEM_SIZE divided by the kernel's local
+ * memory; the report names the tightest limit.
+ *
+ * Bandwidth: bytes moved is the sum of the sizes of the buffers bound to
+ * the kernel (input, output, custom buffers), i.e. each byte read or
+ * written once; kernels that re-read data move more. It is compared with
+ * a device-to-device copy measured once per process, so a kernel near the
+ * copy rate is memory-bound and one well below it is compute- (or
+ * latency-) bound.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: No dynamic memory allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include "op_interface.h"
+
+/* Forward declarations - defined in opencl_utils.h and utils/config.h */
+struct OpenCLEnv;
+struct KernelConfig;
+
+/** Fraction of the measured copy bandwidth above which a kernel counts as memory-bound */
+#define KERNEL_REPORT_MEMORY_BOUND_RATIO 0.6
+
+/**
+ * @brief Hardware usage of one kernel run
+ */
+typedef struct KernelReport {
+    int valid;                   /**< Non-zero once the kernel queries succeeded */
+    size_t max_work_group_size;  /**< CL_KERNEL_WORK_GROUP_SIZE */
+    size_t preferred_multiple;   /**< CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE */
+    cl_ulong local_mem_bytes;    /**< CL_KERNEL_LOCAL_MEM_SIZE */
+    cl_ulong private_mem_bytes;  /**< CL_KERNEL_PRIVATE_MEM_SIZE (per work-item) */
+    cl_uint compute_units;       /**< CL_DEVICE_MAX_COMPUTE_UNITS */
+    cl_ulong device_local_mem;   /**< CL_DEVICE_LOCAL_MEM_SIZE */
+    size_t work_group_items;     /**< Work-items per group used (0 = driver-chosen) */
+    size_t work_groups;          /**< Work-groups in the NDRange (0 if driver-chosen) */
+    double lane_utilization;     /**< work_group_items / rounded up to preferred_multiple */
+    int groups_per_cu;           /**< Resident work-groups per compute unit */
+    const char* occupancy_limit; /**< Tightest limit: work-group size, registers, local memory */
+    double occupancy;            /**< Theoretical occupancy in [0, 1] (-1 if unknown) */
+    double device_fill;          /**< Fraction of resident slots the NDRange fills (<= 1) */
+    size_t bytes_moved;          /**< Bytes of buffers bound to the kernel */
+    double kernel_ms;            /**< Kernel time the rates are derived from */
+    double bandwidth_gbps;       /**< bytes_moved / kernel time */
+    double copy_bandwidth_gbps;  /**< Device copy bandwidth (0 if not measured) */
+    double mpixels_per_s;        /**< Output pixels per second, in millions */
+} KernelReport;
+
+/**
+ * @brief Query kernel resource usage
+ *
+ * @param[in] env OpenCL environment (device)
+ * @param[in] kernel Built kernel
+ * @param[out] report Report to initialize
+ * @return 0 on success, -1 if a query failed (report->valid stays 0)
+ */
+int KernelReportQuery(const struct OpenCLEnv* env, cl_kernel kernel, KernelReport* report);
+
+/**
+ * @brief Complete a report after a timed run
+ *
+ * Measures the device copy bandwidth on first use (cached in env).
+ *
+ * @param[in,out] env OpenCL environment
+ * @param[in] kernel_cfg Kernel configuration of the run (work sizes)
+ * @param[in] input_buf Input buffer (may be NULL)
+ * @param[in] output_buf Output buffer (may be NULL)
+ * @param[in] params Operation parameters (output size, custom buffers)
+ * @param[in] kernel_ms Kernel time in ms
+ * @param[in,out] report Report from KernelReportQuery()
+ */
+void KernelReportFinish(struct OpenCLEnv* env, const struct KernelConfig* kernel_cfg,
+                        cl_mem input_buf, cl_mem output_buf, const OpParams* params,
+                        double kernel_ms, KernelReport* report);
+
+/**
+ * @brief Print kernel resource usage (work-group limits, local/private memory)
+ *
+ * @param[in] report Report from KernelReportQuery()
+ */
+void KernelReportPrintResources(const KernelReport* report);
+
+/**
+ * @brief Print occupancy and bandwidth
+ *
+ * @param[in] report Completed report
+ */
+void KernelReportPrint(const KernelReport* report);
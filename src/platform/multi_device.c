@@ -0,0 +1,804 @@
+/**
+ * @file multi_device.c
+ * @brief Multi-device row-band and frame split implementation
+ */
+
+#include "multi_device.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cache_manager.h"
+#include "kernel_args.h"
+#include "utils/benchmark.h"
+#include "utils/frame_source.h"
+#include "utils/mapped_file.h"
+
+/** In-flight buffer sets per device in the frame split */
+#define MULTI_DEVICE_SLOTS 2
+
+/** Frames in flight over all devices (ring of frame tickets) */
+#define MULTI_DEVICE_RING (MAX_MULTI_DEVICES * MULTI_DEVICE_SLOTS)
+
+/** Maximum balance key length */
+#define MAX_BALANCE_KEY 256
+
+/** Indices of the per-frame commands */
+#define MD_CMD_UPLOAD 0
+#define MD_CMD_KERNEL 1
+#define MD_CMD_READBACK 2
+#define MD_CMD_COUNT 3
+
+/**
+ * @brief One device buffer set and the kernel bound to it
+ */
+typedef struct {
+    cl_mem input_buf;              /**< Device input */
+    cl_mem output_buf;             /**< Device output */
+    cl_kernel kernel;              /**< Kernel with its arguments bound to this set */
+    KernelArgPlan args;            /**< Arguments of kernel, bound once at setup */
+    cl_event events[MD_CMD_COUNT]; /**< Upload, kernel, readback events */
+    int frame;                     /**< Frame in flight, or -1 if idle */
+} LaneSlot;
+
+/**
+ * @brief State of one device during a run
+ */
+typedef struct {
+    OpenCLEnv* env;                       /**< Device environment */
+    KernelConfig kernel_cfg;              /**< Kernel configuration resolved for this device */
+    CustomBuffers custom;                 /**< Custom buffers in this device's context */
+    int owns_custom;                      /**< Non-zero if custom holds buffers of its own */
+    OpParams params;                      /**< Parameters bound to this device's buffers */
+    LaneSlot slots[MULTI_DEVICE_SLOTS];   /**< Buffer sets (row bands use slots[0]) */
+    double share;                         /**< Learned share of the work (shares sum to 1) */
+    double rate;                          /**< Last measured rows or frames per ms (0: none) */
+    int units;                            /**< Rows of the current round, or frames retired */
+    double busy_sum_ms;                   /**< Row bands: busy time over measured rounds */
+    int busy_rounds;                      /**< Row bands: measured rounds with a band */
+    cl_ulong first_start;                 /**< Frames: device time of the first upload */
+    cl_ulong last_end;                    /**< Frames: device time of the last readback */
+    int checked;                          /**< Frames: non-zero once an output was compared */
+} DeviceLane;
+
+/**
+ * @brief Device and buffer set of a frame in flight
+ */
+typedef struct {
+    int lane; /**< Device index */
+    int slot; /**< Buffer set index */
+} FrameTicket;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static OpenCLEnv owned_envs[MAX_MULTI_DEVICES];
+static DeviceLane lanes[MAX_MULTI_DEVICES];
+static FrameTicket tickets[MULTI_DEVICE_RING];
+
+int MultiDeviceOpen(OpenCLEnv* primary, int max_devices, MultiDeviceSet* set) {
+    cl_platform_id platforms[MAX_MULTI_PLATFORMS];
+    cl_device_id devices[MAX_MULTI_DEVICES];
+    cl_uint num_platforms = 0U;
+    cl_uint num_devices;
+    cl_uint p;
+    cl_uint d;
+    cl_int err;
+    int limit;
+
+    if ((primary == NULL) || (set == NULL)) {
+        return -1;
+    }
+    (void)memset(set, 0, sizeof(*set));
+    limit = ((max_devices > 0) && (max_devices < MAX_MULTI_DEVICES)) ? max_devices
+                                                                      : MAX_MULTI_DEVICES;
+    set->devices[0] = primary;
+    set->count = 1;
+
+    err = clGetPlatformIDs(MAX_MULTI_PLATFORMS, platforms, &num_platforms);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Warning: Failed to list platforms (error code: %d)\n", err);
+        return 0;
+    }
+    if (num_platforms > (cl_uint)MAX_MULTI_PLATFORMS) {
+        num_platforms = (cl_uint)MAX_MULTI_PLATFORMS;
+    }
+
+    for (p = 0U; (p < num_platforms) && (set->count < limit); p++) {
+        if (clGetDeviceIDs(platforms[p], CL_DEVICE_TYPE_ALL, (cl_uint)MAX_MULTI_DEVICES, devices,
+                           &num_devices) != CL_SUCCESS) {
+            continue;
+        }
+        if (num_devices > (cl_uint)MAX_MULTI_DEVICES) {
+            num_devices = (cl_uint)MAX_MULTI_DEVICES;
+        }
+        for (d = 0U; (d < num_devices) && (set->count < limit); d++) {
+            OpenCLEnv* env = &owned_envs[set->count];
+
+            if (devices[d] == primary->device) {
+                continue;
+            }
+            (void)printf("\n--- Device %d (platform %u) ---\n", set->count, (unsigned int)p);
+            if (OpenclInitDevice(env, platforms[p], devices[d]) != 0) {
+                (void)fprintf(stderr, "Warning: Skipping a device that failed to initialize\n");
+                OpenclReleaseDevice(env);
+                continue;
+            }
+            set->devices[set->count] = env;
+            set->count++;
+        }
+    }
+    return 0;
+}
+
+void MultiDeviceClose(MultiDeviceSet* set) {
+    int i;
+
+    if (set == NULL) {
+        return;
+    }
+    /* devices[0] is the borrowed primary environment */
+    for (i = 1; i < set->count; i++) {
+        OpenclReleaseDevice(set->devices[i]);
+        set->devices[i] = NULL;
+    }
+    set->count = 0;
+}
+
+/* Release the events of a buffer set and mark it idle */
+static void ReleaseSlotEvents(LaneSlot* slot) {
+    int c;
+
+    for (c = 0; c < MD_CMD_COUNT; c++) {
+        if (slot->events[c] != NULL) {
+            /* MISRA-C:2023 Rule 17.7: Check return value */
+            (void)clReleaseEvent(slot->events[c]);
+            slot->events[c] = NULL;
+        }
+    }
+    slot->frame = -1;
+}
+
+/* Finish the device's work and release everything the lane created */
+static void ReleaseLane(DeviceLane* lane) {
+    int s;
+    int i;
+
+    if ((lane->env != NULL) && (lane->env->queue != NULL)) {
+        (void)clFinish(lane->env->queue);
+    }
+    for (s = 0; s < MULTI_DEVICE_SLOTS; s++) {
+        ReleaseSlotEvents(&lane->slots[s]);
+        OpenclReleaseMemObject(lane->slots[s].input_buf, "multi-device input");
+        OpenclReleaseMemObject(lane->slots[s].output_buf, "multi-device output");
+        lane->slots[s].input_buf = NULL;
+        lane->slots[s].output_buf = NULL;
+        OpenclReleaseKernel(lane->slots[s].kernel);
+        lane->slots[s].kernel = NULL;
+    }
+    if (lane->owns_custom != 0) {
+        for (i = 0; i < lane->custom.count; i++) {
+            OpenclReleaseMemObject(lane->custom.buffers[i].buffer, lane->custom.buffers[i].name);
+            lane->custom.buffers[i].buffer = NULL;
+        }
+        lane->owns_custom = 0;
+    }
+}
+
+/* Copy the custom buffers into the lane's context (file-backed ones from their host data) */
+static int CopyCustomBuffers(DeviceLane* lane, const CustomBuffers* src) {
+    cl_mem_flags flags;
+    int i;
+
+    lane->custom = *src;
+    for (i = 0; i < lane->custom.count; i++) {
+        lane->custom.buffers[i].buffer = NULL;
+    }
+    lane->owns_custom = 1;
+
+    for (i = 0; i < lane->custom.count; i++) {
+        RuntimeBuffer* buf = &lane->custom.buffers[i];
+
+        if (buf->type == BUFFER_TYPE_READ_ONLY) {
+            flags = CL_MEM_READ_ONLY;
+        } else if (buf->type == BUFFER_TYPE_WRITE_ONLY) {
+            flags = CL_MEM_WRITE_ONLY;
+        } else {
+            flags = CL_MEM_READ_WRITE;
+        }
+        if (buf->host_data != NULL) {
+            flags |= CL_MEM_COPY_HOST_PTR;
+        }
+        buf->buffer = OpenclCreateBuffer(lane->env->context, flags, buf->size_bytes,
+                                         buf->host_data, buf->name);
+        if (buf->buffer == NULL) {
+            return -1;
+        }
+    }
+    lane->params.custom_buffers = &lane->custom;
+    return 0;
+}
+
+/*
+ * Create the buffer sets of one device, each with its own kernel whose arguments
+ * are bound once here, so the timed rounds only enqueue
+ */
+static int SetupLane(DeviceLane* lane, OpenCLEnv* env, int is_primary, const char* algorithm_id,
+                     const KernelConfig* kernel_cfg, const OpParams* params, size_t input_size,
+                     size_t output_size, int slot_count) {
+    LaneSlot* slot;
+    int s;
+
+    (void)memset(lane, 0, sizeof(*lane));
+    lane->env = env;
+    for (s = 0; s < MULTI_DEVICE_SLOTS; s++) {
+        lane->slots[s].frame = -1;
+    }
+
+    /* An fp16 kernel falls back to fp32 on the devices without cl_khr_fp16 only */
+    lane->kernel_cfg = *kernel_cfg;
+    OpenclResolvePrecision(env, &lane->kernel_cfg);
+
+    /* The primary device reuses the caller's buffers; the others get copies */
+    lane->params = *params;
+    lane->params.outputs = NULL;
+    if ((is_primary == 0) && (params->custom_buffers != NULL) &&
+        (CopyCustomBuffers(lane, params->custom_buffers) != 0)) {
+        return -1;
+    }
+
+    for (s = 0; s < slot_count; s++) {
+        slot = &lane->slots[s];
+        slot->input_buf = OpenclCreateBuffer(env->context, CL_MEM_READ_ONLY, input_size, NULL,
+                                             "multi-device input");
+        slot->output_buf = OpenclCreateBuffer(env->context, CL_MEM_WRITE_ONLY, output_size, NULL,
+                                              "multi-device output");
+        if ((slot->input_buf == NULL) || (slot->output_buf == NULL)) {
+            return -1;
+        }
+        slot->kernel = OpenclBuildKernel(env, algorithm_id, &lane->kernel_cfg);
+        if ((slot->kernel == NULL) ||
+            (KernelArgPlanCompile(slot->kernel, &lane->params, &lane->kernel_cfg, NULL,
+                                  &slot->args) != 0) ||
+            (KernelArgPlanBind(&slot->args, slot->input_buf, slot->output_buf) != 0)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Scale the shares to sum to 1 */
+static void NormalizeShares(int count) {
+    double total = 0.0;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        total += lanes[i].share;
+    }
+    for (i = 0; i < count; i++) {
+        lanes[i].share = (total > 0.0) ? (lanes[i].share / total) : (1.0 / (double)count);
+    }
+}
+
+/* Move the shares towards the measured throughput (devices never measured keep theirs) */
+static void UpdateShares(int count) {
+    double total = 0.0;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        total += lanes[i].rate;
+    }
+    if (total <= 0.0) {
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        if (lanes[i].rate > 0.0) {
+            lanes[i].share = ((1.0 - MULTI_DEVICE_SMOOTHING) * lanes[i].share) +
+                             (MULTI_DEVICE_SMOOTHING * (lanes[i].rate / total));
+        }
+    }
+    NormalizeShares(count);
+}
+
+/* Build the balance key: <kernel file>_<function>_<split>_<WxH>_d<count>_<device set hash> */
+static void BuildBalanceKey(const MultiDeviceSet* set, const KernelConfig* kernel_cfg,
+                            const OpParams* params, MultiDeviceSplit split, char* key,
+                            size_t key_size) {
+    CacheHashState state;
+    unsigned char hash[CACHE_HASH_SIZE];
+    const char* file_name;
+    size_t i;
+    int d;
+
+    CacheHashInit(&state);
+    for (d = 0; d < set->count; d++) {
+        CacheHashUpdate(&state, set->devices[d]->device_name,
+                        strlen(set->devices[d]->device_name) + 1U);
+        CacheHashUpdate(&state, set->devices[d]->driver_version,
+                        strlen(set->devices[d]->driver_version) + 1U);
+    }
+    CacheHashFinal(&state, hash);
+
+    file_name = strrchr(kernel_cfg->kernel_file, '/');
+    file_name = (file_name != NULL) ? (file_name + 1) : kernel_cfg->kernel_file;
+    (void)snprintf(key, key_size, "%s_%s_%s_%dx%d_d%d_%02x%02x%02x%02x", file_name,
+                   kernel_cfg->kernel_function, (split == MULTI_SPLIT_ROWS) ? "rows" : "frames",
+                   params->src_width, params->src_height, set->count, hash[0], hash[1], hash[2],
+                   hash[3]);
+
+    /* File-safe: characters outside [A-Za-z0-9.-] become '_' */
+    for (i = 0U; key[i] != '\0'; i++) {
+        char c = key[i];
+        if (!(((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+              ((c >= '0') && (c <= '9')) || (c == '.') || (c == '-'))) {
+            key[i] = '_';
+        }
+    }
+}
+
+/* Starting shares: the persisted balance, else compute units x clock */
+static void InitShares(const MultiDeviceSet* set, const char* algorithm_id, const char* key) {
+    double shares[MAX_MULTI_DEVICES];
+    int i;
+
+    if (CacheLoadBalance(algorithm_id, key, shares, set->count) != 0) {
+        for (i = 0; i < set->count; i++) {
+            shares[i] = (double)set->devices[i]->compute_units *
+                        (double)set->devices[i]->max_clock_mhz;
+            if (!(shares[i] > 0.0)) {
+                shares[i] = 1.0;
+            }
+        }
+    }
+    for (i = 0; i < set->count; i++) {
+        lanes[i].share = shares[i];
+    }
+    NormalizeShares(set->count);
+}
+
+/* Device time from the start of @p first to the end of @p last */
+static int EventSpan(cl_event first, cl_event last, cl_ulong* start, cl_ulong* end) {
+    cl_int err;
+
+    err = clGetEventProfilingInfo(first, CL_PROFILING_COMMAND_START, sizeof(*start), start, NULL);
+    if (err == CL_SUCCESS) {
+        err = clGetEventProfilingInfo(last, CL_PROFILING_COMMAND_END, sizeof(*end), end, NULL);
+    }
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to get multi-device profiling info (error code: %d)\n",
+                      err);
+        return -1;
+    }
+    return 0;
+}
+
+/* Compare an output with the reference and count the check */
+static void CheckOutput(const unsigned char* output, const unsigned char* reference,
+                        const VerifyOptions* verify_opts, MultiDeviceResult* result) {
+    VerifyReport report;
+
+    if ((reference == NULL) || (verify_opts == NULL)) {
+        return;
+    }
+    result->checks++;
+    if ((VerifyCompare(output, reference, verify_opts, &report) != 0) || (report.passed == 0)) {
+        result->failures++;
+    }
+}
+
+/**
+ * @brief Enqueue one device's band: input rows with halo, kernel at an offset, output rows
+ *
+ * @return 0 on success (lane->units rows in flight, 0 for an empty band), -1 on error
+ */
+static int EnqueueBand(DeviceLane* lane, const KernelConfig* kernel_cfg,
+                       const unsigned char* input, size_t in_row, unsigned char* output,
+                       size_t out_row, size_t rows, size_t halo, size_t band_begin,
+                       size_t band_end) {
+    LaneSlot* slot = &lane->slots[0];
+    cl_command_queue queue = lane->env->queue;
+    size_t offset[2];
+    size_t size[2];
+    const size_t* local;
+    size_t out_end;
+    size_t lo;
+    size_t hi;
+    cl_int err;
+
+    lane->units = 0;
+    out_end = (band_end < rows) ? band_end : rows;
+    if (band_begin >= out_end) {
+        return 0;
+    }
+    lo = (band_begin > halo) ? (band_begin - halo) : 0U;
+    hi = ((out_end + halo) < rows) ? (out_end + halo) : rows;
+
+    /* Rows keep their frame position, so the kernel indexes the buffer as usual */
+    err = clEnqueueWriteBuffer(queue, slot->input_buf, CL_FALSE, lo * in_row, (hi - lo) * in_row,
+                               input + (lo * in_row), 0U, NULL, &slot->events[MD_CMD_UPLOAD]);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to upload band (error code: %d)\n", err);
+        return -1;
+    }
+    offset[0] = 0U;
+    offset[1] = band_begin;
+    size[0] = kernel_cfg->global_work_size[0];
+    size[1] = band_end - band_begin;
+    local = (kernel_cfg->local_work_size[0] == 0U) ? NULL : kernel_cfg->local_work_size;
+    err = clEnqueueNDRangeKernel(queue, slot->kernel, 2U, offset, size, local, 0U, NULL,
+                                 &slot->events[MD_CMD_KERNEL]);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to enqueue band kernel (error code: %d)\n", err);
+        return -1;
+    }
+    err = clEnqueueReadBuffer(queue, slot->output_buf, CL_FALSE, band_begin * out_row,
+                              (out_end - band_begin) * out_row, output + (band_begin * out_row),
+                              0U, NULL, &slot->events[MD_CMD_READBACK]);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to read back band (error code: %d)\n", err);
+        return -1;
+    }
+    (void)clFlush(queue);
+    lane->units = (int)(out_end - band_begin);
+    return 0;
+}
+
+/**
+ * @brief Row-band split: one warmup round, then md_cfg->rounds measured rounds
+ */
+static int RunRowBands(const MultiDeviceSet* set, const KernelConfig* kernel_cfg,
+                       const OpParams* params, const MultiDeviceConfig* md_cfg,
+                       const unsigned char* input, size_t input_size, unsigned char* output,
+                       size_t output_size, const unsigned char* reference,
+                       const VerifyOptions* verify_opts, MultiDeviceResult* result) {
+    size_t begin[MAX_MULTI_DEVICES];
+    size_t end[MAX_MULTI_DEVICES];
+    size_t rows = (size_t)params->dst_height;
+    size_t in_row = input_size / (size_t)params->src_height;
+    size_t out_row = output_size / rows;
+    size_t global_rows = kernel_cfg->global_work_size[1];
+    size_t granule = (kernel_cfg->local_work_size[1] > 0U) ? kernel_cfg->local_work_size[1] : 1U;
+    size_t boundary;
+    size_t prev;
+    cl_ulong start;
+    cl_ulong stop;
+    double cum;
+    double busy_ms;
+    double round_start;
+    int round;
+    int i;
+
+    for (round = 0; round <= md_cfg->rounds; round++) {
+        /* Bands follow the current shares, aligned to the work-group height */
+        cum = 0.0;
+        prev = 0U;
+        for (i = 0; i < set->count; i++) {
+            cum += lanes[i].share;
+            boundary = (i == (set->count - 1))
+                           ? global_rows
+                           : ((size_t)((cum * (double)global_rows / (double)granule) + 0.5) *
+                              granule);
+            boundary = (boundary > global_rows) ? global_rows : boundary;
+            boundary = (boundary < prev) ? prev : boundary;
+            begin[i] = prev;
+            end[i] = boundary;
+            prev = boundary;
+        }
+
+        round_start = BenchmarkNowMs();
+        for (i = 0; i < set->count; i++) {
+            if (EnqueueBand(&lanes[i], kernel_cfg, input, in_row, output, out_row, rows,
+                            (size_t)md_cfg->halo, begin[i], end[i]) != 0) {
+                return -1;
+            }
+        }
+        for (i = 0; i < set->count; i++) {
+            LaneSlot* slot = &lanes[i].slots[0];
+
+            if (lanes[i].units == 0) {
+                continue;
+            }
+            if ((clWaitForEvents(1U, &slot->events[MD_CMD_READBACK]) != CL_SUCCESS) ||
+                (EventSpan(slot->events[MD_CMD_UPLOAD], slot->events[MD_CMD_READBACK], &start,
+                           &stop) != 0)) {
+                (void)fprintf(stderr, "Failed to complete band on device %d\n", i);
+                return -1;
+            }
+            ReleaseSlotEvents(slot);
+            /* Round 0 warms up every device (first launch, lazy allocation): not measured */
+            busy_ms = (stop > start) ? ((double)(stop - start) / 1000000.0) : 0.0;
+            if ((round > 0) && (busy_ms > 0.0)) {
+                lanes[i].rate = (double)lanes[i].units / busy_ms;
+                lanes[i].busy_sum_ms += busy_ms;
+                lanes[i].busy_rounds++;
+            }
+        }
+        if (round > 0) {
+            result->total_ms += BenchmarkNowMs() - round_start;
+            result->frames++;
+            UpdateShares(set->count);
+        }
+        /* The assembled frame must match the reference whatever the band boundaries */
+        CheckOutput(output, reference, verify_opts, result);
+    }
+
+    for (i = 0; i < set->count; i++) {
+        result->devices[i].units = lanes[i].units;
+        result->devices[i].busy_ms = (lanes[i].busy_rounds > 0)
+                                         ? (lanes[i].busy_sum_ms / (double)lanes[i].busy_rounds)
+                                         : 0.0;
+    }
+    return 0;
+}
+
+/* Device whose share is least used if it takes the next frame */
+static int PickLane(int count, const int* assigned) {
+    double best = 0.0;
+    double load;
+    int pick = 0;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        if (!(lanes[i].share > 0.0)) {
+            continue;
+        }
+        load = (double)(assigned[i] + 1) / lanes[i].share;
+        if ((best == 0.0) || (load < best)) {
+            best = load;
+            pick = i;
+        }
+    }
+    return pick;
+}
+
+/* Wait for a frame, account its device time and compare the device's first output */
+static int RetireFrame(int frame, unsigned char* const host_outputs[],
+                       const unsigned char* reference, const VerifyOptions* verify_opts,
+                       MultiDeviceResult* result) {
+    const FrameTicket* ticket = &tickets[frame % MULTI_DEVICE_RING];
+    DeviceLane* lane = &lanes[ticket->lane];
+    LaneSlot* slot = &lane->slots[ticket->slot];
+    const unsigned char* host_output =
+        host_outputs[(ticket->lane * MULTI_DEVICE_SLOTS) + ticket->slot];
+    cl_ulong start;
+    cl_ulong stop;
+
+    if ((clWaitForEvents(1U, &slot->events[MD_CMD_READBACK]) != CL_SUCCESS) ||
+        (EventSpan(slot->events[MD_CMD_UPLOAD], slot->events[MD_CMD_READBACK], &start, &stop) !=
+         0)) {
+        (void)fprintf(stderr, "Failed to complete frame %d on device %d\n", frame, ticket->lane);
+        return -1;
+    }
+    if ((lane->units == 0) || (start < lane->first_start)) {
+        lane->first_start = start;
+    }
+    if (stop > lane->last_end) {
+        lane->last_end = stop;
+    }
+    lane->units++;
+
+    if (lane->checked == 0) {
+        CheckOutput(host_output, reference, verify_opts, result);
+        lane->checked = 1;
+    }
+    ReleaseSlotEvents(slot);
+    return 0;
+}
+
+/**
+ * @brief Frame split: deal whole frames to the devices in proportion to their shares
+ */
+static int RunFrames(const MultiDeviceSet* set, const KernelConfig* kernel_cfg,
+                     const MultiDeviceConfig* md_cfg, const StreamConfig* stream_cfg,
+                     const unsigned char* input, size_t input_size, size_t output_size,
+                     const unsigned char* reference, const VerifyOptions* verify_opts,
+                     MultiDeviceResult* result) {
+    unsigned char* host_outputs[MULTI_DEVICE_RING];
+    int assigned[MAX_MULTI_DEVICES];
+    FrameSource source;
+    MappedBuffer staging_input;
+    MappedBuffer staging_output;
+    const unsigned char* frame_data;
+    unsigned char* frame_staging;
+    DeviceLane* lane;
+    LaneSlot* slot;
+    size_t local_index;
+    const size_t* local;
+    cl_command_queue queue;
+    cl_int err;
+    double start_ms;
+    int use_source;
+    int frames;
+    int next_retire = 0;
+    int frame;
+    int d;
+    int s;
+    int status = -1;
+
+    (void)memset(&source, 0, sizeof(source));
+    (void)memset(&staging_input, 0, sizeof(staging_input));
+    (void)memset(&staging_output, 0, sizeof(staging_output));
+    (void)memset(assigned, 0, sizeof(assigned));
+
+    /* A frame source gives the batch; otherwise the verified input is repeated */
+    use_source = (stream_cfg->input_path[0] != '\0') ? 1 : 0;
+    frames = md_cfg->rounds;
+    if (use_source != 0) {
+        if (FrameSourceOpen(stream_cfg->input_path, input_size, stream_cfg->max_frames,
+                            &source) != 0) {
+            return -1;
+        }
+        frames = source.frame_count;
+        reference = NULL;
+    }
+
+    if ((MappedBufferAlloc(output_size * (size_t)MULTI_DEVICE_RING, &staging_output) != 0) ||
+        ((source.is_directory != 0) &&
+         (MappedBufferAlloc(input_size * (size_t)MULTI_DEVICE_RING, &staging_input) != 0))) {
+        goto cleanup;
+    }
+    for (s = 0; s < MULTI_DEVICE_RING; s++) {
+        host_outputs[s] = staging_output.data + ((size_t)s * output_size);
+    }
+    local = (kernel_cfg->local_work_size[0] == 0U) ? NULL : kernel_cfg->local_work_size;
+
+    start_ms = BenchmarkNowMs();
+    for (frame = 0; frame < frames; frame++) {
+        d = PickLane(set->count, assigned);
+        lane = &lanes[d];
+
+        /* Frames retire in order; retire until the chosen device has a free set */
+        for (;;) {
+            for (s = 0; s < MULTI_DEVICE_SLOTS; s++) {
+                if (lane->slots[s].frame < 0) {
+                    break;
+                }
+            }
+            if (s < MULTI_DEVICE_SLOTS) {
+                break;
+            }
+            if (RetireFrame(next_retire, host_outputs, reference, verify_opts, result) != 0) {
+                goto cleanup;
+            }
+            next_retire++;
+        }
+        slot = &lane->slots[s];
+        local_index = ((size_t)d * MULTI_DEVICE_SLOTS) + (size_t)s;
+        queue = lane->env->queue;
+
+        frame_data = input;
+        if (use_source != 0) {
+            frame_staging = (staging_input.data != NULL)
+                                ? (staging_input.data + (local_index * input_size))
+                                : NULL;
+            if (FrameSourceRead(&source, frame_staging, &frame_data) != 0) {
+                goto cleanup;
+            }
+        }
+
+        err = clEnqueueWriteBuffer(queue, slot->input_buf, CL_FALSE, 0U, input_size, frame_data,
+                                   0U, NULL, &slot->events[MD_CMD_UPLOAD]);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to upload frame %d (error code: %d)\n", frame, err);
+            goto cleanup;
+        }
+        err = clEnqueueNDRangeKernel(queue, slot->kernel, (cl_uint)kernel_cfg->work_dim, NULL,
+                                     kernel_cfg->global_work_size, local, 0U, NULL,
+                                     &slot->events[MD_CMD_KERNEL]);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to enqueue frame %d (error code: %d)\n", frame, err);
+            goto cleanup;
+        }
+        err = clEnqueueReadBuffer(queue, slot->output_buf, CL_FALSE, 0U, output_size,
+                                  host_outputs[local_index], 0U, NULL,
+                                  &slot->events[MD_CMD_READBACK]);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to read back frame %d (error code: %d)\n", frame, err);
+            goto cleanup;
+        }
+        (void)clFlush(queue);
+
+        slot->frame = frame;
+        tickets[frame % MULTI_DEVICE_RING].lane = d;
+        tickets[frame % MULTI_DEVICE_RING].slot = s;
+        assigned[d]++;
+    }
+    for (; next_retire < frames; next_retire++) {
+        if (RetireFrame(next_retire, host_outputs, reference, verify_opts, result) != 0) {
+            goto cleanup;
+        }
+    }
+    result->total_ms = BenchmarkNowMs() - start_ms;
+    result->frames = frames;
+
+    for (d = 0; d < set->count; d++) {
+        lane = &lanes[d];
+        result->devices[d].units = lane->units;
+        if ((lane->units > 0) && (lane->last_end > lane->first_start)) {
+            result->devices[d].busy_ms =
+                (double)(lane->last_end - lane->first_start) / 1000000.0;
+            lane->rate = (double)lane->units / result->devices[d].busy_ms;
+        }
+    }
+    UpdateShares(set->count);
+    status = 0;
+
+cleanup:
+    MappedBufferRelease(&staging_input);
+    MappedBufferRelease(&staging_output);
+    FrameSourceClose(&source);
+    return status;
+}
+
+int MultiDeviceRun(const MultiDeviceSet* set, const char* algorithm_id,
+                   const KernelConfig* kernel_cfg, const OpParams* params,
+                   const MultiDeviceConfig* md_cfg, const StreamConfig* stream_cfg,
+                   const unsigned char* input, size_t input_size, unsigned char* output,
+                   size_t output_size, const unsigned char* reference,
+                   const VerifyOptions* verify_opts, MultiDeviceResult* result) {
+    char key[MAX_BALANCE_KEY];
+    double shares[MAX_MULTI_DEVICES];
+    int slot_count;
+    int status = -1;
+    int i;
+
+    if ((set == NULL) || (set->count < 1) || (algorithm_id == NULL) || (kernel_cfg == NULL) ||
+        (params == NULL) || (md_cfg == NULL) || (stream_cfg == NULL) || (input == NULL) ||
+        (output == NULL) || (result == NULL)) {
+        return -1;
+    }
+    if (md_cfg->split == MULTI_SPLIT_ROWS) {
+        if ((kernel_cfg->work_dim != 2) || (kernel_cfg->host_type != HOST_TYPE_STANDARD) ||
+            (kernel_cfg->pitched != 0) || (params->src_height != params->dst_height) ||
+            (params->dst_height <= 0) || ((input_size % (size_t)params->src_height) != 0U) ||
+            ((output_size % (size_t)params->dst_height) != 0U)) {
+            (void)fprintf(stderr, "Error: Row bands need a standard 2D kernel on packed rows "
+                                  "with equal input and output heights\n");
+            return -1;
+        }
+    }
+
+    (void)memset(result, 0, sizeof(*result));
+    result->split = md_cfg->split;
+    result->device_count = set->count;
+    slot_count = (md_cfg->split == MULTI_SPLIT_ROWS) ? 1 : MULTI_DEVICE_SLOTS;
+
+    (void)memset(lanes, 0, sizeof(lanes));
+    for (i = 0; i < set->count; i++) {
+        if (SetupLane(&lanes[i], set->devices[i], (i == 0) ? 1 : 0, algorithm_id, kernel_cfg,
+                      params, input_size, output_size, slot_count) != 0) {
+            (void)fprintf(stderr, "Error: Failed to set up device %d (%s)\n", i,
+                          set->devices[i]->device_name);
+            goto cleanup;
+        }
+    }
+
+    BuildBalanceKey(set, kernel_cfg, params, md_cfg->split, key, sizeof(key));
+    InitShares(set, algorithm_id, key);
+
+    if (md_cfg->split == MULTI_SPLIT_ROWS) {
+        status = RunRowBands(set, kernel_cfg, params, md_cfg, input, input_size, output,
+                             output_size, reference, verify_opts, result);
+    } else {
+        status = RunFrames(set, kernel_cfg, md_cfg, stream_cfg, input, input_size, output_size,
+                           reference, verify_opts, result);
+    }
+    if (status != 0) {
+        goto cleanup;
+    }
+
+    result->fps =
+        (result->total_ms > 0.0) ? ((double)result->frames * 1000.0 / result->total_ms) : 0.0;
+    for (i = 0; i < set->count; i++) {
+        (void)snprintf(result->devices[i].device_name, sizeof(result->devices[i].device_name),
+                       "%s", set->devices[i]->device_name);
+        result->devices[i].share = lanes[i].share;
+        result->devices[i].rate = lanes[i].rate;
+        shares[i] = lanes[i].share;
+    }
+    (void)CacheSaveBalance(algorithm_id, key, shares, set->count);
+
+cleanup:
+    for (i = 0; i < set->count; i++) {
+        ReleaseLane(&lanes[i]);
+    }
+    return status;
+}
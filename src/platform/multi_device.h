@@ -0,0 +1,132 @@
+/**
+ * @file multi_device.h
+ * @brief Run one kernel on every OpenCL device at once
+ *
+ * OpenclInit() uses one device. MultiDeviceOpen() adds every other device of
+ * every platform (e.g. an iGPU, a dGPU and a CPU runtime), each with its own
+ * context and queue (OpenclInitDevice()). Each device therefore builds its
+ * own program through the program registry. The binary cache key includes
+ * the device name and driver, so every device keeps its own cached binaries.
+ *
+ * Two splits are supported (MultiDeviceConfig):
+ *
+ * - Row bands: each frame is cut into one band of output rows per device.
+ *   A device receives its band's input rows plus `halo` rows above and
+ *   below (the caller resolves MULTI_DEVICE_HALO_AUTO first). The kernel is launched over the band with a global work offset,
+ *   and the band's output rows are read back into the shared frame. Kernels
+ *   must address rows through get_global_id(1), like tiled dispatches.
+ * - Frames: whole frames of a batch are dealt out to the devices, each with
+ *   two in-flight buffer sets. Outputs are retired in frame order.
+ *
+ * Every buffer set has its own kernel with its arguments bound at setup, so
+ * the measured rounds only enqueue. Each device resolves the kernel's
+ * precision itself: an fp16 variant falls back to fp32 only where
+ * cl_khr_fp16 is missing.
+ *
+ * Work is shared in proportion to each device's measured throughput: rows
+ * or frames per millisecond of device busy time. The first shares come
+ * from the last run on the same device set (out/{algorithm}/{key}.balance),
+ * or from compute units x clock. They are refined after every round with
+ * an exponential moving average and saved when the run ends.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Static device tables, no dynamic allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#include "opencl_utils.h"
+#include "utils/config.h"
+#include "utils/verify.h"
+
+/** Weight of the newest measurement in the learned work shares */
+#define MULTI_DEVICE_SMOOTHING 0.5
+
+/** Maximum OpenCL platforms enumerated */
+#define MAX_MULTI_PLATFORMS 8
+
+/**
+ * @brief Devices of a multi-device run
+ *
+ * devices[0] is the primary environment from OpenclInit() (borrowed); the
+ * others are owned by the set.
+ */
+typedef struct {
+    OpenCLEnv* devices[MAX_MULTI_DEVICES]; /**< Device environments */
+    int count;                             /**< Number of devices */
+} MultiDeviceSet;
+
+/**
+ * @brief Per-device outcome of a multi-device run
+ */
+typedef struct {
+    char device_name[MAX_DEVICE_NAME_SIZE]; /**< CL_DEVICE_NAME */
+    double share;                           /**< Learned share of the work at the end (0-1) */
+    int units;                              /**< Rows of the last round, or frames processed */
+    double busy_ms;                         /**< Busy time (mean per round, or whole batch) */
+    double rate;                            /**< Rows or frames per millisecond of busy time */
+} MultiDeviceStats;
+
+/**
+ * @brief Outcome of a multi-device run
+ */
+typedef struct {
+    MultiDeviceSplit split;                     /**< Split used */
+    int device_count;                           /**< Devices used */
+    int frames;                                 /**< Frames processed (one per row round) */
+    double total_ms;                            /**< Host wall-clock of the measured work */
+    double fps;                                 /**< Frames per second */
+    int checks;                                 /**< Outputs compared with the reference */
+    int failures;                               /**< Outputs that failed the comparison */
+    MultiDeviceStats devices[MAX_MULTI_DEVICES]; /**< Per-device statistics */
+} MultiDeviceResult;
+
+/**
+ * @brief Collect every OpenCL device of every platform
+ *
+ * The primary device comes first; the other devices are initialized with
+ * their own context and queue, up to @p max_devices in total.
+ *
+ * @param[in] primary Initialized primary environment
+ * @param[in] max_devices Devices to use (0 = all, capped at MAX_MULTI_DEVICES)
+ * @param[out] set Device set
+ * @return 0 on success (set->count >= 1), -1 on error
+ */
+int MultiDeviceOpen(OpenCLEnv* primary, int max_devices, MultiDeviceSet* set);
+
+/**
+ * @brief Release the queues and contexts of the devices the set owns
+ *
+ * @param[in,out] set Device set (safe on a zeroed or closed one)
+ */
+void MultiDeviceClose(MultiDeviceSet* set);
+
+/**
+ * @brief Run an already verified kernel across all devices of the set
+ *
+ * Custom buffers are copied into each device's context (file-backed ones
+ * from their host data); scalars come from params. Row bands need a
+ * standard 2D kernel on packed rows with equal input and output heights.
+ *
+ * @param[in] set Device set from MultiDeviceOpen()
+ * @param[in] algorithm_id Algorithm identifier (program cache, balance file)
+ * @param[in] kernel_cfg Kernel configuration (arguments and work sizes)
+ * @param[in] params Operation parameters of the verified run (packed strides)
+ * @param[in] md_cfg Multi-device settings
+ * @param[in] stream_cfg Frame source of the frame split (input_path empty: repeat @p input)
+ * @param[in] input Input frame
+ * @param[in] input_size Bytes per input frame
+ * @param[out] output Output frame (row bands: the assembled last frame)
+ * @param[in] output_size Bytes per output frame
+ * @param[in] reference Reference output to compare with, or NULL (not used with a frame source)
+ * @param[in] verify_opts Comparison settings (used with @p reference)
+ * @param[out] result Throughput, learned shares and comparison counts
+ * @return 0 on success, -1 on error
+ */
+int MultiDeviceRun(const MultiDeviceSet* set, const char* algorithm_id,
+                   const KernelConfig* kernel_cfg, const OpParams* params,
+                   const MultiDeviceConfig* md_cfg, const StreamConfig* stream_cfg,
+                   const unsigned char* input, size_t input_size, unsigned char* output,
+                   size_t output_size, const unsigned char* reference,
+                   const VerifyOptions* verify_opts, MultiDeviceResult* result);
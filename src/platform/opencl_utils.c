@@ -19,12 +19,19 @@
 #include "opencl_utils.h"
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "buffer_pool.h"
 #include "cache_manager.h"
+#include "image_view.h"
 #include "kernel_args.h"
+#include "primitives.h"
+#include "program_registry.h"
+#include "trace.h"
+#include "utils/benchmark.h"
 
 /* Fallback for non-CMake builds - assumes running from project root */
 #ifndef CL_INCLUDE_DIR
@@ -43,7 +50,6 @@
 
 #define MAX_KERNEL_SOURCE_SIZE (1024 * 1024) /* 1MB max kernel source */
 #define MAX_BUILD_LOG_SIZE (16 * 1024)       /* 16KB max build log */
-#define MAX_DEVICE_NAME_SIZE 128
 #define MAX_HEADER_SOURCE_SIZE (256 * 1024) /* 256KB max for embedded headers */
 
 static char kernel_source_buffer[MAX_KERNEL_SOURCE_SIZE];
@@ -328,29 +334,66 @@ static int EmbedHeaders(const char* kernel_file, char* buffer, size_t max_size,
  * OpenCL Environment Lifecycle
  * ============================================================================ */
 
+/* Non-zero if the device extension list contains @p name as a whole word */
+static int DeviceHasExtension(cl_device_id device, const char* name) {
+    /* MISRA-C:2023 Rule 21.3: Static buffer instead of malloc */
+    static char extensions[8192];
+    size_t name_len = strlen(name);
+    const char* pos;
+
+    if (clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, sizeof(extensions), extensions, NULL) !=
+        CL_SUCCESS) {
+        return 0;
+    }
+    extensions[sizeof(extensions) - 1U] = '\0';
+    for (pos = strstr(extensions, name); pos != NULL; pos = strstr(pos + 1, name)) {
+        if (((pos == extensions) || (pos[-1] == ' ')) &&
+            ((pos[name_len] == ' ') || (pos[name_len] == '\0'))) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Non-zero if CL_DEVICE_VERSION ("OpenCL <major>.<minor> ...") is at least 2.0 */
+static int DeviceIsOpencl20(cl_device_id device) {
+    char version[MAX_VERSION_STRING_SIZE];
+    int major = 0;
+
+    if (clGetDeviceInfo(device, CL_DEVICE_VERSION, sizeof(version), version, NULL) !=
+        CL_SUCCESS) {
+        return 0;
+    }
+    version[sizeof(version) - 1U] = '\0';
+    if ((strncmp(version, "OpenCL ", 7U) == 0) && (version[7] >= '0') && (version[7] <= '9')) {
+        major = version[7] - '0';
+    }
+    return (major >= 2) ? 1 : 0;
+}
+
 int OpenclInit(OpenCLEnv* env) {
     cl_int err;
     cl_uint num_platforms;
     cl_uint num_devices;
-    char device_name[MAX_DEVICE_NAME_SIZE];
-    cl_command_queue_properties props;
+    cl_platform_id platform;
+    cl_device_id device;
 
     if (env == NULL) {
         return -1;
     }
 
     /* Get platform */
-    err = clGetPlatformIDs(1U, &env->platform, &num_platforms);
+    err = clGetPlatformIDs(1U, &platform, &num_platforms);
     if (err != CL_SUCCESS) {
         (void)fprintf(stderr, "Error: Failed to get platform IDs (error code: %d)\n", err);
         return -1;
     }
 
     /* Get device */
-    err = clGetDeviceIDs(env->platform, CL_DEVICE_TYPE_GPU, 1U, &env->device, &num_devices);
+    err = clGetDeviceIDs(platform, CL_DEVICE_TYPE_GPU, 1U, &device, &num_devices);
     if (err != CL_SUCCESS) {
         /* Try CPU if GPU is not available */
-        err = clGetDeviceIDs(env->platform, CL_DEVICE_TYPE_CPU, 1U, &env->device, &num_devices);
+        err = clGetDeviceIDs(platform, CL_DEVICE_TYPE_CPU, 1U, &device, &num_devices);
         if (err != CL_SUCCESS) {
             (void)fprintf(stderr, "Error: Failed to get device IDs (error code: %d)\n", err);
             return -1;
@@ -360,11 +403,95 @@ int OpenclInit(OpenCLEnv* env) {
         (void)printf("Using GPU device\n");
     }
 
-    /* Print device info */
-    err = clGetDeviceInfo(env->device, CL_DEVICE_NAME, sizeof(device_name), device_name, NULL);
+    return OpenclInitDevice(env, platform, device);
+}
+
+int OpenclInitDevice(OpenCLEnv* env, cl_platform_id platform, cl_device_id device) {
+    cl_int err;
+    cl_command_queue_properties props;
+
+    if (env == NULL) {
+        return -1;
+    }
+    (void)memset(env, 0, sizeof(*env));
+    env->platform = platform;
+    env->device = device;
+
+    /* Print device info (name kept in env for result reports) */
+    err = clGetDeviceInfo(env->device, CL_DEVICE_NAME, sizeof(env->device_name),
+                          env->device_name, NULL);
     if (err == CL_SUCCESS) {
-        (void)printf("Device: %s\n", device_name);
+        (void)printf("Device: %s\n", env->device_name);
+    } else {
+        env->device_name[0] = '\0';
+    }
+
+    /* Driver and platform versions are part of the kernel cache key */
+    err = clGetDeviceInfo(env->device, CL_DRIVER_VERSION, sizeof(env->driver_version),
+                          env->driver_version, NULL);
+    if (err != CL_SUCCESS) {
+        env->driver_version[0] = '\0';
+    }
+    err = clGetPlatformInfo(env->platform, CL_PLATFORM_VERSION, sizeof(env->platform_version),
+                            env->platform_version, NULL);
+    if (err != CL_SUCCESS) {
+        env->platform_version[0] = '\0';
+    }
+
+    /* Device limits for the kernel hardware report (zero when a query fails) */
+    if (clGetDeviceInfo(env->device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(env->compute_units),
+                        &env->compute_units, NULL) != CL_SUCCESS) {
+        env->compute_units = 0U;
+    }
+    if (clGetDeviceInfo(env->device, CL_DEVICE_MAX_WORK_GROUP_SIZE,
+                        sizeof(env->max_work_group_size), &env->max_work_group_size,
+                        NULL) != CL_SUCCESS) {
+        env->max_work_group_size = 0U;
+    }
+    if (clGetDeviceInfo(env->device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(env->local_mem_size),
+                        &env->local_mem_size, NULL) != CL_SUCCESS) {
+        env->local_mem_size = 0U;
+    }
+    if (clGetDeviceInfo(env->device, CL_DEVICE_MAX_CLOCK_FREQUENCY, sizeof(env->max_clock_mhz),
+                        &env->max_clock_mhz, NULL) != CL_SUCCESS) {
+        env->max_clock_mhz = 0U;
     }
+    env->copy_bandwidth_gbps = 0.0;
+    {
+        cl_uint align_bits = 0U;
+        if ((clGetDeviceInfo(env->device, CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(align_bits),
+                             &align_bits, NULL) == CL_SUCCESS) &&
+            (align_bits >= 8U)) {
+            env->row_pitch_alignment = (size_t)align_bits / 8U;
+        } else {
+            env->row_pitch_alignment = DEFAULT_ROW_PITCH_ALIGNMENT;
+        }
+        /* Image views need pitches aligned to CL_DEVICE_IMAGE_PITCH_ALIGNMENT pixels (8-bit) */
+        env->image_views_supported = (DeviceIsOpencl20(env->device) != 0) ||
+                                     (DeviceHasExtension(env->device,
+                                                         "cl_khr_image2d_from_buffer") != 0);
+#ifdef CL_VERSION_2_0
+        align_bits = 0U;
+        if ((env->image_views_supported != 0) &&
+            (clGetDeviceInfo(env->device, CL_DEVICE_IMAGE_PITCH_ALIGNMENT, sizeof(align_bits),
+                             &align_bits, NULL) == CL_SUCCESS) &&
+            ((size_t)align_bits > env->row_pitch_alignment)) {
+            env->row_pitch_alignment = (size_t)align_bits;
+        }
+#else
+        /* OpenCL 1.2 headers cannot query the image pitch alignment */
+        if ((env->image_views_supported != 0) &&
+            (env->row_pitch_alignment < DEFAULT_ROW_PITCH_ALIGNMENT)) {
+            env->row_pitch_alignment = DEFAULT_ROW_PITCH_ALIGNMENT;
+        }
+#endif
+    }
+    (void)printf("Compute units: %u, max work-group: %zu, local memory: %lu KB, clock: %u MHz\n",
+                 (unsigned int)env->compute_units, env->max_work_group_size,
+                 (unsigned long)(env->local_mem_size / 1024U), (unsigned int)env->max_clock_mhz);
+    env->fp16_supported = DeviceHasExtension(env->device, "cl_khr_fp16");
+    (void)printf("Half precision (cl_khr_fp16): %s\n",
+                 (env->fp16_supported != 0) ? "supported" : "not supported, fp16 variants run fp32");
 
     /* Create context */
     env->context = clCreateContext(NULL, 1U, &env->device, NULL, NULL, &err);
@@ -401,128 +528,194 @@ int OpenclInit(OpenCLEnv* env) {
  * Kernel Building
  * ============================================================================ */
 
-cl_kernel OpenclBuildKernel(OpenCLEnv* env, const char* algorithm_id,
-                            const struct KernelConfig* kernel_cfg) {
-    cl_int err;
-    size_t source_length;
-    cl_program program = NULL;
-    cl_kernel kernel;
-    size_t log_size;
-    const char* source_ptr;
-    int used_cache = 0;
-    char cache_name[256];
-    char build_options[512];
-    const char* kernel_file;
-    const char* kernel_name;
-    const char* kernel_option;
-    HostType host_type;
+/**
+ * @brief Compute the kernel binary cache key
+ *
+ * Hashes device name, driver version, platform version, build options and the
+ * header-embedded kernel source. Fields are NUL-separated so that shifting
+ * characters between fields changes the key.
+ *
+ * @param env OpenCL environment (device/driver/platform strings)
+ * @param build_options Final build options passed to clBuildProgram
+ * @param source Combined kernel source
+ * @param source_length Source length in bytes
+ * @param key_out Key output (CACHE_HASH_SIZE bytes)
+ */
+static void ComputeBuildKey(const OpenCLEnv* env, const char* build_options, const char* source,
+                            size_t source_length, unsigned char* key_out) {
+    CacheHashState state;
+    const char* fields[4];
+    size_t i;
+
+    fields[0] = env->device_name;
+    fields[1] = env->driver_version;
+    fields[2] = env->platform_version;
+    fields[3] = build_options;
+
+    CacheHashInit(&state);
+    for (i = 0U; i < 4U; i++) {
+        /* Include the terminator as field separator */
+        CacheHashUpdate(&state, fields[i], strlen(fields[i]) + 1U);
+    }
+    CacheHashUpdate(&state, source, source_length);
+    CacheHashFinal(&state, key_out);
+}
 
-    if ((env == NULL) || (algorithm_id == NULL) || (kernel_cfg == NULL)) {
-        return NULL;
+void OpenclResolvePrecision(const OpenCLEnv* env, struct KernelConfig* kernel_cfg) {
+    if ((env == NULL) || (kernel_cfg == NULL)) {
+        return;
     }
+    kernel_cfg->precision_fallback = 0;
+    if ((kernel_cfg->precision == KERNEL_PRECISION_FP16) && (env->fp16_supported == 0)) {
+        kernel_cfg->precision_fallback = 1;
+    }
+}
 
-    /* Extract parameters from KernelConfig */
-    kernel_file = kernel_cfg->kernel_file;
-    kernel_name = kernel_cfg->kernel_function;
-    kernel_option = kernel_cfg->kernel_option;
-    host_type = kernel_cfg->host_type;
+int OpenclCheckImageArgs(const OpenCLEnv* env, const struct KernelConfig* kernel_cfg) {
+    int i;
+
+    if ((env == NULL) || (kernel_cfg == NULL)) {
+        return -1;
+    }
+    if (env->image_views_supported != 0) {
+        return 0;
+    }
+    for (i = 0; i < kernel_cfg->kernel_arg_count; i++) {
+        if ((kernel_cfg->kernel_args[i].arg_type == KERNEL_ARG_TYPE_IMAGE_INPUT) ||
+            (kernel_cfg->kernel_args[i].arg_type == KERNEL_ARG_TYPE_IMAGE_OUTPUT)) {
+            (void)fprintf(stderr,
+                          "Error: %s uses i_image/o_image args, which need an OpenCL 2.0 device "
+                          "or cl_khr_image2d_from_buffer (%s has neither)\n",
+                          kernel_cfg->variant_id, env->device_name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int OpenclComposeBuildOptions(const struct KernelConfig* kernel_cfg, char* build_options,
+                              size_t options_size) {
+    int written;
+    int host_type_val;
+    int use_fp16;
+
+    if ((kernel_cfg == NULL) || (build_options == NULL) || (options_size == 0U)) {
+        return -1;
+    }
+
+    /* Construct build options:
+     * "<user_options> [-DSPEC_<NAME>=<value> ...] [-DUSE_FP16=1] -DHOST_TYPE=N" */
+    host_type_val = (kernel_cfg->host_type == HOST_TYPE_CL_EXTENSION) ? 1 : 0;
+    use_fp16 = ((kernel_cfg->precision == KERNEL_PRECISION_FP16) &&
+                (kernel_cfg->precision_fallback == 0))
+                   ? 1
+                   : 0;
+    written = snprintf(build_options, options_size, "%s%s%s -DHOST_TYPE=%d",
+                       kernel_cfg->kernel_option, kernel_cfg->specialize_defines,
+                       (use_fp16 != 0) ? " -DUSE_FP16=1" : "", host_type_val);
+    if ((written < 0) || ((size_t)written >= options_size)) {
+        (void)fprintf(stderr, "Error: Kernel build options too long\n");
+        return -1;
+    }
+    return 0;
+}
+
+int OpenclPrepareProgramSource(const OpenCLEnv* env, const char* kernel_file,
+                               const char* build_options, HostType host_type,
+                               const char** source, size_t* source_length, char* keyed_name,
+                               size_t keyed_name_size) {
+    char cache_name[256];
+    unsigned char build_key[CACHE_HASH_SIZE];
+
+    if ((env == NULL) || (kernel_file == NULL) || (build_options == NULL) || (source == NULL) ||
+        (source_length == NULL) || (keyed_name == NULL)) {
+        return -1;
+    }
 
     /* Extract cache name from kernel file (e.g., "dilate_1" from
      * "src/dilate/cl/dilate_1.cl") */
     if (ExtractCacheName(kernel_file, cache_name, sizeof(cache_name)) != 0) {
         (void)fprintf(stderr, "Error: Failed to extract cache name from %s\n", kernel_file);
-        return NULL;
+        return -1;
     }
 
-    /* Check if cached kernel binary exists AND source hasn't changed */
-    if (CacheKernelIsValid(algorithm_id, cache_name, kernel_file) != 0) {
-        (void)printf("Found valid cached kernel binary for %s, loading...\n", cache_name);
-        program = CacheLoadKernelBinary(env->context, env->device, algorithm_id, cache_name);
-        if (program != NULL) {
-            used_cache = 1;
-            (void)printf("Using cached kernel binary: %s\n", cache_name);
-        } else {
-            (void)printf("Failed to load cached binary, will compile from source\n");
-        }
+    /* Read kernel source with embedded platform headers (needed for the cache key) */
+    if (EmbedHeaders(kernel_file, combined_source_buffer, sizeof(combined_source_buffer),
+                     source_length, host_type) != 0) {
+        return -1;
     }
 
-    /* Construct build options: "<user_options> -DHOST_TYPE=N" */
-    {
-        const char* user_opts = (kernel_option != NULL) ? kernel_option : "";
-        int host_type_val = (host_type == HOST_TYPE_CL_EXTENSION) ? 1 : 0;
-
-        (void)snprintf(build_options, sizeof(build_options), "%s -DHOST_TYPE=%d", user_opts,
-                       host_type_val);
-        (void)printf("Kernel build options: %s\n", build_options);
+    /* Cache key covers everything that affects the binary */
+    ComputeBuildKey(env, build_options, combined_source_buffer, *source_length, build_key);
+    if (CacheFormatKeyedName(cache_name, build_key, keyed_name, keyed_name_size) != 0) {
+        (void)fprintf(stderr, "Error: Failed to build cache key for %s\n", cache_name);
+        return -1;
     }
 
-    /* If no cached binary or loading failed, compile from source */
-    if (used_cache == 0) {
-        /* Read kernel source with embedded platform headers */
-        if (EmbedHeaders(kernel_file, combined_source_buffer, sizeof(combined_source_buffer),
-                         &source_length, host_type) != 0) {
-            return NULL;
-        }
-        source_ptr = combined_source_buffer;
+    *source = combined_source_buffer;
+    return 0;
+}
 
-        /* Create program */
-        program = clCreateProgramWithSource(env->context, 1U, &source_ptr, &source_length, &err);
-        if (err != CL_SUCCESS) {
-            (void)fprintf(stderr, "Error: Failed to create program (error code: %d)\n", err);
-            return NULL;
-        }
+cl_program OpenclBuildProgram(OpenCLEnv* env, const char* algorithm_id, const char* kernel_file,
+                              const char* build_options, HostType host_type) {
+    cl_int err;
+    size_t source_length;
+    cl_program program = NULL;
+    size_t log_size;
+    const char* source_ptr;
+    char keyed_name[256 + 32];
 
-        /* Build program with options */
-        err = clBuildProgram(program, 1U, &env->device, build_options, NULL, NULL);
-        if (err != CL_SUCCESS) {
-            (void)fprintf(stderr, "Error: Failed to build program (error code: %d)\n", err);
-
-            /* Print build log */
-            err = clGetProgramBuildInfo(program, env->device, CL_PROGRAM_BUILD_LOG, 0U, NULL,
-                                        &log_size);
-            if (err == CL_SUCCESS) {
-                if (log_size <= MAX_BUILD_LOG_SIZE) {
-                    err = clGetProgramBuildInfo(program, env->device, CL_PROGRAM_BUILD_LOG,
-                                                log_size, build_log_buffer, NULL);
-                    if (err == CL_SUCCESS) {
-                        (void)fprintf(stderr, "Build log:\n%s\n", build_log_buffer);
-                    }
-                } else {
-                    (void)fprintf(stderr, "Build log too large (%zu bytes)\n", log_size);
-                }
-            }
+    if ((env == NULL) || (algorithm_id == NULL) || (kernel_file == NULL) ||
+        (build_options == NULL)) {
+        return NULL;
+    }
 
-            /* MISRA-C:2023 Rule 17.7: Check return value */
-            err = clReleaseProgram(program);
-            if (err != CL_SUCCESS) {
-                (void)fprintf(stderr, "Warning: Failed to release program (error: %d)\n", err);
-            }
-            return NULL;
+    (void)printf("Kernel build options: %s\n", build_options);
+
+    if (OpenclPrepareProgramSource(env, kernel_file, build_options, host_type, &source_ptr,
+                                   &source_length, keyed_name, sizeof(keyed_name)) != 0) {
+        return NULL;
+    }
+
+    /* Check if a cached binary for this exact build key exists */
+    if (CacheKernelExists(algorithm_id, keyed_name) != 0) {
+        (void)printf("Found cached kernel binary for %s, loading...\n", keyed_name);
+        program = CacheLoadKernelBinary(env->context, env->device, algorithm_id, keyed_name);
+        if (program != NULL) {
+            (void)printf("Using cached kernel binary: %s\n", keyed_name);
+            return program;
         }
+        (void)printf("Failed to load cached binary, will compile from source\n");
+    }
 
-        (void)printf("Kernel compiled successfully\n");
+    /* No cached binary or loading failed: compile from source */
+    /* Create program */
+    program = clCreateProgramWithSource(env->context, 1U, &source_ptr, &source_length, &err);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Error: Failed to create program (error code: %d)\n", err);
+        return NULL;
+    }
 
-        /* Save compiled binary to cache for future runs */
-        if (CacheSaveKernelBinary(program, env->device, algorithm_id, cache_name) == 0) {
-            /* Also save source hash for change detection */
-            unsigned char source_hash[CACHE_HASH_SIZE];
-            if (CacheComputeSourceHash(kernel_file, source_hash) == 0) {
-                if (CacheSaveSourceHash(algorithm_id, cache_name, source_hash) != 0) {
-                    (void)fprintf(stderr, "Warning: Failed to save source hash\n");
+    /* Build program with options */
+    err = clBuildProgram(program, 1U, &env->device, build_options, NULL, NULL);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Error: Failed to build program (error code: %d)\n", err);
+
+        /* Print build log */
+        err = clGetProgramBuildInfo(program, env->device, CL_PROGRAM_BUILD_LOG, 0U, NULL,
+                                    &log_size);
+        if (err == CL_SUCCESS) {
+            if (log_size <= MAX_BUILD_LOG_SIZE) {
+                err = clGetProgramBuildInfo(program, env->device, CL_PROGRAM_BUILD_LOG, log_size,
+                                            build_log_buffer, NULL);
+                if (err == CL_SUCCESS) {
+                    (void)fprintf(stderr, "Build log:\n%s\n", build_log_buffer);
                 }
             } else {
-                (void)fprintf(stderr, "Warning: Failed to compute source hash\n");
+                (void)fprintf(stderr, "Build log too large (%zu bytes)\n", log_size);
             }
-        } else {
-            (void)fprintf(stderr, "Warning: Failed to cache kernel binary\n");
         }
-    }
 
-    /* Create kernel */
-    kernel = clCreateKernel(program, kernel_name, &err);
-    if (err != CL_SUCCESS) {
-        (void)fprintf(stderr, "Error: Failed to create kernel '%s' (error code: %d)\n", kernel_name,
-                      err);
         /* MISRA-C:2023 Rule 17.7: Check return value */
         err = clReleaseProgram(program);
         if (err != CL_SUCCESS) {
@@ -531,16 +724,34 @@ cl_kernel OpenclBuildKernel(OpenCLEnv* env, const char* algorithm_id,
         return NULL;
     }
 
-    /* We can release the program now that the kernel is created */
-    /* MISRA-C:2023 Rule 17.7: Check return value */
-    err = clReleaseProgram(program);
-    if (err != CL_SUCCESS) {
-        (void)fprintf(stderr, "Warning: Failed to release program (error: %d)\n", err);
+    (void)printf("Kernel compiled successfully\n");
+
+    /* Save compiled binary to cache for future runs (key already covers the source) */
+    if (CacheSaveKernelBinary(program, env->device, algorithm_id, keyed_name) != 0) {
+        (void)fprintf(stderr, "Warning: Failed to cache kernel binary\n");
+    } else {
+        (void)printf("Built %s (cached as %s)\n", kernel_file, keyed_name);
+    }
+    return program;
+}
+
+cl_kernel OpenclBuildKernel(OpenCLEnv* env, const char* algorithm_id,
+                            const struct KernelConfig* kernel_cfg) {
+    cl_kernel kernel;
+    KernelReport resources;
+
+    if ((env == NULL) || (algorithm_id == NULL) || (kernel_cfg == NULL)) {
+        return NULL;
+    }
+    if (OpenclCheckImageArgs(env, kernel_cfg) != 0) {
+        return NULL;
     }
 
-    if (used_cache == 0) {
-        (void)printf("Built kernel '%s' from %s (cached as %s)\n", kernel_name, kernel_file,
-                     cache_name);
+    /* Each unique (file, build options) is built once; kernels are handed out by name */
+    kernel =
+        ProgramRegistryCreateKernel(env, algorithm_id, kernel_cfg, kernel_cfg->kernel_function);
+    if ((kernel != NULL) && (KernelReportQuery(env, kernel, &resources) == 0)) {
+        KernelReportPrintResources(&resources);
     }
     return kernel;
 }
@@ -549,60 +760,101 @@ cl_kernel OpenclBuildKernel(OpenCLEnv* env, const char* algorithm_id,
  * Kernel Execution
  * ============================================================================ */
 
-int OpenclRunKernel(OpenCLEnv* env, cl_kernel kernel, const Algorithm* algo, cl_mem input_buf,
-                    cl_mem output_buf, const OpParams* params,
-                    const struct KernelConfig* kernel_cfg, double* gpu_time_ms) {
+int OpenclGetEventDurationMs(cl_event event, double* duration_ms) {
     cl_int err;
-    cl_event event;
     cl_ulong time_start;
     cl_ulong time_end;
-    const size_t* global_work_size;
-    const size_t* local_work_size;
-    int work_dim;
-    HostType host_type;
 
-    if ((env == NULL) || (kernel == NULL) || (params == NULL) || (gpu_time_ms == NULL)) {
+    if ((event == NULL) || (duration_ms == NULL)) {
         return -1;
     }
 
-    /* Set kernel arguments using kernel_cfg */
+    /* Tiled extension dispatches report the span of their tiles */
+    err = ClExtensionGetEventTimes(event, &time_start, &time_end);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to get profiling times (error code: %d)\n", err);
+        return -1;
+    }
+
+    /* Convert nanoseconds to milliseconds */
+    *duration_ms = (double)(time_end - time_start) / 1000000.0;
+    return 0;
+}
+
+int OpenclDispatchKernel(OpenCLEnv* env, cl_kernel kernel, const struct KernelConfig* kernel_cfg,
+                         double* gpu_time_ms) {
     if (kernel_cfg == NULL) {
-        (void)fprintf(stderr, "Error: kernel_cfg is required for setting kernel arguments\n");
         return -1;
     }
+    return OpenclDispatchKernelWithLocalSize(env, kernel, kernel_cfg, kernel_cfg->local_work_size,
+                                             gpu_time_ms);
+}
 
-    /* Extract parameters from KernelConfig */
-    global_work_size = kernel_cfg->global_work_size;
-    local_work_size = kernel_cfg->local_work_size;
-    work_dim = kernel_cfg->work_dim;
-    host_type = kernel_cfg->host_type;
+int OpenclEnqueueKernel(OpenCLEnv* env, cl_kernel kernel, const struct KernelConfig* kernel_cfg,
+                        const size_t* local_work_size, cl_uint num_wait_events,
+                        const cl_event* wait_list, cl_event* event) {
+    if (env == NULL) {
+        return -1;
+    }
+    return OpenclEnqueueKernelOnQueue(env, env->queue, kernel, kernel_cfg, local_work_size,
+                                      num_wait_events, wait_list, event);
+}
 
-    if (OpenclSetKernelArgs(kernel, input_buf, output_buf, params, kernel_cfg) != 0) {
-        (void)fprintf(stderr, "Failed to set kernel arguments from config\n");
+int OpenclEnqueueKernelOnQueue(OpenCLEnv* env, cl_command_queue queue, cl_kernel kernel,
+                               const struct KernelConfig* kernel_cfg,
+                               const size_t* local_work_size, cl_uint num_wait_events,
+                               const cl_event* wait_list, cl_event* event) {
+    cl_int err;
+    const size_t* local;
+
+    if ((env == NULL) || (queue == NULL) || (kernel == NULL) || (kernel_cfg == NULL) ||
+        (local_work_size == NULL) || (event == NULL)) {
         return -1;
     }
 
+    local = (local_work_size[0] == 0U) ? NULL : local_work_size;
+
     /* Execute kernel using appropriate API based on host_type */
-    if (host_type == HOST_TYPE_STANDARD) {
-        (void)printf("\n=== Using Standard OpenCL API ===\n");
-        err = clEnqueueNDRangeKernel(env->queue, kernel, (cl_uint)work_dim, NULL, global_work_size,
-                                     (local_work_size[0] == 0U) ? NULL : local_work_size, 0U, NULL,
-                                     &event);
+    if (kernel_cfg->host_type == HOST_TYPE_STANDARD) {
+        err = clEnqueueNDRangeKernel(queue, kernel, (cl_uint)kernel_cfg->work_dim, NULL,
+                                     kernel_cfg->global_work_size, local, num_wait_events,
+                                     wait_list, event);
     } else {
-        (void)printf("\n=== Using Custom CL Extension API ===\n");
-        err = ClExtensionEnqueueNdrangeKernel(
-            &env->ext_ctx, env->queue, kernel, (cl_uint)work_dim, NULL, global_work_size,
-            (local_work_size[0] == 0U) ? NULL : local_work_size, 0U, NULL, &event);
-
-            CacheSaveCustomBinary(&env->ext_ctx);
+        ClExtensionSetTiling(&env->ext_ctx, &kernel_cfg->tiling);
+        err = ClExtensionEnqueueNdrangeKernel(&env->ext_ctx, queue, kernel,
+                                              (cl_uint)kernel_cfg->work_dim, NULL,
+                                              kernel_cfg->global_work_size, local, num_wait_events,
+                                              wait_list, event);
     }
 
     if (err != CL_SUCCESS) {
         (void)fprintf(stderr, "Failed to enqueue kernel (error code: %d)\n", err);
         return -1;
     }
+    /* The extension path records its own launch */
+    if (kernel_cfg->host_type == HOST_TYPE_STANDARD) {
+        TraceRecordKernel(*event, queue, kernel, "kernel");
+    }
+    return 0;
+}
+
+int OpenclDispatchKernelWithLocalSize(OpenCLEnv* env, cl_kernel kernel,
+                                      const struct KernelConfig* kernel_cfg,
+                                      const size_t* local_work_size, double* gpu_time_ms) {
+    cl_int err;
+    cl_event event;
+    int result;
+
+    if ((env == NULL) || (kernel == NULL) || (kernel_cfg == NULL) || (local_work_size == NULL) ||
+        (gpu_time_ms == NULL)) {
+        return -1;
+    }
 
-    /* Wait for completion - use custom API if configured */
+    if (OpenclEnqueueKernel(env, kernel, kernel_cfg, local_work_size, 0U, NULL, &event) != 0) {
+        return -1;
+    }
+
+    /* Wait for completion */
     err = clFinish(env->queue);
 
     if (err != CL_SUCCESS) {
@@ -613,29 +865,50 @@ int OpenclRunKernel(OpenCLEnv* env, cl_kernel kernel, const Algorithm* algo, cl_
     }
 
     /* Get execution time from profiling events */
-    err = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(time_start),
-                                  &time_start, NULL);
-    if (err != CL_SUCCESS) {
-        (void)fprintf(stderr, "Failed to get profiling start time (error code: %d)\n", err);
-        /* MISRA-C:2023 Rule 17.7: Check return value */
-        (void)clReleaseEvent(event);
+    result = OpenclGetEventDurationMs(event, gpu_time_ms);
+
+    /* MISRA-C:2023 Rule 17.7: Check return value */
+    (void)clReleaseEvent(event);
+    return result;
+}
+
+int OpenclRunKernel(OpenCLEnv* env, cl_kernel kernel, const Algorithm* algo, cl_mem input_buf,
+                    cl_mem output_buf, const OpParams* params,
+                    const struct KernelConfig* kernel_cfg, double* gpu_time_ms,
+                    KernelReport* report) {
+    if ((env == NULL) || (kernel == NULL) || (params == NULL) || (gpu_time_ms == NULL)) {
         return -1;
     }
 
-    err =
-        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(time_end), &time_end, NULL);
-    if (err != CL_SUCCESS) {
-        (void)fprintf(stderr, "Failed to get profiling end time (error code: %d)\n", err);
-        /* MISRA-C:2023 Rule 17.7: Check return value */
-        (void)clReleaseEvent(event);
+    /* Set kernel arguments using kernel_cfg */
+    if (kernel_cfg == NULL) {
+        (void)fprintf(stderr, "Error: kernel_cfg is required for setting kernel arguments\n");
         return -1;
     }
 
-    /* Convert nanoseconds to milliseconds */
-    *gpu_time_ms = (double)(time_end - time_start) / 1000000.0;
+    if (OpenclSetKernelArgs(kernel, input_buf, output_buf, params, kernel_cfg) != 0) {
+        (void)fprintf(stderr, "Failed to set kernel arguments from config\n");
+        return -1;
+    }
 
-    /* MISRA-C:2023 Rule 17.7: Check return value */
-    (void)clReleaseEvent(event);
+    if (kernel_cfg->host_type == HOST_TYPE_STANDARD) {
+        (void)printf("\n=== Using Standard OpenCL API ===\n");
+    } else {
+        (void)printf("\n=== Using Custom CL Extension API ===\n");
+    }
+
+    if (OpenclDispatchKernel(env, kernel, kernel_cfg, gpu_time_ms) != 0) {
+        return -1;
+    }
+
+    if (kernel_cfg->host_type != HOST_TYPE_STANDARD) {
+        CacheSaveCustomBinary(&env->ext_ctx);
+    }
+
+    if ((report != NULL) && (KernelReportQuery(env, kernel, report) == 0)) {
+        KernelReportFinish(env, kernel_cfg, input_buf, output_buf, params, *gpu_time_ms, report);
+        KernelReportPrint(report);
+    }
     return 0;
 }
 
@@ -647,24 +920,300 @@ cl_mem OpenclCreateBuffer(cl_context context, cl_mem_flags flags, size_t size, v
                           const char* buffer_name) {
     cl_int err;
     cl_mem buffer;
+    char span_name[64];
+    double start_ms;
 
     if ((context == NULL) || (buffer_name == NULL)) {
         (void)fprintf(stderr, "Error: Invalid parameters to OpenclCreateBuffer\n");
         return NULL;
     }
 
-    buffer = clCreateBuffer(context, flags, size, host_ptr, &err);
+    start_ms = BenchmarkNowMs();
+    if (BufferPoolAccepts(flags, host_ptr) != 0) {
+        buffer = BufferPoolAcquire(context, flags, size, &err);
+    } else {
+        buffer = clCreateBuffer(context, flags, size, host_ptr, &err);
+    }
     if (err != CL_SUCCESS) {
         (void)fprintf(stderr, "Failed to create %s buffer (error code: %d)\n", buffer_name, err);
         return NULL;
     }
+    if (TraceEnabled() != 0) {
+        (void)snprintf(span_name, sizeof(span_name), "create %s", buffer_name);
+        TraceRecordHost(span_name, "buffer", start_ms, BenchmarkNowMs());
+    }
     return buffer;
 }
 
+const char* OpenclMemoryStrategyName(MemoryStrategy strategy) {
+    if (strategy == MEM_STRATEGY_USE_HOST_PTR) {
+        return "use_host_ptr";
+    }
+    if (strategy == MEM_STRATEGY_ALLOC_HOST_PTR) {
+        return "alloc_host_ptr";
+    }
+    return "copy";
+}
+
+cl_mem OpenclCreateStrategyBuffer(const OpenCLEnv* env, cl_mem_flags flags, size_t size,
+                                  void* host_ptr, MemoryStrategy strategy,
+                                  const char* buffer_name) {
+    cl_int err;
+    cl_uint align_bits = 0U;
+    size_t align_bytes;
+
+    if ((env == NULL) || (buffer_name == NULL)) {
+        (void)fprintf(stderr, "Error: Invalid parameters to OpenclCreateStrategyBuffer\n");
+        return NULL;
+    }
+
+    if (strategy == MEM_STRATEGY_ALLOC_HOST_PTR) {
+        return OpenclCreateBuffer(env->context, flags | CL_MEM_ALLOC_HOST_PTR, size, NULL,
+                                  buffer_name);
+    }
+    if (strategy != MEM_STRATEGY_USE_HOST_PTR) {
+        return OpenclCreateBuffer(env->context, flags, size, NULL, buffer_name);
+    }
+
+    if (host_ptr == NULL) {
+        (void)fprintf(stderr, "Error: use_host_ptr %s buffer needs host memory\n", buffer_name);
+        return NULL;
+    }
+
+    /* Misaligned host memory is legal but silently degrades to a driver-side copy */
+    err = clGetDeviceInfo(env->device, CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(align_bits),
+                          &align_bits, NULL);
+    if ((err == CL_SUCCESS) && (align_bits >= 8U)) {
+        align_bytes = (size_t)align_bits / 8U;
+        if (((uintptr_t)host_ptr % align_bytes) != 0U) {
+            (void)fprintf(stderr,
+                          "Warning: %s host memory is not %zu-byte aligned, "
+                          "use_host_ptr may not be zero-copy\n",
+                          buffer_name, align_bytes);
+        }
+    }
+
+    return OpenclCreateBuffer(env->context, flags | CL_MEM_USE_HOST_PTR, size, host_ptr,
+                              buffer_name);
+}
+
+int OpenclUploadBuffer(const OpenCLEnv* env, cl_mem buffer, MemoryStrategy strategy,
+                       const void* src, size_t size, double* elapsed_ms) {
+    cl_int err;
+    void* mapped;
+    double start_ms;
+    cl_event event = NULL;
+
+    if ((env == NULL) || (buffer == NULL) || (src == NULL)) {
+        (void)fprintf(stderr, "Error: Invalid parameters to OpenclUploadBuffer\n");
+        return -1;
+    }
+
+    start_ms = BenchmarkNowMs();
+    if (strategy == MEM_STRATEGY_COPY) {
+        err = clEnqueueWriteBuffer(env->queue, buffer, CL_TRUE, 0U, size, src, 0U, NULL,
+                                   (TraceEnabled() != 0) ? &event : NULL);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to upload input buffer (error code: %d)\n", err);
+            return -1;
+        }
+        if (event != NULL) {
+            TraceRecordEvent(event, env->queue, "write buffer", "transfer");
+            (void)clReleaseEvent(event);
+        }
+    } else {
+        mapped = clEnqueueMapBuffer(env->queue, buffer, CL_TRUE, CL_MAP_WRITE, 0U, size, 0U, NULL,
+                                    NULL, &err);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to map input buffer (error code: %d)\n", err);
+            return -1;
+        }
+        /* USE_HOST_PTR over src maps to src itself: nothing to copy */
+        if (mapped != src) {
+            (void)memcpy(mapped, src, size);
+        }
+        err = clEnqueueUnmapMemObject(env->queue, buffer, mapped, 0U, NULL, NULL);
+        if (err == CL_SUCCESS) {
+            err = clFinish(env->queue);
+        }
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to unmap input buffer (error code: %d)\n", err);
+            return -1;
+        }
+        TraceRecordHost("map/unmap upload", "transfer", start_ms, BenchmarkNowMs());
+    }
+
+    if (elapsed_ms != NULL) {
+        *elapsed_ms = BenchmarkNowMs() - start_ms;
+    }
+    return 0;
+}
+
+int OpenclReadbackBuffer(const OpenCLEnv* env, cl_mem buffer, MemoryStrategy strategy, void* dst,
+                         size_t size, double* elapsed_ms) {
+    cl_int err;
+    void* mapped;
+    double start_ms;
+    cl_event event = NULL;
+
+    if ((env == NULL) || (buffer == NULL) || (dst == NULL)) {
+        (void)fprintf(stderr, "Error: Invalid parameters to OpenclReadbackBuffer\n");
+        return -1;
+    }
+
+    start_ms = BenchmarkNowMs();
+    if (strategy == MEM_STRATEGY_COPY) {
+        err = clEnqueueReadBuffer(env->queue, buffer, CL_TRUE, 0U, size, dst, 0U, NULL,
+                                  (TraceEnabled() != 0) ? &event : NULL);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to read output buffer (error code: %d)\n", err);
+            return -1;
+        }
+        if (event != NULL) {
+            TraceRecordEvent(event, env->queue, "read buffer", "transfer");
+            (void)clReleaseEvent(event);
+        }
+    } else {
+        mapped = clEnqueueMapBuffer(env->queue, buffer, CL_TRUE, CL_MAP_READ, 0U, size, 0U, NULL,
+                                    NULL, &err);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to map output buffer (error code: %d)\n", err);
+            return -1;
+        }
+        /* USE_HOST_PTR over dst: the map already synchronized the host copy */
+        if (mapped != dst) {
+            (void)memcpy(dst, mapped, size);
+        }
+        err = clEnqueueUnmapMemObject(env->queue, buffer, mapped, 0U, NULL, NULL);
+        if (err == CL_SUCCESS) {
+            err = clFinish(env->queue);
+        }
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to unmap output buffer (error code: %d)\n", err);
+            return -1;
+        }
+        TraceRecordHost("map/unmap readback", "transfer", start_ms, BenchmarkNowMs());
+    }
+
+    if (elapsed_ms != NULL) {
+        *elapsed_ms = BenchmarkNowMs() - start_ms;
+    }
+    return 0;
+}
+
+int OpenclFillBuffer(const OpenCLEnv* env, cl_mem buffer, unsigned char pattern, size_t size) {
+    cl_int err;
+    cl_event event = NULL;
+
+    if ((env == NULL) || (buffer == NULL)) {
+        return -1;
+    }
+
+    err = clEnqueueFillBuffer(env->queue, buffer, &pattern, sizeof(pattern), 0U, size, 0U, NULL,
+                              &event);
+    if (err == CL_SUCCESS) {
+        err = clWaitForEvents(1U, &event);
+        TraceRecordEvent(event, env->queue, "fill buffer", "transfer");
+        (void)clReleaseEvent(event);
+    }
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to fill buffer (error code: %d)\n", err);
+        return -1;
+    }
+    return 0;
+}
+
+void OpenclInitImagePitch(const OpenCLEnv* env, size_t row_bytes, size_t rows, int pitched,
+                          ImagePitch* pitch) {
+    size_t align = DEFAULT_ROW_PITCH_ALIGNMENT;
+
+    if (pitch == NULL) {
+        return;
+    }
+    if ((env != NULL) && (env->row_pitch_alignment > 0U)) {
+        align = env->row_pitch_alignment;
+    }
+    pitch->row_bytes = row_bytes;
+    pitch->rows = rows;
+    pitch->host_pitch = row_bytes;
+    pitch->device_pitch =
+        (pitched != 0) ? (((row_bytes + align - 1U) / align) * align) : row_bytes;
+}
+
+int OpenclUploadRect(const OpenCLEnv* env, cl_mem buffer, const void* src,
+                     const ImagePitch* pitch, double* elapsed_ms) {
+    const size_t origin[3] = {0U, 0U, 0U};
+    size_t region[3];
+    cl_int err;
+    double start_ms;
+    cl_event event = NULL;
+
+    if ((env == NULL) || (buffer == NULL) || (src == NULL) || (pitch == NULL)) {
+        (void)fprintf(stderr, "Error: Invalid parameters to OpenclUploadRect\n");
+        return -1;
+    }
+
+    region[0] = pitch->row_bytes;
+    region[1] = pitch->rows;
+    region[2] = 1U;
+    start_ms = BenchmarkNowMs();
+    err = clEnqueueWriteBufferRect(env->queue, buffer, CL_TRUE, origin, origin, region,
+                                   pitch->device_pitch, 0U, pitch->host_pitch, 0U, src, 0U, NULL,
+                                   (TraceEnabled() != 0) ? &event : NULL);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to upload pitched input buffer (error code: %d)\n", err);
+        return -1;
+    }
+    if (event != NULL) {
+        TraceRecordEvent(event, env->queue, "write rect", "transfer");
+        (void)clReleaseEvent(event);
+    }
+    if (elapsed_ms != NULL) {
+        *elapsed_ms = BenchmarkNowMs() - start_ms;
+    }
+    return 0;
+}
+
+int OpenclReadbackRect(const OpenCLEnv* env, cl_mem buffer, void* dst, const ImagePitch* pitch,
+                       double* elapsed_ms) {
+    const size_t origin[3] = {0U, 0U, 0U};
+    size_t region[3];
+    cl_int err;
+    double start_ms;
+    cl_event event = NULL;
+
+    if ((env == NULL) || (buffer == NULL) || (dst == NULL) || (pitch == NULL)) {
+        (void)fprintf(stderr, "Error: Invalid parameters to OpenclReadbackRect\n");
+        return -1;
+    }
+
+    region[0] = pitch->row_bytes;
+    region[1] = pitch->rows;
+    region[2] = 1U;
+    start_ms = BenchmarkNowMs();
+    err = clEnqueueReadBufferRect(env->queue, buffer, CL_TRUE, origin, origin, region,
+                                  pitch->device_pitch, 0U, pitch->host_pitch, 0U, dst, 0U, NULL,
+                                  (TraceEnabled() != 0) ? &event : NULL);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to read pitched output buffer (error code: %d)\n", err);
+        return -1;
+    }
+    if (event != NULL) {
+        TraceRecordEvent(event, env->queue, "read rect", "transfer");
+        (void)clReleaseEvent(event);
+    }
+    if (elapsed_ms != NULL) {
+        *elapsed_ms = BenchmarkNowMs() - start_ms;
+    }
+    return 0;
+}
+
 void OpenclReleaseMemObject(cl_mem mem_obj, const char* name) {
     cl_int err;
 
-    if (mem_obj != NULL) {
+    /* Image views alias the buffer's memory; drop them with it */
+    ImageViewReleaseBuffer(mem_obj);
+    if ((mem_obj != NULL) && (BufferPoolRelease(mem_obj) == 0)) {
         err = clReleaseMemObject(mem_obj);
         if (err != CL_SUCCESS) {
             (void)fprintf(stderr, "Warning: Failed to release %s (error: %d)\n",
@@ -689,8 +1238,6 @@ void OpenclReleaseKernel(cl_kernel kernel) {
  * ============================================================================ */
 
 void OpenclCleanup(OpenCLEnv* env) {
-    cl_int err;
-
     if (env == NULL) {
         return;
     }
@@ -698,6 +1245,26 @@ void OpenclCleanup(OpenCLEnv* env) {
     /* Cleanup custom CL extension context */
     ClExtensionCleanup(&env->ext_ctx);
 
+    /* Release programs shared by all kernels (kernels hold their own references) */
+    PrimitivesReleaseKernels();
+    ProgramRegistryReleaseAll();
+
+    /* Release image views and samplers, then recycled device buffers (all returned by now) */
+    ImageViewReleaseAll();
+    BufferPoolPrintStats();
+    BufferPoolReleaseAll();
+
+    OpenclReleaseDevice(env);
+    (void)printf("OpenCL cleaned up\n");
+}
+
+void OpenclReleaseDevice(OpenCLEnv* env) {
+    cl_int err;
+
+    if (env == NULL) {
+        return;
+    }
+
     if (env->queue != NULL) {
         /* MISRA-C:2023 Rule 17.7: Check return value */
         err = clReleaseCommandQueue(env->queue);
@@ -715,6 +1282,4 @@ void OpenclCleanup(OpenCLEnv* env) {
         }
         env->context = NULL;
     }
-
-    (void)printf("OpenCL cleaned up\n");
 }
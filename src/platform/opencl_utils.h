@@ -26,43 +26,164 @@
 /* Include op_interface for Algorithm and OpParams */
 #include "cl_extension_api.h"
 #include "kernel_args.h"
+#include "kernel_report.h"
 #include "op_interface.h"
 
+/** Maximum device name length (including terminator) */
+#define MAX_DEVICE_NAME_SIZE 128
+
+/** Maximum driver/platform version string length (including terminator) */
+#define MAX_VERSION_STRING_SIZE 128
+
 /**
  * @brief OpenCL environment containing all required resources
  *
  * Encapsulates all OpenCL objects needed for kernel execution:
  * platform, device, context, and command queue.
  */
-typedef struct {
-    cl_platform_id platform;    /**< OpenCL platform (e.g., Apple, NVIDIA) */
-    cl_device_id device;        /**< OpenCL device (GPU/CPU) */
-    cl_context context;         /**< OpenCL context for device */
-    cl_command_queue queue;     /**< Command queue for kernel execution */
-    CLExtensionContext ext_ctx; /**< Custom CL extension context */
+typedef struct OpenCLEnv {
+    cl_platform_id platform;                        /**< OpenCL platform (e.g., Apple, NVIDIA) */
+    cl_device_id device;                            /**< OpenCL device (GPU/CPU) */
+    cl_context context;                             /**< OpenCL context for device */
+    cl_command_queue queue;                         /**< Command queue for kernel execution */
+    CLExtensionContext ext_ctx;                     /**< Custom CL extension context */
+    char device_name[MAX_DEVICE_NAME_SIZE];         /**< CL_DEVICE_NAME (empty if query failed) */
+    char driver_version[MAX_VERSION_STRING_SIZE];   /**< CL_DRIVER_VERSION (empty if failed) */
+    char platform_version[MAX_VERSION_STRING_SIZE]; /**< CL_PLATFORM_VERSION (empty if failed) */
+    cl_uint compute_units;                          /**< CL_DEVICE_MAX_COMPUTE_UNITS */
+    size_t max_work_group_size;                     /**< CL_DEVICE_MAX_WORK_GROUP_SIZE */
+    cl_ulong local_mem_size;                        /**< CL_DEVICE_LOCAL_MEM_SIZE in bytes */
+    cl_uint max_clock_mhz;                          /**< CL_DEVICE_MAX_CLOCK_FREQUENCY */
+    double copy_bandwidth_gbps;                     /**< Device copy GB/s (0 until measured) */
+    size_t row_pitch_alignment;                     /**< Pitched row alignment (bytes; base
+                                                         address and 8-bit image pitch) */
+    int fp16_supported;                             /**< Non-zero if the device reports
+                                                         cl_khr_fp16 (half arithmetic) */
+    int image_views_supported;                      /**< Non-zero if the device is OpenCL 2.0+
+                                                         or reports cl_khr_image2d_from_buffer */
 } OpenCLEnv;
 
+/** Row pitch alignment used when the device does not report one */
+#define DEFAULT_ROW_PITCH_ALIGNMENT 128U
+
+/**
+ * @brief Row layout of a 2D image in host memory and in its device buffer
+ *
+ * Host images are packed (host_pitch == row_bytes). A pitched device buffer
+ * pads every row to the device alignment, so each row starts on an aligned
+ * address; rows are then moved with clEnqueueWriteBufferRect() /
+ * clEnqueueReadBufferRect().
+ */
+typedef struct {
+    size_t row_bytes;    /**< Pixel bytes per row (width * channels * element size) */
+    size_t rows;         /**< Number of rows */
+    size_t host_pitch;   /**< Host row pitch in bytes */
+    size_t device_pitch; /**< Device buffer row pitch in bytes (>= row_bytes) */
+} ImagePitch;
+
 /**
  * @brief Initialize OpenCL environment
  *
  * Initializes the OpenCL platform, device, context, and command queue.
  * Automatically selects GPU if available, otherwise falls back to CPU.
  * Creates a profiling-enabled command queue for performance measurement.
+ * Also records optional device capabilities (cl_khr_fp16).
  *
  * @param[out] env OpenCL environment structure to initialize
  * @return 0 on success, -1 on error
  */
 int OpenclInit(OpenCLEnv* env);
 
+/**
+ * @brief Initialize an OpenCL environment for a given platform and device
+ *
+ * Same setup as OpenclInit() (device info, context, profiling queue) for a
+ * device chosen by the caller, e.g. every device of a multi-device run
+ * (multi_device.h). Each device gets its own context, so programs, buffers
+ * and binary cache entries are per device.
+ *
+ * @param[out] env OpenCL environment structure to initialize
+ * @param[in] platform Platform of the device
+ * @param[in] device Device to use
+ * @return 0 on success, -1 on error
+ */
+int OpenclInitDevice(OpenCLEnv* env, cl_platform_id platform, cl_device_id device);
+
 /* Forward declaration for KernelConfig - defined in utils/config.h */
 struct KernelConfig;
 
 /**
- * @brief Build OpenCL kernel from source file with caching
+ * @brief Resolve a kernel's requested precision against the device
+ *
+ * An fp16 kernel on a device without cl_khr_fp16 is marked
+ * precision_fallback and built without -DUSE_FP16, so it runs in fp32
+ * instead of failing to compile. Call once per kernel after OpenclInit().
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in,out] kernel_cfg Kernel configuration
+ */
+void OpenclResolvePrecision(const OpenCLEnv* env, struct KernelConfig* kernel_cfg);
+
+/**
+ * @brief Check that the device can run a kernel's image view arguments
+ *
+ * "i_image" / "o_image" args are 2D images created over buffers, which
+ * needs an OpenCL 2.0 device or cl_khr_image2d_from_buffer. Called by
+ * OpenclBuildKernel(); prints the reason when the kernel cannot run.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] kernel_cfg Kernel configuration
+ * @return 0 if the kernel has no image args or the device supports them, -1 otherwise
+ */
+int OpenclCheckImageArgs(const OpenCLEnv* env, const struct KernelConfig* kernel_cfg);
+
+/**
+ * @brief Compose the program build options for a kernel configuration
+ *
+ * Build options are constructed as:
+ * "<user_options> [-DSPEC_<NAME>=<value> ...] [-DUSE_FP16=1] -DHOST_TYPE=N"
+ * where N is 0 for standard, 1 for cl_extension, and the -DSPEC_ macros are
+ * the kernel's specialized scalars. -DUSE_FP16=1 is added for fp16 kernels
+ * unless they fell back to fp32. The options are part of the binary cache
+ * key, so each specialized value gets its own cached binary.
+ *
+ * @param[in] kernel_cfg Kernel configuration
+ * @param[out] build_options Output buffer for the option string
+ * @param[in] options_size Size of output buffer
+ * @return 0 on success, -1 on error (including truncation)
+ */
+int OpenclComposeBuildOptions(const struct KernelConfig* kernel_cfg, char* build_options,
+                              size_t options_size);
+
+/**
+ * @brief Read kernel source with embedded headers and compute its cache name
+ *
+ * The cache name is "<kernel file base>_<build key>", where the build key
+ * hashes device, driver, platform version, build options and the combined
+ * source. This is the name OpenclBuildProgram() stores binaries under, so
+ * offline tools can populate the same cache entries.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] kernel_file Path to kernel source file (.cl)
+ * @param[in] build_options Complete build options (see OpenclComposeBuildOptions)
+ * @param[in] host_type Host type for platform header selection
+ * @param[out] source Combined source; points to a static buffer that is
+ *                    overwritten by the next call
+ * @param[out] source_length Length of combined source in bytes
+ * @param[out] keyed_name Cache name for the binary
+ * @param[in] keyed_name_size Size of keyed_name buffer
+ * @return 0 on success, -1 on error
+ */
+int OpenclPrepareProgramSource(const OpenCLEnv* env, const char* kernel_file,
+                               const char* build_options, HostType host_type,
+                               const char** source, size_t* source_length, char* keyed_name,
+                               size_t keyed_name_size);
+
+/**
+ * @brief Build an OpenCL program from source file with caching
  *
- * Loads kernel source, compiles it, and creates a kernel object.
  * Uses cache_manager to avoid recompilation:
- * - If cached binary exists, loads from cache
+ * - If a cached binary for the build key exists, loads from cache
  * - Otherwise, compiles from source and saves to cache
  *
  * Headers are embedded based on #include directives in the kernel:
@@ -70,8 +191,26 @@ struct KernelConfig;
  * - Embeds matching headers from include/cl/
  * - Comments out the #include lines before compilation
  *
- * Build options are constructed as: "<user_options> -DHOST_TYPE=N"
- * where N is 0 for standard, 1 for cl_extension.
+ * Most callers should go through the program registry (program_registry.h)
+ * so that a program shared by several kernels is only built once.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] algorithm_id Algorithm identifier for cache organization
+ * @param[in] kernel_file Path to kernel source file (.cl)
+ * @param[in] build_options Complete build options (see OpenclComposeBuildOptions)
+ * @param[in] host_type Host type for platform header selection
+ * @return OpenCL program (caller owns the reference), or NULL on error
+ */
+cl_program OpenclBuildProgram(OpenCLEnv* env, const char* algorithm_id, const char* kernel_file,
+                              const char* build_options, HostType host_type);
+
+/**
+ * @brief Build OpenCL kernel from source file with caching
+ *
+ * Obtains the program for (kernel_file, build options) from the program
+ * registry, which builds it at most once per process, and creates the
+ * kernel object by name. The program stays owned by the registry until
+ * OpenclCleanup().
  *
  * Kernel parameters extracted from KernelConfig:
  * - kernel_file: Path to kernel source file (.cl)
@@ -79,6 +218,8 @@ struct KernelConfig;
  * - kernel_option: User-specified build options
  * - host_type: Host type for platform selection
  *
+ * Prints the kernel's resource usage (see kernel_report.h).
+ *
  * @param[in] env Initialized OpenCL environment
  * @param[in] algorithm_id Algorithm identifier for cache organization
  * @param[in] kernel_cfg Kernel configuration containing file, function, options, and host type
@@ -104,6 +245,9 @@ cl_kernel OpenclBuildKernel(OpenCLEnv* env, const char* algorithm_id,
  * - work_dim: Number of work dimensions (1, 2, or 3)
  * - host_type: Host API type (standard or cl_extension)
  *
+ * When report is non-NULL it receives the kernel's occupancy and achieved
+ * bandwidth for this run (see kernel_report.h), which are also printed.
+ *
  * @param[in] env Initialized OpenCL environment
  * @param[in] kernel Compiled kernel object
  * @param[in] algo Algorithm interface (unused, kept for API compatibility)
@@ -112,17 +256,107 @@ cl_kernel OpenclBuildKernel(OpenCLEnv* env, const char* algorithm_id,
  * @param[in] params Operation parameters (dimensions, algo-specific data)
  * @param[in] kernel_cfg Kernel configuration with work sizes and argument descriptors (required)
  * @param[out] gpu_time_ms Execution time in milliseconds
+ * @param[out] report Hardware report of the run (may be NULL)
  * @return 0 on success, -1 on error
  */
 int OpenclRunKernel(OpenCLEnv* env, cl_kernel kernel, const Algorithm* algo, cl_mem input_buf,
                     cl_mem output_buf, const OpParams* params,
-                    const struct KernelConfig* kernel_cfg, double* gpu_time_ms);
+                    const struct KernelConfig* kernel_cfg, double* gpu_time_ms,
+                    KernelReport* report);
+
+/**
+ * @brief Enqueue an already configured kernel and measure its execution time
+ *
+ * Same dispatch path as OpenclRunKernel (standard or CL extension API based on
+ * host_type) but assumes kernel arguments are already set. Used to re-dispatch
+ * a kernel repeatedly (e.g., benchmark iterations) without rebinding arguments.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] kernel Kernel object with arguments set
+ * @param[in] kernel_cfg Kernel configuration with work sizes and host type
+ * @param[out] gpu_time_ms Execution time in milliseconds
+ * @return 0 on success, -1 on error
+ */
+int OpenclDispatchKernel(OpenCLEnv* env, cl_kernel kernel, const struct KernelConfig* kernel_cfg,
+                         double* gpu_time_ms);
+
+/**
+ * @brief Enqueue an already configured kernel with an explicit local work size
+ *
+ * Same as OpenclDispatchKernel but overrides kernel_cfg->local_work_size
+ * (used by the local work size autotuner to time candidate shapes).
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] kernel Kernel object with arguments set
+ * @param[in] kernel_cfg Kernel configuration with global size and host type
+ * @param[in] local_work_size Local work size (work_dim entries; [0] == 0 lets the driver choose)
+ * @param[out] gpu_time_ms Execution time in milliseconds
+ * @return 0 on success, -1 on error
+ */
+int OpenclDispatchKernelWithLocalSize(OpenCLEnv* env, cl_kernel kernel,
+                                      const struct KernelConfig* kernel_cfg,
+                                      const size_t* local_work_size, double* gpu_time_ms);
+
+/**
+ * @brief Enqueue an already configured kernel without waiting for it
+ *
+ * Uses the standard or CL extension enqueue based on host_type. Does not
+ * flush or finish the queue, so several kernels can be chained on device
+ * through their events (e.g., pipeline stages).
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] kernel Kernel object with arguments set
+ * @param[in] kernel_cfg Kernel configuration with work sizes and host type
+ * @param[in] local_work_size Local work size (work_dim entries; [0] == 0 lets the driver choose)
+ * @param[in] num_wait_events Number of events in wait_list
+ * @param[in] wait_list Events that must complete first (NULL if num_wait_events is 0)
+ * @param[out] event Completion event (caller releases)
+ * @return 0 on success, -1 on error
+ */
+int OpenclEnqueueKernel(OpenCLEnv* env, cl_kernel kernel, const struct KernelConfig* kernel_cfg,
+                        const size_t* local_work_size, cl_uint num_wait_events,
+                        const cl_event* wait_list, cl_event* event);
+
+/**
+ * @brief Enqueue an already configured kernel on a specific command queue
+ *
+ * Same as OpenclEnqueueKernel but on a caller-provided queue of env's
+ * context (e.g., the compute queue of the streaming mode).
+ *
+ * @param[in] env Initialized OpenCL environment (context and extension state)
+ * @param[in] queue Command queue to enqueue on
+ * @param[in] kernel Kernel object with arguments set
+ * @param[in] kernel_cfg Kernel configuration with work sizes and host type
+ * @param[in] local_work_size Local work size (work_dim entries; [0] == 0 lets the driver choose)
+ * @param[in] num_wait_events Number of events in wait_list
+ * @param[in] wait_list Events that must complete first (NULL if num_wait_events is 0)
+ * @param[out] event Completion event (caller releases)
+ * @return 0 on success, -1 on error
+ */
+int OpenclEnqueueKernelOnQueue(OpenCLEnv* env, cl_command_queue queue, cl_kernel kernel,
+                               const struct KernelConfig* kernel_cfg,
+                               const size_t* local_work_size, cl_uint num_wait_events,
+                               const cl_event* wait_list, cl_event* event);
+
+/**
+ * @brief Get duration of a completed command from its profiling event
+ *
+ * Requires the queue to be created with CL_QUEUE_PROFILING_ENABLE.
+ *
+ * @param[in] event Completed event
+ * @param[out] duration_ms COMMAND_END - COMMAND_START in milliseconds
+ * @return 0 on success, -1 on error
+ */
+int OpenclGetEventDurationMs(cl_event event, double* duration_ms);
 
 /**
  * @brief Create OpenCL buffer with error checking
  *
  * Wraps clCreateBuffer with automatic error checking and logging.
  * Provides clear error messages including the buffer name for debugging.
+ * Buffers without host memory come from the buffer pool (buffer_pool.h):
+ * they may be larger than @p size and hold data from an earlier use.
+ * Release them with OpenclReleaseMemObject().
  *
  * @param[in] context OpenCL context
  * @param[in] flags Memory flags (CL_MEM_READ_ONLY, CL_MEM_WRITE_ONLY, etc.)
@@ -134,11 +368,132 @@ int OpenclRunKernel(OpenCLEnv* env, cl_kernel kernel, const Algorithm* algo, cl_
 cl_mem OpenclCreateBuffer(cl_context context, cl_mem_flags flags, size_t size, void* host_ptr,
                           const char* buffer_name);
 
+/**
+ * @brief Get the config name of a memory strategy
+ *
+ * @param[in] strategy Memory strategy
+ * @return "copy", "use_host_ptr" or "alloc_host_ptr"
+ */
+const char* OpenclMemoryStrategyName(MemoryStrategy strategy);
+
+/**
+ * @brief Create an image buffer according to a memory strategy
+ *
+ * - MEM_STRATEGY_COPY: plain device buffer (host_ptr is ignored)
+ * - MEM_STRATEGY_USE_HOST_PTR: CL_MEM_USE_HOST_PTR over host_ptr. A warning
+ *   is printed if host_ptr is not aligned to CL_DEVICE_MEM_BASE_ADDR_ALIGN,
+ *   since drivers then fall back to a hidden copy.
+ * - MEM_STRATEGY_ALLOC_HOST_PTR: CL_MEM_ALLOC_HOST_PTR (host_ptr is ignored)
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] flags Access flags (CL_MEM_READ_ONLY, CL_MEM_WRITE_ONLY, ...)
+ * @param[in] size Buffer size in bytes
+ * @param[in] host_ptr Host memory backing the buffer (USE_HOST_PTR only)
+ * @param[in] strategy Memory strategy
+ * @param[in] buffer_name Descriptive name for error messages
+ * @return OpenCL buffer object, or NULL on error
+ */
+cl_mem OpenclCreateStrategyBuffer(const OpenCLEnv* env, cl_mem_flags flags, size_t size,
+                                  void* host_ptr, MemoryStrategy strategy,
+                                  const char* buffer_name);
+
+/**
+ * @brief Make host data visible to the device (blocking)
+ *
+ * COPY uses clEnqueueWriteBuffer. The zero-copy strategies map the buffer
+ * for writing, copy only if the mapped pointer differs from src (always
+ * the case for ALLOC_HOST_PTR, never for an aligned USE_HOST_PTR buffer
+ * over src) and unmap. The elapsed time is host wall-clock so that all
+ * strategies are measured the same way.
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] buffer Buffer created by OpenclCreateStrategyBuffer
+ * @param[in] strategy Strategy the buffer was created with
+ * @param[in] src Host source data
+ * @param[in] size Number of bytes
+ * @param[out] elapsed_ms Transfer time in milliseconds (can be NULL)
+ * @return 0 on success, -1 on error
+ */
+int OpenclUploadBuffer(const OpenCLEnv* env, cl_mem buffer, MemoryStrategy strategy,
+                       const void* src, size_t size, double* elapsed_ms);
+
+/**
+ * @brief Make device results visible in host memory (blocking)
+ *
+ * Counterpart of OpenclUploadBuffer: clEnqueueReadBuffer for COPY,
+ * map for reading / copy if needed / unmap for the zero-copy strategies.
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] buffer Buffer created by OpenclCreateStrategyBuffer
+ * @param[in] strategy Strategy the buffer was created with
+ * @param[out] dst Host destination
+ * @param[in] size Number of bytes
+ * @param[out] elapsed_ms Transfer time in milliseconds (can be NULL)
+ * @return 0 on success, -1 on error
+ */
+int OpenclReadbackBuffer(const OpenCLEnv* env, cl_mem buffer, MemoryStrategy strategy, void* dst,
+                         size_t size, double* elapsed_ms);
+
+/**
+ * @brief Fill a buffer with a byte pattern (blocking)
+ *
+ * Used to poison recycled output buffers, so a kernel that writes nothing
+ * cannot pass verification with an earlier run's result.
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] buffer Buffer to fill
+ * @param[in] pattern Byte value
+ * @param[in] size Number of bytes from offset 0
+ * @return 0 on success, -1 on error
+ */
+int OpenclFillBuffer(const OpenCLEnv* env, cl_mem buffer, unsigned char pattern, size_t size);
+
+/**
+ * @brief Describe the host and device row layout of an image
+ *
+ * @param[in] env OpenCL environment (row_pitch_alignment)
+ * @param[in] row_bytes Pixel bytes per row
+ * @param[in] rows Number of rows
+ * @param[in] pitched Non-zero to pad device rows to the alignment, 0 for packed rows
+ * @param[out] pitch Layout
+ */
+void OpenclInitImagePitch(const OpenCLEnv* env, size_t row_bytes, size_t rows, int pitched,
+                          ImagePitch* pitch);
+
+/**
+ * @brief Upload a packed host image into a pitched buffer (blocking)
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] buffer Buffer of at least device_pitch * rows bytes
+ * @param[in] src Host image (host_pitch rows)
+ * @param[in] pitch Layout from OpenclInitImagePitch()
+ * @param[out] elapsed_ms Transfer time in milliseconds (can be NULL)
+ * @return 0 on success, -1 on error
+ */
+int OpenclUploadRect(const OpenCLEnv* env, cl_mem buffer, const void* src,
+                     const ImagePitch* pitch, double* elapsed_ms);
+
+/**
+ * @brief Read a pitched buffer back into a packed host image (blocking)
+ *
+ * Row padding is not copied.
+ *
+ * @param[in] env OpenCL environment
+ * @param[in] buffer Buffer of at least device_pitch * rows bytes
+ * @param[out] dst Host image (host_pitch rows)
+ * @param[in] pitch Layout from OpenclInitImagePitch()
+ * @param[out] elapsed_ms Transfer time in milliseconds (can be NULL)
+ * @return 0 on success, -1 on error
+ */
+int OpenclReadbackRect(const OpenCLEnv* env, cl_mem buffer, void* dst, const ImagePitch* pitch,
+                       double* elapsed_ms);
+
 /**
  * @brief Release OpenCL memory object with error checking
  *
  * Safely releases an OpenCL memory object with error checking.
  * Handles NULL pointers gracefully and logs warnings on failure.
+ * Pooled buffers return to the buffer pool.
  *
  * @param[in] mem_obj OpenCL memory object to release (can be NULL)
  * @param[in] name Descriptive name for error messages
@@ -164,3 +519,14 @@ void OpenclReleaseKernel(cl_kernel kernel);
  * @param[in,out] env OpenCL environment to clean up
  */
 void OpenclCleanup(OpenCLEnv* env);
+
+/**
+ * @brief Release the command queue and context of one environment
+ *
+ * Unlike OpenclCleanup(), leaves the process-wide program registry, image
+ * views and buffer pool alone; used for the extra devices of a multi-device
+ * run, whose programs and buffers are released by the primary's cleanup.
+ *
+ * @param[in,out] env OpenCL environment (safe on a released one)
+ */
+void OpenclReleaseDevice(OpenCLEnv* env);
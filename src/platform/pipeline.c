@@ -0,0 +1,494 @@
+/**
+ * @file pipeline.c
+ * @brief Multi-kernel pipeline engine implementation
+ */
+
+#include "pipeline.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "fusion.h"
+#include "utils/safe_ops.h"
+
+/** Buffer slots: pipeline input, pipeline output, custom buffers, then pyramid planes */
+#define SLOT_INPUT 0
+#define SLOT_OUTPUT 1
+#define SLOT_CUSTOM_BASE 2
+#define SLOT_PYRAMID_BASE (SLOT_CUSTOM_BASE + MAX_CUSTOM_BUFFERS)
+#define SLOTS_PER_PYRAMID (MAX_PYRAMID_LEVELS + 1)
+#define MAX_PIPELINE_SLOTS (SLOT_PYRAMID_BASE + (MAX_PIPELINE_PYRAMIDS * SLOTS_PER_PYRAMID))
+
+/** Launch level of full-size launches */
+#define LEVEL_FULL (-1)
+
+/**
+ * @brief State threaded through the launches while a pipeline is built
+ */
+typedef struct {
+    OpenCLEnv* env;                               /**< OpenCL environment */
+    const char* algorithm_id;                     /**< Kernel cache directory */
+    const OpParams* params;                       /**< Full-size operation parameters */
+    cl_mem slot_mem[MAX_PIPELINE_SLOTS];          /**< Buffer behind every slot */
+    int slot_writable[MAX_PIPELINE_SLOTS];        /**< Buffer args may write the slot */
+    int last_writer[MAX_PIPELINE_SLOTS];          /**< Last launch writing the slot (-1: none) */
+    unsigned int readers[MAX_PIPELINE_SLOTS];     /**< Launches reading it since that write */
+} PipelineBuilder;
+
+/* Buffer name bound to a kernel argument: explicit binding, else the default */
+static const char* BoundBufferName(const PipelineStageConfig* stage,
+                                   const KernelArgDescriptor* arg) {
+    int i;
+
+    if (stage != NULL) {
+        for (i = 0; i < stage->bind_count; i++) {
+            if (strcmp(stage->bind_arg[i], arg->source_name) == 0) {
+                return stage->bind_buffer[i];
+            }
+        }
+    }
+    if ((arg->arg_type == KERNEL_ARG_TYPE_BUFFER_INPUT) ||
+        (arg->arg_type == KERNEL_ARG_TYPE_IMAGE_INPUT)) {
+        return PIPELINE_BUFFER_INPUT;
+    }
+    if ((arg->arg_type == KERNEL_ARG_TYPE_BUFFER_OUTPUT) ||
+        (arg->arg_type == KERNEL_ARG_TYPE_IMAGE_OUTPUT)) {
+        return PIPELINE_BUFFER_OUTPUT;
+    }
+    return arg->source_name;
+}
+
+/* Map buffer name (or numeric custom index) to slot; -1 if unknown */
+static int ResolveSlot(const char* name, const CustomBuffers* custom_buffers) {
+    long index;
+    int j;
+
+    if (strcmp(name, PIPELINE_BUFFER_INPUT) == 0) {
+        return SLOT_INPUT;
+    }
+    if (strcmp(name, PIPELINE_BUFFER_OUTPUT) == 0) {
+        return SLOT_OUTPUT;
+    }
+    if (custom_buffers == NULL) {
+        return -1;
+    }
+    if ((name[0] >= '0') && (name[0] <= '9')) {
+        if (!SafeStrtol(name, &index) || (index < 0) || (index >= custom_buffers->count)) {
+            return -1;
+        }
+        return SLOT_CUSTOM_BASE + (int)index;
+    }
+    for (j = 0; j < custom_buffers->count; j++) {
+        if (strcmp(custom_buffers->buffers[j].name, name) == 0) {
+            return SLOT_CUSTOM_BASE + j;
+        }
+    }
+    return -1;
+}
+
+/* Pyramid of a buffer name, -1 if it has none */
+static int FindPyramid(const PipelineInstance* inst, const char* name, size_t name_len) {
+    int p;
+
+    for (p = 0; p < inst->pyramid_count; p++) {
+        if ((strlen(inst->pyramids[p].name) == name_len) &&
+            (strncmp(inst->pyramids[p].name, name, name_len) == 0)) {
+            return p;
+        }
+    }
+    return -1;
+}
+
+/* Slot of a pyramid plane; level 0 is the base buffer's own slot */
+static int PyramidSlot(const PipelineInstance* inst, int pyramid, int level,
+                       const CustomBuffers* custom_buffers) {
+    if (level == 0) {
+        return ResolveSlot(inst->pyramids[pyramid].name, custom_buffers);
+    }
+    return SLOT_PYRAMID_BASE + (pyramid * SLOTS_PER_PYRAMID) + level;
+}
+
+/*
+ * Slot of a bound buffer name at a launch level: at a pyramid level, pyramid
+ * buffers resolve to their plane and "<name>@coarser" to the next plane.
+ */
+static int ResolveLaunchSlot(const PipelineInstance* inst, const char* name, int level,
+                             const CustomBuffers* custom_buffers) {
+    size_t len = strlen(name);
+    size_t suffix_len = strlen(PIPELINE_COARSER_SUFFIX);
+    int p;
+
+    if (level == LEVEL_FULL) {
+        return ResolveSlot(name, custom_buffers);
+    }
+    if ((len > suffix_len) && (strcmp(&name[len - suffix_len], PIPELINE_COARSER_SUFFIX) == 0)) {
+        p = FindPyramid(inst, name, len - suffix_len);
+        return ((p >= 0) && (level < inst->pyramids[p].levels) &&
+                (inst->pyramids[p].zero_level != 0))
+                   ? PyramidSlot(inst, p, level + 1, custom_buffers)
+                   : -1;
+    }
+    p = FindPyramid(inst, name, len);
+    return (p >= 0) ? PyramidSlot(inst, p, level, custom_buffers)
+                    : ResolveSlot(name, custom_buffers);
+}
+
+/*
+ * Build one launch: kernel, buffer bindings, dependencies and arguments.
+ * A pyramid build (build_pyramid >= 0) reads plane level-1 of that pyramid
+ * through its input args and writes plane level through its output args.
+ */
+static int AddLaunch(PipelineBuilder* b, PipelineInstance* inst,
+                     const PipelineStageConfig* stage, const KernelConfig* cfg, int level,
+                     int build_pyramid) {
+    cl_mem bound[MAX_KERNEL_ARGS];
+    int slot_state[MAX_PIPELINE_SLOTS]; /* per launch: 0 unused, 1 read, 2 write */
+    const CustomBuffers* custom_buffers = b->params->custom_buffers;
+    const ImagePyramid* pyr = NULL;
+    OpParams launch_params;
+    int n = inst->launch_count;
+    int i;
+
+    if (n >= MAX_PIPELINE_LAUNCHES) {
+        (void)fprintf(stderr, "Error: Pipeline needs more than %d launches\n",
+                      MAX_PIPELINE_LAUNCHES);
+        return -1;
+    }
+
+    /* Level launches run a copy of the config with the level's global size */
+    launch_params = *b->params;
+    if (level != LEVEL_FULL) {
+        pyr = &inst->pyramids[(build_pyramid >= 0) ? build_pyramid : 0];
+        PyramidLevelParams(pyr, (build_pyramid >= 0) ? (level - 1) : level, level,
+                           &launch_params);
+        PyramidLevelWorkSize(cfg, pyr->width[level], pyr->height[level],
+                             &inst->level_cfgs[n]);
+        cfg = &inst->level_cfgs[n];
+    }
+
+    inst->launch_cfgs[n] = cfg;
+    inst->launch_level[n] = level;
+    inst->kernels[n] = OpenclBuildKernel(b->env, b->algorithm_id, cfg);
+    if (inst->kernels[n] == NULL) {
+        return -1;
+    }
+    inst->launch_count = n + 1;
+
+    /* Resolve buffer bindings and record how this launch uses each slot */
+    (void)memset(bound, 0, sizeof(bound));
+    (void)memset(slot_state, 0, sizeof(slot_state));
+    for (i = 0; i < cfg->kernel_arg_count; i++) {
+        const KernelArgDescriptor* arg = &cfg->kernel_args[i];
+        const char* name = NULL;
+        int is_output;
+        int slot;
+        int writes;
+
+        if ((arg->arg_type != KERNEL_ARG_TYPE_BUFFER_INPUT) &&
+            (arg->arg_type != KERNEL_ARG_TYPE_BUFFER_OUTPUT) &&
+            (arg->arg_type != KERNEL_ARG_TYPE_BUFFER_CUSTOM) &&
+            (arg->arg_type != KERNEL_ARG_TYPE_IMAGE_INPUT) &&
+            (arg->arg_type != KERNEL_ARG_TYPE_IMAGE_OUTPUT)) {
+            continue;
+        }
+        is_output = ((arg->arg_type == KERNEL_ARG_TYPE_BUFFER_OUTPUT) ||
+                     (arg->arg_type == KERNEL_ARG_TYPE_IMAGE_OUTPUT))
+                        ? 1
+                        : 0;
+
+        if ((build_pyramid >= 0) && ((is_output != 0) ||
+                                     (arg->arg_type == KERNEL_ARG_TYPE_BUFFER_INPUT) ||
+                                     (arg->arg_type == KERNEL_ARG_TYPE_IMAGE_INPUT))) {
+            slot = PyramidSlot(inst, build_pyramid, (is_output != 0) ? level : (level - 1),
+                               custom_buffers);
+        } else {
+            name = BoundBufferName(stage, arg);
+            slot = ResolveLaunchSlot(inst, name, level, custom_buffers);
+        }
+        if ((slot < 0) || (b->slot_mem[slot] == NULL)) {
+            (void)fprintf(stderr, "Error: Stage %s arg '%s' bound to unknown buffer '%s'\n",
+                          cfg->variant_id, arg->source_name, (name != NULL) ? name : "?");
+            return -1;
+        }
+        bound[i] = b->slot_mem[slot];
+
+        /* Input is never written; outputs and writable buffers count as writes */
+        if (slot == SLOT_INPUT) {
+            writes = 0;
+        } else if ((slot == SLOT_OUTPUT) || (is_output != 0)) {
+            writes = 1;
+        } else {
+            writes = ((arg->arg_type != KERNEL_ARG_TYPE_BUFFER_INPUT) &&
+                      (arg->arg_type != KERNEL_ARG_TYPE_IMAGE_INPUT))
+                         ? b->slot_writable[slot]
+                         : 0;
+        }
+        if (writes != 0) {
+            slot_state[slot] = 2;
+        } else if (slot_state[slot] == 0) {
+            slot_state[slot] = 1;
+        }
+    }
+
+    /* RAW/WAW: wait on last writer; WAR: writers also wait on readers since */
+    for (i = 0; i < MAX_PIPELINE_SLOTS; i++) {
+        if (slot_state[i] == 0) {
+            continue;
+        }
+        if (b->last_writer[i] >= 0) {
+            inst->dep_mask[n] |= 1U << (unsigned int)b->last_writer[i];
+        }
+        if (slot_state[i] == 2) {
+            inst->dep_mask[n] |= b->readers[i];
+            b->last_writer[i] = n;
+            b->readers[i] = 0U;
+        } else {
+            b->readers[i] |= 1U << (unsigned int)n;
+        }
+    }
+
+    launch_params.host_type = cfg->host_type;
+    launch_params.kernel_variant = cfg->kernel_variant;
+    if (OpenclSetKernelArgsWithBuffers(inst->kernels[n], b->slot_mem[SLOT_INPUT],
+                                       b->slot_mem[SLOT_OUTPUT], &launch_params, cfg,
+                                       bound) != 0) {
+        (void)fprintf(stderr, "Failed to set arguments for stage %s\n", cfg->variant_id);
+        return -1;
+    }
+    return 0;
+}
+
+/* Allocate pyramid planes and map them to slots */
+static int CreatePyramids(PipelineBuilder* b, const PipelineConfig* pipeline,
+                          PipelineInstance* inst) {
+    const CustomBuffers* custom_buffers = b->params->custom_buffers;
+    int count = pipeline->pyramid_image_count + pipeline->level_buffer_count;
+    int p;
+    int l;
+
+    for (p = 0; p < count; p++) {
+        int is_image = (p < pipeline->pyramid_image_count) ? 1 : 0;
+        const char* name = (is_image != 0)
+                               ? pipeline->pyramid_images[p]
+                               : pipeline->level_buffers[p - pipeline->pyramid_image_count];
+        int base_slot = ResolveSlot(name, custom_buffers);
+
+        if ((base_slot < 0) || (b->slot_mem[base_slot] == NULL)) {
+            (void)fprintf(stderr, "Error: Pyramid buffer '%s' not found\n", name);
+            return -1;
+        }
+        /* Level buffers get a zero plane past the coarsest level ("@coarser" there) */
+        if (PyramidCreate(b->env, name, b->slot_mem[base_slot], b->params->src_width,
+                          b->params->src_height, pipeline->pyramid_levels,
+                          (is_image != 0) ? 0 : 1, &inst->pyramids[p]) != 0) {
+            return -1;
+        }
+        inst->pyramid_count = p + 1;
+        for (l = 1; l <= MAX_PYRAMID_LEVELS; l++) {
+            int slot = PyramidSlot(inst, p, l, custom_buffers);
+            b->slot_mem[slot] = inst->pyramids[p].planes[l];
+            b->slot_writable[slot] = 1;
+        }
+    }
+    return 0;
+}
+
+int PipelineCreate(OpenCLEnv* env, const char* algorithm_id, const PipelineConfig* pipeline,
+                   const Config* config, cl_mem input_buf, cl_mem output_buf,
+                   const OpParams* params, PipelineInstance* inst) {
+    PipelineBuilder builder;
+    const CustomBuffers* custom_buffers;
+    const KernelConfig* downsample = NULL;
+    int s;
+    int i;
+    int p;
+    int level;
+
+    if ((env == NULL) || (algorithm_id == NULL) || (pipeline == NULL) || (config == NULL) ||
+        (params == NULL) || (inst == NULL)) {
+        return -1;
+    }
+
+    (void)memset(inst, 0, sizeof(*inst));
+    (void)memset(&builder, 0, sizeof(builder));
+    builder.env = env;
+    builder.algorithm_id = algorithm_id;
+    builder.params = params;
+    custom_buffers = params->custom_buffers;
+    for (i = 0; i < MAX_PIPELINE_SLOTS; i++) {
+        builder.last_writer[i] = -1;
+    }
+    builder.slot_mem[SLOT_INPUT] = input_buf;
+    builder.slot_mem[SLOT_OUTPUT] = output_buf;
+    builder.slot_writable[SLOT_OUTPUT] = 1;
+    if (custom_buffers != NULL) {
+        for (i = 0; i < custom_buffers->count; i++) {
+            builder.slot_mem[SLOT_CUSTOM_BASE + i] = custom_buffers->buffers[i].buffer;
+            builder.slot_writable[SLOT_CUSTOM_BASE + i] =
+                (custom_buffers->buffers[i].type != BUFFER_TYPE_READ_ONLY) ? 1 : 0;
+        }
+    }
+
+    /* Pyramid: planes, then one downsample launch per image and level */
+    if (pipeline->pyramid_levels > 0) {
+        downsample = FindKernelConfig(config, pipeline->pyramid_kernel_id);
+        if ((downsample == NULL) || (CreatePyramids(&builder, pipeline, inst) != 0)) {
+            (void)fprintf(stderr, "Error: Failed to create pyramid of pipeline '%s'\n",
+                          pipeline->pipeline_id);
+            PipelineRelease(inst);
+            return -1;
+        }
+        (void)printf("\n=== Pipeline pyramid: %d levels (%s) ===\n", pipeline->pyramid_levels,
+                     downsample->kernel_function);
+        for (p = 0; p < pipeline->pyramid_image_count; p++) {
+            for (level = 1; level < pipeline->pyramid_levels; level++) {
+                if (AddLaunch(&builder, inst, NULL, downsample, level, p) != 0) {
+                    PipelineRelease(inst);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    for (s = 0; s < pipeline->stage_count; s++) {
+        const PipelineStageConfig* stage = &pipeline->stages[s];
+        const KernelConfig* cfg = FindKernelConfig(config, stage->kernel_id);
+
+        if (cfg == NULL) {
+            (void)fprintf(stderr, "Error: Pipeline stage kernel '%s' not found\n",
+                          stage->kernel_id);
+            PipelineRelease(inst);
+            return -1;
+        }
+        if (stage->fuse_kernel_id[0] != '\0') {
+            if (FusionCreateKernelConfig(algorithm_id, config, cfg,
+                                         FindKernelConfig(config, stage->fuse_kernel_id),
+                                         &inst->fused_cfgs[s]) != 0) {
+                (void)fprintf(stderr, "Error: Failed to fuse '%s' into stage %s\n",
+                              stage->fuse_kernel_id, cfg->variant_id);
+                PipelineRelease(inst);
+                return -1;
+            }
+            cfg = &inst->fused_cfgs[s];
+        }
+        if (cfg->local_work_size_auto != 0) {
+            (void)printf("Note: stage %s uses driver-selected local size (no autotune)\n",
+                         cfg->variant_id);
+        }
+
+        (void)printf("\n=== Pipeline stage %d: %s (%s) ===\n", s, cfg->variant_id,
+                     cfg->kernel_function);
+
+        /* Coarse-to-fine stages: one launch per level, coarsest first */
+        if ((stage->coarse_to_fine != 0) && (inst->pyramid_count > 0)) {
+            for (level = pipeline->pyramid_levels - 1; level >= 0; level--) {
+                if (AddLaunch(&builder, inst, stage, cfg, level, -1) != 0) {
+                    PipelineRelease(inst);
+                    return -1;
+                }
+            }
+        } else if (AddLaunch(&builder, inst, stage, cfg, LEVEL_FULL, -1) != 0) {
+            PipelineRelease(inst);
+            return -1;
+        }
+    }
+
+    if (builder.last_writer[SLOT_OUTPUT] < 0) {
+        (void)printf("Warning: No stage of pipeline '%s' writes '%s'\n", pipeline->pipeline_id,
+                     PIPELINE_BUFFER_OUTPUT);
+    }
+    return 0;
+}
+/* Release the first count events */
+static void ReleaseEvents(cl_event* events, int count) {
+    int i;
+
+    for (i = 0; i < count; i++) {
+        /* MISRA-C:2023 Rule 17.7: Check return value */
+        (void)clReleaseEvent(events[i]);
+    }
+}
+
+int PipelineExecute(OpenCLEnv* env, const PipelineInstance* inst, PipelineTiming* timing) {
+    cl_event events[MAX_PIPELINE_LAUNCHES];
+    cl_event wait_list[MAX_PIPELINE_LAUNCHES];
+    cl_ulong start;
+    cl_ulong end;
+    cl_ulong first_start = 0U;
+    cl_ulong last_end = 0U;
+    cl_uint wait_count;
+    cl_int err;
+    int s;
+    int d;
+
+    if ((env == NULL) || (inst == NULL) || (timing == NULL) || (inst->launch_count <= 0)) {
+        return -1;
+    }
+
+    /* Enqueue every launch; dependencies are expressed only through events */
+    for (s = 0; s < inst->launch_count; s++) {
+        wait_count = 0U;
+        for (d = 0; d < s; d++) {
+            if ((inst->dep_mask[s] & (1U << (unsigned int)d)) != 0U) {
+                wait_list[wait_count] = events[d];
+                wait_count++;
+            }
+        }
+        if (OpenclEnqueueKernel(env, inst->kernels[s], inst->launch_cfgs[s],
+                                inst->launch_cfgs[s]->local_work_size, wait_count,
+                                (wait_count > 0U) ? wait_list : NULL, &events[s]) != 0) {
+            ReleaseEvents(events, s);
+            return -1;
+        }
+    }
+
+    /* Single host synchronization point for the whole chain */
+    err = clWaitForEvents((cl_uint)inst->launch_count, events);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to wait for pipeline (error code: %d)\n", err);
+        ReleaseEvents(events, inst->launch_count);
+        return -1;
+    }
+
+    timing->launch_count = inst->launch_count;
+    for (s = 0; s < inst->launch_count; s++) {
+        /* Tiled cl_extension launches report the span of their tiles */
+        err = ClExtensionGetEventTimes(events[s], &start, &end);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to get pipeline profiling info (error code: %d)\n",
+                          err);
+            ReleaseEvents(events, inst->launch_count);
+            return -1;
+        }
+        timing->launch_ms[s] = (double)(end - start) / 1000000.0;
+        if ((s == 0) || (start < first_start)) {
+            first_start = start;
+        }
+        if (end > last_end) {
+            last_end = end;
+        }
+    }
+    timing->total_ms = (double)(last_end - first_start) / 1000000.0;
+
+    ReleaseEvents(events, inst->launch_count);
+    return 0;
+}
+
+void PipelineRelease(PipelineInstance* inst) {
+    int s;
+
+    if (inst == NULL) {
+        return;
+    }
+    for (s = 0; s < inst->launch_count; s++) {
+        if (inst->kernels[s] != NULL) {
+            OpenclReleaseKernel(inst->kernels[s]);
+            inst->kernels[s] = NULL;
+        }
+    }
+    inst->launch_count = 0;
+    for (s = 0; s < inst->pyramid_count; s++) {
+        PyramidRelease(&inst->pyramids[s]);
+    }
+    inst->pyramid_count = 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file pipeline.h
+ * @brief Multi-kernel pipeline engine
+ *
+ * Executes the stages of a "pipeline" config entry back-to-back on the
+ * device. Each stage is a kernel variant from the "kernels" section whose
+ * buffer arguments are routed to the pipeline input ("src"), output ("dst")
+ * or named intermediate buffers from the "buffers" section.
+ *
+ * Dependencies are derived from buffer usage: a stage waits on the last
+ * writer of every buffer it touches, and a stage that writes a buffer also
+ * waits on earlier readers of it. All stages are enqueued with event wait
+ * lists and no host synchronization in between; the host only waits once
+ * for the whole chain.
+ *
+ * Stage kernels are obtained through OpenclBuildKernel(), so stages sharing
+ * a .cl file and build options share one program. A stage with "fuse" runs
+ * a generated kernel that applies the fused elementwise op to the stage
+ * kernel's stores (see fusion.h); its buffers are those of the stage kernel.
+ * "local_work_size": "auto" is not tuned inside pipelines (the driver chooses).
+ *
+ * With a "pyramid", the engine allocates the level planes (see pyramid.h)
+ * and prepends one downsample launch per image and level; a coarse_to_fine
+ * stage expands into one launch per level, coarsest first, with its global
+ * size and src/dst dimensions shrunk to the level. Level launches take part
+ * in the same dependency tracking, so the whole coarse-to-fine chain runs
+ * without host readback. Each launch has its own kernel object.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: No dynamic memory allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#include "opencl_utils.h"
+#include "pyramid.h"
+#include "utils/config.h"
+
+/** Maximum kernel launches of a pipeline (stages, pyramid builds, level launches) */
+#define MAX_PIPELINE_LAUNCHES 32
+
+/** Maximum pyramids of a pipeline (pyramid images plus level buffers) */
+#define MAX_PIPELINE_PYRAMIDS (2 * MAX_PYRAMID_BUFFERS)
+
+/**
+ * @brief Built pipeline: launch kernels with arguments set and dependencies
+ */
+typedef struct {
+    int launch_count;                                       /**< Number of launches */
+    const KernelConfig* launch_cfgs[MAX_PIPELINE_LAUNCHES]; /**< Launch kernel configurations */
+    int launch_level[MAX_PIPELINE_LAUNCHES];                /**< Pyramid level (-1: full size) */
+    KernelConfig fused_cfgs[MAX_PIPELINE_STAGES];           /**< Configs of fused stages */
+    KernelConfig level_cfgs[MAX_PIPELINE_LAUNCHES];         /**< Level-sized configs */
+    cl_kernel kernels[MAX_PIPELINE_LAUNCHES];               /**< Launch kernels (args bound) */
+    unsigned int dep_mask[MAX_PIPELINE_LAUNCHES];           /**< Bit d set: waits on launch d */
+    ImagePyramid pyramids[MAX_PIPELINE_PYRAMIDS];           /**< Images, then level buffers */
+    int pyramid_count;                                      /**< Number of pyramids */
+} PipelineInstance;
+
+/**
+ * @brief Device timing of one pipeline execution (profiling events)
+ */
+typedef struct {
+    int launch_count;                        /**< Number of launches timed */
+    double launch_ms[MAX_PIPELINE_LAUNCHES]; /**< Execution time per launch */
+    double total_ms;                         /**< First launch start to last launch end */
+} PipelineTiming;
+
+/**
+ * @brief Build launch kernels, bind buffers and derive launch dependencies
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] algorithm_id Algorithm identifier (kernel cache directory)
+ * @param[in] pipeline Pipeline configuration
+ * @param[in] config Full configuration (kernels and custom buffer types)
+ * @param[in] input_buf Pipeline input buffer ("src")
+ * @param[in] output_buf Pipeline output buffer ("dst")
+ * @param[in] params Operation parameters (custom buffers with cl_mem, scalars)
+ * @param[out] inst Built pipeline
+ * @return 0 on success, -1 on error (inst is released)
+ */
+int PipelineCreate(OpenCLEnv* env, const char* algorithm_id, const PipelineConfig* pipeline,
+                   const Config* config, cl_mem input_buf, cl_mem output_buf,
+                   const OpParams* params, PipelineInstance* inst);
+
+/**
+ * @brief Enqueue all launches with event dependencies and wait for the chain
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] inst Built pipeline
+ * @param[out] timing Per-launch and end-to-end device time
+ * @return 0 on success, -1 on error
+ */
+int PipelineExecute(OpenCLEnv* env, const PipelineInstance* inst, PipelineTiming* timing);
+
+/**
+ * @brief Release launch kernels and pyramid planes
+ *
+ * @param[in,out] inst Pipeline to release
+ */
+void PipelineRelease(PipelineInstance* inst);
@@ -0,0 +1,716 @@
+/**
+ * @file primitives.c
+ * @brief Device-wide reduce, scan, min/max and histogram implementation
+ */
+
+#include "primitives.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "program_registry.h"
+#include "utils/benchmark.h"
+#include "utils/mapped_file.h"
+
+/** Kernels of include/cl/primitives.cl */
+typedef enum {
+    PRIM_K_REDUCE_FLOAT = 0,
+    PRIM_K_REDUCE_INT,
+    PRIM_K_MINMAX_FLOAT,
+    PRIM_K_MINMAX_FLOAT2,
+    PRIM_K_SCAN_BLOCKS,
+    PRIM_K_SCAN_ADD,
+    PRIM_K_HISTOGRAM_U8,
+    PRIM_K_HISTOGRAM_FLOAT,
+    PRIM_KERNEL_COUNT
+} PrimKernelId;
+
+static const char* const kPrimKernelNames[PRIM_KERNEL_COUNT] = {
+    "prim_reduce_float", "prim_reduce_int",  "prim_minmax_float",   "prim_minmax_float2",
+    "prim_scan_blocks",  "prim_scan_add",    "prim_histogram_u8",   "prim_histogram_float"};
+
+/** Launches of one primitive call (scan: two per level, at most four levels) */
+#define MAX_PRIM_LAUNCHES 16
+
+/** Grid-stride passes use at most this many work-groups per compute unit */
+#define PRIM_GROUPS_PER_CU 4U
+
+/** Events of the launches of one primitive call */
+typedef struct {
+    cl_event events[MAX_PRIM_LAUNCHES];
+    int count;
+} PrimLaunches;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static cl_kernel prim_kernels[PRIM_KERNEL_COUNT];
+static size_t prim_local_size[PRIM_KERNEL_COUNT];
+static KernelConfig prim_cfg;
+static int prim_cfg_ready = 0;
+
+/* Kernel configuration of the primitives program (shared build options) */
+static const KernelConfig* PrimProgramConfig(void) {
+    if (prim_cfg_ready == 0) {
+        (void)memset(&prim_cfg, 0, sizeof(prim_cfg));
+        (void)snprintf(prim_cfg.variant_id, sizeof(prim_cfg.variant_id), "v0");
+        (void)snprintf(prim_cfg.kernel_file, sizeof(prim_cfg.kernel_file), "%s/primitives.cl",
+                       CL_INCLUDE_DIR);
+        prim_cfg.work_dim = 1;
+        prim_cfg.host_type = HOST_TYPE_STANDARD;
+        prim_cfg.memory_strategy = MEM_STRATEGY_COPY;
+        prim_cfg_ready = 1;
+    }
+    return &prim_cfg;
+}
+
+size_t PrimWorkGroupSize(const OpenCLEnv* env, cl_kernel kernel) {
+    size_t limit = PRIM_MAX_LOCAL_SIZE;
+    size_t kernel_limit = 0U;
+    size_t local = 1U;
+
+    if ((env->max_work_group_size > 0U) && (env->max_work_group_size < limit)) {
+        limit = env->max_work_group_size;
+    }
+    if ((clGetKernelWorkGroupInfo(kernel, env->device, CL_KERNEL_WORK_GROUP_SIZE,
+                                  sizeof(kernel_limit), &kernel_limit, NULL) == CL_SUCCESS) &&
+        (kernel_limit > 0U) && (kernel_limit < limit)) {
+        limit = kernel_limit;
+    }
+    while ((local * 2U) <= limit) {
+        local *= 2U;
+    }
+    return local;
+}
+
+/* Kernel by id, created from the registry program on first use */
+static cl_kernel PrimKernel(OpenCLEnv* env, PrimKernelId id, size_t* local_size) {
+    if (prim_kernels[id] == NULL) {
+        prim_kernels[id] = ProgramRegistryCreateKernel(env, PRIMITIVES_ALGORITHM_ID,
+                                                       PrimProgramConfig(), kPrimKernelNames[id]);
+        if (prim_kernels[id] == NULL) {
+            (void)fprintf(stderr, "Error: Failed to create primitive kernel %s\n",
+                          kPrimKernelNames[id]);
+            return NULL;
+        }
+        prim_local_size[id] = PrimWorkGroupSize(env, prim_kernels[id]);
+    }
+    *local_size = prim_local_size[id];
+    return prim_kernels[id];
+}
+
+/* Set one kernel argument; message names the kernel and index on failure */
+static int PrimSetArg(cl_kernel kernel, PrimKernelId id, cl_uint index, size_t size,
+                      const void* value) {
+    cl_int err = clSetKernelArg(kernel, index, size, value);
+
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Error: Failed to set argument %u of %s (error: %d)\n", index,
+                      kPrimKernelNames[id], err);
+        return -1;
+    }
+    return 0;
+}
+
+/* Enqueue a 1D launch of @p groups work-groups and record its event */
+static int PrimLaunch(OpenCLEnv* env, cl_kernel kernel, size_t groups, size_t local,
+                      PrimLaunches* launches) {
+    KernelConfig cfg;
+
+    if (launches->count >= MAX_PRIM_LAUNCHES) {
+        (void)fprintf(stderr, "Error: Too many primitive launches (max %d)\n",
+                      MAX_PRIM_LAUNCHES);
+        return -1;
+    }
+    cfg = *PrimProgramConfig();
+    cfg.global_work_size[0] = groups * local;
+    cfg.local_work_size[0] = local;
+    if (OpenclEnqueueKernel(env, kernel, &cfg, cfg.local_work_size, 0U, NULL,
+                            &launches->events[launches->count]) != 0) {
+        return -1;
+    }
+    launches->count++;
+    return 0;
+}
+
+/* Work-groups of a grid-stride pass over @p count elements */
+static size_t PrimStrideGroups(const OpenCLEnv* env, int count, size_t local) {
+    size_t groups = ((size_t)count + local - 1U) / local;
+    size_t max_groups = (size_t)((env->compute_units > 0U) ? env->compute_units : 1U) *
+                        PRIM_GROUPS_PER_CU;
+
+    return (groups < max_groups) ? groups : max_groups;
+}
+
+/*
+ * Release the events of a call. With gpu_time_ms, wait for the launches
+ * first and report their summed profiling time.
+ */
+static int PrimFinish(PrimLaunches* launches, double* gpu_time_ms) {
+    int result = 0;
+    int i;
+
+    if (gpu_time_ms != NULL) {
+        *gpu_time_ms = 0.0;
+        if ((launches->count > 0) &&
+            (clWaitForEvents((cl_uint)launches->count, launches->events) != CL_SUCCESS)) {
+            (void)fprintf(stderr, "Error: Primitive launch failed\n");
+            result = -1;
+        }
+    }
+    for (i = 0; i < launches->count; i++) {
+        double ms;
+
+        if ((result == 0) && (gpu_time_ms != NULL)) {
+            if (OpenclGetEventDurationMs(launches->events[i], &ms) == 0) {
+                *gpu_time_ms += ms;
+            }
+        }
+        /* MISRA-C:2023 Rule 17.7: Check return value */
+        if (clReleaseEvent(launches->events[i]) != CL_SUCCESS) {
+            (void)fprintf(stderr, "Warning: Failed to release primitive event\n");
+        }
+    }
+    launches->count = 0;
+    return result;
+}
+
+/* Blocking read of @p size bytes from offset 0 */
+static int PrimRead(const OpenCLEnv* env, cl_mem buffer, void* dst, size_t size) {
+    return OpenclReadbackBuffer(env, buffer, MEM_STRATEGY_COPY, dst, size, NULL);
+}
+
+/*
+ * Two-pass grid-stride reduction: pass 1 leaves one partial per group,
+ * pass 2 runs the second kernel with a single group over the partials.
+ * @p value_size is the size of one partial, @p op < 0 for kernels without op.
+ */
+static int PrimReduceTwoPass(OpenCLEnv* env, PrimKernelId first, PrimKernelId second,
+                             cl_mem src, int count, int op, size_t value_size, void* result,
+                             double* gpu_time_ms) {
+    PrimLaunches launches;
+    cl_kernel k1;
+    cl_kernel k2;
+    size_t local1;
+    size_t local2;
+    size_t groups;
+    cl_mem partials;
+    cl_mem final_buf;
+    int partial_count;
+    cl_uint arg;
+    int status = -1;
+
+    if ((env == NULL) || (src == NULL) || (count <= 0) || (result == NULL)) {
+        return -1;
+    }
+    k1 = PrimKernel(env, first, &local1);
+    k2 = PrimKernel(env, second, &local2);
+    if ((k1 == NULL) || (k2 == NULL)) {
+        return -1;
+    }
+
+    groups = PrimStrideGroups(env, count, local1);
+    partial_count = (int)groups;
+    partials = OpenclCreateBuffer(env->context, CL_MEM_READ_WRITE, groups * value_size, NULL,
+                                  "prim_partials");
+    final_buf = OpenclCreateBuffer(env->context, CL_MEM_READ_WRITE, value_size, NULL,
+                                   "prim_result");
+    launches.count = 0;
+
+    if ((partials != NULL) && (final_buf != NULL)) {
+        /* Pass 1: src -> partials */
+        arg = 0U;
+        if ((PrimSetArg(k1, first, arg++, sizeof(cl_mem), &src) == 0) &&
+            (PrimSetArg(k1, first, arg++, sizeof(int), &count) == 0) &&
+            ((op < 0) || (PrimSetArg(k1, first, arg++, sizeof(int), &op) == 0)) &&
+            (PrimSetArg(k1, first, arg++, sizeof(cl_mem), &partials) == 0) &&
+            (PrimSetArg(k1, first, arg, local1 * value_size, NULL) == 0) &&
+            (PrimLaunch(env, k1, groups, local1, &launches) == 0)) {
+            /* Pass 2: one group over the partials -> final_buf */
+            arg = 0U;
+            if ((PrimSetArg(k2, second, arg++, sizeof(cl_mem), &partials) == 0) &&
+                (PrimSetArg(k2, second, arg++, sizeof(int), &partial_count) == 0) &&
+                ((op < 0) || (PrimSetArg(k2, second, arg++, sizeof(int), &op) == 0)) &&
+                (PrimSetArg(k2, second, arg++, sizeof(cl_mem), &final_buf) == 0) &&
+                (PrimSetArg(k2, second, arg, local2 * value_size, NULL) == 0) &&
+                (PrimLaunch(env, k2, 1U, local2, &launches) == 0)) {
+                status = 0;
+            }
+        }
+    }
+
+    if ((PrimFinish(&launches, gpu_time_ms) != 0) ||
+        ((status == 0) && (PrimRead(env, final_buf, result, value_size) != 0))) {
+        status = -1;
+    }
+    OpenclReleaseMemObject(partials, "prim_partials");
+    OpenclReleaseMemObject(final_buf, "prim_result");
+    return status;
+}
+
+int PrimReduceFloat(OpenCLEnv* env, cl_mem src, int count, PrimOp op, float* result,
+                    double* gpu_time_ms) {
+    return PrimReduceTwoPass(env, PRIM_K_REDUCE_FLOAT, PRIM_K_REDUCE_FLOAT, src, count, (int)op,
+                             sizeof(float), result, gpu_time_ms);
+}
+
+int PrimReduceInt(OpenCLEnv* env, cl_mem src, int count, PrimOp op, int* result,
+                  double* gpu_time_ms) {
+    return PrimReduceTwoPass(env, PRIM_K_REDUCE_INT, PRIM_K_REDUCE_INT, src, count, (int)op,
+                             sizeof(int), result, gpu_time_ms);
+}
+
+int PrimMinMaxFloat(OpenCLEnv* env, cl_mem src, int count, float* min_value, float* max_value,
+                    double* gpu_time_ms) {
+    cl_float2 range;
+
+    if ((min_value == NULL) || (max_value == NULL)) {
+        return -1;
+    }
+    if (PrimReduceTwoPass(env, PRIM_K_MINMAX_FLOAT, PRIM_K_MINMAX_FLOAT2, src, count, -1,
+                          sizeof(cl_float2), &range, gpu_time_ms) != 0) {
+        return -1;
+    }
+    *min_value = range.s[0];
+    *max_value = range.s[1];
+    return 0;
+}
+
+/*
+ * One scan level: block scans of src into dst, then (for more than one
+ * block) the block totals are scanned by the next level and added back.
+ * The single block of the last level writes its total to @p total.
+ */
+static int PrimScanLevel(OpenCLEnv* env, cl_mem src, cl_mem dst, int count, cl_mem total,
+                         PrimLaunches* launches) {
+    cl_kernel k_scan;
+    cl_kernel k_add;
+    size_t local;
+    size_t local_add;
+    size_t blocks;
+    cl_mem sums;
+    int block_count;
+    int status = -1;
+
+    k_scan = PrimKernel(env, PRIM_K_SCAN_BLOCKS, &local);
+    k_add = PrimKernel(env, PRIM_K_SCAN_ADD, &local_add);
+    if ((k_scan == NULL) || (k_add == NULL)) {
+        return -1;
+    }
+    (void)local_add; /* Launched with the scan's block size: group i adds block i's offset */
+
+    blocks = ((size_t)count + local - 1U) / local;
+    block_count = (int)blocks;
+    sums = total;
+    if (blocks > 1U) {
+        sums = OpenclCreateBuffer(env->context, CL_MEM_READ_WRITE, blocks * sizeof(int), NULL,
+                                  "prim_block_sums");
+    } else if (sums == NULL) {
+        sums = OpenclCreateBuffer(env->context, CL_MEM_READ_WRITE, sizeof(int), NULL,
+                                  "prim_block_sums");
+    }
+    if (sums == NULL) {
+        return -1;
+    }
+
+    if ((PrimSetArg(k_scan, PRIM_K_SCAN_BLOCKS, 0U, sizeof(cl_mem), &src) == 0) &&
+        (PrimSetArg(k_scan, PRIM_K_SCAN_BLOCKS, 1U, sizeof(int), &count) == 0) &&
+        (PrimSetArg(k_scan, PRIM_K_SCAN_BLOCKS, 2U, sizeof(cl_mem), &dst) == 0) &&
+        (PrimSetArg(k_scan, PRIM_K_SCAN_BLOCKS, 3U, sizeof(cl_mem), &sums) == 0) &&
+        (PrimSetArg(k_scan, PRIM_K_SCAN_BLOCKS, 4U, local * sizeof(int), NULL) == 0) &&
+        (PrimLaunch(env, k_scan, blocks, local, launches) == 0)) {
+        if (blocks == 1U) {
+            status = 0;
+        } else if ((PrimScanLevel(env, sums, sums, block_count, total, launches) == 0) &&
+                   (PrimSetArg(k_add, PRIM_K_SCAN_ADD, 0U, sizeof(cl_mem), &dst) == 0) &&
+                   (PrimSetArg(k_add, PRIM_K_SCAN_ADD, 1U, sizeof(int), &count) == 0) &&
+                   (PrimSetArg(k_add, PRIM_K_SCAN_ADD, 2U, sizeof(cl_mem), &sums) == 0) &&
+                   (PrimLaunch(env, k_add, blocks, local, launches) == 0)) {
+            status = 0;
+        } else {
+            /* status stays -1 */
+        }
+    }
+
+    /* The pool keeps the buffer alive for the launches already enqueued */
+    if (sums != total) {
+        OpenclReleaseMemObject(sums, "prim_block_sums");
+    }
+    return status;
+}
+
+int PrimScanExclusiveInt(OpenCLEnv* env, cl_mem src, cl_mem dst, int count, cl_mem total,
+                         double* gpu_time_ms) {
+    PrimLaunches launches;
+    int status;
+
+    if ((env == NULL) || (src == NULL) || (dst == NULL) || (count <= 0)) {
+        return -1;
+    }
+    launches.count = 0;
+    status = PrimScanLevel(env, src, dst, count, total, &launches);
+    if (PrimFinish(&launches, gpu_time_ms) != 0) {
+        status = -1;
+    }
+    return status;
+}
+
+/*
+ * Zero the histogram and launch a histogram kernel whose arguments before
+ * the bins are already set; @p bins_index is the index of the bins argument.
+ */
+static int PrimHistogram(OpenCLEnv* env, PrimKernelId id, cl_kernel kernel, size_t local,
+                         int count, cl_mem bins, int bin_count, cl_uint bins_index,
+                         double* gpu_time_ms) {
+    PrimLaunches launches;
+    cl_int zero = 0;
+    cl_int err;
+    int status = -1;
+
+    launches.count = 0;
+    err = clEnqueueFillBuffer(env->queue, bins, &zero, sizeof(zero), 0U,
+                              (size_t)bin_count * sizeof(int), 0U, NULL, &launches.events[0]);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Error: Failed to clear histogram (error: %d)\n", err);
+        return -1;
+    }
+    launches.count = 1;
+
+    if ((PrimSetArg(kernel, id, bins_index, sizeof(cl_mem), &bins) == 0) &&
+        (PrimSetArg(kernel, id, bins_index + 1U, sizeof(int), &bin_count) == 0) &&
+        (PrimSetArg(kernel, id, bins_index + 2U, (size_t)bin_count * sizeof(int), NULL) == 0) &&
+        (PrimLaunch(env, kernel, PrimStrideGroups(env, count, local), local, &launches) == 0)) {
+        status = 0;
+    }
+    if (PrimFinish(&launches, gpu_time_ms) != 0) {
+        status = -1;
+    }
+    return status;
+}
+
+int PrimHistogramU8(OpenCLEnv* env, cl_mem src, int count, cl_mem bins, int bin_count,
+                    double* gpu_time_ms) {
+    cl_kernel kernel;
+    size_t local;
+
+    if ((env == NULL) || (src == NULL) || (bins == NULL) || (count <= 0) || (bin_count < 1) ||
+        (bin_count > 256)) {
+        return -1;
+    }
+    kernel = PrimKernel(env, PRIM_K_HISTOGRAM_U8, &local);
+    if ((kernel == NULL) ||
+        (PrimSetArg(kernel, PRIM_K_HISTOGRAM_U8, 0U, sizeof(cl_mem), &src) != 0) ||
+        (PrimSetArg(kernel, PRIM_K_HISTOGRAM_U8, 1U, sizeof(int), &count) != 0)) {
+        return -1;
+    }
+    return PrimHistogram(env, PRIM_K_HISTOGRAM_U8, kernel, local, count, bins, bin_count, 2U,
+                         gpu_time_ms);
+}
+
+int PrimHistogramFloat(OpenCLEnv* env, cl_mem src, int count, float lo, float hi, cl_mem bins,
+                       int bin_count, double* gpu_time_ms) {
+    cl_kernel kernel;
+    size_t local;
+
+    if ((env == NULL) || (src == NULL) || (bins == NULL) || (count <= 0) || (bin_count < 1) ||
+        (bin_count > PRIM_MAX_HISTOGRAM_BINS) || !(hi > lo)) {
+        return -1;
+    }
+    kernel = PrimKernel(env, PRIM_K_HISTOGRAM_FLOAT, &local);
+    if ((kernel == NULL) ||
+        (PrimSetArg(kernel, PRIM_K_HISTOGRAM_FLOAT, 0U, sizeof(cl_mem), &src) != 0) ||
+        (PrimSetArg(kernel, PRIM_K_HISTOGRAM_FLOAT, 1U, sizeof(int), &count) != 0) ||
+        (PrimSetArg(kernel, PRIM_K_HISTOGRAM_FLOAT, 2U, sizeof(float), &lo) != 0) ||
+        (PrimSetArg(kernel, PRIM_K_HISTOGRAM_FLOAT, 3U, sizeof(float), &hi) != 0)) {
+        return -1;
+    }
+    return PrimHistogram(env, PRIM_K_HISTOGRAM_FLOAT, kernel, local, count, bins, bin_count, 4U,
+                         gpu_time_ms);
+}
+
+void PrimitivesReleaseKernels(void) {
+    int i;
+
+    for (i = 0; i < (int)PRIM_KERNEL_COUNT; i++) {
+        if (prim_kernels[i] != NULL) {
+            OpenclReleaseKernel(prim_kernels[i]);
+            prim_kernels[i] = NULL;
+        }
+    }
+}
+
+/* ============================================================================
+ * BENCHMARK
+ * ============================================================================
+ */
+
+/** Bins of the benchmark histograms */
+#define BENCH_U8_BINS 256
+#define BENCH_FLOAT_BINS 64
+
+/** Primitives covered by PrimitivesBenchmark() */
+typedef enum {
+    BENCH_REDUCE_SUM_FLOAT = 0,
+    BENCH_REDUCE_SUM_INT,
+    BENCH_MINMAX_FLOAT,
+    BENCH_SCAN_INT,
+    BENCH_HISTOGRAM_U8,
+    BENCH_HISTOGRAM_FLOAT,
+    BENCH_COUNT
+} BenchPrimitive;
+
+static const char* const kBenchNames[BENCH_COUNT] = {
+    "reduce_sum_float", "reduce_sum_int", "minmax_float",
+    "scan_exclusive_int", "histogram_u8", "histogram_float"};
+
+/** Device and host data of a benchmark run */
+typedef struct {
+    int count;
+    MappedBuffer host;    /**< floats | ints | scan result | uchars */
+    float* values_f;      /**< Input floats in [-1, 1) */
+    int* values_i;        /**< Input ints in {0, 1} (e.g. a corner map) */
+    int* scan_out;        /**< Readback of the scan */
+    unsigned char* bytes; /**< Input 8-bit values */
+    cl_mem src_f;
+    cl_mem src_i;
+    cl_mem src_u8;
+    cl_mem scan_dst;
+    cl_mem scan_total;
+    cl_mem bins;
+} BenchData;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static double bench_samples[MAX_BENCHMARK_ITERATIONS];
+
+/* Deterministic pseudo-random inputs (LCG, same data on every run) */
+static void BenchFillInputs(BenchData* d) {
+    unsigned int state = 12345U;
+    int i;
+
+    for (i = 0; i < d->count; i++) {
+        state = (state * 1103515245U) + 12345U;
+        d->values_f[i] = ((float)((state >> 8) & 0xFFFFU) / 32768.0f) - 1.0f;
+        d->values_i[i] = (int)((state >> 24) & 1U);
+        d->bytes[i] = (unsigned char)(state >> 16);
+    }
+}
+
+/* Host bin of prim_histogram_float (same float arithmetic as the kernel) */
+static int BenchFloatBin(float v, float lo, float hi, int bin_count) {
+    float scale = (float)bin_count / (hi - lo);
+    float pos = floorf((v - lo) * scale);
+
+    if (pos < 0.0f) {
+        return 0;
+    }
+    return (pos >= (float)bin_count) ? (bin_count - 1) : (int)pos;
+}
+
+/* Run one primitive once; @p check compares against the host result */
+static int BenchRun(OpenCLEnv* env, BenchData* d, BenchPrimitive p, int check, double* ms) {
+    static int gpu_bins[PRIM_MAX_HISTOGRAM_BINS];
+    static int ref_bins[PRIM_MAX_HISTOGRAM_BINS];
+    int i;
+
+    switch (p) {
+        case BENCH_REDUCE_SUM_FLOAT: {
+            float sum;
+            double ref = 0.0;
+            double abs_sum = 0.0;
+
+            if (PrimReduceFloat(env, d->src_f, d->count, PRIM_OP_SUM, &sum, ms) != 0) {
+                return -1;
+            }
+            if (check == 0) {
+                return 0;
+            }
+            for (i = 0; i < d->count; i++) {
+                ref += (double)d->values_f[i];
+                abs_sum += fabs((double)d->values_f[i]);
+            }
+            /* Float tree sum: error grows with log2(count) roundings of the running total */
+            return (fabs((double)sum - ref) <= (1e-5 * abs_sum) + 1e-3) ? 0 : -1;
+        }
+        case BENCH_REDUCE_SUM_INT: {
+            int sum;
+            int ref = 0;
+
+            if (PrimReduceInt(env, d->src_i, d->count, PRIM_OP_SUM, &sum, ms) != 0) {
+                return -1;
+            }
+            if (check == 0) {
+                return 0;
+            }
+            for (i = 0; i < d->count; i++) {
+                ref += d->values_i[i];
+            }
+            return (sum == ref) ? 0 : -1;
+        }
+        case BENCH_MINMAX_FLOAT: {
+            float lo;
+            float hi;
+            float ref_lo = d->values_f[0];
+            float ref_hi = d->values_f[0];
+
+            if (PrimMinMaxFloat(env, d->src_f, d->count, &lo, &hi, ms) != 0) {
+                return -1;
+            }
+            if (check == 0) {
+                return 0;
+            }
+            for (i = 1; i < d->count; i++) {
+                ref_lo = (d->values_f[i] < ref_lo) ? d->values_f[i] : ref_lo;
+                ref_hi = (d->values_f[i] > ref_hi) ? d->values_f[i] : ref_hi;
+            }
+            return ((lo == ref_lo) && (hi == ref_hi)) ? 0 : -1;
+        }
+        case BENCH_SCAN_INT: {
+            int total;
+            int running = 0;
+
+            if (PrimScanExclusiveInt(env, d->src_i, d->scan_dst, d->count, d->scan_total, ms) !=
+                0) {
+                return -1;
+            }
+            if (check == 0) {
+                return 0;
+            }
+            if ((PrimRead(env, d->scan_dst, d->scan_out, (size_t)d->count * sizeof(int)) != 0) ||
+                (PrimRead(env, d->scan_total, &total, sizeof(int)) != 0)) {
+                return -1;
+            }
+            for (i = 0; i < d->count; i++) {
+                if (d->scan_out[i] != running) {
+                    (void)fprintf(stderr, "  scan mismatch at %d: %d (expected %d)\n", i,
+                                  d->scan_out[i], running);
+                    return -1;
+                }
+                running += d->values_i[i];
+            }
+            return (total == running) ? 0 : -1;
+        }
+        case BENCH_HISTOGRAM_U8:
+        case BENCH_HISTOGRAM_FLOAT: {
+            int bin_count = (p == BENCH_HISTOGRAM_U8) ? BENCH_U8_BINS : BENCH_FLOAT_BINS;
+            int status = (p == BENCH_HISTOGRAM_U8)
+                             ? PrimHistogramU8(env, d->src_u8, d->count, d->bins, bin_count, ms)
+                             : PrimHistogramFloat(env, d->src_f, d->count, -1.0f, 1.0f, d->bins,
+                                                  bin_count, ms);
+
+            if ((status != 0) || (check == 0)) {
+                return status;
+            }
+            if (PrimRead(env, d->bins, gpu_bins, (size_t)bin_count * sizeof(int)) != 0) {
+                return -1;
+            }
+            (void)memset(ref_bins, 0, (size_t)bin_count * sizeof(int));
+            for (i = 0; i < d->count; i++) {
+                if (p == BENCH_HISTOGRAM_U8) {
+                    ref_bins[((int)d->bytes[i] * bin_count) >> 8]++;
+                } else {
+                    ref_bins[BenchFloatBin(d->values_f[i], -1.0f, 1.0f, bin_count)]++;
+                }
+            }
+            return (memcmp(gpu_bins, ref_bins, (size_t)bin_count * sizeof(int)) == 0) ? 0 : -1;
+        }
+        default:
+            return -1;
+    }
+}
+
+/* Input bytes read by one run of a primitive */
+static size_t BenchInputBytes(BenchPrimitive p, int count) {
+    return (p == BENCH_HISTOGRAM_U8) ? (size_t)count : ((size_t)count * sizeof(float));
+}
+
+static void BenchReleaseData(BenchData* d) {
+    OpenclReleaseMemObject(d->src_f, "prim_bench_f32");
+    OpenclReleaseMemObject(d->src_i, "prim_bench_i32");
+    OpenclReleaseMemObject(d->src_u8, "prim_bench_u8");
+    OpenclReleaseMemObject(d->scan_dst, "prim_bench_scan");
+    OpenclReleaseMemObject(d->scan_total, "prim_bench_total");
+    OpenclReleaseMemObject(d->bins, "prim_bench_bins");
+    MappedBufferRelease(&d->host);
+}
+
+int PrimitivesBenchmark(OpenCLEnv* env, int count, int warmup, int iterations) {
+    BenchData d;
+    BenchmarkStats stats;
+    size_t n;
+    int failures = 0;
+    int p;
+    int it;
+
+    if ((env == NULL) || (count <= 0) || (warmup < 0) || (iterations < 1) ||
+        (iterations > MAX_BENCHMARK_ITERATIONS)) {
+        return -1;
+    }
+
+    (void)memset(&d, 0, sizeof(d));
+    d.count = count;
+    n = (size_t)count;
+    if (MappedBufferAlloc(n * ((3U * sizeof(int)) + 1U), &d.host) != 0) {
+        (void)fprintf(stderr, "Error: Failed to allocate primitive benchmark data\n");
+        return -1;
+    }
+    d.values_f = (float*)(void*)d.host.data;
+    d.values_i = (int*)(void*)(d.host.data + (n * sizeof(float)));
+    d.scan_out = (int*)(void*)(d.host.data + (2U * n * sizeof(int)));
+    d.bytes = d.host.data + (3U * n * sizeof(int));
+    BenchFillInputs(&d);
+
+    d.src_f = OpenclCreateBuffer(env->context, CL_MEM_READ_ONLY, n * sizeof(float), NULL,
+                                 "prim_bench_f32");
+    d.src_i = OpenclCreateBuffer(env->context, CL_MEM_READ_ONLY, n * sizeof(int), NULL,
+                                 "prim_bench_i32");
+    d.src_u8 = OpenclCreateBuffer(env->context, CL_MEM_READ_ONLY, n, NULL, "prim_bench_u8");
+    d.scan_dst = OpenclCreateBuffer(env->context, CL_MEM_READ_WRITE, n * sizeof(int), NULL,
+                                    "prim_bench_scan");
+    d.scan_total = OpenclCreateBuffer(env->context, CL_MEM_READ_WRITE, sizeof(int), NULL,
+                                      "prim_bench_total");
+    d.bins = OpenclCreateBuffer(env->context, CL_MEM_READ_WRITE,
+                                (size_t)BENCH_U8_BINS * sizeof(int), NULL, "prim_bench_bins");
+    if ((d.src_f == NULL) || (d.src_i == NULL) || (d.src_u8 == NULL) || (d.scan_dst == NULL) ||
+        (d.scan_total == NULL) || (d.bins == NULL) ||
+        (OpenclUploadBuffer(env, d.src_f, MEM_STRATEGY_COPY, d.values_f, n * sizeof(float),
+                            NULL) != 0) ||
+        (OpenclUploadBuffer(env, d.src_i, MEM_STRATEGY_COPY, d.values_i, n * sizeof(int),
+                            NULL) != 0) ||
+        (OpenclUploadBuffer(env, d.src_u8, MEM_STRATEGY_COPY, d.bytes, n, NULL) != 0)) {
+        BenchReleaseData(&d);
+        return -1;
+    }
+
+    (void)printf("\n=== Primitives Benchmark: %d elements, %d warmup + %d timed ===\n", count,
+                 warmup, iterations);
+    for (p = 0; p < (int)BENCH_COUNT; p++) {
+        double ms = 0.0;
+        int ok = 1;
+
+        if (BenchRun(env, &d, (BenchPrimitive)p, 1, &ms) != 0) {
+            (void)printf("%-20s FAILED (result differs from host)\n", kBenchNames[p]);
+            failures++;
+            continue;
+        }
+        for (it = 0; (it < warmup) && (ok != 0); it++) {
+            ok = (BenchRun(env, &d, (BenchPrimitive)p, 0, &ms) == 0) ? 1 : 0;
+        }
+        for (it = 0; (it < iterations) && (ok != 0); it++) {
+            ok = (BenchRun(env, &d, (BenchPrimitive)p, 0, &bench_samples[it]) == 0) ? 1 : 0;
+        }
+        if ((ok == 0) || (BenchmarkComputeStats(bench_samples, iterations, &stats) != 0)) {
+            (void)printf("%-20s FAILED (launch error)\n", kBenchNames[p]);
+            failures++;
+            continue;
+        }
+        BenchmarkPrintStats(kBenchNames[p], &stats);
+        if (stats.median_ms > 0.0) {
+            (void)printf("%-20s %.2f GB/s input bandwidth (median)\n", "",
+                         (double)BenchInputBytes((BenchPrimitive)p, count) /
+                             (stats.median_ms * 1.0e6));
+        }
+    }
+
+    BenchReleaseData(&d);
+    (void)printf("Primitives: %d of %d passed\n", (int)BENCH_COUNT - failures, (int)BENCH_COUNT);
+    return (failures == 0) ? 0 : -1;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file primitives.h
+ * @brief Device-wide reduce, scan, min/max and histogram on device buffers
+ *
+ * Host side of the shared primitives library: the kernels are in
+ * include/cl/primitives.cl, and kernels of any algorithm can use the same
+ * work-group building blocks through #include "primitives.h".
+ *
+ * - Reduce / min-max: a grid-stride pass leaves one partial per work-group,
+ *   a second single-group launch of the same kernel combines them; only the
+ *   final value is read back.
+ * - Scan: each work-group scans one block and writes the block total; the
+ *   totals are scanned the same way (a second level, and further levels for
+ *   more than local_size^2 elements) and added back to the blocks.
+ * - Histogram: one local histogram per work-group, merged into the global
+ *   histogram with one atomic per bin and group.
+ *
+ * Launches go to env->queue in order; intermediate buffers come from the
+ * buffer pool. With @p gpu_time_ms set, a call waits for its launches and
+ * reports their summed profiling time; without it, scan and histogram
+ * return as soon as everything is enqueued.
+ *
+ * The kernels are built once per process through the program registry
+ * (cached under out/primitives/) and released by PrimitivesReleaseKernels(),
+ * called from OpenclCleanup().
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Static kernel table, no dynamic memory allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#include "opencl_utils.h"
+
+/** Algorithm id of the primitives program (kernel cache directory) */
+#define PRIMITIVES_ALGORITHM_ID "primitives"
+
+/** Upper bound on the work-group size used by the primitives */
+#define PRIM_MAX_LOCAL_SIZE 256U
+
+/** Maximum histogram bins (local memory: one int per bin and group) */
+#define PRIM_MAX_HISTOGRAM_BINS 4096
+
+/**
+ * @brief Reduction operator
+ *
+ * Must match PRIM_OP_* in include/cl/primitives.h
+ */
+typedef enum { PRIM_OP_SUM = 0, PRIM_OP_MIN = 1, PRIM_OP_MAX = 2 } PrimOp;
+
+/**
+ * @brief Work-group size for a kernel built on include/cl/primitives.h
+ *
+ * Largest power of two within PRIM_MAX_LOCAL_SIZE, the device limit and
+ * the kernel's CL_KERNEL_WORK_GROUP_SIZE.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] kernel Kernel
+ * @return Work-group size (>= 1)
+ */
+size_t PrimWorkGroupSize(const OpenCLEnv* env, cl_kernel kernel);
+
+/**
+ * @brief Reduce a float buffer
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] src Input values (float)
+ * @param[in] count Number of values (> 0)
+ * @param[in] op Reduction operator
+ * @param[out] result Reduction of src[0 .. count)
+ * @param[out] gpu_time_ms Summed kernel time in milliseconds (may be NULL)
+ * @return 0 on success, -1 on error
+ */
+int PrimReduceFloat(OpenCLEnv* env, cl_mem src, int count, PrimOp op, float* result,
+                    double* gpu_time_ms);
+
+/**
+ * @brief Reduce an int buffer
+ *
+ * Sums wrap like the device's 32-bit integer arithmetic.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] src Input values (int)
+ * @param[in] count Number of values (> 0)
+ * @param[in] op Reduction operator
+ * @param[out] result Reduction of src[0 .. count)
+ * @param[out] gpu_time_ms Summed kernel time in milliseconds (may be NULL)
+ * @return 0 on success, -1 on error
+ */
+int PrimReduceInt(OpenCLEnv* env, cl_mem src, int count, PrimOp op, int* result,
+                  double* gpu_time_ms);
+
+/**
+ * @brief Minimum and maximum of a float buffer in one pass over the data
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] src Input values (float)
+ * @param[in] count Number of values (> 0)
+ * @param[out] min_value Minimum
+ * @param[out] max_value Maximum
+ * @param[out] gpu_time_ms Summed kernel time in milliseconds (may be NULL)
+ * @return 0 on success, -1 on error
+ */
+int PrimMinMaxFloat(OpenCLEnv* env, cl_mem src, int count, float* min_value, float* max_value,
+                    double* gpu_time_ms);
+
+/**
+ * @brief Exclusive prefix sum of an int buffer
+ *
+ * dst[i] = src[0] + ... + src[i - 1]. @p src and @p dst may be the same
+ * buffer. The result stays on the device; @p total (if given) receives the
+ * sum of all values in its first int, e.g. the length of a compacted list.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] src Input values (int)
+ * @param[in] dst Output values (int, count elements)
+ * @param[in] count Number of values (> 0)
+ * @param[in] total Buffer receiving the total (one int), or NULL
+ * @param[out] gpu_time_ms Summed kernel time in milliseconds (may be NULL)
+ * @return 0 on success, -1 on error
+ */
+int PrimScanExclusiveInt(OpenCLEnv* env, cl_mem src, cl_mem dst, int count, cl_mem total,
+                         double* gpu_time_ms);
+
+/**
+ * @brief Histogram of 8-bit values into equal-width bins
+ *
+ * Value v is counted in bin v * bin_count / 256. @p bins is overwritten.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] src Input values (uchar)
+ * @param[in] count Number of values (> 0)
+ * @param[in] bins Histogram (int, bin_count elements)
+ * @param[in] bin_count Number of bins (1..256)
+ * @param[out] gpu_time_ms Summed kernel time in milliseconds (may be NULL)
+ * @return 0 on success, -1 on error
+ */
+int PrimHistogramU8(OpenCLEnv* env, cl_mem src, int count, cl_mem bins, int bin_count,
+                    double* gpu_time_ms);
+
+/**
+ * @brief Histogram of float values over [lo, hi) into equal-width bins
+ *
+ * Out-of-range values are clamped into the first or last bin, NaNs are not
+ * counted. @p bins is overwritten.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] src Input values (float)
+ * @param[in] count Number of values (> 0)
+ * @param[in] lo Lower edge of the first bin
+ * @param[in] hi Upper edge of the last bin (> lo)
+ * @param[in] bins Histogram (int, bin_count elements)
+ * @param[in] bin_count Number of bins (1..PRIM_MAX_HISTOGRAM_BINS)
+ * @param[out] gpu_time_ms Summed kernel time in milliseconds (may be NULL)
+ * @return 0 on success, -1 on error
+ */
+int PrimHistogramFloat(OpenCLEnv* env, cl_mem src, int count, float lo, float hi, cl_mem bins,
+                       int bin_count, double* gpu_time_ms);
+
+/**
+ * @brief Check and benchmark every primitive on generated data
+ *
+ * Each primitive is checked once against a host computation, then timed
+ * over warmup + timed iterations; prints latency statistics and achieved
+ * input bandwidth per primitive.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] count Elements per input (> 0)
+ * @param[in] warmup Warmup iterations (not timed)
+ * @param[in] iterations Timed iterations (1..MAX_BENCHMARK_ITERATIONS)
+ * @return 0 if every primitive matched its host result, -1 otherwise
+ */
+int PrimitivesBenchmark(OpenCLEnv* env, int count, int warmup, int iterations);
+
+/**
+ * @brief Release the primitive kernels (the program stays with the registry)
+ */
+void PrimitivesReleaseKernels(void);
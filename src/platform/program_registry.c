@@ -0,0 +1,158 @@
+/**
+ * @file program_registry.c
+ * @brief Per-process registry of built OpenCL programs
+ */
+
+#include "program_registry.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "trace.h"
+#include "utils/benchmark.h"
+#include "utils/config.h"
+
+/** Maximum build options length stored per entry */
+#define MAX_REGISTRY_OPTIONS 768
+
+/** One built program and the key it was built for */
+typedef struct {
+    char kernel_file[256];                    /**< Kernel source file path */
+    char build_options[MAX_REGISTRY_OPTIONS]; /**< Complete build options */
+    cl_context context;                       /**< Context the program belongs to */
+    cl_program program;                       /**< Built program (registry-owned) */
+} RegisteredProgram;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static RegisteredProgram registered_programs[MAX_REGISTERED_PROGRAMS];
+static int registered_count = 0;
+
+/* Registered program for kernel_cfg; *registered is 0 if the registry was full */
+static cl_program LookupOrBuild(OpenCLEnv* env, const char* algorithm_id,
+                                const struct KernelConfig* kernel_cfg, int* registered) {
+    char build_options[MAX_REGISTRY_OPTIONS];
+    RegisteredProgram* entry;
+    cl_program program;
+    char span_name[64];
+    double start_ms;
+    int i;
+
+    *registered = 1;
+    if ((env == NULL) || (algorithm_id == NULL) || (kernel_cfg == NULL)) {
+        return NULL;
+    }
+
+    if (OpenclComposeBuildOptions(kernel_cfg, build_options, sizeof(build_options)) != 0) {
+        return NULL;
+    }
+
+    for (i = 0; i < registered_count; i++) {
+        entry = &registered_programs[i];
+        if ((entry->context == env->context) &&
+            (strcmp(entry->kernel_file, kernel_cfg->kernel_file) == 0) &&
+            (strcmp(entry->build_options, build_options) == 0)) {
+            (void)printf("Reusing built program for %s (%s)\n", entry->kernel_file,
+                         entry->build_options);
+            return entry->program;
+        }
+    }
+
+    start_ms = BenchmarkNowMs();
+    program = OpenclBuildProgram(env, algorithm_id, kernel_cfg->kernel_file, build_options,
+                                 kernel_cfg->host_type);
+    if (TraceEnabled() != 0) {
+        (void)snprintf(span_name, sizeof(span_name), "build %.57s", kernel_cfg->kernel_file);
+        TraceRecordHost(span_name, "build", start_ms, BenchmarkNowMs());
+    }
+    if (program == NULL) {
+        return NULL;
+    }
+
+    if (registered_count >= MAX_REGISTERED_PROGRAMS) {
+        /* Registry full: the caller owns the program */
+        (void)fprintf(stderr, "Warning: Program registry full (%d), program not shared\n",
+                      MAX_REGISTERED_PROGRAMS);
+        *registered = 0;
+        return program;
+    }
+
+    entry = &registered_programs[registered_count];
+    (void)strncpy(entry->kernel_file, kernel_cfg->kernel_file, sizeof(entry->kernel_file) - 1U);
+    entry->kernel_file[sizeof(entry->kernel_file) - 1U] = '\0';
+    (void)strncpy(entry->build_options, build_options, sizeof(entry->build_options) - 1U);
+    entry->build_options[sizeof(entry->build_options) - 1U] = '\0';
+    entry->context = env->context;
+    entry->program = program;
+    registered_count++;
+
+    return program;
+}
+
+cl_program ProgramRegistryGetProgram(OpenCLEnv* env, const char* algorithm_id,
+                                     const struct KernelConfig* kernel_cfg) {
+    cl_program program;
+    cl_int err;
+    int registered;
+
+    program = LookupOrBuild(env, algorithm_id, kernel_cfg, &registered);
+    if ((program != NULL) && (registered == 0)) {
+        /* Only registry-owned programs are handed out */
+        err = clReleaseProgram(program);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Warning: Failed to release program (error: %d)\n", err);
+        }
+        program = NULL;
+    }
+    return program;
+}
+
+cl_kernel ProgramRegistryCreateKernel(OpenCLEnv* env, const char* algorithm_id,
+                                      const struct KernelConfig* kernel_cfg,
+                                      const char* kernel_name) {
+    cl_program program;
+    cl_kernel kernel;
+    cl_int err;
+    int registered;
+
+    if (kernel_name == NULL) {
+        return NULL;
+    }
+
+    program = LookupOrBuild(env, algorithm_id, kernel_cfg, &registered);
+    if (program == NULL) {
+        return NULL;
+    }
+
+    kernel = clCreateKernel(program, kernel_name, &err);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Error: Failed to create kernel '%s' (error code: %d)\n", kernel_name,
+                      err);
+        kernel = NULL;
+    }
+
+    /* An unregistered program lives on through the kernel's own reference */
+    if (registered == 0) {
+        err = clReleaseProgram(program);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Warning: Failed to release program (error: %d)\n", err);
+        }
+    }
+    return kernel;
+}
+
+void ProgramRegistryReleaseAll(void) {
+    cl_int err;
+    int i;
+
+    for (i = 0; i < registered_count; i++) {
+        if (registered_programs[i].program != NULL) {
+            /* MISRA-C:2023 Rule 17.7: Check return value */
+            err = clReleaseProgram(registered_programs[i].program);
+            if (err != CL_SUCCESS) {
+                (void)fprintf(stderr, "Warning: Failed to release program (error: %d)\n", err);
+            }
+            registered_programs[i].program = NULL;
+        }
+    }
+    registered_count = 0;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file program_registry.h
+ * @brief Per-process registry of built OpenCL programs
+ *
+ * Several kernel variants of an algorithm usually live in the same .cl file
+ * and share build options. The registry builds each unique
+ * (kernel_file, build_options) pair once - loading or saving the program
+ * binary through cache_manager exactly once - and hands out cl_kernel
+ * objects by function name from the shared program.
+ *
+ * Programs are owned by the registry and released by
+ * ProgramRegistryReleaseAll() (called from OpenclCleanup()). Kernels created
+ * from them hold their own references and are released by the caller as
+ * before. When the registry is full, ProgramRegistryCreateKernel() still
+ * returns the kernel but drops its own reference to the unshared program.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Static registry table, no dynamic memory allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#include "opencl_utils.h"
+
+/** Maximum number of distinct programs held by the registry */
+#define MAX_REGISTERED_PROGRAMS 32
+
+/**
+ * @brief Get the program for a kernel configuration, building it on first use
+ *
+ * The lookup key is (kernel_file, composed build options). On a miss the
+ * program is built via OpenclBuildProgram() and registered.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] algorithm_id Algorithm identifier for cache organization
+ * @param[in] kernel_cfg Kernel configuration (file, options, host type)
+ * @return Registry-owned program, or NULL on error (including a full registry)
+ */
+cl_program ProgramRegistryGetProgram(OpenCLEnv* env, const char* algorithm_id,
+                                     const struct KernelConfig* kernel_cfg);
+
+/**
+ * @brief Create a kernel by name from the program of a kernel configuration
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] algorithm_id Algorithm identifier for cache organization
+ * @param[in] kernel_cfg Kernel configuration (file, options, host type)
+ * @param[in] kernel_name Kernel function name within the program
+ * @return New kernel object (caller releases), or NULL on error
+ */
+cl_kernel ProgramRegistryCreateKernel(OpenCLEnv* env, const char* algorithm_id,
+                                      const struct KernelConfig* kernel_cfg,
+                                      const char* kernel_name);
+
+/**
+ * @brief Release all registered programs and empty the registry
+ */
+void ProgramRegistryReleaseAll(void);
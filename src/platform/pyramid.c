@@ -0,0 +1,128 @@
+/**
+ * @file pyramid.c
+ * @brief Device-side image pyramids implementation
+ */
+
+#include "pyramid.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "buffer_pool.h"
+
+int PyramidLevelDim(int base, int level) {
+    int size = base;
+    int l;
+
+    for (l = 0; l < level; l++) {
+        size = (size + 1) / 2;
+    }
+    return size;
+}
+
+/* Size of a buffer as requested (pooled) or allocated, 0 on query failure */
+static size_t BaseSize(cl_mem buffer) {
+    size_t size = BufferPoolRequestedSize(buffer);
+
+    if ((size == 0U) &&
+        (clGetMemObjectInfo(buffer, CL_MEM_SIZE, sizeof(size), &size, NULL) != CL_SUCCESS)) {
+        size = 0U;
+    }
+    return size;
+}
+
+int PyramidCreate(OpenCLEnv* env, const char* name, cl_mem base, int width, int height,
+                  int levels, int zero_level, ImagePyramid* pyr) {
+    size_t pixels;
+    size_t size;
+    int top;
+    int l;
+
+    if ((env == NULL) || (name == NULL) || (base == NULL) || (pyr == NULL) || (width <= 0) ||
+        (height <= 0) || (levels < 2) || (levels > MAX_PYRAMID_LEVELS)) {
+        return -1;
+    }
+
+    (void)memset(pyr, 0, sizeof(*pyr));
+    (void)snprintf(pyr->name, sizeof(pyr->name), "%s", name);
+    pyr->levels = levels;
+    pyr->zero_level = zero_level;
+    pixels = (size_t)width * (size_t)height;
+    pyr->bytes_per_pixel = BaseSize(base) / pixels;
+    if (pyr->bytes_per_pixel == 0U) {
+        (void)fprintf(stderr, "Error: Pyramid buffer '%s' is smaller than %dx%d pixels\n", name,
+                      width, height);
+        return -1;
+    }
+
+    top = (zero_level != 0) ? levels : (levels - 1);
+    pyr->planes[0] = base;
+    for (l = 0; l <= top; l++) {
+        pyr->width[l] = PyramidLevelDim(width, l);
+        pyr->height[l] = PyramidLevelDim(height, l);
+        if (l == 0) {
+            continue;
+        }
+
+        size = (size_t)pyr->width[l] * (size_t)pyr->height[l] * pyr->bytes_per_pixel;
+        pyr->planes[l] = OpenclCreateBuffer(env->context, CL_MEM_READ_WRITE, size, NULL, name);
+        if (pyr->planes[l] == NULL) {
+            PyramidRelease(pyr);
+            return -1;
+        }
+        /* The plane past the coarsest level is the zero initial estimate */
+        if ((l == levels) && (OpenclFillBuffer(env, pyr->planes[l], 0U, size) != 0)) {
+            PyramidRelease(pyr);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void PyramidLevelParams(const ImagePyramid* pyr, int src_level, int dst_level, OpParams* params) {
+    if ((pyr == NULL) || (params == NULL)) {
+        return;
+    }
+    params->src_width = pyr->width[src_level];
+    params->src_height = pyr->height[src_level];
+    params->src_stride = pyr->width[src_level] * params->src_channels;
+    params->dst_width = pyr->width[dst_level];
+    params->dst_height = pyr->height[dst_level];
+    params->dst_stride = pyr->width[dst_level] * params->dst_channels;
+}
+
+void PyramidLevelWorkSize(const KernelConfig* cfg, int width, int height,
+                          KernelConfig* level_cfg) {
+    size_t extent[2];
+    int dim;
+
+    if ((cfg == NULL) || (level_cfg == NULL)) {
+        return;
+    }
+    *level_cfg = *cfg;
+    if (cfg->work_dim < 2) {
+        return;
+    }
+    extent[0] = (size_t)width;
+    extent[1] = (size_t)height;
+    for (dim = 0; (dim < cfg->work_dim) && (dim < 2); dim++) {
+        size_t local = cfg->local_work_size[dim];
+        level_cfg->global_work_size[dim] =
+            (local > 0U) ? (((extent[dim] + local - 1U) / local) * local) : extent[dim];
+    }
+}
+
+void PyramidRelease(ImagePyramid* pyr) {
+    int l;
+
+    if (pyr == NULL) {
+        return;
+    }
+    for (l = 1; l <= MAX_PYRAMID_LEVELS; l++) {
+        if (pyr->planes[l] != NULL) {
+            OpenclReleaseMemObject(pyr->planes[l], pyr->name);
+            pyr->planes[l] = NULL;
+        }
+    }
+    pyr->levels = 0;
+}
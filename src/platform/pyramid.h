@@ -0,0 +1,102 @@
+/**
+ * @file pyramid.h
+ * @brief Device-side image pyramids for coarse-to-fine pipelines
+ *
+ * A pyramid is a set of device planes for one pipeline buffer: level 0 is
+ * the buffer itself, level l + 1 is ceil(w / 2) x ceil(h / 2) of level l
+ * with the same bytes per pixel. Planes of levels 1 and up come from the
+ * buffer pool and stay on the device; nothing is read back between levels.
+ *
+ * Pyramid images are filled level by level by a downsample kernel (see
+ * include/cl/pyramid.h); level buffers (e.g. per-level flow) are written by
+ * coarse-to-fine stages and get an extra zero-filled plane one level past
+ * the coarsest, so the coarsest launch reads a zero initial estimate
+ * through the same "@coarser" binding as every other level.
+ *
+ * Level planes are packed (row stride = level width); the base buffer must
+ * be packed too.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Planes from the buffer pool, no dynamic memory allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#include "opencl_utils.h"
+#include "utils/config.h"
+
+/**
+ * @brief Planes of one pyramid buffer
+ */
+typedef struct {
+    char name[64];                           /**< Pipeline buffer name */
+    int levels;                              /**< Levels including level 0 */
+    int zero_level;                          /**< Non-zero: planes[levels] is zero-filled */
+    int width[MAX_PYRAMID_LEVELS + 1];       /**< Width per level */
+    int height[MAX_PYRAMID_LEVELS + 1];      /**< Height per level */
+    size_t bytes_per_pixel;                  /**< Bytes per pixel (all levels) */
+    cl_mem planes[MAX_PYRAMID_LEVELS + 1];   /**< Level planes ([0] is the caller's buffer) */
+} ImagePyramid;
+
+/**
+ * @brief Size of a dimension at a pyramid level: ceil(base / 2^level)
+ *
+ * @param[in] base Level-0 size
+ * @param[in] level Level
+ * @return Size at the level
+ */
+int PyramidLevelDim(int base, int level);
+
+/**
+ * @brief Allocate the planes of levels 1 .. levels-1 (and the zero plane)
+ *
+ * Bytes per pixel are taken from the size of @p base divided by
+ * width * height.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] name Pipeline buffer name (for messages)
+ * @param[in] base Level-0 buffer (not owned)
+ * @param[in] width Level-0 width
+ * @param[in] height Level-0 height
+ * @param[in] levels Levels including level 0 (2..MAX_PYRAMID_LEVELS)
+ * @param[in] zero_level Non-zero to add a zero-filled plane past the coarsest level
+ * @param[out] pyr Pyramid
+ * @return 0 on success, -1 on error (pyr is released)
+ */
+int PyramidCreate(OpenCLEnv* env, const char* name, cl_mem base, int width, int height,
+                  int levels, int zero_level, ImagePyramid* pyr);
+
+/**
+ * @brief Operation parameters for a launch reading level @p src_level and writing @p dst_level
+ *
+ * Sets src/dst width, height and (packed) stride; all other fields are kept.
+ *
+ * @param[in] pyr Pyramid providing the level sizes
+ * @param[in] src_level Level read by the launch
+ * @param[in] dst_level Level written by the launch
+ * @param[in,out] params Parameters to adjust
+ */
+void PyramidLevelParams(const ImagePyramid* pyr, int src_level, int dst_level, OpParams* params);
+
+/**
+ * @brief Kernel config with its global size shrunk to a level
+ *
+ * Dimension 0 covers @p width, dimension 1 @p height, each rounded up to a
+ * multiple of the local size (when one is set). 1D launches (e.g. over a
+ * keypoint list) are not image-shaped and keep their global size.
+ *
+ * @param[in] cfg Full-size kernel configuration
+ * @param[in] width Level width
+ * @param[in] height Level height
+ * @param[out] level_cfg Copy of @p cfg with the level's global size
+ */
+void PyramidLevelWorkSize(const KernelConfig* cfg, int width, int height,
+                          KernelConfig* level_cfg);
+
+/**
+ * @brief Return the level planes to the pool (level 0 is left alone)
+ *
+ * @param[in,out] pyr Pyramid to release
+ */
+void PyramidRelease(ImagePyramid* pyr);
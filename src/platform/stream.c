@@ -0,0 +1,318 @@
+/**
+ * @file stream.c
+ * @brief Multi-frame streaming engine implementation
+ */
+
+#include "stream.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "kernel_args.h"
+#include "trace.h"
+#include "utils/frame_source.h"
+#include "utils/mapped_file.h"
+
+/** Indices of the per-frame commands */
+#define STREAM_CMD_UPLOAD 0
+#define STREAM_CMD_KERNEL 1
+#define STREAM_CMD_READBACK 2
+#define STREAM_CMD_COUNT 3
+
+/**
+ * @brief One in-flight buffer set
+ */
+typedef struct {
+    cl_mem input_buf;                  /**< Device input of this set */
+    cl_mem output_buf;                 /**< Device output of this set */
+    cl_event events[STREAM_CMD_COUNT]; /**< Upload, kernel, readback events */
+    int frame;                         /**< Frame in flight, or -1 if idle */
+} StreamSlot;
+
+/**
+ * @brief Running totals over retired frames
+ */
+typedef struct {
+    int retired;                     /**< Frames retired so far */
+    double cmd_ms[STREAM_CMD_COUNT]; /**< Sum of command times per kind */
+} StreamTotals;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static double latency_samples[MAX_BENCHMARK_ITERATIONS];
+static KernelArgPlan stream_args;
+
+/* Create an in-order profiling queue on the environment's device */
+static cl_command_queue CreateStreamQueue(const OpenCLEnv* env, const char* name) {
+    cl_int err;
+    cl_command_queue queue;
+
+    queue = clCreateCommandQueue(env->context, env->device, CL_QUEUE_PROFILING_ENABLE, &err);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to create %s queue (error code: %d)\n", name, err);
+        return NULL;
+    }
+    return queue;
+}
+
+/* Release the events of a slot and mark it idle */
+static void ReleaseSlotEvents(StreamSlot* slot) {
+    int c;
+
+    for (c = 0; c < STREAM_CMD_COUNT; c++) {
+        if (slot->events[c] != NULL) {
+            /* MISRA-C:2023 Rule 17.7: Check return value */
+            (void)clReleaseEvent(slot->events[c]);
+            slot->events[c] = NULL;
+        }
+    }
+    slot->frame = -1;
+}
+
+/* Wait for the slot's frame, record its timing and write its output frame */
+static int RetireSlot(StreamSlot* slot, const unsigned char* host_output, size_t output_size,
+                      FILE* out_fp, StreamTotals* totals) {
+    cl_int err;
+    cl_ulong queued;
+    cl_ulong end;
+    double cmd_ms;
+    int c;
+
+    err = clWaitForEvents(1U, &slot->events[STREAM_CMD_READBACK]);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to wait for frame %d (error code: %d)\n", slot->frame, err);
+        return -1;
+    }
+
+    for (c = 0; c < STREAM_CMD_COUNT; c++) {
+        if (OpenclGetEventDurationMs(slot->events[c], &cmd_ms) != 0) {
+            return -1;
+        }
+        totals->cmd_ms[c] += cmd_ms;
+    }
+
+    /* Latency: upload queued until readback done (same device clock for all queues) */
+    err = clGetEventProfilingInfo(slot->events[STREAM_CMD_UPLOAD], CL_PROFILING_COMMAND_QUEUED,
+                                  sizeof(queued), &queued, NULL);
+    if (err == CL_SUCCESS) {
+        err = clGetEventProfilingInfo(slot->events[STREAM_CMD_READBACK], CL_PROFILING_COMMAND_END,
+                                      sizeof(end), &end, NULL);
+    }
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Failed to get frame profiling info (error code: %d)\n", err);
+        return -1;
+    }
+    /* Ring of the most recent frames bounds the sample storage */
+    latency_samples[totals->retired % MAX_BENCHMARK_ITERATIONS] =
+        (end > queued) ? ((double)(end - queued) / 1000000.0) : 0.0;
+    totals->retired++;
+
+    if ((out_fp != NULL) && (fwrite(host_output, 1U, output_size, out_fp) != output_size)) {
+        (void)fprintf(stderr, "Error: Failed to write output frame %d\n", slot->frame);
+        return -1;
+    }
+
+    ReleaseSlotEvents(slot);
+    return 0;
+}
+
+int StreamRun(OpenCLEnv* env, cl_kernel kernel, const KernelConfig* kernel_cfg,
+              const OpParams* params, const StreamConfig* stream_cfg, size_t input_size,
+              size_t output_size, StreamResult* result) {
+    cl_command_queue queues[STREAM_CMD_COUNT] = {NULL, NULL, NULL};
+    static const char* const queue_names[STREAM_CMD_COUNT] = {"upload", "compute", "readback"};
+    StreamSlot slots[MAX_STREAM_BUFFER_SETS];
+    StreamTotals totals;
+    FrameSource source;
+    MappedBuffer staging_input;
+    MappedBuffer staging_output;
+    FILE* out_fp = NULL;
+    StreamSlot* slot;
+    const unsigned char* frame_data;
+    unsigned char* frame_staging;
+    unsigned char* host_output;
+    char trace_name[32];
+    cl_int err;
+    double start_ms;
+    int sets;
+    int frame;
+    int s;
+    int c;
+    int status = -1;
+
+    if ((env == NULL) || (kernel == NULL) || (kernel_cfg == NULL) || (params == NULL) ||
+        (stream_cfg == NULL) || (result == NULL)) {
+        return -1;
+    }
+    sets = stream_cfg->buffer_sets;
+    if ((sets < 2) || (sets > MAX_STREAM_BUFFER_SETS)) {
+        sets = STREAM_DEFAULT_BUFFER_SETS;
+    }
+
+    if (FrameSourceOpen(stream_cfg->input_path, input_size, stream_cfg->max_frames, &source) !=
+        0) {
+        return -1;
+    }
+
+    (void)memset(&totals, 0, sizeof(totals));
+    (void)memset(slots, 0, sizeof(slots));
+    (void)memset(&staging_input, 0, sizeof(staging_input));
+    (void)memset(&staging_output, 0, sizeof(staging_output));
+    for (s = 0; s < MAX_STREAM_BUFFER_SETS; s++) {
+        slots[s].frame = -1;
+    }
+
+    /* Page-backed host staging per set: output always, input only for directory sources */
+    if ((MappedBufferAlloc(output_size * (size_t)sets, &staging_output) != 0) ||
+        ((source.is_directory != 0) &&
+         (MappedBufferAlloc(input_size * (size_t)sets, &staging_input) != 0))) {
+        goto cleanup;
+    }
+
+    for (c = 0; c < STREAM_CMD_COUNT; c++) {
+        queues[c] = CreateStreamQueue(env, queue_names[c]);
+        if (queues[c] == NULL) {
+            goto cleanup;
+        }
+    }
+    for (s = 0; s < sets; s++) {
+        slots[s].input_buf = OpenclCreateBuffer(env->context, CL_MEM_READ_ONLY, input_size, NULL,
+                                                "stream input");
+        slots[s].output_buf = OpenclCreateBuffer(env->context, CL_MEM_WRITE_ONLY, output_size,
+                                                 NULL, "stream output");
+        if ((slots[s].input_buf == NULL) || (slots[s].output_buf == NULL)) {
+            goto cleanup;
+        }
+    }
+
+    if (stream_cfg->output_path[0] != '\0') {
+        out_fp = fopen(stream_cfg->output_path, "wb");
+        if (out_fp == NULL) {
+            (void)fprintf(stderr, "Error: Failed to create stream output: %s\n",
+                          stream_cfg->output_path);
+            goto cleanup;
+        }
+    }
+
+    /* Set every argument once, untimed; per frame only the two buffer arguments change */
+    if ((KernelArgPlanCompile(kernel, params, kernel_cfg, NULL, &stream_args) != 0) ||
+        (KernelArgPlanBind(&stream_args, slots[0].input_buf, slots[0].output_buf) != 0)) {
+        goto cleanup;
+    }
+
+    start_ms = BenchmarkNowMs();
+    for (frame = 0; frame < source.frame_count; frame++) {
+        s = frame % sets;
+        slot = &slots[s];
+        host_output = staging_output.data + ((size_t)s * output_size);
+
+        /* Reusing a set: its previous frame must be fully read back first */
+        if ((slot->frame >= 0) &&
+            (RetireSlot(slot, host_output, output_size, out_fp, &totals) != 0)) {
+            goto cleanup;
+        }
+
+        /* Host file I/O overlaps the device work of the frames still in flight */
+        frame_staging =
+            (staging_input.data != NULL) ? (staging_input.data + ((size_t)s * input_size)) : NULL;
+        if (FrameSourceRead(&source, frame_staging, &frame_data) != 0) {
+            goto cleanup;
+        }
+        slot->frame = frame;
+
+        err = clEnqueueWriteBuffer(queues[STREAM_CMD_UPLOAD], slot->input_buf, CL_FALSE, 0U,
+                                   input_size, frame_data, 0U, NULL,
+                                   &slot->events[STREAM_CMD_UPLOAD]);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to upload frame %d (error code: %d)\n", frame, err);
+            goto cleanup;
+        }
+        if (TraceEnabled() != 0) {
+            (void)snprintf(trace_name, sizeof(trace_name), "write frame %d", frame);
+            TraceRecordEvent(slot->events[STREAM_CMD_UPLOAD], queues[STREAM_CMD_UPLOAD],
+                             trace_name, "transfer");
+        }
+
+        /* Arguments are captured at enqueue time, so re-binding per frame is safe */
+        if ((KernelArgPlanBind(&stream_args, slot->input_buf, slot->output_buf) != 0) ||
+            (OpenclEnqueueKernelOnQueue(env, queues[STREAM_CMD_KERNEL], kernel, kernel_cfg,
+                                        kernel_cfg->local_work_size, 1U,
+                                        &slot->events[STREAM_CMD_UPLOAD],
+                                        &slot->events[STREAM_CMD_KERNEL]) != 0)) {
+            goto cleanup;
+        }
+
+        err = clEnqueueReadBuffer(queues[STREAM_CMD_READBACK], slot->output_buf, CL_FALSE, 0U,
+                                  output_size, host_output, 1U,
+                                  &slot->events[STREAM_CMD_KERNEL],
+                                  &slot->events[STREAM_CMD_READBACK]);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Failed to read back frame %d (error code: %d)\n", frame, err);
+            goto cleanup;
+        }
+        if (TraceEnabled() != 0) {
+            (void)snprintf(trace_name, sizeof(trace_name), "read frame %d", frame);
+            TraceRecordEvent(slot->events[STREAM_CMD_READBACK], queues[STREAM_CMD_READBACK],
+                             trace_name, "transfer");
+        }
+
+        /* Submit now so the device starts while the host reads the next frame */
+        for (c = 0; c < STREAM_CMD_COUNT; c++) {
+            (void)clFlush(queues[c]);
+        }
+    }
+
+    /* Drain the remaining sets in frame order */
+    for (frame = source.frame_count - sets; frame < source.frame_count; frame++) {
+        if (frame < 0) {
+            continue;
+        }
+        s = frame % sets;
+        if ((slots[s].frame >= 0) &&
+            (RetireSlot(&slots[s], staging_output.data + ((size_t)s * output_size), output_size,
+                        out_fp, &totals) != 0)) {
+            goto cleanup;
+        }
+    }
+
+    result->frames = totals.retired;
+    result->buffer_sets = sets;
+    result->total_ms = BenchmarkNowMs() - start_ms;
+    result->fps = (result->total_ms > 0.0)
+                      ? ((double)totals.retired * 1000.0 / result->total_ms)
+                      : 0.0;
+    result->upload_mean_ms = totals.cmd_ms[STREAM_CMD_UPLOAD] / (double)totals.retired;
+    result->kernel_mean_ms = totals.cmd_ms[STREAM_CMD_KERNEL] / (double)totals.retired;
+    result->readback_mean_ms = totals.cmd_ms[STREAM_CMD_READBACK] / (double)totals.retired;
+    if (BenchmarkComputeStats(latency_samples,
+                              (totals.retired < MAX_BENCHMARK_ITERATIONS)
+                                  ? totals.retired
+                                  : MAX_BENCHMARK_ITERATIONS,
+                              &result->latency) == 0) {
+        status = 0;
+    }
+
+cleanup:
+    /* MISRA-C:2023 Rule 22.1: Finish outstanding work before releasing its buffers */
+    for (c = 0; c < STREAM_CMD_COUNT; c++) {
+        if (queues[c] != NULL) {
+            (void)clFinish(queues[c]);
+        }
+    }
+    for (s = 0; s < MAX_STREAM_BUFFER_SETS; s++) {
+        ReleaseSlotEvents(&slots[s]);
+        OpenclReleaseMemObject(slots[s].input_buf, "stream input buffer");
+        OpenclReleaseMemObject(slots[s].output_buf, "stream output buffer");
+    }
+    for (c = 0; c < STREAM_CMD_COUNT; c++) {
+        if (queues[c] != NULL) {
+            (void)clReleaseCommandQueue(queues[c]);
+        }
+    }
+    if ((out_fp != NULL) && (fclose(out_fp) != 0)) {
+        (void)fprintf(stderr, "Warning: Failed to close stream output\n");
+    }
+    MappedBufferRelease(&staging_input);
+    MappedBufferRelease(&staging_output);
+    FrameSourceClose(&source);
+    return status;
+}
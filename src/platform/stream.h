@@ -0,0 +1,68 @@
+/**
+ * @file stream.h
+ * @brief Multi-frame streaming engine with overlapped transfers
+ *
+ * Applies one configured kernel to every frame of a FrameSource. Each frame
+ * uses one of 2-3 buffer sets (host staging, device input, device output)
+ * and three in-order command queues of the same context:
+ *
+ *   upload queue:   write frame k+1    (waits on nothing)
+ *   compute queue:  kernel on frame k  (waits on its upload)
+ *   readback queue: read frame k-1     (waits on its kernel)
+ *
+ * Cross-queue ordering uses events only, so the device is free to overlap
+ * the three. Before a buffer set is reused the host waits for its previous
+ * frame's readback, which also bounds the number of frames in flight. Host
+ * file reads of the next frame overlap the device work of the others.
+ *
+ * Per-frame latency is measured on the device clock from the moment the
+ * upload is queued until the readback ends; throughput is host wall-clock
+ * over the whole sequence.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Static host staging buffers, no dynamic allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#include "opencl_utils.h"
+#include "utils/benchmark.h"
+#include "utils/config.h"
+
+/**
+ * @brief Outcome of one streaming run
+ */
+typedef struct {
+    int frames;              /**< Frames processed */
+    int buffer_sets;         /**< In-flight buffer sets used */
+    double total_ms;         /**< Host wall-clock for the whole sequence */
+    double fps;              /**< Sustained frames per second */
+    BenchmarkStats latency;  /**< Per-frame latency (last MAX_BENCHMARK_ITERATIONS frames) */
+    double upload_mean_ms;   /**< Mean upload command time */
+    double kernel_mean_ms;   /**< Mean kernel command time */
+    double readback_mean_ms; /**< Mean readback command time */
+} StreamResult;
+
+/**
+ * @brief Stream a frame sequence through an already verified kernel
+ *
+ * Kernel arguments are re-bound for every frame to that frame's buffer set
+ * (custom buffers and scalars come from params and are shared by all
+ * frames). The kernel must be safe to run on consecutive frames in the
+ * same compute queue, which is in order, so kernels never overlap each
+ * other.
+ *
+ * @param[in] env Initialized OpenCL environment
+ * @param[in] kernel Built kernel
+ * @param[in] kernel_cfg Kernel configuration (arguments and work sizes)
+ * @param[in] params Operation parameters (custom buffers with cl_mem, scalars)
+ * @param[in] stream_cfg Streaming settings (frame source, output, buffer sets)
+ * @param[in] input_size Bytes per input frame
+ * @param[in] output_size Bytes per output frame
+ * @param[out] result Throughput and latency statistics
+ * @return 0 on success, -1 on error
+ */
+int StreamRun(OpenCLEnv* env, cl_kernel kernel, const KernelConfig* kernel_cfg,
+              const OpParams* params, const StreamConfig* stream_cfg, size_t input_size,
+              size_t output_size, StreamResult* result);
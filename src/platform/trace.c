@@ -0,0 +1,339 @@
+/**
+ * @file trace.c
+ * @brief Event timeline trace export (Chrome trace format) implementation
+ */
+
+#include "trace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "utils/benchmark.h"
+
+/* Trace process ids */
+#define TRACE_PID_HOST 1
+#define TRACE_PID_DEVICE 2
+
+/* Profiling timestamps read per device event */
+#define TRACE_STAMP_QUEUED 0
+#define TRACE_STAMP_SUBMIT 1
+#define TRACE_STAMP_START 2
+#define TRACE_STAMP_END 3
+#define TRACE_STAMP_COUNT 4
+
+/**
+ * @brief One recorded device command or host span
+ */
+typedef struct {
+    cl_event event;       /**< Retained event (NULL for host spans) */
+    int queue;            /**< Queue index (device commands) */
+    double host_ms;       /**< Host time at record (device) or span start (host) */
+    double end_ms;        /**< Span end (host spans) */
+    char name[64];        /**< Display name */
+    const char* category; /**< Category (string literal) */
+} TraceEntry;
+
+static int trace_enabled = 0;
+static TraceEntry entries[MAX_TRACE_EVENTS];
+static int entry_count = 0;
+static int dropped_count = 0;
+static cl_command_queue queues[MAX_TRACE_QUEUES];
+static int queue_count = 0;
+
+/* Timestamps read in TraceWrite(), kept off the stack */
+static cl_ulong stamps[MAX_TRACE_EVENTS][TRACE_STAMP_COUNT];
+static int stamps_valid[MAX_TRACE_EVENTS];
+
+void TraceEnable(int enabled) { trace_enabled = (enabled != 0) ? 1 : 0; }
+
+int TraceEnabled(void) { return trace_enabled; }
+
+/* Index of a queue, registering it on first use (overflow shares the last track) */
+static int QueueIndex(cl_command_queue queue) {
+    int i;
+
+    for (i = 0; i < queue_count; i++) {
+        if (queues[i] == queue) {
+            return i;
+        }
+    }
+    if (queue_count < MAX_TRACE_QUEUES) {
+        queues[queue_count] = queue;
+        queue_count++;
+        return queue_count - 1;
+    }
+    return MAX_TRACE_QUEUES - 1;
+}
+
+/* Next free entry, or NULL (and one more dropped) when the table is full */
+static TraceEntry* NewEntry(const char* name, const char* category) {
+    TraceEntry* entry;
+
+    if (entry_count >= MAX_TRACE_EVENTS) {
+        dropped_count++;
+        return NULL;
+    }
+    entry = &entries[entry_count];
+    entry_count++;
+    (void)memset(entry, 0, sizeof(*entry));
+    (void)snprintf(entry->name, sizeof(entry->name), "%s", (name != NULL) ? name : "?");
+    entry->category = (category != NULL) ? category : "other";
+    return entry;
+}
+
+void TraceRecordEvent(cl_event event, cl_command_queue queue, const char* name,
+                      const char* category) {
+    TraceEntry* entry;
+
+    if ((trace_enabled == 0) || (event == NULL)) {
+        return;
+    }
+    entry = NewEntry(name, category);
+    if (entry == NULL) {
+        return;
+    }
+    if (clRetainEvent(event) != CL_SUCCESS) {
+        entry_count--;
+        dropped_count++;
+        return;
+    }
+    entry->event = event;
+    entry->queue = QueueIndex(queue);
+    entry->host_ms = BenchmarkNowMs();
+}
+
+void TraceRecordKernel(cl_event event, cl_command_queue queue, cl_kernel kernel,
+                       const char* category) {
+    char name[64];
+
+    if ((trace_enabled == 0) || (event == NULL)) {
+        return;
+    }
+    if ((kernel == NULL) || (clGetKernelInfo(kernel, CL_KERNEL_FUNCTION_NAME, sizeof(name), name,
+                                             NULL) != CL_SUCCESS)) {
+        (void)snprintf(name, sizeof(name), "kernel");
+    }
+    TraceRecordEvent(event, queue, name, category);
+}
+
+void TraceRecordHost(const char* name, const char* category, double start_ms, double end_ms) {
+    TraceEntry* entry;
+
+    if (trace_enabled == 0) {
+        return;
+    }
+    entry = NewEntry(name, category);
+    if (entry == NULL) {
+        return;
+    }
+    entry->host_ms = start_ms;
+    entry->end_ms = (end_ms > start_ms) ? end_ms : start_ms;
+}
+
+/* Write a string with JSON escaping */
+static void WriteJsonString(FILE* fp, const char* text) {
+    const char* c;
+
+    (void)fputc('"', fp);
+    for (c = text; *c != '\0'; c++) {
+        if ((*c == '"') || (*c == '\\')) {
+            (void)fputc('\\', fp);
+            (void)fputc(*c, fp);
+        } else if ((unsigned char)*c < 0x20U) {
+            (void)fputc(' ', fp);
+        } else {
+            (void)fputc(*c, fp);
+        }
+    }
+    (void)fputc('"', fp);
+}
+
+/* Common head of a trace event: name, category, phase, process and thread */
+static void WriteEventHead(FILE* fp, int* first, const char* name, const char* category,
+                           char phase, int pid, int tid) {
+    (void)fprintf(fp, "%s\n{\"name\":", (*first != 0) ? "" : ",");
+    *first = 0;
+    WriteJsonString(fp, name);
+    (void)fprintf(fp, ",\"cat\":");
+    WriteJsonString(fp, category);
+    (void)fprintf(fp, ",\"ph\":\"%c\",\"pid\":%d,\"tid\":%d", phase, pid, tid);
+}
+
+/* Metadata event naming a process (tid < 0) or a thread */
+static void WriteName(FILE* fp, int* first, int pid, int tid, const char* name) {
+    (void)fprintf(fp, "%s\n{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+                  (*first != 0) ? "" : ",", (tid < 0) ? "process_name" : "thread_name", pid,
+                  (tid < 0) ? 0 : tid);
+    *first = 0;
+    WriteJsonString(fp, name);
+    (void)fprintf(fp, "}}");
+}
+
+/* Async span (begin/end pair) shown on its own row, for overlapping waits */
+static void WriteAsyncSpan(FILE* fp, int* first, const char* name, int tid, int id, double start_us,
+                           double end_us) {
+    WriteEventHead(fp, first, name, "wait", 'b', TRACE_PID_DEVICE, tid);
+    (void)fprintf(fp, ",\"id\":%d,\"ts\":%.3f}", id, start_us);
+    WriteEventHead(fp, first, name, "wait", 'e', TRACE_PID_DEVICE, tid);
+    (void)fprintf(fp, ",\"id\":%d,\"ts\":%.3f}", id, end_us);
+}
+
+/* Read the four profiling timestamps of every device entry */
+static void ReadStamps(void) {
+    static const cl_profiling_info kinds[TRACE_STAMP_COUNT] = {
+        CL_PROFILING_COMMAND_QUEUED, CL_PROFILING_COMMAND_SUBMIT, CL_PROFILING_COMMAND_START,
+        CL_PROFILING_COMMAND_END};
+    int i;
+    int k;
+
+    for (i = 0; i < entry_count; i++) {
+        stamps_valid[i] = 0;
+        if (entries[i].event == NULL) {
+            continue;
+        }
+        stamps_valid[i] = 1;
+        for (k = 0; k < TRACE_STAMP_COUNT; k++) {
+            if (clGetEventProfilingInfo(entries[i].event, kinds[k], sizeof(cl_ulong),
+                                        &stamps[i][k], NULL) != CL_SUCCESS) {
+                stamps_valid[i] = 0;
+                break;
+            }
+        }
+    }
+}
+
+int TraceWrite(const char* path) {
+    FILE* fp;
+    char label[64];
+    double offset_ms = 0.0;
+    double base_ms = 0.0;
+    double delta;
+    double us[TRACE_STAMP_COUNT];
+    int have_offset = 0;
+    int have_base = 0;
+    int first = 1;
+    int skipped = 0;
+    int i;
+    int k;
+
+    if (path == NULL) {
+        return -1;
+    }
+
+    ReadStamps();
+
+    /* Device-to-host clock offset: the tightest host-after-enqueue vs QUEUED pair */
+    for (i = 0; i < entry_count; i++) {
+        if (stamps_valid[i] != 0) {
+            delta = entries[i].host_ms - ((double)stamps[i][TRACE_STAMP_QUEUED] / 1.0e6);
+            if ((have_offset == 0) || (delta < offset_ms)) {
+                offset_ms = delta;
+                have_offset = 1;
+            }
+        }
+    }
+    /* Trace starts at the earliest event */
+    for (i = 0; i < entry_count; i++) {
+        if (stamps_valid[i] != 0) {
+            delta = ((double)stamps[i][TRACE_STAMP_QUEUED] / 1.0e6) + offset_ms;
+        } else if (entries[i].event == NULL) {
+            delta = entries[i].host_ms;
+        } else {
+            continue;
+        }
+        if ((have_base == 0) || (delta < base_ms)) {
+            base_ms = delta;
+            have_base = 1;
+        }
+    }
+
+    fp = fopen(path, "w");
+    if (fp == NULL) {
+        (void)fprintf(stderr, "Error: Failed to create trace file %s\n", path);
+        return -1;
+    }
+
+    (void)fprintf(fp, "{\"traceEvents\":[");
+    WriteName(fp, &first, TRACE_PID_HOST, -1, "host");
+    WriteName(fp, &first, TRACE_PID_HOST, 0, "host thread");
+    WriteName(fp, &first, TRACE_PID_DEVICE, -1, "device");
+    for (i = 0; i < queue_count; i++) {
+        (void)snprintf(label, sizeof(label), "queue %d", i);
+        WriteName(fp, &first, TRACE_PID_DEVICE, (2 * i) + 1, label);
+        (void)snprintf(label, sizeof(label), "queue %d wait", i);
+        WriteName(fp, &first, TRACE_PID_DEVICE, (2 * i) + 2, label);
+    }
+
+    for (i = 0; i < entry_count; i++) {
+        if (entries[i].event == NULL) {
+            WriteEventHead(fp, &first, entries[i].name, entries[i].category, 'X', TRACE_PID_HOST,
+                           0);
+            (void)fprintf(fp, ",\"ts\":%.3f,\"dur\":%.3f}",
+                          (entries[i].host_ms - base_ms) * 1000.0,
+                          (entries[i].end_ms - entries[i].host_ms) * 1000.0);
+            continue;
+        }
+        if (stamps_valid[i] == 0) {
+            skipped++;
+            continue;
+        }
+        for (k = 0; k < TRACE_STAMP_COUNT; k++) {
+            us[k] = (((double)stamps[i][k] / 1.0e6) + offset_ms - base_ms) * 1000.0;
+        }
+
+        /* Execution on the queue's track, raw device timestamps in args */
+        WriteEventHead(fp, &first, entries[i].name, entries[i].category, 'X', TRACE_PID_DEVICE,
+                       (2 * entries[i].queue) + 1);
+        (void)fprintf(fp,
+                      ",\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"queued_ns\":%llu,"
+                      "\"submit_ns\":%llu,\"start_ns\":%llu,\"end_ns\":%llu}}",
+                      us[TRACE_STAMP_START], us[TRACE_STAMP_END] - us[TRACE_STAMP_START],
+                      (unsigned long long)stamps[i][TRACE_STAMP_QUEUED],
+                      (unsigned long long)stamps[i][TRACE_STAMP_SUBMIT],
+                      (unsigned long long)stamps[i][TRACE_STAMP_START],
+                      (unsigned long long)stamps[i][TRACE_STAMP_END]);
+
+        /* Waiting time: host-side queueing, then submitted but not yet running */
+        if (us[TRACE_STAMP_SUBMIT] > us[TRACE_STAMP_QUEUED]) {
+            (void)snprintf(label, sizeof(label), "queued: %.40s", entries[i].name);
+            WriteAsyncSpan(fp, &first, label, (2 * entries[i].queue) + 2, (2 * i) + 1,
+                           us[TRACE_STAMP_QUEUED], us[TRACE_STAMP_SUBMIT]);
+        }
+        if (us[TRACE_STAMP_START] > us[TRACE_STAMP_SUBMIT]) {
+            (void)snprintf(label, sizeof(label), "submitted: %.37s", entries[i].name);
+            WriteAsyncSpan(fp, &first, label, (2 * entries[i].queue) + 2, (2 * i) + 2,
+                           us[TRACE_STAMP_SUBMIT], us[TRACE_STAMP_START]);
+        }
+    }
+
+    (void)fprintf(fp,
+                  "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":%d,"
+                  "\"skipped_events\":%d,\"clock_offset_ms\":%.6f}}\n",
+                  dropped_count, skipped, offset_ms);
+
+    if (fclose(fp) != 0) {
+        (void)fprintf(stderr, "Error: Failed to write trace file %s\n", path);
+        return -1;
+    }
+
+    (void)printf("Trace saved to: %s (%d events", path, entry_count - skipped);
+    if ((dropped_count > 0) || (skipped > 0)) {
+        (void)printf(", %d dropped, %d without profiling info", dropped_count, skipped);
+    }
+    (void)printf(")\n");
+    return 0;
+}
+
+void TraceReset(void) {
+    int i;
+
+    for (i = 0; i < entry_count; i++) {
+        if (entries[i].event != NULL) {
+            (void)clReleaseEvent(entries[i].event);
+            entries[i].event = NULL;
+        }
+    }
+    entry_count = 0;
+    dropped_count = 0;
+    queue_count = 0;
+}
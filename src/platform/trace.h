@@ -0,0 +1,114 @@
+/**
+ * @file trace.h
+ * @brief Event timeline trace export (Chrome trace format)
+ *
+ * When enabled, every enqueue made through the platform layer (kernels on
+ * any queue, buffer writes and reads, the custom CL extension calls) hands
+ * its cl_event to the trace, and host-side work (program build, buffer
+ * creation, map/unmap transfers, the C reference, verification) is recorded
+ * as host spans. TraceWrite() reads the QUEUED/SUBMIT/START/END profiling
+ * timestamps of all recorded events and writes a trace.json that opens in
+ * chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Layout: process "host" holds the host spans; process "device" holds two
+ * tracks per command queue, one with the execution (START..END) of each
+ * command and one with its waiting time (QUEUED..SUBMIT, SUBMIT..START).
+ * Gaps on an execution track are idle device time; long waits show queue
+ * stalls behind transfers or dependencies.
+ *
+ * Clock alignment: device timestamps are on the device clock. They are
+ * shifted onto the host clock by the smallest observed difference between
+ * the host time just after an enqueue returned and its QUEUED timestamp,
+ * so host and device tracks line up to within the enqueue call overhead.
+ *
+ * Events are retained until TraceReset(); recording is for the host thread
+ * only (C reference worker threads are covered by the enclosing span).
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: No dynamic memory allocation (static event table)
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#pragma once
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+/** Maximum events (device and host) recorded per trace; later ones are counted as dropped */
+#define MAX_TRACE_EVENTS 8192
+
+/** Maximum distinct command queues tracked */
+#define MAX_TRACE_QUEUES 8
+
+/**
+ * @brief Enable or disable recording
+ *
+ * Disabling does not discard events already recorded.
+ *
+ * @param[in] enabled Non-zero to record
+ */
+void TraceEnable(int enabled);
+
+/**
+ * @brief Check whether recording is enabled
+ *
+ * Callers use this to decide whether to request an event from an
+ * otherwise event-less enqueue.
+ *
+ * @return Non-zero if enabled
+ */
+int TraceEnabled(void);
+
+/**
+ * @brief Record a device command
+ *
+ * The event is retained, so the caller keeps (and releases) its own
+ * reference. Timestamps are read in TraceWrite(), when the command is done.
+ *
+ * @param[in] event Event of the enqueued command (NULL is ignored)
+ * @param[in] queue Queue the command was enqueued on
+ * @param[in] name Command name (e.g., "write input")
+ * @param[in] category Trace category (e.g., "transfer")
+ */
+void TraceRecordEvent(cl_event event, cl_command_queue queue, const char* name,
+                      const char* category);
+
+/**
+ * @brief Record a kernel launch, named after the kernel function
+ *
+ * @param[in] event Event of the launch (NULL is ignored)
+ * @param[in] queue Queue the kernel was enqueued on
+ * @param[in] kernel Kernel object
+ * @param[in] category Trace category (e.g., "kernel")
+ */
+void TraceRecordKernel(cl_event event, cl_command_queue queue, cl_kernel kernel,
+                       const char* category);
+
+/**
+ * @brief Record a host span
+ *
+ * @param[in] name Span name
+ * @param[in] category Trace category
+ * @param[in] start_ms Start time from BenchmarkNowMs()
+ * @param[in] end_ms End time from BenchmarkNowMs()
+ */
+void TraceRecordHost(const char* name, const char* category, double start_ms, double end_ms);
+
+/**
+ * @brief Write the recorded events as a Chrome trace JSON file
+ *
+ * All recorded commands must have completed (e.g., after clFinish).
+ * Commands whose profiling info cannot be read are skipped.
+ *
+ * @param[in] path Output file path
+ * @return 0 on success, -1 on error
+ */
+int TraceWrite(const char* path);
+
+/**
+ * @brief Release the retained events and clear the trace
+ */
+void TraceReset(void);
@@ -0,0 +1,431 @@
+/**
+ * @file precompile.c
+ * @brief Offline kernel pre-compilation tool
+ *
+ * Walks every algorithm config in config/ (or a given directory), compiles
+ * all distinct kernel programs for the selected device and stores the
+ * binaries in the out/<algo>/ kernel cache under the same build key that
+ * OpenclBuildKernel() looks up. Run at deploy time so the first run of
+ * opencl_host never pays for JIT compilation.
+ *
+ * Programs are built in parallel: worker threads each issue clBuildProgram()
+ * with a completion callback and wait for it before taking the next job.
+ * Source preparation and binary saving stay on the main thread because they
+ * use the static buffers of opencl_utils/cache_manager.
+ *
+ * --export DIR additionally copies the binary of every variant to
+ * DIR/<op_id>/cache/<variant_id>.bin, the layout the binary-only Android
+ * runtime (android_runner.h) loads without source or build key.
+ *
+ * Usage: opencl_precompile [--jobs N] [--force] [--export DIR] [config_dir]
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Static job table, no dynamic memory allocation
+ * - Rule 17.7: All OpenCL API return values checked
+ */
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "platform/cache_manager.h"
+#include "platform/opencl_utils.h"
+#include "utils/config.h"
+#include "utils/safe_ops.h"
+
+/** Maximum number of distinct programs compiled per invocation */
+#define MAX_PRECOMPILE_JOBS 128
+
+/** Maximum number of build threads */
+#define MAX_PRECOMPILE_THREADS 16
+
+/** Maximum number of variant binaries exported per invocation */
+#define MAX_EXPORT_ENTRIES 256
+
+/** Default number of build threads */
+#define DEFAULT_PRECOMPILE_THREADS 4
+
+#define MAX_PATH_LENGTH 512
+#define MAX_BUILD_LOG_SIZE (16 * 1024)
+#define DEFAULT_CONFIG_DIR "config"
+
+/** One program to compile */
+typedef struct {
+    char algorithm_id[32];   /**< Cache directory (config op_id) */
+    char kernel_file[256];   /**< Kernel source file */
+    char build_options[768]; /**< Complete build options */
+    char keyed_name[288];    /**< Cache name (file base + build key) */
+    cl_program program;      /**< Program created from source */
+    int done;                /**< Set by build callback */
+    cl_int build_err;        /**< clBuildProgram return value */
+} PrecompileJob;
+
+/** One variant binary to export */
+typedef struct {
+    char algorithm_id[32]; /**< Cache directory (config op_id) */
+    char variant_id[32];   /**< Variant identifier (export file name) */
+    char keyed_name[288];  /**< Cache name of the variant's program */
+} ExportEntry;
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static PrecompileJob jobs[MAX_PRECOMPILE_JOBS];
+static int job_count = 0;
+static ExportEntry exports[MAX_EXPORT_ENTRIES];
+static int export_count = 0;
+static int next_job = 0;
+static Config config;
+static OpenCLEnv env;
+static pthread_t threads[MAX_PRECOMPILE_THREADS];
+static char build_log_buffer[MAX_BUILD_LOG_SIZE];
+
+static pthread_mutex_t job_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_done_cond = PTHREAD_COND_INITIALIZER;
+
+/* Config files in the config directory that are not algorithm configs */
+static int IsAlgorithmConfig(const char* name) {
+    size_t len = strlen(name);
+
+    if ((len <= 5U) || (strcmp(name + len - 5U, ".json") != 0)) {
+        return 0;
+    }
+    if ((strcmp(name, "inputs.json") == 0) || (strcmp(name, "outputs.json") == 0) ||
+        (strcmp(name, "template.json") == 0)) {
+        return 0;
+    }
+    return 1;
+}
+
+static int FindJob(const char* algorithm_id, const char* keyed_name) {
+    int i;
+
+    for (i = 0; i < job_count; i++) {
+        if ((strcmp(jobs[i].algorithm_id, algorithm_id) == 0) &&
+            (strcmp(jobs[i].keyed_name, keyed_name) == 0)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Queue every distinct program of one config; returns number of kernels skipped on error */
+static int CollectJobs(const char* config_path, int force, int export_variants) {
+    const char* source;
+    size_t source_length;
+    char build_options[768];
+    char keyed_name[288];
+    PrecompileJob* job;
+    cl_int err;
+    int errors = 0;
+    int i;
+
+    (void)memset(&config, 0, sizeof(config));
+    if (ParseConfig(config_path, &config) != 0) {
+        (void)fprintf(stderr, "Warning: Failed to parse %s, skipping\n", config_path);
+        return 1;
+    }
+    if ((config.op_id[0] == '\0') || (strcmp(config.op_id, "config") == 0)) {
+        if (ExtractOpIdFromPath(config_path, config.op_id, sizeof(config.op_id)) != 0) {
+            return 1;
+        }
+    }
+
+    for (i = 0; i < config.num_kernels; i++) {
+        KernelConfig* kernel_cfg = &config.kernels[i];
+
+        /* Same build options as the runner on this device (fp16 fallback) */
+        OpenclResolvePrecision(&env, kernel_cfg);
+
+        if ((OpenclComposeBuildOptions(kernel_cfg, build_options, sizeof(build_options)) != 0) ||
+            (OpenclPrepareProgramSource(&env, kernel_cfg->kernel_file, build_options,
+                                        kernel_cfg->host_type, &source, &source_length,
+                                        keyed_name, sizeof(keyed_name)) != 0)) {
+            (void)fprintf(stderr, "Error: %s variant %s: cannot prepare %s\n", config.op_id,
+                          kernel_cfg->variant_id, kernel_cfg->kernel_file);
+            errors++;
+            continue;
+        }
+
+        if (export_variants != 0) {
+            if (export_count < MAX_EXPORT_ENTRIES) {
+                ExportEntry* entry = &exports[export_count];
+                (void)snprintf(entry->algorithm_id, sizeof(entry->algorithm_id), "%s",
+                               config.op_id);
+                (void)snprintf(entry->variant_id, sizeof(entry->variant_id), "%s",
+                               kernel_cfg->variant_id);
+                (void)snprintf(entry->keyed_name, sizeof(entry->keyed_name), "%s", keyed_name);
+                export_count++;
+            } else {
+                (void)fprintf(stderr, "Error: Too many variants to export (max %d)\n",
+                              MAX_EXPORT_ENTRIES);
+                errors++;
+            }
+        }
+
+        if (FindJob(config.op_id, keyed_name) >= 0) {
+            continue;
+        }
+        if ((force == 0) && (CacheKernelExists(config.op_id, keyed_name) != 0)) {
+            (void)printf("  [cached]  %s/%s\n", config.op_id, keyed_name);
+            continue;
+        }
+        if (job_count >= MAX_PRECOMPILE_JOBS) {
+            (void)fprintf(stderr, "Error: Too many programs (max %d)\n", MAX_PRECOMPILE_JOBS);
+            errors++;
+            break;
+        }
+
+        /* clCreateProgramWithSource copies the source, so the static buffer can be reused */
+        job = &jobs[job_count];
+        (void)memset(job, 0, sizeof(*job));
+        job->program = clCreateProgramWithSource(env.context, 1U, &source, &source_length, &err);
+        if (err != CL_SUCCESS) {
+            (void)fprintf(stderr, "Error: Failed to create program for %s (error code: %d)\n",
+                          kernel_cfg->kernel_file, err);
+            errors++;
+            continue;
+        }
+        (void)snprintf(job->algorithm_id, sizeof(job->algorithm_id), "%s", config.op_id);
+        (void)snprintf(job->kernel_file, sizeof(job->kernel_file), "%s", kernel_cfg->kernel_file);
+        (void)snprintf(job->build_options, sizeof(job->build_options), "%s", build_options);
+        (void)snprintf(job->keyed_name, sizeof(job->keyed_name), "%s", keyed_name);
+        job_count++;
+    }
+    return errors;
+}
+
+/* Build completion callback (may run on a driver thread) */
+static void CL_CALLBACK BuildNotify(cl_program program, void* user_data) {
+    PrecompileJob* job = (PrecompileJob*)user_data;
+
+    (void)program;
+    (void)pthread_mutex_lock(&job_mutex);
+    job->done = 1;
+    (void)pthread_cond_broadcast(&job_done_cond);
+    (void)pthread_mutex_unlock(&job_mutex);
+}
+
+static void* BuildWorker(void* arg) {
+    PrecompileJob* job;
+    cl_int err;
+
+    (void)arg;
+    for (;;) {
+        (void)pthread_mutex_lock(&job_mutex);
+        if (next_job >= job_count) {
+            (void)pthread_mutex_unlock(&job_mutex);
+            break;
+        }
+        job = &jobs[next_job];
+        next_job++;
+        (void)pthread_mutex_unlock(&job_mutex);
+
+        err = clBuildProgram(job->program, 1U, &env.device, job->build_options, BuildNotify, job);
+
+        (void)pthread_mutex_lock(&job_mutex);
+        job->build_err = err;
+        if (err != CL_SUCCESS) {
+            /* Immediate failure: the callback is not guaranteed to fire */
+            job->done = 1;
+        }
+        while (job->done == 0) {
+            (void)pthread_cond_wait(&job_done_cond, &job_mutex);
+        }
+        (void)pthread_mutex_unlock(&job_mutex);
+    }
+    return NULL;
+}
+
+/* Check build status, print log on failure, save binary on success */
+static int FinishJob(PrecompileJob* job) {
+    cl_build_status status = CL_BUILD_ERROR;
+    size_t log_size = 0U;
+    cl_int err;
+    int result = -1;
+
+    if (job->build_err == CL_SUCCESS) {
+        err = clGetProgramBuildInfo(job->program, env.device, CL_PROGRAM_BUILD_STATUS,
+                                    sizeof(status), &status, NULL);
+        if (err != CL_SUCCESS) {
+            status = CL_BUILD_ERROR;
+        }
+    }
+
+    if (status == CL_BUILD_SUCCESS) {
+        if (CacheSaveKernelBinary(job->program, env.device, job->algorithm_id, job->keyed_name) ==
+            0) {
+            (void)printf("  [built]   %s/%s (%s)\n", job->algorithm_id, job->keyed_name,
+                         job->kernel_file);
+            result = 0;
+        } else {
+            (void)fprintf(stderr, "Error: Failed to cache %s/%s\n", job->algorithm_id,
+                          job->keyed_name);
+        }
+    } else {
+        (void)fprintf(stderr, "  [failed]  %s/%s (%s, error code: %d)\n", job->algorithm_id,
+                      job->keyed_name, job->kernel_file, job->build_err);
+        err = clGetProgramBuildInfo(job->program, env.device, CL_PROGRAM_BUILD_LOG, 0U, NULL,
+                                    &log_size);
+        if ((err == CL_SUCCESS) && (log_size > 1U) && (log_size <= MAX_BUILD_LOG_SIZE)) {
+            err = clGetProgramBuildInfo(job->program, env.device, CL_PROGRAM_BUILD_LOG, log_size,
+                                        build_log_buffer, NULL);
+            if (err == CL_SUCCESS) {
+                (void)fprintf(stderr, "Build log:\n%s\n", build_log_buffer);
+            }
+        }
+    }
+
+    /* MISRA-C:2023 Rule 17.7: Check return value */
+    err = clReleaseProgram(job->program);
+    if (err != CL_SUCCESS) {
+        (void)fprintf(stderr, "Warning: Failed to release program (error: %d)\n", err);
+    }
+    job->program = NULL;
+    return result;
+}
+
+/* Copy one variant binary to <dir>/<op_id>/cache/<variant_id>.bin */
+static int ExportVariant(const char* export_dir, const ExportEntry* entry) {
+    char path[MAX_PATH_LENGTH];
+    int result;
+
+    /* MISRA-C:2023 Rule 17.7: mkdir fails if the directory exists, which is okay */
+    (void)mkdir(export_dir, 0755);
+    (void)snprintf(path, sizeof(path), "%s/%s", export_dir, entry->algorithm_id);
+    (void)mkdir(path, 0755);
+    (void)snprintf(path, sizeof(path), "%s/%s/cache", export_dir, entry->algorithm_id);
+    (void)mkdir(path, 0755);
+
+    result = snprintf(path, sizeof(path), "%s/%s/cache/%s.bin", export_dir, entry->algorithm_id,
+                      entry->variant_id);
+    if ((result < 0) || ((size_t)result >= sizeof(path)) ||
+        (CacheExportKernelBinary(entry->algorithm_id, entry->keyed_name, path) != 0)) {
+        (void)fprintf(stderr, "  [failed]  export %s %s\n", entry->algorithm_id,
+                      entry->variant_id);
+        return -1;
+    }
+    (void)printf("  [export]  %s\n", path);
+    return 0;
+}
+
+static void PrintUsage(FILE* stream, const char* prog) {
+    (void)fprintf(stream, "Usage: %s [--jobs N] [--force] [--export DIR] [config_dir]\n",
+                  prog);
+    (void)fprintf(stream, "  --jobs N   Parallel build threads (1-%d, default %d)\n",
+                  MAX_PRECOMPILE_THREADS, DEFAULT_PRECOMPILE_THREADS);
+    (void)fprintf(stream, "  --force    Rebuild programs that are already cached\n");
+    (void)fprintf(stream, "  --export DIR\n");
+    (void)fprintf(stream, "             Write variant binaries to DIR/<op>/cache/<variant>.bin\n");
+    (void)fprintf(stream, "  config_dir Directory of algorithm configs (default: %s)\n",
+                  DEFAULT_CONFIG_DIR);
+}
+
+int main(int argc, char** argv) {
+    const char* config_dir = DEFAULT_CONFIG_DIR;
+    const char* export_dir = NULL;
+    char config_path[MAX_PATH_LENGTH];
+    int thread_count = DEFAULT_PRECOMPILE_THREADS;
+    int force = 0;
+    int have_dir = 0;
+    int errors = 0;
+    int started = 0;
+    long temp_long;
+    DIR* dir;
+    struct dirent* entry;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--jobs") == 0) && ((i + 1) < argc)) {
+            i++;
+            if (!SafeStrtol(argv[i], &temp_long) || (temp_long < 1) ||
+                (temp_long > MAX_PRECOMPILE_THREADS)) {
+                (void)fprintf(stderr, "Error: --jobs requires an integer in [1, %d]\n",
+                              MAX_PRECOMPILE_THREADS);
+                return 1;
+            }
+            thread_count = (int)temp_long;
+        } else if (strcmp(argv[i], "--force") == 0) {
+            force = 1;
+        } else if ((strcmp(argv[i], "--export") == 0) && ((i + 1) < argc)) {
+            i++;
+            export_dir = argv[i];
+        } else if ((strcmp(argv[i], "--help") == 0) || (strcmp(argv[i], "-h") == 0)) {
+            PrintUsage(stdout, argv[0]);
+            return 0;
+        } else if ((argv[i][0] != '-') && (have_dir == 0)) {
+            config_dir = argv[i];
+            have_dir = 1;
+        } else {
+            PrintUsage(stderr, argv[0]);
+            return 1;
+        }
+    }
+
+    if (OpenclInit(&env) != 0) {
+        (void)fprintf(stderr, "Failed to initialize OpenCL\n");
+        return 1;
+    }
+
+    /* 1. Collect distinct programs from every algorithm config */
+    dir = opendir(config_dir);
+    if (dir == NULL) {
+        (void)fprintf(stderr, "Error: Cannot open config directory %s\n", config_dir);
+        OpenclCleanup(&env);
+        return 1;
+    }
+    (void)printf("=== Collecting kernels from %s ===\n", config_dir);
+    entry = readdir(dir);
+    while (entry != NULL) {
+        if (IsAlgorithmConfig(entry->d_name) != 0) {
+            (void)snprintf(config_path, sizeof(config_path), "%s/%s", config_dir, entry->d_name);
+            errors += CollectJobs(config_path, force, (export_dir != NULL) ? 1 : 0);
+        }
+        entry = readdir(dir);
+    }
+    (void)closedir(dir);
+
+    /* 2. Build in parallel */
+    if (thread_count > job_count) {
+        thread_count = job_count;
+    }
+    (void)printf("=== Building %d program(s) on %s with %d thread(s) ===\n", job_count,
+                 env.device_name, thread_count);
+    for (i = 0; i < thread_count; i++) {
+        if (pthread_create(&threads[i], NULL, BuildWorker, NULL) != 0) {
+            (void)fprintf(stderr, "Warning: Failed to start build thread %d\n", i);
+            break;
+        }
+        started++;
+    }
+    if ((started == 0) && (job_count > 0)) {
+        /* No threads: build on the main thread */
+        (void)BuildWorker(NULL);
+    }
+    for (i = 0; i < started; i++) {
+        (void)pthread_join(threads[i], NULL);
+    }
+
+    /* 3. Save binaries to the kernel cache */
+    for (i = 0; i < job_count; i++) {
+        if (FinishJob(&jobs[i]) != 0) {
+            errors++;
+        }
+    }
+
+    /* 4. Per-variant binaries for the binary-only runtime */
+    if (export_dir != NULL) {
+        (void)printf("=== Exporting %d variant binary(ies) to %s ===\n", export_count,
+                     export_dir);
+        for (i = 0; i < export_count; i++) {
+            if (ExportVariant(export_dir, &exports[i]) != 0) {
+                errors++;
+            }
+        }
+    }
+
+    OpenclCleanup(&env);
+
+    (void)printf("=== Precompile done: %d program(s), %d error(s) ===\n", job_count, errors);
+    return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file benchmark.c
+ * @brief Latency statistics for multi-iteration benchmark runs
+ */
+
+#include "benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+/* Scratch copy of samples used for sorting (percentile computation) */
+static double sorted_samples[MAX_BENCHMARK_ITERATIONS];
+
+/* qsort comparator for ascending doubles */
+static int CompareDouble(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+
+    if (da < db) {
+        return -1;
+    }
+    if (da > db) {
+        return 1;
+    }
+    return 0;
+}
+
+/* Percentile with linear interpolation between closest ranks (p in [0, 100]) */
+static double Percentile(const double* sorted, int count, double p) {
+    double rank;
+    int lower;
+    double frac;
+
+    if (count == 1) {
+        return sorted[0];
+    }
+
+    rank = (p / 100.0) * (double)(count - 1);
+    lower = (int)rank;
+    if (lower >= (count - 1)) {
+        return sorted[count - 1];
+    }
+    frac = rank - (double)lower;
+    return sorted[lower] + (frac * (sorted[lower + 1] - sorted[lower]));
+}
+
+int BenchmarkComputeStats(const double* samples, int count, BenchmarkStats* stats) {
+    double sum = 0.0;
+    double sq_sum = 0.0;
+    double diff;
+    int i;
+
+    if ((samples == NULL) || (stats == NULL) || (count <= 0) ||
+        (count > MAX_BENCHMARK_ITERATIONS)) {
+        return -1;
+    }
+
+    (void)memcpy(sorted_samples, samples, (size_t)count * sizeof(double));
+    qsort(sorted_samples, (size_t)count, sizeof(double), CompareDouble);
+
+    for (i = 0; i < count; i++) {
+        sum += sorted_samples[i];
+    }
+
+    stats->count = count;
+    stats->min_ms = sorted_samples[0];
+    stats->max_ms = sorted_samples[count - 1];
+    stats->mean_ms = sum / (double)count;
+    stats->median_ms = Percentile(sorted_samples, count, 50.0);
+    stats->p95_ms = Percentile(sorted_samples, count, 95.0);
+    stats->p99_ms = Percentile(sorted_samples, count, 99.0);
+
+    for (i = 0; i < count; i++) {
+        diff = sorted_samples[i] - stats->mean_ms;
+        sq_sum += diff * diff;
+    }
+    stats->stddev_ms = sqrt(sq_sum / (double)count);
+
+    return 0;
+}
+
+double BenchmarkNowMs(void) {
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0.0;
+    }
+    return ((double)ts.tv_sec * 1000.0) + ((double)ts.tv_nsec / 1.0e6);
+}
+
+void BenchmarkPrintStats(const char* label, const BenchmarkStats* stats) {
+    if ((label == NULL) || (stats == NULL)) {
+        return;
+    }
+
+    (void)printf("%-9s min %8.3f | median %8.3f | p95 %8.3f | p99 %8.3f | stddev %7.3f ms\n",
+                 label, stats->min_ms, stats->median_ms, stats->p95_ms, stats->p99_ms,
+                 stats->stddev_ms);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file benchmark.h
+ * @brief Latency statistics for multi-iteration benchmark runs
+ *
+ * Provides summary statistics (min/median/percentiles/stddev) over a set of
+ * timing samples collected by the benchmark mode in algorithm_runner.c.
+ * Samples are typically OpenCL profiling durations in milliseconds.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Uses static scratch buffer for sorting, no dynamic allocation
+ * - Rule 17.7: All functions return status for error checking
+ */
+
+#pragma once
+
+/** Maximum number of timed iterations per benchmark run (static sample storage) */
+#define MAX_BENCHMARK_ITERATIONS 1000
+
+/** Default number of warmup iterations (not included in statistics) */
+#define BENCHMARK_DEFAULT_WARMUP 3
+
+/** Default number of timed iterations */
+#define BENCHMARK_DEFAULT_ITERATIONS 20
+
+/**
+ * @brief Summary statistics over a set of timing samples
+ *
+ * All values are in milliseconds. Percentiles use linear interpolation
+ * between the closest ranks of the sorted samples.
+ */
+typedef struct {
+    int count;        /**< Number of samples */
+    double min_ms;    /**< Minimum sample */
+    double max_ms;    /**< Maximum sample */
+    double mean_ms;   /**< Arithmetic mean */
+    double median_ms; /**< 50th percentile */
+    double p95_ms;    /**< 95th percentile */
+    double p99_ms;    /**< 99th percentile */
+    double stddev_ms; /**< Population standard deviation */
+} BenchmarkStats;
+
+/**
+ * @brief Benchmark result for one kernel variant
+ *
+ * Kernel, upload (host-to-device) and readback (device-to-host) timings
+ * are measured separately: the kernel from its profiling event, transfers
+ * on the host clock so every memory strategy is measured the same way.
+ */
+typedef struct {
+    int warmup_iterations;   /**< Warmup iterations executed (discarded) */
+    BenchmarkStats kernel;   /**< NDRange kernel execution time */
+    BenchmarkStats upload;   /**< Input host-to-device transfer time */
+    BenchmarkStats readback; /**< Output device-to-host transfer time (on-device verification:
+                                  compare launch plus its two-int result) */
+    int device_verified;     /**< Non-zero if every iteration was verified on the device */
+    int verify_failures;     /**< Iterations whose on-device verification failed */
+} BenchmarkResult;
+
+/**
+ * @brief Compute summary statistics over timing samples
+ *
+ * The input array is not modified (samples are sorted in a static copy).
+ *
+ * @param[in] samples Timing samples in milliseconds
+ * @param[in] count Number of samples (1 to MAX_BENCHMARK_ITERATIONS)
+ * @param[out] stats Computed statistics
+ * @return 0 on success, -1 on error
+ */
+int BenchmarkComputeStats(const double* samples, int count, BenchmarkStats* stats);
+
+/**
+ * @brief Monotonic host wall-clock time
+ *
+ * Used where no profiling event covers the measured work (e.g., map/unmap
+ * transfers plus the host-side copy of the zero-copy memory strategies).
+ *
+ * @return Milliseconds since an unspecified fixed point
+ */
+double BenchmarkNowMs(void);
+
+/**
+ * @brief Print one line of statistics with a label
+ *
+ * Format: "<label>: min X | median X | p95 X | p99 X | stddev X ms"
+ *
+ * @param[in] label Row label (e.g., "Kernel")
+ * @param[in] stats Statistics to print
+ */
+void BenchmarkPrintStats(const char* label, const BenchmarkStats* stats);
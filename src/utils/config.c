@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include "cJSON.h"
+#include "utils/benchmark.h"
 #include "utils/safe_ops.h"
 
 /* Maximum line length for config file */
@@ -105,6 +106,8 @@ static DataType ParseDataType(const char* str) {
         return DATA_TYPE_INT;
     } else if (strcmp(str, "short") == 0) {
         return DATA_TYPE_SHORT;
+    } else if (strcmp(str, "half") == 0) {
+        return DATA_TYPE_HALF;
     }
 
     return DATA_TYPE_NONE;
@@ -121,6 +124,8 @@ static size_t GetDataTypeSize(DataType type) {
             return sizeof(int);
         case DATA_TYPE_SHORT:
             return sizeof(short);
+        case DATA_TYPE_HALF:
+            return sizeof(unsigned short); /* cl_half bits */
         default:
             return 0;
     }
@@ -141,6 +146,20 @@ static HostType ParseHostType(const char* str) {
     return HOST_TYPE_CL_EXTENSION; /* Default to cl_extension */
 }
 
+/* Parse memory strategy from string (returns -1 for unknown names) */
+static int ParseMemoryStrategy(const char* str, MemoryStrategy* strategy) {
+    if (strcmp(str, "copy") == 0) {
+        *strategy = MEM_STRATEGY_COPY;
+    } else if (strcmp(str, "use_host_ptr") == 0) {
+        *strategy = MEM_STRATEGY_USE_HOST_PTR;
+    } else if (strcmp(str, "alloc_host_ptr") == 0) {
+        *strategy = MEM_STRATEGY_ALLOC_HOST_PTR;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
 /* Parse buffer type from string */
 static BufferType ParseBufferType(const char* str) {
     if (str == NULL) {
@@ -187,6 +206,12 @@ static KernelArgType ParseKernelArgKey(const char* key) {
         return KERNEL_ARG_TYPE_BUFFER_OUTPUT;
     } else if (strcmp(key, "buffer") == 0) {
         return KERNEL_ARG_TYPE_BUFFER_CUSTOM;
+    } else if (strcmp(key, "i_image") == 0) {
+        return KERNEL_ARG_TYPE_IMAGE_INPUT;
+    } else if (strcmp(key, "o_image") == 0) {
+        return KERNEL_ARG_TYPE_IMAGE_OUTPUT;
+    } else if (strcmp(key, "sampler") == 0) {
+        return KERNEL_ARG_TYPE_SAMPLER;
     } else if (strcmp(key, "param") == 0) {
         /* param type will be determined by data_type in array */
         return KERNEL_ARG_TYPE_SCALAR_INT; /* placeholder, will be updated */
@@ -212,8 +237,31 @@ static KernelArgType GetScalarArgType(const char* data_type_str) {
     return KERNEL_ARG_TYPE_NONE;
 }
 
-/* Evaluate simple arithmetic expression (e.g., "1920 * 1080 * 4") */
-static int EvalExpression(const char* str, size_t* result) {
+/* Value of an image field named in a size expression (src_width, ...) */
+static int ImageFieldValue(const char* name, const InputImageConfig* image, long* value) {
+    if (image == NULL) {
+        return -1;
+    }
+    if (strcmp(name, "src_width") == 0) {
+        *value = (long)image->src_width;
+    } else if (strcmp(name, "src_height") == 0) {
+        *value = (long)image->src_height;
+    } else if (strcmp(name, "src_channels") == 0) {
+        *value = (image->src_channels > 0) ? (long)image->src_channels : 1L;
+    } else if (strcmp(name, "src_stride") == 0) {
+        *value = (long)image->src_stride;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Evaluate simple arithmetic expression (e.g., "1920 * 1080 * 4"). With an
+ * image, the operands may also name its fields ("src_width * src_height * 4").
+ */
+static int EvalExpressionWithImage(const char* str, const InputImageConfig* image,
+                                   size_t* result) {
     char buffer[MAX_BUFFER_LENGTH];
     char* saveptr = NULL;
     char* token;
@@ -239,8 +287,10 @@ static int EvalExpression(const char* str, size_t* result) {
         } else if (strcmp(token, "-") == 0) {
             operation = '-';
         } else {
-            /* Try to parse as number */
-            if (!SafeStrtol(token, &temp_val) || (temp_val < 0)) {
+            /* Try to parse as number, then as an image field */
+            if ((!SafeStrtol(token, &temp_val) &&
+                 (ImageFieldValue(token, image, &temp_val) != 0)) ||
+                (temp_val < 0)) {
                 return -1;
             }
 
@@ -276,6 +326,25 @@ static int EvalExpression(const char* str, size_t* result) {
     return 0;
 }
 
+static int EvalExpression(const char* str, size_t* result) {
+    return EvalExpressionWithImage(str, NULL, result);
+}
+
+/* Input image the config reads: input_image_id, else the first one (NULL if none parsed) */
+static const InputImageConfig* SelectedInputImage(const Config* config) {
+    int i;
+
+    if (config->input_image_count == 0) {
+        return NULL;
+    }
+    for (i = 0; (config->input_image_id[0] != '\0') && (i < config->input_image_count); i++) {
+        if (strcmp(config->input_images[i].name, config->input_image_id) == 0) {
+            return &config->input_images[i];
+        }
+    }
+    return &config->input_images[0];
+}
+
 /* Helper to get integer from JSON (supports both number and string expression) */
 static int GetJsonInt(const cJSON* json, const char* key, int* value) {
     cJSON* item = cJSON_GetObjectItemCaseSensitive(json, key);
@@ -338,6 +407,165 @@ static int GetJsonFloat(const cJSON* json, const char* key, float* value) {
     return -1;
 }
 
+/* Helper to get boolean from JSON (accepts true/false or 0/1) */
+static int GetJsonBool(const cJSON* json, const char* key, int* value) {
+    cJSON* item = cJSON_GetObjectItemCaseSensitive(json, key);
+    if (item == NULL) {
+        return -1;
+    }
+
+    if (cJSON_IsBool(item)) {
+        *value = cJSON_IsTrue(item) ? 1 : 0;
+        return 0;
+    } else if (cJSON_IsNumber(item)) {
+        *value = (item->valueint != 0) ? 1 : 0;
+        return 0;
+    }
+    return -1;
+}
+
+/**
+ * @brief Parse a "tolerance": a number (absolute) or {"abs", "rel", "ulp"}
+ *
+ * @param[in] item Tolerance item (NULL leaves @p out disabled)
+ * @param[in] owner Output or variant name for error messages
+ * @param[out] out Tolerances
+ * @return 0 on success, -1 on error
+ */
+static int ParseTolerance(const cJSON* item, const char* owner, ToleranceOverride* out) {
+    (void)memset(out, 0, sizeof(*out));
+    if (item == NULL) {
+        return 0;
+    }
+    out->enabled = 1;
+    if (cJSON_IsNumber(item)) {
+        out->tolerance = (float)item->valuedouble;
+    } else if (cJSON_IsObject(item)) {
+        (void)GetJsonFloat(item, "abs", &out->tolerance);
+        (void)GetJsonFloat(item, "rel", &out->rel_tolerance);
+        (void)GetJsonInt(item, "ulp", &out->ulp_tolerance);
+    } else {
+        (void)fprintf(stderr, "Error: %s tolerance must be a number or an object\n", owner);
+        return -1;
+    }
+    if ((out->tolerance < 0.0f) || (out->rel_tolerance < 0.0f) || (out->ulp_tolerance < 0)) {
+        (void)fprintf(stderr, "Error: %s tolerances must be >= 0\n", owner);
+        return -1;
+    }
+    return 0;
+}
+
+/* Parse a kernel precision name; -1 if unknown */
+static int ParseKernelPrecision(const char* str, KernelPrecision* precision) {
+    if (strcmp(str, "fp32") == 0) {
+        *precision = KERNEL_PRECISION_FP32;
+    } else if (strcmp(str, "fp16") == 0) {
+        *precision = KERNEL_PRECISION_FP16;
+    } else if (strcmp(str, "int") == 0) {
+        *precision = KERNEL_PRECISION_INT;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+int ParseMultiDeviceSplit(const char* str, MultiDeviceSplit* split) {
+    if (strcmp(str, "rows") == 0) {
+        *split = MULTI_SPLIT_ROWS;
+    } else if (strcmp(str, "frames") == 0) {
+        *split = MULTI_SPLIT_FRAMES;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse a kernel's optional "tiling" object
+ *
+ * @param[in] item "tiling" JSON object (NULL leaves the dispatch untiled)
+ * @param[in,out] kc Kernel configuration (host_type and work_dim already parsed)
+ * @return 0 on success, -1 on invalid settings
+ */
+static int ParseTilingJson(const cJSON* item, KernelConfig* kc) {
+    const cJSON* size;
+    const cJSON* dim;
+    char order_str[32] = "row_major";
+    int idx = 0;
+
+    kc->tiling.tile_size[0] = 0U;
+    kc->tiling.tile_size[1] = 0U;
+    kc->tiling.order = TILE_ORDER_ROW_MAJOR;
+    kc->tiling.queues = 1;
+    if (item == NULL) {
+        return 0;
+    }
+    if (!cJSON_IsObject(item) || (kc->host_type != HOST_TYPE_CL_EXTENSION)) {
+        (void)fprintf(stderr, "Error: Kernel '%s' tiling must be an object and needs host_type "
+                              "cl_extension\n", kc->variant_id);
+        return -1;
+    }
+
+    size = cJSON_GetObjectItemCaseSensitive(item, "tile_size");
+    if (size != NULL) {
+        cJSON_ArrayForEach(dim, size) {
+            if ((idx >= 2) || !cJSON_IsNumber(dim) || (dim->valuedouble < 0.0)) {
+                (void)fprintf(stderr, "Error: Kernel '%s' tile_size must be 1-2 numbers >= 0\n",
+                              kc->variant_id);
+                return -1;
+            }
+            kc->tiling.tile_size[idx] = (size_t)dim->valuedouble;
+            idx++;
+        }
+    }
+
+    (void)GetJsonString(item, "order", order_str, sizeof(order_str));
+    if (strcmp(order_str, "z_order") == 0) {
+        kc->tiling.order = TILE_ORDER_Z_ORDER;
+    } else if (strcmp(order_str, "row_major") != 0) {
+        (void)fprintf(stderr, "Error: Kernel '%s' has invalid tiling order '%s' "
+                              "(expected row_major or z_order)\n", kc->variant_id, order_str);
+        return -1;
+    }
+
+    (void)GetJsonInt(item, "queues", &kc->tiling.queues);
+    if ((kc->tiling.queues < 1) || (kc->tiling.queues > MAX_TILE_QUEUES)) {
+        (void)fprintf(stderr, "Error: Kernel '%s' tiling queues must be 1-%d\n", kc->variant_id,
+                      MAX_TILE_QUEUES);
+        return -1;
+    }
+    return 0;
+}
+
+/* Check whether a kernel argument reads scalar @p name (directly or as a struct field) */
+static int KernelArgUsesScalar(const KernelArgDescriptor* arg, const char* name) {
+    int i;
+
+    if (arg->arg_type == KERNEL_ARG_TYPE_STRUCT) {
+        for (i = 0; i < arg->struct_field_count; i++) {
+            if (strcmp(arg->struct_fields[i], name) == 0) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+    return ((arg->arg_type >= KERNEL_ARG_TYPE_SCALAR_INT) &&
+            (arg->arg_type <= KERNEL_ARG_TYPE_SCALAR_SIZE) && (strcmp(arg->source_name, name) == 0))
+               ? 1
+               : 0;
+}
+
+/* Specialized scalars a kernel references: " -DSPEC_<NAME>=<value>" each (see "specialize") */
+static int ComposeSpecializeDefines(const Config* config, KernelConfig* kc) {
+    if (ComposeScalarDefines(config, kc, "SPEC_", 1, kc->specialize_defines,
+                             sizeof(kc->specialize_defines)) != 0) {
+        (void)fprintf(stderr, "Error: Kernel '%s' has too many specialized scalars\n",
+                      kc->variant_id);
+        return -1;
+    }
+    return 0;
+}
+
 /* Parse kernel arguments from JSON array
  * New format: {"key": ["data_type", "name"]} or {"key": ["data_type", "name", size]}
  * - i_buffer: Input buffer  (e.g., {"i_buffer": ["uchar", "src"]})
@@ -345,12 +573,15 @@ static int GetJsonFloat(const cJSON* json, const char* key, float* value) {
  * - buffer:   Custom buffer (e.g., {"buffer": ["uchar", "tmp", 45000]})
  * - param:    Scalar param  (e.g., {"param": ["int", "src_width"]})
  * - struct:   Packed struct (e.g., {"struct": ["field1", "field2", ...]})
+ * - i_image / o_image: Image views (e.g., {"i_image": ["uchar", "src"]})
+ * - sampler:  Sampler (e.g., {"sampler": ["nearest", "border"]})
  */
 static int ParseKernelArgsJson(const cJSON* args_array, KernelArgDescriptor* args, int max_count) {
     const cJSON* arg;
     int count = 0;
-    const char* arg_keys[] = {"i_buffer", "o_buffer", "buffer", "param", "struct"};
-    int num_keys = 5;
+    const char* arg_keys[] = {"i_buffer", "o_buffer", "buffer",  "param",
+                              "struct",   "i_image",  "o_image", "sampler"};
+    int num_keys = 8;
 
     if ((args_array == NULL) || !cJSON_IsArray(args_array)) {
         return 0;
@@ -383,7 +614,8 @@ static int ParseKernelArgsJson(const cJSON* args_array, KernelArgDescriptor* arg
 
         if ((matched_key == NULL) || (value_array == NULL)) {
             (void)fprintf(stderr,
-                          "Error: Kernel argument must have one of: i_buffer, o_buffer, buffer, param, struct\n");
+                          "Error: Kernel argument must have one of: i_buffer, o_buffer, buffer, "
+                          "param, struct, i_image, o_image, sampler\n");
             return -1;
         }
 
@@ -469,6 +701,18 @@ static int ParseKernelArgsJson(const cJSON* args_array, KernelArgDescriptor* arg
             return -1;
         }
 
+        /* For sampler, element [0] is the filter mode */
+        args[count].sampler_linear = 0;
+        if (args[count].arg_type == KERNEL_ARG_TYPE_SAMPLER) {
+            if (strcmp(data_type_item->valuestring, "linear") == 0) {
+                args[count].sampler_linear = 1;
+            } else if (strcmp(data_type_item->valuestring, "nearest") != 0) {
+                (void)fprintf(stderr, "Error: Invalid sampler filter: %s (nearest or linear)\n",
+                              data_type_item->valuestring);
+                return -1;
+            }
+        }
+
         /* Copy source name */
         (void)strncpy(args[count].source_name, name_item->valuestring,
                       sizeof(args[count].source_name) - 1U);
@@ -493,6 +737,285 @@ static int ParseKernelArgsJson(const cJSON* args_array, KernelArgDescriptor* arg
     return count;
 }
 
+/* True if name is a pipeline buffer: "src", "dst" or a configured custom buffer */
+static int IsPipelineBufferName(const Config* config, const char* name) {
+    int i;
+
+    if ((strcmp(name, PIPELINE_BUFFER_INPUT) == 0) || (strcmp(name, PIPELINE_BUFFER_OUTPUT) == 0)) {
+        return 1;
+    }
+    for (i = 0; i < config->custom_buffer_count; i++) {
+        if (strcmp(config->custom_buffers[i].name, name) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Index of @p name in a list of buffer names, -1 if absent */
+static int FindNameIndex(const char (*names)[64], int count, const char* name) {
+    int i;
+
+    for (i = 0; i < count; i++) {
+        if (strcmp(names[i], name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Parse a list of pipeline buffer names (pyramid "images" / "level_buffers") */
+static int ParseBufferNameList(const cJSON* list, const Config* config, const char* pipeline_id,
+                               char (*names)[64], int* count) {
+    cJSON* item;
+
+    *count = 0;
+    if ((list == NULL) || !cJSON_IsArray(list)) {
+        return 0;
+    }
+    cJSON_ArrayForEach(item, list) {
+        if (!cJSON_IsString(item) || (IsPipelineBufferName(config, item->valuestring) == 0)) {
+            (void)fprintf(stderr, "Error: Pipeline '%s' pyramid names unknown buffer\n",
+                          pipeline_id);
+            return -1;
+        }
+        if (*count >= MAX_PYRAMID_BUFFERS) {
+            (void)fprintf(stderr, "Error: Too many pyramid buffers in pipeline '%s' (max %d)\n",
+                          pipeline_id, MAX_PYRAMID_BUFFERS);
+            return -1;
+        }
+        (void)strncpy(names[*count], item->valuestring, sizeof(names[0]) - 1U);
+        (*count)++;
+    }
+    return 0;
+}
+
+/* Parse "pyramid": {"levels": 3, "downsample": "v4", "images": [...], "level_buffers": [...]} */
+static int ParsePyramidJson(const cJSON* pyramid, const Config* config, PipelineConfig* pc) {
+    const cJSON* levels = cJSON_GetObjectItemCaseSensitive(pyramid, "levels");
+    int i;
+
+    /* Levels: a number, or an int scalar shared with the C reference */
+    if (cJSON_IsNumber(levels)) {
+        pc->pyramid_levels = levels->valueint;
+    } else if (cJSON_IsString(levels)) {
+        for (i = 0; i < config->scalar_arg_count; i++) {
+            if ((strcmp(config->scalar_args[i].name, levels->valuestring) == 0) &&
+                (config->scalar_args[i].type == SCALAR_TYPE_INT)) {
+                pc->pyramid_levels = config->scalar_args[i].value.int_value;
+            }
+        }
+    } else {
+        pc->pyramid_levels = 0;
+    }
+    if ((pc->pyramid_levels < 2) || (pc->pyramid_levels > MAX_PYRAMID_LEVELS)) {
+        (void)fprintf(stderr, "Error: Pipeline '%s' pyramid 'levels' must be 2-%d\n",
+                      pc->pipeline_id, MAX_PYRAMID_LEVELS);
+        return -1;
+    }
+
+    if ((GetJsonString(pyramid, "downsample", pc->pyramid_kernel_id,
+                       sizeof(pc->pyramid_kernel_id)) != 0) ||
+        (FindKernelConfig(config, pc->pyramid_kernel_id) == NULL)) {
+        (void)fprintf(stderr, "Error: Pipeline '%s' pyramid needs a 'downsample' kernel\n",
+                      pc->pipeline_id);
+        return -1;
+    }
+
+    if ((ParseBufferNameList(cJSON_GetObjectItemCaseSensitive(pyramid, "images"), config,
+                             pc->pipeline_id, pc->pyramid_images,
+                             &pc->pyramid_image_count) != 0) ||
+        (ParseBufferNameList(cJSON_GetObjectItemCaseSensitive(pyramid, "level_buffers"), config,
+                             pc->pipeline_id, pc->level_buffers, &pc->level_buffer_count) != 0)) {
+        return -1;
+    }
+    for (i = 0; i < pc->level_buffer_count; i++) {
+        if (FindNameIndex(pc->pyramid_images, pc->pyramid_image_count, pc->level_buffers[i]) >=
+            0) {
+            (void)fprintf(stderr, "Error: Pipeline '%s' buffer '%s' is both a pyramid image and "
+                                  "a level buffer\n", pc->pipeline_id, pc->level_buffers[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* True if a binding names a level buffer's coarser plane: "<level buffer>@coarser" */
+static int IsCoarserBinding(const PipelineConfig* pc, const char* name) {
+    char base[64];
+    size_t len = strlen(name);
+    size_t suffix_len = strlen(PIPELINE_COARSER_SUFFIX);
+
+    if ((len <= suffix_len) || (len - suffix_len >= sizeof(base)) ||
+        (strcmp(&name[len - suffix_len], PIPELINE_COARSER_SUFFIX) != 0)) {
+        return 0;
+    }
+    (void)memcpy(base, name, len - suffix_len);
+    base[len - suffix_len] = '\0';
+    return (FindNameIndex(pc->level_buffers, pc->level_buffer_count, base) >= 0) ? 1 : 0;
+}
+
+/* Parse "output_goldens": {"flow_y": "test_data/algo/golden_y.bin"} (NULL: none) */
+static int ParsePipelineGoldens(const cJSON* goldens, PipelineConfig* pc) {
+    cJSON* golden;
+
+    if (goldens == NULL) {
+        return 0;
+    }
+    if (!cJSON_IsObject(goldens)) {
+        (void)fprintf(stderr, "Error: Pipeline '%s' output_goldens must be an object\n",
+                      pc->pipeline_id);
+        return -1;
+    }
+    cJSON_ArrayForEach(golden, goldens) {
+        if (!cJSON_IsString(golden)) {
+            (void)fprintf(stderr, "Error: Pipeline '%s' golden of '%s' must be a path\n",
+                          pc->pipeline_id, golden->string);
+            return -1;
+        }
+        if (pc->golden_count >= MAX_PIPELINE_GOLDENS) {
+            (void)fprintf(stderr, "Error: Too many output_goldens in pipeline '%s' (max %d)\n",
+                          pc->pipeline_id, MAX_PIPELINE_GOLDENS);
+            return -1;
+        }
+        (void)snprintf(pc->goldens[pc->golden_count].output,
+                       sizeof(pc->goldens[pc->golden_count].output), "%s", golden->string);
+        (void)snprintf(pc->goldens[pc->golden_count].golden_file,
+                       sizeof(pc->goldens[pc->golden_count].golden_file), "%s",
+                       golden->valuestring);
+        pc->golden_count++;
+    }
+    return 0;
+}
+
+/* Parse one stage: {"kernel": "v0", "bind": {"dst": "tmp"}} */
+static int ParsePipelineStageJson(const cJSON* stage_json, const Config* config,
+                                  const PipelineConfig* pc, PipelineStageConfig* stage) {
+    const char* pipeline_id = pc->pipeline_id;
+    cJSON* bind;
+    cJSON* binding;
+
+    (void)memset(stage, 0, sizeof(PipelineStageConfig));
+
+    if (GetJsonString(stage_json, "kernel", stage->kernel_id, sizeof(stage->kernel_id)) != 0) {
+        (void)fprintf(stderr, "Error: Pipeline '%s' stage missing 'kernel'\n", pipeline_id);
+        return -1;
+    }
+    if (FindKernelConfig(config, stage->kernel_id) == NULL) {
+        (void)fprintf(stderr, "Error: Pipeline '%s' references unknown kernel '%s'\n",
+                      pipeline_id, stage->kernel_id);
+        return -1;
+    }
+
+    /* Optional elementwise kernel fused into this stage; it must name its epilogue */
+    if (GetJsonString(stage_json, "fuse", stage->fuse_kernel_id, sizeof(stage->fuse_kernel_id)) ==
+        0) {
+        const KernelConfig* fused = FindKernelConfig(config, stage->fuse_kernel_id);
+        if ((fused == NULL) || (fused->epilogue[0] == '\0')) {
+            (void)fprintf(stderr, "Error: Pipeline '%s' fuses '%s', which is not a kernel with "
+                                  "an 'epilogue'\n", pipeline_id, stage->fuse_kernel_id);
+            return -1;
+        }
+    }
+
+    (void)GetJsonBool(stage_json, "coarse_to_fine", &stage->coarse_to_fine);
+    if ((stage->coarse_to_fine != 0) && (pc->pyramid_levels == 0)) {
+        (void)fprintf(stderr, "Error: Pipeline '%s' has a coarse_to_fine stage but no 'pyramid'\n",
+                      pipeline_id);
+        return -1;
+    }
+
+    bind = cJSON_GetObjectItemCaseSensitive(stage_json, "bind");
+    if ((bind != NULL) && cJSON_IsObject(bind)) {
+        cJSON_ArrayForEach(binding, bind) {
+            if (!cJSON_IsString(binding)) {
+                (void)fprintf(stderr, "Error: Pipeline '%s' binding '%s' must be a string\n",
+                              pipeline_id, binding->string);
+                return -1;
+            }
+            if (stage->bind_count >= MAX_PIPELINE_BINDINGS) {
+                (void)fprintf(stderr, "Error: Too many bindings in pipeline '%s' (max %d)\n",
+                              pipeline_id, MAX_PIPELINE_BINDINGS);
+                return -1;
+            }
+            if ((IsPipelineBufferName(config, binding->valuestring) == 0) &&
+                ((stage->coarse_to_fine == 0) ||
+                 (IsCoarserBinding(pc, binding->valuestring) == 0))) {
+                (void)fprintf(stderr, "Error: Pipeline '%s' binds unknown buffer '%s'\n",
+                              pipeline_id, binding->valuestring);
+                return -1;
+            }
+            (void)strncpy(stage->bind_arg[stage->bind_count], binding->string,
+                          sizeof(stage->bind_arg[0]) - 1U);
+            (void)strncpy(stage->bind_buffer[stage->bind_count], binding->valuestring,
+                          sizeof(stage->bind_buffer[0]) - 1U);
+            stage->bind_count++;
+        }
+    }
+    return 0;
+}
+
+/* Parse "pipeline" section (after kernels and buffers so references can be checked) */
+static int ParsePipelinesJson(const cJSON* pipelines, Config* config) {
+    cJSON* pipeline;
+    cJSON* item;
+    cJSON* stages;
+    cJSON* stage_json;
+
+    cJSON_ArrayForEach(pipeline, pipelines) {
+        /* Skip documentation fields */
+        if (pipeline->string[0] == '_') {
+            continue;
+        }
+
+        if (config->pipeline_count >= MAX_PIPELINES) {
+            (void)fprintf(stderr, "Error: Too many pipelines (max %d)\n", MAX_PIPELINES);
+            return -1;
+        }
+
+        PipelineConfig* pc = &config->pipelines[config->pipeline_count];
+        (void)memset(pc, 0, sizeof(PipelineConfig));
+        (void)strncpy(pc->pipeline_id, pipeline->string, sizeof(pc->pipeline_id) - 1U);
+        (void)GetJsonString(pipeline, "description", pc->description, sizeof(pc->description));
+        (void)GetJsonString(pipeline, "golden_file", pc->golden_file, sizeof(pc->golden_file));
+        if (ParseTolerance(cJSON_GetObjectItemCaseSensitive(pipeline, "tolerance"),
+                           pc->pipeline_id, &pc->tolerance) != 0) {
+            return -1;
+        }
+        if (ParsePipelineGoldens(cJSON_GetObjectItemCaseSensitive(pipeline, "output_goldens"),
+                                 pc) != 0) {
+            return -1;
+        }
+
+        /* Optional pyramid (before the stages that bind its levels) */
+        item = cJSON_GetObjectItemCaseSensitive(pipeline, "pyramid");
+        if ((item != NULL) && (ParsePyramidJson(item, config, pc) != 0)) {
+            return -1;
+        }
+
+        stages = cJSON_GetObjectItemCaseSensitive(pipeline, "stages");
+        if ((stages == NULL) || !cJSON_IsArray(stages) || (cJSON_GetArraySize(stages) == 0)) {
+            (void)fprintf(stderr, "Error: Pipeline '%s' missing 'stages'\n", pc->pipeline_id);
+            return -1;
+        }
+        cJSON_ArrayForEach(stage_json, stages) {
+            if (pc->stage_count >= MAX_PIPELINE_STAGES) {
+                (void)fprintf(stderr, "Error: Too many stages in pipeline '%s' (max %d)\n",
+                              pc->pipeline_id, MAX_PIPELINE_STAGES);
+                return -1;
+            }
+            if (ParsePipelineStageJson(stage_json, config, pc, &pc->stages[pc->stage_count]) !=
+                0) {
+                return -1;
+            }
+            pc->stage_count++;
+        }
+
+        config->pipeline_count++;
+    }
+    return 0;
+}
+
 int ParseConfig(const char* filename, Config* config) {
     char* json_str;
     cJSON* root;
@@ -534,10 +1057,35 @@ int ParseConfig(const char* filename, Config* config) {
     config->num_kernels = 0;
     config->custom_buffer_count = 0;
     config->scalar_arg_count = 0;
+    config->pipeline_count = 0;
     config->verification.tolerance = 0.0f;
+    config->verification.rel_tolerance = 0.0f;
+    config->verification.ulp_tolerance = 0;
     config->verification.error_rate_threshold = 0.0f;
     config->verification.golden_source = GOLDEN_SOURCE_C_REF;
     config->verification.golden_file[0] = '\0';
+    config->verification.reference_threads = 0;
+    config->verification.early_exit = 0;
+    config->verification.dump_diff = 0;
+    config->verification.on_device = 0;
+    config->benchmark.enabled = 0;
+    config->benchmark.warmup_iterations = BENCHMARK_DEFAULT_WARMUP;
+    config->benchmark.iterations = BENCHMARK_DEFAULT_ITERATIONS;
+    config->results.write_csv = 0;
+    config->results.write_trace = 0;
+    config->stream.enabled = 0;
+    config->stream.input_path[0] = '\0';
+    config->stream.output_path[0] = '\0';
+    config->stream.max_frames = 0;
+    config->stream.buffer_sets = STREAM_DEFAULT_BUFFER_SETS;
+    config->multi_device.enabled = 0;
+    config->multi_device.split = MULTI_SPLIT_ROWS;
+    config->multi_device.halo = MULTI_DEVICE_HALO_AUTO;
+    config->multi_device.rounds = MULTI_DEVICE_DEFAULT_ROUNDS;
+    config->multi_device.max_devices = 0;
+
+    /* Optional explicit op_id: several config files can drive one algorithm */
+    (void)GetJsonString(root, "op_id", config->op_id, sizeof(config->op_id));
 
     /* Parse input section */
     item = cJSON_GetObjectItemCaseSensitive(root, "input");
@@ -557,6 +1105,8 @@ int ParseConfig(const char* filename, Config* config) {
     item = cJSON_GetObjectItemCaseSensitive(root, "verification");
     if (item != NULL) {
         (void)GetJsonFloat(item, "tolerance", &config->verification.tolerance);
+        (void)GetJsonFloat(item, "rel_tolerance", &config->verification.rel_tolerance);
+        (void)GetJsonInt(item, "ulp_tolerance", &config->verification.ulp_tolerance);
         (void)GetJsonFloat(item, "error_rate_threshold",
                            &config->verification.error_rate_threshold);
 
@@ -571,6 +1121,99 @@ int ParseConfig(const char* filename, Config* config) {
 
         (void)GetJsonString(item, "golden_file", config->verification.golden_file,
                             sizeof(config->verification.golden_file));
+        (void)GetJsonInt(item, "reference_threads", &config->verification.reference_threads);
+        (void)GetJsonBool(item, "early_exit", &config->verification.early_exit);
+        (void)GetJsonBool(item, "dump_diff", &config->verification.dump_diff);
+        (void)GetJsonBool(item, "on_device", &config->verification.on_device);
+
+        if (config->verification.reference_threads < 0) {
+            (void)fprintf(stderr, "Error: reference_threads must be >= 0 (0 = all CPUs)\n");
+            cJSON_Delete(root);
+            return -1;
+        }
+        if ((config->verification.rel_tolerance < 0.0f) ||
+            (config->verification.ulp_tolerance < 0)) {
+            (void)fprintf(stderr, "Error: rel_tolerance and ulp_tolerance must be >= 0\n");
+            cJSON_Delete(root);
+            return -1;
+        }
+    }
+
+    /* Parse benchmark section */
+    item = cJSON_GetObjectItemCaseSensitive(root, "benchmark");
+    if (item != NULL) {
+        (void)GetJsonBool(item, "enabled", &config->benchmark.enabled);
+        (void)GetJsonInt(item, "warmup_iterations", &config->benchmark.warmup_iterations);
+        (void)GetJsonInt(item, "iterations", &config->benchmark.iterations);
+
+        if ((config->benchmark.warmup_iterations < 0) || (config->benchmark.iterations < 1) ||
+            (config->benchmark.iterations > MAX_BENCHMARK_ITERATIONS)) {
+            (void)fprintf(stderr,
+                          "Error: Invalid benchmark section (warmup >= 0, 1 <= iterations <= %d)\n",
+                          MAX_BENCHMARK_ITERATIONS);
+            cJSON_Delete(root);
+            return -1;
+        }
+    }
+
+    /* Parse stream section */
+    item = cJSON_GetObjectItemCaseSensitive(root, "stream");
+    if (item != NULL) {
+        (void)GetJsonBool(item, "enabled", &config->stream.enabled);
+        (void)GetJsonString(item, "input", config->stream.input_path,
+                            sizeof(config->stream.input_path));
+        (void)GetJsonString(item, "output", config->stream.output_path,
+                            sizeof(config->stream.output_path));
+        (void)GetJsonInt(item, "frames", &config->stream.max_frames);
+        (void)GetJsonInt(item, "buffer_sets", &config->stream.buffer_sets);
+
+        if ((config->stream.max_frames < 0) || (config->stream.buffer_sets < 2) ||
+            (config->stream.buffer_sets > MAX_STREAM_BUFFER_SETS)) {
+            (void)fprintf(stderr,
+                          "Error: Invalid stream section (frames >= 0, 2 <= buffer_sets <= %d)\n",
+                          MAX_STREAM_BUFFER_SETS);
+            cJSON_Delete(root);
+            return -1;
+        }
+    }
+
+    /* Parse multi_device section */
+    item = cJSON_GetObjectItemCaseSensitive(root, "multi_device");
+    if (item != NULL) {
+        char split_str[16] = "rows";
+        int halo_set;
+
+        (void)GetJsonBool(item, "enabled", &config->multi_device.enabled);
+        (void)GetJsonString(item, "split", split_str, sizeof(split_str));
+        /* Without "halo", row bands take the op's REF_HALO_ROWS */
+        halo_set = (GetJsonInt(item, "halo", &config->multi_device.halo) == 0) ? 1 : 0;
+        (void)GetJsonInt(item, "rounds", &config->multi_device.rounds);
+        (void)GetJsonInt(item, "max_devices", &config->multi_device.max_devices);
+
+        if (ParseMultiDeviceSplit(split_str, &config->multi_device.split) != 0) {
+            (void)fprintf(stderr, "Error: Invalid multi_device split '%s' (rows or frames)\n",
+                          split_str);
+            cJSON_Delete(root);
+            return -1;
+        }
+        if (((halo_set != 0) && (config->multi_device.halo < 0)) ||
+            (config->multi_device.rounds < 1) ||
+            (config->multi_device.max_devices < 0) ||
+            (config->multi_device.max_devices > MAX_MULTI_DEVICES)) {
+            (void)fprintf(stderr,
+                          "Error: Invalid multi_device section (halo >= 0, rounds >= 1, "
+                          "0 <= max_devices <= %d)\n",
+                          MAX_MULTI_DEVICES);
+            cJSON_Delete(root);
+            return -1;
+        }
+    }
+
+    /* Parse results section */
+    item = cJSON_GetObjectItemCaseSensitive(root, "results");
+    if (item != NULL) {
+        (void)GetJsonBool(item, "csv", &config->results.write_csv);
+        (void)GetJsonBool(item, "trace", &config->results.write_trace);
     }
 
     /* Parse scalars section */
@@ -636,6 +1279,14 @@ int ParseConfig(const char* filename, Config* config) {
                 }
             }
 
+            /* Optional compile-time specialization (-DSPEC_<NAME>=<value>) */
+            (void)GetJsonBool(scalar, "specialize", &sc->specialize);
+            if ((sc->specialize != 0) && (value_item == NULL)) {
+                (void)fprintf(stderr, "Error: Specialized scalar '%s' has no value\n", sc->name);
+                cJSON_Delete(root);
+                return -1;
+            }
+
             config->scalar_arg_count++;
         }
     }
@@ -683,7 +1334,16 @@ int ParseConfig(const char* filename, Config* config) {
 
             (void)GetJsonInt(buffer, "num_elements", &buf->num_elements);
             (void)GetJsonString(buffer, "source_file", buf->source_file, sizeof(buf->source_file));
-            (void)GetJsonSize(buffer, "size_bytes", &buf->size_bytes);
+            /* size_bytes may be derived from the input image ("src_width * src_height * 4") */
+            {
+                const cJSON* size_item = cJSON_GetObjectItemCaseSensitive(buffer, "size_bytes");
+                if ((size_item != NULL) && cJSON_IsString(size_item)) {
+                    (void)EvalExpressionWithImage(size_item->valuestring,
+                                                  SelectedInputImage(config), &buf->size_bytes);
+                } else {
+                    (void)GetJsonSize(buffer, "size_bytes", &buf->size_bytes);
+                }
+            }
 
             /* Calculate size_bytes for file-backed buffers */
             if ((buf->source_file[0] != '\0') && (buf->size_bytes == 0)) {
@@ -739,6 +1399,18 @@ int ParseConfig(const char* filename, Config* config) {
             (void)GetJsonString(kernel, "host_type", host_type_str, sizeof(host_type_str));
             kc->host_type = ParseHostType(host_type_str);
 
+            /* Get memory_strategy (default to copy) */
+            char strategy_str[32] = "copy";
+            (void)GetJsonString(kernel, "memory_strategy", strategy_str, sizeof(strategy_str));
+            if (ParseMemoryStrategy(strategy_str, &kc->memory_strategy) != 0) {
+                (void)fprintf(stderr,
+                              "Error: Kernel '%s' has invalid memory_strategy '%s' "
+                              "(expected copy, use_host_ptr or alloc_host_ptr)\n",
+                              kc->variant_id, strategy_str);
+                cJSON_Delete(root);
+                return -1;
+            }
+
             /* Get kernel_option (optional user build options, default empty) */
             kc->kernel_option[0] = '\0';
             (void)GetJsonString(kernel, "kernel_option", kc->kernel_option,
@@ -785,9 +1457,16 @@ int ParseConfig(const char* filename, Config* config) {
                 return -1;
             }
 
-            /* Get local_work_size array */
+            /* Get local_work_size array (or "auto" for autotuning) */
             cJSON* lws = cJSON_GetObjectItemCaseSensitive(kernel, "local_work_size");
-            if ((lws != NULL) && cJSON_IsArray(lws)) {
+            kc->local_work_size_auto = 0;
+            if ((lws != NULL) && cJSON_IsString(lws) && (strcmp(lws->valuestring, "auto") == 0)) {
+                /* Resolved at run time by the autotuner (0 = driver choice until then) */
+                kc->local_work_size_auto = 1;
+                kc->local_work_size[0] = 0U;
+                kc->local_work_size[1] = 0U;
+                kc->local_work_size[2] = 0U;
+            } else if ((lws != NULL) && cJSON_IsArray(lws)) {
                 int idx = 0;
                 cJSON* lws_item;
                 cJSON_ArrayForEach(lws_item, lws) {
@@ -814,10 +1493,83 @@ int ParseConfig(const char* filename, Config* config) {
                 kc->kernel_arg_count = arg_count;
             }
 
+            /* Optional tiled sub-dispatch (cl_extension only) */
+            if (ParseTilingJson(cJSON_GetObjectItemCaseSensitive(kernel, "tiling"), kc) != 0) {
+                cJSON_Delete(root);
+                return -1;
+            }
+
+            /* Optional precision, fp32 baseline and variant tolerance (precision report) */
+            {
+                char precision_str[16] = "fp32";
+                (void)GetJsonString(kernel, "precision", precision_str, sizeof(precision_str));
+                if (ParseKernelPrecision(precision_str, &kc->precision) != 0) {
+                    (void)fprintf(stderr,
+                                  "Error: Kernel '%s' has invalid precision '%s' "
+                                  "(expected fp32, fp16 or int)\n",
+                                  kc->variant_id, precision_str);
+                    cJSON_Delete(root);
+                    return -1;
+                }
+            }
+            (void)GetJsonString(kernel, "baseline", kc->baseline, sizeof(kc->baseline));
+            if (ParseTolerance(cJSON_GetObjectItemCaseSensitive(kernel, "tolerance"),
+                               kc->variant_id, &kc->tolerance) != 0) {
+                cJSON_Delete(root);
+                return -1;
+            }
+
+            /* Optional fusion epilogue and pipeline-only flag */
+            (void)GetJsonString(kernel, "epilogue", kc->epilogue, sizeof(kc->epilogue));
+            (void)GetJsonBool(kernel, "pipeline_only", &kc->pipeline_only);
+            (void)GetJsonString(kernel, "reference", kc->reference, sizeof(kc->reference));
+
+            /* Optional pitched device rows (rectangular transfers need the copy strategy) */
+            (void)GetJsonBool(kernel, "pitched", &kc->pitched);
+            if ((kc->pitched != 0) && (kc->memory_strategy != MEM_STRATEGY_COPY)) {
+                (void)fprintf(stderr, "Error: Kernel '%s' pitched needs memory_strategy copy\n",
+                              kc->variant_id);
+                cJSON_Delete(root);
+                return -1;
+            }
+
+            /* Optional batch dimension: the image index is one extra, outermost dimension */
+            (void)GetJsonBool(kernel, "batch", &kc->batch);
+            if ((kc->batch != 0) &&
+                ((kc->work_dim > 2) || (kc->host_type != HOST_TYPE_STANDARD))) {
+                (void)fprintf(stderr,
+                              "Error: Kernel '%s' batch needs the standard host type and "
+                              "work_dim 1 or 2\n",
+                              kc->variant_id);
+                cJSON_Delete(root);
+                return -1;
+            }
+
+            /* Specialized scalars, unless the variant opts out for a generic build */
+            {
+                int specialize = 1;
+                (void)GetJsonBool(kernel, "specialize", &specialize);
+                if (specialize == 0) {
+                    kc->specialize_defines[0] = '\0';
+                } else if (ComposeSpecializeDefines(config, kc) != 0) {
+                    cJSON_Delete(root);
+                    return -1;
+                }
+            }
+
             config->num_kernels++;
         }
     }
 
+    /* Parse pipeline section (stages reference kernels and buffers parsed above) */
+    item = cJSON_GetObjectItemCaseSensitive(root, "pipeline");
+    if ((item != NULL) && cJSON_IsObject(item)) {
+        if (ParsePipelinesJson(item, config) != 0) {
+            cJSON_Delete(root);
+            return -1;
+        }
+    }
+
     cJSON_Delete(root);
 
     /* Validate custom buffers */
@@ -841,9 +1593,9 @@ int ParseConfig(const char* filename, Config* config) {
                     return -1;
                 }
             }
-            /* Empty buffer: must have size_bytes */
+            /* Empty buffer: must have size_bytes (checked once the input images are known) */
             else {
-                if (buf->size_bytes == 0) {
+                if ((buf->size_bytes == 0) && (config->input_image_count > 0)) {
                     (void)fprintf(stderr, "Error: Empty buffer '%s' missing 'size_bytes' field\n",
                                   buf->name);
                     return -1;
@@ -872,15 +1624,122 @@ int GetOpVariants(const Config* config, const char* op_id, KernelConfig* variant
         return 0;
     }
 
-    /* All kernels in the config are variants of this operation */
+    /* All kernels in the config are variants of this operation, except pipeline-only ones */
+    *count = 0;
     for (i = 0; i < config->num_kernels; i++) {
-        variants[i] = (KernelConfig*)&config->kernels[i];
+        if (config->kernels[i].pipeline_only == 0) {
+            variants[*count] = (KernelConfig*)&config->kernels[i];
+            (*count)++;
+        }
     }
+    return 0;
+}
 
-    *count = config->num_kernels;
+int ComposeScalarDefines(const Config* config, const KernelConfig* kernel_cfg, const char* prefix,
+                         int specialized_only, char* out, size_t out_size) {
+    char macro[64];
+    size_t used = 0U;
+    int written = 0;
+    int i;
+    int j;
+    size_t k;
+
+    if ((config == NULL) || (kernel_cfg == NULL) || (prefix == NULL) || (out == NULL) ||
+        (out_size == 0U)) {
+        return -1;
+    }
+
+    out[0] = '\0';
+    for (i = 0; i < config->scalar_arg_count; i++) {
+        const ScalarArgConfig* sc = &config->scalar_args[i];
+        int referenced = 0;
+
+        if ((specialized_only != 0) && (sc->specialize == 0)) {
+            continue;
+        }
+        for (j = 0; (j < kernel_cfg->kernel_arg_count) && (referenced == 0); j++) {
+            referenced = KernelArgUsesScalar(&kernel_cfg->kernel_args[j], sc->name);
+        }
+        if (referenced == 0) {
+            continue;
+        }
+
+        for (k = 0U; (sc->name[k] != '\0') && (k < (sizeof(macro) - 1U)); k++) {
+            macro[k] = (isalnum((unsigned char)sc->name[k]) != 0)
+                           ? (char)toupper((unsigned char)sc->name[k])
+                           : '_';
+        }
+        macro[k] = '\0';
+
+        switch (sc->type) {
+            case SCALAR_TYPE_FLOAT:
+                written = snprintf(&out[used], out_size - used, " -D%s%s=%.9ef", prefix, macro,
+                                   (double)sc->value.float_value);
+                break;
+            case SCALAR_TYPE_SIZE:
+                written = snprintf(&out[used], out_size - used, " -D%s%s=%zu", prefix, macro,
+                                   sc->value.size_value);
+                break;
+            default:
+                written = snprintf(&out[used], out_size - used, " -D%s%s=%d", prefix, macro,
+                                   sc->value.int_value);
+                break;
+        }
+        if ((written < 0) || ((size_t)written >= (out_size - used))) {
+            out[0] = '\0';
+            return -1;
+        }
+        used += (size_t)written;
+    }
     return 0;
 }
 
+int VariantMatchesSelector(const KernelConfig* kernel_cfg, const char* selector,
+                           size_t selector_len) {
+    const char* id;
+
+    if ((kernel_cfg == NULL) || (selector == NULL)) {
+        return 0;
+    }
+    id = kernel_cfg->variant_id;
+    if (id[0] == 'v') {
+        id++;
+    }
+    if ((selector_len > 0U) && (selector[0] == 'v')) {
+        selector++;
+        selector_len--;
+    }
+    return ((strlen(id) == selector_len) && (strncmp(id, selector, selector_len) == 0)) ? 1 : 0;
+}
+
+const KernelConfig* FindKernelConfig(const Config* config, const char* variant_id) {
+    int i;
+
+    if ((config == NULL) || (variant_id == NULL)) {
+        return NULL;
+    }
+    for (i = 0; i < config->num_kernels; i++) {
+        if (strcmp(config->kernels[i].variant_id, variant_id) == 0) {
+            return &config->kernels[i];
+        }
+    }
+    return NULL;
+}
+
+const PipelineConfig* FindPipelineConfig(const Config* config, const char* pipeline_id) {
+    int i;
+
+    if ((config == NULL) || (pipeline_id == NULL)) {
+        return NULL;
+    }
+    for (i = 0; i < config->pipeline_count; i++) {
+        if (strcmp(config->pipelines[i].pipeline_id, pipeline_id) == 0) {
+            return &config->pipelines[i];
+        }
+    }
+    return NULL;
+}
+
 int ResolveConfigPath(const char* input, char* output, size_t output_size) {
     FILE* test_file;
     int written;
@@ -942,10 +1801,180 @@ int ExtractOpIdFromPath(const char* config_path, char* op_id, size_t op_id_size)
     return 0;
 }
 
+/* Parse one inputs.json entry */
+static void ParseInputEntry(const cJSON* image, InputImageConfig* img) {
+    size_t stride_val;
+
+    (void)memset(img, 0, sizeof(InputImageConfig));
+    (void)strncpy(img->name, image->string, sizeof(img->name) - 1U);
+
+    /* Parse image properties */
+    (void)GetJsonString(image, "input", img->input_path, sizeof(img->input_path));
+    (void)GetJsonInt(image, "src_width", &img->src_width);
+    (void)GetJsonInt(image, "src_height", &img->src_height);
+    (void)GetJsonInt(image, "src_channels", &img->src_channels);
+
+    /* src_stride can be a number or expression string */
+    if (GetJsonSize(image, "src_stride", &stride_val) == 0) {
+        img->src_stride = (int)stride_val;
+    }
+
+    /* Optional batch of same-shape images packed in one file */
+    img->batch_count = 1;
+    (void)GetJsonInt(image, "batch", &img->batch_count);
+}
+
+/**
+ * @brief Parse the "buffers" object of an outputs.json entry
+ *
+ * @param[in] buffers "buffers" object
+ * @param[in,out] img Output entry (data_type / output_path follow the first buffer)
+ * @return 0 on success, -1 on error
+ */
+static int ParseOutputBuffers(const cJSON* buffers, OutputImageConfig* img) {
+    const cJSON* item;
+    const cJSON* field;
+    OutputBufferConfig* buf;
+
+    cJSON_ArrayForEach(item, buffers) {
+        if (img->buffer_count >= MAX_OUTPUT_BUFFERS) {
+            (void)fprintf(stderr, "Error: %s has more than %d buffers\n", img->name,
+                          MAX_OUTPUT_BUFFERS);
+            return -1;
+        }
+        buf = &img->buffers[img->buffer_count];
+        (void)memset(buf, 0, sizeof(*buf));
+        (void)strncpy(buf->name, item->string, sizeof(buf->name) - 1U);
+
+        buf->data_type = DATA_TYPE_UCHAR;
+        field = cJSON_GetObjectItemCaseSensitive(item, "data_type");
+        if ((field != NULL) && cJSON_IsString(field)) {
+            buf->data_type = ParseDataType(field->valuestring);
+        }
+        if ((buf->data_type != DATA_TYPE_UCHAR) && (buf->data_type != DATA_TYPE_FLOAT)) {
+            (void)fprintf(stderr, "Error: %s.%s data_type must be \"uchar\" or \"float\"\n",
+                          img->name, buf->name);
+            return -1;
+        }
+        (void)GetJsonString(item, "golden_file", buf->golden_file, sizeof(buf->golden_file));
+        (void)GetJsonString(item, "output", buf->output_path, sizeof(buf->output_path));
+        if (ParseTolerance(cJSON_GetObjectItemCaseSensitive(item, "tolerance"), buf->name,
+                           &buf->tolerance) != 0) {
+            return -1;
+        }
+        img->buffer_count++;
+    }
+
+    if (img->buffer_count > 0) {
+        img->data_type = img->buffers[0].data_type;
+        if (img->buffers[0].output_path[0] != '\0') {
+            (void)snprintf(img->output_path, sizeof(img->output_path), "%s",
+                           img->buffers[0].output_path);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse one outputs.json entry
+ *
+ * @param[in] output Entry
+ * @param[out] img Output image configuration
+ * @return 0 on success, -1 on error
+ */
+static int ParseOutputEntry(const cJSON* output, OutputImageConfig* img) {
+    const cJSON* item;
+    size_t stride_val;
+
+    (void)memset(img, 0, sizeof(OutputImageConfig));
+    (void)strncpy(img->name, output->string, sizeof(img->name) - 1U);
+
+    /* Parse output properties */
+    (void)GetJsonString(output, "output", img->output_path, sizeof(img->output_path));
+    (void)GetJsonInt(output, "dst_width", &img->dst_width);
+    (void)GetJsonInt(output, "dst_height", &img->dst_height);
+    (void)GetJsonInt(output, "dst_channels", &img->dst_channels);
+
+    /* dst_stride can be a number or expression string */
+    if (GetJsonSize(output, "dst_stride", &stride_val) == 0) {
+        img->dst_stride = (int)stride_val;
+    }
+
+    /* Element type: uchar images by default, float for responses and flow fields */
+    img->data_type = DATA_TYPE_UCHAR;
+    item = cJSON_GetObjectItemCaseSensitive(output, "data_type");
+    if ((item != NULL) && cJSON_IsString(item)) {
+        img->data_type = ParseDataType(item->valuestring);
+        if ((img->data_type != DATA_TYPE_UCHAR) && (img->data_type != DATA_TYPE_FLOAT)) {
+            (void)fprintf(stderr, "Error: %s data_type must be \"uchar\" or \"float\"\n",
+                          output->string);
+            return -1;
+        }
+    }
+
+    /* Named outputs of a multi-output kernel */
+    item = cJSON_GetObjectItemCaseSensitive(output, "buffers");
+    if ((item != NULL) && (ParseOutputBuffers(item, img) != 0)) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Slot of an inputs.json / outputs.json entry
+ *
+ * Numbered entries ("<prefix>N") keep slot N - 1 and are placed in the
+ * first pass; entries with any other name ("svd_output", "image_rgba") are
+ * appended in the second pass, after the highest numbered one. A number
+ * out of range only skips that entry, so the files stay usable for every
+ * other algorithm.
+ *
+ * @param[in] name Entry name
+ * @param[in] prefix Numbered entry prefix ("image_" or "output_")
+ * @param[in] named_pass Non-zero for the second pass
+ * @param[in] max_entries Number of slots
+ * @param[in,out] count Slots in use
+ * @return Slot index, -1 to skip the entry in this pass, -2 on error
+ */
+static int EntrySlot(const char* name, const char* prefix, int named_pass, int max_entries,
+                     int* count) {
+    size_t prefix_len = strlen(prefix);
+    long temp_long = 0;
+    int slot;
+
+    if ((strncmp(name, prefix, prefix_len) == 0) && SafeStrtol(name + prefix_len, &temp_long)) {
+        if (named_pass != 0) {
+            return -1;
+        }
+        if ((temp_long < 1) || (temp_long > max_entries)) {
+            (void)fprintf(stderr, "Warning: Entry %s out of range (1-%d), skipped\n", name,
+                          max_entries);
+            return -1;
+        }
+        slot = (int)temp_long - 1;
+    } else {
+        if (named_pass == 0) {
+            return -1;
+        }
+        if (*count >= max_entries) {
+            (void)fprintf(stderr, "Error: Too many entries (max %d): %s\n", max_entries, name);
+            return -2;
+        }
+        slot = *count;
+    }
+
+    if (slot + 1 > *count) {
+        *count = slot + 1;
+    }
+    return slot;
+}
+
 int ParseInputsConfig(const char* filename, Config* config) {
     char* json_str;
     cJSON* root;
     cJSON* image;
+    int pass;
+    int slot;
 
     if ((filename == NULL) || (config == NULL)) {
         return -1;
@@ -973,42 +2002,18 @@ int ParseInputsConfig(const char* filename, Config* config) {
     /* Initialize input images count */
     config->input_image_count = 0;
 
-    /* Iterate over all image entries */
-    cJSON_ArrayForEach(image, root) {
-        /* Skip non-image entries */
-        if (strncmp(image->string, "image_", 6U) != 0) {
-            continue;
-        }
-
-        /* Parse image index from name (image_1 -> 0, image_2 -> 1, etc.) */
-        long temp_long;
-        if (!SafeStrtol(image->string + 6, &temp_long) || (temp_long < 1) ||
-            (temp_long > MAX_INPUT_IMAGES)) {
-            (void)fprintf(stderr, "Error: Invalid image name: %s\n", image->string);
-            cJSON_Delete(root);
-            return -1;
-        }
-
-        int image_index = (int)temp_long - 1;
-
-        /* Update image count */
-        if (image_index + 1 > config->input_image_count) {
-            config->input_image_count = image_index + 1;
-        }
-
-        InputImageConfig* img = &config->input_images[image_index];
-        (void)memset(img, 0, sizeof(InputImageConfig));
-
-        /* Parse image properties */
-        (void)GetJsonString(image, "input", img->input_path, sizeof(img->input_path));
-        (void)GetJsonInt(image, "src_width", &img->src_width);
-        (void)GetJsonInt(image, "src_height", &img->src_height);
-        (void)GetJsonInt(image, "src_channels", &img->src_channels);
-
-        /* src_stride can be a number or expression string */
-        size_t stride_val;
-        if (GetJsonSize(image, "src_stride", &stride_val) == 0) {
-            img->src_stride = (int)stride_val;
+    /* image_N entries first (image_1 -> 0, image_2 -> 1, etc.), then named ones */
+    for (pass = 0; pass < 2; pass++) {
+        cJSON_ArrayForEach(image, root) {
+            slot = EntrySlot(image->string, "image_", pass, MAX_INPUT_IMAGES,
+                             &config->input_image_count);
+            if (slot == -2) {
+                cJSON_Delete(root);
+                return -1;
+            }
+            if (slot >= 0) {
+                ParseInputEntry(image, &config->input_images[slot]);
+            }
         }
     }
 
@@ -1023,6 +2028,8 @@ int ParseOutputsConfig(const char* filename, Config* config) {
     char* json_str;
     cJSON* root;
     cJSON* output;
+    int pass;
+    int slot;
 
     if ((filename == NULL) || (config == NULL)) {
         return -1;
@@ -1050,42 +2057,17 @@ int ParseOutputsConfig(const char* filename, Config* config) {
     /* Initialize output images count */
     config->output_image_count = 0;
 
-    /* Iterate over all output entries */
-    cJSON_ArrayForEach(output, root) {
-        /* Skip non-output entries */
-        if (strncmp(output->string, "output_", 7U) != 0) {
-            continue;
-        }
-
-        /* Parse output index from name (output_1 -> 0, output_2 -> 1, etc.) */
-        long temp_long;
-        if (!SafeStrtol(output->string + 7, &temp_long) || (temp_long < 1) ||
-            (temp_long > MAX_OUTPUT_IMAGES)) {
-            (void)fprintf(stderr, "Error: Invalid output name: %s\n", output->string);
-            cJSON_Delete(root);
-            return -1;
-        }
-
-        int output_index = (int)temp_long - 1;
-
-        /* Update output count */
-        if (output_index + 1 > config->output_image_count) {
-            config->output_image_count = output_index + 1;
-        }
-
-        OutputImageConfig* img = &config->output_images[output_index];
-        (void)memset(img, 0, sizeof(OutputImageConfig));
-
-        /* Parse output properties */
-        (void)GetJsonString(output, "output", img->output_path, sizeof(img->output_path));
-        (void)GetJsonInt(output, "dst_width", &img->dst_width);
-        (void)GetJsonInt(output, "dst_height", &img->dst_height);
-        (void)GetJsonInt(output, "dst_channels", &img->dst_channels);
-
-        /* dst_stride can be a number or expression string */
-        size_t stride_val;
-        if (GetJsonSize(output, "dst_stride", &stride_val) == 0) {
-            img->dst_stride = (int)stride_val;
+    /* output_N entries first (output_1 -> 0, output_2 -> 1, etc.), then named ones */
+    for (pass = 0; pass < 2; pass++) {
+        cJSON_ArrayForEach(output, root) {
+            slot = EntrySlot(output->string, "output_", pass, MAX_OUTPUT_IMAGES,
+                             &config->output_image_count);
+            if ((slot == -2) ||
+                ((slot >= 0) &&
+                 (ParseOutputEntry(output, &config->output_images[slot]) != 0))) {
+                cJSON_Delete(root);
+                return -1;
+            }
         }
     }
 
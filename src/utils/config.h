@@ -13,19 +13,29 @@
  *   "input": { "input_image_id": "image_1" },
  *   "output": { "output_image_id": "output_1" },
  *   "verification": { "tolerance": 0, "error_rate_threshold": 0 },
+ *   "benchmark": { "enabled": false, "warmup_iterations": 3, "iterations": 20 },
+ *   "results": { "csv": false },
  *   "kernels": {
  *     "v0": {
  *       "kernel_file": "path/to/kernel.cl",
  *       "kernel_function": "function_name",
  *       "work_dim": 2,
  *       "global_work_size": [1920, 1080],
- *       "local_work_size": [16, 16],
+ *       "local_work_size": [16, 16],       (or "auto" to autotune)
  *       "kernel_args": [
  *         {"i_buffer": ["uchar", "src"]},
  *         {"o_buffer": ["uchar", "dst"]},
  *         {"param": ["int", "src_width"]}
  *       ]
  *     }
+ *   },
+ *   "pipeline": {
+ *     "p0": {
+ *       "stages": [
+ *         {"kernel": "v0", "bind": {"dst": "tmp"}},
+ *         {"kernel": "v1", "bind": {"src": "tmp"}}
+ *       ]
+ *     }
  *   }
  * }
  *
@@ -46,12 +56,27 @@
 
 /** Maximum number of input images */
 #define MAX_INPUT_IMAGES 16
+#define MAX_BATCH_IMAGES 4096
 
 /** Maximum number of output images */
 #define MAX_OUTPUT_IMAGES 16
 
 /* Note: HostType and BufferType are defined in utils/op_interface.h */
 
+/**
+ * @brief Host/device memory strategy for the input and output image buffers
+ *
+ * Selected per kernel variant with "memory_strategy". The zero-copy
+ * strategies avoid explicit transfers on unified-memory devices: data is
+ * exchanged through clEnqueueMapBuffer/clEnqueueUnmapMemObject instead of
+ * clEnqueueWriteBuffer/clEnqueueReadBuffer.
+ */
+typedef enum {
+    MEM_STRATEGY_COPY = 0,       /**< Device-allocated buffer, explicit write/read (default) */
+    MEM_STRATEGY_USE_HOST_PTR,   /**< CL_MEM_USE_HOST_PTR over the page-aligned host buffers */
+    MEM_STRATEGY_ALLOC_HOST_PTR  /**< CL_MEM_ALLOC_HOST_PTR, host access via map/unmap */
+} MemoryStrategy;
+
 /**
  * @brief Input image configuration
  *
@@ -59,38 +84,86 @@
  * and image dimensions.
  */
 typedef struct {
+    char name[64];        /**< Entry name in inputs.json (e.g., "image_1", "svd_input") */
     char input_path[256]; /**< Path to input image file */
     int src_width;        /**< Source image width in pixels */
     int src_height;       /**< Source image height in pixels */
     int src_channels;     /**< Number of channels (e.g., 3 for RGB) */
     int src_stride;       /**< Stride in bytes (may differ from width * channels) */
+    int batch_count;      /**< "batch": images of this shape back to back in the file (1 = one) */
 } InputImageConfig;
 
+/** Data type enumeration for buffer elements */
+typedef enum {
+    DATA_TYPE_NONE = 0,
+    DATA_TYPE_FLOAT, /**< 32-bit floating point (4 bytes) */
+    DATA_TYPE_UCHAR, /**< 8-bit unsigned char (1 byte) */
+    DATA_TYPE_INT,   /**< 32-bit signed integer (4 bytes) */
+    DATA_TYPE_SHORT, /**< 16-bit signed integer (2 bytes) */
+    DATA_TYPE_HALF   /**< 16-bit IEEE half float (2 bytes; vload_half/vstore_half, or
+                          arithmetic with cl_khr_fp16) */
+} DataType;
+
+/**
+ * @brief Verification bounds replacing the verification section's
+ *
+ * Config file format:
+ * "tolerance": 2                                      (absolute only)
+ * "tolerance": {"abs": 0.01, "rel": 0.001, "ulp": 4}  (float outputs)
+ */
+typedef struct {
+    int enabled;         /**< Non-zero if "tolerance" was given */
+    float tolerance;     /**< Max |diff| */
+    float rel_tolerance; /**< Also accept |diff| <= rel_tolerance * |ref| (0: off) */
+    int ulp_tolerance;   /**< Also accept float elements this many ULPs apart (0: off) */
+} ToleranceOverride;
+
+/**
+ * @brief One named, typed output of a multi-output kernel
+ *
+ * Bound to the kernel's o_buffer argument of the same name. All buffers of
+ * an entry share its dimensions. The first one is the primary output
+ * (verified against the verification section's golden); the others are
+ * read back, verified against their own golden and saved next to it.
+ *
+ * Config file format (outputs.json, per entry):
+ * "buffers": {
+ *     "sigma1": {"data_type": "float"},
+ *     "angle": {"data_type": "float", "golden_file": "...", "output": "...",
+ *               "tolerance": {"abs": 0.01, "rel": 0.001, "ulp": 4}}
+ * }
+ * "tolerance" follows ToleranceOverride.
+ */
+typedef struct {
+    char name[64];         /**< o_buffer name in kernel_args (e.g., "sigma2") */
+    DataType data_type;    /**< Element type (uchar or float) */
+    char golden_file[256]; /**< Golden of this output (empty: C reference output) */
+    char output_path[256]; /**< Raw file receiving this output (empty: run directory only) */
+    ToleranceOverride tolerance; /**< "tolerance" (replaces the verification section's) */
+} OutputBufferConfig;
+
 /**
  * @brief Output image configuration
  *
  * Contains parameters for a single output image, including file path
- * and image dimensions.
+ * and image dimensions. With "buffers", the entry describes every output
+ * of a multi-output kernel and data_type / output_path are the first
+ * buffer's.
  */
 typedef struct {
+    char name[64];         /**< Entry name in outputs.json (e.g., "output_1", "svd_output") */
     char output_path[256]; /**< Path to output image file */
     int dst_width;         /**< Destination image width in pixels */
     int dst_height;        /**< Destination image height in pixels */
     int dst_channels;      /**< Number of channels (e.g., 3 for RGB) */
     int dst_stride;        /**< Stride in bytes (may differ from width * channels) */
+    DataType data_type;    /**< Element type (uchar default, or float for responses/flow) */
+    OutputBufferConfig buffers[MAX_OUTPUT_BUFFERS]; /**< Named outputs (empty: single output) */
+    int buffer_count;                               /**< Number of named outputs */
 } OutputImageConfig;
 
 /* Note: MAX_CUSTOM_BUFFERS is defined in utils/op_interface.h */
 
-/** Data type enumeration for buffer elements */
-typedef enum {
-    DATA_TYPE_NONE = 0,
-    DATA_TYPE_FLOAT, /**< 32-bit floating point (4 bytes) */
-    DATA_TYPE_UCHAR, /**< 8-bit unsigned char (1 byte) */
-    DATA_TYPE_INT,   /**< 32-bit signed integer (4 bytes) */
-    DATA_TYPE_SHORT  /**< 16-bit signed integer (2 bytes) */
-} DataType;
-
 /** Maximum number of kernel arguments */
 #define MAX_KERNEL_ARGS 32
 
@@ -107,6 +180,9 @@ typedef enum {
     KERNEL_ARG_TYPE_SCALAR_FLOAT,  /**< Float scalar (float) */
     KERNEL_ARG_TYPE_SCALAR_SIZE,   /**< Size_t scalar (size_t) */
     KERNEL_ARG_TYPE_STRUCT,        /**< Struct packed from scalars */
+    KERNEL_ARG_TYPE_IMAGE_INPUT,   /**< 2D image view of the input buffer (read_only) */
+    KERNEL_ARG_TYPE_IMAGE_OUTPUT,  /**< 2D image view of the output buffer (write_only) */
+    KERNEL_ARG_TYPE_SAMPLER,       /**< Sampler for image reads (cl_sampler) */
 } KernelArgType;
 
 /**
@@ -122,6 +198,11 @@ typedef enum {
  * - param:    Scalar param  (e.g., {"param": ["int", "src_width"]})
  * - struct:   Packed struct (e.g., {"struct": ["field1", "field2", ...]})
  *             Fields reference scalars defined in the "scalars" section
+ * - i_image:  Image view of an input buffer  (e.g., {"i_image": ["uchar", "src"]})
+ * - o_image:  Image view of an output buffer (e.g., {"o_image": ["uchar", "dst"]})
+ * - sampler:  Sampler [filter, addressing] (e.g., {"sampler": ["nearest", "border"]})
+ *             Addressing "border" follows OpParams.border_mode; "clamp",
+ *             "constant", "reflect" or "wrap" fix it (see platform/image_view.h)
  */
 typedef struct {
     KernelArgType arg_type; /**< Type of argument (buffer or scalar) */
@@ -131,12 +212,55 @@ typedef struct {
                                  - For scalars: param name (e.g., "src_width", "dst_height")
                              */
     size_t buffer_size;     /**< Buffer size in bytes (0 if not specified, for buffer types only) */
+    int sampler_linear;     /**< Sampler filter: non-zero for linear (KERNEL_ARG_TYPE_SAMPLER) */
 
     /* Struct fields (for KERNEL_ARG_TYPE_STRUCT only) */
     char struct_fields[MAX_STRUCT_FIELDS][64]; /**< Array of scalar names to pack into struct */
     int struct_field_count;                    /**< Number of fields in struct */
 } KernelArgDescriptor;
 
+/** Maximum command queues a tiled dispatch spreads over */
+#define MAX_TILE_QUEUES 4
+
+/** Tile traversal order for tiled sub-dispatch */
+typedef enum {
+    TILE_ORDER_ROW_MAJOR = 0, /**< Left to right, top to bottom */
+    TILE_ORDER_Z_ORDER        /**< Morton order: neighbouring tiles run close in time */
+} TileOrder;
+
+/**
+ * @brief Tiled sub-dispatch for the cl_extension host type
+ *
+ * The NDRange is split into tiles launched with global work offsets, so
+ * kernels must index with get_global_id() (get_global_size() and
+ * get_group_id() are per tile). Tile sizes are rounded up to a multiple of
+ * the local size.
+ *
+ * Config file format (per kernel, optional):
+ * "tiling": { "tile_size": [256, 128], "order": "z_order", "queues": 2 }
+ */
+typedef struct {
+    size_t tile_size[2]; /**< Tile size in work-items (x, y); 0 = untiled dimension */
+    TileOrder order;     /**< Tile traversal order */
+    int queues;          /**< Queues the tiles are spread over round-robin (1 = caller's) */
+} TilingConfig;
+
+/**
+ * @brief Arithmetic precision of a kernel variant
+ *
+ * Reduced-precision variants are built from the same source as their fp32
+ * sibling where possible: "fp16" adds -DUSE_FP16=1 to the build options when
+ * the device reports cl_khr_fp16 (kernels then enable the extension and
+ * compute in half), and builds without it - in float - otherwise. "int"
+ * marks fixed-point/integer-math kernels; it changes no build option and
+ * only labels the variant in the precision report.
+ */
+typedef enum {
+    KERNEL_PRECISION_FP32 = 0, /**< 32-bit float (default) */
+    KERNEL_PRECISION_FP16,     /**< Half precision (cl_khr_fp16) */
+    KERNEL_PRECISION_INT       /**< Integer / fixed-point arithmetic */
+} KernelPrecision;
+
 /**
  * @brief Kernel configuration for a specific variant
  *
@@ -151,6 +275,7 @@ typedef struct KernelConfig {
     int work_dim;               /**< Work dimensions (1, 2, or 3) */
     size_t global_work_size[3]; /**< Global work size for each dimension */
     size_t local_work_size[3];  /**< Local work group size for each dimension */
+    int local_work_size_auto;   /**< Non-zero if "local_work_size": "auto" (autotuned) */
     HostType host_type;         /**< Host API type (standard or cl_extension) */
     char kernel_option[256];    /**< User-specified kernel build options (e.g.,
                                    "-cl-fast-relaxed-math"). System appends platform defines:
@@ -159,6 +284,25 @@ typedef struct KernelConfig {
                                    (v0->0, v1->1, etc.) */
     KernelArgDescriptor kernel_args[MAX_KERNEL_ARGS]; /**< Array of kernel argument descriptors */
     int kernel_arg_count;                             /**< Number of kernel arguments configured */
+    MemoryStrategy memory_strategy;                   /**< Input/output buffer strategy */
+    TilingConfig tiling;                              /**< Tiled sub-dispatch (cl_extension) */
+    char specialize_defines[256]; /**< " -DSPEC_<NAME>=<value>" for each specialized scalar the
+                                     kernel's args reference (empty with "specialize": false) */
+    int pitched; /**< Non-zero if "pitched": true: device rows padded to the device alignment,
+                    src_stride/dst_stride carry the device row pitch (copy strategy only) */
+    char epilogue[64]; /**< Elementwise op as a uchar -> uchar function or macro of the kernel
+                          file, for fusion into a stencil stage ("epilogue", empty if none) */
+    int pipeline_only; /**< Non-zero if "pipeline_only": true: not listed or run as a variant */
+    char reference[32]; /**< "reference": registered op whose C reference this kernel matches in
+                           a pipeline reference (empty: the config's own op) */
+    KernelPrecision precision; /**< "precision": "fp32" (default), "fp16" or "int" */
+    int precision_fallback;    /**< Non-zero if fp16 was requested but the device lacks
+                                  cl_khr_fp16 (built and run in fp32, see OpenclResolvePrecision) */
+    char baseline[32]; /**< "baseline": fp32 variant a reduced-precision variant is compared
+                          with in the precision report (empty: none) */
+    ToleranceOverride tolerance; /**< "tolerance": bounds of this variant (e.g. looser for fp16) */
+    int batch; /**< Non-zero if "batch": true: the kernel takes the image index from
+                  get_global_id(work_dim), so batch mode runs one work_dim + 1 dispatch */
 } KernelConfig;
 
 /**
@@ -212,6 +356,7 @@ typedef struct {
         float float_value; /**< Float value */
         size_t size_value; /**< Size value */
     } value;
+    int specialize; /**< Non-zero: also compiled in as -DSPEC_<NAME>=<value> ("specialize") */
 } ScalarArgConfig;
 
 /** Maximum number of scalar arguments */
@@ -242,19 +387,240 @@ typedef enum {
  */
 typedef struct {
     float tolerance; /**< Max per-pixel difference allowed (e.g., 0 for exact, 1 for ±1) */
+    float rel_tolerance; /**< Float outputs: also accept |diff| <= rel_tolerance * |ref| */
+    int ulp_tolerance;   /**< Float outputs: also accept elements this many ULPs apart */
     float error_rate_threshold; /**< Max fraction of pixels that can exceed tolerance (e.g., 0.001 =
                                    0.1%) */
     GoldenSourceType golden_source; /**< Source of golden sample (c_ref or file) */
     char golden_file[256];          /**< Path to golden.bin file (when golden_source = file) */
+    int reference_threads;          /**< C reference threads (0 = one per CPU, 1 = single) */
+    int early_exit;                 /**< Stop comparing once the error budget is exceeded */
+    int dump_diff;                  /**< Write |gpu - ref| to diff.bin when elements differ */
+    int on_device; /**< Benchmark iterations compare on the device (no full readback) */
 } VerificationConfig;
 
+/**
+ * @brief Benchmark configuration
+ *
+ * Enables multi-iteration benchmark mode: after the verified run, the kernel
+ * is re-dispatched warmup_iterations + iterations times reusing the already
+ * built kernel and buffers. Only the timed iterations contribute to statistics.
+ *
+ * Config file format:
+ * "benchmark": { "enabled": true, "warmup_iterations": 5, "iterations": 50 }
+ *
+ * CLI flags (--benchmark, --warmup N, --iterations N) override these values.
+ */
+typedef struct {
+    int enabled;           /**< Non-zero to run benchmark iterations */
+    int warmup_iterations; /**< Untimed iterations before measurement */
+    int iterations;        /**< Timed iterations (max MAX_BENCHMARK_ITERATIONS) */
+} BenchmarkConfig;
+
+/** Default number of in-flight buffer sets in streaming mode (double buffering) */
+#define STREAM_DEFAULT_BUFFER_SETS 2
+
+/** Maximum number of in-flight buffer sets in streaming mode (triple buffering) */
+#define MAX_STREAM_BUFFER_SETS 3
+
+/**
+ * @brief Streaming mode configuration
+ *
+ * After the verified run, the kernel is applied to every frame of a frame
+ * sequence with upload, compute and readback of consecutive frames
+ * overlapped on separate command queues (see platform/stream.h).
+ *
+ * The input is either a raw file of back-to-back frames (each the size of
+ * the configured input image) or a directory of one raw file per frame,
+ * processed in file name order.
+ *
+ * Config file format:
+ * "stream": { "enabled": true, "input": "test_data/x/frames.bin", "output": "",
+ *             "frames": 0, "buffer_sets": 2 }
+ *
+ * CLI flags (--stream PATH, --frames N, --buffer-sets N) override these values.
+ */
+typedef struct {
+    int enabled;           /**< Non-zero to run the streaming mode */
+    char input_path[256];  /**< Multi-frame raw file or directory of frames */
+    char output_path[256]; /**< Raw file receiving all output frames (empty: none) */
+    int max_frames;        /**< Frames to process (0 = all available) */
+    int buffer_sets;       /**< In-flight buffer sets (2 or MAX_STREAM_BUFFER_SETS) */
+} StreamConfig;
+
+/** Maximum number of devices used by the multi-device mode */
+#define MAX_MULTI_DEVICES 8
+
+/** Default number of split rounds (row bands) or frames (frame split) */
+#define MULTI_DEVICE_DEFAULT_ROUNDS 16
+
+/** Row-band halo not configured: taken from the op's REF_HALO_ROWS */
+#define MULTI_DEVICE_HALO_AUTO (-1)
+
+/**
+ * @brief How the multi-device mode divides the work
+ */
+typedef enum {
+    MULTI_SPLIT_ROWS = 0, /**< Each frame cut into one row band per device */
+    MULTI_SPLIT_FRAMES    /**< Whole frames of a batch dealt out to the devices */
+} MultiDeviceSplit;
+
+/**
+ * @brief Multi-device mode configuration
+ *
+ * After the verified run, the kernel is run on every OpenCL device of every
+ * platform at once (see platform/multi_device.h). Work is shared in
+ * proportion to each device's measured throughput; the ratio is refined
+ * after every round and persisted per device set.
+ *
+ * Config file format:
+ * "multi_device": { "enabled": true, "split": "rows", "halo": 2, "rounds": 16,
+ *                   "max_devices": 0 }
+ *
+ * CLI flags (--multi-device rows|frames, --devices N) override these values.
+ */
+typedef struct {
+    int enabled;            /**< Non-zero to run the multi-device mode */
+    MultiDeviceSplit split; /**< Row bands or whole frames */
+    int halo;               /**< Input rows above and below a band (MULTI_DEVICE_HALO_AUTO) */
+    int rounds;             /**< Split rounds (rows) or frames in the batch (frames) */
+    int max_devices;        /**< Devices to use (0 = all, up to MAX_MULTI_DEVICES) */
+} MultiDeviceConfig;
+
+/** Maximum number of pipelines per algorithm */
+#define MAX_PIPELINES 8
+
+/** Maximum number of stages in a pipeline */
+#define MAX_PIPELINE_STAGES 8
+
+/** Maximum number of buffer bindings per pipeline stage */
+#define MAX_PIPELINE_BINDINGS 8
+
+/** Pipeline buffer name bound to the primary input image */
+#define PIPELINE_BUFFER_INPUT "src"
+
+/** Pipeline buffer name bound to the primary output image */
+#define PIPELINE_BUFFER_OUTPUT "dst"
+
+/** Maximum levels of a pipeline pyramid (level 0 is the full-size buffer) */
+#define MAX_PYRAMID_LEVELS 6
+
+/** Maximum pyramid images (and, separately, per-level buffers) of a pipeline */
+#define MAX_PYRAMID_BUFFERS 4
+
+/** Binding suffix selecting the next coarser level of a per-level buffer */
+#define PIPELINE_COARSER_SUFFIX "@coarser"
+
+/**
+ * @brief One stage of a kernel pipeline
+ *
+ * A stage runs one kernel variant from the "kernels" section. By default its
+ * i_buffer args read the pipeline input ("src"), o_buffer args write the
+ * pipeline output ("dst") and buffer args use the named custom buffer.
+ * Bindings remap buffer args by their source name to "src", "dst" or any
+ * buffer from the "buffers" section.
+ *
+ * A stage can fuse an elementwise kernel (one with an "epilogue") into its
+ * kernel: the two sources are combined into one generated kernel that
+ * applies the epilogue to every stored output value (see platform/fusion.h).
+ *
+ * A "coarse_to_fine" stage of a pipeline with a pyramid is launched once per
+ * level, coarsest first. Pyramid images and level buffers bind to their
+ * plane at the launch level; "<buffer>@coarser" binds a level buffer's plane
+ * of the next coarser level (zero-filled beyond the coarsest level).
+ *
+ * Config file format:
+ * {"kernel": "v0", "bind": {"dst": "response"}}
+ * {"kernel": "blur", "fuse": "v0"}
+ * {"kernel": "v5_pyrlk", "coarse_to_fine": true, "bind": {"coarse_x": "dst@coarser"}}
+ */
+typedef struct {
+    char kernel_id[32];                          /**< Variant id in "kernels" */
+    char fuse_kernel_id[32];                     /**< Elementwise kernel fused in (empty: none) */
+    int coarse_to_fine;                          /**< Non-zero: one launch per pyramid level */
+    char bind_arg[MAX_PIPELINE_BINDINGS][64];    /**< Kernel arg source names */
+    char bind_buffer[MAX_PIPELINE_BINDINGS][64]; /**< Pipeline buffer per binding */
+    int bind_count;                              /**< Number of bindings */
+} PipelineStageConfig;
+
+/** Maximum "output_goldens" of a pipeline (every named output after the primary one) */
+#define MAX_PIPELINE_GOLDENS (MAX_OUTPUT_BUFFERS - 1)
+
+/**
+ * @brief Golden of a named output written by a pipeline
+ *
+ * Replaces the output's single-variant golden from outputs.json, since a
+ * pipeline usually writes something else into it.
+ */
+typedef struct {
+    char output[64];       /**< Named output (outputs.json "buffers") and pipeline buffer */
+    char golden_file[256]; /**< Golden of that output after the pipeline */
+} PipelineGolden;
+
+/**
+ * @brief Multi-kernel pipeline
+ *
+ * Stages are enqueued back-to-back with event dependencies derived from the
+ * buffers they share; the host only reads back the final "dst" output.
+ *
+ * An optional pyramid gives "images" device-side levels built by the
+ * "downsample" kernel before the stages run (level l + 1 is half of level l,
+ * rounded up), and "level_buffers" one plane per level for coarse-to-fine
+ * stages. "levels" is a number or the name of an int scalar.
+ *
+ * Config file format:
+ * "pipeline": {
+ *   "p0": {
+ *     "description": "response + NMS",
+ *     "golden_file": "test_data/algo/golden.bin",   (optional: stage C references chained)
+ *     "tolerance": 1,                               (optional)
+ *     "output_goldens": {"flow_y": "test_data/algo/golden_y.bin"},   (optional)
+ *     "pyramid": {"levels": 3, "downsample": "v4_pyrdown", "images": ["src"],
+ *                 "level_buffers": ["dst"]},      (optional)
+ *     "stages": [ {"kernel": "v0", "bind": {"dst": "tmp"}}, {"kernel": "v1"} ]
+ *   }
+ * }
+ */
+typedef struct PipelineConfig {
+    char pipeline_id[32];                            /**< Pipeline identifier (CLI selector) */
+    char description[128];                           /**< Human-readable description */
+    char golden_file[256];                           /**< Optional golden for the final output */
+    ToleranceOverride tolerance;                     /**< "tolerance" of the final output */
+    PipelineGolden goldens[MAX_PIPELINE_GOLDENS];    /**< "output_goldens" of named outputs */
+    int golden_count;                                /**< Number of output goldens */
+    PipelineStageConfig stages[MAX_PIPELINE_STAGES]; /**< Stages in execution order */
+    int stage_count;                                 /**< Number of stages */
+    int pyramid_levels;                              /**< Pyramid levels (0: no pyramid) */
+    char pyramid_kernel_id[32];                      /**< Downsample kernel building a level */
+    char pyramid_images[MAX_PYRAMID_BUFFERS][64];    /**< Buffers downsampled into levels */
+    int pyramid_image_count;                         /**< Number of pyramid images */
+    char level_buffers[MAX_PYRAMID_BUFFERS][64];     /**< Buffers with one plane per level */
+    int level_buffer_count;                          /**< Number of level buffers */
+} PipelineConfig;
+
+/**
+ * @brief Results output configuration
+ *
+ * results.json is always written to the run directory; CSV and the
+ * event timeline trace (trace.json, Chrome trace format) are optional.
+ *
+ * Config file format:
+ * "results": { "csv": true, "trace": true }
+ *
+ * CLI flags --csv and --trace override these values.
+ */
+typedef struct {
+    int write_csv;   /**< Non-zero to also write results.csv */
+    int write_trace; /**< Non-zero to also write trace.json */
+} ResultsConfig;
+
 /**
  * @brief Complete configuration parsed from config file
  *
  * Contains all settings needed to run the OpenCL image processing
  * framework, including image parameters and all kernel variants.
  */
-typedef struct {
+typedef struct Config {
     char op_id[32]; /**< Algorithm identifier (e.g., "dilate3x3") */
 
     /* Input images configuration (from config/inputs.json) */
@@ -281,6 +647,22 @@ typedef struct {
 
     /* Verification configuration */
     VerificationConfig verification; /**< Verification settings (tolerance, error rate) */
+
+    /* Benchmark configuration */
+    BenchmarkConfig benchmark; /**< Multi-iteration benchmark settings */
+
+    /* Streaming mode configuration */
+    StreamConfig stream; /**< Multi-frame streaming settings */
+
+    /* Multi-device configuration */
+    MultiDeviceConfig multi_device; /**< Row-band or frame split across devices */
+
+    /* Results output configuration */
+    ResultsConfig results; /**< Machine-readable results settings */
+
+    /* Multi-kernel pipelines */
+    PipelineConfig pipelines[MAX_PIPELINES]; /**< Pipeline definitions */
+    int pipeline_count;                      /**< Number of pipelines configured */
 } Config;
 
 /**
@@ -299,7 +681,9 @@ int ParseConfig(const char* filename, Config* config);
  * @brief Parse input images configuration file
  *
  * Reads and parses a JSON inputs configuration file with multiple
- * image_N entries, populating the input_images array in Config.
+ * image_N entries, populating the input_images array in Config. Entries
+ * with other names (e.g., "svd_input") follow the numbered ones and are
+ * selected by name.
  *
  * @param[in] filename Path to inputs configuration file (e.g., config/inputs.json)
  * @param[out] config Configuration structure to populate with input images
@@ -311,7 +695,10 @@ int ParseInputsConfig(const char* filename, Config* config);
  * @brief Parse output images configuration file
  *
  * Reads and parses a JSON outputs configuration file with multiple
- * output_N entries, populating the output_images array in Config.
+ * output_N entries, populating the output_images array in Config. Entries
+ * with other names (e.g., "svd_output") follow the numbered ones and are
+ * selected by name; an entry may list the named outputs of a
+ * multi-output kernel under "buffers" (see OutputBufferConfig).
  *
  * @param[in] filename Path to outputs configuration file (e.g., config/outputs.json)
  * @param[out] config Configuration structure to populate with output images
@@ -335,6 +722,57 @@ int ParseOutputsConfig(const char* filename, Config* config);
  */
 int GetOpVariants(const Config* config, const char* op_id, KernelConfig* variants[], int* count);
 
+/**
+ * @brief Check whether a selector names a variant
+ *
+ * The 'v' prefix of the variant id is optional: "1f" and "v1f" both select
+ * v1f. Used by the command line, working sets and server mode alike.
+ *
+ * @param[in] kernel_cfg Variant
+ * @param[in] selector Variant id as requested (need not be terminated)
+ * @param[in] selector_len Number of selector characters
+ * @return 1 if @p selector names @p kernel_cfg, 0 otherwise
+ */
+int VariantMatchesSelector(const KernelConfig* kernel_cfg, const char* selector,
+                           size_t selector_len);
+
+/**
+ * @brief Find a kernel configuration by variant id
+ *
+ * @param[in] config Parsed configuration
+ * @param[in] variant_id Variant identifier (e.g., "v0")
+ * @return Kernel configuration, or NULL if not found
+ */
+const KernelConfig* FindKernelConfig(const Config* config, const char* variant_id);
+
+/**
+ * @brief Find a pipeline by id
+ *
+ * @param[in] config Parsed configuration
+ * @param[in] pipeline_id Pipeline identifier
+ * @return Pipeline configuration, or NULL if not found
+ */
+const PipelineConfig* FindPipelineConfig(const Config* config, const char* pipeline_id);
+
+/**
+ * @brief Compose -D options for the config scalars a kernel's args reference
+ *
+ * Each scalar read by one of the kernel's arguments (as a param or a
+ * struct field) becomes " -D<prefix><NAME>=<value>", with the name
+ * upper-cased and non-alphanumeric characters as '_'; floats are written
+ * as 'f'-suffixed literals.
+ *
+ * @param[in] config Configuration (scalars)
+ * @param[in] kernel_cfg Kernel whose arguments select the scalars
+ * @param[in] prefix Macro name prefix (e.g., "SPEC_")
+ * @param[in] specialized_only Non-zero to include only scalars with "specialize": true
+ * @param[out] out Option string (empty if no scalar matches)
+ * @param[in] out_size Size of out
+ * @return 0 on success, -1 if the options do not fit
+ */
+int ComposeScalarDefines(const Config* config, const KernelConfig* kernel_cfg, const char* prefix,
+                         int specialized_only, char* out, size_t out_size);
+
 /**
  * @brief Resolve config path from algorithm name
  *
@@ -362,3 +800,12 @@ int ResolveConfigPath(const char* input, char* output, size_t output_size);
  * @return 0 on success, -1 on error
  */
 int ExtractOpIdFromPath(const char* config_path, char* op_id, size_t op_id_size);
+
+/**
+ * @brief Parse a multi-device split name
+ *
+ * @param[in] str "rows" or "frames"
+ * @param[out] split Parsed split
+ * @return 0 on success, -1 if the name is unknown
+ */
+int ParseMultiDeviceSplit(const char* str, MultiDeviceSplit* split);
@@ -0,0 +1,96 @@
+/**
+ * @file cpu_features.c
+ * @brief Runtime CPU SIMD detection for the C reference implementations
+ */
+
+#include "utils/cpu_features.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Cached level, set once by InitSimdLevel */
+static CpuSimd cached_level = CPU_SIMD_SCALAR;
+static pthread_once_t detect_once = PTHREAD_ONCE_INIT;
+
+/* Widest level the CPU (and OS, for AVX state) supports */
+static CpuSimd DetectSimdLevel(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return CPU_SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return CPU_SIMD_SSE2;
+    }
+    return CPU_SIMD_SCALAR;
+#elif defined(__aarch64__)
+    /* AdvSIMD is mandatory on AArch64 (ARMv7 NEON floats are not IEEE exact) */
+    return CPU_SIMD_NEON;
+#else
+    return CPU_SIMD_SCALAR;
+#endif
+}
+
+/* True if 'requested' may replace 'available' (same ISA family, not wider) */
+static bool IsAllowedOverride(CpuSimd requested, CpuSimd available) {
+    if (requested == CPU_SIMD_SCALAR) {
+        return true;
+    }
+    if (requested == CPU_SIMD_NEON) {
+        return available == CPU_SIMD_NEON;
+    }
+    /* SSE2 / AVX2 */
+    return (available != CPU_SIMD_NEON) && (requested <= available);
+}
+
+/* Detect and apply the OPENCL_REF_SIMD override (runs once) */
+static void InitSimdLevel(void) {
+    const char* override;
+    CpuSimd requested;
+    CpuSimd level;
+    int i;
+
+    level = DetectSimdLevel();
+
+    override = getenv("OPENCL_REF_SIMD");
+    if ((override != NULL) && (override[0] != '\0')) {
+        requested = level;
+        for (i = (int)CPU_SIMD_SCALAR; i <= (int)CPU_SIMD_NEON; i++) {
+            if (strcmp(override, CpuSimdName((CpuSimd)i)) == 0) {
+                requested = (CpuSimd)i;
+                break;
+            }
+        }
+        if ((i > (int)CPU_SIMD_NEON) || !IsAllowedOverride(requested, level)) {
+            (void)fprintf(stderr, "Warning: OPENCL_REF_SIMD=%s not available, using %s\n",
+                          override, CpuSimdName(level));
+        } else {
+            level = requested;
+        }
+    }
+
+    cached_level = level;
+}
+
+CpuSimd CpuSimdLevel(void) {
+    /* Reference bands call this concurrently from the thread pool */
+    (void)pthread_once(&detect_once, InitSimdLevel);
+    return cached_level;
+}
+
+const char* CpuSimdName(CpuSimd level) {
+    switch (level) {
+        case CPU_SIMD_SSE2:
+            return "sse2";
+        case CPU_SIMD_AVX2:
+            return "avx2";
+        case CPU_SIMD_NEON:
+            return "neon";
+        case CPU_SIMD_SCALAR:
+        default:
+            return "scalar";
+    }
+}
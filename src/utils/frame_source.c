@@ -0,0 +1,150 @@
+/**
+ * @file frame_source.c
+ * @brief Sequential frame reader for the streaming mode
+ */
+
+#include "frame_source.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
+static char frame_files[MAX_FRAME_SOURCE_FILES][512];
+
+/* qsort comparator for file paths */
+static int ComparePath(const void* a, const void* b) {
+    return strcmp((const char*)a, (const char*)b);
+}
+
+/* Collect and sort the regular files of a directory, returns count or -1 */
+static int ListFrameFiles(const char* dir_path) {
+    DIR* dir;
+    const struct dirent* entry;
+    struct stat st;
+    int count = 0;
+    int written;
+
+    dir = opendir(dir_path);
+    if (dir == NULL) {
+        (void)fprintf(stderr, "Error: Failed to open frame directory: %s\n", dir_path);
+        return -1;
+    }
+
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        if (count >= MAX_FRAME_SOURCE_FILES) {
+            (void)fprintf(stderr, "Warning: More than %d frame files, ignoring the rest\n",
+                          MAX_FRAME_SOURCE_FILES);
+            break;
+        }
+        written = snprintf(frame_files[count], sizeof(frame_files[count]), "%s/%s", dir_path,
+                           entry->d_name);
+        if ((written < 0) || ((size_t)written >= sizeof(frame_files[count]))) {
+            (void)fprintf(stderr, "Warning: Frame path too long, skipping %s\n", entry->d_name);
+            continue;
+        }
+        if ((stat(frame_files[count], &st) != 0) || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        count++;
+    }
+    (void)closedir(dir);
+
+    qsort(frame_files, (size_t)count, sizeof(frame_files[0]), ComparePath);
+    return count;
+}
+
+int FrameSourceOpen(const char* path, size_t frame_size, int max_frames, FrameSource* source) {
+    struct stat st;
+    long available;
+
+    if ((path == NULL) || (frame_size == 0U) || (max_frames < 0) || (source == NULL)) {
+        (void)fprintf(stderr, "Error: Invalid parameters for FrameSourceOpen\n");
+        return -1;
+    }
+
+    (void)memset(source, 0, sizeof(*source));
+    source->frame_size = frame_size;
+
+    if (stat(path, &st) != 0) {
+        (void)fprintf(stderr, "Error: Frame source not found: %s\n", path);
+        return -1;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        source->is_directory = 1;
+        available = (long)ListFrameFiles(path);
+        if (available < 0) {
+            return -1;
+        }
+    } else {
+        if (MappedFileOpen(path, frame_size, &source->file_map) != 0) {
+            return -1;
+        }
+        available = (long)(source->file_map.size / frame_size);
+        if ((source->file_map.size % frame_size) != 0U) {
+            (void)fprintf(stderr, "Warning: %s is not a whole number of %zu-byte frames\n", path,
+                          frame_size);
+        }
+    }
+
+    if (available == 0) {
+        (void)fprintf(stderr, "Error: No %zu-byte frames in %s\n", frame_size, path);
+        FrameSourceClose(source);
+        return -1;
+    }
+
+    if ((max_frames > 0) && ((long)max_frames < available)) {
+        available = (long)max_frames;
+    }
+    source->frame_count = (int)available;
+    return 0;
+}
+
+int FrameSourceRead(FrameSource* source, unsigned char* staging, const unsigned char** frame) {
+    FILE* fp;
+    size_t read_count;
+    const char* path;
+
+    if ((source == NULL) || (frame == NULL) || (source->next_frame >= source->frame_count) ||
+        ((source->is_directory != 0) && (staging == NULL))) {
+        return -1;
+    }
+
+    if (source->is_directory == 0) {
+        /* In place: no copy, pages are faulted in as the upload reads them */
+        *frame = source->file_map.data + ((size_t)source->next_frame * source->frame_size);
+        source->next_frame++;
+        return 0;
+    }
+
+    /* Per-frame files are opened here; ReadImageToBuffer would log every frame */
+    path = frame_files[source->next_frame];
+    fp = fopen(path, "rb");
+    if (fp == NULL) {
+        (void)fprintf(stderr, "Error: Failed to open frame: %s\n", path);
+        return -1;
+    }
+    read_count = fread(staging, 1U, source->frame_size, fp);
+    (void)fclose(fp);
+    if (read_count != source->frame_size) {
+        (void)fprintf(stderr, "Error: Failed to read frame %d (read %zu of %zu bytes)\n",
+                      source->next_frame, read_count, source->frame_size);
+        return -1;
+    }
+
+    *frame = staging;
+    source->next_frame++;
+    return 0;
+}
+
+void FrameSourceClose(FrameSource* source) {
+    if (source != NULL) {
+        MappedBufferRelease(&source->file_map);
+    }
+}
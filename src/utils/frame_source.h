@@ -0,0 +1,78 @@
+/**
+ * @file frame_source.h
+ * @brief Sequential frame reader for the streaming mode
+ *
+ * A frame source is either:
+ * - A raw file of back-to-back frames (frame count = file size / frame size).
+ *   The file is memory-mapped and frames are handed out in place, so long
+ *   sequences are neither copied nor size-capped.
+ * - A directory with one raw file per frame, read in file name order
+ *   (hidden files are skipped) into a caller-provided staging buffer
+ *
+ * Only one frame source can be open at a time (directory entries are kept
+ * in static storage).
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: Uses static storage for directory entries, no dynamic allocation
+ * - Rule 17.7: All functions return status for error checking
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "mapped_file.h"
+
+/** Maximum number of frame files in a directory frame source */
+#define MAX_FRAME_SOURCE_FILES 1024
+
+/**
+ * @brief Open frame sequence
+ */
+typedef struct {
+    MappedBuffer file_map; /**< Raw multi-frame file mapping (empty for a directory) */
+    int is_directory;      /**< Non-zero if frames come from a directory */
+    size_t frame_size;     /**< Bytes per frame */
+    int frame_count;       /**< Frames available (after the max_frames limit) */
+    int next_frame;        /**< Index of the next frame to read */
+} FrameSource;
+
+/**
+ * @brief Open a frame sequence
+ *
+ * For a raw file, trailing bytes that do not form a full frame are ignored
+ * with a warning. For a directory, every file must be frame_size
+ * bytes or more (only the first frame_size bytes are used, checked when
+ * the frame is read).
+ *
+ * @param[in] path Multi-frame raw file or directory
+ * @param[in] frame_size Bytes per frame
+ * @param[in] max_frames Maximum frames to deliver (0 = all available)
+ * @param[out] source Opened frame source
+ * @return 0 on success, -1 on error (including an empty sequence)
+ */
+int FrameSourceOpen(const char* path, size_t frame_size, int max_frames, FrameSource* source);
+
+/**
+ * @brief Get the next frame
+ *
+ * Raw file sources return a pointer into the mapping (valid until
+ * FrameSourceClose) and leave staging untouched; directory sources read
+ * the frame file into staging and return staging.
+ *
+ * @param[in,out] source Frame source
+ * @param[out] staging Destination for directory sources (at least frame_size bytes,
+ *                     may be NULL for raw file sources)
+ * @param[out] frame Frame data
+ * @return 0 on success, -1 on error or when no frames are left
+ */
+int FrameSourceRead(FrameSource* source, unsigned char* staging, const unsigned char** frame);
+
+/**
+ * @brief Close a frame source
+ *
+ * Unmaps a raw file source: frames returned by FrameSourceRead become invalid.
+ *
+ * @param[in,out] source Frame source (safe to call on a failed open)
+ */
+void FrameSourceClose(FrameSource* source);
@@ -4,10 +4,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "mapped_file.h"
+
 /* MISRA-C:2023 Rule 21.3: Avoid dynamic memory allocation */
-/* Using static buffers with maximum size constraints */
-#define MAX_IMAGE_SIZE (4096 * 4096) /* Maximum 16MB buffer */
-static unsigned char image_buffer[MAX_IMAGE_SIZE];
+/* Current input image mapping (replaced by each ReadImage call) */
+static MappedBuffer image_mapping;
 
 int ReadImageToBuffer(const char* filename, size_t size, unsigned char* buffer) {
     FILE* fp;
@@ -41,18 +42,23 @@ int ReadImageToBuffer(const char* filename, size_t size, unsigned char* buffer)
 }
 
 unsigned char* ReadImage(const char* filename, size_t size) {
-    /* Check if data fits in static buffer */
-    if (size > MAX_IMAGE_SIZE) {
-        (void)fprintf(stderr, "Error: Data too large (%zu bytes, max %d)\n", size,
-                      MAX_IMAGE_SIZE);
+    ReleaseImage();
+
+    if ((filename == NULL) || (size == 0U)) {
+        (void)fprintf(stderr, "Error: Invalid parameters for ReadImage\n");
         return NULL;
     }
 
-    if (ReadImageToBuffer(filename, size, image_buffer) != 0) {
+    if (MappedFileOpen(filename, size, &image_mapping) != 0) {
         return NULL;
     }
 
-    return image_buffer;
+    (void)printf("Mapped %zu bytes from %s\n", size, filename);
+    return image_mapping.data;
+}
+
+void ReleaseImage(void) {
+    MappedBufferRelease(&image_mapping);
 }
 
 int WriteImage(const char* filename, const unsigned char* data, size_t size) {
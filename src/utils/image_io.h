@@ -8,7 +8,7 @@
  * File format: Raw binary, no header
  *
  * MISRA C 2023 Compliance:
- * - Rule 21.3: Uses static buffers, avoids dynamic allocation
+ * - Rule 21.3: No malloc; ReadImage memory-maps the file (see mapped_file.h)
  * - Rule 8.13: Const-correct parameters
  */
 
@@ -17,20 +17,29 @@
 #include <stddef.h>
 
 /**
- * @brief Read raw binary data from file
+ * @brief Map raw binary data from file
  *
- * Reads a binary file into a static buffer. The file must contain
- * exactly the specified number of bytes.
+ * Memory-maps the file instead of copying it, so there is no size cap and
+ * pages are loaded on first access. The mapping is page aligned and
+ * copy-on-write (writes never reach the file). The file must contain at
+ * least the specified number of bytes.
  *
  * @param[in] filename Path to input file
- * @param[in] size Number of bytes to read
- * @return Pointer to static buffer containing data, or NULL on error
+ * @param[in] size Number of bytes needed
+ * @return Pointer to the mapped data, or NULL on error
  *
- * @note Returns pointer to static buffer - not thread-safe
- * @note Size must not exceed MAX_IMAGE_SIZE (defined in implementation)
+ * @note Only one image is mapped at a time: the pointer stays valid until
+ *       the next ReadImage or ReleaseImage call - not thread-safe
  */
 unsigned char* ReadImage(const char* filename, size_t size);
 
+/**
+ * @brief Unmap the image returned by the last ReadImage call
+ *
+ * Safe to call when no image is mapped.
+ */
+void ReleaseImage(void);
+
 /**
  * @brief Read raw binary data from file into user-provided buffer
  *
@@ -0,0 +1,92 @@
+/**
+ * @file mapped_file.c
+ * @brief Memory-mapped file and page-backed buffer helpers
+ */
+
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+int MappedFileOpen(const char* path, size_t min_size, MappedBuffer* buffer) {
+    struct stat st;
+    void* addr;
+    int fd;
+
+    if ((path == NULL) || (buffer == NULL)) {
+        (void)fprintf(stderr, "Error: Invalid parameters for MappedFileOpen\n");
+        return -1;
+    }
+    (void)memset(buffer, 0, sizeof(*buffer));
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        (void)fprintf(stderr, "Error: Failed to open file: %s\n", path);
+        return -1;
+    }
+
+    if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode)) {
+        (void)fprintf(stderr, "Error: Not a regular file: %s\n", path);
+        (void)close(fd);
+        return -1;
+    }
+    if ((st.st_size <= 0) || ((size_t)st.st_size < min_size)) {
+        (void)fprintf(stderr, "Error: File too small: %s (%lld bytes, need %zu)\n", path,
+                      (long long)st.st_size, (min_size > 0U) ? min_size : 1U);
+        (void)close(fd);
+        return -1;
+    }
+
+    addr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    /* The mapping keeps its own reference to the file */
+    (void)close(fd);
+    if (addr == MAP_FAILED) {
+        (void)fprintf(stderr, "Error: Failed to map file: %s\n", path);
+        return -1;
+    }
+
+    buffer->data = (unsigned char*)addr;
+    buffer->size = (size_t)st.st_size;
+    buffer->length = (size_t)st.st_size;
+    return 0;
+}
+
+int MappedBufferAlloc(size_t size, MappedBuffer* buffer) {
+    void* addr;
+
+    if ((size == 0U) || (buffer == NULL)) {
+        (void)fprintf(stderr, "Error: Invalid parameters for MappedBufferAlloc\n");
+        return -1;
+    }
+    (void)memset(buffer, 0, sizeof(*buffer));
+
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+        (void)fprintf(stderr, "Error: Failed to allocate %zu-byte buffer\n", size);
+        return -1;
+    }
+
+    buffer->data = (unsigned char*)addr;
+    buffer->size = size;
+    buffer->length = size;
+    return 0;
+}
+
+void MappedBufferRelease(MappedBuffer* buffer) {
+    if ((buffer != NULL) && (buffer->data != NULL)) {
+        if (munmap(buffer->data, buffer->length) != 0) {
+            (void)fprintf(stderr, "Warning: Failed to unmap %zu-byte buffer\n", buffer->length);
+        }
+        buffer->data = NULL;
+        buffer->size = 0U;
+        buffer->length = 0U;
+    }
+}
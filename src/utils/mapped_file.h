@@ -0,0 +1,59 @@
+/**
+ * @file mapped_file.h
+ * @brief Memory-mapped file and page-backed buffer helpers
+ *
+ * Replaces fixed-size static buffers for large data: files are mapped
+ * instead of copied (pages are loaded on first access and shared with the
+ * page cache), and scratch buffers are anonymous mappings sized on demand.
+ * Both are page aligned, so they can back CL_MEM_USE_HOST_PTR buffers.
+ *
+ * File mappings are private (copy-on-write): writes through data are
+ * allowed but never reach the file.
+ *
+ * MISRA C 2023 Compliance:
+ * - Rule 21.3: No malloc/free; memory comes from mmap and is released with munmap
+ * - Rule 17.7: All functions return status for error checking
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * @brief Mapped file or anonymous page-backed buffer
+ */
+typedef struct {
+    unsigned char* data; /**< Start of the mapping (NULL if not mapped) */
+    size_t size;         /**< Usable bytes (file size, or requested size) */
+    size_t length;       /**< Mapped length passed to munmap */
+} MappedBuffer;
+
+/**
+ * @brief Map a whole file (private, read/write copy-on-write)
+ *
+ * @param[in] path File to map
+ * @param[in] min_size Minimum file size in bytes (0 = any non-empty file)
+ * @param[out] buffer Mapping (buffer->size is the file size)
+ * @return 0 on success, -1 on error (missing, empty or too small file)
+ */
+int MappedFileOpen(const char* path, size_t min_size, MappedBuffer* buffer);
+
+/**
+ * @brief Allocate a zero-filled anonymous page-backed buffer
+ *
+ * Pages are only committed when first touched, so oversizing is cheap.
+ *
+ * @param[in] size Buffer size in bytes (> 0)
+ * @param[out] buffer Mapping
+ * @return 0 on success, -1 on error
+ */
+int MappedBufferAlloc(size_t size, MappedBuffer* buffer);
+
+/**
+ * @brief Unmap a buffer from MappedFileOpen or MappedBufferAlloc
+ *
+ * Safe to call on a zeroed or already released buffer.
+ *
+ * @param[in,out] buffer Mapping to release (reset to empty)
+ */
+void MappedBufferRelease(MappedBuffer* buffer);
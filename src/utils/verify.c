@@ -1,81 +1,780 @@
 #include "utils/verify.h"
 
 #include <math.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
+#include "utils/cpu_features.h"
 #include "utils/safe_ops.h"
 
-int VerifyExactMatch(unsigned char* gpu_output, unsigned char* ref_output, int width, int height,
-                     int channels, int tolerance) {
-    int errors = 0;
-    int total_elements;
-    int temp_size;
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VERIFY_SIMD_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define VERIFY_SIMD_NEON 1
+#endif
+
+/** Elements per block; identical blocks are counted without a per-element pass */
+#define VERIFY_BLOCK_ELEMENTS 64
+
+/** Minimum elements per thread; smaller images are compared on the calling thread */
+#define VERIFY_MIN_CHUNK_ELEMENTS 65536U
+
+/** Diff image bytes written per fwrite() */
+#define VERIFY_DIFF_CHUNK_BYTES 65536U
+
+/** One thread's share of a comparison */
+typedef struct {
+    const unsigned char* gpu;                /**< GPU output bytes */
+    const unsigned char* ref;                /**< Reference output bytes */
+    VerifyElementType type;                  /**< Element type */
+    CpuSimd simd;                            /**< Instruction set for the identical-block test */
+    size_t begin;                            /**< First element */
+    size_t end;                              /**< One past the last element */
+    float tolerance;                         /**< Max |diff| not counted as an error */
+    float rel_tolerance;                     /**< Relative bound (float, 0: off) */
+    int ulp_tolerance;                       /**< ULP bound (float, 0: off) */
+    float bin_unit;                          /**< Histogram unit u */
+    size_t budget;                           /**< Errors allowed before early exit */
+    int early_exit;                          /**< Stop once errors exceed budget */
+    size_t errors;                           /**< Elements above tolerance */
+    size_t histogram[VERIFY_HISTOGRAM_BINS]; /**< |diff| distribution */
+    float max_error;                         /**< Largest |diff| (INFINITY if non-finite) */
+    size_t worst_index;                      /**< Element holding max_error */
+    int has_worst;                           /**< Non-zero once an element differs */
+    int stopped;                             /**< Non-zero if stopped early */
+} VerifyChunk;
+
+/* MISRA-C:2023 Rule 21.3: Static work table, no dynamic allocation (not reentrant) */
+static VerifyChunk chunks[VERIFY_MAX_THREADS];
+static pthread_t chunk_threads[VERIFY_MAX_THREADS];
+static unsigned char diff_chunk[VERIFY_DIFF_CHUNK_BYTES];
+/* Per-comparison uchar tables: bin of each |diff|, and byte thresholds (see UcharBlockSse2) */
+static unsigned char uchar_bins[256];
+static unsigned char uchar_thresholds[VERIFY_HISTOGRAM_BINS];
+
+/*
+ * Identical-block skip: most elements of a passing output match their
+ * reference exactly, so runs of whole blocks are compared as raw bytes and
+ * only blocks that differ anywhere get the per-element pass. Byte equality
+ * implies |diff| == 0 for both element types, so the result does not
+ * depend on the instruction set. Each returns the number of leading blocks
+ * (of block_bytes, a multiple of 64) that are identical.
+ */
+#if defined(VERIFY_SIMD_X86)
+__attribute__((target("sse2"))) static size_t EqualBlocksSse2(const unsigned char* a,
+                                                              const unsigned char* b,
+                                                              size_t block_bytes, size_t blocks) {
+    size_t n;
+    size_t i;
+    __m128i diff;
+
+    for (n = 0U; n < blocks; n++) {
+        diff = _mm_setzero_si128();
+        for (i = 0U; i < block_bytes; i += 16U) {
+            diff = _mm_or_si128(diff, _mm_xor_si128(_mm_loadu_si128((const __m128i*)(a + i)),
+                                                    _mm_loadu_si128((const __m128i*)(b + i))));
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF) {
+            break;
+        }
+        a += block_bytes;
+        b += block_bytes;
+    }
+    return n;
+}
+
+__attribute__((target("avx2"))) static size_t EqualBlocksAvx2(const unsigned char* a,
+                                                              const unsigned char* b,
+                                                              size_t block_bytes, size_t blocks) {
+    size_t n;
+    size_t i;
+    __m256i diff;
+
+    for (n = 0U; n < blocks; n++) {
+        diff = _mm256_setzero_si256();
+        for (i = 0U; i < block_bytes; i += 32U) {
+            diff = _mm256_or_si256(
+                diff, _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                       _mm256_loadu_si256((const __m256i*)(b + i))));
+        }
+        if (_mm256_testz_si256(diff, diff) == 0) {
+            break;
+        }
+        a += block_bytes;
+        b += block_bytes;
+    }
+    return n;
+}
+#endif
+
+#if defined(VERIFY_SIMD_NEON)
+static size_t EqualBlocksNeon(const unsigned char* a, const unsigned char* b, size_t block_bytes,
+                              size_t blocks) {
+    size_t n;
+    size_t i;
+    uint8x16_t diff;
+
+    for (n = 0U; n < blocks; n++) {
+        diff = vdupq_n_u8(0U);
+        for (i = 0U; i < block_bytes; i += 16U) {
+            diff = vorrq_u8(diff, veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+        }
+        if (vmaxvq_u8(diff) != 0U) {
+            break;
+        }
+        a += block_bytes;
+        b += block_bytes;
+    }
+    return n;
+}
+#endif
+
+static size_t EqualBlocks(CpuSimd simd, const unsigned char* a, const unsigned char* b,
+                          size_t block_bytes, size_t blocks) {
+    size_t n;
+
+#if defined(VERIFY_SIMD_X86)
+    if (simd == CPU_SIMD_AVX2) {
+        return EqualBlocksAvx2(a, b, block_bytes, blocks);
+    }
+    if (simd == CPU_SIMD_SSE2) {
+        return EqualBlocksSse2(a, b, block_bytes, blocks);
+    }
+#elif defined(VERIFY_SIMD_NEON)
+    if (simd == CPU_SIMD_NEON) {
+        return EqualBlocksNeon(a, b, block_bytes, blocks);
+    }
+#endif
+    (void)simd;
+    for (n = 0U; n < blocks; n++) {
+        if (memcmp(a + (n * block_bytes), b + (n * block_bytes), block_bytes) != 0) {
+            break;
+        }
+    }
+    return n;
+}
+
+/* Histogram bin of a non-negative |diff| (see VERIFY_HISTOGRAM_BINS) */
+static int HistogramBin(float diff, float unit) {
+    int bin = 1;
+    float bound = unit;
+
+    if (diff == 0.0f) {
+        return 0;
+    }
+    while ((bin < (VERIFY_HISTOGRAM_BINS - 1)) && !(diff <= bound)) {
+        bound *= 2.0f;
+        bin++;
+    }
+    return bin;
+}
+
+/* |diff| of element i; non-finite differences (NaN, inf - inf) become INFINITY */
+static float ElementDiff(const VerifyChunk* chunk, size_t i) {
+    float g;
+    float r;
+    float diff;
+
+    if (chunk->type == VERIFY_ELEMENT_UCHAR) {
+        return (float)abs((int)chunk->gpu[i] - (int)chunk->ref[i]);
+    }
+    (void)memcpy(&g, chunk->gpu + (i * sizeof(float)), sizeof(float));
+    (void)memcpy(&r, chunk->ref + (i * sizeof(float)), sizeof(float));
+    if (memcmp(&g, &r, sizeof(float)) == 0) {
+        return 0.0f; /* Identical bits, including matching NaNs */
+    }
+    diff = fabsf(g - r);
+    return isfinite(diff) ? diff : INFINITY;
+}
+
+/* Record a non-zero |diff| as the worst so far (first strict maximum wins) */
+static void TrackWorst(VerifyChunk* chunk, size_t i, float diff) {
+    if ((chunk->has_worst == 0) || (diff > chunk->max_error)) {
+        chunk->max_error = diff;
+        chunk->worst_index = i;
+        chunk->has_worst = 1;
+    }
+}
+
+/* Element pass over uchar elements [begin, end); bins come from the 256-entry table */
+static void CompareUcharRun(VerifyChunk* chunk, size_t begin, size_t end) {
+    size_t i;
     int diff;
-    int i;
-    int actual_channels = (channels > 0) ? channels : 1;
 
-    if ((gpu_output == NULL) || (ref_output == NULL)) {
+    for (i = begin; i < end; i++) {
+        diff = abs((int)chunk->gpu[i] - (int)chunk->ref[i]);
+        chunk->histogram[uchar_bins[diff]]++;
+        if ((float)diff > chunk->tolerance) {
+            chunk->errors++;
+        }
+        if (diff > 0) {
+            TrackWorst(chunk, i, (float)diff);
+        }
+    }
+}
+
+/*
+ * Vector pass over one differing uchar block. For integer |diff| every
+ * histogram bound and the tolerance reduce to a byte threshold t
+ * (|diff| > bound  <=>  |diff| > t, with t capped at 255), so a block is
+ * summarized by how many elements lie at or below each threshold plus its
+ * largest |diff|. thresholds[0 .. BINS-2] are the bin upper bounds (0, u,
+ * 2u, ...), thresholds[BINS-1] the tolerance.
+ */
+#if defined(VERIFY_SIMD_X86)
+__attribute__((target("sse2"))) static int UcharBlockSse2(const unsigned char* a,
+                                                          const unsigned char* b,
+                                                          const unsigned char* thresholds,
+                                                          size_t* at_or_below) {
+    __m128i diff[VERIFY_BLOCK_ELEMENTS / 16];
+    __m128i t;
+    __m128i count;
+    __m128i sad;
+    __m128i max_diff = _mm_setzero_si128();
+    __m128i ga;
+    __m128i rb;
+    unsigned char lanes[16];
+    int max_value = 0;
+    int j;
+    int k;
+
+    for (k = 0; k < (VERIFY_BLOCK_ELEMENTS / 16); k++) {
+        ga = _mm_loadu_si128((const __m128i*)(a + (k * 16)));
+        rb = _mm_loadu_si128((const __m128i*)(b + (k * 16)));
+        diff[k] = _mm_or_si128(_mm_subs_epu8(ga, rb), _mm_subs_epu8(rb, ga));
+        max_diff = _mm_max_epu8(max_diff, diff[k]);
+    }
+    _mm_storeu_si128((__m128i*)lanes, max_diff);
+    for (k = 0; k < 16; k++) {
+        if ((int)lanes[k] > max_value) {
+            max_value = (int)lanes[k];
+        }
+    }
+    for (j = 0; j < VERIFY_HISTOGRAM_BINS; j++) {
+        if ((int)thresholds[j] >= max_value) {
+            at_or_below[j] = (size_t)VERIFY_BLOCK_ELEMENTS; /* Whole block at or below */
+            continue;
+        }
+        t = _mm_set1_epi8((char)thresholds[j]);
+        count = _mm_setzero_si128();
+        for (k = 0; k < (VERIFY_BLOCK_ELEMENTS / 16); k++) {
+            /* Lane is 0xFF (-1) where diff <= t; at most 4 per lane, no overflow */
+            count = _mm_sub_epi8(
+                count, _mm_cmpeq_epi8(_mm_subs_epu8(diff[k], t), _mm_setzero_si128()));
+        }
+        sad = _mm_sad_epu8(count, _mm_setzero_si128());
+        at_or_below[j] = (size_t)(_mm_cvtsi128_si32(sad) +
+                                  _mm_cvtsi128_si32(_mm_srli_si128(sad, 8)));
+    }
+    return max_value;
+}
+#endif
+
+#if defined(VERIFY_SIMD_NEON)
+static int UcharBlockNeon(const unsigned char* a, const unsigned char* b,
+                          const unsigned char* thresholds, size_t* at_or_below) {
+    uint8x16_t diff[VERIFY_BLOCK_ELEMENTS / 16];
+    uint8x16_t max_diff = vdupq_n_u8(0U);
+    uint8x16_t count;
+    uint8x16_t t;
+    int max_value;
+    int j;
+    int k;
+
+    for (k = 0; k < (VERIFY_BLOCK_ELEMENTS / 16); k++) {
+        diff[k] = vabdq_u8(vld1q_u8(a + (k * 16)), vld1q_u8(b + (k * 16)));
+        max_diff = vmaxq_u8(max_diff, diff[k]);
+    }
+    max_value = (int)vmaxvq_u8(max_diff);
+    for (j = 0; j < VERIFY_HISTOGRAM_BINS; j++) {
+        if ((int)thresholds[j] >= max_value) {
+            at_or_below[j] = (size_t)VERIFY_BLOCK_ELEMENTS; /* Whole block at or below */
+            continue;
+        }
+        t = vdupq_n_u8(thresholds[j]);
+        count = vdupq_n_u8(0U);
+        for (k = 0; k < (VERIFY_BLOCK_ELEMENTS / 16); k++) {
+            count = vsubq_u8(count, vcleq_u8(diff[k], t));
+        }
+        at_or_below[j] = (size_t)vaddlvq_u8(count);
+    }
+    return max_value;
+}
+#endif
+
+/* Vector block summary, or -1 when the instruction set has none */
+static int UcharBlock(CpuSimd simd, const unsigned char* a, const unsigned char* b,
+                      const unsigned char* thresholds, size_t* at_or_below) {
+#if defined(VERIFY_SIMD_X86)
+    if ((simd == CPU_SIMD_AVX2) || (simd == CPU_SIMD_SSE2)) {
+        return UcharBlockSse2(a, b, thresholds, at_or_below);
+    }
+#elif defined(VERIFY_SIMD_NEON)
+    if (simd == CPU_SIMD_NEON) {
+        return UcharBlockNeon(a, b, thresholds, at_or_below);
+    }
+#endif
+    (void)simd;
+    (void)a;
+    (void)b;
+    (void)thresholds;
+    (void)at_or_below;
+    return -1;
+}
+
+/* Differing uchar block [block, block + count): vector summary when possible */
+static void CompareUcharBlock(VerifyChunk* chunk, size_t block, size_t count) {
+    size_t at_or_below[VERIFY_HISTOGRAM_BINS];
+    size_t i;
+    int max_value = -1;
+    int bin;
+
+    if ((count == (size_t)VERIFY_BLOCK_ELEMENTS) && (chunk->tolerance >= 0.0f)) {
+        max_value = UcharBlock(chunk->simd, chunk->gpu + block, chunk->ref + block,
+                               uchar_thresholds, at_or_below);
+    }
+    if (max_value < 0) {
+        CompareUcharRun(chunk, block, block + count);
+        return;
+    }
+
+    chunk->histogram[0] += at_or_below[0];
+    for (bin = 1; bin < (VERIFY_HISTOGRAM_BINS - 1); bin++) {
+        chunk->histogram[bin] += at_or_below[bin] - at_or_below[bin - 1];
+    }
+    chunk->histogram[VERIFY_HISTOGRAM_BINS - 1] += count - at_or_below[VERIFY_HISTOGRAM_BINS - 2];
+    chunk->errors += count - at_or_below[VERIFY_HISTOGRAM_BINS - 1];
+
+    /* The first element reaching the block maximum is the first strict maximum */
+    if ((max_value > 0) && ((chunk->has_worst == 0) || ((float)max_value > chunk->max_error))) {
+        for (i = block; i < (block + count); i++) {
+            if (abs((int)chunk->gpu[i] - (int)chunk->ref[i]) == max_value) {
+                TrackWorst(chunk, i, (float)max_value);
+                break;
+            }
+        }
+    }
+}
+
+/* Float bits mapped to integers that order like the values (-0 and +0 both 0) */
+static long long FloatOrdered(float value) {
+    int32_t bits;
+
+    (void)memcpy(&bits, &value, sizeof(bits));
+    return (bits < 0) ? ((long long)INT32_MIN - (long long)bits) : (long long)bits;
+}
+
+/* Non-zero if element i, above the absolute tolerance, is within the relative or ULP bound */
+static int FloatWithinBounds(const VerifyChunk* chunk, size_t i, float diff) {
+    float g;
+    float r;
+    long long ulps;
+
+    if (!isfinite(diff)) {
         return 0;
     }
+    (void)memcpy(&g, chunk->gpu + (i * sizeof(float)), sizeof(float));
+    (void)memcpy(&r, chunk->ref + (i * sizeof(float)), sizeof(float));
+    if ((chunk->rel_tolerance > 0.0f) && (diff <= (chunk->rel_tolerance * fabsf(r)))) {
+        return 1;
+    }
+    if (chunk->ulp_tolerance > 0) {
+        ulps = FloatOrdered(g) - FloatOrdered(r);
+        if (ulps < 0) {
+            ulps = -ulps;
+        }
+        return (ulps <= (long long)chunk->ulp_tolerance) ? 1 : 0;
+    }
+    return 0;
+}
+
+static void CompareFloatRun(VerifyChunk* chunk, size_t begin, size_t end) {
+    size_t i;
+    float diff;
+
+    for (i = begin; i < end; i++) {
+        diff = ElementDiff(chunk, i);
+        chunk->histogram[HistogramBin(diff, chunk->bin_unit)]++;
+        if ((diff > chunk->tolerance) && (FloatWithinBounds(chunk, i, diff) == 0)) {
+            chunk->errors++;
+        }
+        if (diff > 0.0f) {
+            TrackWorst(chunk, i, diff);
+        }
+    }
+}
+
+static void CompareChunk(VerifyChunk* chunk) {
+    size_t elem_size = (chunk->type == VERIFY_ELEMENT_FLOAT) ? sizeof(float) : 1U;
+    size_t block;
+    size_t count;
+
+    for (block = chunk->begin; block < chunk->end; block += count) {
+        /* Skip identical full blocks; the partial last block always takes the element pass */
+        count = EqualBlocks(chunk->simd, chunk->gpu + (block * elem_size),
+                            chunk->ref + (block * elem_size),
+                            (size_t)VERIFY_BLOCK_ELEMENTS * elem_size,
+                            (chunk->end - block) / (size_t)VERIFY_BLOCK_ELEMENTS) *
+                (size_t)VERIFY_BLOCK_ELEMENTS;
+        if (count > 0U) {
+            chunk->histogram[0] += count;
+            continue;
+        }
+        count = chunk->end - block;
+        if (count > (size_t)VERIFY_BLOCK_ELEMENTS) {
+            count = (size_t)VERIFY_BLOCK_ELEMENTS;
+        }
+
+        if (chunk->type == VERIFY_ELEMENT_UCHAR) {
+            CompareUcharBlock(chunk, block, count);
+        } else {
+            CompareFloatRun(chunk, block, block + count);
+        }
+
+        if ((chunk->early_exit != 0) && (chunk->errors > chunk->budget)) {
+            chunk->stopped = 1;
+            break;
+        }
+    }
+}
+
+static void* CompareChunkThread(void* arg) {
+    CompareChunk((VerifyChunk*)arg);
+    return NULL;
+}
+
+/* Element count of an image, or 0 on invalid or overflowing dimensions */
+static size_t ElementCount(const VerifyOptions* opts) {
+    int channels = (opts->channels > 0) ? opts->channels : 1;
+    int pixels;
+    int total;
 
     /* MISRA-C:2023 Rule 1.3: Check for integer overflow */
-    if (!SafeMulInt(width, height, &temp_size)) {
+    if ((opts->width <= 0) || (opts->height <= 0)) {
+        return 0U;
+    }
+    if (!SafeMulInt(opts->width, opts->height, &pixels) ||
+        !SafeMulInt(pixels, channels, &total)) {
         (void)fprintf(stderr, "Error: Image dimensions overflow\n");
-        return 0;
+        return 0U;
     }
-    if (!SafeMulInt(temp_size, actual_channels, &total_elements)) {
-        (void)fprintf(stderr, "Error: Image dimensions overflow (with channels)\n");
-        return 0;
+    return (size_t)total;
+}
+
+/* Largest error count whose rate still passes (same float test as the verdict) */
+static size_t ErrorBudget(size_t total, float threshold) {
+    size_t budget;
+
+    if (!(threshold < 1.0f)) {
+        return total;
+    }
+    if (!(threshold > 0.0f)) {
+        return 0U;
     }
+    budget = (size_t)((double)threshold * (double)total);
+    while ((budget > 0U) && (((float)budget / (float)total) > threshold)) {
+        budget--;
+    }
+    while ((budget < total) && (((float)(budget + 1U) / (float)total) <= threshold)) {
+        budget++;
+    }
+    return budget;
+}
 
-    for (i = 0; i < total_elements; i++) {
-        diff = (int)gpu_output[i] - (int)ref_output[i];
-        if (diff < 0) {
-            diff = -diff; /* Absolute value */
+static void ReadElement(const void* data, VerifyElementType type, size_t i, float* value) {
+    if (type == VERIFY_ELEMENT_UCHAR) {
+        *value = (float)((const unsigned char*)data)[i];
+    } else {
+        (void)memcpy(value, (const unsigned char*)data + (i * sizeof(float)), sizeof(float));
+    }
+}
+
+int VerifyCompare(const void* gpu_output, const void* ref_output, const VerifyOptions* opts,
+                  VerifyReport* report) {
+    size_t total;
+    size_t per_chunk;
+    size_t begin;
+    size_t worst_index = 0U;
+    size_t pixel;
+    int chunk_count;
+    int started[VERIFY_MAX_THREADS];
+    int has_worst = 0;
+    int channels;
+    int bin;
+    int i;
+    float unit;
+    float bound;
+    CpuSimd simd;
+
+    if ((gpu_output == NULL) || (ref_output == NULL) || (opts == NULL) || (report == NULL)) {
+        return -1;
+    }
+    (void)memset(report, 0, sizeof(*report));
+    report->worst_x = -1;
+    report->worst_y = -1;
+    report->worst_channel = -1;
+
+    total = ElementCount(opts);
+    if (total == 0U) {
+        return -1;
+    }
+    channels = (opts->channels > 0) ? opts->channels : 1;
+    simd = CpuSimdLevel();
+    unit = (opts->tolerance > 0.0f) ? opts->tolerance : 1.0f;
+    if (opts->element_type == VERIFY_ELEMENT_UCHAR) {
+        for (i = 0; i < 256; i++) {
+            uchar_bins[i] = (unsigned char)HistogramBin((float)i, unit);
+        }
+        bound = 0.0f;
+        for (i = 0; i < (VERIFY_HISTOGRAM_BINS - 1); i++) {
+            uchar_thresholds[i] = (bound >= 255.0f) ? 255U : (unsigned char)bound;
+            bound = (i == 0) ? unit : (bound * 2.0f);
+        }
+        uchar_thresholds[VERIFY_HISTOGRAM_BINS - 1] =
+            (opts->tolerance >= 255.0f) ? 255U : (unsigned char)opts->tolerance;
+    }
+
+    /* Split into block-aligned ranges of at least VERIFY_MIN_CHUNK_ELEMENTS */
+    chunk_count = (opts->threads > 1) ? opts->threads : 1;
+    if (chunk_count > VERIFY_MAX_THREADS) {
+        chunk_count = VERIFY_MAX_THREADS;
+    }
+    if ((size_t)chunk_count > (total / VERIFY_MIN_CHUNK_ELEMENTS)) {
+        chunk_count = (int)(total / VERIFY_MIN_CHUNK_ELEMENTS);
+        if (chunk_count < 1) {
+            chunk_count = 1;
+        }
+    }
+    per_chunk = (total + (size_t)chunk_count - 1U) / (size_t)chunk_count;
+    per_chunk = ((per_chunk + VERIFY_BLOCK_ELEMENTS - 1U) / VERIFY_BLOCK_ELEMENTS) *
+                VERIFY_BLOCK_ELEMENTS;
+
+    begin = 0U;
+    for (i = 0; i < chunk_count; i++) {
+        (void)memset(&chunks[i], 0, sizeof(chunks[i]));
+        chunks[i].gpu = (const unsigned char*)gpu_output;
+        chunks[i].ref = (const unsigned char*)ref_output;
+        chunks[i].type = opts->element_type;
+        chunks[i].simd = simd;
+        chunks[i].begin = begin;
+        chunks[i].end = ((total - begin) > per_chunk) ? (begin + per_chunk) : total;
+        chunks[i].tolerance = opts->tolerance;
+        chunks[i].rel_tolerance = opts->rel_tolerance;
+        chunks[i].ulp_tolerance = opts->ulp_tolerance;
+        chunks[i].bin_unit = unit;
+        chunks[i].budget = ErrorBudget(total, opts->error_rate_threshold);
+        chunks[i].early_exit = opts->early_exit;
+        begin = chunks[i].end;
+    }
+
+    /* Chunk 0 runs on the calling thread; a thread that fails to start runs inline */
+    started[0] = 0;
+    for (i = 1; i < chunk_count; i++) {
+        started[i] =
+            (pthread_create(&chunk_threads[i], NULL, CompareChunkThread, &chunks[i]) == 0) ? 1
+                                                                                             : 0;
+    }
+    CompareChunk(&chunks[0]);
+    for (i = 1; i < chunk_count; i++) {
+        if (started[i] != 0) {
+            (void)pthread_join(chunk_threads[i], NULL);
+        } else {
+            CompareChunk(&chunks[i]);
+        }
+    }
+
+    /* Merge in element order, so the report matches a single-threaded pass */
+    report->total_elements = total;
+    for (i = 0; i < chunk_count; i++) {
+        report->errors += chunks[i].errors;
+        for (bin = 0; bin < VERIFY_HISTOGRAM_BINS; bin++) {
+            report->histogram[bin] += chunks[i].histogram[bin];
+        }
+        if ((chunks[i].has_worst != 0) &&
+            ((has_worst == 0) || (chunks[i].max_error > report->max_error))) {
+            report->max_error = chunks[i].max_error;
+            worst_index = chunks[i].worst_index;
+            has_worst = 1;
         }
-        if (diff > tolerance) {
-            errors++;
+        if (chunks[i].stopped != 0) {
+            report->early_exited = 1;
         }
     }
 
-    return (errors == 0) ? 1 : 0; /* Return 1 if passed, 0 if failed */
+    report->error_rate = (float)report->errors / (float)total;
+    report->passed = (report->error_rate <= opts->error_rate_threshold) ? 1 : 0;
+    if (has_worst != 0) {
+        pixel = worst_index / (size_t)channels;
+        report->worst_channel = (int)(worst_index % (size_t)channels);
+        report->worst_x = (int)(pixel % (size_t)opts->width);
+        report->worst_y = (int)(pixel / (size_t)opts->width);
+        ReadElement(gpu_output, opts->element_type, worst_index, &report->worst_gpu);
+        ReadElement(ref_output, opts->element_type, worst_index, &report->worst_ref);
+    }
+
+    return 0;
 }
 
-int VerifyWithTolerance(unsigned char* gpu_output, unsigned char* ref_output, int width, int height,
-                        int channels, float tolerance, float error_rate_threshold, float* max_error) {
-    int errors = 0;
-    int total_elements;
-    int temp_size;
+void VerifyPrintReport(const VerifyOptions* opts, const VerifyReport* report) {
+    float unit;
+    float low = 0.0f;
+    float high;
+    char label[48];
+    int bin;
+
+    if ((opts == NULL) || (report == NULL)) {
+        return;
+    }
+
+    (void)printf("Mismatches: %zu / %zu (%.4f%%, tolerance %g", report->errors,
+                 report->total_elements, (double)report->error_rate * 100.0,
+                 (double)opts->tolerance);
+    if ((opts->element_type == VERIFY_ELEMENT_FLOAT) && (opts->rel_tolerance > 0.0f)) {
+        (void)printf(", rel %g", (double)opts->rel_tolerance);
+    }
+    if ((opts->element_type == VERIFY_ELEMENT_FLOAT) && (opts->ulp_tolerance > 0)) {
+        (void)printf(", %d ULP", opts->ulp_tolerance);
+    }
+    (void)printf(")%s\n", (report->early_exited != 0) ? " [early exit]" : "");
+    if (report->worst_x < 0) {
+        return;
+    }
+    (void)printf("Worst element: (%d, %d) ch %d  gpu %g  ref %g  |diff| %g\n", report->worst_x,
+                 report->worst_y, report->worst_channel, (double)report->worst_gpu,
+                 (double)report->worst_ref, (double)report->max_error);
+
+    (void)printf("Error histogram:\n");
+    unit = (opts->tolerance > 0.0f) ? opts->tolerance : 1.0f;
+    high = unit;
+    for (bin = 0; bin < VERIFY_HISTOGRAM_BINS; bin++) {
+        if (bin == 0) {
+            (void)snprintf(label, sizeof(label), "exact");
+        } else if (bin < (VERIFY_HISTOGRAM_BINS - 1)) {
+            (void)snprintf(label, sizeof(label), "(%g, %g]", (double)low, (double)high);
+        } else {
+            (void)snprintf(label, sizeof(label), "> %g", (double)low);
+        }
+        if (report->histogram[bin] > 0U) {
+            (void)printf("  %-24s %zu\n", label, report->histogram[bin]);
+        }
+        if (bin > 0) {
+            low = high;
+            high *= 2.0f;
+        }
+    }
+}
+
+int VerifyWriteDiffImage(const void* gpu_output, const void* ref_output,
+                         const VerifyOptions* opts, const char* path) {
+    VerifyChunk view;
+    FILE* fp;
+    size_t total;
+    size_t elem_size;
+    size_t per_chunk;
+    size_t begin;
+    size_t count;
+    size_t i;
     float diff;
-    float error_rate;
-    int i;
-    int actual_channels = (channels > 0) ? channels : 1;
+    int result = 0;
 
-    if ((gpu_output == NULL) || (ref_output == NULL) || (max_error == NULL)) {
+    if ((gpu_output == NULL) || (ref_output == NULL) || (opts == NULL) || (path == NULL)) {
+        return -1;
+    }
+    total = ElementCount(opts);
+    if (total == 0U) {
+        return -1;
+    }
+
+    (void)memset(&view, 0, sizeof(view));
+    view.gpu = (const unsigned char*)gpu_output;
+    view.ref = (const unsigned char*)ref_output;
+    view.type = opts->element_type;
+    elem_size = (opts->element_type == VERIFY_ELEMENT_FLOAT) ? sizeof(float) : 1U;
+    per_chunk = VERIFY_DIFF_CHUNK_BYTES / elem_size;
+
+    fp = fopen(path, "wb");
+    if (fp == NULL) {
+        (void)fprintf(stderr, "Error: Failed to open diff image %s\n", path);
+        return -1;
+    }
+
+    for (begin = 0U; (begin < total) && (result == 0); begin += count) {
+        count = ((total - begin) > per_chunk) ? per_chunk : (total - begin);
+        for (i = 0U; i < count; i++) {
+            diff = ElementDiff(&view, begin + i);
+            if (elem_size == 1U) {
+                diff_chunk[i] = (unsigned char)diff;
+            } else {
+                (void)memcpy(&diff_chunk[i * sizeof(float)], &diff, sizeof(float));
+            }
+        }
+        if (fwrite(diff_chunk, elem_size, count, fp) != count) {
+            (void)fprintf(stderr, "Error: Failed to write diff image %s\n", path);
+            result = -1;
+        }
+    }
+
+    if (fclose(fp) != 0) {
+        result = -1;
+    }
+    return result;
+}
+
+int VerifyExactMatch(unsigned char* gpu_output, unsigned char* ref_output, int width, int height,
+                     int channels, int tolerance) {
+    VerifyOptions opts;
+    VerifyReport report;
+
+    if ((gpu_output == NULL) || (ref_output == NULL)) {
         return 0;
     }
 
-    *max_error = 0.0f;
-    /* MISRA-C:2023 Rule 1.3: Check for integer overflow */
-    if (!SafeMulInt(width, height, &temp_size)) {
-        (void)fprintf(stderr, "Error: Image dimensions overflow\n");
+    opts.element_type = VERIFY_ELEMENT_UCHAR;
+    opts.width = width;
+    opts.height = height;
+    opts.channels = channels;
+    opts.tolerance = (float)tolerance;
+    opts.rel_tolerance = 0.0f;
+    opts.ulp_tolerance = 0;
+    opts.error_rate_threshold = 0.0f;
+    opts.threads = 1;
+    opts.early_exit = 1; /* The first error decides */
+    if (VerifyCompare(gpu_output, ref_output, &opts, &report) != 0) {
         return 0;
     }
-    if (!SafeMulInt(temp_size, actual_channels, &total_elements)) {
-        (void)fprintf(stderr, "Error: Image dimensions overflow (with channels)\n");
+
+    return (report.errors == 0U) ? 1 : 0; /* Return 1 if passed, 0 if failed */
+}
+
+int VerifyWithTolerance(unsigned char* gpu_output, unsigned char* ref_output, int width, int height,
+                        int channels, float tolerance, float error_rate_threshold, float* max_error) {
+    VerifyOptions opts;
+    VerifyReport report;
+
+    if ((gpu_output == NULL) || (ref_output == NULL) || (max_error == NULL)) {
         return 0;
     }
 
-    for (i = 0; i < total_elements; i++) {
-        diff = fabsf((float)gpu_output[i] - (float)ref_output[i]);
-        if (diff > *max_error) {
-            *max_error = diff;
-        }
-        if (diff > tolerance) {
-            errors++;
-        }
+    *max_error = 0.0f;
+    opts.element_type = VERIFY_ELEMENT_UCHAR;
+    opts.width = width;
+    opts.height = height;
+    opts.channels = channels;
+    opts.tolerance = tolerance;
+    opts.rel_tolerance = 0.0f;
+    opts.ulp_tolerance = 0;
+    opts.error_rate_threshold = error_rate_threshold;
+    opts.threads = 1;
+    opts.early_exit = 0; /* max_error covers the whole image */
+    if (VerifyCompare(gpu_output, ref_output, &opts, &report) != 0) {
+        return 0;
     }
 
-    error_rate = ((float)errors / (float)total_elements);
-    return (error_rate <= error_rate_threshold) ? 1 : 0;
+    *max_error = report.max_error;
+    return report.passed;
 }
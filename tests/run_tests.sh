@@ -101,8 +101,8 @@ Examples:
   $0 --junit -r ./ci-reports  # Generate JUnit XML for CI/CD
 
 Algorithms and Variants:
-  dilate3x3:   v0, v1
-  gaussian5x5: v1f, v1, v2, v3
+  dilate3x3:   v0, v1, v2, v3
+  gaussian5x5: v1f, v1fu, v1fa, v1, v2, v3, v4, v5, v6, v7
   relu:        v0, v1, v6, v3
 EOF
 }
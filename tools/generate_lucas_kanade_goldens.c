@@ -0,0 +1,215 @@
+/**
+ * @file generate_lucas_kanade_goldens.c
+ * @brief Standalone tool to generate the pyramidal and sparse Lucas-Kanade goldens
+ *
+ * Runs the C references the pyr_lk and sparse_track pipelines of
+ * config/lucas_kanade.json are checked against:
+ * - pyr_lk: LucasKanadeRef() with "pyramid_levels" levels (flow_x, flow_y)
+ * - sparse_track: the same flow, kept only at Harris keypoints of the
+ *   previous frame (HarrisCornerRef() then HarrisNmsRef()), zero elsewhere
+ *
+ * Usage:
+ *   gcc -O2 -Iinclude -Isrc -o generate_lucas_kanade_goldens \
+ *       tools/generate_lucas_kanade_goldens.c examples/lucas_kanade/c_ref/lucas_kanade_ref.c \
+ *       examples/harris_corner/c_ref/harris_corner_ref.c src/utils/cpu_features.c -lm
+ *   ./generate_lucas_kanade_goldens <prev> <curr> <out_dir> <width> <height> <levels> <threshold>
+ *
+ * Example:
+ *   ./generate_lucas_kanade_goldens test_data/lucas_kanade/prev_frame.bin \
+ *       test_data/lucas_kanade/curr_frame.bin test_data/lucas_kanade 1920 1080 3 10000.0
+ *
+ * Writes <out_dir>/golden_pyr_flow_x.bin, golden_pyr_flow_y.bin,
+ * golden_sparse_flow_x.bin and golden_sparse_flow_y.bin (float).
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "op_interface.h"
+
+void LucasKanadeRef(const OpParams* params);
+void HarrisCornerRef(const OpParams* params);
+void HarrisNmsRef(const OpParams* params);
+
+/* Large tables kept off the stack */
+static CustomBuffers buffers;
+static CustomScalars scalars;
+
+/**
+ * @brief Read a binary file of exactly @p size bytes
+ */
+unsigned char* read_file(const char* filename, size_t size) {
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) {
+        fprintf(stderr, "Error: Cannot open file %s\n", filename);
+        return NULL;
+    }
+
+    unsigned char* data = (unsigned char*)malloc(size);
+    if (!data) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        fclose(fp);
+        return NULL;
+    }
+
+    size_t read_count = fread(data, 1, size, fp);
+    fclose(fp);
+    if (read_count != size) {
+        fprintf(stderr, "Error: Expected %zu bytes in %s, read %zu\n", size, filename, read_count);
+        free(data);
+        return NULL;
+    }
+    return data;
+}
+
+/**
+ * @brief Write a float map to <dir>/<name>
+ */
+bool write_float_file(const char* dir, const char* name, const float* data, size_t count) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp) {
+        fprintf(stderr, "Error: Cannot create file %s\n", path);
+        return false;
+    }
+
+    size_t written = fwrite(data, sizeof(float), count, fp);
+    fclose(fp);
+    if (written != count) {
+        fprintf(stderr, "Error: Expected to write %zu elements to %s, wrote %zu\n", count, path,
+                written);
+        return false;
+    }
+    printf("Wrote %s\n", path);
+    return true;
+}
+
+/**
+ * @brief Add a named buffer or scalar to the reference parameters
+ */
+void add_buffer(const char* name, void* data, size_t size) {
+    RuntimeBuffer* buf = &buffers.buffers[buffers.count++];
+    snprintf(buf->name, sizeof(buf->name), "%s", name);
+    buf->host_data = (unsigned char*)data;
+    buf->size_bytes = size;
+}
+
+void add_int_scalar(const char* name, int value) {
+    ScalarValue* s = &scalars.scalars[scalars.count++];
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    s->type = SCALAR_TYPE_INT;
+    s->value.int_value = value;
+}
+
+void add_float_scalar(const char* name, float value) {
+    ScalarValue* s = &scalars.scalars[scalars.count++];
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    s->type = SCALAR_TYPE_FLOAT;
+    s->value.float_value = value;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 8) {
+        fprintf(stderr,
+                "Usage: %s <prev> <curr> <out_dir> <width> <height> <levels> <threshold>\n",
+                argv[0]);
+        fprintf(stderr, "Example:\n");
+        fprintf(stderr, "  %s test_data/lucas_kanade/prev_frame.bin \\\n", argv[0]);
+        fprintf(stderr, "      test_data/lucas_kanade/curr_frame.bin test_data/lucas_kanade "
+                        "1920 1080 3 10000.0\n");
+        return 1;
+    }
+
+    const char* out_dir = argv[3];
+    int width = atoi(argv[4]);
+    int height = atoi(argv[5]);
+    int levels = atoi(argv[6]);
+    float threshold = (float)atof(argv[7]);
+
+    if (width <= 0 || height <= 0 || levels < 1) {
+        fprintf(stderr, "Error: Invalid dimensions %dx%d or levels %d\n", width, height, levels);
+        return 1;
+    }
+
+    size_t num_pixels = (size_t)width * height;
+    unsigned char* prev = read_file(argv[1], num_pixels);
+    unsigned char* curr = read_file(argv[2], num_pixels);
+    float* flow_x = (float*)calloc(num_pixels, sizeof(float));
+    float* flow_y = (float*)calloc(num_pixels, sizeof(float));
+    float* response = (float*)calloc(num_pixels, sizeof(float));
+    unsigned char* corners = (unsigned char*)calloc(num_pixels, 1);
+    if (!prev || !curr || !flow_x || !flow_y || !response || !corners) {
+        return 1;
+    }
+
+    /* Same scalars as config/lucas_kanade.json */
+    add_int_scalar("window_size", 5);
+    add_int_scalar("max_iters", 10);
+    add_int_scalar("pyramid_levels", levels);
+    add_float_scalar("nms_threshold", threshold);
+
+    OpParams params;
+    memset(&params, 0, sizeof(params));
+    params.src_width = width;
+    params.src_height = height;
+    params.src_channels = 1;
+    params.src_stride = width;
+    params.dst_width = width;
+    params.dst_height = height;
+    params.dst_channels = 1;
+    params.dst_stride = width;
+    params.custom_scalars = &scalars;
+    params.custom_buffers = &buffers;
+
+    /* Dense pyramidal flow (prev = input, curr = curr_frame, flow_x = output) */
+    printf("Running %d-level Lucas-Kanade...\n", levels);
+    add_buffer("curr_frame", curr, num_pixels);
+    add_buffer("flow_y", flow_y, num_pixels * sizeof(float));
+    params.input = prev;
+    params.output = (unsigned char*)flow_x;
+    LucasKanadeRef(&params);
+
+    /* Keypoints: Harris response of the previous frame, then NMS */
+    printf("Detecting Harris keypoints (threshold %.2f)...\n", threshold);
+    params.output = (unsigned char*)response;
+    HarrisCornerRef(&params);
+    buffers.count = 0;
+    add_buffer("response", response, num_pixels * sizeof(float));
+    add_buffer("corners", corners, num_pixels);
+    HarrisNmsRef(&params);
+
+    if (!write_float_file(out_dir, "golden_pyr_flow_x.bin", flow_x, num_pixels) ||
+        !write_float_file(out_dir, "golden_pyr_flow_y.bin", flow_y, num_pixels)) {
+        return 1;
+    }
+
+    /* Sparse flow: dense flow at keypoints, zero elsewhere */
+    size_t keypoints = 0;
+    for (size_t i = 0; i < num_pixels; i++) {
+        if (corners[i] == 255) {
+            keypoints++;
+        } else {
+            flow_x[i] = 0.0f;
+            flow_y[i] = 0.0f;
+        }
+    }
+    printf("Keypoints: %zu\n", keypoints);
+
+    if (!write_float_file(out_dir, "golden_sparse_flow_x.bin", flow_x, num_pixels) ||
+        !write_float_file(out_dir, "golden_sparse_flow_y.bin", flow_y, num_pixels)) {
+        return 1;
+    }
+
+    printf("Done!\n");
+    free(prev);
+    free(curr);
+    free(flow_x);
+    free(flow_y);
+    free(response);
+    free(corners);
+    return 0;
+}